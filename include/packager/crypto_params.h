@@ -181,6 +181,12 @@ struct EncryptionParams {
   double crypto_period_duration_in_seconds = kNoKeyRotation;
   /// Enable/disable subsample encryption for VP9.
   bool vp9_subsample_encryption = true;
+  /// Number of background worker threads used to encrypt media samples, per
+  /// track. When positive, sample encryption runs on a worker pool and the
+  /// encrypted samples are dispatched downstream in their original order, so
+  /// tracks sharing a pipeline no longer serialize their crypto work. The
+  /// default of 0 encrypts inline on the dispatching thread.
+  int32_t encryption_worker_count = 0;
 
   /// Encrypted stream information that is used to determine stream label.
   struct EncryptedStreamAttributes {
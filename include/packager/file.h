@@ -20,8 +20,12 @@ namespace shaka {
 extern const char* kCallbackFilePrefix;
 extern const char* kLocalFilePrefix;
 extern const char* kMemoryFilePrefix;
+extern const char* kReplayFilePrefix;
+extern const char* kShmFilePrefix;
 extern const char* kUdpFilePrefix;
+extern const char* kUringFilePrefix;
 extern const char* kHttpFilePrefix;
+extern const char* kIngestHttpFilePrefix;
 const int64_t kWholeFile = -1;
 
 /// Define an abstract file interface.
@@ -69,6 +73,24 @@ class SHAKA_EXPORT File {
   /// @return Number of bytes written, or a value < 0 on error.
   virtual int64_t Write(const void* buffer, uint64_t length) = 0;
 
+  /// A non-contiguous buffer extent for WriteV().
+  struct IoVec {
+    const void* data;
+    uint64_t length;
+  };
+
+  /// Write several non-contiguous extents in order, as if each were passed to
+  /// Write() back to back. Lets callers emit a segment assembled from
+  /// separate header and payload buffers without coalescing them first. The
+  /// base implementation loops over Write(); file types with native vectored
+  /// I/O (e.g. LocalFile via writev) override it.
+  /// @param iov points to @a iov_count extents to write.
+  /// @param iov_count is the number of extents.
+  /// @return Total number of bytes written, or a value < 0 on error. A value
+  ///         smaller than the sum of the extent lengths indicates an error
+  ///         partway through.
+  virtual int64_t WriteV(const IoVec* iov, int iov_count);
+
   /// Close the file for writing.  This signals that no more data will be
   /// written.  Future writes are invalid and their behavior is undefined!
   /// Data may still be read from the file after calling this method.
@@ -97,6 +119,27 @@ class SHAKA_EXPORT File {
   /// @return true on succcess, false otherwise.
   virtual bool Tell(uint64_t* position) = 0;
 
+  /// Map a read-only view of a byte range of the file into memory, so
+  /// callers can reference file bytes directly instead of copying them
+  /// through Read(). The mapping remains valid until Close() and is
+  /// independent of the Read()/Seek() position. The base implementation
+  /// returns NULL; file types that can support zero-copy reads (e.g.
+  /// LocalFile via mmap) override it.
+  /// @param offset is the byte offset of the start of the region.
+  /// @param length is the size of the region in bytes.
+  /// @return Pointer to the first byte of the mapped region, or NULL if this
+  ///         file type does not support mapping, the range is out of bounds,
+  ///         or mapping failed.
+  virtual const uint8_t* MapReadRegion(uint64_t offset, uint64_t length);
+
+  /// @return A hint for the per-call read size, in bytes, that best matches
+  ///         this file type's transport: small latency-bounded reads for
+  ///         datagram and live sources, large pipelined reads for remote
+  ///         storage where per-request overhead dominates. Returns 0 when the
+  ///         file type has no preference, in which case the caller should use
+  ///         its own default. The base implementation returns 0.
+  virtual uint64_t OptimalReadSize();
+
   /// @return The file name. Note that the file type prefix has been stripped
   ///         off.
   const std::string& file_name() const { return file_name_; }
@@ -185,6 +228,7 @@ class SHAKA_EXPORT File {
   virtual bool Open() = 0;
 
  private:
+  friend class HashingFile;
   friend class ThreadedIoFile;
 
   // This is a file factory method, it creates a proper file, e.g.
@@ -70,6 +70,11 @@ struct HlsParams {
   /// playlist. A negative number indicates a negative time offset from the end
   /// of the last media segment in the playlist.
   std::optional<double> start_time_offset;
+  /// If enabled, an append-only binary feed of playlist changes is written
+  /// next to the master playlist as "<master_playlist_output>.delta" so
+  /// downstream consumers can track segment additions and key rotations
+  /// without re-parsing the playlists.
+  bool generate_delta_feed = false;
 };
 
 }  // namespace shaka
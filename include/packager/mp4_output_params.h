@@ -20,6 +20,20 @@ struct Mp4OutputParams {
   /// Note that it is required by spec if segment_template contains $Times$
   /// specifier.
   bool generate_sidx_in_media_segments = true;
+  /// Write finalized media segments on a background thread, so sample
+  /// processing for the next segment starts while the previous segment is
+  /// still flushing to (possibly remote) storage. Segment files are still
+  /// closed before the manifest is updated. Only applies to multi-segment
+  /// (segment template) output.
+  bool async_segment_finalization = false;
+  /// Number of background threads writing finalized segments when
+  /// @a async_segment_finalization is set. Finalized segments are independent
+  /// of each other, so with more than one thread several segments can be in
+  /// flight to (possibly remote) storage at once; a reorder stage still fires
+  /// MuxerListener events strictly in segment order. Ignored (one writer)
+  /// when segments are appended to a single output file, whose writes must
+  /// stay ordered.
+  int32_t segment_writer_threads = 1;
   /// Enable LL-DASH streaming.
   /// Each segment constists of many fragments, and each fragment contains one
   /// chunk. A chunk is the smallest unit and is constructed of a single moof
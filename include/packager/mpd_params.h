@@ -102,6 +102,10 @@ struct MpdParams {
   /// and is greatly influnced by the player.
   /// This parameter is required by DASH-IF Low Latency standards.
   double target_latency_seconds = 1;
+  /// If enabled, an append-only binary feed of manifest changes is written
+  /// next to the MPD as "<mpd_output>.delta" so downstream consumers can
+  /// track segment additions and key rotations without re-parsing the MPD.
+  bool generate_delta_feed = false;
 };
 
 }  // namespace shaka
@@ -8,8 +8,10 @@
 #define PACKAGER_PUBLIC_PACKAGER_H_
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -47,6 +49,11 @@ struct PackagingParams {
   /// audio) timestamps to compensate for possible negative timestamps in the
   /// input.
   int32_t transport_stream_timestamp_offset_ms = 0;
+  /// If nonzero, mux MPEG2-TS output at this constant rate in bits per
+  /// second: null packets are interleaved so every segment occupies exactly
+  /// its duration at the rate, as broadcast (CBR) delivery chains require.
+  /// Zero keeps variable-rate output.
+  int64_t ts_mux_rate_bps = 0;
   // the threshold used to determine if we should assume that the text stream
   // actually starts at time zero
   int32_t default_text_zero_bias_ms = 0;
@@ -56,13 +63,99 @@ struct PackagingParams {
 
   /// Out of band cuepoint parameters.
   AdCueGeneratorParams ad_cue_generator_params;
+  /// Create the ad cue alignment machinery even when
+  /// @a ad_cue_generator_params has no cue points, so that cues can be
+  /// injected while Run() is executing through Packager::InjectAdCue().
+  bool allow_ad_cue_injection = false;
 
   /// Create a human readable format of MediaInfo. The output file name will be
   /// the name specified by output flag, suffixed with `.media_info`.
   bool output_media_info = false;
+  /// Write the `.media_info` files in protobuf binary wire format instead of
+  /// human readable text format. Binary serialization avoids protobuf
+  /// reflection and produces much smaller files; mpd_generator accepts both
+  /// formats. Only used when @a output_media_info is set.
+  bool output_media_info_binary = false;
+  /// Write a binary key frame index (timestamp, byte offset and size per key
+  /// frame) per stream output, suffixed with `.key_frame_index`. Later
+  /// trick-play or thumbnail packaging jobs can use it to seek straight to
+  /// key frames without demuxing the whole rendition.
+  bool output_key_frame_index = false;
+  /// Write a sha256sum-compatible sidecar per stream output, suffixed with
+  /// `.sha256`, listing the SHA-256 digest of every finalized media segment.
+  /// Digests are computed inline while segments are written, so checksummed
+  /// origin uploads need no extra read pass. Only segments written front to
+  /// back get digests; single-file outputs finalized with seeks are skipped.
+  bool output_segment_digests = false;
   /// Only use a single thread to generate output.  This is useful in tests to
   /// avoid non-deterministic outputs.
   bool single_threaded = false;
+  /// If nonzero, run all packaging jobs on a fixed-size pool of this many
+  /// worker threads with work stealing, instead of one dedicated thread per
+  /// job. Useful when packaging many renditions concurrently on machines
+  /// where one-thread-per-job would oversubscribe the cores. Ignored when
+  /// @a single_threaded is set. When ad cues are configured the jobs must
+  /// all run concurrently to keep their cue points aligned, so the pool is
+  /// grown to one worker per job if this value is smaller.
+  uint32_t worker_thread_count = 0;
+  /// If nonnegative, pin all packaging threads to the CPUs of this NUMA node
+  /// (Linux only). Worker threads inherit the affinity and the buffers they
+  /// allocate become node-local through the kernel's first-touch policy,
+  /// avoiding cross-node memory traffic on multi-socket hosts. Run one
+  /// packager process per node to use the whole machine.
+  int32_t numa_node = -1;
+  /// Per-stream byte budget (high watermark) of the demuxer's parallel
+  /// dispatch queues. The parser is throttled once a stream holds this many
+  /// undispatched sample bytes and resumes below half of it, so queue memory
+  /// follows each stream's actual bitrate instead of a fixed sample count.
+  /// 0 uses the built-in default (8 MB).
+  uint64_t demux_buffer_bytes = 0;
+  /// When true, a pair of stream descriptors that differ only in manifest
+  /// attributes — one marked dash_only, the other hls_only — is folded into a
+  /// single muxer whose segments are referenced by both manifests, instead of
+  /// serializing the same bytes twice. The hls_only descriptor keeps its HLS
+  /// attributes (name, group, playlists) but its output naming is ignored;
+  /// both manifests point at the dash descriptor's segments.
+  bool share_dual_manifest_segments = false;
+  /// When true, stream descriptors that resolve to byte-identical outputs —
+  /// same input stream, codec, crypto settings and manifest visibility,
+  /// differing only in output naming (typically the shared audio re-listed
+  /// per ladder variant) — share a single pipeline. The extra descriptors'
+  /// names are served by copying the muxed files, so every advertised output
+  /// still appears, but the track is demuxed, encrypted and muxed only once.
+  bool deduplicate_repeated_streams = false;
+  /// Per-stream byte budget for sample payloads buffered by handlers that
+  /// hold samples back waiting for a synchronization point (cue alignment,
+  /// trick play). Payloads beyond the budget are spilled to a temporary file
+  /// in @a temp_dir and read back when dispatched, capping worst-case memory
+  /// on inputs with sparse key frames or far-apart ad cues. 0 keeps all
+  /// buffered payloads in memory.
+  uint64_t sample_buffer_spill_bytes = 0;
+  /// Per-job byte budget for buffered media payloads. The demuxer dispatch
+  /// queues and the sample queues of the handlers along a job's pipeline
+  /// share one accounting of their buffered bytes; once the total crosses
+  /// three quarters of the budget, the queues spill to disk and the parser
+  /// throttles early until the total falls back below half. A misbehaving
+  /// input (e.g. huge GOPs buffered waiting for a far-away cue) thus
+  /// degrades to a throttled job instead of growing without bound and
+  /// taking every job on the host down with the process. 0 disables
+  /// job-level accounting; the per-stream budgets above still apply.
+  uint64_t job_memory_limit_bytes = 0;
+  /// If set, called when a job's buffered bytes cross the pressure
+  /// watermark of @a job_memory_limit_bytes, once per pressure episode,
+  /// from a packaging thread. @a input names the job's input source.
+  std::function<void(const std::string& input,
+                     uint64_t buffered_bytes,
+                     uint64_t budget_bytes)>
+      memory_pressure_callback;
+  /// Drive the muxer clock and the MPD's publishTime and
+  /// availabilityStartTime from media timestamps instead of the system
+  /// clock. Virtual time starts at the wall clock time of Initialize() and
+  /// advances to the end of every finalized segment, so with file inputs a
+  /// 24-hour live channel's sliding window, segment eviction and key
+  /// rotation behavior can be soak-tested (and benchmarked) in minutes of
+  /// wall time. Ignored when TestParams::inject_fake_clock is set.
+  bool enable_virtual_clock = false;
 
   /// DASH MPD related parameters.
   MpdParams mpd_params;
@@ -76,6 +169,42 @@ struct PackagingParams {
   /// Buffer callback params.
   BufferCallbackParams buffer_callback_params;
 
+  /// Collect per-handler processing time in the media pipeline, exposed
+  /// through Packager::DumpPipelineStats(). Sample and byte counters are
+  /// always collected; timing adds two clock reads per dispatched sample and
+  /// is therefore opt-in.
+  bool enable_pipeline_stats = false;
+  /// If nonzero, log the pipeline stats JSON (see
+  /// Packager::DumpPipelineStats()) every this many seconds while Run() is
+  /// executing.
+  double pipeline_stats_dump_period_seconds = 0;
+
+  /// If nonzero, run a watchdog that monitors per-thread progress heartbeats
+  /// from the pipeline and, when no thread has made progress for this many
+  /// seconds, logs the heartbeat table, pipeline stats and stall histograms
+  /// and flushes the trace ring — turning a silent hang into an actionable
+  /// report.
+  double watchdog_stall_seconds = 0;
+  /// If set (and the watchdog is enabled), a detected stall also cancels all
+  /// jobs so Run() returns instead of hanging until an external alarm fires.
+  bool watchdog_fail_fast = false;
+
+  /// If nonzero, shed non-critical work when a live pipeline falls behind
+  /// real time by more than this many seconds: trick-play branches skip
+  /// frames and per-segment manifest rewrites are batched, progressively as
+  /// the lag grows, so the primary media path keeps real time. Shedding
+  /// decisions are reported through Packager::DumpPipelineStats().
+  double load_shedding_lag_seconds = 0;
+
+  /// If not empty, record live packaging positions (the next segment number
+  /// of every stream with a segment template) to this file after every
+  /// finalized segment, so a restarted packager can resume from them.
+  std::string checkpoint_file;
+  /// If not empty, restore segment numbering from the checkpoint file at this
+  /// path before packaging starts. Typically the same path as
+  /// @a checkpoint_file.
+  std::string resume_from;
+
   // Parameters for testing. Do not use in production.
   TestParams test_params;
 };
@@ -184,6 +313,55 @@ class SHAKA_EXPORT Packager {
   /// Cancel packaging. Note that it has to be called from another thread.
   void Cancel();
 
+  /// Add a stream descriptor to a running packager without tearing down the
+  /// pipeline, e.g. to add a rendition to a live channel's ladder. The
+  /// descriptor must reference an input and stream selector that are already
+  /// being packaged: the new muxer branch is attached to that stream's
+  /// existing fan-out at the next segment boundary and registers with the
+  /// running manifest notifiers on its first segment. The new output shares
+  /// the source stream's chunking and encryption, so skip_encryption and
+  /// drm_label cannot differ from the running stream's. Text streams and new
+  /// inputs are not supported. Safe to call from another thread while Run()
+  /// is executing.
+  /// @return OK on success, an appropriate error code on failure.
+  Status AddStreamDescriptor(const StreamDescriptor& stream_descriptor);
+
+  /// Remove an output that was previously added with AddStreamDescriptor(),
+  /// identified by its output path or segment template. The branch is flushed
+  /// at the next segment boundary so its output is finalized, then detached.
+  /// Outputs from the initial Initialize() call cannot be removed. Safe to
+  /// call from another thread while Run() is executing.
+  /// @return OK on success, an appropriate error code on failure.
+  Status RemoveStreamDescriptor(const StreamDescriptor& stream_descriptor);
+
+  /// Inject an ad cue into a running packager, e.g. from an out-of-band
+  /// SCTE-35 feed, without restarting the pipeline. The cue is aligned
+  /// across streams exactly like a cue from
+  /// PackagingParams::ad_cue_generator_params and takes effect at the next
+  /// key frame at or after @a time_in_seconds (input presentation time).
+  /// Requires PackagingParams::allow_ad_cue_injection; cues the streams have
+  /// already passed are rejected. Safe to call from another thread while
+  /// Run() is executing.
+  /// @return OK on success, an appropriate error code on failure.
+  Status InjectAdCue(double time_in_seconds);
+
+  /// Dump per-handler pipeline counters (samples in/out, bytes in, cumulative
+  /// processing time) as a JSON string, one entry per media handler, plus
+  /// wait-time histograms for the pipeline's blocking points (full IO caches,
+  /// sync point waits, HTTP round trips) tagged by resource and file or URL,
+  /// so a channel that falls behind real time can be attributed to storage,
+  /// crypto or manifest. Safe to call from another thread while Run() is
+  /// executing, e.g. to spot the slow handler in a live deployment.
+  /// The dump also carries "progress" (the mean normalized progress over all
+  /// muxers, in [0, 1]) and "eta_seconds" (remaining time extrapolated from
+  /// elapsed wall clock; negative while unknown). Progress is published by
+  /// the muxing threads with relaxed atomic stores, so polling it at a high
+  /// rate does not perturb the pipelines being measured.
+  /// Processing time is only collected when
+  /// PackagingParams::enable_pipeline_stats is set.
+  /// @return the stats as a JSON string.
+  std::string DumpPipelineStats() const;
+
   /// @return The version of the library.
   static std::string GetLibraryVersion();
 
@@ -213,11 +391,52 @@ class SHAKA_EXPORT Packager {
       const EncryptionParams::EncryptedStreamAttributes& stream_attributes);
 
  private:
+  friend class PackagerEngine;
+
   Packager(const Packager&) = delete;
   Packager& operator=(const Packager&) = delete;
 
   struct PackagerInternal;
   std::unique_ptr<PackagerInternal> internal_;
+  // Set by PackagerEngine so HTTP origins already pre-warmed by earlier jobs
+  // on the same engine are not warmed again. Null for standalone Packagers.
+  std::set<std::string>* warmed_http_origins_ = nullptr;
+};
+
+/// A reusable packaging engine for running many short jobs back to back in
+/// library mode. Much of the expensive warm state is process wide and already
+/// survives individual Packager instances: the worker thread pool, the libcurl
+/// share with its DNS cache and TLS session tickets, and the memory:// file
+/// system. The engine builds on that by remembering which HTTP origins its
+/// jobs have pre-warmed, so successive Run() calls hitting the same key
+/// servers and upload endpoints skip the handshakes, and by keeping a stable
+/// handle for cancelling whichever job is currently running. Run() may be
+/// called any number of times with different parameters; calls are expected to
+/// be sequential, not concurrent.
+class SHAKA_EXPORT PackagerEngine {
+ public:
+  PackagerEngine();
+  ~PackagerEngine();
+
+  /// Run a packaging job to completion. Equivalent to constructing a Packager
+  /// and calling Initialize() then Run(), but reuses the engine's warm state.
+  /// Note that it blocks until the job completes, fails or is cancelled.
+  /// @param packaging_params contains the packaging parameters.
+  /// @param stream_descriptors a list of stream descriptors.
+  /// @return OK on success, an appropriate error code on failure.
+  Status Run(const PackagingParams& packaging_params,
+             const std::vector<StreamDescriptor>& stream_descriptors);
+
+  /// Cancel the currently running job, if any. Note that it has to be called
+  /// from another thread.
+  void Cancel();
+
+ private:
+  PackagerEngine(const PackagerEngine&) = delete;
+  PackagerEngine& operator=(const PackagerEngine&) = delete;
+
+  struct EngineInternal;
+  std::unique_ptr<EngineInternal> internal_;
 };
 
 }  // namespace shaka
@@ -8,7 +8,10 @@
 #define PACKAGER_PUBLIC_STATUS_H_
 
 #include <iostream>
+#include <memory>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 #include <packager/export.h>
 
@@ -89,13 +92,26 @@ enum Code {
 class SHAKA_EXPORT Status {
  public:
   /// Creates a "successful" status.
-  Status() : error_code_(error::OK) {}
+  Status() = default;
 
   /// Create a status with the specified code, and error message.
   /// If "error_code == error::OK", error_message is ignored and a Status
   /// object identical to Status::OK is constructed.
   Status(error::Code error_code, const std::string& error_message);
 
+  /// Create a status whose error message is formatted lazily:
+  /// @a make_message is only invoked when @a error_code is not error::OK.
+  /// Use this where a status is constructed on a hot path and the message
+  /// formatting would otherwise be paid on success as well.
+  template <typename MessageMaker,
+            typename = std::enable_if_t<
+                std::is_invocable_r<std::string, MessageMaker>::value>>
+  Status(error::Code error_code, MessageMaker&& make_message)
+      : error_code_(error_code) {
+    if (error_code_ != error::OK)
+      SetMessage(std::forward<MessageMaker>(make_message)());
+  }
+
   /// @name Some pre-defined Status objects.
   /// @{
   static const Status OK;  // Identical to 0-arg constructor.
@@ -114,10 +130,13 @@ class SHAKA_EXPORT Status {
 
   bool ok() const { return error_code_ == error::OK; }
   error::Code error_code() const { return error_code_; }
-  const std::string& error_message() const { return error_message_; }
+  const std::string& error_message() const {
+    return error_message_ ? *error_message_ : EmptyMessage();
+  }
 
   bool operator==(const Status& x) const {
-    return error_code_ == x.error_code() && error_message_ == x.error_message();
+    return error_code_ == x.error_code() &&
+           error_message() == x.error_message();
   }
   bool operator!=(const Status& x) const { return !(*this == x); }
 
@@ -125,8 +144,18 @@ class SHAKA_EXPORT Status {
   std::string ToString() const;
 
  private:
-  error::Code error_code_;
-  std::string error_message_;
+  // Stores a non-empty message and logs it. Out of line so the lazy message
+  // constructor stays small at call sites.
+  void SetMessage(std::string error_message);
+
+  static const std::string& EmptyMessage();
+
+  error::Code error_code_ = error::OK;
+  // The message is shared and immutable, so copying a status copies two
+  // words instead of string contents, and the OK path - the common case on
+  // the per-sample pipeline plumbing - never touches an allocator: a null
+  // pointer here means "no message".
+  std::shared_ptr<const std::string> error_message_;
 
   // Not using DISALLOW_COPY_AND_ASSIGN here intentionally to allow the compiler
   // generated copy constructor and assignment operator.
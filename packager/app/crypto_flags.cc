@@ -39,6 +39,12 @@ ABSL_FLAG(std::string,
           playready_extra_header_data,
           "",
           "Extra XML data to add to PlayReady headers.");
+ABSL_FLAG(int32_t,
+          encryption_worker_count,
+          0,
+          "Number of background worker threads used to encrypt media samples, "
+          "per track. The default of 0 encrypts inline on the demuxing "
+          "thread.");
 
 bool ValueNotGreaterThanTen(const char* flagname, int32_t value) {
   if (value > 10) {
@@ -83,6 +89,11 @@ bool ValidateCryptoFlags() {
     success = false;
   }
 
+  if (absl::GetFlag(FLAGS_encryption_worker_count) < 0) {
+    fprintf(stderr, "ERROR: encryption_worker_count must be non-negative.\n");
+    success = false;
+  }
+
   return success;
 }
 }  // namespace shaka
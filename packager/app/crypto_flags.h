@@ -18,6 +18,7 @@ ABSL_DECLARE_FLAG(int32_t, crypt_byte_block);
 ABSL_DECLARE_FLAG(int32_t, skip_byte_block);
 ABSL_DECLARE_FLAG(bool, vp9_subsample_encryption);
 ABSL_DECLARE_FLAG(std::string, playready_extra_header_data);
+ABSL_DECLARE_FLAG(int32_t, encryption_worker_count);
 
 namespace shaka {
 bool ValidateCryptoFlags();
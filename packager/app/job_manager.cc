@@ -10,8 +10,12 @@
 
 #include <absl/log/check.h>
 
+#include <packager/file/io_cancellation.h>
+#include <packager/file/thread_pool.h>
 #include <packager/media/chunking/sync_point_queue.h>
 #include <packager/media/origin/origin_handler.h>
+#include <packager/utils/trace_event.h>
+#include <packager/utils/watchdog.h>
 
 namespace shaka {
 namespace media {
@@ -32,7 +36,15 @@ const Status& Job::Initialize() {
 }
 
 void Job::Start() {
-  thread_.reset(new std::thread(&Job::Run, this));
+  DCHECK(!started_);
+  started_ = true;
+  // Run on the shared thread pool rather than a dedicated thread, so that
+  // pool threads are reused across jobs (and across ThreadedIoFile/HttpFile,
+  // which post to the same pool) instead of one blocked thread per pipeline.
+  ThreadPool::instance.PostTask([this]() {
+    Run();
+    complete_notification_.Notify();
+  });
 }
 
 void Job::Cancel() {
@@ -40,8 +52,13 @@ void Job::Cancel() {
 }
 
 const Status& Job::Run() {
-  if (status_.ok())  // initialized correctly
+  if (status_.ok()) {  // initialized correctly
+    TraceBuffer::ScopedEvent trace("job", "run", name_);
+    // The handlers running under this job pulse the heartbeat from their
+    // dispatch path; registering here scopes the slot to the job's lifetime.
+    Watchdog::ScopedHeartbeat heartbeat(name_);
     status_ = work_->Run();
+  }
 
   on_complete_(this);
 
@@ -49,10 +66,10 @@ const Status& Job::Run() {
 }
 
 void Job::Join() {
-  if (thread_) {
-    thread_->join();
-    thread_ = nullptr;
-  }
+  // Nothing to wait for unless Start() handed the job to the thread pool.
+  // Waiting is idempotent, unlike joining a thread.
+  if (started_)
+    complete_notification_.WaitForNotification();
 }
 
 JobManager::JobManager(std::unique_ptr<SyncPointQueue> sync_points)
@@ -66,9 +83,26 @@ void JobManager::Add(const std::string& name,
 }
 
 Status JobManager::InitializeJobs() {
-  Status status;
-  for (auto& job : jobs_)
-    status.Update(job->Initialize());
+  // Jobs are independent pipelines, so initialize them concurrently on the
+  // shared thread pool. Start-up is then bounded by the slowest pipeline
+  // instead of the sum over all of them, which matters when many stream
+  // descriptors are registered.
+  absl::Mutex mutex;
+  Status status;           // Protected by |mutex|.
+  size_t pending_jobs = jobs_.size();  // Protected by |mutex|.
+
+  for (auto& job : jobs_) {
+    ThreadPool::instance.PostTask([&mutex, &status, &pending_jobs, &job]() {
+      const Status& job_status = job->Initialize();
+      absl::MutexLock lock(&mutex);
+      status.Update(job_status);
+      --pending_jobs;
+    });
+  }
+
+  absl::MutexLock lock(&mutex);
+  mutex.Await(absl::Condition(
+      +[](size_t* pending) { return *pending == 0; }, &pending_jobs));
   return status;
 }
 
@@ -109,6 +143,13 @@ Status JobManager::RunJobs() {
   if (sync_points_)
     sync_points_->Cancel();
 
+  if (!active_jobs.empty()) {
+    // Kick pipelines parked in blocking I/O (cache waits, stalled network
+    // transfers) so cancellation takes effect in about a second instead of
+    // whenever the current read or write happens to finish.
+    IoCancellation::Request();
+  }
+
   for (auto& job : active_jobs)
     job->Cancel();
 
@@ -129,6 +170,12 @@ void JobManager::CancelJobs() {
   if (sync_points_)
     sync_points_->Cancel();
 
+  // Job::Cancel is only a request; pipelines notice it at their next loop
+  // iteration. Closing the I/O caches and aborting network transfers turns
+  // threads parked in blocking reads or writes around immediately, so the
+  // whole process can be torn down in about a second.
+  IoCancellation::Request();
+
   for (auto& job : jobs_)
     job->Cancel();
 }
@@ -10,10 +10,10 @@
 #include <functional>
 #include <map>
 #include <memory>
-#include <thread>
 #include <vector>
 
 #include <absl/synchronization/mutex.h>
+#include <absl/synchronization/notification.h>
 
 #include <packager/status.h>
 
@@ -37,8 +37,8 @@ class Job {
   // and returns it for convenience.
   const Status& Initialize();
 
-  // Begin the job in a new thread. This is only a request and will not block.
-  // If you want to wait for the job to complete, use |complete|.
+  // Begin the job on the shared thread pool. This is only a request and will
+  // not block. If you want to wait for the job to complete, use |complete|.
   // Use either Start() for threaded operation or Run() for non-threaded
   // operation.  DO NOT USE BOTH!
   void Start();
@@ -53,7 +53,8 @@ class Job {
   // block. If you want to wait for the job to complete, use |complete|.
   void Cancel();
 
-  // Join the thread, if any was started. Blocks until the thread has stopped.
+  // Wait for the job if Start() was called. Blocks until the job has
+  // finished running on the thread pool.
   void Join();
 
   // Get the current status of the job. If the job failed to initialize or
@@ -70,7 +71,10 @@ class Job {
   std::string name_;
   std::shared_ptr<OriginHandler> work_;
   OnCompleteFunction on_complete_;
-  std::unique_ptr<std::thread> thread_;
+  // Set by Start() and signaled when the posted task finishes, so Join() has
+  // something to wait on without a dedicated per-job thread.
+  bool started_ = false;
+  absl::Notification complete_notification_;
   Status status_;
 };
 
@@ -91,10 +95,10 @@ class JobManager {
   // the job, you need to call |RunJobs|.
   void Add(const std::string& name, std::shared_ptr<OriginHandler> handler);
 
-  // Initialize all registered jobs. If any job fails to initialize, this will
-  // return the error and it will not be safe to call |RunJobs| as not all jobs
-  // will be properly initialized.
-  Status InitializeJobs();
+  // Initialize all registered jobs concurrently. If any job fails to
+  // initialize, this will return the error and it will not be safe to call
+  // |RunJobs| as not all jobs will be properly initialized.
+  virtual Status InitializeJobs();
 
   // Run all registered jobs. Before calling this make sure that
   // |InitializedJobs| returned |Status::OK|. This call is blocking and will
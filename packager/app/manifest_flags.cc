@@ -42,3 +42,10 @@ ABSL_FLAG(bool,
           true,
           "True forces the muxer to order streams in the order given "
           "on the command-line. False uses the previous unordered behavior.");
+ABSL_FLAG(bool,
+          generate_manifest_delta_feed,
+          false,
+          "If enabled, an append-only binary feed of manifest changes is "
+          "written next to the MPD and/or HLS master playlist as "
+          "'<manifest path>.delta', so downstream consumers can track segment "
+          "additions and key rotations without re-parsing the manifests.");
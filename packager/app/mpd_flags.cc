@@ -23,6 +23,13 @@ ABSL_FLAG(bool,
           "Create a human readable format of MediaInfo. The output file name "
           "will be the name specified by output flag, suffixed with "
           "'.media_info'.");
+ABSL_FLAG(bool,
+          output_media_info_binary,
+          false,
+          "Write '.media_info' files in protobuf binary wire format instead "
+          "of human readable text format. Binary serialization is much "
+          "cheaper and smaller; mpd_generator accepts both formats. Only "
+          "used with --output_media_info.");
 ABSL_FLAG(std::string, mpd_output, "", "MPD output file name.");
 ABSL_FLAG(std::string,
           base_urls,
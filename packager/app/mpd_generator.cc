@@ -53,12 +53,14 @@ enum ExitStatus {
   kSuccess = 0,
   kEmptyInputError,
   kEmptyOutputError,
-  kFailedToWriteMpdToFileError
+  kFailedToWriteMpdToFileError,
+  kFailedToReadBundleError
 };
 
 ExitStatus CheckRequiredFlags() {
-  if (absl::GetFlag(FLAGS_input).empty()) {
-    LOG(ERROR) << "--input is required.";
+  if (absl::GetFlag(FLAGS_input).empty() &&
+      absl::GetFlag(FLAGS_input_bundle).empty()) {
+    LOG(ERROR) << "--input or --input_bundle is required.";
     return kEmptyInputError;
   }
 
@@ -75,8 +77,11 @@ ExitStatus RunMpdGenerator() {
   std::vector<std::string> base_urls;
   typedef std::vector<std::string>::const_iterator Iterator;
 
-  std::vector<std::string> input_files =
-      absl::StrSplit(absl::GetFlag(FLAGS_input), ",", absl::AllowEmpty());
+  std::vector<std::string> input_files;
+  if (!absl::GetFlag(FLAGS_input).empty()) {
+    input_files =
+        absl::StrSplit(absl::GetFlag(FLAGS_input), ",", absl::AllowEmpty());
+  }
 
   if (!absl::GetFlag(FLAGS_base_urls).empty()) {
     base_urls =
@@ -87,10 +92,17 @@ ExitStatus RunMpdGenerator() {
   for (Iterator it = base_urls.begin(); it != base_urls.end(); ++it)
     mpd_writer.AddBaseUrl(*it);
 
-  for (const std::string& file : input_files) {
-    if (!mpd_writer.AddFile(file)) {
-      LOG(WARNING) << "MpdWriter failed to read " << file << ", skipping.";
-    }
+  const std::string input_bundle = absl::GetFlag(FLAGS_input_bundle);
+  if (!input_bundle.empty() && !mpd_writer.AddMediaInfoBundle(input_bundle)) {
+    LOG(ERROR) << "MpdWriter failed to load media info bundle "
+               << input_bundle;
+    return kFailedToReadBundleError;
+  }
+
+  // Files are read and parsed concurrently; MediaInfos still end up in
+  // --input order.
+  if (!mpd_writer.AddFiles(input_files)) {
+    LOG(WARNING) << "Some media info files could not be read, skipping.";
   }
 
   if (!mpd_writer.WriteMpdToFile(absl::GetFlag(FLAGS_output).c_str())) {
@@ -13,6 +13,13 @@ ABSL_FLAG(std::string,
           input,
           "",
           "Comma separated list of MediaInfo input files.");
+ABSL_FLAG(std::string,
+          input_bundle,
+          "",
+          "A single file holding any number of binary MediaInfo messages, "
+          "each prefixed with its serialized size as a protobuf varint. Its "
+          "MediaInfos are added before the ones from --input. At least one "
+          "of --input and --input_bundle is required.");
 ABSL_FLAG(std::string, output, "", "MPD output file name.");
 ABSL_FLAG(std::string,
           base_urls,
@@ -7,6 +7,7 @@
 #include <packager/app/muxer_factory.h>
 
 #include <packager/media/base/muxer.h>
+#include <packager/media/event/segment_checkpoint_muxer_listener.h>
 #include <packager/media/formats/mp2t/ts_muxer.h>
 #include <packager/media/formats/mp4/mp4_muxer.h>
 #include <packager/media/formats/packed_audio/packed_audio_writer.h>
@@ -22,7 +23,8 @@ MuxerFactory::MuxerFactory(const PackagingParams& packaging_params)
     : mp4_params_(packaging_params.mp4_output_params),
       temp_dir_(packaging_params.temp_dir),
       transport_stream_timestamp_offset_ms_(
-          packaging_params.transport_stream_timestamp_offset_ms) {}
+          packaging_params.transport_stream_timestamp_offset_ms),
+      ts_mux_rate_bps_(packaging_params.ts_mux_rate_bps) {}
 
 std::shared_ptr<Muxer> MuxerFactory::CreateMuxer(
     MediaContainerName output_format,
@@ -31,10 +33,15 @@ std::shared_ptr<Muxer> MuxerFactory::CreateMuxer(
   options.mp4_params = mp4_params_;
   options.transport_stream_timestamp_offset_ms =
       transport_stream_timestamp_offset_ms_;
+  options.ts_mux_rate_bps = ts_mux_rate_bps_;
   options.temp_dir = temp_dir_;
   options.output_file_name = stream.output;
   options.segment_template = stream.segment_template;
   options.bandwidth = stream.bandwidth;
+  if (resume_checkpoint_ && !stream.segment_template.empty()) {
+    options.initial_segment_number =
+        resume_checkpoint_->GetNextSegmentNumber(stream.segment_template);
+  }
 
   std::shared_ptr<Muxer> muxer;
 
@@ -71,7 +78,9 @@ std::shared_ptr<Muxer> MuxerFactory::CreateMuxer(
 
   // We successfully created a muxer, then there is a couple settings
   // we should set before returning it.
-  if (clock_) {
+  if (virtual_clock_) {
+    muxer->set_virtual_clock(virtual_clock_);
+  } else if (clock_) {
     muxer->set_clock(clock_);
   }
 
@@ -81,5 +90,9 @@ std::shared_ptr<Muxer> MuxerFactory::CreateMuxer(
 void MuxerFactory::OverrideClock(std::shared_ptr<Clock> clock) {
   clock_ = clock;
 }
+
+void MuxerFactory::UseVirtualClock(std::shared_ptr<VirtualClock> clock) {
+  virtual_clock_ = clock;
+}
 }  // namespace media
 }  // namespace shaka
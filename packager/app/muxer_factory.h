@@ -13,6 +13,7 @@
 #include <packager/media/base/container_names.h>
 #include <packager/mp4_output_params.h>
 #include <packager/mpd/base/mpd_builder.h>
+#include <packager/utils/virtual_clock.h>
 
 namespace shaka {
 struct PackagingParams;
@@ -22,6 +23,7 @@ namespace media {
 
 class Muxer;
 class MuxerListener;
+class SegmentCheckpoint;
 
 /// To make it easier to create muxers, this factory allows for all
 /// configuration to be set at the factory level so that when a function
@@ -39,10 +41,23 @@ class MuxerFactory {
   /// this will replace the clock for all muxers created after this call.
   void OverrideClock(std::shared_ptr<Clock> clock);
 
+  /// Drive muxers created after this call from @a clock, a media-time driven
+  /// clock that the muxers advance as they finalize segments (see
+  /// PackagingParams::enable_virtual_clock). Takes precedence over
+  /// OverrideClock().
+  void UseVirtualClock(std::shared_ptr<VirtualClock> clock);
+
   void SetTsStreamOffset(int32_t offset_ms) {
     transport_stream_timestamp_offset_ms_ = offset_ms;
   }
 
+  /// Resume segment numbering from @a checkpoint: muxers created afterwards
+  /// start their $Number$ counter at the position the checkpoint recorded for
+  /// their segment template. @a checkpoint must outlive the factory.
+  void SetResumeCheckpoint(const SegmentCheckpoint* checkpoint) {
+    resume_checkpoint_ = checkpoint;
+  }
+
  private:
   MuxerFactory(const MuxerFactory&) = delete;
   MuxerFactory& operator=(const MuxerFactory&) = delete;
@@ -50,7 +65,10 @@ class MuxerFactory {
   const Mp4OutputParams mp4_params_;
   const std::string temp_dir_;
   int32_t transport_stream_timestamp_offset_ms_ = 0;
+  const int64_t ts_mux_rate_bps_ = 0;
   std::shared_ptr<Clock> clock_ = nullptr;
+  std::shared_ptr<VirtualClock> virtual_clock_ = nullptr;
+  const SegmentCheckpoint* resume_checkpoint_ = nullptr;
 };
 
 }  // namespace media
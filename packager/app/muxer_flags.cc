@@ -54,6 +54,21 @@ ABSL_FLAG(bool,
           mp4_include_pssh_in_stream,
           true,
           "MP4 only: include pssh in the encrypted stream.");
+ABSL_FLAG(bool,
+          output_key_frame_index,
+          false,
+          "Write a binary key frame index (timestamp, byte offset and size "
+          "per key frame) next to each output, suffixed with "
+          "'.key_frame_index'. Later trick-play or thumbnail packaging jobs "
+          "can use it to locate key frames without demuxing the rendition.");
+ABSL_FLAG(bool,
+          output_segment_digests,
+          false,
+          "Write a sha256sum-compatible sidecar next to each output, "
+          "suffixed with '.sha256', listing the SHA-256 digest of every "
+          "finalized media segment. Digests are computed inline while "
+          "segments are written, so checksummed origin uploads need no "
+          "extra read pass.");
 ABSL_FLAG(int32_t,
           transport_stream_timestamp_offset_ms,
           100,
@@ -62,6 +77,15 @@ ABSL_FLAG(int32_t,
           "input. For example, timestamps from ISO-BMFF after adjusted by "
           "EditList could be negative. In transport streams, timestamps are "
           "not allowed to be less than zero.");
+ABSL_FLAG(int64_t,
+          ts_mux_rate_bps,
+          0,
+          "If nonzero, mux MPEG2-TS output at this constant rate, in bits "
+          "per second, by interleaving null packets so every segment "
+          "occupies exactly its duration at the rate. PCRs are restamped to "
+          "the constant-rate schedule. The rate must exceed the stream's "
+          "peak bitrate; segments that do not fit are left variable-rate "
+          "with a warning. 0 (the default) keeps variable-rate output.");
 ABSL_FLAG(
     int32_t,
     default_text_zero_bias_ms,
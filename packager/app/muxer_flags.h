@@ -20,7 +20,10 @@ ABSL_DECLARE_FLAG(bool, fragment_sap_aligned);
 ABSL_DECLARE_FLAG(bool, generate_sidx_in_media_segments);
 ABSL_DECLARE_FLAG(std::string, temp_dir);
 ABSL_DECLARE_FLAG(bool, mp4_include_pssh_in_stream);
+ABSL_DECLARE_FLAG(bool, output_key_frame_index);
+ABSL_DECLARE_FLAG(bool, output_segment_digests);
 ABSL_DECLARE_FLAG(int32_t, transport_stream_timestamp_offset_ms);
+ABSL_DECLARE_FLAG(int64_t, ts_mux_rate_bps);
 ABSL_DECLARE_FLAG(int32_t, default_text_zero_bias_ms);
 
 #endif  // APP_MUXER_FLAGS_H_
@@ -4,12 +4,24 @@
 // license that can be found in the LICENSE file or at
 // https://developers.google.com/open-source/licenses/bsd
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <optional>
 
 #if defined(OS_WIN)
 #include <codecvt>
 #include <functional>
+#else
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <thread>
 #endif  // defined(OS_WIN)
 
 #include <absl/flags/flag.h>
@@ -19,9 +31,11 @@
 #include <absl/log/globals.h>
 #include <absl/log/initialize.h>
 #include <absl/log/log.h>
+#include <absl/strings/ascii.h>
 #include <absl/strings/numbers.h>
 #include <absl/strings/str_format.h>
 #include <absl/strings/str_split.h>
+#include <absl/synchronization/mutex.h>
 
 #include <packager/app/ad_cue_generator_flags.h>
 #include <packager/app/crypto_flags.h>
@@ -37,8 +51,10 @@
 #include <packager/app/widevine_encryption_flags.h>
 #include <packager/file.h>
 #include <packager/kv_pairs/kv_pairs.h>
+#include <packager/media/base/media_handler.h>
 #include <packager/tools/license_notice.h>
 #include <packager/utils/string_trim_split.h>
+#include <packager/utils/trace_event.h>
 
 ABSL_FLAG(bool, dump_stream_info, false, "Dump demuxed stream info.");
 ABSL_FLAG(bool, licenses, false, "Dump licenses.");
@@ -57,6 +73,139 @@ ABSL_FLAG(bool,
           single_threaded,
           false,
           "If enabled, only use one thread when generating content.");
+ABSL_FLAG(bool,
+          benchmark,
+          false,
+          "Run the configured packaging job repeatedly and report wall-clock "
+          "time, samples/sec and MB/sec muxed, per-handler pipeline stats and "
+          "peak RSS. Outputs are still written, and overwritten by each run. "
+          "Implies pipeline stats collection.");
+ABSL_FLAG(int32_t,
+          numa_node,
+          -1,
+          "If nonnegative, pin all packaging threads to the CPUs of this "
+          "NUMA node (Linux only). Buffers allocated by the pipeline then "
+          "stay node-local via the kernel's first-touch policy. Run one "
+          "packager process per node on multi-socket hosts.");
+ABSL_FLAG(uint64_t,
+          demux_buffer_bytes,
+          0,
+          "Per-stream byte budget of the demuxer's parallel dispatch queues. "
+          "Parsing is throttled once a stream holds this many undispatched "
+          "sample bytes (the high watermark) and resumes below half of it, "
+          "so queue memory follows each stream's bitrate instead of a fixed "
+          "sample count. 0 uses the built-in default (8 MB).");
+ABSL_FLAG(bool,
+          share_dual_manifest_segments,
+          false,
+          "Mux a track listed both as dash_only and hls_only only once when "
+          "the two descriptors differ solely in manifest attributes. Both "
+          "manifests then reference the dash descriptor's segments and the "
+          "hls_only descriptor's output naming is ignored.");
+ABSL_FLAG(bool,
+          deduplicate_repeated_streams,
+          false,
+          "Share one pipeline among stream descriptors that resolve to "
+          "byte-identical outputs and differ only in output naming, e.g. the "
+          "same audio listed per ladder variant. The extra names are served "
+          "by copying the muxed files, so the track is packaged only once.");
+ABSL_FLAG(uint64_t,
+          sample_buffer_spill_bytes,
+          0,
+          "Per-stream byte budget for sample payloads buffered while waiting "
+          "for a synchronization point (cue alignment, trick play). Payloads "
+          "beyond the budget are spilled to a temporary file in --temp_dir "
+          "and read back on dispatch. 0 keeps all buffered payloads in "
+          "memory.");
+ABSL_FLAG(uint64_t,
+          job_memory_limit_bytes,
+          0,
+          "Per-job byte budget for buffered media payloads, shared by the "
+          "demuxer queues and sample queues of each job's pipeline. Once a "
+          "job's buffered bytes cross three quarters of the budget its "
+          "queues spill to disk and its parser throttles early until usage "
+          "falls below half, so one misbehaving input degrades to a "
+          "throttled job instead of exhausting the host's memory. 0 "
+          "disables job-level accounting.");
+ABSL_FLAG(int32_t,
+          benchmark_iterations,
+          3,
+          "Number of packaging runs in --benchmark mode.");
+ABSL_FLAG(double,
+          benchmark_max_seconds,
+          0,
+          "Wall-clock budget for the best run in --benchmark mode. If the "
+          "best of --benchmark_iterations runs takes longer, the benchmark "
+          "fails with a nonzero exit code. Combine with a replay:// input of "
+          "a recorded production session to validate a release against "
+          "real-world load. 0 disables the budget.");
+ABSL_FLAG(double,
+          benchmark_min_mbps,
+          0,
+          "Muxed throughput budget, in MB/sec, for the best run in "
+          "--benchmark mode. If every run muxes slower than this, the "
+          "benchmark fails with a nonzero exit code. 0 disables the budget.");
+ABSL_FLAG(int32_t,
+          shard_count,
+          1,
+          "Total number of packager processes sharing the work. Each process "
+          "must be launched with the same command line except for "
+          "--shard_index, and packages every shard_count-th stream descriptor "
+          "by command line position, so the split is deterministic across "
+          "hosts. Use --output_media_info on the workers and merge the "
+          "resulting .media_info files into one manifest with mpd_generator.");
+ABSL_FLAG(int32_t,
+          shard_index,
+          0,
+          "Zero-based index of this process among --shard_count workers.");
+ABSL_FLAG(double,
+          watchdog_stall_seconds,
+          0,
+          "If nonzero, run a watchdog that declares a stall when no pipeline "
+          "thread has made progress for this many seconds, then logs each "
+          "thread's last activity and timestamp, the pipeline stats and "
+          "stall histograms, and flushes the trace ring (see --trace_output) "
+          "— so a wedged channel produces an actionable report instead of "
+          "hanging silently. 0 disables the watchdog.");
+ABSL_FLAG(bool,
+          watchdog_fail_fast,
+          false,
+          "With --watchdog_stall_seconds, also cancel all jobs when a stall "
+          "is detected so the process exits and a supervisor can restart it, "
+          "instead of waiting for an external alarm.");
+ABSL_FLAG(std::string,
+          checkpoint_file,
+          "",
+          "Path of a live-state checkpoint file. When set, the packager "
+          "records each stream's next segment number there after every "
+          "finalized segment. Pass the same path as --resume_from on restart "
+          "to continue numbering at the live edge.");
+ABSL_FLAG(std::string,
+          resume_from,
+          "",
+          "Path of a checkpoint file written by a previous run (see "
+          "--checkpoint_file). Segment numbering resumes from the recorded "
+          "positions instead of starting over.");
+ABSL_FLAG(bool,
+          virtual_clock,
+          false,
+          "Drive the muxer clock and the MPD's publishTime and "
+          "availabilityStartTime from media timestamps instead of the system "
+          "clock. Virtual time starts at startup wall clock time and advances "
+          "to the end of every finalized segment, so with file inputs a long "
+          "live channel's sliding window, segment eviction and key rotation "
+          "behavior can be soak-tested faster than real time. Combine with "
+          "--benchmark to measure it.");
+ABSL_FLAG(std::string,
+          cue_injection_socket,
+          "",
+          "Path of a Unix domain socket to listen on for runtime ad cue "
+          "injection, e.g. from an out-of-band SCTE-35 feed. Each accepted "
+          "connection carries newline-separated cue start times in seconds "
+          "(input presentation time); each line is injected like an "
+          "--ad_cues entry and takes effect at the next key frame, without "
+          "restarting the pipeline. One status line (OK or ERROR ...) is "
+          "written back per cue line. Not supported on Windows.");
 
 // From absl/log:
 ABSL_DECLARE_FLAG(int, stderrthreshold);
@@ -340,6 +489,17 @@ std::optional<PackagingParams> GetPackagingParams() {
 
   packaging_params.temp_dir = absl::GetFlag(FLAGS_temp_dir);
   packaging_params.single_threaded = absl::GetFlag(FLAGS_single_threaded);
+  packaging_params.numa_node = absl::GetFlag(FLAGS_numa_node);
+  packaging_params.demux_buffer_bytes = absl::GetFlag(FLAGS_demux_buffer_bytes);
+  packaging_params.share_dual_manifest_segments =
+      absl::GetFlag(FLAGS_share_dual_manifest_segments);
+  packaging_params.deduplicate_repeated_streams =
+      absl::GetFlag(FLAGS_deduplicate_repeated_streams);
+  packaging_params.sample_buffer_spill_bytes =
+      absl::GetFlag(FLAGS_sample_buffer_spill_bytes);
+  packaging_params.job_memory_limit_bytes =
+      absl::GetFlag(FLAGS_job_memory_limit_bytes);
+  packaging_params.enable_virtual_clock = absl::GetFlag(FLAGS_virtual_clock);
 
   AdCueGeneratorParams& ad_cue_generator_params =
       packaging_params.ad_cue_generator_params;
@@ -347,6 +507,8 @@ std::optional<PackagingParams> GetPackagingParams() {
                    &ad_cue_generator_params.cue_points)) {
     return std::nullopt;
   }
+  packaging_params.allow_ad_cue_injection =
+      !absl::GetFlag(FLAGS_cue_injection_socket).empty();
 
   ChunkingParams& chunking_params = packaging_params.chunking_params;
   chunking_params.segment_duration_in_seconds =
@@ -403,6 +565,8 @@ std::optional<PackagingParams> GetPackagingParams() {
         absl::GetFlag(FLAGS_max_uhd1_pixels), std::placeholders::_1);
     encryption_params.playready_extra_header_data =
         absl::GetFlag(FLAGS_playready_extra_header_data);
+    encryption_params.encryption_worker_count =
+        absl::GetFlag(FLAGS_encryption_worker_count);
   }
   switch (encryption_params.key_provider) {
     case KeyProvider::kWidevine: {
@@ -475,10 +639,19 @@ std::optional<PackagingParams> GetPackagingParams() {
 
   packaging_params.transport_stream_timestamp_offset_ms =
       absl::GetFlag(FLAGS_transport_stream_timestamp_offset_ms);
+  packaging_params.ts_mux_rate_bps = absl::GetFlag(FLAGS_ts_mux_rate_bps);
   packaging_params.default_text_zero_bias_ms =
       absl::GetFlag(FLAGS_default_text_zero_bias_ms);
 
   packaging_params.output_media_info = absl::GetFlag(FLAGS_output_media_info);
+  packaging_params.output_media_info_binary =
+      absl::GetFlag(FLAGS_output_media_info_binary);
+  packaging_params.output_key_frame_index =
+      absl::GetFlag(FLAGS_output_key_frame_index);
+  packaging_params.output_segment_digests =
+      absl::GetFlag(FLAGS_output_segment_digests);
+  packaging_params.checkpoint_file = absl::GetFlag(FLAGS_checkpoint_file);
+  packaging_params.resume_from = absl::GetFlag(FLAGS_resume_from);
 
   MpdParams& mpd_params = packaging_params.mpd_params;
   mpd_params.mpd_output = absl::GetFlag(FLAGS_mpd_output);
@@ -521,6 +694,8 @@ std::optional<PackagingParams> GetPackagingParams() {
   mpd_params.include_mspr_pro =
       absl::GetFlag(FLAGS_include_mspr_pro_for_playready);
   mpd_params.low_latency_dash_mode = absl::GetFlag(FLAGS_low_latency_dash_mode);
+  mpd_params.generate_delta_feed =
+      absl::GetFlag(FLAGS_generate_manifest_delta_feed);
 
   HlsParams& hls_params = packaging_params.hls_params;
   if (!GetHlsPlaylistType(absl::GetFlag(FLAGS_hls_playlist_type),
@@ -540,6 +715,17 @@ std::optional<PackagingParams> GetPackagingParams() {
   hls_params.media_sequence_number =
       absl::GetFlag(FLAGS_hls_media_sequence_number);
   hls_params.start_time_offset = absl::GetFlag(FLAGS_hls_start_time_offset);
+  hls_params.generate_delta_feed =
+      absl::GetFlag(FLAGS_generate_manifest_delta_feed);
+
+  // Benchmark mode reports per-handler CPU, which needs timing collection.
+  if (absl::GetFlag(FLAGS_benchmark))
+    packaging_params.enable_pipeline_stats = true;
+
+  packaging_params.watchdog_stall_seconds =
+      absl::GetFlag(FLAGS_watchdog_stall_seconds);
+  packaging_params.watchdog_fail_fast =
+      absl::GetFlag(FLAGS_watchdog_fail_fast);
 
   TestParams& test_params = packaging_params.test_params;
   test_params.dump_stream_info = absl::GetFlag(FLAGS_dump_stream_info);
@@ -551,6 +737,226 @@ std::optional<PackagingParams> GetPackagingParams() {
   return packaging_params;
 }
 
+#if !defined(OS_WIN)
+// Listens on a Unix domain socket (see --cue_injection_socket) and feeds
+// newline-separated cue times to Packager::InjectAdCue() while Run() is
+// executing. Connections are served one at a time; a scheduler script can
+// check the per-line status replies to know whether a cue was accepted.
+class CueInjectionListener {
+ public:
+  explicit CueInjectionListener(Packager* packager) : packager_(packager) {}
+  ~CueInjectionListener() { Stop(); }
+
+  bool Start(const std::string& socket_path) {
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(addr.sun_path)) {
+      LOG(ERROR) << "--cue_injection_socket path is too long: " << socket_path;
+      return false;
+    }
+    strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+
+    listen_fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+      LOG(ERROR) << "Cannot create cue injection socket: " << strerror(errno);
+      return false;
+    }
+    // Remove a stale socket left behind by a previous run.
+    unlink(socket_path.c_str());
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) !=
+            0 ||
+        listen(listen_fd_, 1) != 0) {
+      LOG(ERROR) << "Cannot listen on " << socket_path << ": "
+                 << strerror(errno);
+      close(listen_fd_);
+      listen_fd_ = -1;
+      return false;
+    }
+    socket_path_ = socket_path;
+    thread_ = std::thread(&CueInjectionListener::ThreadMain, this);
+    LOG(INFO) << "Listening for ad cue injection on " << socket_path;
+    return true;
+  }
+
+  void Stop() {
+    if (listen_fd_ < 0)
+      return;
+    stopping_ = true;
+    // Unblocks accept(); an in-flight client read is unblocked below.
+    shutdown(listen_fd_, SHUT_RDWR);
+    {
+      absl::MutexLock lock(&mutex_);
+      if (client_fd_ >= 0)
+        shutdown(client_fd_, SHUT_RDWR);
+    }
+    thread_.join();
+    close(listen_fd_);
+    listen_fd_ = -1;
+    unlink(socket_path_.c_str());
+  }
+
+ private:
+  CueInjectionListener(const CueInjectionListener&) = delete;
+  CueInjectionListener& operator=(const CueInjectionListener&) = delete;
+
+  void ThreadMain() {
+    while (!stopping_) {
+      const int client = accept(listen_fd_, nullptr, nullptr);
+      if (client < 0) {
+        if (stopping_ || errno == EINVAL)
+          break;
+        if (errno == EINTR)
+          continue;
+        LOG(ERROR) << "Cue injection accept failed: " << strerror(errno);
+        break;
+      }
+      {
+        absl::MutexLock lock(&mutex_);
+        client_fd_ = client;
+      }
+      ServeClient(client);
+      {
+        absl::MutexLock lock(&mutex_);
+        client_fd_ = -1;
+      }
+      close(client);
+    }
+  }
+
+  void ServeClient(int fd) {
+    std::string buffer;
+    char chunk[256];
+    ssize_t bytes;
+    while ((bytes = read(fd, chunk, sizeof(chunk))) > 0) {
+      buffer.append(chunk, bytes);
+      size_t newline;
+      while ((newline = buffer.find('\n')) != std::string::npos) {
+        InjectLine(buffer.substr(0, newline), fd);
+        buffer.erase(0, newline + 1);
+      }
+    }
+    // A final line without a trailing newline still counts.
+    if (!buffer.empty())
+      InjectLine(buffer, fd);
+  }
+
+  void InjectLine(const std::string& line, int fd) {
+    const std::string trimmed(absl::StripAsciiWhitespace(line));
+    if (trimmed.empty())
+      return;
+
+    double time_in_seconds = 0;
+    Status status;
+    if (!absl::SimpleAtod(trimmed, &time_in_seconds)) {
+      status = Status(error::INVALID_ARGUMENT,
+                      "Cannot parse cue time '" + trimmed + "'.");
+    } else {
+      status = packager_->InjectAdCue(time_in_seconds);
+    }
+    if (!status.ok())
+      LOG(WARNING) << "Cue injection failed: " << status.ToString();
+
+    const std::string reply =
+        status.ok() ? "OK\n" : "ERROR " + status.ToString() + "\n";
+    if (write(fd, reply.data(), reply.size()) !=
+        static_cast<ssize_t>(reply.size())) {
+      VLOG(1) << "Failed to write cue injection reply.";
+    }
+  }
+
+  Packager* const packager_;
+  std::string socket_path_;
+  int listen_fd_ = -1;
+  std::atomic<bool> stopping_{false};
+  std::thread thread_;
+  absl::Mutex mutex_;
+  int client_fd_ ABSL_GUARDED_BY(mutex_) = -1;
+};
+#endif  // !defined(OS_WIN)
+
+// Runs the configured job graph --benchmark_iterations times and prints
+// throughput numbers suitable for capacity planning and A/B testing of
+// packaging options. A fresh Packager is used per run; the pipeline stats
+// counters reset with it since handlers unregister on destruction.
+int RunBenchmark(const PackagingParams& packaging_params,
+                 const std::vector<StreamDescriptor>& stream_descriptors) {
+  const int iterations = absl::GetFlag(FLAGS_benchmark_iterations);
+  if (iterations <= 0) {
+    LOG(ERROR) << "--benchmark_iterations must be positive.";
+    return kArgumentValidationFailed;
+  }
+
+  double best_seconds = 0;
+  double best_mbps = 0;
+  for (int i = 0; i < iterations; ++i) {
+    Packager packager;
+    Status status = packager.Initialize(packaging_params, stream_descriptors);
+    if (!status.ok()) {
+      LOG(ERROR) << "Failed to initialize packager: " << status.ToString();
+      return kArgumentValidationFailed;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    status = packager.Run();
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+            .count();
+    if (!status.ok()) {
+      LOG(ERROR) << "Packaging Error: " << status.ToString();
+      // A failed run is when the trace is most wanted.
+      TraceBuffer::WriteConfiguredOutput();
+      return kPackagingFailed;
+    }
+
+    uint64_t muxed_samples = 0;
+    uint64_t muxed_bytes = 0;
+    media::MediaHandlerStatsRegistry::GetSinkTotals(&muxed_samples,
+                                                    &muxed_bytes);
+    printf("Run %d/%d: %.3f s, %.0f samples/sec, %.2f MB/sec muxed\n", i + 1,
+           iterations, seconds, muxed_samples / seconds,
+           muxed_bytes / seconds / (1024.0 * 1024.0));
+    if (i + 1 == iterations)
+      printf("Pipeline stats: %s\n", packager.DumpPipelineStats().c_str());
+    if (best_seconds == 0 || seconds < best_seconds)
+      best_seconds = seconds;
+    best_mbps =
+        std::max(best_mbps, muxed_bytes / seconds / (1024.0 * 1024.0));
+  }
+  printf("Best of %d runs: %.3f s\n", iterations, best_seconds);
+
+  // Enforce the configured budgets on the best run, so a single noisy run
+  // does not fail a release validation that otherwise meets its budget.
+  bool budget_missed = false;
+  const double max_seconds = absl::GetFlag(FLAGS_benchmark_max_seconds);
+  if (max_seconds > 0 && best_seconds > max_seconds) {
+    LOG(ERROR) << "Benchmark budget missed: best run took " << best_seconds
+               << " s, budget is " << max_seconds << " s.";
+    budget_missed = true;
+  }
+  const double min_mbps = absl::GetFlag(FLAGS_benchmark_min_mbps);
+  if (min_mbps > 0 && best_mbps < min_mbps) {
+    LOG(ERROR) << "Benchmark budget missed: best run muxed " << best_mbps
+               << " MB/sec, budget is " << min_mbps << " MB/sec.";
+    budget_missed = true;
+  }
+
+  TraceBuffer::WriteConfiguredOutput();
+
+#if !defined(OS_WIN)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    // ru_maxrss is in kilobytes on Linux and bytes on macOS.
+#if defined(__APPLE__)
+    const double peak_rss_mb = usage.ru_maxrss / (1024.0 * 1024.0);
+#else
+    const double peak_rss_mb = usage.ru_maxrss / 1024.0;
+#endif
+    printf("Peak RSS: %.1f MB\n", peak_rss_mb);
+  }
+#endif  // !defined(OS_WIN)
+  return budget_missed ? kPackagingFailed : kSuccess;
+}
+
 int PackagerMain(int argc, char** argv) {
   absl::FlagsUsageConfig flag_config;
   flag_config.version_string = []() -> std::string {
@@ -613,6 +1019,45 @@ int PackagerMain(int argc, char** argv) {
     }
   }
 
+  const int32_t shard_count = absl::GetFlag(FLAGS_shard_count);
+  const int32_t shard_index = absl::GetFlag(FLAGS_shard_index);
+  if (shard_count < 1 || shard_index < 0 || shard_index >= shard_count) {
+    std::cerr << "--shard_index must be in [0, --shard_count)." << std::endl;
+    return kArgumentValidationFailed;
+  }
+  if (shard_count > 1) {
+    // Keep every shard_count-th descriptor, counting from shard_index. The
+    // selection depends only on command line position, so the shards are
+    // disjoint and complete across workers. Note that stream indexes were
+    // assigned above, before the filtering, so they stay consistent with a
+    // non-sharded run.
+    std::vector<StreamDescriptor> shard_descriptors;
+    for (size_t i = shard_index; i < stream_descriptors.size();
+         i += shard_count) {
+      shard_descriptors.push_back(stream_descriptors[i]);
+    }
+    if (shard_descriptors.empty()) {
+      std::cerr << "Shard " << shard_index << " of " << shard_count
+                << " selects no stream descriptors; use fewer shards."
+                << std::endl;
+      return kArgumentValidationFailed;
+    }
+    LOG(INFO) << "Shard " << shard_index << " of " << shard_count
+              << " packages " << shard_descriptors.size() << " of "
+              << stream_descriptors.size() << " streams.";
+    if (!packaging_params->mpd_params.mpd_output.empty() ||
+        !packaging_params->hls_params.master_playlist_output.empty()) {
+      LOG(WARNING) << "Manifest output in sharded mode only covers this "
+                      "shard's streams. Use --output_media_info on every "
+                      "worker and merge the .media_info files with "
+                      "mpd_generator instead.";
+    }
+    stream_descriptors.swap(shard_descriptors);
+  }
+
+  if (absl::GetFlag(FLAGS_benchmark))
+    return RunBenchmark(packaging_params.value(), stream_descriptors);
+
   Packager packager;
   Status status =
       packager.Initialize(packaging_params.value(), stream_descriptors);
@@ -620,7 +1065,26 @@ int PackagerMain(int argc, char** argv) {
     LOG(ERROR) << "Failed to initialize packager: " << status.ToString();
     return kArgumentValidationFailed;
   }
+
+  const std::string cue_injection_socket =
+      absl::GetFlag(FLAGS_cue_injection_socket);
+#if defined(OS_WIN)
+  if (!cue_injection_socket.empty()) {
+    LOG(ERROR) << "--cue_injection_socket is not supported on Windows.";
+    return kArgumentValidationFailed;
+  }
+#else
+  CueInjectionListener cue_injection_listener(&packager);
+  if (!cue_injection_socket.empty() &&
+      !cue_injection_listener.Start(cue_injection_socket)) {
+    return kArgumentValidationFailed;
+  }
+#endif  // defined(OS_WIN)
+
   status = packager.Run();
+#if !defined(OS_WIN)
+  cue_injection_listener.Stop();
+#endif  // !defined(OS_WIN)
   if (!status.ok()) {
     LOG(ERROR) << "Packaging Error: " << status.ToString();
     return kPackagingFailed;
@@ -16,6 +16,15 @@ SingleThreadJobManager::SingleThreadJobManager(
     std::unique_ptr<SyncPointQueue> sync_points)
     : JobManager(std::move(sync_points)) {}
 
+Status SingleThreadJobManager::InitializeJobs() {
+  Status status;
+
+  for (auto& job : jobs_)
+    status.Update(job->Initialize());
+
+  return status;
+}
+
 Status SingleThreadJobManager::RunJobs() {
   Status status;
 
@@ -22,6 +22,9 @@ class SingleThreadJobManager : public JobManager {
   //        fails or is cancelled. It can be NULL.
   explicit SingleThreadJobManager(std::unique_ptr<SyncPointQueue> sync_points);
 
+  // Initialize all registered jobs serially in this thread.
+  Status InitializeJobs() override;
+
   // Run all registered jobs serially in this thread.
   Status RunJobs() override;
 };
@@ -0,0 +1,147 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/app/work_stealing_job_manager.h>
+
+#include <algorithm>
+#include <set>
+
+#include <absl/log/check.h>
+#include <absl/log/log.h>
+
+#include <packager/file/io_cancellation.h>
+#include <packager/media/chunking/sync_point_queue.h>
+#include <packager/media/origin/origin_handler.h>
+
+namespace shaka {
+namespace media {
+
+WorkStealingJobManager::WorkStealingJobManager(
+    std::unique_ptr<SyncPointQueue> sync_points,
+    size_t num_workers)
+    : JobManager(std::move(sync_points)),
+      num_workers_(num_workers ? num_workers
+                               : std::thread::hardware_concurrency()) {
+  if (!num_workers_)
+    num_workers_ = 1;
+}
+
+Status WorkStealingJobManager::RunJobs() {
+  // There is no point spinning up more workers than jobs.
+  size_t num_workers = std::min(num_workers_, jobs_.size());
+
+  // With ad cues the jobs are not independent units of work: every stream's
+  // CueAlignmentHandler registers a thread with the shared SyncPointQueue,
+  // and GetNext() only promotes a hint once all registered threads are
+  // waiting. A pool smaller than the job count would leave some jobs queued
+  // forever while the running ones block in GetNext(), deadlocking the
+  // pipeline, so fall back to one worker per job.
+  if (sync_points_ && num_workers < jobs_.size()) {
+    LOG(WARNING) << "Ad cues require all " << jobs_.size()
+                 << " jobs to run concurrently; ignoring worker_thread_count="
+                 << num_workers_ << " and using one worker per job.";
+    num_workers = jobs_.size();
+  }
+
+  worker_queues_.clear();
+  for (size_t i = 0; i < num_workers; i++)
+    worker_queues_.emplace_back(new WorkerQueue);
+
+  // Distribute jobs round-robin across the worker deques. Workers whose
+  // deques drain early will steal from the others, so the initial placement
+  // only matters for locality, not for balance.
+  for (size_t i = 0; i < jobs_.size(); i++) {
+    WorkerQueue* queue = worker_queues_[i % num_workers].get();
+    absl::MutexLock lock(&queue->mutex);
+    queue->jobs.push_back(jobs_[i].get());
+  }
+
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < num_workers; i++)
+    workers.emplace_back(&WorkStealingJobManager::WorkerMain, this, i);
+
+  // Wait for all jobs to complete or any job to error. This mirrors
+  // JobManager::RunJobs, except that completion unblocks a pool worker
+  // instead of retiring a dedicated thread.
+  std::set<Job*> active_jobs;
+  for (auto& job : jobs_)
+    active_jobs.insert(job.get());
+
+  Status status;
+  {
+    absl::MutexLock lock(&mutex_);
+    while (status.ok() && active_jobs.size()) {
+      // any_job_complete_ is protected by mutex_.
+      any_job_complete_.Wait(&mutex_);
+
+      // complete_ is protected by mutex_.
+      for (const auto& entry : complete_) {
+        Job* job = entry.first;
+        bool complete = entry.second;
+        if (complete) {
+          status.Update(job->status());
+          active_jobs.erase(job);
+        }
+      }
+    }
+  }
+
+  // If the main loop has exited and there are still jobs running,
+  // we need to cancel them and clean-up.
+  if (sync_points_)
+    sync_points_->Cancel();
+
+  if (!active_jobs.empty()) {
+    // Kick pipelines parked in blocking I/O (cache waits, stalled network
+    // transfers) so cancellation takes effect in about a second instead of
+    // whenever the current read or write happens to finish.
+    IoCancellation::Request();
+  }
+
+  for (auto& job : active_jobs)
+    job->Cancel();
+
+  for (auto& worker : workers)
+    worker.join();
+
+  return status;
+}
+
+Job* WorkStealingJobManager::TakeJob(size_t worker_index) {
+  // Fast path: pop from the front of our own deque.
+  {
+    WorkerQueue* queue = worker_queues_[worker_index].get();
+    absl::MutexLock lock(&queue->mutex);
+    if (!queue->jobs.empty()) {
+      Job* job = queue->jobs.front();
+      queue->jobs.pop_front();
+      return job;
+    }
+  }
+
+  // Slow path: steal from the back of a sibling's deque, starting with our
+  // nearest neighbor to spread the stealing traffic around.
+  for (size_t i = 1; i < worker_queues_.size(); i++) {
+    WorkerQueue* victim =
+        worker_queues_[(worker_index + i) % worker_queues_.size()].get();
+    absl::MutexLock lock(&victim->mutex);
+    if (!victim->jobs.empty()) {
+      Job* job = victim->jobs.back();
+      victim->jobs.pop_back();
+      return job;
+    }
+  }
+
+  return nullptr;
+}
+
+void WorkStealingJobManager::WorkerMain(size_t worker_index) {
+  while (Job* job = TakeJob(worker_index))
+    job->Run();
+}
+
+}  // namespace media
+}  // namespace shaka
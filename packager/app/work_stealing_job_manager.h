@@ -0,0 +1,66 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_APP_WORK_STEALING_JOB_MANAGER_H_
+#define PACKAGER_APP_WORK_STEALING_JOB_MANAGER_H_
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <absl/base/thread_annotations.h>
+#include <absl/synchronization/mutex.h>
+
+#include <packager/app/job_manager.h>
+
+namespace shaka {
+namespace media {
+
+// A subclass of JobManager that runs all the jobs on a fixed-size pool of
+// worker threads instead of spawning one dedicated thread per job. Each worker
+// owns a deque of pending jobs; a worker pops from the front of its own deque
+// and, when that runs dry, steals from the back of a sibling's deque. This
+// keeps thread count bounded (and context switching cheap) even when hundreds
+// of packaging jobs are registered.
+class WorkStealingJobManager : public JobManager {
+ public:
+  // @param sync_points is an optional SyncPointQueue used to synchronize and
+  //        align cue points. JobManager cancels @a sync_points when any job
+  //        fails or is cancelled. It can be NULL.
+  // @param num_workers is the number of worker threads in the pool. If 0, the
+  //        number of hardware threads is used.
+  WorkStealingJobManager(std::unique_ptr<SyncPointQueue> sync_points,
+                         size_t num_workers);
+
+  // Run all registered jobs across the worker pool. Blocks until all jobs
+  // exit. Before calling this make sure that |InitializeJobs| returned
+  // |Status::OK|.
+  Status RunJobs() override;
+
+ private:
+  // Per-worker job deque. Owners pop from the front; thieves steal from the
+  // back, so an owner and a thief only contend when one job remains.
+  struct WorkerQueue {
+    absl::Mutex mutex;
+    std::deque<Job*> jobs ABSL_GUARDED_BY(mutex);
+  };
+
+  // Pop a job from |worker_index|'s own deque, or steal one from a sibling.
+  // Returns NULL when no work is left anywhere.
+  Job* TakeJob(size_t worker_index);
+
+  void WorkerMain(size_t worker_index);
+
+  size_t num_workers_;
+  std::vector<std::unique_ptr<WorkerQueue>> worker_queues_;
+};
+
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_APP_WORK_STEALING_JOB_MANAGER_H_
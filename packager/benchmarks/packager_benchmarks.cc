@@ -0,0 +1,209 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+//
+// Microbenchmarks for hot-path primitives. These use the same corpora as the
+// unit tests (packager/media/test/data) so results are comparable across
+// machines and changes. Run the packager_benchmarks target directly; it is
+// not registered with ctest.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <absl/log/check.h>
+#include <benchmark/benchmark.h>
+
+#include <packager/media/base/aes_encryptor.h>
+#include <packager/media/base/buffer_writer.h>
+#include <packager/media/codecs/h264_parser.h>
+#include <packager/media/codecs/nalu_reader.h>
+#include <packager/media/formats/mp2t/pes_packet.h>
+#include <packager/media/formats/mp2t/program_map_table_writer.h>
+#include <packager/media/formats/mp2t/ts_writer.h>
+#include <packager/media/formats/mp4/box_reader.h>
+#include <packager/media/test/test_data_util.h>
+#include <packager/mpd/base/adaptation_set.h>
+#include <packager/mpd/base/media_info.pb.h>
+#include <packager/mpd/base/mpd_builder.h>
+#include <packager/mpd/base/mpd_options.h>
+#include <packager/mpd/base/period.h>
+
+namespace shaka {
+namespace media {
+namespace {
+
+// Walks every NAL unit of an AnnexB byte stream, which is the inner loop of
+// all H.26x content analysis (keyframe detection, SPS/PPS extraction).
+void BM_NaluReaderAdvance(benchmark::State& state) {
+  const std::vector<uint8_t> stream = ReadTestDataFile("test-25fps.h264");
+  CHECK(!stream.empty());
+
+  for (auto _ : state) {
+    NaluReader reader(Nalu::kH264, kIsAnnexbByteStream, stream.data(),
+                      stream.size());
+    Nalu nalu;
+    int num_nalus = 0;
+    while (reader.Advance(&nalu) == NaluReader::kOk)
+      num_nalus++;
+    benchmark::DoNotOptimize(num_nalus);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(stream.size()));
+}
+BENCHMARK(BM_NaluReaderAdvance);
+
+// Parses the slice headers of every video slice in the stream, after feeding
+// the parser the parameter sets it needs.
+void BM_H264ParseSliceHeader(benchmark::State& state) {
+  const std::vector<uint8_t> stream = ReadTestDataFile("test-25fps.h264");
+  CHECK(!stream.empty());
+
+  for (auto _ : state) {
+    H264Parser parser;
+    NaluReader reader(Nalu::kH264, kIsAnnexbByteStream, stream.data(),
+                      stream.size());
+    Nalu nalu;
+    int num_slices = 0;
+    while (reader.Advance(&nalu) == NaluReader::kOk) {
+      int id;
+      if (nalu.type() == Nalu::H264_SPS) {
+        CHECK_EQ(H264Parser::kOk, parser.ParseSps(nalu, &id));
+      } else if (nalu.type() == Nalu::H264_PPS) {
+        CHECK_EQ(H264Parser::kOk, parser.ParsePps(nalu, &id));
+      } else if (nalu.is_video_slice()) {
+        H264SliceHeader slice_header;
+        CHECK_EQ(H264Parser::kOk, parser.ParseSliceHeader(nalu, &slice_header));
+        num_slices++;
+      }
+    }
+    benchmark::DoNotOptimize(num_slices);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(stream.size()));
+}
+BENCHMARK(BM_H264ParseSliceHeader);
+
+// Raw AES-CBC throughput, the cost floor of every encrypted packaging job.
+void BM_AesCbcEncryptorCrypt(benchmark::State& state) {
+  const std::vector<uint8_t> key(16, 0x42);
+  const std::vector<uint8_t> iv(16, 0x24);
+  AesCbcEncryptor encryptor(kNoPadding);
+  CHECK(encryptor.InitializeWithIv(key, iv));
+
+  const std::vector<uint8_t> plaintext(state.range(0), 0xab);
+  std::vector<uint8_t> ciphertext;
+  for (auto _ : state) {
+    CHECK(encryptor.Crypt(plaintext, &ciphertext));
+    benchmark::DoNotOptimize(ciphertext.data());
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(plaintext.size()));
+}
+BENCHMARK(BM_AesCbcEncryptorCrypt)->Arg(4096)->Arg(1 << 20);
+
+// Walks the top-level box structure of a typical MP4 file and scans the
+// children of 'moov', which is what every MP4 parse starts with.
+void BM_BoxReaderReadBox(benchmark::State& state) {
+  const std::vector<uint8_t> file = ReadTestDataFile("bear-1280x720.mp4");
+  CHECK(!file.empty());
+
+  for (auto _ : state) {
+    size_t pos = 0;
+    int num_boxes = 0;
+    while (pos + 8 <= file.size()) {
+      bool err = false;
+      FourCC type;
+      uint64_t box_size;
+      if (!mp4::BoxReader::StartBox(file.data() + pos, file.size() - pos,
+                                    &type, &box_size, &err) ||
+          err) {
+        break;
+      }
+      std::unique_ptr<mp4::BoxReader> reader(mp4::BoxReader::ReadBox(
+          file.data() + pos, file.size() - pos, &err));
+      CHECK(!err);
+      if (reader && reader->type() == FOURCC_moov)
+        CHECK(reader->ScanChildren());
+      num_boxes++;
+      pos += box_size;
+    }
+    benchmark::DoNotOptimize(num_boxes);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(file.size()));
+}
+BENCHMARK(BM_BoxReaderReadBox);
+
+// Packetizes a segment worth of PES packets into 188-byte TS packets.
+void BM_TsWriterAddPesPacket(benchmark::State& state) {
+  const size_t kPesPayloadSize = 32 * 1024;
+  const int kPesPacketsPerSegment = 30;
+
+  for (auto _ : state) {
+    mp2t::TsWriter writer(
+        std::make_unique<mp2t::VideoProgramMapTableWriter>(kCodecH264));
+    BufferWriter buffer;
+    CHECK(writer.NewSegment(&buffer));
+    for (int i = 0; i < kPesPacketsPerSegment; i++) {
+      auto pes = std::make_unique<mp2t::PesPacket>();
+      pes->set_stream_id(0xe0);
+      pes->set_pts(90000 + i * 3000);
+      pes->set_dts(90000 + i * 3000);
+      pes->set_is_key_frame(i == 0);
+      pes->mutable_data()->assign(kPesPayloadSize, 0x55);
+      CHECK(writer.AddPesPacket(std::move(pes), &buffer));
+    }
+    benchmark::DoNotOptimize(buffer.Size());
+  }
+  state.SetBytesProcessed(state.iterations() * kPesPacketsPerSegment *
+                          static_cast<int64_t>(kPesPayloadSize));
+}
+BENCHMARK(BM_TsWriterAddPesPacket);
+
+MediaInfo GetVideoMediaInfo(int index) {
+  MediaInfo media_info;
+  media_info.set_bandwidth(1000000 + index * 500000);
+  media_info.set_reference_time_scale(90000);
+  media_info.set_container_type(MediaInfo::CONTAINER_MP4);
+  media_info.set_media_file_name("video_" + std::to_string(index) + ".mp4");
+
+  MediaInfo::VideoInfo* video_info = media_info.mutable_video_info();
+  video_info->set_codec("avc1.64001f");
+  video_info->set_width(640 + index * 2);
+  video_info->set_height(360 + index);
+  video_info->set_time_scale(90000);
+  video_info->set_frame_duration(3000);
+  video_info->set_pixel_width(1);
+  video_info->set_pixel_height(1);
+  return media_info;
+}
+
+// Serializes an on-demand MPD with state.range(0) video representations.
+void BM_MpdBuilderToString(benchmark::State& state) {
+  MpdOptions mpd_options;
+  MpdBuilder mpd_builder(mpd_options);
+  mpd_builder.AddBaseUrl("http://example.com/");
+  Period* period = mpd_builder.GetOrCreatePeriod(0.0);
+  for (int i = 0; i < state.range(0); i++) {
+    const MediaInfo media_info = GetVideoMediaInfo(i);
+    AdaptationSet* adaptation_set = period->GetOrCreateAdaptationSet(
+        media_info, /* content_protection_in_adaptation_set= */ true);
+    CHECK(adaptation_set->AddRepresentation(media_info));
+  }
+
+  std::string output;
+  for (auto _ : state) {
+    output.clear();
+    CHECK(mpd_builder.ToString(&output));
+    benchmark::DoNotOptimize(output.data());
+  }
+}
+BENCHMARK(BM_MpdBuilderToString)->Arg(1)->Arg(16);
+
+}  // namespace
+}  // namespace media
+}  // namespace shaka
@@ -0,0 +1,63 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/file/async_file_deleter.h>
+
+#include <functional>
+#include <utility>
+
+#include <absl/log/log.h>
+
+#include <packager/file.h>
+#include <packager/file/thread_pool.h>
+
+namespace shaka {
+
+AsyncFileDeleter::AsyncFileDeleter() = default;
+
+AsyncFileDeleter::~AsyncFileDeleter() {
+  WaitForPendingDeletes();
+}
+
+void AsyncFileDeleter::Delete(const std::string& file_name) {
+  absl::MutexLock lock(&mutex_);
+  pending_.push_back(file_name);
+  if (!processing_) {
+    processing_ = true;
+    ThreadPool::instance.PostTask(
+        std::bind(&AsyncFileDeleter::ProcessDeletesTask, this));
+  }
+}
+
+void AsyncFileDeleter::WaitForPendingDeletes() {
+  absl::MutexLock lock(&mutex_);
+  mutex_.Await(absl::Condition(this, &AsyncFileDeleter::IsIdle));
+}
+
+void AsyncFileDeleter::ProcessDeletesTask() {
+  while (true) {
+    std::deque<std::string> batch;
+    {
+      absl::MutexLock lock(&mutex_);
+      if (pending_.empty()) {
+        processing_ = false;
+        return;
+      }
+      batch.swap(pending_);
+    }
+    for (const std::string& file_name : batch) {
+      VLOG(2) << "Deleting " << file_name;
+      if (!File::Delete(file_name.c_str()))
+        LOG(WARNING) << "Failed to delete " << file_name;
+    }
+  }
+}
+
+bool AsyncFileDeleter::IsIdle() const {
+  return !processing_ && pending_.empty();
+}
+
+}  // namespace shaka
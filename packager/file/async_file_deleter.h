@@ -0,0 +1,56 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_FILE_ASYNC_FILE_DELETER_H_
+#define PACKAGER_FILE_ASYNC_FILE_DELETER_H_
+
+#include <deque>
+#include <string>
+
+#include <absl/base/thread_annotations.h>
+#include <absl/synchronization/mutex.h>
+
+#include <packager/macros/classes.h>
+
+namespace shaka {
+
+/// Deletes files on a background thread. Live packaging expires one segment
+/// per new segment for the lifetime of the event, and against HTTP storage
+/// each delete is a blocking round trip; funneling deletes through this class
+/// keeps that latency off the manifest update path. Queued deletions are
+/// drained in batches by a single ThreadPool task, so bursts of expirations
+/// (e.g. a sliding-window catch-up) cost one task wakeup.
+class AsyncFileDeleter {
+ public:
+  AsyncFileDeleter();
+  /// Blocks until every queued deletion has been attempted.
+  ~AsyncFileDeleter();
+
+  /// Queue @a file_name for deletion. Deletion happens asynchronously; a
+  /// failure to delete is logged but not reported back.
+  void Delete(const std::string& file_name);
+
+  /// Block until every deletion queued so far has been attempted.
+  void WaitForPendingDeletes();
+
+ private:
+  // Runs on the thread pool. Drains the queue in batches and exits when the
+  // queue is empty; Delete() starts a new task when none is running.
+  void ProcessDeletesTask();
+
+  bool IsIdle() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  absl::Mutex mutex_;
+  std::deque<std::string> pending_ ABSL_GUARDED_BY(mutex_);
+  // True while a drain task is posted or running.
+  bool processing_ ABSL_GUARDED_BY(mutex_) = false;
+
+  DISALLOW_COPY_AND_ASSIGN(AsyncFileDeleter);
+};
+
+}  // namespace shaka
+
+#endif  // PACKAGER_FILE_ASYNC_FILE_DELETER_H_
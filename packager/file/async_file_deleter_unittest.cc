@@ -0,0 +1,79 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/file/async_file_deleter.h>
+
+#include <memory>
+#include <string>
+
+#include <absl/strings/str_format.h>
+#include <gtest/gtest.h>
+
+#include <packager/file.h>
+#include <packager/file/file_closer.h>
+#include <packager/file/memory_file.h>
+
+namespace shaka {
+namespace {
+
+void WriteFile(const std::string& file_name) {
+  std::unique_ptr<File, FileCloser> file(File::Open(file_name.c_str(), "w"));
+  ASSERT_TRUE(file);
+  const uint8_t kData[] = {1, 2, 3};
+  ASSERT_EQ(static_cast<int64_t>(sizeof(kData)),
+            file->Write(kData, sizeof(kData)));
+}
+
+bool FileExists(const std::string& file_name) {
+  std::unique_ptr<File, FileCloser> file(File::Open(file_name.c_str(), "r"));
+  return file != nullptr;
+}
+
+}  // namespace
+
+class AsyncFileDeleterTest : public testing::Test {
+ protected:
+  void TearDown() override { MemoryFile::DeleteAll(); }
+};
+
+TEST_F(AsyncFileDeleterTest, DeletesQueuedFile) {
+  const char kFileName[] = "memory://async_deleter_file";
+  WriteFile(kFileName);
+  ASSERT_TRUE(FileExists(kFileName));
+
+  AsyncFileDeleter deleter;
+  deleter.Delete(kFileName);
+  deleter.WaitForPendingDeletes();
+  EXPECT_FALSE(FileExists(kFileName));
+}
+
+TEST_F(AsyncFileDeleterTest, DeletesManyFiles) {
+  const int kNumFiles = 100;
+  AsyncFileDeleter deleter;
+  for (int i = 0; i < kNumFiles; i++) {
+    const std::string file_name =
+        absl::StrFormat("memory://async_deleter_file_%d", i);
+    WriteFile(file_name);
+    deleter.Delete(file_name);
+  }
+  deleter.WaitForPendingDeletes();
+  for (int i = 0; i < kNumFiles; i++) {
+    EXPECT_FALSE(
+        FileExists(absl::StrFormat("memory://async_deleter_file_%d", i)));
+  }
+}
+
+TEST_F(AsyncFileDeleterTest, DestructorWaitsForPendingDeletes) {
+  const char kFileName[] = "memory://async_deleter_file";
+  WriteFile(kFileName);
+  {
+    AsyncFileDeleter deleter;
+    deleter.Delete(kFileName);
+  }
+  EXPECT_FALSE(FileExists(kFileName));
+}
+
+}  // namespace shaka
@@ -0,0 +1,283 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/file/cached_http_file.h>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+#include <absl/flags/flag.h>
+#include <absl/log/log.h>
+#include <absl/synchronization/mutex.h>
+
+#include <packager/file/http_file.h>
+#include <packager/macros/compiler.h>
+#include <packager/macros/logging.h>
+
+ABSL_FLAG(uint64_t,
+          http_cache_size_bytes,
+          0,
+          "Size of the process-wide cache for http(s) inputs, in bytes. "
+          "Downloads are cached by url and shared across all jobs in the "
+          "process, so concurrent jobs reading the same remote input hit "
+          "the origin once. Objects larger than the cache stream through "
+          "uncached. Specify 0 to disable the cache.");
+
+namespace shaka {
+
+namespace {
+
+struct CacheEntry {
+  // The downloaded object; null while the download is still in flight.
+  std::shared_ptr<const std::vector<uint8_t>> data;
+  // Set when the entry has no usable data: the downloader abandoned it
+  // (error, oversized object or close before EOF) or it was evicted. The
+  // next open of the url takes over as downloader.
+  bool failed = false;
+  // Recency for LRU eviction; larger is more recent.
+  uint64_t sequence = 0;
+};
+
+struct Cache {
+  // Nodes are never erased outside of tests: waiting opens hold references
+  // into the map, see EntryDecided below. Eviction drops an entry's data and
+  // leaves the small node behind, so the map is bounded by the number of
+  // distinct urls.
+  std::map<std::string, CacheEntry> entries;
+  uint64_t total_bytes = 0;
+  uint64_t next_sequence = 0;
+  uint64_t origin_fetches = 0;
+  uint64_t cache_hits = 0;
+  // Overrides the flag when nonzero. For tests.
+  uint64_t size_override = 0;
+};
+
+absl::Mutex* CacheMutex() {
+  static absl::Mutex* const mutex = new absl::Mutex;
+  return mutex;
+}
+
+Cache* GetCache() {
+  static Cache* const cache = new Cache;
+  return cache;
+}
+
+uint64_t CacheSizeBytes() {
+  const uint64_t size_override = GetCache()->size_override;
+  return size_override ? size_override
+                       : absl::GetFlag(FLAGS_http_cache_size_bytes);
+}
+
+// True once a concurrent download of the entry's url has either published
+// its data or given up.
+bool EntryDecided(CacheEntry* entry) {
+  return entry->data != nullptr || entry->failed;
+}
+
+}  // namespace
+
+CachedHttpFile::CachedHttpFile(const std::string& url)
+    : File(url), url_(url) {}
+
+CachedHttpFile::~CachedHttpFile() {}
+
+bool CachedHttpFile::Enabled() {
+  return absl::GetFlag(FLAGS_http_cache_size_bytes) > 0;
+}
+
+void CachedHttpFile::GetCacheStats(uint64_t* origin_fetches,
+                                   uint64_t* cache_hits) {
+  absl::MutexLock lock(CacheMutex());
+  *origin_fetches = GetCache()->origin_fetches;
+  *cache_hits = GetCache()->cache_hits;
+}
+
+void CachedHttpFile::SetCacheSizeForTesting(uint64_t size_bytes) {
+  absl::MutexLock lock(CacheMutex());
+  GetCache()->size_override = size_bytes;
+}
+
+void CachedHttpFile::ClearCacheForTesting() {
+  absl::MutexLock lock(CacheMutex());
+  *GetCache() = Cache();
+}
+
+bool CachedHttpFile::Open() {
+  {
+    absl::MutexLock lock(CacheMutex());
+    Cache* cache = GetCache();
+    const auto result = cache->entries.try_emplace(url_);
+    CacheEntry& entry = result.first->second;
+    if (!result.second) {
+      // Another file is, or was, fetching this url; wait for its verdict.
+      CacheMutex()->Await(absl::Condition(&EntryDecided, &entry));
+      if (entry.data) {
+        cached_data_ = entry.data;
+        entry.sequence = ++cache->next_sequence;
+        ++cache->cache_hits;
+        return true;
+      }
+      // The concurrent download was abandoned; take over as downloader.
+      entry.failed = false;
+    }
+    ++cache->origin_fetches;
+    caching_ = true;
+  }
+
+  upstream_ = new HttpFile(HttpMethod::kGet, url_);
+  if (!upstream_->Open()) {
+    upstream_->Close();
+    upstream_ = nullptr;
+    AbandonCaching();
+    return false;
+  }
+  return true;
+}
+
+bool CachedHttpFile::Close() {
+  bool result = true;
+  if (upstream_) {
+    result = upstream_->Close();
+    upstream_ = nullptr;
+  }
+  // Closed before the download completed; let someone else fetch the url.
+  if (caching_ && !committed_)
+    AbandonCaching();
+  delete this;
+  return result;
+}
+
+int64_t CachedHttpFile::Read(void* buffer, uint64_t length) {
+  if (cached_data_) {
+    if (position_ >= cached_data_->size())
+      return 0;
+    const uint64_t bytes_to_read =
+        std::min<uint64_t>(length, cached_data_->size() - position_);
+    memcpy(buffer, cached_data_->data() + position_, bytes_to_read);
+    position_ += bytes_to_read;
+    return bytes_to_read;
+  }
+
+  const int64_t bytes_read = upstream_->Read(buffer, length);
+  if (bytes_read < 0) {
+    AbandonCaching();
+    return bytes_read;
+  }
+  if (bytes_read == 0) {
+    if (caching_ && !committed_)
+      CommitToCache();
+    return 0;
+  }
+  position_ += bytes_read;
+  if (caching_) {
+    pending_.insert(pending_.end(), static_cast<const uint8_t*>(buffer),
+                    static_cast<const uint8_t*>(buffer) + bytes_read);
+    // Objects that cannot fit the cache stream through uncached.
+    if (pending_.size() > CacheSizeBytes())
+      AbandonCaching();
+  }
+  return bytes_read;
+}
+
+int64_t CachedHttpFile::Write(const void* buffer, uint64_t length) {
+  UNUSED(buffer);
+  UNUSED(length);
+  NOTIMPLEMENTED() << "CachedHttpFile only supports read mode.";
+  return -1;
+}
+
+void CachedHttpFile::CloseForWriting() {}
+
+int64_t CachedHttpFile::Size() {
+  if (cached_data_)
+    return cached_data_->size();
+  return upstream_->Size();
+}
+
+bool CachedHttpFile::Flush() {
+  NOTIMPLEMENTED() << "CachedHttpFile only supports read mode.";
+  return false;
+}
+
+bool CachedHttpFile::Seek(uint64_t position) {
+  if (cached_data_) {
+    if (position > cached_data_->size())
+      return false;
+    position_ = position;
+    return true;
+  }
+  // A seek would break the sequential byte accumulation; the object can no
+  // longer be cached by this file.
+  AbandonCaching();
+  if (!upstream_->Seek(position))
+    return false;
+  position_ = position;
+  return true;
+}
+
+bool CachedHttpFile::Tell(uint64_t* position) {
+  *position = position_;
+  return true;
+}
+
+uint64_t CachedHttpFile::OptimalReadSize() {
+  if (upstream_)
+    return upstream_->OptimalReadSize();
+  return File::OptimalReadSize();
+}
+
+void CachedHttpFile::AbandonCaching() {
+  if (!caching_)
+    return;
+  caching_ = false;
+  pending_.clear();
+  pending_.shrink_to_fit();
+  absl::MutexLock lock(CacheMutex());
+  GetCache()->entries[url_].failed = true;
+}
+
+void CachedHttpFile::CommitToCache() {
+  committed_ = true;
+  caching_ = false;
+  auto data =
+      std::make_shared<const std::vector<uint8_t>>(std::move(pending_));
+
+  absl::MutexLock lock(CacheMutex());
+  Cache* cache = GetCache();
+  const uint64_t cache_size = CacheSizeBytes();
+  if (data->size() > cache_size) {
+    cache->entries[url_].failed = true;
+    return;
+  }
+
+  // Evict least recently used objects until the new one fits. Readers of an
+  // evicted object keep it alive through their shared_ptr.
+  while (cache->total_bytes + data->size() > cache_size) {
+    auto victim = cache->entries.end();
+    for (auto it = cache->entries.begin(); it != cache->entries.end(); ++it) {
+      if (!it->second.data)
+        continue;
+      if (victim == cache->entries.end() ||
+          it->second.sequence < victim->second.sequence) {
+        victim = it;
+      }
+    }
+    if (victim == cache->entries.end())
+      break;
+    cache->total_bytes -= victim->second.data->size();
+    victim->second.data.reset();
+    victim->second.failed = true;
+  }
+
+  CacheEntry& entry = cache->entries[url_];
+  entry.data = std::move(data);
+  entry.failed = false;
+  entry.sequence = ++cache->next_sequence;
+  cache->total_bytes += entry.data->size();
+}
+
+}  // namespace shaka
@@ -0,0 +1,104 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_FILE_CACHED_HTTP_FILE_H_
+#define PACKAGER_FILE_CACHED_HTTP_FILE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <packager/file.h>
+#include <packager/macros/classes.h>
+
+namespace shaka {
+
+class HttpFile;
+
+/// CachedHttpFile is a read-path cache in front of HttpFile for inputs that
+/// are shared by concurrent jobs in one process, e.g. per-rendition packaging
+/// jobs reading the same remote mezzanine. Downloaded objects are kept in a
+/// process-wide LRU cache keyed by url and bounded by
+/// --http_cache_size_bytes; a second open of the same url is served from
+/// memory without contacting the origin. Downloads are single flight: while
+/// one file is fetching a url, further opens of that url wait for it and
+/// then read the cached copy, so N concurrent jobs hit the origin once.
+/// Objects larger than the cache bound stream through uncached. Only read
+/// mode is supported.
+class CachedHttpFile : public File {
+ public:
+  /// @param url is the full url of the remote resource, e.g.
+  ///        "https://example.com/mezzanine.mp4".
+  explicit CachedHttpFile(const std::string& url);
+
+  /// @return true if --http_cache_size_bytes is set, i.e. http(s) downloads
+  ///         should go through CachedHttpFile.
+  static bool Enabled();
+
+  /// Cache effectiveness counters, reported through
+  /// Packager::DumpPipelineStats().
+  /// @param origin_fetches receives the number of downloads that went to the
+  ///        origin.
+  /// @param cache_hits receives the number of opens served from the cache.
+  static void GetCacheStats(uint64_t* origin_fetches, uint64_t* cache_hits);
+
+  /// Overrides --http_cache_size_bytes for tests.
+  static void SetCacheSizeForTesting(uint64_t size_bytes);
+
+  /// Drops every cached object and resets the counters and the size
+  /// override. For tests.
+  static void ClearCacheForTesting();
+
+  /// @name File implementation overrides.
+  /// @{
+  bool Close() override;
+  int64_t Read(void* buffer, uint64_t length) override;
+  int64_t Write(const void* buffer, uint64_t length) override;
+  void CloseForWriting() override;
+  int64_t Size() override;
+  bool Flush() override;
+  bool Seek(uint64_t position) override;
+  bool Tell(uint64_t* position) override;
+  uint64_t OptimalReadSize() override;
+  /// @}
+
+ protected:
+  ~CachedHttpFile() override;
+
+  bool Open() override;
+
+ private:
+  // Marks this file's in-flight cache entry as abandoned so that waiting and
+  // later opens fetch the url themselves, and stops accumulating bytes.
+  void AbandonCaching();
+  // Publishes the fully downloaded object to the cache, evicting least
+  // recently used objects to make room.
+  void CommitToCache();
+
+  const std::string url_;
+  // Set when the object is served from the cache (possibly after waiting for
+  // a concurrent download); shared with the cache entry, so it stays valid
+  // if the entry is evicted.
+  std::shared_ptr<const std::vector<uint8_t>> cached_data_;
+  uint64_t position_ = 0;
+  // The origin download performed when the cache cannot serve this url;
+  // owned (closed in Close()).
+  HttpFile* upstream_ = nullptr;
+  // Bytes read from the origin so far, committed to the cache once the
+  // download completes.
+  std::vector<uint8_t> pending_;
+  // True while this file is the designated downloader for |url_| and the
+  // object still fits the cache bound.
+  bool caching_ = false;
+  bool committed_ = false;
+
+  DISALLOW_COPY_AND_ASSIGN(CachedHttpFile);
+};
+
+}  // namespace shaka
+
+#endif  // PACKAGER_FILE_CACHED_HTTP_FILE_H_
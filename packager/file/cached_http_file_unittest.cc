@@ -0,0 +1,95 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/file/cached_http_file.h>
+
+#include <string>
+
+#include <absl/flags/declare.h>
+#include <absl/flags/flag.h>
+#include <gtest/gtest.h>
+
+#include <packager/file.h>
+#include <packager/media/test/test_web_server.h>
+
+ABSL_DECLARE_FLAG(uint64_t, http_cache_size_bytes);
+
+namespace shaka {
+
+namespace {
+
+const uint64_t kTestCacheSizeBytes = 16 << 20;
+
+// Reads |url| to the end through File::OpenWithNoBuffering, which routes
+// http(s) reads through CachedHttpFile while the cache flag is set.
+bool ReadAll(const std::string& url, std::string* contents) {
+  File* file = File::OpenWithNoBuffering(url.c_str(), "r");
+  if (!file)
+    return false;
+  contents->clear();
+  char buffer[4096];
+  int64_t bytes_read;
+  while ((bytes_read = file->Read(buffer, sizeof(buffer))) > 0)
+    contents->append(buffer, bytes_read);
+  const bool closed = file->Close();
+  return bytes_read == 0 && closed;
+}
+
+class CachedHttpFileTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(server_.Start());
+    absl::SetFlag(&FLAGS_http_cache_size_bytes, kTestCacheSizeBytes);
+    CachedHttpFile::ClearCacheForTesting();
+  }
+
+  void TearDown() override {
+    absl::SetFlag(&FLAGS_http_cache_size_bytes, 0);
+    CachedHttpFile::ClearCacheForTesting();
+  }
+
+  media::TestWebServer server_;
+};
+
+}  // namespace
+
+TEST_F(CachedHttpFileTest, SecondOpenServedFromCache) {
+  std::string first_read;
+  std::string second_read;
+  ASSERT_TRUE(ReadAll(server_.ReflectUrl(), &first_read));
+  ASSERT_TRUE(ReadAll(server_.ReflectUrl(), &second_read));
+
+  EXPECT_FALSE(first_read.empty());
+  EXPECT_EQ(first_read, second_read);
+
+  uint64_t origin_fetches;
+  uint64_t cache_hits;
+  CachedHttpFile::GetCacheStats(&origin_fetches, &cache_hits);
+  EXPECT_EQ(1u, origin_fetches);
+  EXPECT_EQ(1u, cache_hits);
+}
+
+TEST_F(CachedHttpFileTest, OversizedObjectStreamsThroughUncached) {
+  // A one byte cache cannot hold the response, so both reads must go to the
+  // origin and still return the full object.
+  CachedHttpFile::SetCacheSizeForTesting(1);
+
+  std::string first_read;
+  std::string second_read;
+  ASSERT_TRUE(ReadAll(server_.ReflectUrl(), &first_read));
+  ASSERT_TRUE(ReadAll(server_.ReflectUrl(), &second_read));
+
+  EXPECT_FALSE(first_read.empty());
+  EXPECT_EQ(first_read, second_read);
+
+  uint64_t origin_fetches;
+  uint64_t cache_hits;
+  CachedHttpFile::GetCacheStats(&origin_fetches, &cache_hits);
+  EXPECT_EQ(2u, origin_fetches);
+  EXPECT_EQ(0u, cache_hits);
+}
+
+}  // namespace shaka
@@ -0,0 +1,54 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+//
+// On-disk format shared by the UDP capture writer (see the "capture" UDP
+// option in UdpOptions) and ReplayFile. A capture file is an 8-byte magic
+// followed by a sequence of records; each record is a fixed-size header with
+// the datagram's arrival time and size, followed by the datagram payload.
+// The fixed-size headers make the file self-indexing: a reader can skip from
+// record to record without inspecting payloads. All integers are
+// little-endian regardless of host byte order.
+
+#ifndef PACKAGER_FILE_CAPTURE_FILE_FORMAT_H_
+#define PACKAGER_FILE_CAPTURE_FILE_FORMAT_H_
+
+#include <cstdint>
+#include <cstring>
+
+namespace shaka {
+
+// Magic bytes at the start of every capture file. The trailing digits are the
+// format version; bump them on incompatible layout changes.
+const char kCaptureFileMagic[] = {'S', 'H', 'K', 'C', 'A', 'P', '0', '1'};
+const size_t kCaptureFileMagicSize = sizeof(kCaptureFileMagic);
+
+// Per-record header: 8-byte timestamp in microseconds since the start of the
+// capture, then 4-byte payload size.
+const size_t kCaptureRecordHeaderSize = 12;
+
+inline void EncodeCaptureRecordHeader(uint64_t timestamp_us,
+                                      uint32_t payload_size,
+                                      uint8_t* out) {
+  for (int i = 0; i < 8; ++i)
+    out[i] = static_cast<uint8_t>(timestamp_us >> (8 * i));
+  for (int i = 0; i < 4; ++i)
+    out[8 + i] = static_cast<uint8_t>(payload_size >> (8 * i));
+}
+
+inline void DecodeCaptureRecordHeader(const uint8_t* in,
+                                      uint64_t* timestamp_us,
+                                      uint32_t* payload_size) {
+  *timestamp_us = 0;
+  for (int i = 0; i < 8; ++i)
+    *timestamp_us |= static_cast<uint64_t>(in[i]) << (8 * i);
+  *payload_size = 0;
+  for (int i = 0; i < 4; ++i)
+    *payload_size |= static_cast<uint32_t>(in[8 + i]) << (8 * i);
+}
+
+}  // namespace shaka
+
+#endif  // PACKAGER_FILE_CAPTURE_FILE_FORMAT_H_
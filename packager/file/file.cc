@@ -17,15 +17,23 @@
 #include <absl/strings/numbers.h>
 #include <absl/strings/str_format.h>
 
+#include <packager/file/cached_http_file.h>
 #include <packager/file/callback_file.h>
 #include <packager/file/file_util.h>
+#include <packager/file/hashing_file.h>
+#include <packager/file/hedged_http_file.h>
 #include <packager/file/http_file.h>
+#include <packager/file/ingest_http_file.h>
 #include <packager/file/local_file.h>
 #include <packager/file/memory_file.h>
+#include <packager/file/replay_file.h>
+#include <packager/file/shm_file.h>
 #include <packager/file/threaded_io_file.h>
 #include <packager/file/udp_file.h>
+#include <packager/file/uring_file.h>
 #include <packager/macros/compiler.h>
 #include <packager/macros/logging.h>
+#include <packager/utils/trace_event.h>
 
 ABSL_FLAG(uint64_t,
           io_cache_size,
@@ -42,9 +50,13 @@ namespace shaka {
 const char* kCallbackFilePrefix = "callback://";
 const char* kLocalFilePrefix = "file://";
 const char* kMemoryFilePrefix = "memory://";
+const char* kShmFilePrefix = "shm://";
+const char* kReplayFilePrefix = "replay://";
 const char* kUdpFilePrefix = "udp://";
+const char* kUringFilePrefix = "uring://";
 const char* kHttpFilePrefix = "http://";
 const char* kHttpsFilePrefix = "https://";
+const char* kIngestHttpFilePrefix = "ingest-http://";
 
 
 namespace {
@@ -95,6 +107,14 @@ bool WriteLocalFileAtomically(const char* file_name,
   return true;
 }
 
+File* CreateReplayFile(const char* file_name, const char* mode) {
+  if (strcmp(mode, "r")) {
+    NOTIMPLEMENTED() << "ReplayFile only supports read mode.";
+    return NULL;
+  }
+  return new ReplayFile(file_name);
+}
+
 File* CreateUdpFile(const char* file_name, const char* mode) {
   if (strcmp(mode, "r")) {
     NOTIMPLEMENTED() << "UdpFile only supports read (receive) mode.";
@@ -103,26 +123,63 @@ File* CreateUdpFile(const char* file_name, const char* mode) {
   return new UdpFile(file_name);
 }
 
+File* CreateIngestHttpFile(const char* file_name, const char* mode) {
+  if (strcmp(mode, "r")) {
+    NOTIMPLEMENTED() << "IngestHttpFile only supports read (receive) mode.";
+    return NULL;
+  }
+  return new IngestHttpFile(file_name);
+}
+
 File* CreateHttpsFile(const char* file_name, const char* mode) {
-  HttpMethod method = HttpMethod::kGet;
   if (strcmp(mode, "r") != 0) {
-    method = HttpMethod::kPut;
+    const std::string url = std::string("https://") + file_name;
+    if (HedgedHttpFile::Enabled())
+      return new HedgedHttpFile(url);
+    return new HttpFile(HttpMethod::kPut, url);
   }
-  return new HttpFile(method, std::string("https://") + file_name);
+  const std::string url = std::string("https://") + file_name;
+  if (CachedHttpFile::Enabled())
+    return new CachedHttpFile(url);
+  return new HttpFile(HttpMethod::kGet, url);
 }
 
 File* CreateHttpFile(const char* file_name, const char* mode) {
-  HttpMethod method = HttpMethod::kGet;
   if (strcmp(mode, "r") != 0) {
-    method = HttpMethod::kPut;
+    const std::string url = std::string("http://") + file_name;
+    if (HedgedHttpFile::Enabled())
+      return new HedgedHttpFile(url);
+    return new HttpFile(HttpMethod::kPut, url);
+  }
+  const std::string url = std::string("http://") + file_name;
+  if (CachedHttpFile::Enabled())
+    return new CachedHttpFile(url);
+  return new HttpFile(HttpMethod::kGet, url);
+}
+
+File* CreateUringFile(const char* file_name, const char* mode) {
+  if (!UringFile::IsSupported()) {
+    // Keep uring:// URLs working on builds without liburing.
+    LOG_FIRST_N(WARNING, 1) << "io_uring support is not compiled in; "
+                               "uring:// falls back to regular local file "
+                               "I/O.";
+    return new LocalFile(file_name, mode);
   }
-  return new HttpFile(method, std::string("http://") + file_name);
+  return new UringFile(file_name, mode);
 }
 
 File* CreateMemoryFile(const char* file_name, const char* mode) {
   return new MemoryFile(file_name, mode);
 }
 
+File* CreateShmFile(const char* file_name, const char* mode) {
+  return new ShmFile(file_name, mode);
+}
+
+bool DeleteShmFile(const char* file_name) {
+  return ShmFile::Delete(file_name);
+}
+
 bool DeleteMemoryFile(const char* file_name) {
   MemoryFile::Delete(file_name);
   return true;
@@ -136,10 +193,14 @@ static const FileTypeInfo kFileTypeInfo[] = {
         &WriteLocalFileAtomically,
     },
     {kUdpFilePrefix, &CreateUdpFile, nullptr, nullptr},
+    {kReplayFilePrefix, &CreateReplayFile, nullptr, nullptr},
+    {kUringFilePrefix, &CreateUringFile, &DeleteLocalFile, nullptr},
     {kMemoryFilePrefix, &CreateMemoryFile, &DeleteMemoryFile, nullptr},
+    {kShmFilePrefix, &CreateShmFile, &DeleteShmFile, nullptr},
     {kCallbackFilePrefix, &CreateCallbackFile, nullptr, nullptr},
     {kHttpFilePrefix, &CreateHttpFile, nullptr, nullptr},
     {kHttpsFilePrefix, &CreateHttpsFile, nullptr, nullptr},
+    {kIngestHttpFilePrefix, &CreateIngestHttpFile, nullptr, nullptr},
 };
 
 std::string_view GetFileTypePrefix(std::string_view file_name) {
@@ -168,9 +229,33 @@ File* File::Create(const char* file_name, const char* mode) {
       CreateInternalFile(file_name, mode));
 
   std::string_view file_type_prefix = GetFileTypePrefix(file_name);
+
+  if (HashingFile::IsEnabled() && !strcmp(mode, "w") &&
+      file_type_prefix != kMemoryFilePrefix &&
+      file_type_prefix != kShmFilePrefix &&
+      file_type_prefix != kCallbackFilePrefix) {
+    // Tee writes through an inline hasher so segment digests come for free
+    // with the write. Memory, shared memory and callback files are internal
+    // intermediates whose digests nobody consumes. With threaded I/O the
+    // hasher sits below ThreadedIoFile and runs on the background writer
+    // thread.
+    internal_file.reset(new HashingFile(std::move(internal_file)));
+  }
+
   if (file_type_prefix == kMemoryFilePrefix ||
-      file_type_prefix == kCallbackFilePrefix) {
-    // Disable caching for memory and callback files.
+      file_type_prefix == kCallbackFilePrefix ||
+      file_type_prefix == kShmFilePrefix) {
+    // Disable caching for memory, callback and shared memory files. Shared
+    // memory writes land directly in the mapped pages; an I/O cache in front
+    // would just add a copy.
+    return internal_file.release();
+  }
+  if (file_type_prefix == kHttpFilePrefix ||
+      file_type_prefix == kHttpsFilePrefix) {
+    // HttpFile already performs the transfer on a background thread and
+    // buffers through its own IoCache, so wrapping it in ThreadedIoFile
+    // would only add a second cache, a second task and an extra copy
+    // between the muxer and the wire.
     return internal_file.release();
   }
 
@@ -202,7 +287,41 @@ File* File::CreateInternalFile(const char* file_name, const char* mode) {
   return file_type->factory_function(real_file_name.data(), mode);
 }
 
+int64_t File::WriteV(const IoVec* iov, int iov_count) {
+  DCHECK(iov);
+
+  int64_t total_bytes_written = 0;
+  for (int i = 0; i < iov_count; i++) {
+    uint64_t extent_bytes_written = 0;
+    while (extent_bytes_written < iov[i].length) {
+      const int64_t bytes_written =
+          Write(static_cast<const uint8_t*>(iov[i].data) + extent_bytes_written,
+                iov[i].length - extent_bytes_written);
+      if (bytes_written < 0)
+        return total_bytes_written > 0 ? total_bytes_written : bytes_written;
+      if (bytes_written == 0)
+        return total_bytes_written;
+      extent_bytes_written += bytes_written;
+      total_bytes_written += bytes_written;
+    }
+  }
+  return total_bytes_written;
+}
+
+const uint8_t* File::MapReadRegion(uint64_t /*offset*/, uint64_t /*length*/) {
+  // Memory mapping is an optional optimization; file types that cannot
+  // support it simply report it as unavailable and callers fall back to
+  // Read().
+  return NULL;
+}
+
+uint64_t File::OptimalReadSize() {
+  // No preference; the caller picks its own read size.
+  return 0;
+}
+
 File* File::Open(const char* file_name, const char* mode) {
+  TraceBuffer::ScopedEvent trace("file", "open", file_name);
   File* file = File::Create(file_name, mode);
   if (!file)
     return NULL;
@@ -0,0 +1,179 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/file/hashing_file.h>
+
+#include <atomic>
+#include <deque>
+#include <map>
+
+#include <absl/log/check.h>
+#include <absl/strings/escaping.h>
+#include <absl/synchronization/mutex.h>
+
+namespace shaka {
+namespace {
+
+std::atomic<bool> g_hashing_enabled(false);
+
+// Cap on unclaimed digests. Claimed entries (media segments) are removed by
+// TakeDigest(); entries nobody claims - manifests, files with non-linear
+// writes - are evicted oldest first, so the registry stays bounded over a
+// long-running live session.
+const size_t kMaxPendingDigests = 4096;
+
+// Digests of finished files, keyed by file name (without file type prefix),
+// waiting to be claimed via HashingFile::TakeDigest().
+class DigestRegistry {
+ public:
+  static DigestRegistry* Instance() {
+    static DigestRegistry* instance = new DigestRegistry;
+    return instance;
+  }
+
+  void Put(const std::string& file_name, const std::string& sha256_hex) {
+    absl::MutexLock lock(&mutex_);
+    if (digests_.insert(std::make_pair(file_name, sha256_hex)).second) {
+      insertion_order_.push_back(file_name);
+    } else {
+      // Same name written again (e.g. a rewritten manifest): keep the newest
+      // digest, the insertion order entry is already there.
+      digests_[file_name] = sha256_hex;
+    }
+    while (digests_.size() > kMaxPendingDigests) {
+      digests_.erase(insertion_order_.front());
+      insertion_order_.pop_front();
+    }
+  }
+
+  bool Take(const std::string& file_name, std::string* sha256_hex) {
+    absl::MutexLock lock(&mutex_);
+    auto iter = digests_.find(file_name);
+    if (iter == digests_.end())
+      return false;
+    *sha256_hex = iter->second;
+    digests_.erase(iter);
+    // |insertion_order_| is left as is; a stale name makes the eviction loop
+    // above erase nothing, which is harmless.
+    return true;
+  }
+
+ private:
+  DigestRegistry() = default;
+
+  absl::Mutex mutex_;
+  std::map<std::string, std::string> digests_ ABSL_GUARDED_BY(mutex_);
+  std::deque<std::string> insertion_order_ ABSL_GUARDED_BY(mutex_);
+};
+
+// Strips a file type prefix ("file://", "http://", ...) if present, matching
+// the name files are opened under (File::file_name() has it stripped too).
+std::string StripFileTypePrefix(const std::string& file_name) {
+  const size_t pos = file_name.find("://");
+  return pos == std::string::npos ? file_name : file_name.substr(pos + 3);
+}
+
+}  // namespace
+
+HashingFile::HashingFile(std::unique_ptr<File, FileCloser> internal_file)
+    : File(internal_file->file_name()),
+      internal_file_(std::move(internal_file)) {
+  DCHECK(internal_file_);
+  mbedtls_md_init(&md_context_);
+  const mbedtls_md_info_t* md_info =
+      mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+  CHECK(md_info);
+  CHECK_EQ(0, mbedtls_md_setup(&md_context_, md_info, 0));
+  CHECK_EQ(0, mbedtls_md_starts(&md_context_));
+}
+
+HashingFile::~HashingFile() {
+  mbedtls_md_free(&md_context_);
+}
+
+bool HashingFile::Open() {
+  return internal_file_->Open();
+}
+
+bool HashingFile::Close() {
+  if (digest_valid_ && bytes_hashed_ > 0) {
+    std::string digest(mbedtls_md_get_size(mbedtls_md_info_from_type(
+                           MBEDTLS_MD_SHA256)),
+                       0);
+    CHECK_EQ(0, mbedtls_md_finish(&md_context_,
+                                  reinterpret_cast<unsigned char*>(
+                                      digest.data())));
+    DigestRegistry::Instance()->Put(file_name(),
+                                    absl::BytesToHexString(digest));
+  }
+  const bool result = internal_file_.release()->Close();
+  delete this;
+  return result;
+}
+
+int64_t HashingFile::Read(void* buffer, uint64_t length) {
+  return internal_file_->Read(buffer, length);
+}
+
+int64_t HashingFile::Write(const void* buffer, uint64_t length) {
+  const int64_t written = internal_file_->Write(buffer, length);
+  if (written > 0) {
+    // Hash exactly the bytes that reached the file; a short write keeps the
+    // digest in sync with the file content.
+    CHECK_EQ(0, mbedtls_md_update(&md_context_,
+                                  static_cast<const unsigned char*>(buffer),
+                                  written));
+    bytes_hashed_ += written;
+  }
+  return written;
+}
+
+void HashingFile::CloseForWriting() {
+  internal_file_->CloseForWriting();
+}
+
+int64_t HashingFile::Size() {
+  return internal_file_->Size();
+}
+
+bool HashingFile::Flush() {
+  return internal_file_->Flush();
+}
+
+bool HashingFile::Seek(uint64_t position) {
+  if (!internal_file_->Seek(position))
+    return false;
+  // Seeking to the current write position (e.g. a seekability probe) leaves
+  // the linear digest intact; any other reposition invalidates it.
+  if (position != bytes_hashed_)
+    digest_valid_ = false;
+  return true;
+}
+
+bool HashingFile::Tell(uint64_t* position) {
+  return internal_file_->Tell(position);
+}
+
+const uint8_t* HashingFile::MapReadRegion(uint64_t offset, uint64_t length) {
+  return internal_file_->MapReadRegion(offset, length);
+}
+
+void HashingFile::SetEnabled(bool enabled) {
+  g_hashing_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool HashingFile::IsEnabled() {
+  return g_hashing_enabled.load(std::memory_order_relaxed);
+}
+
+bool HashingFile::TakeDigest(const std::string& file_name,
+                             std::string* sha256_hex) {
+  DCHECK(sha256_hex);
+  return DigestRegistry::Instance()->Take(StripFileTypePrefix(file_name),
+                                          sha256_hex);
+}
+
+}  // namespace shaka
@@ -0,0 +1,82 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_FILE_HASHING_FILE_H_
+#define PACKAGER_FILE_HASHING_FILE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <mbedtls/md.h>
+
+#include <packager/file.h>
+#include <packager/file/file_closer.h>
+#include <packager/macros/classes.h>
+
+namespace shaka {
+
+/// File wrapper that computes the SHA-256 digest of the bytes written to the
+/// wrapped file, as an inline tee on the write path: the digest of a finished
+/// segment comes for free with the write, with no extra read pass. When
+/// threaded I/O is enabled the wrapper sits below ThreadedIoFile, so the
+/// hashing runs on the background writer thread.
+///
+/// The digest describes the file content only if it was written front to
+/// back; any repositioning write (e.g. box size backpatching) invalidates it.
+/// On Close() a valid digest is deposited in a process-wide registry under
+/// the file name, where it can be claimed once with TakeDigest().
+class HashingFile : public File {
+ public:
+  /// @param internal_file The file to wrap. Must be in write mode.
+  explicit HashingFile(std::unique_ptr<File, FileCloser> internal_file);
+
+  /// @name File implementation overrides.
+  /// @{
+  bool Close() override;
+  int64_t Read(void* buffer, uint64_t length) override;
+  int64_t Write(const void* buffer, uint64_t length) override;
+  void CloseForWriting() override;
+  int64_t Size() override;
+  bool Flush() override;
+  bool Seek(uint64_t position) override;
+  bool Tell(uint64_t* position) override;
+  const uint8_t* MapReadRegion(uint64_t offset, uint64_t length) override;
+  /// @}
+
+  /// Enable or disable hashing of files opened for writing. Read by the File
+  /// factory; set it before any output file is opened.
+  static void SetEnabled(bool enabled);
+  /// @return Whether write hashing is enabled.
+  static bool IsEnabled();
+
+  /// Claim the digest of a finished file. Each digest can be claimed once;
+  /// a second call for the same name fails.
+  /// @param file_name is the name the file was opened under. A file type
+  ///        prefix (e.g. "file://"), if present, is ignored.
+  /// @param sha256_hex is set to the lowercase hex digest on success.
+  /// @return true if a digest was recorded for @a file_name.
+  static bool TakeDigest(const std::string& file_name, std::string* sha256_hex);
+
+ protected:
+  ~HashingFile() override;
+
+  bool Open() override;
+
+ private:
+  std::unique_ptr<File, FileCloser> internal_file_;
+  mbedtls_md_context_t md_context_;
+  // Write position implied by the bytes hashed so far. A seek elsewhere
+  // makes the linear digest meaningless.
+  uint64_t bytes_hashed_ = 0;
+  bool digest_valid_ = true;
+
+  DISALLOW_COPY_AND_ASSIGN(HashingFile);
+};
+
+}  // namespace shaka
+
+#endif  // PACKAGER_FILE_HASHING_FILE_H_
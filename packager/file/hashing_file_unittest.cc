@@ -0,0 +1,90 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/file/hashing_file.h>
+
+#include <gtest/gtest.h>
+
+#include <packager/file.h>
+#include <packager/file/file_test_util.h>
+
+namespace shaka {
+namespace {
+
+// SHA-256 of the string "abc", a standard test vector.
+const char kAbcSha256Hex[] =
+    "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad";
+
+}  // namespace
+
+class HashingFileTest : public testing::Test {
+ protected:
+  void SetUp() override { HashingFile::SetEnabled(true); }
+  void TearDown() override { HashingFile::SetEnabled(false); }
+};
+
+TEST_F(HashingFileTest, RecordsDigestOfLinearWrite) {
+  TempFile temp_file;
+
+  File* file = File::Open(temp_file.path().c_str(), "w");
+  ASSERT_TRUE(file);
+  ASSERT_EQ(3, file->Write("abc", 3));
+  ASSERT_TRUE(file->Close());
+
+  std::string sha256_hex;
+  ASSERT_TRUE(HashingFile::TakeDigest(temp_file.path(), &sha256_hex));
+  EXPECT_EQ(kAbcSha256Hex, sha256_hex);
+
+  // A digest can only be claimed once.
+  EXPECT_FALSE(HashingFile::TakeDigest(temp_file.path(), &sha256_hex));
+}
+
+TEST_F(HashingFileTest, SeekToCurrentPositionKeepsDigest) {
+  TempFile temp_file;
+
+  File* file = File::Open(temp_file.path().c_str(), "w");
+  ASSERT_TRUE(file);
+  ASSERT_EQ(2, file->Write("ab", 2));
+  // A seek to the current write position (e.g. a seekability probe) does not
+  // invalidate the linear digest.
+  ASSERT_TRUE(file->Seek(2));
+  ASSERT_EQ(1, file->Write("c", 1));
+  ASSERT_TRUE(file->Close());
+
+  std::string sha256_hex;
+  ASSERT_TRUE(HashingFile::TakeDigest(temp_file.path(), &sha256_hex));
+  EXPECT_EQ(kAbcSha256Hex, sha256_hex);
+}
+
+TEST_F(HashingFileTest, NonLinearWriteInvalidatesDigest) {
+  TempFile temp_file;
+
+  File* file = File::Open(temp_file.path().c_str(), "w");
+  ASSERT_TRUE(file);
+  ASSERT_EQ(3, file->Write("abc", 3));
+  // Backpatching: the bytes in the file no longer match the hashed stream.
+  ASSERT_TRUE(file->Seek(0));
+  ASSERT_EQ(1, file->Write("x", 1));
+  ASSERT_TRUE(file->Close());
+
+  std::string sha256_hex;
+  EXPECT_FALSE(HashingFile::TakeDigest(temp_file.path(), &sha256_hex));
+}
+
+TEST_F(HashingFileTest, NoDigestWhenDisabled) {
+  HashingFile::SetEnabled(false);
+  TempFile temp_file;
+
+  File* file = File::Open(temp_file.path().c_str(), "w");
+  ASSERT_TRUE(file);
+  ASSERT_EQ(3, file->Write("abc", 3));
+  ASSERT_TRUE(file->Close());
+
+  std::string sha256_hex;
+  EXPECT_FALSE(HashingFile::TakeDigest(temp_file.path(), &sha256_hex));
+}
+
+}  // namespace shaka
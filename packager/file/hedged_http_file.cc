@@ -0,0 +1,326 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/file/hedged_http_file.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <absl/flags/flag.h>
+#include <absl/log/log.h>
+#include <absl/synchronization/mutex.h>
+#include <absl/time/clock.h>
+#include <absl/time/time.h>
+
+#include <packager/file/http_file.h>
+#include <packager/file/thread_pool.h>
+#include <packager/macros/compiler.h>
+
+ABSL_FLAG(int32_t,
+          http_upload_retries,
+          0,
+          "Number of additional attempts for a failed HTTP upload. Each "
+          "retry re-sends the whole object after an exponentially growing "
+          "delay.");
+ABSL_FLAG(int64_t,
+          http_upload_retry_delay_ms,
+          500,
+          "Delay before the first HTTP upload retry, in milliseconds; "
+          "doubled for every further retry.");
+ABSL_FLAG(std::string,
+          http_upload_hedge_base_url,
+          "",
+          "Alternate endpoint for HTTP uploads, e.g. "
+          "\"https://replica.example.com\". When an upload to the primary "
+          "endpoint exceeds its latency budget, the same request is raced "
+          "against this endpoint (with the primary's path appended) and the "
+          "first success wins. Empty disables hedging.");
+ABSL_FLAG(double,
+          http_upload_hedge_latency_factor,
+          3.0,
+          "The hedge latency budget as a multiple of the primary endpoint's "
+          "recent upload latency (an exponentially weighted moving "
+          "average).");
+
+namespace shaka {
+
+namespace {
+
+constexpr const char* kBinaryContentType = "application/octet-stream";
+
+// Weight of the newest sample in the per-endpoint latency average.
+constexpr double kEwmaWeight = 0.25;
+
+// Hedge budget used before the first successful upload to an endpoint.
+constexpr absl::Duration kDefaultHedgeBudget = absl::Seconds(1);
+
+// Scheme and authority of |url|, e.g. "https://host:8080".
+std::string EndpointOf(const std::string& url) {
+  const size_t scheme_end = url.find("://");
+  if (scheme_end == std::string::npos)
+    return url;
+  const size_t path_start = url.find('/', scheme_end + 3);
+  return path_start == std::string::npos ? url : url.substr(0, path_start);
+}
+
+// |url| with its scheme and authority replaced by |base|, or an empty string
+// when |base| is empty.
+std::string HedgeUrlFor(const std::string& url, std::string base) {
+  if (base.empty())
+    return "";
+  while (!base.empty() && base.back() == '/')
+    base.pop_back();
+  return base + url.substr(EndpointOf(url).size());
+}
+
+// Tracks an exponentially weighted moving average of successful upload
+// latencies per endpoint for the lifetime of the process, so the hedge
+// budget follows how each origin replica has recently been performing.
+class UploadLatencyTracker {
+ public:
+  static UploadLatencyTracker& Instance() {
+    static UploadLatencyTracker instance;
+    return instance;
+  }
+
+  void RecordSuccess(const std::string& endpoint, absl::Duration latency) {
+    const double latency_ms = absl::ToDoubleMilliseconds(latency);
+    absl::MutexLock lock(&mutex_);
+    auto it = ewma_ms_.find(endpoint);
+    if (it == ewma_ms_.end()) {
+      ewma_ms_[endpoint] = latency_ms;
+    } else {
+      it->second += kEwmaWeight * (latency_ms - it->second);
+    }
+  }
+
+  absl::Duration HedgeBudget(const std::string& endpoint,
+                             double latency_factor) {
+    absl::MutexLock lock(&mutex_);
+    auto it = ewma_ms_.find(endpoint);
+    if (it == ewma_ms_.end())
+      return kDefaultHedgeBudget;
+    return absl::Milliseconds(it->second * latency_factor);
+  }
+
+ private:
+  UploadLatencyTracker() = default;
+
+  absl::Mutex mutex_;
+  std::map<std::string, double> ewma_ms_ ABSL_GUARDED_BY(mutex_);
+};
+
+// Everything an upload task needs, copied or shared so the task can outlive
+// the HedgedHttpFile that started it.
+struct UploadParams {
+  std::string upload_content_type;
+  std::vector<std::string> headers;
+  int32_t timeout_in_seconds;
+  int32_t max_retries;
+  int64_t retry_delay_ms;
+  std::shared_ptr<std::vector<uint8_t>> buffer;
+};
+
+// Outcome of the race between the primary and the hedged request.
+struct HedgeState {
+  absl::Mutex mutex;
+  int outstanding = 0;
+  bool succeeded = false;
+  Status error;  // The first failure.
+};
+
+Status UploadOnce(const std::string& url, const UploadParams& params) {
+  HttpFile* file =
+      new HttpFile(HttpMethod::kPut, url, params.upload_content_type,
+                   params.headers, params.timeout_in_seconds);
+  if (!file->Open()) {
+    // Open only fails when curl could not be initialized, in which case no
+    // transfer task was started and CloseWithStatus would wait forever.
+    return Status(error::INTERNAL_ERROR, "Cannot open " + url);
+  }
+  const std::vector<uint8_t>& data = *params.buffer;
+  uint64_t position = 0;
+  while (position < data.size()) {
+    const int64_t written =
+        file->Write(data.data() + position, data.size() - position);
+    if (written <= 0)
+      break;
+    position += written;
+  }
+  file->CloseForWriting();
+  return file->CloseWithStatus();
+}
+
+Status UploadWithRetries(const std::string& url, const UploadParams& params) {
+  absl::Duration delay = absl::Milliseconds(params.retry_delay_ms);
+  Status status;
+  for (int32_t attempt = 0; attempt <= params.max_retries; ++attempt) {
+    if (attempt > 0) {
+      LOG(WARNING) << "Retrying upload to " << url << " in " << delay << ": "
+                   << status;
+      absl::SleepFor(delay);
+      delay *= 2;
+    }
+    const absl::Time start = absl::Now();
+    status = UploadOnce(url, params);
+    if (status.ok()) {
+      UploadLatencyTracker::Instance().RecordSuccess(EndpointOf(url),
+                                                     absl::Now() - start);
+      return status;
+    }
+  }
+  return status;
+}
+
+void RunUploadTask(std::shared_ptr<HedgeState> state,
+                   const std::string& url,
+                   const UploadParams& params) {
+  const Status status = UploadWithRetries(url, params);
+  absl::MutexLock lock(&state->mutex);
+  if (status.ok()) {
+    state->succeeded = true;
+  } else if (state->error.ok()) {
+    state->error = status;
+  }
+  --state->outstanding;
+}
+
+}  // namespace
+
+HedgedHttpFile::HedgedHttpFile(const std::string& url)
+    : HedgedHttpFile(url,
+                     absl::GetFlag(FLAGS_http_upload_hedge_base_url),
+                     kBinaryContentType,
+                     {},
+                     0,
+                     absl::GetFlag(FLAGS_http_upload_retries),
+                     absl::GetFlag(FLAGS_http_upload_retry_delay_ms),
+                     absl::GetFlag(FLAGS_http_upload_hedge_latency_factor)) {}
+
+HedgedHttpFile::HedgedHttpFile(const std::string& url,
+                               const std::string& hedge_base_url,
+                               const std::string& upload_content_type,
+                               const std::vector<std::string>& headers,
+                               int32_t timeout_in_seconds,
+                               int32_t max_retries,
+                               int64_t retry_delay_ms,
+                               double hedge_latency_factor)
+    : File(url.c_str()),
+      url_(url),
+      hedge_url_(HedgeUrlFor(url, hedge_base_url)),
+      upload_content_type_(upload_content_type),
+      headers_(headers),
+      timeout_in_seconds_(timeout_in_seconds),
+      max_retries_(max_retries),
+      retry_delay_ms_(retry_delay_ms),
+      hedge_latency_factor_(hedge_latency_factor),
+      buffer_(std::make_shared<std::vector<uint8_t>>()) {}
+
+HedgedHttpFile::~HedgedHttpFile() {}
+
+// static
+bool HedgedHttpFile::Enabled() {
+  return absl::GetFlag(FLAGS_http_upload_retries) > 0 ||
+         !absl::GetFlag(FLAGS_http_upload_hedge_base_url).empty();
+}
+
+bool HedgedHttpFile::Open() {
+  VLOG(2) << "Opening " << url_ << " for a hedged upload.";
+  return true;
+}
+
+Status HedgedHttpFile::CloseWithStatus() {
+  const Status result = Upload();
+  LOG_IF(ERROR, !result.ok()) << "Hedged upload failed: " << result;
+  delete this;
+  return result;
+}
+
+bool HedgedHttpFile::Close() {
+  return CloseWithStatus().ok();
+}
+
+int64_t HedgedHttpFile::Read(void* buffer, uint64_t length) {
+  UNUSED(buffer);
+  UNUSED(length);
+  LOG(ERROR) << "HedgedHttpFile does not support Read().";
+  return -1;
+}
+
+int64_t HedgedHttpFile::Write(const void* buffer, uint64_t length) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(buffer);
+  buffer_->insert(buffer_->end(), bytes, bytes + length);
+  return length;
+}
+
+void HedgedHttpFile::CloseForWriting() {}
+
+int64_t HedgedHttpFile::Size() {
+  return buffer_->size();
+}
+
+bool HedgedHttpFile::Flush() {
+  // Nothing is on the wire until close; the upload must be complete and
+  // repeatable before the first request starts.
+  return true;
+}
+
+bool HedgedHttpFile::Seek(uint64_t position) {
+  UNUSED(position);
+  LOG(ERROR) << "HedgedHttpFile does not support Seek().";
+  return false;
+}
+
+bool HedgedHttpFile::Tell(uint64_t* position) {
+  UNUSED(position);
+  LOG(ERROR) << "HedgedHttpFile does not support Tell().";
+  return false;
+}
+
+Status HedgedHttpFile::Upload() {
+  UploadParams params = {upload_content_type_, headers_, timeout_in_seconds_,
+                         max_retries_,         retry_delay_ms_, buffer_};
+  if (hedge_url_.empty())
+    return UploadWithRetries(url_, params);
+
+  auto state = std::make_shared<HedgeState>();
+  state->outstanding = 1;
+  ThreadPool::instance.PostTask([state, url = url_, params]() {
+    RunUploadTask(state, url, params);
+  });
+
+  const absl::Duration budget = UploadLatencyTracker::Instance().HedgeBudget(
+      EndpointOf(url_), hedge_latency_factor_);
+
+  absl::MutexLock lock(&state->mutex);
+  state->mutex.AwaitWithTimeout(
+      absl::Condition(
+          +[](HedgeState* s) { return s->succeeded || s->outstanding == 0; },
+          state.get()),
+      budget);
+  if (!state->succeeded) {
+    // The primary is past its latency budget (or already failed); race the
+    // alternate endpoint and take the first success.
+    LOG(WARNING) << "Upload to " << url_ << " exceeded its latency budget of "
+                 << budget << "; hedging to " << hedge_url_;
+    ++state->outstanding;
+    ThreadPool::instance.PostTask([state, url = hedge_url_, params]() {
+      RunUploadTask(state, url, params);
+    });
+    state->mutex.Await(absl::Condition(
+        +[](HedgeState* s) { return s->succeeded || s->outstanding == 0; },
+        state.get()));
+  }
+  if (state->succeeded)
+    return Status::OK;
+  return state->error.ok()
+             ? Status(error::HTTP_FAILURE, "Upload to " + url_ + " failed.")
+             : state->error;
+}
+
+}  // namespace shaka
@@ -0,0 +1,112 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_FILE_HEDGED_HTTP_FILE_H_
+#define PACKAGER_FILE_HEDGED_HTTP_FILE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <packager/file.h>
+#include <packager/macros/classes.h>
+
+namespace shaka {
+
+/// HedgedHttpFile is an upload reliability layer in front of HttpFile. It
+/// buffers the whole object (typically one segment) in memory and performs
+/// the PUT on close, which makes the upload repeatable:
+///
+/// - Failed uploads are retried with exponential backoff
+///   (--http_upload_retries, --http_upload_retry_delay_ms).
+/// - When --http_upload_hedge_base_url is set and the primary endpoint has
+///   not answered within a latency budget, the same PUT is raced against the
+///   alternate endpoint and the first success wins. The budget is derived
+///   from an exponentially weighted moving average of the primary endpoint's
+///   recent upload latencies, so hedges fire when a replica is slower than
+///   its own recent history rather than on a fixed timer.
+///
+/// Close() returns once one endpoint has accepted the object; a losing
+/// in-flight request is left to finish in the background. Only write mode is
+/// supported.
+class HedgedHttpFile : public File {
+ public:
+  /// Create a hedged upload for @a url with retry and hedging parameters
+  /// taken from the command line flags.
+  explicit HedgedHttpFile(const std::string& url);
+
+  /// Create a hedged upload with explicit parameters.
+  /// @param url is the primary upload url.
+  /// @param hedge_base_url replaces the scheme and authority of @a url for
+  ///        the hedged request; an empty string disables hedging.
+  /// @param upload_content_type is the "Content-Type" of the upload.
+  /// @param headers are extra headers to add to every request.
+  /// @param timeout_in_seconds is the request timeout; 0 means unlimited.
+  /// @param max_retries is the number of additional attempts per endpoint.
+  /// @param retry_delay_ms is the first retry delay, doubled per retry.
+  /// @param hedge_latency_factor scales the latency EWMA into the hedge
+  ///        budget.
+  HedgedHttpFile(const std::string& url,
+                 const std::string& hedge_base_url,
+                 const std::string& upload_content_type,
+                 const std::vector<std::string>& headers,
+                 int32_t timeout_in_seconds,
+                 int32_t max_retries,
+                 int64_t retry_delay_ms,
+                 double hedge_latency_factor);
+
+  /// @return true if any of the retry or hedging flags are set, i.e. http(s)
+  ///         uploads should go through HedgedHttpFile.
+  static bool Enabled();
+
+  /// Performs the (possibly hedged) upload and returns its status.
+  /// Closes the file regardless of the upload result.
+  Status CloseWithStatus();
+
+  /// @name File implementation overrides.
+  /// @{
+  bool Close() override;
+  int64_t Read(void* buffer, uint64_t length) override;
+  int64_t Write(const void* buffer, uint64_t length) override;
+  void CloseForWriting() override;
+  int64_t Size() override;
+  bool Flush() override;
+  bool Seek(uint64_t position) override;
+  bool Tell(uint64_t* position) override;
+  bool Open() override;
+  /// @}
+
+ protected:
+  ~HedgedHttpFile() override;
+
+ private:
+  // Performs the retried upload, racing the hedge endpoint after the latency
+  // budget when one is configured. The upload tasks only reference state that
+  // is shared or copied, so a losing request can safely outlive the file.
+  Status Upload();
+
+  const std::string url_;
+  // Primary url with its scheme and authority replaced by the hedge base
+  // url; empty when hedging is disabled.
+  const std::string hedge_url_;
+  const std::string upload_content_type_;
+  const std::vector<std::string> headers_;
+  const int32_t timeout_in_seconds_;
+  const int32_t max_retries_;
+  const int64_t retry_delay_ms_;
+  const double hedge_latency_factor_;
+
+  // Shared with the upload tasks, which may outlive this file when a hedged
+  // request loses the race.
+  std::shared_ptr<std::vector<uint8_t>> buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(HedgedHttpFile);
+};
+
+}  // namespace shaka
+
+#endif  // PACKAGER_FILE_HEDGED_HTTP_FILE_H_
@@ -0,0 +1,92 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/file/hedged_http_file.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <packager/file/file_closer.h>
+#include <packager/media/test/test_web_server.h>
+
+namespace shaka {
+
+namespace {
+
+const std::vector<std::string> kNoHeaders;
+const std::string kNoHedgeBaseUrl;
+const std::string kBinaryContentType = "application/octet-stream";
+const int kDefaultTestTimeout = 10;  // For a local, embedded server
+const int kNoRetries = 0;
+const int64_t kShortRetryDelayMs = 1;
+const double kDefaultHedgeLatencyFactor = 3.0;
+
+using FilePtr = std::unique_ptr<HedgedHttpFile, FileCloser>;
+
+class HedgedHttpFileTest : public testing::Test {
+ protected:
+  void SetUp() override { ASSERT_TRUE(server_.Start()); }
+
+  // The server's base url, e.g. "http://127.0.0.1:8080".
+  std::string BaseUrl() {
+    const std::string reflect_url = server_.ReflectUrl();
+    return reflect_url.substr(0, reflect_url.rfind('/'));
+  }
+
+  media::TestWebServer server_;
+};
+
+}  // namespace
+
+TEST_F(HedgedHttpFileTest, BasicPut) {
+  FilePtr file(new HedgedHttpFile(
+      server_.ReflectUrl(), kNoHedgeBaseUrl, kBinaryContentType, kNoHeaders,
+      kDefaultTestTimeout, kNoRetries, kShortRetryDelayMs,
+      kDefaultHedgeLatencyFactor));
+  ASSERT_TRUE(file->Open());
+
+  const std::string data = "abcd";
+  ASSERT_EQ(static_cast<int64_t>(data.size()),
+            file->Write(data.data(), data.size()));
+  ASSERT_EQ(static_cast<int64_t>(data.size()), file->Size());
+
+  ASSERT_EQ(Status::OK, file.release()->CloseWithStatus());
+}
+
+TEST_F(HedgedHttpFileTest, FailedUploadReturnsErrorAfterRetries) {
+  FilePtr file(new HedgedHttpFile(
+      server_.StatusCodeUrl(502), kNoHedgeBaseUrl, kBinaryContentType,
+      kNoHeaders, kDefaultTestTimeout, /* max_retries= */ 1, kShortRetryDelayMs,
+      kDefaultHedgeLatencyFactor));
+  ASSERT_TRUE(file->Open());
+
+  const std::string data = "abcd";
+  ASSERT_EQ(static_cast<int64_t>(data.size()),
+            file->Write(data.data(), data.size()));
+
+  ASSERT_NE(Status::OK, file.release()->CloseWithStatus());
+}
+
+TEST_F(HedgedHttpFileTest, HedgesToAlternateEndpoint) {
+  // The primary endpoint refuses connections; the hedged request to the test
+  // server must win the race.
+  FilePtr file(new HedgedHttpFile(
+      "http://127.0.0.1:1/reflect", BaseUrl(), kBinaryContentType, kNoHeaders,
+      kDefaultTestTimeout, kNoRetries, kShortRetryDelayMs,
+      kDefaultHedgeLatencyFactor));
+  ASSERT_TRUE(file->Open());
+
+  const std::string data = "abcd";
+  ASSERT_EQ(static_cast<int64_t>(data.size()),
+            file->Write(data.data(), data.size()));
+
+  ASSERT_EQ(Status::OK, file.release()->CloseWithStatus());
+}
+
+}  // namespace shaka
@@ -6,17 +6,26 @@
 
 #include <packager/file/http_file.h>
 
+#include <algorithm>
+#include <map>
+#include <vector>
+
 #include <absl/flags/declare.h>
 #include <absl/flags/flag.h>
 #include <absl/log/check.h>
 #include <absl/log/log.h>
 #include <absl/strings/escaping.h>
+#include <absl/strings/match.h>
 #include <absl/strings/str_format.h>
+#include <absl/synchronization/mutex.h>
 #include <curl/curl.h>
 
+#include <packager/file/io_cancellation.h>
 #include <packager/file/thread_pool.h>
 #include <packager/macros/compiler.h>
 #include <packager/macros/logging.h>
+#include <packager/utils/stall_monitor.h>
+#include <packager/utils/trace_event.h>
 #include <packager/version/version.h>
 
 ABSL_FLAG(std::string,
@@ -45,6 +54,18 @@ ABSL_FLAG(bool,
           false,
           "Disable peer verification. This is needed to talk to servers "
           "without valid certificates.");
+ABSL_FLAG(int32_t,
+          http_parallel_range_requests,
+          0,
+          "Number of concurrent Range requests used to download HTTP "
+          "sources whose size is known. 0 or 1 streams over a single "
+          "connection. Higher values saturate high-latency links at the "
+          "cost of up to N Range requests' worth of reassembly memory.");
+ABSL_FLAG(uint64_t,
+          http_range_request_size,
+          8 * 1024 * 1024,
+          "Size in bytes of each Range request when "
+          "--http_parallel_range_requests is enabled.");
 
 ABSL_DECLARE_FLAG(uint64_t, io_cache_size);
 
@@ -68,6 +89,27 @@ size_t CurlWriteCallback(char* buffer, size_t size, size_t nmemb, void* user) {
   return length;
 }
 
+// Destination of one Range request. |limit| is the number of bytes asked for;
+// receiving more means the server ignored the Range header and is sending the
+// whole resource, in which case the transfer is aborted before the body can
+// grow without bound.
+struct RangeBuffer {
+  std::vector<uint8_t>* data;
+  size_t limit;
+};
+
+size_t CurlRangeWriteCallback(char* buffer,
+                              size_t size,
+                              size_t nmemb,
+                              void* user) {
+  RangeBuffer* out = reinterpret_cast<RangeBuffer*>(user);
+  const size_t length = size * nmemb;
+  if (out->data->size() + length > out->limit)
+    return 0;  // Aborts the transfer with CURLE_WRITE_ERROR.
+  out->data->insert(out->data->end(), buffer, buffer + length);
+  return length;
+}
+
 size_t CurlReadCallback(char* buffer, size_t size, size_t nitems, void* user) {
   IoCache* cache = reinterpret_cast<IoCache*>(user);
   size_t length = cache->Read(buffer, size * nitems);
@@ -75,6 +117,18 @@ size_t CurlReadCallback(char* buffer, size_t size, size_t nitems, void* user) {
   return length;
 }
 
+int CurlProgressCallback(void* /* clientp */,
+                         curl_off_t /* dltotal */,
+                         curl_off_t /* dlnow */,
+                         curl_off_t /* ultotal */,
+                         curl_off_t /* ulnow */) {
+  // A nonzero return aborts the transfer with CURLE_ABORTED_BY_CALLBACK.
+  // curl invokes this about once per second even when no data is flowing, so
+  // a cancelled job lets go of a stalled connection within a second instead
+  // of waiting out the transfer timeout.
+  return IoCancellation::IsRequested() ? 1 : 0;
+}
+
 int CurlDebugCallback(CURL* /* handle */,
                       curl_infotype type,
                       const char* data,
@@ -147,6 +201,61 @@ class LibCurlInitializer {
   LibCurlInitializer& operator=(const LibCurlInitializer&) = delete;
 };
 
+// A process-wide curl share object that pools connections, DNS results and
+// TLS sessions across all HttpFile transfers. Without it every file open
+// creates a cold easy handle and pays TCP slow start plus a full TLS
+// handshake, which dominates when uploading thousands of small chunks per
+// minute. With the shared connection cache, sequential uploads to the same
+// origin reuse warm (HTTP/2-capable) connections.
+class LibCurlShare {
+ public:
+  static LibCurlShare& Instance() {
+    static LibCurlShare instance;
+    return instance;
+  }
+
+  CURLSH* share() const { return share_; }
+
+  LibCurlShare(const LibCurlShare&) = delete;
+  LibCurlShare& operator=(const LibCurlShare&) = delete;
+
+ private:
+  LibCurlShare() : share_(curl_share_init()) {
+    if (!share_)
+      return;
+    curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, &LibCurlShare::Lock);
+    curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, &LibCurlShare::Unlock);
+    curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+  }
+
+  // Process-lifetime singleton: the share object must outlive every easy
+  // handle, so it is intentionally never cleaned up.
+  ~LibCurlShare() = default;
+
+  static void Lock(CURL* /* handle */,
+                   curl_lock_data data,
+                   curl_lock_access /* access */,
+                   void* userptr) {
+    static_cast<LibCurlShare*>(userptr)->mutexes_[data].Lock();
+  }
+
+  static void Unlock(CURL* /* handle */, curl_lock_data data, void* userptr) {
+    static_cast<LibCurlShare*>(userptr)->mutexes_[data].Unlock();
+  }
+
+  absl::Mutex mutexes_[CURL_LOCK_DATA_LAST];
+  CURLSH* share_;
+};
+
+// curl_global_init is not thread safe; funnel all users through one local
+// static so it runs exactly once, before the first easy handle is created.
+void EnsureLibCurlInitialized() {
+  static LibCurlInitializer lib_curl_initializer;
+}
+
 template <typename List>
 bool AppendHeader(const std::string& header, List* list) {
   auto* temp = curl_slist_append(list->get(), header.c_str());
@@ -174,6 +283,9 @@ HttpFile::HttpFile(HttpMethod method,
       upload_content_type_(upload_content_type),
       timeout_in_seconds_(timeout_in_seconds),
       method_(method),
+      parallel_range_requests_(
+          absl::GetFlag(FLAGS_http_parallel_range_requests)),
+      range_request_size_(absl::GetFlag(FLAGS_http_range_request_size)),
       download_cache_(absl::GetFlag(FLAGS_io_cache_size)),
       upload_cache_(absl::GetFlag(FLAGS_io_cache_size)),
       curl_(curl_easy_init()),
@@ -185,11 +297,16 @@ HttpFile::HttpFile(HttpMethod method,
           absl::GetFlag(FLAGS_client_cert_private_key_file)),
       client_cert_private_key_password_(
           absl::GetFlag(FLAGS_client_cert_private_key_password)) {
-  static LibCurlInitializer lib_curl_initializer;
+  EnsureLibCurlInitialized();
   if (user_agent_.empty()) {
     user_agent_ += "ShakaPackager/" + GetPackagerVersion();
   }
 
+  // Attribute stalls on the transfer caches (curl slower than the pipeline,
+  // or vice versa) to this URL.
+  download_cache_.set_stall_name(url_);
+  upload_cache_.set_stall_name(url_);
+
   // We will have at least one header, so use a null header to signal error
   // to Open.
 
@@ -215,6 +332,57 @@ HttpFile::HttpFile(HttpMethod method,
 
 HttpFile::~HttpFile() {}
 
+// static
+void HttpFile::PreWarm(const std::string& url) {
+  if (!absl::StartsWith(url, "http://") && !absl::StartsWith(url, "https://"))
+    return;
+  EnsureLibCurlInitialized();
+  if (!LibCurlShare::Instance().share())
+    return;
+
+  std::unique_ptr<CURL, CurlDelete> curl(curl_easy_init());
+  if (!curl)
+    return;
+  curl_easy_setopt(curl.get(), CURLOPT_URL, url.c_str());
+  // Route the DNS result and TLS session ticket into the process-wide share
+  // so the first real transfer to this origin picks them up.
+  curl_easy_setopt(curl.get(), CURLOPT_SHARE, LibCurlShare::Instance().share());
+  // Stop once the connection (including the TLS handshake) is established;
+  // no request is sent.
+  curl_easy_setopt(curl.get(), CURLOPT_CONNECT_ONLY, 1L);
+  curl_easy_setopt(curl.get(), CURLOPT_CONNECTTIMEOUT, 5L);
+  // Match the TLS configuration of real transfers; otherwise the cached
+  // session would not be resumable by them.
+  if (absl::GetFlag(FLAGS_disable_peer_verification))
+    curl_easy_setopt(curl.get(), CURLOPT_SSL_VERIFYPEER, 0L);
+  const std::string ca_file = absl::GetFlag(FLAGS_ca_file);
+  if (!ca_file.empty())
+    curl_easy_setopt(curl.get(), CURLOPT_CAINFO, ca_file.data());
+  const std::string client_cert_file = absl::GetFlag(FLAGS_client_cert_file);
+  const std::string client_cert_private_key_file =
+      absl::GetFlag(FLAGS_client_cert_private_key_file);
+  if (!client_cert_private_key_file.empty() && !client_cert_file.empty()) {
+    curl_easy_setopt(curl.get(), CURLOPT_SSLKEY,
+                     client_cert_private_key_file.data());
+    curl_easy_setopt(curl.get(), CURLOPT_SSLCERT, client_cert_file.data());
+    curl_easy_setopt(curl.get(), CURLOPT_SSLKEYTYPE, "PEM");
+    curl_easy_setopt(curl.get(), CURLOPT_SSLCERTTYPE, "PEM");
+    const std::string password =
+        absl::GetFlag(FLAGS_client_cert_private_key_password);
+    if (!password.empty())
+      curl_easy_setopt(curl.get(), CURLOPT_KEYPASSWD, password.data());
+  }
+
+  const CURLcode res = curl_easy_perform(curl.get());
+  if (res == CURLE_OK) {
+    VLOG(1) << "Pre-warmed connection to " << url;
+  } else {
+    // Purely an optimization; the real transfer will surface any hard error.
+    VLOG(1) << "Failed to pre-warm connection to " << url << ": "
+            << curl_easy_strerror(res);
+  }
+}
+
 bool HttpFile::Open() {
   VLOG(2) << "Opening " << url_;
 
@@ -227,7 +395,12 @@ bool HttpFile::Open() {
   // TODO: Implement retrying with exponential backoff, see
   // "widevine_key_source.cc"
 
-  ThreadPool::instance.PostTask(std::bind(&HttpFile::ThreadMain, this));
+  if (method_ == HttpMethod::kGet && parallel_range_requests_ > 1 &&
+      range_request_size_ > 0) {
+    ThreadPool::instance.PostTask(std::bind(&HttpFile::RangeThreadMain, this));
+  } else {
+    ThreadPool::instance.PostTask(std::bind(&HttpFile::ThreadMain, this));
+  }
 
   return true;
 }
@@ -241,7 +414,11 @@ Status HttpFile::CloseWithStatus() {
   // code at minimum) can still be written after uploading is complete.
   // The task will close the download cache when it is complete.
   upload_cache_.Close();
-  task_exit_event_.WaitForNotification();
+  {
+    // This wait covers the tail of the transfer and the server's response.
+    StallMonitor::ScopedWait stall_wait("http.close_wait", url_);
+    task_exit_event_.WaitForNotification();
+  }
 
   const Status result = status_;
   LOG_IF(ERROR, !result.ok()) << "HttpFile request failed: " << result;
@@ -292,6 +469,14 @@ bool HttpFile::Tell(uint64_t* position) {
   return false;
 }
 
+uint64_t HttpFile::OptimalReadSize() {
+  // Remote storage is throughput-bound: per-request overhead dominates small
+  // reads, so drain the download cache in chunks the size of one Range
+  // request (or a large fixed chunk when ranged downloads are off).
+  const uint64_t kDefaultChunkSize = 8 * 1024 * 1024;
+  return range_request_size_ > 0 ? range_request_size_ : kDefaultChunkSize;
+}
+
 void HttpFile::CurlDelete::operator()(CURL* curl) {
   curl_easy_cleanup(curl);
 }
@@ -300,34 +485,23 @@ void HttpFile::CurlDelete::operator()(curl_slist* headers) {
   curl_slist_free_all(headers);
 }
 
-void HttpFile::SetupRequest() {
-  auto* curl = curl_.get();
+void HttpFile::SetupTransportOptions(CURL* curl) {
+  // Reuse pooled connections/DNS/TLS sessions across transfers, negotiate
+  // HTTP/2 over TLS, and keep idle connections warm between chunk uploads.
+  if (LibCurlShare::Instance().share())
+    curl_easy_setopt(curl, CURLOPT_SHARE, LibCurlShare::Instance().share());
+  curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+  curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
 
-  switch (method_) {
-    case HttpMethod::kGet:
-      curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
-      break;
-    case HttpMethod::kPost:
-      curl_easy_setopt(curl, CURLOPT_POST, 1L);
-      break;
-    case HttpMethod::kPut:
-      curl_easy_setopt(curl, CURLOPT_PUT, 1L);
-      break;
-  }
+  // Cooperative cancellation checkpoint for fast job teardown.
+  curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, &CurlProgressCallback);
+  curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
 
   curl_easy_setopt(curl, CURLOPT_URL, url_.c_str());
   curl_easy_setopt(curl, CURLOPT_USERAGENT, user_agent_.c_str());
   curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout_in_seconds_);
   curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1L);
   curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, &CurlWriteCallback);
-  curl_easy_setopt(curl, CURLOPT_WRITEDATA, &download_cache_);
-  if (method_ != HttpMethod::kGet) {
-    curl_easy_setopt(curl, CURLOPT_READFUNCTION, &CurlReadCallback);
-    curl_easy_setopt(curl, CURLOPT_READDATA, &upload_cache_);
-  }
-
-  curl_easy_setopt(curl, CURLOPT_HTTPHEADER, request_headers_.get());
 
   if (absl::GetFlag(FLAGS_disable_peer_verification))
     curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
@@ -355,7 +529,37 @@ void HttpFile::SetupRequest() {
   }
 }
 
+void HttpFile::SetupRequest() {
+  auto* curl = curl_.get();
+
+  switch (method_) {
+    case HttpMethod::kGet:
+      curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
+      break;
+    case HttpMethod::kPost:
+      curl_easy_setopt(curl, CURLOPT_POST, 1L);
+      break;
+    case HttpMethod::kPut:
+      curl_easy_setopt(curl, CURLOPT_PUT, 1L);
+      break;
+  }
+
+  SetupTransportOptions(curl);
+
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, &CurlWriteCallback);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, &download_cache_);
+  if (method_ != HttpMethod::kGet) {
+    curl_easy_setopt(curl, CURLOPT_READFUNCTION, &CurlReadCallback);
+    curl_easy_setopt(curl, CURLOPT_READDATA, &upload_cache_);
+  }
+
+  curl_easy_setopt(curl, CURLOPT_HTTPHEADER, request_headers_.get());
+}
+
 void HttpFile::ThreadMain() {
+  TraceBuffer::ScopedEvent trace(
+      "file", method_ == HttpMethod::kPut ? "http_upload" : "http_download",
+      url_);
   SetupRequest();
 
   CURLcode res = curl_easy_perform(curl_.get());
@@ -367,9 +571,11 @@ void HttpFile::ThreadMain() {
       error_message += absl::StrFormat(", response code: %ld.", response_code);
     }
 
-    status_ = Status(
-        res == CURLE_OPERATION_TIMEDOUT ? error::TIME_OUT : error::HTTP_FAILURE,
-        error_message);
+    status_ = Status(res == CURLE_OPERATION_TIMEDOUT ? error::TIME_OUT
+                     : res == CURLE_ABORTED_BY_CALLBACK
+                         ? error::CANCELLED
+                         : error::HTTP_FAILURE,
+                     error_message);
   }
 
   // In some cases it is possible that the server has already closed the
@@ -382,4 +588,218 @@ void HttpFile::ThreadMain() {
   task_exit_event_.Notify();
 }
 
+int64_t HttpFile::ProbeContentLength() {
+  std::unique_ptr<CURL, CurlDelete> curl(curl_easy_init());
+  if (!curl)
+    return -1;
+  SetupTransportOptions(curl.get());
+  curl_easy_setopt(curl.get(), CURLOPT_NOBODY, 1L);
+  curl_easy_setopt(curl.get(), CURLOPT_HTTPHEADER, request_headers_.get());
+
+  if (curl_easy_perform(curl.get()) != CURLE_OK)
+    return -1;
+  curl_off_t content_length = -1;
+  curl_easy_getinfo(curl.get(), CURLINFO_CONTENT_LENGTH_DOWNLOAD_T,
+                    &content_length);
+  return content_length;
+}
+
+Status HttpFile::DownloadRange(uint64_t first_byte,
+                               uint64_t last_byte,
+                               std::vector<uint8_t>* out,
+                               bool* range_unsupported) {
+  std::unique_ptr<CURL, CurlDelete> curl(curl_easy_init());
+  if (!curl)
+    return Status(error::HTTP_FAILURE, "curl_easy_init() failed.");
+  SetupTransportOptions(curl.get());
+  curl_easy_setopt(curl.get(), CURLOPT_HTTPGET, 1L);
+  curl_easy_setopt(curl.get(), CURLOPT_HTTPHEADER, request_headers_.get());
+
+  const std::string range =
+      absl::StrFormat("%u-%u", first_byte, last_byte);
+  curl_easy_setopt(curl.get(), CURLOPT_RANGE, range.c_str());
+
+  out->reserve(last_byte - first_byte + 1);
+  RangeBuffer buffer = {out, static_cast<size_t>(last_byte - first_byte + 1)};
+  curl_easy_setopt(curl.get(), CURLOPT_WRITEFUNCTION, &CurlRangeWriteCallback);
+  curl_easy_setopt(curl.get(), CURLOPT_WRITEDATA, &buffer);
+
+  const CURLcode res = curl_easy_perform(curl.get());
+  long response_code = 0;
+  curl_easy_getinfo(curl.get(), CURLINFO_RESPONSE_CODE, &response_code);
+  if (res != CURLE_OK) {
+    if (res == CURLE_WRITE_ERROR && response_code == 200) {
+      *range_unsupported = true;
+      return Status(error::HTTP_FAILURE,
+                    "Server ignored the Range header for " + url_);
+    }
+    std::string error_message = curl_easy_strerror(res);
+    error_message += absl::StrFormat(", response code: %ld.", response_code);
+    return Status(res == CURLE_OPERATION_TIMEDOUT ? error::TIME_OUT
+                  : res == CURLE_ABORTED_BY_CALLBACK
+                      ? error::CANCELLED
+                      : error::HTTP_FAILURE,
+                  error_message);
+  }
+  if (response_code != 206) {
+    *range_unsupported = true;
+    return Status(error::HTTP_FAILURE,
+                  "Server ignored the Range header for " + url_);
+  }
+  if (out->size() != last_byte - first_byte + 1) {
+    return Status(error::HTTP_FAILURE,
+                  absl::StrFormat("Short Range response for %s: %s gave %zu "
+                                  "bytes.",
+                                  url_, range, out->size()));
+  }
+  return Status::OK;
+}
+
+namespace {
+
+// Shared state between the in-order writer and the concurrent range download
+// tasks. Lives on the coordinator's stack; the coordinator joins all workers
+// before returning.
+struct RangeDownloadState {
+  absl::Mutex mutex;
+  uint64_t total_size = 0;
+  uint64_t num_chunks = 0;
+  // Bound on how far chunk assignment may run ahead of the in-order writer;
+  // caps reassembly memory at this many chunks.
+  uint64_t max_chunks_ahead = 0;
+  uint64_t next_chunk ABSL_GUARDED_BY(mutex) = 0;
+  uint64_t next_write ABSL_GUARDED_BY(mutex) = 0;
+  std::map<uint64_t, std::vector<uint8_t>> completed ABSL_GUARDED_BY(mutex);
+  int active_workers ABSL_GUARDED_BY(mutex) = 0;
+  bool failed ABSL_GUARDED_BY(mutex) = false;
+  bool range_unsupported ABSL_GUARDED_BY(mutex) = false;
+  Status status ABSL_GUARDED_BY(mutex);
+};
+
+}  // namespace
+
+void HttpFile::RangeThreadMain() {
+  const int64_t content_length = ProbeContentLength();
+  const uint64_t num_chunks =
+      content_length > 0
+          ? (content_length + range_request_size_ - 1) / range_request_size_
+          : 0;
+  if (num_chunks <= 1) {
+    // Unknown size, empty resource or a single chunk; nothing to
+    // parallelize.
+    ThreadMain();
+    return;
+  }
+
+  RangeDownloadState state;
+  state.total_size = content_length;
+  state.num_chunks = num_chunks;
+  state.max_chunks_ahead = parallel_range_requests_;
+
+  const int num_workers = static_cast<int>(
+      std::min<uint64_t>(parallel_range_requests_, num_chunks));
+  {
+    absl::MutexLock lock(&state.mutex);
+    state.active_workers = num_workers;
+  }
+  for (int i = 0; i < num_workers; ++i) {
+    ThreadPool::instance.PostTask([this, &state]() {
+      for (;;) {
+        uint64_t chunk;
+        {
+          absl::MutexLock lock(&state.mutex);
+          // Wait for a slot in the reassembly window.
+          state.mutex.Await(absl::Condition(
+              +[](RangeDownloadState* s) {
+                s->mutex.AssertHeld();
+                return s->failed || s->next_chunk >= s->num_chunks ||
+                       s->next_chunk < s->next_write + s->max_chunks_ahead;
+              },
+              &state));
+          if (state.failed || state.next_chunk >= state.num_chunks) {
+            --state.active_workers;
+            return;
+          }
+          chunk = state.next_chunk++;
+        }
+
+        const uint64_t first_byte = chunk * range_request_size_;
+        const uint64_t last_byte =
+            std::min(first_byte + range_request_size_, state.total_size) - 1;
+        std::vector<uint8_t> data;
+        bool range_unsupported = false;
+        const Status status =
+            DownloadRange(first_byte, last_byte, &data, &range_unsupported);
+
+        absl::MutexLock lock(&state.mutex);
+        if (!status.ok()) {
+          if (!state.failed) {
+            state.failed = true;
+            state.range_unsupported = range_unsupported;
+            state.status = status;
+          }
+          --state.active_workers;
+          return;
+        }
+        state.completed[chunk] = std::move(data);
+      }
+    });
+  }
+
+  // Deliver the chunks to the reader in order. The download cache blocks
+  // when full, so the window follows the reader's consumption rate.
+  for (uint64_t i = 0; i < num_chunks; ++i) {
+    std::vector<uint8_t> data;
+    {
+      absl::MutexLock lock(&state.mutex);
+      state.mutex.Await(absl::Condition(
+          +[](RangeDownloadState* s) {
+            s->mutex.AssertHeld();
+            return s->failed || s->completed.count(s->next_write) > 0;
+          },
+          &state));
+      if (state.failed)
+        break;
+      data = std::move(state.completed[state.next_write]);
+      state.completed.erase(state.next_write);
+    }
+    const uint64_t written = download_cache_.Write(data.data(), data.size());
+    absl::MutexLock lock(&state.mutex);
+    if (written < data.size()) {
+      // The reader closed early; stop downloading.
+      state.failed = true;
+      break;
+    }
+    ++state.next_write;
+  }
+
+  bool fall_back_to_streaming = false;
+  {
+    absl::MutexLock lock(&state.mutex);
+    state.failed = true;  // Unblock any worker still waiting for a slot.
+    state.mutex.Await(absl::Condition(
+        +[](RangeDownloadState* s) {
+          s->mutex.AssertHeld();
+          return s->active_workers == 0;
+        },
+        &state));
+    // Only fall back when nothing has been delivered yet, so the reader sees
+    // the stream from the start.
+    fall_back_to_streaming = state.range_unsupported && state.next_write == 0;
+    if (!fall_back_to_streaming && !state.status.ok())
+      status_ = state.status;
+  }
+
+  if (fall_back_to_streaming) {
+    LOG(WARNING) << "Server does not support Range requests for " << url_
+                 << "; falling back to a single streaming download.";
+    ThreadMain();
+    return;
+  }
+
+  upload_cache_.Close();
+  download_cache_.Close();
+  task_exit_event_.Notify();
+}
+
 }  // namespace shaka
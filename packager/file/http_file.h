@@ -31,6 +31,14 @@ enum class HttpMethod {
 /// Note that calling Flush will indicate EOF for the upload and no more can be
 /// uploaded.
 ///
+/// Downloads stream over a single connection by default. With
+/// --http_parallel_range_requests set, GET transfers of sources that report a
+/// content length are split into fixed-size Range requests downloaded
+/// concurrently and reassembled in order ahead of the reader, which saturates
+/// high-latency links that a single connection cannot. The reader's io cache
+/// provides the flow control, so the download window follows the consumption
+/// rate. Servers without Range support fall back to the streaming path.
+///
 /// About how to use this, please visit the corresponding documentation [1].
 ///
 /// [1]
@@ -47,6 +55,13 @@ class HttpFile : public File {
   HttpFile(const HttpFile&) = delete;
   HttpFile& operator=(const HttpFile&) = delete;
 
+  /// Establishes a connection to the origin serving @a url and caches the DNS
+  /// result and TLS session ticket in the process-wide curl share, so the
+  /// first real request to that origin skips name resolution and completes an
+  /// abbreviated TLS handshake. Best effort and blocking; intended to be run
+  /// on a worker thread during startup. Non http(s) urls are ignored.
+  static void PreWarm(const std::string& url);
+
   Status CloseWithStatus();
 
   /// @name File implementation overrides.
@@ -59,6 +74,7 @@ class HttpFile : public File {
   bool Flush() override;
   bool Seek(uint64_t position) override;
   bool Tell(uint64_t* position) override;
+  uint64_t OptimalReadSize() override;
   bool Open() override;
   /// @}
 
@@ -71,13 +87,36 @@ class HttpFile : public File {
     void operator()(curl_slist* headers);
   };
 
+  // Applies the transport options shared by every transfer for this file:
+  // curl share, HTTP/2, keepalive, user agent, timeout and TLS configuration.
+  void SetupTransportOptions(CURL* curl);
   void SetupRequest();
   void ThreadMain();
 
+  // Issues a HEAD request for |url_|.
+  // Returns the content length, or -1 if it cannot be determined.
+  int64_t ProbeContentLength();
+  // Downloads [first_byte, last_byte] with a Range request into |out|.
+  // Fails without writing the body and sets |range_unsupported| if the server
+  // ignores the Range header.
+  Status DownloadRange(uint64_t first_byte,
+                       uint64_t last_byte,
+                       std::vector<uint8_t>* out,
+                       bool* range_unsupported);
+  // Coordinator for the parallel Range download mode: assigns chunks to
+  // concurrent download tasks and writes them to the download cache in order.
+  // Falls back to ThreadMain() when ranged downloads are not possible.
+  void RangeThreadMain();
+
   const std::string url_;
   const std::string upload_content_type_;
   const int32_t timeout_in_seconds_;
   const HttpMethod method_;
+  // Number of concurrent Range requests for downloads; 0 or 1 streams over a
+  // single connection.
+  const int32_t parallel_range_requests_;
+  // Size of each Range request in the parallel download mode.
+  const uint64_t range_request_size_;
   IoCache download_cache_;
   IoCache upload_cache_;
   std::unique_ptr<CURL, CurlDelete> curl_;
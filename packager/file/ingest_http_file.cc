@@ -0,0 +1,439 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/file/ingest_http_file.h>
+
+#if defined(OS_WIN)
+#include <ws2tcpip.h>
+#define close closesocket
+#define EINTR_CODE WSAEINTR
+#else
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#define INVALID_SOCKET -1
+#define EINTR_CODE EINTR
+#endif  // defined(OS_WIN)
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#include <absl/log/check.h>
+#include <absl/log/log.h>
+#include <absl/strings/ascii.h>
+#include <absl/strings/numbers.h>
+
+#include <packager/macros/classes.h>
+#include <packager/macros/compiler.h>
+#include <packager/macros/logging.h>
+
+namespace shaka {
+
+namespace {
+
+// Upper bound on the request header; encoders send a handful of lines.
+const size_t kMaxRequestHeaderSize = 64 * 1024;
+
+const char kContinueResponse[] = "HTTP/1.1 100 Continue\r\n\r\n";
+const char kOkResponse[] =
+    "HTTP/1.1 200 OK\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+const char kBadRequestResponse[] =
+    "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: "
+    "close\r\n\r\n";
+
+int GetSocketErrorCode() {
+#if defined(OS_WIN)
+  return WSAGetLastError();
+#else
+  return errno;
+#endif
+}
+
+int64_t RecvInternal(SOCKET socket, void* buffer, uint64_t length) {
+  int64_t result;
+  do {
+    result = recv(socket, reinterpret_cast<char*>(buffer),
+                  static_cast<int>(length), 0);
+  } while (result == -1 && GetSocketErrorCode() == EINTR_CODE);
+  return result;
+}
+
+void SendResponse(SOCKET socket, const char* response) {
+  const size_t response_size = strlen(response);
+  // Best effort; the pushing side may already be gone.
+  UNUSED(send(socket, response, static_cast<int>(response_size), 0));
+}
+
+// Returns the value of |header_name| in |lower_header_block| (which must
+// already be lower cased), or an empty string if not present.
+std::string GetHeaderValue(const std::string& lower_header_block,
+                           const std::string& header_name) {
+  const std::string search = "\r\n" + header_name + ":";
+  const size_t pos = lower_header_block.find(search);
+  if (pos == std::string::npos)
+    return "";
+  const size_t value_begin = pos + search.size();
+  const size_t value_end = lower_header_block.find("\r\n", value_begin);
+  std::string value =
+      lower_header_block.substr(value_begin, value_end - value_begin);
+  return std::string(absl::StripAsciiWhitespace(value));
+}
+
+}  // anonymous namespace
+
+IngestHttpFile::IngestHttpFile(const char* address_and_port)
+    : File(address_and_port),
+      listen_socket_(INVALID_SOCKET),
+      socket_(INVALID_SOCKET) {}
+
+IngestHttpFile::~IngestHttpFile() {}
+
+bool IngestHttpFile::Open() {
+#if defined(OS_WIN)
+  WSADATA wsa_data;
+  int wsa_error = WSAStartup(MAKEWORD(2, 2), &wsa_data);
+  if (wsa_error != 0) {
+    LOG(ERROR) << "Winsock start up failed with error " << wsa_error;
+    return false;
+  }
+  wsa_started_ = true;
+#endif  // defined(OS_WIN)
+
+  DCHECK_EQ(INVALID_SOCKET, listen_socket_);
+
+  const std::string address_and_port = file_name();
+  const size_t colon_pos = address_and_port.rfind(':');
+  if (colon_pos == std::string::npos) {
+    LOG(ERROR) << "Malformed ingest address '" << address_and_port
+               << "'. Expecting '<address>:<port>'.";
+    return false;
+  }
+  std::string address = address_and_port.substr(0, colon_pos);
+  if (address.empty())
+    address = "0.0.0.0";
+  uint32_t port = 0;
+  if (!absl::SimpleAtoi(address_and_port.substr(colon_pos + 1), &port) ||
+      port > 65535) {
+    LOG(ERROR) << "Malformed ingest port in '" << address_and_port << "'.";
+    return false;
+  }
+
+  struct in_addr local_in_addr = {0};
+  if (inet_pton(AF_INET, address.c_str(), &local_in_addr) != 1) {
+    LOG(ERROR) << "Malformed IPv4 address " << address;
+    return false;
+  }
+
+  listen_socket_ = socket(AF_INET, SOCK_STREAM, 0);
+  if (listen_socket_ == INVALID_SOCKET) {
+    LOG(ERROR) << "Could not allocate socket, error = " << GetSocketErrorCode();
+    return false;
+  }
+
+  const int optval = 1;
+  if (setsockopt(listen_socket_, SOL_SOCKET, SO_REUSEADDR,
+                 reinterpret_cast<const char*>(&optval), sizeof(optval)) < 0) {
+    LOG(ERROR) << "Could not apply the SO_REUSEADDR property to the ingest "
+                  "socket, error = "
+               << GetSocketErrorCode();
+    close(listen_socket_);
+    listen_socket_ = INVALID_SOCKET;
+    return false;
+  }
+
+  // TODO: Support IPv6.
+  struct sockaddr_in local_sock_addr;
+  memset(&local_sock_addr, 0, sizeof(local_sock_addr));
+  local_sock_addr.sin_family = AF_INET;
+  local_sock_addr.sin_port = htons(static_cast<uint16_t>(port));
+  local_sock_addr.sin_addr = local_in_addr;
+
+  if (bind(listen_socket_,
+           reinterpret_cast<struct sockaddr*>(&local_sock_addr),
+           sizeof(local_sock_addr)) < 0) {
+    LOG(ERROR) << "Could not bind ingest socket, error = "
+               << GetSocketErrorCode();
+    close(listen_socket_);
+    listen_socket_ = INVALID_SOCKET;
+    return false;
+  }
+
+  // A single pushing encoder per ingest point.
+  if (listen(listen_socket_, 1) < 0) {
+    LOG(ERROR) << "Could not listen on ingest socket, error = "
+               << GetSocketErrorCode();
+    close(listen_socket_);
+    listen_socket_ = INVALID_SOCKET;
+    return false;
+  }
+
+  LOG(INFO) << "Waiting for a push on ingest-http://" << address_and_port
+            << ".";
+  return true;
+}
+
+bool IngestHttpFile::AcceptAndReadRequestHeader() {
+  DCHECK(!connection_accepted_);
+
+  do {
+    socket_ = accept(listen_socket_, NULL, NULL);
+  } while (socket_ == INVALID_SOCKET &&
+           GetSocketErrorCode() == EINTR_CODE);
+  if (socket_ == INVALID_SOCKET) {
+    LOG(ERROR) << "Could not accept ingest connection, error = "
+               << GetSocketErrorCode();
+    return false;
+  }
+  connection_accepted_ = true;
+
+  // Receive until the end of the request header. Whatever body bytes arrive
+  // with it are kept in |remainder_| and served by the first reads.
+  std::string header;
+  size_t header_end = std::string::npos;
+  while (header_end == std::string::npos) {
+    if (header.size() >= kMaxRequestHeaderSize) {
+      LOG(ERROR) << "Ingest request header exceeds " << kMaxRequestHeaderSize
+                 << " bytes.";
+      SendResponse(socket_, kBadRequestResponse);
+      return false;
+    }
+    char buffer[4096];
+    const int64_t bytes_received = RecvInternal(socket_, buffer,
+                                                sizeof(buffer));
+    if (bytes_received <= 0) {
+      LOG(ERROR) << "Ingest connection closed before the request header "
+                    "completed.";
+      return false;
+    }
+    const size_t scan_from = header.size() < 3 ? 0 : header.size() - 3;
+    header.append(buffer, bytes_received);
+    header_end = header.find("\r\n\r\n", scan_from);
+  }
+
+  const uint8_t* body_begin =
+      reinterpret_cast<const uint8_t*>(header.data()) + header_end + 4;
+  remainder_.assign(body_begin,
+                    reinterpret_cast<const uint8_t*>(header.data()) +
+                        header.size());
+  remainder_pos_ = 0;
+  header.resize(header_end + 2);  // Keep the trailing CRLF for header search.
+
+  if (header.compare(0, 5, "POST ") != 0 &&
+      header.compare(0, 4, "PUT ") != 0) {
+    LOG(ERROR) << "Ingest expects a single POST or PUT request, got '"
+               << header.substr(0, header.find("\r\n")) << "'.";
+    SendResponse(socket_, kBadRequestResponse);
+    return false;
+  }
+
+  const std::string lower_header = absl::AsciiStrToLower(header);
+  if (GetHeaderValue(lower_header, "transfer-encoding").find("chunked") !=
+      std::string::npos) {
+    chunked_ = true;
+    remaining_bytes_ = 0;
+  } else {
+    const std::string content_length =
+        GetHeaderValue(lower_header, "content-length");
+    if (content_length.empty()) {
+      // Delimited by connection close.
+      remaining_bytes_ = -1;
+    } else if (!absl::SimpleAtoi(content_length, &remaining_bytes_) ||
+               remaining_bytes_ < 0) {
+      LOG(ERROR) << "Malformed Content-Length '" << content_length
+                 << "' in ingest request.";
+      SendResponse(socket_, kBadRequestResponse);
+      return false;
+    }
+  }
+
+  if (GetHeaderValue(lower_header, "expect").find("100-continue") !=
+      std::string::npos) {
+    SendResponse(socket_, kContinueResponse);
+  }
+  return true;
+}
+
+int64_t IngestHttpFile::ReadRaw(void* buffer, uint64_t length) {
+  if (remainder_pos_ < remainder_.size()) {
+    const uint64_t bytes_to_copy = std::min(
+        length, static_cast<uint64_t>(remainder_.size() - remainder_pos_));
+    memcpy(buffer, remainder_.data() + remainder_pos_, bytes_to_copy);
+    remainder_pos_ += bytes_to_copy;
+    return bytes_to_copy;
+  }
+  return RecvInternal(socket_, buffer, length);
+}
+
+bool IngestHttpFile::ReadLine(std::string* line) {
+  line->clear();
+  // Lines here are chunk sizes and trailers, i.e. a few bytes each; reading
+  // them one byte at a time keeps the chunk payloads themselves going
+  // straight into the caller's buffer.
+  char character;
+  while (true) {
+    const int64_t bytes_received = ReadRaw(&character, 1);
+    if (bytes_received <= 0)
+      return false;
+    if (character == '\n') {
+      if (!line->empty() && line->back() == '\r')
+        line->pop_back();
+      return true;
+    }
+    line->push_back(character);
+  }
+}
+
+int64_t IngestHttpFile::ReadChunked(void* buffer, uint64_t length) {
+  if (remaining_bytes_ == 0) {
+    // At a chunk boundary; read the next chunk header.
+    std::string chunk_header;
+    if (!ReadLine(&chunk_header))
+      return -1;
+    // Ignore chunk extensions.
+    const size_t semicolon_pos = chunk_header.find(';');
+    if (semicolon_pos != std::string::npos)
+      chunk_header.resize(semicolon_pos);
+    int64_t chunk_size = 0;
+    if (!absl::SimpleHexAtoi(chunk_header, &chunk_size) || chunk_size < 0) {
+      LOG(ERROR) << "Malformed chunk size '" << chunk_header
+                 << "' in ingest request.";
+      return -1;
+    }
+    if (chunk_size == 0) {
+      // Last chunk; consume any trailers up to the empty line.
+      std::string trailer;
+      do {
+        if (!ReadLine(&trailer))
+          return -1;
+      } while (!trailer.empty());
+      FinishBody();
+      return 0;
+    }
+    remaining_bytes_ = chunk_size;
+  }
+
+  const int64_t bytes_received = ReadRaw(
+      buffer, std::min(length, static_cast<uint64_t>(remaining_bytes_)));
+  if (bytes_received <= 0) {
+    LOG(ERROR) << "Ingest connection closed in the middle of a chunk.";
+    return -1;
+  }
+  remaining_bytes_ -= bytes_received;
+  if (remaining_bytes_ == 0) {
+    // Consume the CRLF that terminates the chunk payload.
+    std::string empty_line;
+    if (!ReadLine(&empty_line) || !empty_line.empty())
+      return -1;
+  }
+  return bytes_received;
+}
+
+void IngestHttpFile::FinishBody() {
+  body_complete_ = true;
+  SendResponse(socket_, kOkResponse);
+}
+
+bool IngestHttpFile::Close() {
+  if (socket_ != INVALID_SOCKET) {
+    close(socket_);
+    socket_ = INVALID_SOCKET;
+  }
+  if (listen_socket_ != INVALID_SOCKET) {
+    close(listen_socket_);
+    listen_socket_ = INVALID_SOCKET;
+  }
+  delete this;
+#if defined(OS_WIN)
+  if (wsa_started_)
+    WSACleanup();
+#endif
+  return true;
+}
+
+int64_t IngestHttpFile::Read(void* buffer, uint64_t length) {
+  DCHECK(buffer);
+
+  if (listen_socket_ == INVALID_SOCKET)
+    return -1;
+  if (!connection_accepted_ && !AcceptAndReadRequestHeader())
+    return -1;
+  if (body_complete_)
+    return 0;
+
+  if (chunked_)
+    return ReadChunked(buffer, length);
+
+  uint64_t bytes_to_read = length;
+  if (remaining_bytes_ >= 0) {
+    bytes_to_read =
+        std::min(length, static_cast<uint64_t>(remaining_bytes_));
+  }
+  const int64_t bytes_received = ReadRaw(buffer, bytes_to_read);
+  if (bytes_received < 0)
+    return -1;
+  if (bytes_received == 0) {
+    if (remaining_bytes_ > 0) {
+      LOG(ERROR) << "Ingest connection closed with " << remaining_bytes_
+                 << " body bytes outstanding.";
+      return -1;
+    }
+    // Delimited by connection close; nothing to acknowledge.
+    body_complete_ = true;
+    return 0;
+  }
+  if (remaining_bytes_ > 0) {
+    remaining_bytes_ -= bytes_received;
+    if (remaining_bytes_ == 0)
+      FinishBody();
+  }
+  return bytes_received;
+}
+
+int64_t IngestHttpFile::Write(const void* buffer, uint64_t length) {
+  UNUSED(buffer);
+  UNUSED(length);
+  NOTIMPLEMENTED() << "IngestHttpFile is unwritable!";
+  return -1;
+}
+
+void IngestHttpFile::CloseForWriting() {
+#if defined(OS_WIN)
+  shutdown(socket_, SD_SEND);
+#else
+  shutdown(socket_, SHUT_WR);
+#endif
+}
+
+int64_t IngestHttpFile::Size() {
+  if (listen_socket_ == INVALID_SOCKET)
+    return -1;
+
+  return std::numeric_limits<int64_t>::max();
+}
+
+bool IngestHttpFile::Flush() {
+  NOTIMPLEMENTED() << "IngestHttpFile is unflushable!";
+  return false;
+}
+
+bool IngestHttpFile::Seek(uint64_t position) {
+  UNUSED(position);
+  NOTIMPLEMENTED() << "IngestHttpFile is unseekable!";
+  return false;
+}
+
+bool IngestHttpFile::Tell(uint64_t* position) {
+  UNUSED(position);
+  NOTIMPLEMENTED() << "IngestHttpFile is unseekable!";
+  return false;
+}
+
+}  // namespace shaka
@@ -0,0 +1,93 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_FILE_INGEST_HTTP_FILE_H_
+#define PACKAGER_FILE_INGEST_HTTP_FILE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(OS_WIN)
+#include <windows.h>
+#include <winsock2.h>
+#else
+typedef int SOCKET;
+#endif  // defined(OS_WIN)
+
+#include <packager/file.h>
+#include <packager/macros/classes.h>
+
+namespace shaka {
+
+/// Implements IngestHttpFile, a listening push-ingest source. Opening
+/// "ingest-http://<address>:<port>" binds a TCP socket and serves the body of
+/// a single POST or PUT request (e.g. a CMAF or TS push from an encoder)
+/// through Read(). The connection is accepted lazily on the first Read.
+/// Bodies may use chunked transfer encoding, a Content-Length, or be
+/// delimited by connection close; body bytes are received directly into the
+/// caller's buffer without an intermediate copy. Only read (receive) mode is
+/// supported.
+class IngestHttpFile : public File {
+ public:
+  /// @param address_and_port C string of the form "<address>:<port>". An
+  ///        empty address or "0.0.0.0" listens on all interfaces.
+  explicit IngestHttpFile(const char* address_and_port);
+
+  /// @name File implementation overrides.
+  /// @{
+  bool Close() override;
+  int64_t Read(void* buffer, uint64_t length) override;
+  int64_t Write(const void* buffer, uint64_t length) override;
+  void CloseForWriting() override;
+  int64_t Size() override;
+  bool Flush() override;
+  bool Seek(uint64_t position) override;
+  bool Tell(uint64_t* position) override;
+  /// @}
+
+ protected:
+  ~IngestHttpFile() override;
+
+  bool Open() override;
+
+ private:
+  // Accept the pushing connection and parse the request header. Body bytes
+  // received together with the header are kept in |remainder_|.
+  bool AcceptAndReadRequestHeader();
+  // Receive up to |length| body bytes, draining |remainder_| before reading
+  // straight from the socket into |buffer|.
+  int64_t ReadRaw(void* buffer, uint64_t length);
+  // Read a CRLF terminated line; used for chunk sizes and trailers.
+  bool ReadLine(std::string* line);
+  // Read the body of a chunked request.
+  int64_t ReadChunked(void* buffer, uint64_t length);
+  // Mark the body complete and acknowledge the request.
+  void FinishBody();
+
+  SOCKET listen_socket_;
+  SOCKET socket_;
+  bool connection_accepted_ = false;
+  bool body_complete_ = false;
+  bool chunked_ = false;
+  // For identity bodies: remaining body bytes, or -1 when the body is
+  // delimited by connection close. For chunked bodies: remaining bytes of the
+  // current chunk, with 0 meaning the next chunk header must be read.
+  int64_t remaining_bytes_ = -1;
+  // Body bytes that arrived with the request header, drained first.
+  std::vector<uint8_t> remainder_;
+  size_t remainder_pos_ = 0;
+#if defined(OS_WIN)
+  // For Winsock in Windows.
+  bool wsa_started_ = false;
+#endif  // defined(OS_WIN)
+
+  DISALLOW_COPY_AND_ASSIGN(IngestHttpFile);
+};
+
+}  // namespace shaka
+
+#endif  // PACKAGER_FILE_INGEST_HTTP_FILE_H_
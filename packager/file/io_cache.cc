@@ -7,53 +7,68 @@
 #include <packager/file/io_cache.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 
 #include <absl/log/check.h>
 #include <absl/log/log.h>
 
+#include <packager/file/io_cancellation.h>
 #include <packager/macros/logging.h>
+#include <packager/utils/stall_monitor.h>
 
 namespace shaka {
 
 IoCache::IoCache(uint64_t cache_size)
     : cache_size_(cache_size),
-      // Make the buffer one byte larger than the cache so that when the
-      // condition r_ptr == w_ptr is unambiguous (buffer empty).
-      circular_buffer_(cache_size + 1),
-      end_ptr_(&circular_buffer_[0] + cache_size + 1),
-      r_ptr_(circular_buffer_.data()),
-      w_ptr_(circular_buffer_.data()),
-      closed_(false) {}
+      circular_buffer_(cache_size),
+      write_pos_(0),
+      read_pos_(0),
+      closed_(false),
+      reader_parked_(false),
+      writer_parked_(false) {
+  // Makes this cache reachable from IoCancellation::Request(), the global
+  // teardown kick that unblocks parked readers and writers.
+  IoCancellation::Register(this);
+}
 
 IoCache::~IoCache() {
+  IoCancellation::Unregister(this);
   Close();
 }
 
 uint64_t IoCache::Read(void* buffer, uint64_t size) {
   DCHECK(buffer);
 
-  absl::MutexLock lock(&mutex_);
-  while (!closed_ && (BytesCachedInternal() == 0)) {
-    write_event_.Wait(&mutex_);
+  uint64_t read_pos = read_pos_.load(std::memory_order_relaxed);
+  uint64_t cached;
+  for (;;) {
+    cached = write_pos_.load(std::memory_order_acquire) - read_pos;
+    if (cached != 0 || closed_.load(std::memory_order_acquire))
+      break;
+
+    // Park until the writer produces data. The seq_cst flag store and
+    // counter re-check pair with the seq_cst fence in WakeReader(): a
+    // concurrent writer either makes its data visible to the re-check or
+    // sees the flag and signals.
+    absl::MutexLock lock(&mutex_);
+    reader_parked_.store(true, std::memory_order_seq_cst);
+    cached = write_pos_.load(std::memory_order_seq_cst) - read_pos;
+    if (cached != 0 || closed_.load(std::memory_order_seq_cst)) {
+      reader_parked_.store(false, std::memory_order_relaxed);
+      break;
+    }
+    {
+      StallMonitor::ScopedWait stall_wait("io_cache.read_empty", stall_name_);
+      write_event_.Wait(&mutex_);
+    }
+    reader_parked_.store(false, std::memory_order_relaxed);
   }
 
-  size = std::min(size, BytesCachedInternal());
-  uint64_t first_chunk_size(
-      std::min(size, static_cast<uint64_t>(end_ptr_ - r_ptr_)));
-  memcpy(buffer, r_ptr_, first_chunk_size);
-  r_ptr_ += first_chunk_size;
-  DCHECK_GE(end_ptr_, r_ptr_);
-  if (r_ptr_ == end_ptr_)
-    r_ptr_ = &circular_buffer_[0];
-  uint64_t second_chunk_size(size - first_chunk_size);
-  if (second_chunk_size) {
-    memcpy(static_cast<uint8_t*>(buffer) + first_chunk_size, r_ptr_,
-           second_chunk_size);
-    r_ptr_ += second_chunk_size;
-    DCHECK_GT(end_ptr_, r_ptr_);
-  }
-  read_event_.Signal();
+  size = std::min(size, cached);
+  CopyOut(read_pos, buffer, size);
+  read_pos_.store(read_pos + size, std::memory_order_release);
+  WakeWriter();
   return size;
 }
 
@@ -63,83 +78,142 @@ uint64_t IoCache::Write(const void* buffer, uint64_t size) {
   const uint8_t* r_ptr(static_cast<const uint8_t*>(buffer));
   uint64_t bytes_left(size);
   while (bytes_left) {
-    absl::MutexLock lock(&mutex_);
-    while (!closed_ && (BytesFreeInternal() == 0)) {
+    uint64_t write_pos = write_pos_.load(std::memory_order_relaxed);
+    uint64_t free_bytes;
+    for (;;) {
+      free_bytes =
+          cache_size_ - (write_pos - read_pos_.load(std::memory_order_acquire));
+      if (free_bytes != 0 || closed_.load(std::memory_order_acquire))
+        break;
+
       VLOG(1) << "Circular buffer is full, which can happen if data arrives "
                  "faster than being consumed by packager. Ignore if it is not "
                  "live packaging. Otherwise, try increasing --io_cache_size.";
-      read_event_.Wait(&mutex_);
+
+      // Park until the reader frees space; see Read() for the protocol.
+      absl::MutexLock lock(&mutex_);
+      writer_parked_.store(true, std::memory_order_seq_cst);
+      free_bytes =
+          cache_size_ -
+          (write_pos - read_pos_.load(std::memory_order_seq_cst));
+      if (free_bytes != 0 || closed_.load(std::memory_order_seq_cst)) {
+        writer_parked_.store(false, std::memory_order_relaxed);
+        break;
+      }
+      {
+        StallMonitor::ScopedWait stall_wait("io_cache.write_full",
+                                            stall_name_);
+        read_event_.Wait(&mutex_);
+      }
+      writer_parked_.store(false, std::memory_order_relaxed);
     }
-    if (closed_)
+    if (closed_.load(std::memory_order_acquire))
       return 0;
 
-    uint64_t write_size(std::min(bytes_left, BytesFreeInternal()));
-    uint64_t first_chunk_size(
-        std::min(write_size, static_cast<uint64_t>(end_ptr_ - w_ptr_)));
-    memcpy(w_ptr_, r_ptr, first_chunk_size);
-    w_ptr_ += first_chunk_size;
-    DCHECK_GE(end_ptr_, w_ptr_);
-    if (w_ptr_ == end_ptr_)
-      w_ptr_ = &circular_buffer_[0];
-    r_ptr += first_chunk_size;
-    uint64_t second_chunk_size(write_size - first_chunk_size);
-    if (second_chunk_size) {
-      memcpy(w_ptr_, r_ptr, second_chunk_size);
-      w_ptr_ += second_chunk_size;
-      DCHECK_GT(end_ptr_, w_ptr_);
-      r_ptr += second_chunk_size;
-    }
+    uint64_t write_size(std::min(bytes_left, free_bytes));
+    CopyIn(write_pos, r_ptr, write_size);
+    write_pos_.store(write_pos + write_size, std::memory_order_release);
+    r_ptr += write_size;
     bytes_left -= write_size;
-    write_event_.Signal();
+    WakeReader();
   }
   return size;
 }
 
 void IoCache::Clear() {
-  absl::MutexLock lock(&mutex_);
-  r_ptr_ = w_ptr_ = circular_buffer_.data();
+  read_pos_.store(write_pos_.load(std::memory_order_acquire),
+                  std::memory_order_release);
   // Let any writers know that there is room in the cache.
-  read_event_.Signal();
+  WakeWriter();
 }
 
 void IoCache::Close() {
+  closed_.store(true, std::memory_order_seq_cst);
   absl::MutexLock lock(&mutex_);
-  closed_ = true;
-  read_event_.Signal();
-  write_event_.Signal();
+  read_event_.SignalAll();
+  write_event_.SignalAll();
 }
 
 void IoCache::Reopen() {
-  absl::MutexLock lock(&mutex_);
-  CHECK(closed_);
-  r_ptr_ = w_ptr_ = circular_buffer_.data();
-  closed_ = false;
+  CHECK(closed());
+  read_pos_.store(0, std::memory_order_relaxed);
+  write_pos_.store(0, std::memory_order_relaxed);
+  closed_.store(false, std::memory_order_release);
 }
 
 uint64_t IoCache::BytesCached() {
-  absl::MutexLock lock(&mutex_);
-  return BytesCachedInternal();
+  return write_pos_.load(std::memory_order_acquire) -
+         read_pos_.load(std::memory_order_acquire);
 }
 
 uint64_t IoCache::BytesFree() {
-  absl::MutexLock lock(&mutex_);
-  return BytesFreeInternal();
+  return cache_size_ - BytesCached();
 }
 
-uint64_t IoCache::BytesCachedInternal() {
-  return (r_ptr_ <= w_ptr_)
-             ? w_ptr_ - r_ptr_
-             : (end_ptr_ - r_ptr_) + (w_ptr_ - circular_buffer_.data());
+void IoCache::WaitUntilEmptyOrClosed() {
+  for (;;) {
+    if (BytesCached() == 0 || closed_.load(std::memory_order_acquire))
+      return;
+
+    // Drain waiters park alongside the writer; the reader wakes both.
+    absl::MutexLock lock(&mutex_);
+    writer_parked_.store(true, std::memory_order_seq_cst);
+    if ((write_pos_.load(std::memory_order_seq_cst) -
+         read_pos_.load(std::memory_order_seq_cst)) == 0 ||
+        closed_.load(std::memory_order_seq_cst)) {
+      writer_parked_.store(false, std::memory_order_relaxed);
+      return;
+    }
+    {
+      StallMonitor::ScopedWait stall_wait("io_cache.drain", stall_name_);
+      read_event_.Wait(&mutex_);
+    }
+    writer_parked_.store(false, std::memory_order_relaxed);
+  }
 }
 
-uint64_t IoCache::BytesFreeInternal() {
-  return cache_size_ - BytesCachedInternal();
+void IoCache::CopyOut(uint64_t pos, void* buffer, uint64_t size) const {
+  const uint64_t offset = pos % cache_size_;
+  const uint64_t first_chunk_size = std::min(size, cache_size_ - offset);
+  memcpy(buffer, circular_buffer_.data() + offset, first_chunk_size);
+  if (size > first_chunk_size) {
+    memcpy(static_cast<uint8_t*>(buffer) + first_chunk_size,
+           circular_buffer_.data(), size - first_chunk_size);
+  }
 }
 
-void IoCache::WaitUntilEmptyOrClosed() {
-  absl::MutexLock lock(&mutex_);
-  while (!closed_ && BytesCachedInternal()) {
-    read_event_.Wait(&mutex_);
+void IoCache::CopyIn(uint64_t pos, const void* buffer, uint64_t size) {
+  const uint64_t offset = pos % cache_size_;
+  const uint64_t first_chunk_size = std::min(size, cache_size_ - offset);
+  memcpy(circular_buffer_.data() + offset, buffer, first_chunk_size);
+  if (size > first_chunk_size) {
+    memcpy(circular_buffer_.data(),
+           static_cast<const uint8_t*>(buffer) + first_chunk_size,
+           size - first_chunk_size);
+  }
+}
+
+void IoCache::WakeReader() {
+  // Full fence: the preceding write_pos_ store is only a release store, so
+  // without it the store could stay in the store buffer past the flag load
+  // below (store-buffering reordering) while the parking reader's re-check
+  // still reads the old counter -- both sides would then sleep with no signal
+  // pending. The fence pairs with the reader's seq_cst flag store/counter
+  // re-check: either that re-check sees the new counter, or this load sees
+  // the flag and signals.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (reader_parked_.load(std::memory_order_seq_cst)) {
+    absl::MutexLock lock(&mutex_);
+    write_event_.SignalAll();
+  }
+}
+
+void IoCache::WakeWriter() {
+  // Full fence before the flag load; see WakeReader() for the rationale.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (writer_parked_.load(std::memory_order_seq_cst)) {
+    absl::MutexLock lock(&mutex_);
+    read_event_.SignalAll();
   }
 }
 
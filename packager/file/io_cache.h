@@ -7,7 +7,9 @@
 #ifndef PACKAGER_FILE_IO_CACHE_H_
 #define PACKAGER_FILE_IO_CACHE_H_
 
+#include <atomic>
 #include <cstdint>
+#include <string>
 #include <vector>
 
 #include <absl/synchronization/mutex.h>
@@ -17,6 +19,12 @@
 namespace shaka {
 
 /// Declaration of class which implements a thread-safe circular buffer.
+/// The internals are a lock-free single-producer/single-consumer ring:
+/// uncontended reads and writes only touch acquire/release atomics, and the
+/// mutex/condvar pair is used solely to park a thread when the ring is full
+/// (writer) or empty (reader). Only one reader thread and one writer thread
+/// may use the cache concurrently, which matches all in-tree users (e.g.
+/// ThreadedIoFile).
 class IoCache {
  public:
   explicit IoCache(uint64_t cache_size);
@@ -47,7 +55,7 @@ class IoCache {
   void Close();
 
   /// @return true if the cache is closed, false otherwise.
-  bool closed() { return closed_; }
+  bool closed() { return closed_.load(std::memory_order_acquire); }
 
   /// Reopens the cache. Any data still in the cache will be lost.
   void Reopen();
@@ -63,19 +71,50 @@ class IoCache {
   /// Waits until the cache is empty or has been closed.
   void WaitUntilEmptyOrClosed();
 
+  /// Set the name this cache's blocking waits are attributed to in the
+  /// StallMonitor histograms, typically the file name or URL the cache
+  /// buffers for. Unnamed caches are recorded under an empty name.
+  void set_stall_name(const std::string& stall_name) {
+    stall_name_ = stall_name;
+  }
+
  private:
-  uint64_t BytesCachedInternal();
-  uint64_t BytesFreeInternal();
+  // Copy |size| bytes out of the ring starting at absolute position |pos|,
+  // wrapping around the end of the buffer if necessary.
+  void CopyOut(uint64_t pos, void* buffer, uint64_t size) const;
+  // Copy |size| bytes into the ring starting at absolute position |pos|,
+  // wrapping around the end of the buffer if necessary.
+  void CopyIn(uint64_t pos, const void* buffer, uint64_t size);
+
+  // Wake the reader if it is parked waiting for data.
+  void WakeReader();
+  // Wake the writer (and any drain waiter) parked waiting for consumption.
+  void WakeWriter();
 
   const uint64_t cache_size_;
+  std::vector<uint8_t> circular_buffer_;
+
+  // Monotonically increasing byte counters; the ring position is the counter
+  // modulo |cache_size_|. The writer owns |write_pos_| and the reader owns
+  // |read_pos_|; each observes the other's counter with acquire loads. They
+  // live on separate cache lines so the two threads do not false-share.
+  alignas(64) std::atomic<uint64_t> write_pos_;
+  alignas(64) std::atomic<uint64_t> read_pos_;
+
+  std::atomic<bool> closed_;
+
+  // Parking lot for the full/empty edge cases. A thread about to block
+  // advertises itself through the corresponding flag (sequentially consistent
+  // with the position counters, so a wakeup cannot be missed), and the other
+  // side only touches the mutex when a flag is set.
+  std::atomic<bool> reader_parked_;
+  std::atomic<bool> writer_parked_;
   absl::Mutex mutex_;
   absl::CondVar read_event_ ABSL_GUARDED_BY(mutex_);
   absl::CondVar write_event_ ABSL_GUARDED_BY(mutex_);
-  std::vector<uint8_t> circular_buffer_ ABSL_GUARDED_BY(mutex_);
-  const uint8_t* end_ptr_ ABSL_GUARDED_BY(mutex_);
-  uint8_t* r_ptr_ ABSL_GUARDED_BY(mutex_);
-  uint8_t* w_ptr_ ABSL_GUARDED_BY(mutex_);
-  bool closed_ ABSL_GUARDED_BY(mutex_);
+
+  // Tag for StallMonitor histograms; see set_stall_name().
+  std::string stall_name_;
 
   DISALLOW_COPY_AND_ASSIGN(IoCache);
 };
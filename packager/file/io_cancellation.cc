@@ -0,0 +1,73 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/file/io_cancellation.h>
+
+#include <atomic>
+#include <set>
+
+#include <absl/synchronization/mutex.h>
+
+#include <packager/file/io_cache.h>
+
+namespace shaka {
+namespace {
+
+// Checked from hot-ish paths (e.g. the curl progress callback of every
+// transfer), so the flag itself is lock free; the mutex only guards the
+// cache registry.
+std::atomic<bool> g_cancellation_requested(false);
+
+struct CacheRegistry {
+  absl::Mutex mutex;
+  std::set<IoCache*> caches ABSL_GUARDED_BY(mutex);
+};
+
+CacheRegistry* GetRegistry() {
+  // Process-lifetime singleton: IoCaches can be destroyed from static
+  // destructors, so the registry is intentionally never cleaned up.
+  static CacheRegistry* registry = new CacheRegistry;
+  return registry;
+}
+
+}  // namespace
+
+void IoCancellation::Request() {
+  g_cancellation_requested.store(true, std::memory_order_release);
+  CacheRegistry* registry = GetRegistry();
+  absl::MutexLock lock(&registry->mutex);
+  // Close() unblocks parked readers and writers; their Read()/Write() calls
+  // then return short, which callers already handle as end of stream or a
+  // failed write.
+  for (IoCache* cache : registry->caches)
+    cache->Close();
+}
+
+bool IoCancellation::IsRequested() {
+  return g_cancellation_requested.load(std::memory_order_acquire);
+}
+
+void IoCancellation::ResetForTesting() {
+  g_cancellation_requested.store(false, std::memory_order_release);
+}
+
+void IoCancellation::Register(IoCache* cache) {
+  CacheRegistry* registry = GetRegistry();
+  absl::MutexLock lock(&registry->mutex);
+  registry->caches.insert(cache);
+  // A cache created after cancellation (e.g. by a job racing with teardown)
+  // starts closed, so its first blocking call returns immediately.
+  if (IsRequested())
+    cache->Close();
+}
+
+void IoCancellation::Unregister(IoCache* cache) {
+  CacheRegistry* registry = GetRegistry();
+  absl::MutexLock lock(&registry->mutex);
+  registry->caches.erase(cache);
+}
+
+}  // namespace shaka
@@ -0,0 +1,51 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_FILE_IO_CANCELLATION_H_
+#define PACKAGER_FILE_IO_CANCELLATION_H_
+
+namespace shaka {
+
+class IoCache;
+
+/// Process-wide cooperative cancellation of blocking I/O, used for fast job
+/// teardown. Job cancellation is only a request; without a kick, pipeline
+/// threads notice it at their next loop iteration, which can be tens of
+/// seconds away when they are parked in a cache wait or a stalled network
+/// transfer. Request() closes every live IoCache (unblocking parked readers
+/// and writers), makes caches created afterwards start closed, and aborts
+/// in-flight curl transfers at their next progress callback.
+///
+/// Cancellation is a point of no return for the process: it cannot be undone
+/// and no further packaging run will make progress. It is meant for
+/// orchestrators tearing a job down to reclaim the machine, not for pausing
+/// work.
+class IoCancellation {
+ public:
+  /// Request cancellation of all blocking I/O in the process. Thread safe,
+  /// idempotent, and non-blocking apart from waking parked threads.
+  static void Request();
+
+  /// @return true if cancellation has been requested.
+  static bool IsRequested();
+
+  /// Clears the cancellation request. Test only: production cancellation is
+  /// irreversible, and caches closed by Request() stay closed.
+  static void ResetForTesting();
+
+ private:
+  friend class IoCache;
+
+  // Called by IoCache on construction and destruction so Request() can close
+  // every live cache. Registering after cancellation has been requested
+  // closes @a cache immediately.
+  static void Register(IoCache* cache);
+  static void Unregister(IoCache* cache);
+};
+
+}  // namespace shaka
+
+#endif  // PACKAGER_FILE_IO_CANCELLATION_H_
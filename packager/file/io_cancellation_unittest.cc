@@ -0,0 +1,67 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/file/io_cancellation.h>
+
+#include <cstdint>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <packager/file/io_cache.h>
+
+namespace shaka {
+namespace {
+
+const uint64_t kCacheSize = 16;
+
+}  // namespace
+
+class IoCancellationTest : public testing::Test {
+ protected:
+  // Cancellation is sticky in production; undo it so other tests in this
+  // binary can keep using IoCaches.
+  void TearDown() override { IoCancellation::ResetForTesting(); }
+};
+
+TEST_F(IoCancellationTest, NotRequestedByDefault) {
+  EXPECT_FALSE(IoCancellation::IsRequested());
+}
+
+TEST_F(IoCancellationTest, UnblocksParkedReader) {
+  IoCache cache(kCacheSize);
+  std::thread reader([&cache]() {
+    uint8_t buffer[kCacheSize];
+    // Blocks on the empty cache until Request() closes it, then returns 0.
+    EXPECT_EQ(0u, cache.Read(buffer, sizeof(buffer)));
+  });
+
+  IoCancellation::Request();
+  EXPECT_TRUE(IoCancellation::IsRequested());
+  reader.join();
+  EXPECT_TRUE(cache.closed());
+}
+
+TEST_F(IoCancellationTest, UnblocksParkedWriter) {
+  IoCache cache(kCacheSize);
+  uint8_t buffer[kCacheSize] = {};
+  ASSERT_EQ(kCacheSize, cache.Write(buffer, sizeof(buffer)));
+  std::thread writer([&cache, &buffer]() {
+    // Blocks on the full cache until Request() closes it, then returns short.
+    EXPECT_LT(cache.Write(buffer, sizeof(buffer)), sizeof(buffer));
+  });
+
+  IoCancellation::Request();
+  writer.join();
+}
+
+TEST_F(IoCancellationTest, CachesCreatedAfterRequestStartClosed) {
+  IoCancellation::Request();
+  IoCache cache(kCacheSize);
+  EXPECT_TRUE(cache.closed());
+}
+
+}  // namespace shaka
@@ -9,15 +9,22 @@
 #if defined(OS_WIN)
 #include <windows.h>
 #else
+#include <limits.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
 #endif  // defined(OS_WIN)
 
+#include <algorithm>
 #include <cstdio>
 #include <filesystem>
+#include <vector>
 
 #include <absl/log/check.h>
 #include <absl/log/log.h>
 
+#include <packager/macros/compiler.h>
 #include <packager/macros/logging.h>
 
 namespace shaka {
@@ -33,6 +40,13 @@ LocalFile::LocalFile(const char* file_name, const char* mode)
 
 bool LocalFile::Close() {
   bool result = true;
+#if !defined(OS_WIN)
+  if (mapped_base_) {
+    munmap(mapped_base_, mapped_size_);
+    mapped_base_ = nullptr;
+    mapped_size_ = 0;
+  }
+#endif  // !defined(OS_WIN)
   if (internal_file_) {
     result = fclose(internal_file_) == 0;
     internal_file_ = NULL;
@@ -65,6 +79,66 @@ int64_t LocalFile::Write(const void* buffer, uint64_t length) {
   return bytes_written;
 }
 
+int64_t LocalFile::WriteV(const IoVec* iov, int iov_count) {
+#if defined(OS_WIN)
+  // No writev equivalent through the stdio layer; fall back to sequential
+  // writes.
+  return File::WriteV(iov, iov_count);
+#else
+  DCHECK(iov);
+  DCHECK(internal_file_ != NULL);
+
+  // The stdio buffer must be flushed so the direct writev bytes land after
+  // everything written through fwrite.
+  if (!Flush())
+    return -1;
+
+  std::vector<struct iovec> vectors(iov_count);
+  uint64_t total_size = 0;
+  for (int i = 0; i < iov_count; i++) {
+    vectors[i].iov_base = const_cast<void*>(iov[i].data);
+    vectors[i].iov_len = iov[i].length;
+    total_size += iov[i].length;
+  }
+
+  const int fd = fileno(internal_file_);
+  int64_t total_bytes_written = 0;
+  size_t vector_index = 0;
+  while (total_bytes_written < static_cast<int64_t>(total_size)) {
+    const int batch_count = static_cast<int>(
+        std::min<size_t>(vectors.size() - vector_index, IOV_MAX));
+    const ssize_t bytes_written =
+        writev(fd, vectors.data() + vector_index, batch_count);
+    if (bytes_written < 0) {
+      VLOG(2) << "WriteV error " << strerror(errno);
+      return total_bytes_written > 0 ? total_bytes_written : -1;
+    }
+    total_bytes_written += bytes_written;
+    // Advance past fully written vectors and trim the partial one.
+    uint64_t remaining = bytes_written;
+    while (remaining > 0 && vector_index < vectors.size()) {
+      if (remaining >= vectors[vector_index].iov_len) {
+        remaining -= vectors[vector_index].iov_len;
+        vector_index++;
+      } else {
+        vectors[vector_index].iov_base =
+            static_cast<uint8_t*>(vectors[vector_index].iov_base) + remaining;
+        vectors[vector_index].iov_len -= remaining;
+        remaining = 0;
+      }
+    }
+  }
+
+  // Keep the stdio position in sync with the kernel-level writes.
+  const off_t file_position = lseek(fd, 0, SEEK_CUR);
+  if (file_position < 0 ||
+      fseeko(internal_file_, file_position, SEEK_SET) < 0) {
+    return -1;
+  }
+  return total_bytes_written;
+#endif  // defined(OS_WIN)
+}
+
 void LocalFile::CloseForWriting() {}
 
 int64_t LocalFile::Size() {
@@ -112,6 +186,40 @@ bool LocalFile::Tell(uint64_t* position) {
   return true;
 }
 
+const uint8_t* LocalFile::MapReadRegion(uint64_t offset, uint64_t length) {
+#if defined(OS_WIN)
+  UNUSED(offset);
+  UNUSED(length);
+  return NULL;
+#else
+  DCHECK(internal_file_ != NULL);
+
+  // Mapping is only offered for read-only files; a file being written
+  // through the stdio buffer would not be coherent with the mapping.
+  if (file_mode_.find_first_of("wa+") != std::string::npos)
+    return NULL;
+
+  if (!mapped_base_) {
+    // Map the whole file once and serve all regions out of that mapping.
+    struct stat file_stat;
+    if (fstat(fileno(internal_file_), &file_stat) != 0)
+      return NULL;
+    if (file_stat.st_size <= 0)
+      return NULL;
+    void* base = mmap(NULL, file_stat.st_size, PROT_READ, MAP_SHARED,
+                      fileno(internal_file_), 0);
+    if (base == MAP_FAILED)
+      return NULL;
+    mapped_base_ = base;
+    mapped_size_ = file_stat.st_size;
+  }
+
+  if (offset > mapped_size_ || length > mapped_size_ - offset)
+    return NULL;
+  return static_cast<const uint8_t*>(mapped_base_) + offset;
+#endif  // defined(OS_WIN)
+}
+
 LocalFile::~LocalFile() {}
 
 bool LocalFile::Open() {
@@ -28,11 +28,13 @@ class LocalFile : public File {
   bool Close() override;
   int64_t Read(void* buffer, uint64_t length) override;
   int64_t Write(const void* buffer, uint64_t length) override;
+  int64_t WriteV(const IoVec* iov, int iov_count) override;
   void CloseForWriting() override;
   int64_t Size() override;
   bool Flush() override;
   bool Seek(uint64_t position) override;
   bool Tell(uint64_t* position) override;
+  const uint8_t* MapReadRegion(uint64_t offset, uint64_t length) override;
   /// @}
 
   /// Delete a local file.
@@ -48,6 +50,9 @@ class LocalFile : public File {
  private:
   std::string file_mode_;
   FILE* internal_file_;
+  // Lazily created read-only mapping of the whole file; see MapReadRegion.
+  void* mapped_base_ = nullptr;
+  uint64_t mapped_size_ = 0;
 
   DISALLOW_COPY_AND_ASSIGN(LocalFile);
 };
@@ -10,7 +10,11 @@
 #include <cstring>  // for memcpy
 #include <map>
 #include <memory>
-#include <set>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif  // defined(__linux__)
 
 #include <absl/log/check.h>
 #include <absl/log/log.h>
@@ -21,7 +25,63 @@
 namespace shaka {
 namespace {
 
-// A helper filesystem object.  This holds the data for the memory files.
+// Transparent huge pages on x86-64 and arm64 are 2MB.
+const size_t kHugePageSize = 2 * 1024 * 1024;
+
+}  // namespace
+
+// Backing store for a single memory file. MemoryFile instances hold a
+// shared_ptr handle acquired at open time, so reads and writes never touch
+// the global file-system lock, and the data stays alive after the name is
+// deleted for as long as a handle remains.
+class MemoryFileData {
+ public:
+  MemoryFileData() = default;
+
+  const uint8_t* data() const { return buffer_.data(); }
+  uint8_t* data() { return buffer_.data(); }
+  size_t size() const { return buffer_.size(); }
+
+  void Resize(size_t new_size) {
+    if (new_size > buffer_.capacity())
+      Reserve(std::max(new_size, buffer_.capacity() * 2));
+    buffer_.resize(new_size);
+  }
+
+ private:
+  MemoryFileData(const MemoryFileData&) = delete;
+  MemoryFileData& operator=(const MemoryFileData&) = delete;
+
+  void Reserve(size_t new_capacity) {
+    // Large buffers grow in 2MB steps so the allocation can be backed by
+    // transparent huge pages and reallocations stay rare.
+    if (new_capacity >= kHugePageSize) {
+      new_capacity = (new_capacity + kHugePageSize - 1) & ~(kHugePageSize - 1);
+    }
+    buffer_.reserve(new_capacity);
+#if defined(__linux__)
+    // madvise() wants page-aligned addresses, so advise the largest
+    // huge-page-aligned range inside the allocation. This is only a hint;
+    // failure is harmless.
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(buffer_.data());
+    const uintptr_t aligned_begin =
+        (begin + kHugePageSize - 1) & ~(kHugePageSize - 1);
+    const uintptr_t end = begin + buffer_.capacity();
+    if (end >= aligned_begin + kHugePageSize) {
+      madvise(reinterpret_cast<void*>(aligned_begin),
+              (end - aligned_begin) & ~(kHugePageSize - 1), MADV_HUGEPAGE);
+    }
+#endif  // defined(__linux__)
+  }
+
+  std::vector<uint8_t> buffer_;
+};
+
+namespace {
+
+// A helper filesystem object.  This maps file names to their backing stores.
+// The lock here is taken only on open/close/delete; I/O on an open file goes
+// through the handle returned by Open() and is lock-free.
 class FileSystem {
  public:
   ~FileSystem() {}
@@ -33,29 +93,18 @@ class FileSystem {
 
   void Delete(const std::string& file_name) {
     absl::MutexLock auto_lock(&mutex_);
-
-    if (open_files_.find(file_name) != open_files_.end()) {
-      LOG(ERROR) << "File '" << file_name
-                 << "' is still open. Deleting an open MemoryFile is not "
-                    "allowed. Exit without deleting the file.";
-      return;
-    }
-
+    // Any open handle keeps the underlying data alive; only the name to data
+    // mapping is removed here.
     files_.erase(file_name);
   }
 
   void DeleteAll() {
     absl::MutexLock auto_lock(&mutex_);
-    if (!open_files_.empty()) {
-      LOG(ERROR) << "There are still files open. Deleting an open MemoryFile "
-                    "is not allowed. Exit without deleting the file.";
-      return;
-    }
     files_.clear();
   }
 
-  std::vector<uint8_t>* Open(const std::string& file_name,
-                             const std::string& mode) {
+  std::shared_ptr<MemoryFileData> Open(const std::string& file_name,
+                                       const std::string& mode) {
     absl::MutexLock auto_lock(&mutex_);
 
     if (open_files_.find(file_name) != open_files_.end()) {
@@ -65,13 +114,17 @@ class FileSystem {
       return nullptr;
     }
 
-    auto iter = files_.find(file_name);
+    std::shared_ptr<MemoryFileData> data;
     if (mode == "r") {
+      auto iter = files_.find(file_name);
       if (iter == files_.end())
         return nullptr;
+      data = iter->second;
     } else if (mode == "w") {
-      if (iter != files_.end())
-        iter->second.clear();
+      // Opening for write replaces any previous contents with a fresh
+      // backing store.
+      data = std::make_shared<MemoryFileData>();
+      files_[file_name] = data;
     } else {
       NOTIMPLEMENTED() << "File mode '" << mode
                        << "' not supported by MemoryFile";
@@ -79,7 +132,7 @@ class FileSystem {
     }
 
     open_files_[file_name] = mode;
-    return &files_[file_name];
+    return data;
   }
 
   bool Close(const std::string& file_name) {
@@ -103,7 +156,8 @@ class FileSystem {
   FileSystem() = default;
 
   // Filename to file data map.
-  std::map<std::string, std::vector<uint8_t>> files_ ABSL_GUARDED_BY(mutex_);
+  std::map<std::string, std::shared_ptr<MemoryFileData>> files_
+      ABSL_GUARDED_BY(mutex_);
   // Filename to file open modes map.
   std::map<std::string, std::string> open_files_ ABSL_GUARDED_BY(mutex_);
 
@@ -113,7 +167,7 @@ class FileSystem {
 }  // namespace
 
 MemoryFile::MemoryFile(const std::string& file_name, const std::string& mode)
-    : File(file_name), mode_(mode), file_(NULL), position_(0) {}
+    : File(file_name), mode_(mode), position_(0) {}
 
 MemoryFile::~MemoryFile() {}
 
@@ -131,7 +185,7 @@ int64_t MemoryFile::Read(void* buffer, uint64_t length) {
     return 0;
 
   const uint64_t bytes_to_read = std::min(length, size - position_);
-  memcpy(buffer, &(*file_)[position_], bytes_to_read);
+  memcpy(buffer, file_->data() + position_, bytes_to_read);
   position_ += bytes_to_read;
   return bytes_to_read;
 }
@@ -146,10 +200,10 @@ int64_t MemoryFile::Write(const void* buffer, uint64_t length) {
 
   const uint64_t size = Size();
   if (size < position_ + length) {
-    file_->resize(position_ + length);
+    file_->Resize(position_ + length);
   }
 
-  memcpy(&(*file_)[position_], buffer, length);
+  memcpy(file_->data() + position_, buffer, length);
   position_ += length;
   return length;
 }
@@ -8,16 +8,19 @@
 #define MEDIA_FILE_MEDIA_FILE_H_
 
 #include <cstdint>
+#include <memory>
 #include <string>
-#include <vector>
 
 #include <packager/file.h>
 #include <packager/macros/classes.h>
 
 namespace shaka {
 
-/// Implements a File that is stored in memory.  This should be only used for
-/// testing, since this does not support larger files.
+class MemoryFileData;
+
+/// Implements a File that is stored in memory. Used for tests and for small
+/// intermediate artifacts (e.g. init segments) produced and consumed within
+/// the same process.
 class MemoryFile : public File {
  public:
   MemoryFile(const std::string& file_name, const std::string& mode);
@@ -34,12 +37,11 @@ class MemoryFile : public File {
   bool Tell(uint64_t* position) override;
   /// @}
 
-  /// Deletes all memory file data created.  This assumes that there are no
-  /// MemoryFile objects alive.  Any alive objects will be in an undefined
-  /// state.
+  /// Deletes all memory file data created.  Open files keep a handle to their
+  /// data and remain usable; only the name to data mapping is removed.
   static void DeleteAll();
-  /// Deletes the memory file data with the given file_name.  Any objects open
-  /// with that file name will be in an undefined state.
+  /// Deletes the memory file data with the given file_name.  An object open
+  /// with that file name keeps a handle to the data and remains usable.
   static void Delete(const std::string& file_name);
 
  protected:
@@ -48,7 +50,10 @@ class MemoryFile : public File {
 
  private:
   std::string mode_;
-  std::vector<uint8_t>* file_;
+  // Handle to the backing store, acquired at open time. Reads and writes go
+  // through the handle without taking the file-system lock, so concurrent
+  // pipelines on different memory:// files do not serialize on each other.
+  std::shared_ptr<MemoryFileData> file_;
   uint64_t position_;
 
   DISALLOW_COPY_AND_ASSIGN(MemoryFile);
@@ -101,6 +101,25 @@ TEST_F(MemoryFileTest, ReadMissingFileFails) {
   EXPECT_FALSE(file);
 }
 
+TEST_F(MemoryFileTest, DeleteWhileOpenKeepsHandleUsable) {
+  std::unique_ptr<File, FileCloser> file(File::Open("memory://file1", "w"));
+  ASSERT_TRUE(file);
+  ASSERT_EQ(kWriteBufferSize, file->Write(kWriteBuffer, kWriteBufferSize));
+
+  // The open handle keeps the data alive; only the name goes away.
+  MemoryFile::Delete("memory://file1");
+
+  ASSERT_TRUE(file->Seek(0));
+  uint8_t read_buffer[kWriteBufferSize];
+  ASSERT_EQ(kWriteBufferSize, file->Read(read_buffer, kWriteBufferSize));
+  EXPECT_EQ(0, memcmp(kWriteBuffer, read_buffer, kWriteBufferSize));
+  file.release()->Close();
+
+  // The name no longer resolves once the file is deleted.
+  std::unique_ptr<File, FileCloser> reader(File::Open("memory://file1", "r"));
+  EXPECT_FALSE(reader);
+}
+
 TEST_F(MemoryFileTest, WriteExistingFileDeletes) {
   std::unique_ptr<File, FileCloser> file1(File::Open("memory://file1", "w"));
   ASSERT_TRUE(file1);
@@ -0,0 +1,181 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/file/replay_file.h>
+
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <absl/log/log.h>
+#include <absl/strings/numbers.h>
+
+#include <packager/file/capture_file_format.h>
+#include <packager/kv_pairs/kv_pairs.h>
+#include <packager/macros/compiler.h>
+#include <packager/macros/logging.h>
+
+namespace shaka {
+
+namespace {
+
+const int kMaxReplaySpeed = 100;
+
+// Reads exactly |length| bytes, looping over short reads. Returns true on
+// success, false on error or premature end of file.
+bool ReadFully(File* file, uint8_t* buffer, uint64_t length) {
+  uint64_t total = 0;
+  while (total < length) {
+    const int64_t bytes_read = file->Read(buffer + total, length - total);
+    if (bytes_read <= 0)
+      return false;
+    total += bytes_read;
+  }
+  return true;
+}
+
+}  // namespace
+
+ReplayFile::ReplayFile(const char* url_with_options)
+    : File(url_with_options) {}
+
+ReplayFile::~ReplayFile() {}
+
+bool ReplayFile::Open() {
+  std::string path(file_name());
+  const size_t question_mark_pos = path.find('?');
+  if (question_mark_pos != std::string::npos) {
+    const std::vector<KVPair> kv_pairs =
+        SplitStringIntoKeyValuePairs(path.substr(question_mark_pos + 1));
+    path.resize(question_mark_pos);
+    for (const auto& pair : kv_pairs) {
+      if (pair.first == "speed") {
+        if (!absl::SimpleAtoi(pair.second, &speed_) || speed_ < 1 ||
+            speed_ > kMaxReplaySpeed) {
+          LOG(ERROR) << "Invalid replay speed \"" << pair.second
+                     << "\"; expected an integer between 1 and "
+                     << kMaxReplaySpeed << ".";
+          return false;
+        }
+      } else {
+        LOG(ERROR) << "Unknown field in replay options (\"" << pair.first
+                   << "\").";
+        return false;
+      }
+    }
+  }
+
+  source_ = File::Open(path.c_str(), "r");
+  if (!source_) {
+    LOG(ERROR) << "Failed to open capture file " << path;
+    return false;
+  }
+
+  uint8_t magic[kCaptureFileMagicSize];
+  if (!ReadFully(source_, magic, sizeof(magic)) ||
+      memcmp(magic, kCaptureFileMagic, sizeof(magic)) != 0) {
+    LOG(ERROR) << path << " is not a capture file.";
+    source_->Close();
+    source_ = nullptr;
+    return false;
+  }
+  return true;
+}
+
+bool ReplayFile::Close() {
+  if (source_) {
+    source_->Close();
+    source_ = nullptr;
+  }
+  delete this;
+  return true;
+}
+
+int64_t ReplayFile::Read(void* buffer, uint64_t length) {
+  DCHECK(buffer);
+  if (!source_)
+    return -1;
+
+  uint8_t header[kCaptureRecordHeaderSize];
+  const int64_t header_bytes = source_->Read(header, sizeof(header));
+  if (header_bytes == 0)
+    return 0;  // Clean end of the capture.
+  if (header_bytes != static_cast<int64_t>(sizeof(header)) &&
+      (header_bytes < 0 ||
+       !ReadFully(source_, header + header_bytes,
+                  sizeof(header) - header_bytes))) {
+    LOG(ERROR) << "Truncated record header in capture file " << file_name();
+    return -1;
+  }
+
+  uint64_t timestamp_us = 0;
+  uint32_t payload_size = 0;
+  DecodeCaptureRecordHeader(header, &timestamp_us, &payload_size);
+  if (payload_size > length) {
+    LOG(ERROR) << "Captured datagram of " << payload_size
+               << " bytes does not fit the caller's buffer of " << length
+               << " bytes.";
+    return -1;
+  }
+
+  if (!replay_started_) {
+    replay_start_ = std::chrono::steady_clock::now();
+    replay_started_ = true;
+  }
+  // Pace the datagram to its recorded arrival time, compressed by the speed
+  // multiplier. sleep_until with a past deadline returns immediately, so a
+  // slow consumer only falls behind, exactly like a live UDP source.
+  std::this_thread::sleep_until(replay_start_ +
+                                std::chrono::microseconds(timestamp_us) /
+                                    speed_);
+
+  if (!ReadFully(source_, static_cast<uint8_t*>(buffer), payload_size)) {
+    LOG(ERROR) << "Truncated record payload in capture file " << file_name();
+    return -1;
+  }
+  return payload_size;
+}
+
+int64_t ReplayFile::Write(const void* buffer, uint64_t length) {
+  UNUSED(buffer);
+  UNUSED(length);
+  NOTIMPLEMENTED() << "ReplayFile is unwritable!";
+  return -1;
+}
+
+void ReplayFile::CloseForWriting() {}
+
+int64_t ReplayFile::Size() {
+  if (!source_)
+    return -1;
+  return source_->Size();
+}
+
+bool ReplayFile::Flush() {
+  NOTIMPLEMENTED() << "ReplayFile is unflushable!";
+  return false;
+}
+
+bool ReplayFile::Seek(uint64_t position) {
+  UNUSED(position);
+  NOTIMPLEMENTED() << "ReplayFile is unseekable!";
+  return false;
+}
+
+bool ReplayFile::Tell(uint64_t* position) {
+  UNUSED(position);
+  NOTIMPLEMENTED() << "ReplayFile is unseekable!";
+  return false;
+}
+
+uint64_t ReplayFile::OptimalReadSize() {
+  // Captures hold UDP datagrams, so one maximum-size datagram per call, as
+  // with a live UDP source.
+  return 65536;
+}
+
+}  // namespace shaka
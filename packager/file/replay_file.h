@@ -0,0 +1,65 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_FILE_REPLAY_FILE_H_
+#define PACKAGER_FILE_REPLAY_FILE_H_
+
+#include <chrono>
+#include <cstdint>
+
+#include <packager/file.h>
+#include <packager/macros/classes.h>
+
+namespace shaka {
+
+/// Implements ReplayFile, which plays a recorded UDP ingest session (written
+/// through the "capture" UDP option, see UdpOptions) back into the pipeline.
+/// Each Read() returns one captured datagram, paced according to the recorded
+/// arrival timestamps so the pipeline sees production-shaped load. The url
+/// form is:
+///   replay://path/to/capture[?speed=multiplier]
+/// where the path is resolved through File::Open, so e.g. memory:// capture
+/// files work too. "speed" is an integer playback speed multiplier between 1
+/// and 100; it defaults to 1 (real time).
+class ReplayFile : public File {
+ public:
+  /// @param url_with_options C string of the form
+  ///        "path/to/capture[?speed=multiplier]" (the replay:// prefix
+  ///        already stripped).
+  explicit ReplayFile(const char* url_with_options);
+
+  /// @name File implementation overrides.
+  /// @{
+  bool Close() override;
+  int64_t Read(void* buffer, uint64_t length) override;
+  int64_t Write(const void* buffer, uint64_t length) override;
+  void CloseForWriting() override;
+  int64_t Size() override;
+  bool Flush() override;
+  bool Seek(uint64_t position) override;
+  bool Tell(uint64_t* position) override;
+  uint64_t OptimalReadSize() override;
+  /// @}
+
+ protected:
+  ~ReplayFile() override;
+
+  bool Open() override;
+
+ private:
+  // The underlying capture file; owned (closed in Close()).
+  File* source_ = nullptr;
+  int speed_ = 1;
+  // Set on the first Read(); recorded timestamps are paced relative to it.
+  std::chrono::steady_clock::time_point replay_start_;
+  bool replay_started_ = false;
+
+  DISALLOW_COPY_AND_ASSIGN(ReplayFile);
+};
+
+}  // namespace shaka
+
+#endif  // PACKAGER_FILE_REPLAY_FILE_H_
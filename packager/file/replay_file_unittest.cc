@@ -0,0 +1,133 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <packager/file.h>
+#include <packager/file/capture_file_format.h>
+#include <packager/file/memory_file.h>
+
+namespace shaka {
+namespace {
+
+const char kCapturePath[] = "memory://test.cap";
+
+// One datagram of a capture under construction.
+struct CaptureRecord {
+  uint64_t timestamp_us;
+  std::string payload;
+};
+
+void WriteCapture(const std::vector<CaptureRecord>& records) {
+  File* file = File::Open(kCapturePath, "w");
+  ASSERT_TRUE(file);
+  ASSERT_EQ(static_cast<int64_t>(kCaptureFileMagicSize),
+            file->Write(kCaptureFileMagic, kCaptureFileMagicSize));
+  for (const CaptureRecord& record : records) {
+    uint8_t header[kCaptureRecordHeaderSize];
+    EncodeCaptureRecordHeader(record.timestamp_us,
+                              static_cast<uint32_t>(record.payload.size()),
+                              header);
+    ASSERT_EQ(static_cast<int64_t>(sizeof(header)),
+              file->Write(header, sizeof(header)));
+    ASSERT_EQ(static_cast<int64_t>(record.payload.size()),
+              file->Write(record.payload.data(), record.payload.size()));
+  }
+  ASSERT_TRUE(file->Close());
+}
+
+}  // namespace
+
+class ReplayFileTest : public testing::Test {
+ protected:
+  void TearDown() override { MemoryFile::DeleteAll(); }
+};
+
+TEST_F(ReplayFileTest, ReplaysDatagramsInOrder) {
+  WriteCapture({{0, "first datagram"}, {100, "second"}, {200, "third one"}});
+
+  File* file = File::OpenWithNoBuffering("replay://memory://test.cap?speed=100", "r");
+  ASSERT_TRUE(file);
+
+  char buffer[65536];
+  ASSERT_EQ(14, file->Read(buffer, sizeof(buffer)));
+  EXPECT_EQ(0, memcmp(buffer, "first datagram", 14));
+  ASSERT_EQ(6, file->Read(buffer, sizeof(buffer)));
+  EXPECT_EQ(0, memcmp(buffer, "second", 6));
+  ASSERT_EQ(9, file->Read(buffer, sizeof(buffer)));
+  EXPECT_EQ(0, memcmp(buffer, "third one", 9));
+  // Clean end of the capture.
+  EXPECT_EQ(0, file->Read(buffer, sizeof(buffer)));
+  EXPECT_TRUE(file->Close());
+}
+
+TEST_F(ReplayFileTest, PacesDatagramsToRecordedTimestamps) {
+  // Two datagrams 60 ms apart replayed at real time must take at least the
+  // recorded interval; sleep_until never returns early.
+  WriteCapture({{0, "a"}, {60000, "b"}});
+
+  File* file = File::OpenWithNoBuffering("replay://memory://test.cap", "r");
+  ASSERT_TRUE(file);
+
+  char buffer[65536];
+  const auto start = std::chrono::steady_clock::now();
+  ASSERT_EQ(1, file->Read(buffer, sizeof(buffer)));
+  ASSERT_EQ(1, file->Read(buffer, sizeof(buffer)));
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT_GE(elapsed, std::chrono::milliseconds(50));
+  EXPECT_TRUE(file->Close());
+}
+
+TEST_F(ReplayFileTest, RejectsInvalidSpeed) {
+  WriteCapture({{0, "datagram"}});
+
+  EXPECT_EQ(nullptr, File::OpenWithNoBuffering("replay://memory://test.cap?speed=0", "r"));
+  EXPECT_EQ(nullptr, File::OpenWithNoBuffering("replay://memory://test.cap?speed=101", "r"));
+  EXPECT_EQ(nullptr, File::OpenWithNoBuffering("replay://memory://test.cap?speed=fast", "r"));
+}
+
+TEST_F(ReplayFileTest, RejectsNonCaptureFile) {
+  File* file = File::Open(kCapturePath, "w");
+  ASSERT_TRUE(file);
+  const char kJunk[] = "not a capture";
+  ASSERT_EQ(static_cast<int64_t>(sizeof(kJunk)),
+            file->Write(kJunk, sizeof(kJunk)));
+  ASSERT_TRUE(file->Close());
+
+  EXPECT_EQ(nullptr, File::OpenWithNoBuffering("replay://memory://test.cap", "r"));
+}
+
+TEST_F(ReplayFileTest, FailsOnTruncatedRecord) {
+  // A complete record followed by a header that promises more payload than
+  // the file holds.
+  File* file = File::Open(kCapturePath, "w");
+  ASSERT_TRUE(file);
+  ASSERT_EQ(static_cast<int64_t>(kCaptureFileMagicSize),
+            file->Write(kCaptureFileMagic, kCaptureFileMagicSize));
+  uint8_t header[kCaptureRecordHeaderSize];
+  EncodeCaptureRecordHeader(0, 8, header);
+  ASSERT_EQ(static_cast<int64_t>(sizeof(header)),
+            file->Write(header, sizeof(header)));
+  ASSERT_EQ(8, file->Write("complete", 8));
+  EncodeCaptureRecordHeader(1000, 100, header);
+  ASSERT_EQ(static_cast<int64_t>(sizeof(header)),
+            file->Write(header, sizeof(header)));
+  ASSERT_TRUE(file->Close());
+
+  File* replay = File::OpenWithNoBuffering("replay://memory://test.cap?speed=100", "r");
+  ASSERT_TRUE(replay);
+  char buffer[65536];
+  ASSERT_EQ(8, replay->Read(buffer, sizeof(buffer)));
+  EXPECT_EQ(-1, replay->Read(buffer, sizeof(buffer)));
+  EXPECT_TRUE(replay->Close());
+}
+
+}  // namespace shaka
@@ -0,0 +1,304 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/file/shm_file.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <absl/log/check.h>
+#include <absl/log/log.h>
+
+#include <packager/macros/compiler.h>
+#include <packager/macros/logging.h>
+
+namespace shaka {
+namespace {
+
+const uint32_t kShmFileMagic = 0x53686d46;  // 'ShmF'
+
+// Initial payload capacity; doubled whenever a write outgrows it. Sized for a
+// typical media segment so most segments never remap.
+const uint64_t kInitialCapacity = 4 << 20;
+
+// Control header at the start of every shared memory object. The consumer
+// maps the object and polls |complete|; |size| is only meaningful once
+// |complete| is set. Atomics are used so the cross-process publication does
+// not need a separate lock object.
+struct ShmFileHeader {
+  uint32_t magic;
+  std::atomic<uint32_t> complete;
+  std::atomic<uint64_t> size;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "shm file header atomics must be lock free to be shared "
+              "across processes");
+
+std::string MakeObjectName(const char* file_name) {
+  // POSIX shared memory object names start with exactly one '/'.
+  std::string name = "/";
+  name += file_name;
+  for (size_t i = 1; i < name.size(); ++i) {
+    if (name[i] == '/')
+      name[i] = '_';
+  }
+  return name;
+}
+
+}  // namespace
+
+#if !defined(_WIN32)
+
+ShmFile::ShmFile(const char* file_name, const char* mode)
+    : File(file_name), object_name_(MakeObjectName(file_name)),
+      file_mode_(mode) {}
+
+ShmFile::~ShmFile() {}
+
+bool ShmFile::Open() {
+  if (file_mode_ != "r" && file_mode_ != "w") {
+    NOTIMPLEMENTED() << "ShmFile does not support mode " << file_mode_;
+    return false;
+  }
+  const bool writing = file_mode_ == "w";
+
+  fd_ = shm_open(object_name_.c_str(),
+                 writing ? (O_CREAT | O_TRUNC | O_RDWR) : O_RDONLY, 0644);
+  if (fd_ < 0) {
+    LOG(ERROR) << "Failed to open shared memory object " << object_name_;
+    return false;
+  }
+
+  if (writing) {
+    if (!EnsureCapacity(kInitialCapacity)) {
+      Close();
+      return false;
+    }
+    ShmFileHeader* header = reinterpret_cast<ShmFileHeader*>(map_);
+    header->magic = kShmFileMagic;
+    header->complete.store(0, std::memory_order_relaxed);
+    header->size.store(0, std::memory_order_relaxed);
+    return true;
+  }
+
+  struct stat info;
+  if (fstat(fd_, &info) != 0 ||
+      static_cast<uint64_t>(info.st_size) < sizeof(ShmFileHeader)) {
+    LOG(ERROR) << "Shared memory object " << object_name_
+               << " is missing or truncated.";
+    Close();
+    return false;
+  }
+  mapped_size_ = info.st_size;
+  void* map = mmap(nullptr, mapped_size_, PROT_READ, MAP_SHARED, fd_, 0);
+  if (map == MAP_FAILED) {
+    LOG(ERROR) << "Failed to map shared memory object " << object_name_;
+    map_ = nullptr;
+    Close();
+    return false;
+  }
+  map_ = static_cast<uint8_t*>(map);
+
+  const ShmFileHeader* header = reinterpret_cast<const ShmFileHeader*>(map_);
+  if (header->magic != kShmFileMagic ||
+      header->complete.load(std::memory_order_acquire) == 0) {
+    LOG(ERROR) << "Shared memory object " << object_name_
+               << " is not a complete shm file.";
+    Close();
+    return false;
+  }
+  size_ = header->size.load(std::memory_order_acquire);
+  if (sizeof(ShmFileHeader) + size_ > mapped_size_) {
+    LOG(ERROR) << "Shared memory object " << object_name_
+               << " declares more payload than is mapped.";
+    Close();
+    return false;
+  }
+  return true;
+}
+
+bool ShmFile::Close() {
+  bool result = true;
+  if (file_mode_ == "w")
+    CloseForWriting();
+  if (map_) {
+    if (munmap(map_, mapped_size_) != 0)
+      result = false;
+    map_ = nullptr;
+  }
+  if (fd_ >= 0) {
+    if (close(fd_) != 0)
+      result = false;
+    fd_ = -1;
+  }
+  delete this;
+  return result;
+}
+
+int64_t ShmFile::Read(void* buffer, uint64_t length) {
+  DCHECK(buffer);
+  DCHECK(map_);
+  if (position_ >= size_)
+    return 0;
+  const uint64_t bytes_to_read = std::min(length, size_ - position_);
+  memcpy(buffer, map_ + sizeof(ShmFileHeader) + position_, bytes_to_read);
+  position_ += bytes_to_read;
+  return bytes_to_read;
+}
+
+int64_t ShmFile::Write(const void* buffer, uint64_t length) {
+  DCHECK(buffer);
+  DCHECK_EQ(file_mode_, "w");
+  if (!EnsureCapacity(position_ + length))
+    return -1;
+  memcpy(map_ + sizeof(ShmFileHeader) + position_, buffer, length);
+  position_ += length;
+  if (position_ > size_)
+    size_ = position_;
+  return length;
+}
+
+void ShmFile::CloseForWriting() {
+  if (!map_ || file_mode_ != "w")
+    return;
+  ShmFileHeader* header = reinterpret_cast<ShmFileHeader*>(map_);
+  if (header->complete.load(std::memory_order_relaxed) != 0)
+    return;
+  header->size.store(size_, std::memory_order_release);
+  header->complete.store(1, std::memory_order_release);
+  // Trim the object so the consumer's mapping matches the payload.
+  if (ftruncate(fd_, sizeof(ShmFileHeader) + size_) != 0)
+    PLOG(WARNING) << "Failed to trim shared memory object " << object_name_;
+}
+
+int64_t ShmFile::Size() {
+  return size_;
+}
+
+bool ShmFile::Flush() {
+  // Writes go straight into the mapped pages; there is nothing buffered in
+  // this process to flush.
+  return map_ != nullptr;
+}
+
+bool ShmFile::Seek(uint64_t position) {
+  if (position > size_)
+    return false;
+  position_ = position;
+  return true;
+}
+
+bool ShmFile::Tell(uint64_t* position) {
+  DCHECK(position);
+  *position = position_;
+  return true;
+}
+
+bool ShmFile::Delete(const char* file_name) {
+  return shm_unlink(MakeObjectName(file_name).c_str()) == 0;
+}
+
+bool ShmFile::EnsureCapacity(uint64_t needed_capacity) {
+  const uint64_t needed_size = sizeof(ShmFileHeader) + needed_capacity;
+  if (needed_size <= mapped_size_)
+    return true;
+
+  uint64_t new_size = mapped_size_ ? mapped_size_ : needed_size;
+  while (new_size < needed_size)
+    new_size *= 2;
+
+  if (ftruncate(fd_, new_size) != 0) {
+    PLOG(ERROR) << "Failed to grow shared memory object " << object_name_
+                << " to " << new_size << " bytes";
+    return false;
+  }
+  if (map_) {
+    munmap(map_, mapped_size_);
+    map_ = nullptr;
+  }
+  void* map =
+      mmap(nullptr, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  if (map == MAP_FAILED) {
+    LOG(ERROR) << "Failed to map shared memory object " << object_name_;
+    return false;
+  }
+  map_ = static_cast<uint8_t*>(map);
+  mapped_size_ = new_size;
+  return true;
+}
+
+#else  // defined(_WIN32)
+
+ShmFile::ShmFile(const char* file_name, const char* mode)
+    : File(file_name), object_name_(MakeObjectName(file_name)),
+      file_mode_(mode) {}
+
+ShmFile::~ShmFile() {}
+
+bool ShmFile::Open() {
+  NOTIMPLEMENTED() << "shm:// files are not supported on Windows.";
+  return false;
+}
+
+bool ShmFile::Close() {
+  delete this;
+  return false;
+}
+
+int64_t ShmFile::Read(void* buffer, uint64_t length) {
+  UNUSED(buffer);
+  UNUSED(length);
+  return -1;
+}
+
+int64_t ShmFile::Write(const void* buffer, uint64_t length) {
+  UNUSED(buffer);
+  UNUSED(length);
+  return -1;
+}
+
+void ShmFile::CloseForWriting() {}
+
+int64_t ShmFile::Size() {
+  return -1;
+}
+
+bool ShmFile::Flush() {
+  return false;
+}
+
+bool ShmFile::Seek(uint64_t position) {
+  UNUSED(position);
+  return false;
+}
+
+bool ShmFile::Tell(uint64_t* position) {
+  UNUSED(position);
+  return false;
+}
+
+bool ShmFile::Delete(const char* file_name) {
+  UNUSED(file_name);
+  return false;
+}
+
+bool ShmFile::EnsureCapacity(uint64_t needed_capacity) {
+  UNUSED(needed_capacity);
+  return false;
+}
+
+#endif  // !defined(_WIN32)
+
+}  // namespace shaka
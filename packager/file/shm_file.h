@@ -0,0 +1,77 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_FILE_SHM_FILE_H_
+#define PACKAGER_FILE_SHM_FILE_H_
+
+#include <cstdint>
+#include <string>
+
+#include <packager/file.h>
+#include <packager/macros/classes.h>
+
+namespace shaka {
+
+/// Implements a File backed by a POSIX shared memory object ("shm://"
+/// prefix). Segment bytes land directly in pages that a co-located consumer
+/// (e.g. an origin server) can map, so the handoff is zero-copy and avoids
+/// the localhost HTTP hop that HttpFile pays per segment.
+///
+/// Each file maps to one shared memory object whose layout is a small
+/// control header followed by the payload. The writer publishes the payload
+/// size and a completion flag in the header when the file is closed for
+/// writing; readers poll the flag before consuming. The writer never unlinks
+/// the object - the consumer unlinks it once the segment has been served.
+/// Not available on Windows.
+class ShmFile : public File {
+ public:
+  /// @param file_name C string containing the name of the file to be
+  ///        accessed. Mapped to the POSIX shared memory object name
+  ///        "/<file_name>" with any '/' replaced by '_'.
+  /// @param mode C string containing a file access mode. Only "r" and "w"
+  ///        are supported.
+  ShmFile(const char* file_name, const char* mode);
+
+  /// @name File implementation overrides.
+  /// @{
+  bool Close() override;
+  int64_t Read(void* buffer, uint64_t length) override;
+  int64_t Write(const void* buffer, uint64_t length) override;
+  void CloseForWriting() override;
+  int64_t Size() override;
+  bool Flush() override;
+  bool Seek(uint64_t position) override;
+  bool Tell(uint64_t* position) override;
+  /// @}
+
+  /// Unlinks the shared memory object with the given name.
+  /// @return true on success, false otherwise.
+  static bool Delete(const char* file_name);
+
+ protected:
+  ~ShmFile() override;
+
+  bool Open() override;
+
+ private:
+  // Grow the object and remap it so at least |needed_capacity| payload bytes
+  // fit. Returns false on failure.
+  bool EnsureCapacity(uint64_t needed_capacity);
+
+  std::string object_name_;
+  std::string file_mode_;
+  int fd_ = -1;
+  uint8_t* map_ = nullptr;
+  uint64_t mapped_size_ = 0;
+  uint64_t size_ = 0;
+  uint64_t position_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(ShmFile);
+};
+
+}  // namespace shaka
+
+#endif  // PACKAGER_FILE_SHM_FILE_H_
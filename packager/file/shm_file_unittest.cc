@@ -0,0 +1,99 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/file/shm_file.h>
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <packager/file.h>
+
+#if !defined(_WIN32)
+
+namespace shaka {
+namespace {
+const char kShmFileName[] = "shm://shaka_shm_file_test";
+}  // namespace
+
+class ShmFileTest : public testing::Test {
+ protected:
+  void TearDown() override { File::Delete(kShmFileName); }
+};
+
+TEST_F(ShmFileTest, WriteThenRead) {
+  const std::string kContents = "shared memory segment payload";
+
+  File* writer = File::Open(kShmFileName, "w");
+  ASSERT_TRUE(writer);
+  EXPECT_EQ(static_cast<int64_t>(kContents.size()),
+            writer->Write(kContents.data(), kContents.size()));
+  EXPECT_EQ(static_cast<int64_t>(kContents.size()), writer->Size());
+  ASSERT_TRUE(writer->Close());
+
+  File* reader = File::Open(kShmFileName, "r");
+  ASSERT_TRUE(reader);
+  std::string read_contents(kContents.size(), '\0');
+  EXPECT_EQ(static_cast<int64_t>(kContents.size()),
+            reader->Read(&read_contents[0], read_contents.size()));
+  EXPECT_EQ(kContents, read_contents);
+  // At end of file now.
+  EXPECT_EQ(0, reader->Read(&read_contents[0], read_contents.size()));
+  ASSERT_TRUE(reader->Close());
+}
+
+TEST_F(ShmFileTest, GrowsBeyondInitialCapacity) {
+  // Larger than the initial mapping so the object is grown and remapped.
+  const std::vector<uint8_t> contents(10 << 20, 0x42);
+
+  File* writer = File::Open(kShmFileName, "w");
+  ASSERT_TRUE(writer);
+  EXPECT_EQ(static_cast<int64_t>(contents.size()),
+            writer->Write(contents.data(), contents.size()));
+  ASSERT_TRUE(writer->Close());
+
+  File* reader = File::Open(kShmFileName, "r");
+  ASSERT_TRUE(reader);
+  EXPECT_EQ(static_cast<int64_t>(contents.size()), reader->Size());
+  std::vector<uint8_t> read_contents(contents.size());
+  EXPECT_EQ(static_cast<int64_t>(contents.size()),
+            reader->Read(read_contents.data(), read_contents.size()));
+  EXPECT_EQ(contents, read_contents);
+  ASSERT_TRUE(reader->Close());
+}
+
+TEST_F(ShmFileTest, SeekAndRewrite) {
+  File* writer = File::Open(kShmFileName, "w");
+  ASSERT_TRUE(writer);
+  EXPECT_EQ(5, writer->Write("aaaaa", 5));
+  ASSERT_TRUE(writer->Seek(1));
+  EXPECT_EQ(3, writer->Write("bbb", 3));
+  // Rewrites within the payload do not shrink it.
+  EXPECT_EQ(5, writer->Size());
+  ASSERT_TRUE(writer->Close());
+
+  std::string contents;
+  ASSERT_TRUE(File::ReadFileToString(kShmFileName, &contents));
+  EXPECT_EQ("abbba", contents);
+}
+
+TEST_F(ShmFileTest, ReadingIncompleteFileFails) {
+  File* writer = File::Open(kShmFileName, "w");
+  ASSERT_TRUE(writer);
+  EXPECT_EQ(4, writer->Write("abcd", 4));
+
+  // The writer has not closed yet, so the completion flag is unset.
+  EXPECT_FALSE(File::Open(kShmFileName, "r"));
+  ASSERT_TRUE(writer->Close());
+  File* reader = File::Open(kShmFileName, "r");
+  ASSERT_TRUE(reader);
+  ASSERT_TRUE(reader->Close());
+}
+
+}  // namespace shaka
+
+#endif  // !defined(_WIN32)
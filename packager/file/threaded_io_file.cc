@@ -9,17 +9,21 @@
 #include <absl/log/check.h>
 
 #include <packager/file/thread_pool.h>
+#include <packager/utils/watchdog.h>
 
 namespace shaka {
 
 ThreadedIoFile::ThreadedIoFile(std::unique_ptr<File, FileCloser> internal_file,
                                Mode mode,
                                uint64_t io_cache_size,
-                               uint64_t io_block_size)
+                               uint64_t io_block_size,
+                               FlushMode flush_mode)
     : File(internal_file->file_name()),
       internal_file_(std::move(internal_file)),
       mode_(mode),
+      flush_mode_(flush_mode),
       cache_(io_cache_size),
+      write_cache_(&cache_),
       io_buffer_(io_block_size),
       position_(0),
       size_(0),
@@ -27,8 +31,15 @@ ThreadedIoFile::ThreadedIoFile(std::unique_ptr<File, FileCloser> internal_file,
       internal_file_error_(0),
       flushing_(false),
       flush_complete_(false),
+      flush_requested_(0),
+      flush_completed_(0),
+      flush_result_(true),
       task_exited_(false) {
   DCHECK(internal_file_);
+  if (flush_mode_ == kAsyncFlush) {
+    DCHECK_EQ(kOutputMode, mode_);
+    second_cache_.reset(new IoCache(io_cache_size));
+  }
 }
 
 ThreadedIoFile::~ThreadedIoFile() {}
@@ -50,10 +61,15 @@ bool ThreadedIoFile::Close() {
   DCHECK(internal_file_);
 
   bool result = true;
-  if (mode_ == kOutputMode)
+  if (mode_ == kOutputMode) {
     result = Flush();
+    if (flush_mode_ == kAsyncFlush)
+      result &= WaitForFlush(flush_token());
+  }
 
   cache_.Close();
+  if (second_cache_)
+    second_cache_->Close();
   WaitForSignal(&task_exited_mutex_, &task_exited_);
 
   result &= internal_file_.release()->Close();
@@ -81,15 +97,26 @@ int64_t ThreadedIoFile::Write(const void* buffer, uint64_t length) {
   DCHECK(internal_file_);
   DCHECK_EQ(kOutputMode, mode_);
 
-  if (internal_file_error_.load(std::memory_order_relaxed))
-    return internal_file_error_.load(std::memory_order_relaxed);
+  for (;;) {
+    if (internal_file_error_.load(std::memory_order_relaxed))
+      return internal_file_error_.load(std::memory_order_relaxed);
 
-  uint64_t bytes_written = cache_.Write(buffer, length);
-  position_ += bytes_written;
-  if (position_ > size_)
-    size_ = position_;
+    uint64_t bytes_written = write_cache_->Write(buffer, length);
+    if (bytes_written != 0 || length == 0) {
+      position_ += bytes_written;
+      if (position_ > size_)
+        size_ = position_;
+      return bytes_written;
+    }
 
-  return bytes_written;
+    if (flush_mode_ != kAsyncFlush)
+      return 0;
+    // The write cache is still closed from a flush that the background writer
+    // has not finished yet; it is reopened before the flush token retires.
+    // This is the only point where an async flush can back-pressure writes,
+    // and it needs two outstanding flushes to get here.
+    WaitForFlush(flush_token());
+  }
 }
 
 void ThreadedIoFile::CloseForWriting() {}
@@ -107,6 +134,19 @@ bool ThreadedIoFile::Flush() {
   if (internal_file_error_.load(std::memory_order_relaxed))
     return false;
 
+  if (flush_mode_ == kAsyncFlush) {
+    // Close the active cache to mark the end of the flushed range, then swap
+    // writes over to the other half of the double buffer. The background
+    // writer drains and flushes the closed half and reopens it for the next
+    // swap; WaitForFlush() observes completion.
+    absl::MutexLock lock(&flush_mutex_);
+    write_cache_->Close();
+    ++flush_requested_;
+    write_cache_ = OtherCache(write_cache_);
+    // Errors from earlier async flushes surface here.
+    return flush_result_;
+  }
+
   {
     absl::MutexLock lock(&flush_mutex_);
     flushing_ = true;
@@ -119,11 +159,28 @@ bool ThreadedIoFile::Flush() {
   return internal_file_->Flush();
 }
 
+uint64_t ThreadedIoFile::flush_token() {
+  absl::MutexLock lock(&flush_mutex_);
+  return flush_requested_;
+}
+
+bool ThreadedIoFile::WaitForFlush(uint64_t token) {
+  DCHECK_EQ(kAsyncFlush, flush_mode_);
+
+  absl::MutexLock lock(&flush_mutex_);
+  while (flush_completed_ < token)
+    flush_cv_.Wait(&flush_mutex_);
+  return flush_result_;
+}
+
 bool ThreadedIoFile::Seek(uint64_t position) {
   if (mode_ == kOutputMode) {
-    // Writing. Just flush the cache and seek.
+    // Writing. Just flush the cache and seek. An async flush must also be
+    // waited out so the seek cannot overtake in-flight writes.
     if (!Flush())
       return false;
+    if (flush_mode_ == kAsyncFlush && !WaitForFlush(flush_token()))
+      return false;
     if (!internal_file_->Seek(position))
       return false;
   } else {
@@ -158,12 +215,29 @@ bool ThreadedIoFile::Tell(uint64_t* position) {
   return true;
 }
 
+const uint8_t* ThreadedIoFile::MapReadRegion(uint64_t offset,
+                                             uint64_t length) {
+  // Mappings do not interact with the cache thread or the read position, so
+  // they can be forwarded straight to the internal file. The mapping stays
+  // valid until Close(), which closes the internal file last.
+  if (mode_ != kInputMode)
+    return NULL;
+  return internal_file_->MapReadRegion(offset, length);
+}
+
+uint64_t ThreadedIoFile::OptimalReadSize() {
+  // The preference of the wrapped file still applies through the cache: it
+  // bounds how much a caller should ask for (and thus wait for) per call.
+  return internal_file_->OptimalReadSize();
+}
+
 void ThreadedIoFile::TaskHandler() {
   {
     absl::MutexLock lock(&task_exited_mutex_);
     task_exited_ = false;
   }
 
+  Watchdog::ScopedHeartbeat heartbeat(file_name());
   if (mode_ == kInputMode)
     RunInInputMode();
   else
@@ -180,6 +254,7 @@ void ThreadedIoFile::RunInInputMode() {
   DCHECK_EQ(kInputMode, mode_);
 
   while (true) {
+    Watchdog::Pulse("threaded_io.read");
     int64_t read_result =
         internal_file_->Read(&io_buffer_[0], io_buffer_.size());
     if (read_result <= 0) {
@@ -198,9 +273,36 @@ void ThreadedIoFile::RunInOutputMode() {
   DCHECK(internal_file_);
   DCHECK_EQ(kOutputMode, mode_);
 
+  // In kAsyncFlush mode the writer drains the two caches in strict
+  // alternation, mirroring the swaps done by Flush().
+  IoCache* read_cache = &cache_;
+
   while (true) {
-    uint64_t write_bytes = cache_.Read(&io_buffer_[0], io_buffer_.size());
+    uint64_t write_bytes = read_cache->Read(&io_buffer_[0], io_buffer_.size());
+    Watchdog::Pulse("threaded_io.write");
     if (write_bytes == 0) {
+      if (flush_mode_ == kAsyncFlush) {
+        {
+          absl::MutexLock lock(&flush_mutex_);
+          if (flush_completed_ >= flush_requested_) {
+            // Closed with no flush outstanding: Close() wants us gone.
+            return;
+          }
+        }
+        // Commit the drained half outside the lock so a concurrent Flush()
+        // call never blocks on storage, then retire the token.
+        const bool flush_ok = internal_file_->Flush();
+        read_cache->Reopen();
+        {
+          absl::MutexLock lock(&flush_mutex_);
+          flush_result_ &= flush_ok;
+          ++flush_completed_;
+          flush_cv_.SignalAll();
+        }
+        read_cache = OtherCache(read_cache);
+        continue;
+      }
+
       absl::MutexLock lock(&flush_mutex_);
       if (flushing_) {
         cache_.Reopen();
@@ -217,12 +319,19 @@ void ThreadedIoFile::RunInOutputMode() {
         if (write_result < 0) {
           internal_file_error_.store(write_result, std::memory_order_relaxed);
           cache_.Close();
+          if (second_cache_)
+            second_cache_->Close();
 
           absl::MutexLock lock(&flush_mutex_);
           if (flushing_) {
             flushing_ = false;
             flush_complete_ = true;
           }
+          // Retire any outstanding async flush tokens so waiters wake up and
+          // observe the error.
+          flush_result_ = false;
+          flush_completed_ = flush_requested_;
+          flush_cv_.SignalAll();
           return;
         }
         bytes_written += write_result;
@@ -231,6 +340,11 @@ void ThreadedIoFile::RunInOutputMode() {
   }
 }
 
+IoCache* ThreadedIoFile::OtherCache(IoCache* cache) {
+  DCHECK(second_cache_);
+  return cache == &cache_ ? second_cache_.get() : &cache_;
+}
+
 void ThreadedIoFile::WaitForSignal(absl::Mutex* mutex, bool* condition) {
   // This waits until the boolean condition variable is true, then locks the
   // mutex.  The check is done every time the mutex is unlocked.  As long as
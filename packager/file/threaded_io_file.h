@@ -23,11 +23,20 @@ namespace shaka {
 class ThreadedIoFile : public File {
  public:
   enum Mode { kInputMode, kOutputMode };
+  enum FlushMode {
+    /// Flush() blocks until all buffered bytes reach the internal file.
+    kBlockingFlush,
+    /// Flush() hands the buffered bytes to the background writer and returns
+    /// immediately. Use flush_token() / WaitForFlush() to observe completion;
+    /// flush errors surface on a later Flush(), WaitForFlush() or Close().
+    kAsyncFlush,
+  };
 
   ThreadedIoFile(std::unique_ptr<File, FileCloser> internal_file,
                  Mode mode,
                  uint64_t io_cache_size,
-                 uint64_t io_block_size);
+                 uint64_t io_block_size,
+                 FlushMode flush_mode = kBlockingFlush);
 
   /// @name File implementation overrides.
   /// @{
@@ -39,8 +48,18 @@ class ThreadedIoFile : public File {
   bool Flush() override;
   bool Seek(uint64_t position) override;
   bool Tell(uint64_t* position) override;
+  const uint8_t* MapReadRegion(uint64_t offset, uint64_t length) override;
+  uint64_t OptimalReadSize() override;
   /// @}
 
+  /// @return A token identifying the most recently requested flush. Only
+  ///         meaningful in kAsyncFlush mode.
+  uint64_t flush_token();
+  /// Blocks until the flush identified by @a token has been committed to the
+  /// internal file. Only meaningful in kAsyncFlush mode.
+  /// @return true if every flush up to @a token succeeded.
+  bool WaitForFlush(uint64_t token);
+
  protected:
   ~ThreadedIoFile() override;
 
@@ -54,9 +73,20 @@ class ThreadedIoFile : public File {
   void RunInOutputMode();
   void WaitForSignal(absl::Mutex* mutex, bool* condition);
 
+  // Returns the other half of the double buffer. Only used in kAsyncFlush
+  // mode, where |second_cache_| is allocated.
+  IoCache* OtherCache(IoCache* cache);
+
   std::unique_ptr<File, FileCloser> internal_file_;
   const Mode mode_;
+  const FlushMode flush_mode_;
   IoCache cache_;
+  // Second half of the double buffer, allocated in kAsyncFlush mode only.
+  // Flush() closes the active cache and swaps writes over to the other one
+  // while the background writer drains and flushes the closed half.
+  std::unique_ptr<IoCache> second_cache_;
+  // The cache new writes go to. Only accessed from the writing thread.
+  IoCache* write_cache_;
   std::vector<uint8_t> io_buffer_;
   uint64_t position_;
   uint64_t size_;
@@ -66,6 +96,12 @@ class ThreadedIoFile : public File {
   absl::Mutex flush_mutex_;
   bool flushing_ ABSL_GUARDED_BY(flush_mutex_);
   bool flush_complete_ ABSL_GUARDED_BY(flush_mutex_);
+  // Async flush bookkeeping: tokens are issued by Flush() and retired by the
+  // background writer once the corresponding bytes hit the internal file.
+  absl::CondVar flush_cv_;
+  uint64_t flush_requested_ ABSL_GUARDED_BY(flush_mutex_);
+  uint64_t flush_completed_ ABSL_GUARDED_BY(flush_mutex_);
+  bool flush_result_ ABSL_GUARDED_BY(flush_mutex_);
 
   absl::Mutex task_exited_mutex_;
   bool task_exited_ ABSL_GUARDED_BY(task_exited_mutex_);
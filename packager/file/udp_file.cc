@@ -25,13 +25,22 @@
 #ifndef IP_MULTICAST_ALL
 #define IP_MULTICAST_ALL 49
 #endif
+// SO_RXQ_OVFL has been supported since kernel version 2.6.33 but we may be
+// building on a machine that is older than that.
+#if defined(__linux__) && !defined(SO_RXQ_OVFL)
+#define SO_RXQ_OVFL 40
+#endif
 #endif  // defined(OS_WIN)
 
+#include <algorithm>
+#include <cstring>
 #include <limits>
+#include <vector>
 
 #include <absl/log/check.h>
 #include <absl/log/log.h>
 
+#include <packager/file/capture_file_format.h>
 #include <packager/file/udp_options.h>
 #include <packager/macros/classes.h>
 #include <packager/macros/compiler.h>
@@ -53,8 +62,57 @@ int GetSocketErrorCode() {
 #endif
 }
 
+// Per-packet slot large enough for the biggest possible datagram. Read()
+// DCHECKs the caller's buffer against the same bound.
+const size_t kMaxDatagramSize = 65536;
+
+#if defined(__linux__)
+
+// Upper bound on the "batch_size" option; beyond this the ring just wastes
+// memory without saving additional system calls.
+const int kMaxBatchDepth = 1024;
+
+#endif  // defined(__linux__)
+
 }  // anonymous namespace
 
+#if defined(__linux__)
+
+// Preallocated ring of receive slots shared across recvmmsg() calls, so the
+// steady state receive path performs no allocations.
+struct UdpFile::RecvBatch {
+  explicit RecvBatch(int depth)
+      : payloads(depth * kMaxDatagramSize),
+        iovecs(depth),
+        headers(depth),
+        controls(depth * CMSG_SPACE(sizeof(uint32_t))) {
+    for (int i = 0; i < depth; ++i) {
+      iovecs[i].iov_base = &payloads[i * kMaxDatagramSize];
+      iovecs[i].iov_len = kMaxDatagramSize;
+      headers[i].msg_hdr.msg_iov = &iovecs[i];
+      headers[i].msg_hdr.msg_iovlen = 1;
+      headers[i].msg_hdr.msg_control =
+          &controls[i * CMSG_SPACE(sizeof(uint32_t))];
+      headers[i].msg_hdr.msg_controllen = CMSG_SPACE(sizeof(uint32_t));
+    }
+  }
+
+  const uint8_t* payload(int index) const {
+    return &payloads[index * kMaxDatagramSize];
+  }
+
+  std::vector<uint8_t> payloads;
+  std::vector<struct iovec> iovecs;
+  std::vector<struct mmsghdr> headers;
+  // Ancillary data space for the SO_RXQ_OVFL drop counter.
+  std::vector<uint8_t> controls;
+  // [next_index, received_count) are the filled slots not yet consumed.
+  int next_index = 0;
+  int received_count = 0;
+};
+
+#endif  // defined(__linux__)
+
 UdpFile::UdpFile(const char* file_name)
     : File(file_name), socket_(INVALID_SOCKET) {}
 
@@ -65,6 +123,10 @@ bool UdpFile::Close() {
     close(socket_);
     socket_ = INVALID_SOCKET;
   }
+  if (capture_file_) {
+    capture_file_->Close();
+    capture_file_ = nullptr;
+  }
   delete this;
 #if defined(OS_WIN)
   if (wsa_started_)
@@ -81,15 +143,89 @@ int64_t UdpFile::Read(void* buffer, uint64_t length) {
   if (socket_ == INVALID_SOCKET)
     return -1;
 
+#if defined(__linux__)
+  if (batch_)
+    return ReadBatched(buffer, length);
+#endif  // defined(__linux__)
+
   int64_t result;
   do {
     result = recvfrom(socket_, reinterpret_cast<char*>(buffer),
                       static_cast<int>(length), 0, NULL, 0);
   } while (result == -1 && GetSocketErrorCode() == EINTR_CODE);
 
+  if (capture_file_ && result > 0)
+    WriteCaptureRecord(buffer, result);
   return result;
 }
 
+void UdpFile::WriteCaptureRecord(const void* payload, uint64_t size) {
+  uint8_t header[kCaptureRecordHeaderSize];
+  const uint64_t timestamp_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - capture_start_)
+          .count();
+  EncodeCaptureRecordHeader(timestamp_us, static_cast<uint32_t>(size), header);
+  if (capture_file_->Write(header, sizeof(header)) !=
+          static_cast<int64_t>(sizeof(header)) ||
+      capture_file_->Write(payload, size) != static_cast<int64_t>(size)) {
+    LOG(ERROR) << "Failed to write to capture file; abandoning the capture.";
+    capture_file_->Close();
+    capture_file_ = nullptr;
+  }
+}
+
+#if defined(__linux__)
+
+int64_t UdpFile::ReadBatched(void* buffer, uint64_t length) {
+  if (batch_->next_index >= batch_->received_count) {
+    // Ring drained; refill it. MSG_WAITFORONE blocks for the first datagram
+    // (honoring SO_RCVTIMEO) and then grabs whatever else is already queued,
+    // so a steady stream costs roughly one system call per ring of packets.
+    int result;
+    do {
+      result = recvmmsg(socket_, batch_->headers.data(),
+                        batch_->headers.size(), MSG_WAITFORONE, nullptr);
+    } while (result == -1 && GetSocketErrorCode() == EINTR_CODE);
+    if (result <= 0)
+      return -1;
+    batch_->next_index = 0;
+    batch_->received_count = result;
+
+    // The kernel reports drops through a cumulative counter attached to each
+    // message; fold the increase into our own counter.
+    for (int i = 0; i < result; ++i) {
+      struct msghdr* header = &batch_->headers[i].msg_hdr;
+      for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(header); cmsg != nullptr;
+           cmsg = CMSG_NXTHDR(header, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL) {
+          uint32_t overflow_count;
+          memcpy(&overflow_count, CMSG_DATA(cmsg), sizeof(overflow_count));
+          if (overflow_count != last_overflow_count_) {
+            dropped_packets_ += overflow_count - last_overflow_count_;
+            last_overflow_count_ = overflow_count;
+            LOG_EVERY_N(WARNING, 10)
+                << "UDP receive queue overflowed; " << dropped_packets_
+                << " datagrams dropped so far on " << file_name();
+          }
+        }
+      }
+      // Reset for the next refill; the kernel shrinks it on each receive.
+      header->msg_controllen = CMSG_SPACE(sizeof(uint32_t));
+    }
+  }
+
+  const int index = batch_->next_index++;
+  const uint64_t datagram_size = batch_->headers[index].msg_len;
+  const uint64_t bytes_to_copy = std::min(datagram_size, length);
+  memcpy(buffer, batch_->payload(index), bytes_to_copy);
+  if (capture_file_ && bytes_to_copy > 0)
+    WriteCaptureRecord(buffer, bytes_to_copy);
+  return bytes_to_copy;
+}
+
+#endif  // defined(__linux__)
+
 int64_t UdpFile::Write(const void* buffer, uint64_t length) {
   UNUSED(buffer);
   UNUSED(length);
@@ -129,6 +265,12 @@ bool UdpFile::Tell(uint64_t* position) {
   return false;
 }
 
+uint64_t UdpFile::OptimalReadSize() {
+  // One maximum-size datagram per poll keeps live-input latency bounded;
+  // asking for more would just make the reader wait on the socket.
+  return kMaxDatagramSize;
+}
+
 class ScopedSocket {
  public:
   explicit ScopedSocket(SOCKET sock_fd) : sock_fd_(sock_fd) {}
@@ -304,6 +446,43 @@ bool UdpFile::Open() {
     }
   }
 
+  if (options->batch_size() > 1) {
+#if defined(__linux__)
+    const int batch_depth = std::min(options->batch_size(), kMaxBatchDepth);
+    // Ask the kernel to attach its cumulative drop counter to every received
+    // message; batching without drop visibility hides overload.
+    const int optval_one = 1;
+    if (setsockopt(new_socket.get(), SOL_SOCKET, SO_RXQ_OVFL,
+                   reinterpret_cast<const char*>(&optval_one),
+                   sizeof(optval_one)) < 0) {
+      LOG(WARNING) << "Failed to enable SO_RXQ_OVFL; dropped datagrams will "
+                      "not be counted, error = "
+                   << GetSocketErrorCode();
+    }
+    batch_.reset(new RecvBatch(batch_depth));
+#else
+    LOG(WARNING) << "The batch_size UDP option is only supported on Linux; "
+                    "falling back to one datagram per read.";
+#endif  // defined(__linux__)
+  }
+
+  if (!options->capture_path().empty()) {
+    capture_file_ = File::Open(options->capture_path().c_str(), "w");
+    if (!capture_file_) {
+      LOG(ERROR) << "Failed to open capture file " << options->capture_path();
+      return false;
+    }
+    if (capture_file_->Write(kCaptureFileMagic, kCaptureFileMagicSize) !=
+        static_cast<int64_t>(kCaptureFileMagicSize)) {
+      LOG(ERROR) << "Failed to write capture file header to "
+                 << options->capture_path();
+      capture_file_->Close();
+      capture_file_ = nullptr;
+      return false;
+    }
+    capture_start_ = std::chrono::steady_clock::now();
+  }
+
   socket_ = new_socket.release();
   return true;
 }
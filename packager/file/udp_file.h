@@ -7,7 +7,9 @@
 #ifndef MEDIA_FILE_UDP_FILE_H_
 #define MEDIA_FILE_UDP_FILE_H_
 
+#include <chrono>
 #include <cstdint>
+#include <memory>
 #include <string>
 
 #if defined(OS_WIN)
@@ -39,15 +41,41 @@ class UdpFile : public File {
   bool Flush() override;
   bool Seek(uint64_t position) override;
   bool Tell(uint64_t* position) override;
+  uint64_t OptimalReadSize() override;
   /// @}
 
+  /// @return The number of datagrams the kernel reported as dropped on this
+  ///         socket so far. Only populated when batched receive is enabled
+  ///         through the "batch_size" UDP option; 0 otherwise.
+  uint64_t dropped_packets() const { return dropped_packets_; }
+
  protected:
   ~UdpFile() override;
 
   bool Open() override;
 
  private:
+  // Appends one received datagram to |capture_file_| with its arrival time.
+  // On a write error the capture is abandoned with an error log; reception
+  // itself is unaffected.
+  void WriteCaptureRecord(const void* payload, uint64_t size);
+
   SOCKET socket_;
+  uint64_t dropped_packets_ = 0;
+  // Set up in Open() when the "capture" UDP option is present; received
+  // datagrams are recorded here in the capture_file_format.h layout for
+  // later replay through a replay:// source. Owned; closed in Close().
+  File* capture_file_ = nullptr;
+  std::chrono::steady_clock::time_point capture_start_;
+#if defined(__linux__)
+  // Preallocated packet ring used by the recvmmsg() receive path; allocated in
+  // Open() when the "batch_size" UDP option is greater than one.
+  struct RecvBatch;
+  int64_t ReadBatched(void* buffer, uint64_t length);
+  std::unique_ptr<RecvBatch> batch_;
+  // Last value of the kernel's cumulative SO_RXQ_OVFL drop counter.
+  uint32_t last_overflow_count_ = 0;
+#endif  // defined(__linux__)
 #if defined(OS_WIN)
   // For Winsock in Windows.
   bool wsa_started_ = false;
@@ -28,7 +28,9 @@ namespace {
 
 enum FieldType {
   kUnknownField = 0,
+  kBatchSizeField,
   kBufferSizeField,
+  kCaptureField,
   kInterfaceAddressField,
   kMulticastSourceField,
   kReuseField,
@@ -41,7 +43,9 @@ struct FieldNameToTypeMapping {
 };
 
 const FieldNameToTypeMapping kFieldNameTypeMappings[] = {
+    {"batch_size", kBatchSizeField},
     {"buffer_size", kBufferSizeField},
+    {"capture", kCaptureField},
     {"interface", kInterfaceAddressField},
     {"reuse", kReuseField},
     {"source", kMulticastSourceField},
@@ -94,6 +98,14 @@ std::unique_ptr<UdpOptions> UdpOptions::ParseFromString(
 
     for (const auto& pair : kv_pairs) {
       switch (GetFieldType(pair.first)) {
+        case kBatchSizeField:
+          if (!absl::SimpleAtoi(pair.second, &options->batch_size_) ||
+              options->batch_size_ < 0) {
+            LOG(ERROR) << "Invalid udp option for batch_size field "
+                       << pair.second;
+            return nullptr;
+          }
+          break;
         case kBufferSizeField:
           if (!absl::SimpleAtoi(pair.second, &options->buffer_size_)) {
             LOG(ERROR) << "Invalid udp option for buffer_size field "
@@ -101,6 +113,13 @@ std::unique_ptr<UdpOptions> UdpOptions::ParseFromString(
             return nullptr;
           }
           break;
+        case kCaptureField:
+          if (pair.second.empty()) {
+            LOG(ERROR) << "Empty path in udp option for capture field.";
+            return nullptr;
+          }
+          options->capture_path_ = pair.second;
+          break;
         case kInterfaceAddressField:
           options->interface_address_ = pair.second;
           break;
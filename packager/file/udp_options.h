@@ -29,6 +29,8 @@ class UdpOptions {
     return is_source_specific_multicast_;
   }
   int buffer_size() const { return buffer_size_; }
+  int batch_size() const { return batch_size_; }
+  const std::string& capture_path() const { return capture_path_; }
 
  private:
   UdpOptions() = default;
@@ -50,6 +52,14 @@ class UdpOptions {
   // by the underlying operating system ('sysctl net.core.rmem_max' on Linux
   // returns the maximum receive memory size).
   int buffer_size_ = 0;
+  // Number of datagrams to receive per system call. Values greater than one
+  // enable batched receives (recvmmsg on Linux); 0 or 1 keeps the classic one
+  // datagram per system call behavior.
+  int batch_size_ = 0;
+  // When not empty, every received datagram is also recorded with its arrival
+  // time to a capture file at this path, which can later be fed back through
+  // a replay:// source. The path is resolved through File::Open.
+  std::string capture_path_;
 };
 
 }  // namespace shaka
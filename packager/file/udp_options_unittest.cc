@@ -130,4 +130,26 @@ TEST_F(UdpOptionsTest, BufferSize) {
   EXPECT_EQ(1234, options->buffer_size());
 }
 
+TEST_F(UdpOptionsTest, BatchSize) {
+  auto options = UdpOptions::ParseFromString("224.1.2.30:88?batch_size=64");
+  ASSERT_TRUE(options);
+  EXPECT_EQ(64, options->batch_size());
+}
+
+TEST_F(UdpOptionsTest, InvalidBatchSize) {
+  ASSERT_FALSE(UdpOptions::ParseFromString("224.1.2.30:88?batch_size=-1"));
+  ASSERT_FALSE(UdpOptions::ParseFromString("224.1.2.30:88?batch_size=many"));
+}
+
+TEST_F(UdpOptionsTest, Capture) {
+  auto options = UdpOptions::ParseFromString(
+      "224.1.2.30:88?capture=/captures/channel1.cap");
+  ASSERT_TRUE(options);
+  EXPECT_EQ("/captures/channel1.cap", options->capture_path());
+}
+
+TEST_F(UdpOptionsTest, InvalidCapture) {
+  ASSERT_FALSE(UdpOptions::ParseFromString("224.1.2.30:88?capture="));
+}
+
 }  // namespace shaka
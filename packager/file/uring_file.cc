@@ -0,0 +1,323 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/file/uring_file.h>
+
+#if defined(PACKAGER_ENABLE_IO_URING)
+#include <fcntl.h>
+#include <liburing.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+#include <absl/log/check.h>
+#include <absl/log/log.h>
+
+#include <packager/macros/compiler.h>
+#include <packager/macros/logging.h>
+
+namespace shaka {
+
+namespace {
+
+// Submission queue depth. Also bounds the number of in-flight writes.
+const unsigned kQueueDepth = 64;
+// Number and size of registered write staging buffers. 32 x 256KB keeps a
+// full segment in flight for typical bitrates without unbounded memory.
+const size_t kNumWriteBuffers = 32;
+const size_t kWriteBufferSize = 256 * 1024;
+// Submit when this many SQEs have accumulated, to amortize the syscall.
+const size_t kSubmitBatchSize = 8;
+
+}  // namespace
+
+UringFile::UringFile(const char* file_name, const char* mode)
+    : File(file_name), file_mode_(mode) {}
+
+UringFile::~UringFile() {}
+
+// static
+bool UringFile::IsSupported() {
+#if defined(PACKAGER_ENABLE_IO_URING)
+  return true;
+#else
+  return false;
+#endif
+}
+
+#if defined(PACKAGER_ENABLE_IO_URING)
+
+bool UringFile::Open() {
+  if (file_mode_ != "r" && file_mode_ != "w") {
+    LOG(ERROR) << "UringFile only supports 'r' and 'w' modes, got '"
+               << file_mode_ << "'.";
+    return false;
+  }
+
+  const int flags =
+      file_mode_ == "r" ? O_RDONLY : (O_WRONLY | O_CREAT | O_TRUNC);
+  fd_ = open(file_name().c_str(), flags, 0644);
+  if (fd_ < 0) {
+    LOG(ERROR) << "Cannot open '" << file_name() << "': " << strerror(errno);
+    return false;
+  }
+
+  ring_ = new io_uring;
+  const int ret = io_uring_queue_init(kQueueDepth, ring_, 0);
+  if (ret < 0) {
+    LOG(ERROR) << "io_uring_queue_init failed: " << strerror(-ret);
+    delete ring_;
+    ring_ = nullptr;
+    close(fd_);
+    fd_ = -1;
+    return false;
+  }
+
+  if (file_mode_ == "w") {
+    write_buffers_.resize(kNumWriteBuffers);
+    std::vector<iovec> iovecs(kNumWriteBuffers);
+    for (size_t i = 0; i < kNumWriteBuffers; i++) {
+      write_buffers_[i].resize(kWriteBufferSize);
+      iovecs[i].iov_base = write_buffers_[i].data();
+      iovecs[i].iov_len = kWriteBufferSize;
+      free_buffers_.push_back(static_cast<int>(i));
+    }
+    // Registered buffers let the kernel skip per-write page pinning.
+    if (io_uring_register_buffers(ring_, iovecs.data(), kNumWriteBuffers) <
+        0) {
+      LOG(WARNING) << "io_uring buffer registration failed; writes will not "
+                      "use fixed buffers.";
+      write_buffers_.clear();
+      free_buffers_.clear();
+    }
+  }
+
+  position_ = 0;
+  size_ = 0;
+  if (file_mode_ == "r") {
+    struct stat file_stat;
+    if (fstat(fd_, &file_stat) == 0)
+      size_ = file_stat.st_size;
+  }
+  return true;
+}
+
+bool UringFile::Close() {
+  bool result = Flush();
+  if (ring_) {
+    io_uring_queue_exit(ring_);
+    delete ring_;
+    ring_ = nullptr;
+  }
+  if (fd_ >= 0) {
+    result = (close(fd_) == 0) && result;
+    fd_ = -1;
+  }
+  result = result && !error_;
+  delete this;
+  return result;
+}
+
+int64_t UringFile::Read(void* buffer, uint64_t length) {
+  DCHECK(buffer);
+  DCHECK_GE(fd_, 0);
+
+  // Reads are synchronous: the caller needs the data before it can proceed,
+  // so there is nothing to overlap. Still issued through the ring so reads
+  // and buffered writes retire in one place.
+  io_uring_sqe* sqe = io_uring_get_sqe(ring_);
+  if (!sqe)
+    return -1;
+  io_uring_prep_read(sqe, fd_, buffer, length, position_);
+  io_uring_sqe_set_data(sqe, nullptr);
+  if (io_uring_submit(ring_) < 0)
+    return -1;
+
+  io_uring_cqe* cqe = nullptr;
+  if (io_uring_wait_cqe(ring_, &cqe) < 0)
+    return -1;
+  const int res = cqe->res;
+  io_uring_cqe_seen(ring_, cqe);
+  if (res < 0)
+    return -1;
+  position_ += res;
+  return res;
+}
+
+bool UringFile::ReapCompletion(bool wait) {
+  io_uring_cqe* cqe = nullptr;
+  const int ret = wait ? io_uring_wait_cqe(ring_, &cqe)
+                       : io_uring_peek_cqe(ring_, &cqe);
+  if (ret < 0 || !cqe)
+    return false;
+  if (cqe->res < 0) {
+    LOG(ERROR) << "Async write to '" << file_name()
+               << "' failed: " << strerror(-cqe->res);
+    error_ = true;
+  }
+  // user_data holds the registered buffer index + 1 (0 means no buffer).
+  const uint64_t user_data = io_uring_cqe_get_data64(cqe);
+  if (user_data)
+    free_buffers_.push_back(static_cast<int>(user_data - 1));
+  io_uring_cqe_seen(ring_, cqe);
+  in_flight_--;
+  return !error_;
+}
+
+bool UringFile::Drain() {
+  if (unsubmitted_) {
+    io_uring_submit(ring_);
+    unsubmitted_ = 0;
+  }
+  while (in_flight_) {
+    if (!ReapCompletion(/*wait=*/true) && error_)
+      return false;
+  }
+  return !error_;
+}
+
+int UringFile::AcquireBuffer() {
+  while (free_buffers_.empty()) {
+    if (unsubmitted_) {
+      io_uring_submit(ring_);
+      unsubmitted_ = 0;
+    }
+    if (!ReapCompletion(/*wait=*/true) && error_)
+      return -1;
+  }
+  const int index = free_buffers_.back();
+  free_buffers_.pop_back();
+  return index;
+}
+
+int64_t UringFile::Write(const void* buffer, uint64_t length) {
+  DCHECK(buffer);
+  DCHECK_GE(fd_, 0);
+
+  if (error_)
+    return -1;
+
+  const uint8_t* source = static_cast<const uint8_t*>(buffer);
+  uint64_t bytes_left = length;
+  while (bytes_left) {
+    const int buffer_index = AcquireBuffer();
+    if (buffer_index < 0)
+      return -1;
+    const uint64_t chunk_size =
+        std::min(bytes_left, static_cast<uint64_t>(kWriteBufferSize));
+    memcpy(write_buffers_[buffer_index].data(), source, chunk_size);
+
+    io_uring_sqe* sqe = io_uring_get_sqe(ring_);
+    if (!sqe) {
+      // SQ full: push what we have and retry.
+      io_uring_submit(ring_);
+      unsubmitted_ = 0;
+      sqe = io_uring_get_sqe(ring_);
+      if (!sqe)
+        return -1;
+    }
+    io_uring_prep_write_fixed(sqe, fd_, write_buffers_[buffer_index].data(),
+                              chunk_size, position_, buffer_index);
+    io_uring_sqe_set_data64(sqe, buffer_index + 1);
+    in_flight_++;
+    unsubmitted_++;
+    position_ += chunk_size;
+    size_ = std::max(size_, position_);
+    source += chunk_size;
+    bytes_left -= chunk_size;
+
+    if (unsubmitted_ >= kSubmitBatchSize) {
+      io_uring_submit(ring_);
+      unsubmitted_ = 0;
+    }
+  }
+  return length;
+}
+
+void UringFile::CloseForWriting() {}
+
+int64_t UringFile::Size() {
+  if (file_mode_ == "w" && !Drain())
+    return -1;
+  return size_;
+}
+
+bool UringFile::Flush() {
+  if (!ring_)
+    return !error_;
+  if (!Drain())
+    return false;
+  if (file_mode_ == "w" && fdatasync(fd_) != 0)
+    return false;
+  return true;
+}
+
+bool UringFile::Seek(uint64_t position) {
+  // All in-flight writes carry explicit offsets, but draining first keeps
+  // rewrites of the same range ordered.
+  if (file_mode_ == "w" && !Drain())
+    return false;
+  position_ = position;
+  return true;
+}
+
+bool UringFile::Tell(uint64_t* position) {
+  DCHECK(position);
+  *position = position_;
+  return true;
+}
+
+#else  // !defined(PACKAGER_ENABLE_IO_URING)
+
+bool UringFile::Open() {
+  LOG(ERROR) << "Shaka Packager was built without io_uring support; rebuild "
+                "with liburing to use uring:// files.";
+  return false;
+}
+
+bool UringFile::Close() {
+  delete this;
+  return false;
+}
+
+int64_t UringFile::Read(void* buffer, uint64_t length) {
+  UNUSED(buffer);
+  UNUSED(length);
+  return -1;
+}
+
+int64_t UringFile::Write(const void* buffer, uint64_t length) {
+  UNUSED(buffer);
+  UNUSED(length);
+  return -1;
+}
+
+void UringFile::CloseForWriting() {}
+
+int64_t UringFile::Size() {
+  return -1;
+}
+
+bool UringFile::Flush() {
+  return false;
+}
+
+bool UringFile::Seek(uint64_t position) {
+  UNUSED(position);
+  return false;
+}
+
+bool UringFile::Tell(uint64_t* position) {
+  UNUSED(position);
+  return false;
+}
+
+#endif  // defined(PACKAGER_ENABLE_IO_URING)
+
+}  // namespace shaka
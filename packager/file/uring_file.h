@@ -0,0 +1,84 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_FILE_URING_FILE_H_
+#define PACKAGER_FILE_URING_FILE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <packager/file.h>
+#include <packager/macros/classes.h>
+
+#if defined(PACKAGER_ENABLE_IO_URING)
+struct io_uring;
+#endif
+
+namespace shaka {
+
+/// Implements a local File backed by Linux io_uring. Writes are staged into
+/// registered buffers and submitted asynchronously with submission batching,
+/// so segment writes overlap with muxing without the per-write thread handoff
+/// (and extra memcpy) that ThreadedIoFile pays. Selected with the "uring://"
+/// prefix; only built when liburing is available, otherwise the prefix falls
+/// back to LocalFile.
+class UringFile : public File {
+ public:
+  /// @param file_name C string containing the name of the file to be accessed.
+  /// @param mode C string containing a file access mode. Only "r" and "w" are
+  ///        supported.
+  UringFile(const char* file_name, const char* mode);
+
+  /// @name File implementation overrides.
+  /// @{
+  bool Close() override;
+  int64_t Read(void* buffer, uint64_t length) override;
+  int64_t Write(const void* buffer, uint64_t length) override;
+  void CloseForWriting() override;
+  int64_t Size() override;
+  bool Flush() override;
+  bool Seek(uint64_t position) override;
+  bool Tell(uint64_t* position) override;
+  /// @}
+
+  /// @return true if io_uring support was compiled in.
+  static bool IsSupported();
+
+ protected:
+  ~UringFile() override;
+
+  bool Open() override;
+
+ private:
+#if defined(PACKAGER_ENABLE_IO_URING)
+  // Reap one completion, blocking if |wait| is true. Returns false on
+  // completion error (recorded in |error_|) or when nothing was reaped.
+  bool ReapCompletion(bool wait);
+  // Wait for all in-flight submissions to complete.
+  bool Drain();
+  // Acquire a free registered buffer index, draining completions as needed.
+  int AcquireBuffer();
+
+  io_uring* ring_ = nullptr;
+  int fd_ = -1;
+  uint64_t position_ = 0;
+  uint64_t size_ = 0;
+  size_t in_flight_ = 0;
+  size_t unsubmitted_ = 0;
+  bool error_ = false;
+  std::vector<std::vector<uint8_t>> write_buffers_;
+  std::vector<int> free_buffers_;
+#endif  // defined(PACKAGER_ENABLE_IO_URING)
+
+  std::string file_mode_;
+
+  DISALLOW_COPY_AND_ASSIGN(UringFile);
+};
+
+}  // namespace shaka
+
+#endif  // PACKAGER_FILE_URING_FILE_H_
@@ -100,6 +100,19 @@ class HlsNotifier {
   /// @return true on success, false otherwise.
   virtual bool Flush() = 0;
 
+  /// Defer playlist writes triggered by segment notifications until the next
+  /// WritePendingPlaylists() or Flush() call, so updates that arrive close
+  /// together are published in one write per playlist. The default
+  /// implementation ignores the hint; notifiers that publish inline keep
+  /// doing so.
+  virtual void SetPublishDeferred(bool /*deferred*/) {}
+
+  /// Write the playlists whose content changed since the last write. Only
+  /// meaningful with deferred publishing; the default implementation does
+  /// nothing.
+  /// @return true on success, false otherwise.
+  virtual bool WritePendingPlaylists() { return true; }
+
   /// @return The HLS parameters.
   const HlsParams& hls_params() const { return hls_params_; }
 
@@ -55,6 +55,28 @@ struct Variant {
   uint64_t avg_audio_bitrate = 0;
 };
 
+// Builds a cheap fingerprint of the inputs that can change the rendered
+// master playlist after startup: the set of streams, their codecs and the
+// bitrate values reported by each MediaPlaylist. Frame rate is included as it
+// is derived from the sample duration, which may not be known at the time of
+// the first write. Everything else rendered into the master playlist is fixed
+// at playlist creation, so matching fingerprints mean re-rendering the tags
+// would produce the same content.
+std::string GetPlaylistsFingerprint(
+    const std::string& base_url,
+    const std::list<MediaPlaylist*>& playlists) {
+  std::string fingerprint = base_url;
+  for (const MediaPlaylist* playlist : playlists) {
+    absl::StrAppendFormat(&fingerprint, "|%s,%d,%s,%s,%u,%u,%.5f",
+                          playlist->file_name(),
+                          static_cast<int>(playlist->stream_type()),
+                          playlist->codec(), playlist->language(),
+                          playlist->MaxBitrate(), playlist->AvgBitrate(),
+                          playlist->GetFrameRate());
+  }
+  return fingerprint;
+}
+
 uint64_t GetMaximumMaxBitrate(const std::list<const MediaPlaylist*> playlists) {
   uint64_t max = 0;
   for (const auto& playlist : playlists) {
@@ -553,6 +575,13 @@ bool MasterPlaylist::WriteMasterPlaylist(
     const std::string& base_url,
     const std::string& output_dir,
     const std::list<MediaPlaylist*>& playlists) {
+  // Skip re-rendering all the tags when nothing that feeds into the master
+  // playlist has changed since the last write. This is the common case for
+  // live updates, where the master playlist is re-notified on every segment.
+  std::string fingerprint = GetPlaylistsFingerprint(base_url, playlists);
+  if (!written_playlist_.empty() && fingerprint == written_fingerprint_)
+    return true;
+
   std::string content = "#EXTM3U\n";
   AppendVersionString(&content);
 
@@ -563,8 +592,10 @@ bool MasterPlaylist::WriteMasterPlaylist(
                   playlists, &content);
 
   // Skip if the playlist is already written.
-  if (content == written_playlist_)
+  if (content == written_playlist_) {
+    written_fingerprint_ = std::move(fingerprint);
     return true;
+  }
 
   auto file_path = std::filesystem::u8path(output_dir) / file_name_;
   if (!File::WriteFileAtomically(file_path.string().c_str(), content)) {
@@ -572,6 +603,7 @@ bool MasterPlaylist::WriteMasterPlaylist(
     return false;
   }
   written_playlist_ = content;
+  written_fingerprint_ = std::move(fingerprint);
   return true;
 }
 
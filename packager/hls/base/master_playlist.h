@@ -49,6 +49,9 @@ class MasterPlaylist {
   MasterPlaylist& operator=(const MasterPlaylist&) = delete;
 
   std::string written_playlist_;
+  // Fingerprint of the inputs |written_playlist_| was rendered from; when it
+  // matches, WriteMasterPlaylist() returns without re-rendering the tags.
+  std::string written_fingerprint_;
   const std::filesystem::path file_name_;
   const std::string default_audio_language_;
   const std::string default_text_language_;
@@ -22,6 +22,7 @@
 #include <packager/macros/logging.h>
 #include <packager/media/base/language_utils.h>
 #include <packager/media/base/muxer_util.h>
+#include <packager/media/base/object_pool.h>
 #include <packager/version/version.h>
 
 namespace shaka {
@@ -167,6 +168,17 @@ std::string CreatePlaylistHeader(
 
 class SegmentInfoEntry : public HlsEntry {
  public:
+  // Live playlists allocate one of these per segment and free one per
+  // segment evicted by SlideWindow(), indefinitely. Recycle the fixed-size
+  // slots through ObjectPool so a multi-day event reuses the DVR window's
+  // worth of slots instead of churning the global heap.
+  static void* operator new(size_t size) {
+    return media::ObjectPool<SegmentInfoEntry>::Allocate(size);
+  }
+  static void operator delete(void* ptr, size_t size) {
+    media::ObjectPool<SegmentInfoEntry>::Deallocate(ptr, size);
+  }
+
   // If |use_byte_range| true then this will append EXT-X-BYTERANGE
   // after EXTINF.
   // It uses |previous_segment_end_offset| to determine if it has to also
@@ -186,6 +198,7 @@ class SegmentInfoEntry : public HlsEntry {
   double duration_seconds() const { return duration_seconds_; }
   void set_duration_seconds(double duration_seconds) {
     duration_seconds_ = duration_seconds;
+    InvalidateCachedString();
   }
 
  private:
@@ -345,6 +358,14 @@ std::string PlacementOpportunityEntry::ToString() {
 HlsEntry::HlsEntry(HlsEntry::EntryType type) : type_(type) {}
 HlsEntry::~HlsEntry() {}
 
+const std::string& HlsEntry::GetCachedString() {
+  if (!cached_string_valid_) {
+    cached_string_ = ToString();
+    cached_string_valid_ = true;
+  }
+  return cached_string_;
+}
+
 MediaPlaylist::MediaPlaylist(const HlsParams& hls_params,
                              const std::string& file_name,
                              const std::string& name,
@@ -367,11 +388,11 @@ void MediaPlaylist::SetStreamTypeForTesting(
 }
 
 void MediaPlaylist::SetCodecForTesting(const std::string& codec) {
-  codec_ = codec;
+  codec_ = &InternString(codec);
 }
 
 void MediaPlaylist::SetLanguageForTesting(const std::string& language) {
-  language_ = language;
+  language_ = &InternString(language);
 }
 
 void MediaPlaylist::SetCharacteristicsForTesting(
@@ -392,18 +413,19 @@ bool MediaPlaylist::SetMediaInfo(const MediaInfo& media_info) {
 
   if (media_info.has_video_info()) {
     stream_type_ = MediaPlaylistStreamType::kVideo;
-    codec_ = AdjustVideoCodec(media_info.video_info().codec());
+    codec_ = &InternString(AdjustVideoCodec(media_info.video_info().codec()));
   } else if (media_info.has_audio_info()) {
     stream_type_ = MediaPlaylistStreamType::kAudio;
-    codec_ = media_info.audio_info().codec();
+    codec_ = &InternString(media_info.audio_info().codec());
   } else {
     stream_type_ = MediaPlaylistStreamType::kSubtitle;
-    codec_ = media_info.text_info().codec();
+    codec_ = &InternString(media_info.text_info().codec());
   }
 
   time_scale_ = time_scale;
   media_info_ = media_info;
-  language_ = GetLanguage(media_info);
+  cached_header_state_.reset();
+  language_ = &InternString(GetLanguage(media_info));
   use_byte_range_ = !media_info_.has_segment_template_url() &&
                     media_info_.container_type() != MediaInfo::CONTAINER_TEXT;
   characteristics_ =
@@ -416,8 +438,10 @@ bool MediaPlaylist::SetMediaInfo(const MediaInfo& media_info) {
 }
 
 void MediaPlaylist::SetSampleDuration(int32_t sample_duration) {
-  if (media_info_.has_video_info())
+  if (media_info_.has_video_info()) {
     media_info_.mutable_video_info()->set_frame_duration(sample_duration);
+    cached_header_state_.reset();
+  }
 }
 
 void MediaPlaylist::AddSegment(const std::string& file_name,
@@ -489,16 +513,43 @@ bool MediaPlaylist::WriteToFile(const std::filesystem::path& file_path) {
     SetTargetDuration(ceil(GetLongestSegmentDuration()));
   }
 
-  std::string content = CreatePlaylistHeader(
-      media_info_, target_duration_, hls_params_.playlist_type, stream_type_,
-      media_sequence_number_, discontinuity_sequence_number_,
-      hls_params_.start_time_offset);
+  const PlaylistHeaderState header_state = {stream_type_,
+                                            media_sequence_number_,
+                                            discontinuity_sequence_number_,
+                                            target_duration_};
+  if (!cached_header_state_.has_value() ||
+      cached_header_state_->stream_type != header_state.stream_type ||
+      cached_header_state_->media_sequence_number !=
+          header_state.media_sequence_number ||
+      cached_header_state_->discontinuity_sequence_number !=
+          header_state.discontinuity_sequence_number ||
+      cached_header_state_->target_duration != header_state.target_duration) {
+    cached_header_ = CreatePlaylistHeader(
+        media_info_, target_duration_, hls_params_.playlist_type, stream_type_,
+        media_sequence_number_, discontinuity_sequence_number_,
+        hls_params_.start_time_offset);
+    cached_header_state_ = header_state;
+  }
 
-  for (const auto& entry : entries_)
-    absl::StrAppendFormat(&content, "%s\n", entry->ToString().c_str());
+  constexpr char kEndList[] = "#EXT-X-ENDLIST\n";
+  const bool is_vod = hls_params_.playlist_type == HlsPlaylistType::kVod;
 
-  if (hls_params_.playlist_type == HlsPlaylistType::kVod) {
-    content += "#EXT-X-ENDLIST\n";
+  // Assemble the playlist from the cached pieces in a single allocation.
+  size_t content_size = cached_header_.size();
+  for (const auto& entry : entries_)
+    content_size += entry->GetCachedString().size() + 1;  // Trailing newline.
+  if (is_vod)
+    content_size += sizeof(kEndList) - 1;
+
+  std::string content;
+  content.reserve(content_size);
+  content.append(cached_header_);
+  for (const auto& entry : entries_) {
+    content.append(entry->GetCachedString());
+    content.push_back('\n');
+  }
+  if (is_vod) {
+    content += kEndList;
   }
 
   if (!File::WriteFileAtomically(file_path.string().c_str(), content)) {
@@ -569,7 +620,7 @@ bool MediaPlaylist::GetDisplayResolution(uint32_t* width,
 
 std::string MediaPlaylist::GetVideoRange() const {
   // Dolby Vision (dvh1 or dvhe) is always HDR.
-  if (codec_.find("dvh") == 0)
+  if (codec_->find("dvh") == 0)
     return "PQ";
 
   // HLS specification:
@@ -729,6 +780,9 @@ void MediaPlaylist::SlideWindow() {
   // Add key entries back.
   entries_.insert(entries_.begin(), std::make_move_iterator(ext_x_keys.begin()),
                   std::make_move_iterator(ext_x_keys.end()));
+  // Delete the files of all the segments that fell out of the preserved
+  // window in this slide in one pass.
+  DeleteOldSegments();
 }
 
 void MediaPlaylist::RemoveOldSegment(int64_t start_time) {
@@ -740,14 +794,14 @@ void MediaPlaylist::RemoveOldSegment(int64_t start_time) {
   segments_to_be_removed_.push_back(
       media::GetSegmentName(media_info_.segment_template(), start_time,
                             media_sequence_number_, media_info_.bandwidth()));
+}
+
+void MediaPlaylist::DeleteOldSegments() {
   while (segments_to_be_removed_.size() >
          hls_params_.preserved_segments_outside_live_window) {
-    VLOG(2) << "Deleting " << segments_to_be_removed_.front();
-    if (!File::Delete(segments_to_be_removed_.front().c_str())) {
-      LOG(WARNING) << "Failed to delete " << segments_to_be_removed_.front()
-                   << "; Will retry later.";
-      break;
-    }
+    // Deletion happens on a background thread so that a slow storage backend
+    // does not stall playlist updates.
+    segment_deleter_.Delete(segments_to_be_removed_.front());
     segments_to_be_removed_.pop_front();
   }
 }
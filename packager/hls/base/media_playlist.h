@@ -7,16 +7,20 @@
 #ifndef PACKAGER_HLS_BASE_MEDIA_PLAYLIST_H_
 #define PACKAGER_HLS_BASE_MEDIA_PLAYLIST_H_
 
+#include <deque>
 #include <filesystem>
 #include <list>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
+#include <packager/file/async_file_deleter.h>
 #include <packager/hls_params.h>
 #include <packager/macros/classes.h>
 #include <packager/mpd/base/bandwidth_estimator.h>
 #include <packager/mpd/base/media_info.pb.h>
+#include <packager/utils/string_interner.h>
 
 namespace shaka {
 
@@ -37,11 +41,22 @@ class HlsEntry {
   EntryType type() const { return type_; }
   virtual std::string ToString() = 0;
 
+  /// Same value as ToString(), but rendered at most once until the entry is
+  /// modified. Use this when serializing the playlist.
+  /// @return the rendered tag line(s) for this entry.
+  const std::string& GetCachedString();
+
  protected:
   explicit HlsEntry(EntryType type);
 
+  /// Invalidates the string cached by GetCachedString(). Subclasses must call
+  /// this from any mutator that affects ToString() output.
+  void InvalidateCachedString() { cached_string_valid_ = false; }
+
  private:
   EntryType type_;
+  std::string cached_string_;
+  bool cached_string_valid_ = false;
 };
 
 /// Methods are virtual for mocking.
@@ -79,7 +94,7 @@ class MediaPlaylist {
   const std::string& name() const { return name_; }
   const std::string& group_id() const { return group_id_; }
   MediaPlaylistStreamType stream_type() const { return stream_type_; }
-  const std::string& codec() const { return codec_; }
+  const std::string& codec() const { return *codec_; }
 
   /// For testing only.
   void SetStreamTypeForTesting(MediaPlaylistStreamType stream_type);
@@ -220,7 +235,7 @@ class MediaPlaylist {
 
   /// @return the language of the media, as an ISO language tag in its shortest
   ///         form.  May be an empty string for video.
-  const std::string& language() const { return language_; }
+  const std::string& language() const { return *language_; }
 
   const std::vector<std::string>& characteristics() const {
     return characteristics_;
@@ -250,10 +265,14 @@ class MediaPlaylist {
   // Remove elements from |entries_| for live profile. Increments
   // |sequence_number_| by the number of segments removed.
   void SlideWindow();
-  // Remove the segment specified by |start_time|. The actual deletion can
-  // happen at a later time depending on the value of
-  // |preserved_segment_outside_live_window| in |hls_params_|.
+  // Queue the segment specified by |start_time| for deletion. The actual
+  // deletion happens in DeleteOldSegments() and can be further delayed
+  // depending on the value of |preserved_segment_outside_live_window| in
+  // |hls_params_|.
   void RemoveOldSegment(int64_t start_time);
+  // Delete the files of queued segments that fell outside the preserved
+  // window. Called once per SlideWindow() rather than per removed segment.
+  void DeleteOldSegments();
 
   const HlsParams& hls_params_;
   // Mainly for MasterPlaylist to use these values.
@@ -264,8 +283,10 @@ class MediaPlaylist {
   MediaPlaylistStreamType stream_type_ = MediaPlaylistStreamType::kUnknown;
   // Whether to use byte range for SegmentInfoEntry.
   bool use_byte_range_ = false;
-  std::string codec_;
-  std::string language_;
+  // Interned (see InternString()): playlists of the same codec or language
+  // share one canonical copy of the string.
+  const std::string* codec_ = &InternString("");
+  const std::string* language_ = &InternString("");
   std::vector<std::string> characteristics_;
   bool forced_subtitle_ = false;
   uint32_t media_sequence_number_ = 0;
@@ -285,13 +306,28 @@ class MediaPlaylist {
   bool target_duration_set_ = false;
   int32_t target_duration_ = 0;
 
+  // The playlist header (everything before the media segment entries) only
+  // changes when one of these values changes. WriteToFile() caches the
+  // rendered header and rebuilds it when the current values no longer match;
+  // mutating |media_info_| resets the cache directly.
+  struct PlaylistHeaderState {
+    MediaPlaylistStreamType stream_type;
+    uint32_t media_sequence_number;
+    int discontinuity_sequence_number;
+    int32_t target_duration;
+  };
+  std::optional<PlaylistHeaderState> cached_header_state_;
+  std::string cached_header_;
+
   // TODO(kqyang): This could be managed better by a separate class, than having
   // all them managed in MediaPlaylist.
   std::list<std::unique_ptr<HlsEntry>> entries_;
   double current_buffer_depth_ = 0;
-  // A list to hold the file names of the segments to be removed temporarily.
-  // Once a file is actually removed, it is removed from the list.
-  std::list<std::string> segments_to_be_removed_;
+  // Holds the file names of the segments to be removed temporarily. Once a
+  // file is handed to |segment_deleter_|, it is removed from the queue.
+  std::deque<std::string> segments_to_be_removed_;
+  // Deletes expired segment files off the playlist update path.
+  AsyncFileDeleter segment_deleter_;
 
   // Used by kVideoIFrameOnly playlists to track the i-frames (key frames).
   struct KeyFrameInfo {
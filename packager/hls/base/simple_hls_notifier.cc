@@ -8,6 +8,7 @@
 
 #include <cmath>
 #include <filesystem>
+#include <map>
 #include <optional>
 
 #include <absl/flags/flag.h>
@@ -17,6 +18,7 @@
 #include <absl/strings/numbers.h>
 
 #include <packager/file/file_util.h>
+#include <packager/media/base/byte_codec.h>
 #include <packager/media/base/protection_system_ids.h>
 #include <packager/media/base/protection_system_specific_info.h>
 #include <packager/media/base/proto_json_util.h>
@@ -72,15 +74,24 @@ bool IsPlayReadySystemId(const std::vector<uint8_t>& system_id) {
 
 std::string Base64EncodeData(const std::string& prefix,
                              const std::string& data) {
-    std::string data_base64;
-    absl::Base64Escape(data, &data_base64);
-    return prefix + data_base64;
+    return prefix + media::EncodeBase64(data);
 }
 
 std::string VectorToString(const std::vector<uint8_t>& v) {
   return std::string(v.begin(), v.end());
 }
 
+// Key for the derived key-uri cache. A key rotation notifies every media
+// playlist with identical inputs, so the derived uri only depends on the
+// protection system, the key id and the protection system specific data. The
+// key id size is included to keep the concatenation unambiguous.
+std::string KeyUriCacheKey(const std::string& system,
+                           const std::vector<uint8_t>& key_id,
+                           const std::vector<uint8_t>& system_data) {
+  return system + ":" + std::to_string(key_id.size()) + ":" +
+         VectorToString(key_id) + VectorToString(system_data);
+}
+
 // Segment URL is relative to either output directory or the directory
 // containing the media playlist depends on whether base_url is set.
 std::string GenerateSegmentUrl(const std::string& segment_name,
@@ -159,12 +170,10 @@ bool WidevinePsshToJson(const std::vector<uint8_t>& pssh_box,
 
   // Place the current |key_id| to the front and converts all key_id to hex
   // format.
-  widevine_header.add_key_ids(absl::BytesToHexString(absl::string_view(
+  widevine_header.add_key_ids(media::EncodeLowerHex(std::string_view(
       reinterpret_cast<const char*>(key_id.data()), key_id.size())));
   for (const std::string& key_id_in_pssh : pssh_proto.key_id()) {
-    const std::string key_id_hex = absl::BytesToHexString(
-        absl::string_view(reinterpret_cast<const char*>(key_id_in_pssh.data()),
-                          key_id_in_pssh.size()));
+    const std::string key_id_hex = media::EncodeLowerHex(key_id_in_pssh);
     if (widevine_header.key_ids(0) != key_id_hex)
       widevine_header.add_key_ids(key_id_hex);
   }
@@ -198,13 +207,13 @@ void NotifyEncryptionToMediaPlaylist(
     MediaPlaylist* media_playlist) {
   std::string iv_string;
   if (!iv.empty()) {
-    iv_string =
-        "0x" + absl::BytesToHexString(absl::string_view(
-                   reinterpret_cast<const char*>(iv.data()), iv.size()));
+    iv_string = "0x" + media::EncodeLowerHex(std::string_view(
+                           reinterpret_cast<const char*>(iv.data()),
+                           iv.size()));
   }
   std::string key_id_string;
   if (!key_id.empty()) {
-    key_id_string = "0x" + absl::BytesToHexString(absl::string_view(
+    key_id_string = "0x" + media::EncodeLowerHex(std::string_view(
                                reinterpret_cast<const char*>(key_id.data()),
                                key_id.size()));
   }
@@ -221,27 +230,36 @@ bool HandleWidevineKeyFormats(
     const std::vector<uint8_t>& key_id,
     const std::vector<uint8_t>& iv,
     const std::vector<uint8_t>& protection_system_specific_data,
+    std::map<std::string, std::string>* key_uri_cache,
     MediaPlaylist* media_playlist) {
   if (absl::GetFlag(FLAGS_enable_legacy_widevine_hls_signaling) &&
       encryption_method == MediaPlaylist::EncryptionMethod::kSampleAes) {
     // This format allows SAMPLE-AES only.
-    std::string key_uri_data;
-    if (!WidevinePsshToJson(protection_system_specific_data, key_id,
-                            &key_uri_data)) {
-      return false;
+    std::string& legacy_key_uri_data_base64 = (*key_uri_cache)[KeyUriCacheKey(
+        "com.widevine", key_id, protection_system_specific_data)];
+    if (legacy_key_uri_data_base64.empty()) {
+      std::string key_uri_data;
+      if (!WidevinePsshToJson(protection_system_specific_data, key_id,
+                              &key_uri_data)) {
+        return false;
+      }
+      legacy_key_uri_data_base64 =
+          Base64EncodeData(kUriBase64Prefix, key_uri_data);
     }
-    std::string key_uri_data_base64 =
-        Base64EncodeData(kUriBase64Prefix, key_uri_data);
-    NotifyEncryptionToMediaPlaylist(encryption_method, key_uri_data_base64,
+    NotifyEncryptionToMediaPlaylist(encryption_method,
+                                    legacy_key_uri_data_base64,
                                     std::vector<uint8_t>(), iv, "com.widevine",
                                     "1", media_playlist);
   }
 
-  std::string pssh_as_string(
-      reinterpret_cast<const char*>(protection_system_specific_data.data()),
-      protection_system_specific_data.size());
-  std::string key_uri_data_base64 =
-      Base64EncodeData(kUriBase64Prefix, pssh_as_string);
+  std::string& key_uri_data_base64 = (*key_uri_cache)[KeyUriCacheKey(
+      kWidevineDashIfIopUUID, key_id, protection_system_specific_data)];
+  if (key_uri_data_base64.empty()) {
+    std::string pssh_as_string(
+        reinterpret_cast<const char*>(protection_system_specific_data.data()),
+        protection_system_specific_data.size());
+    key_uri_data_base64 = Base64EncodeData(kUriBase64Prefix, pssh_as_string);
+  }
   NotifyEncryptionToMediaPlaylist(encryption_method, key_uri_data_base64,
                                   key_id, iv, kWidevineDashIfIopUUID, "1",
                                   media_playlist);
@@ -285,6 +303,10 @@ SimpleHlsNotifier::SimpleHlsNotifier(const HlsParams& hls_params)
   master_playlist_.reset(new MasterPlaylist(
       master_playlist_path.filename(), default_audio_langauge,
       default_text_language, hls_params.is_independent_segments));
+  if (hls_params.generate_delta_feed &&
+      !hls_params.master_playlist_output.empty()) {
+    delta_log_.reset(new ManifestDeltaLog(hls_params.master_playlist_output));
+  }
 }
 
 SimpleHlsNotifier::~SimpleHlsNotifier() {}
@@ -334,6 +356,8 @@ bool SimpleHlsNotifier::NotifyNewStream(const MediaInfo& media_info,
   media_playlists_.push_back(media_playlist.get());
   stream_map_[*stream_id].reset(
       new StreamEntry{std::move(media_playlist), encryption_method});
+  if (delta_log_)
+    delta_log_->OnStreamAdded(*stream_id);
   return true;
 }
 
@@ -368,6 +392,8 @@ bool SimpleHlsNotifier::NotifyNewSegment(uint32_t stream_id,
                          master_playlist_dir_, media_playlist->file_name());
   media_playlist->AddSegment(segment_url, start_time, duration,
                              start_byte_offset, size);
+  if (delta_log_)
+    delta_log_->OnSegmentAdded(stream_id, start_time, duration, size);
 
   // Update target duration.
   int32_t longest_segment_duration =
@@ -381,6 +407,19 @@ bool SimpleHlsNotifier::NotifyNewSegment(uint32_t stream_id,
   // Update the playlists when there is new segments in live mode.
   if (hls_params().playlist_type == HlsPlaylistType::kLive ||
       hls_params().playlist_type == HlsPlaylistType::kEvent) {
+    if (publish_deferred_) {
+      // Only record which playlists changed; WritePendingPlaylists()
+      // publishes them in one pass, so updates that arrive close together
+      // coalesce into a single write per playlist.
+      if (target_duration_updated) {
+        for (MediaPlaylist* playlist : media_playlists_)
+          dirty_playlists_.insert(playlist);
+      } else {
+        dirty_playlists_.insert(media_playlist.get());
+      }
+      master_playlist_dirty_ = true;
+      return true;
+    }
     // Update all playlists if target duration is updated.
     if (target_duration_updated) {
       for (MediaPlaylist* playlist : media_playlists_) {
@@ -447,10 +486,12 @@ bool SimpleHlsNotifier::NotifyEncryptionUpdate(
       stream_iterator->second->encryption_method;
   LOG_IF(WARNING, encryption_method == MediaPlaylist::EncryptionMethod::kNone)
       << "Got encryption notification but the encryption method is NONE";
+  if (delta_log_)
+    delta_log_->OnKeyRotated(stream_id);
   if (IsWidevineSystemId(system_id)) {
-    return HandleWidevineKeyFormats(encryption_method,
-                                    key_id, iv, protection_system_specific_data,
-                                    media_playlist.get());
+    return HandleWidevineKeyFormats(encryption_method, key_id, iv,
+                                    protection_system_specific_data,
+                                    &key_uri_cache_, media_playlist.get());
   }
 
   // Key Id does not need to be specified with "identity" and "sdk".
@@ -461,8 +502,12 @@ bool SimpleHlsNotifier::NotifyEncryptionUpdate(
     if (key_uri.empty()) {
       // Use key_id as the key_uri. The player needs to have custom logic to
       // convert it to the actual key uri.
-      std::string key_uri_data = VectorToString(key_id);
-      key_uri = Base64EncodeData(kUriBase64Prefix, key_uri_data);
+      std::string& cached_key_uri =
+          key_uri_cache_[KeyUriCacheKey("identity", key_id, empty_key_id)];
+      if (cached_key_uri.empty())
+        cached_key_uri = Base64EncodeData(kUriBase64Prefix,
+                                          VectorToString(key_id));
+      key_uri = cached_key_uri;
     }
     NotifyEncryptionToMediaPlaylist(encryption_method, key_uri, empty_key_id,
                                     iv, "identity", "", media_playlist.get());
@@ -473,8 +518,12 @@ bool SimpleHlsNotifier::NotifyEncryptionUpdate(
     if (key_uri.empty()) {
       // Use key_id as the key_uri. The player needs to have custom logic to
       // convert it to the actual key uri.
-      std::string key_uri_data = VectorToString(key_id);
-      key_uri = Base64EncodeData(kUriFairPlayPrefix, key_uri_data);
+      std::string& cached_key_uri =
+          key_uri_cache_[KeyUriCacheKey("fairplay", key_id, empty_key_id)];
+      if (cached_key_uri.empty())
+        cached_key_uri = Base64EncodeData(kUriFairPlayPrefix,
+                                          VectorToString(key_id));
+      key_uri = cached_key_uri;
     }
 
     // FairPlay defines IV to be carried with the key, not the playlist.
@@ -485,14 +534,18 @@ bool SimpleHlsNotifier::NotifyEncryptionUpdate(
     return true;
   }
   if (IsPlayReadySystemId(system_id)) {
-    std::unique_ptr<media::PsshBoxBuilder> b =
-        media::PsshBoxBuilder::ParseFromBox(
-            protection_system_specific_data.data(),
-            protection_system_specific_data.size());
-    std::string pssh_data(reinterpret_cast<const char*>(b->pssh_data().data()),
-                          b->pssh_data().size());
-    std::string key_uri_data_base64 =
-        Base64EncodeData(kUriBase64Utf16Prefix, pssh_data);
+    std::string& key_uri_data_base64 = key_uri_cache_[KeyUriCacheKey(
+        "com.microsoft.playready", key_id, protection_system_specific_data)];
+    if (key_uri_data_base64.empty()) {
+      std::unique_ptr<media::PsshBoxBuilder> b =
+          media::PsshBoxBuilder::ParseFromBox(
+              protection_system_specific_data.data(),
+              protection_system_specific_data.size());
+      std::string pssh_data(
+          reinterpret_cast<const char*>(b->pssh_data().data()),
+          b->pssh_data().size());
+      key_uri_data_base64 = Base64EncodeData(kUriBase64Utf16Prefix, pssh_data);
+    }
     NotifyEncryptionToMediaPlaylist(encryption_method, key_uri_data_base64,
                                     empty_key_id, iv, "com.microsoft.playready",
                                     "1", media_playlist.get());
@@ -518,6 +571,37 @@ bool SimpleHlsNotifier::Flush() {
     LOG(ERROR) << "Failed to write master playlist.";
     return false;
   }
+  // Everything is current now; drop any pending deferred updates.
+  dirty_playlists_.clear();
+  master_playlist_dirty_ = false;
+  if (delta_log_)
+    delta_log_->OnManifestWritten();
+  return true;
+}
+
+void SimpleHlsNotifier::SetPublishDeferred(bool deferred) {
+  absl::MutexLock lock(&lock_);
+  publish_deferred_ = deferred;
+}
+
+bool SimpleHlsNotifier::WritePendingPlaylists() {
+  absl::MutexLock lock(&lock_);
+  for (MediaPlaylist* playlist : dirty_playlists_) {
+    playlist->SetTargetDuration(target_duration_);
+    if (!WriteMediaPlaylist(master_playlist_dir_, playlist))
+      return false;
+  }
+  dirty_playlists_.clear();
+  if (master_playlist_dirty_) {
+    if (!master_playlist_->WriteMasterPlaylist(
+            hls_params().base_url, master_playlist_dir_, media_playlists_)) {
+      LOG(ERROR) << "Failed to write master playlist.";
+      return false;
+    }
+    master_playlist_dirty_ = false;
+  }
+  if (delta_log_)
+    delta_log_->OnManifestWritten();
   return true;
 }
 
@@ -10,6 +10,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -20,6 +21,7 @@
 #include <packager/hls/base/media_playlist.h>
 #include <packager/hls_params.h>
 #include <packager/macros/classes.h>
+#include <packager/mpd/base/manifest_delta_log.h>
 
 namespace shaka {
 namespace hls {
@@ -70,6 +72,8 @@ class SimpleHlsNotifier : public HlsNotifier {
       const std::vector<uint8_t>& iv,
       const std::vector<uint8_t>& protection_system_specific_data) override;
   bool Flush() override;
+  void SetPublishDeferred(bool deferred) override;
+  bool WritePendingPlaylists() override;
   /// }@
 
  private:
@@ -85,6 +89,8 @@ class SimpleHlsNotifier : public HlsNotifier {
 
   std::unique_ptr<MediaPlaylistFactory> media_playlist_factory_;
   std::unique_ptr<MasterPlaylist> master_playlist_;
+  // Binary feed of playlist changes; null unless enabled in HlsParams.
+  std::unique_ptr<ManifestDeltaLog> delta_log_;
 
   // Maps to unique_ptr because StreamEntry also holds unique_ptr
   std::map<uint32_t, std::unique_ptr<StreamEntry>> stream_map_;
@@ -92,6 +98,19 @@ class SimpleHlsNotifier : public HlsNotifier {
 
   uint32_t sequence_number_ = 0;
 
+  // Deferred publishing (see SetPublishDeferred): live playlist updates are
+  // collected here instead of being written inline, and published by the
+  // next WritePendingPlaylists() or Flush() call.
+  bool publish_deferred_ = false;
+  std::set<MediaPlaylist*> dirty_playlists_;
+  bool master_playlist_dirty_ = false;
+
+  // Caches key uris derived in NotifyEncryptionUpdate, keyed by (protection
+  // system, key id, protection system specific data). A key rotation notifies
+  // every media playlist with identical inputs, so the base64/proto
+  // conversions run once per rotation instead of once per playlist.
+  std::map<std::string, std::string> key_uri_cache_;
+
   absl::Mutex lock_;
 
   DISALLOW_COPY_AND_ASSIGN(SimpleHlsNotifier);
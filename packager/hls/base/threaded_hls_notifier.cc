@@ -0,0 +1,203 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/hls/base/threaded_hls_notifier.h>
+
+#include <functional>
+#include <utility>
+
+#include <absl/log/check.h>
+#include <absl/log/log.h>
+
+#include <packager/file/thread_pool.h>
+
+namespace shaka {
+namespace hls {
+
+ThreadedHlsNotifier::ThreadedHlsNotifier(const HlsParams& hls_params,
+                                         std::unique_ptr<HlsNotifier> notifier)
+    : HlsNotifier(hls_params), notifier_(std::move(notifier)) {
+  DCHECK(notifier_);
+}
+
+ThreadedHlsNotifier::~ThreadedHlsNotifier() {
+  {
+    absl::MutexLock lock(&mutex_);
+    stopped_ = true;
+  }
+  if (started_)
+    task_exit_event_.WaitForNotification();
+}
+
+bool ThreadedHlsNotifier::Init() {
+  DCHECK(!started_);
+  if (!notifier_->Init())
+    return false;
+  // The wrapped notifier collects playlist updates instead of writing them
+  // inline; ProcessEventsTask() publishes them once per drained batch.
+  notifier_->SetPublishDeferred(true);
+  started_ = true;
+  ThreadPool::instance.PostTask(
+      std::bind(&ThreadedHlsNotifier::ProcessEventsTask, this));
+  return true;
+}
+
+bool ThreadedHlsNotifier::NotifyNewStream(const MediaInfo& media_info,
+                                          const std::string& playlist_name,
+                                          const std::string& stream_name,
+                                          const std::string& group_id,
+                                          uint32_t* stream_id) {
+  if (!WaitUntilIdle())
+    return false;
+  return notifier_->NotifyNewStream(media_info, playlist_name, stream_name,
+                                    group_id, stream_id);
+}
+
+bool ThreadedHlsNotifier::NotifySampleDuration(uint32_t stream_id,
+                                               int32_t sample_duration) {
+  if (!WaitUntilIdle())
+    return false;
+  return notifier_->NotifySampleDuration(stream_id, sample_duration);
+}
+
+bool ThreadedHlsNotifier::NotifyNewSegment(uint32_t stream_id,
+                                           const std::string& segment_name,
+                                           int64_t start_time,
+                                           int64_t duration,
+                                           uint64_t start_byte_offset,
+                                           uint64_t size) {
+  Event event;
+  event.type = Event::Type::kNewSegment;
+  event.stream_id = stream_id;
+  event.segment_name = segment_name;
+  event.start_time = start_time;
+  event.duration = duration;
+  event.start_byte_offset = start_byte_offset;
+  event.size = size;
+  return PostEvent(std::move(event));
+}
+
+bool ThreadedHlsNotifier::NotifyKeyFrame(uint32_t stream_id,
+                                         int64_t timestamp,
+                                         uint64_t start_byte_offset,
+                                         uint64_t size) {
+  Event event;
+  event.type = Event::Type::kKeyFrame;
+  event.stream_id = stream_id;
+  event.timestamp = timestamp;
+  event.start_byte_offset = start_byte_offset;
+  event.size = size;
+  return PostEvent(std::move(event));
+}
+
+bool ThreadedHlsNotifier::NotifyCueEvent(uint32_t stream_id,
+                                         int64_t timestamp) {
+  Event event;
+  event.type = Event::Type::kCueEvent;
+  event.stream_id = stream_id;
+  event.timestamp = timestamp;
+  return PostEvent(std::move(event));
+}
+
+bool ThreadedHlsNotifier::NotifyEncryptionUpdate(
+    uint32_t stream_id,
+    const std::vector<uint8_t>& key_id,
+    const std::vector<uint8_t>& system_id,
+    const std::vector<uint8_t>& iv,
+    const std::vector<uint8_t>& protection_system_specific_data) {
+  if (!WaitUntilIdle())
+    return false;
+  return notifier_->NotifyEncryptionUpdate(stream_id, key_id, system_id, iv,
+                                           protection_system_specific_data);
+}
+
+bool ThreadedHlsNotifier::Flush() {
+  Event event;
+  event.type = Event::Type::kFlush;
+  return PostEvent(std::move(event));
+}
+
+bool ThreadedHlsNotifier::WaitUntilIdle() {
+  absl::MutexLock lock(&mutex_);
+  mutex_.Await(absl::Condition(this, &ThreadedHlsNotifier::IsIdle));
+  return success_;
+}
+
+bool ThreadedHlsNotifier::IsIdle() const {
+  return events_.empty() && !processing_;
+}
+
+bool ThreadedHlsNotifier::HasWork() const {
+  return stopped_ || !events_.empty();
+}
+
+bool ThreadedHlsNotifier::PostEvent(Event event) {
+  DCHECK(started_);
+  absl::MutexLock lock(&mutex_);
+  events_.push_back(std::move(event));
+  return success_;
+}
+
+void ThreadedHlsNotifier::ProcessEventsTask() {
+  std::deque<Event> batch;
+  while (true) {
+    {
+      absl::MutexLock lock(&mutex_);
+      mutex_.Await(absl::Condition(this, &ThreadedHlsNotifier::HasWork));
+      if (events_.empty()) {
+        DCHECK(stopped_);
+        break;
+      }
+      events_.swap(batch);
+      processing_ = true;
+    }
+
+    // Apply the batch outside the lock so new events can be enqueued without
+    // waiting for playlist writes. With deferred publishing the wrapped
+    // notifier only records which playlists changed; they are written once
+    // after the whole batch, so updates coalesce into one write per playlist
+    // per drain pass. A Flush in the batch writes everything anyway and
+    // replaces the pending-playlists pass.
+    bool batch_success = true;
+    bool flush_requested = false;
+    for (const Event& event : batch) {
+      switch (event.type) {
+        case Event::Type::kNewSegment:
+          batch_success &= notifier_->NotifyNewSegment(
+              event.stream_id, event.segment_name, event.start_time,
+              event.duration, event.start_byte_offset, event.size);
+          break;
+        case Event::Type::kKeyFrame:
+          batch_success &=
+              notifier_->NotifyKeyFrame(event.stream_id, event.timestamp,
+                                        event.start_byte_offset, event.size);
+          break;
+        case Event::Type::kCueEvent:
+          batch_success &=
+              notifier_->NotifyCueEvent(event.stream_id, event.timestamp);
+          break;
+        case Event::Type::kFlush:
+          flush_requested = true;
+          break;
+      }
+    }
+    if (flush_requested)
+      batch_success &= notifier_->Flush();
+    else
+      batch_success &= notifier_->WritePendingPlaylists();
+    if (!batch_success)
+      LOG(ERROR) << "Failed to apply HLS notifications.";
+    batch.clear();
+
+    absl::MutexLock lock(&mutex_);
+    processing_ = false;
+    success_ &= batch_success;
+  }
+  task_exit_event_.Notify();
+}
+
+}  // namespace hls
+}  // namespace shaka
@@ -0,0 +1,137 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_HLS_BASE_THREADED_HLS_NOTIFIER_H_
+#define PACKAGER_HLS_BASE_THREADED_HLS_NOTIFIER_H_
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <absl/base/thread_annotations.h>
+#include <absl/synchronization/mutex.h>
+#include <absl/synchronization/notification.h>
+
+#include <packager/hls/base/hls_notifier.h>
+
+namespace shaka {
+namespace hls {
+
+/// An HlsNotifier decorator which moves per-segment notifications and playlist
+/// writes off the caller's thread, the HLS counterpart of ThreadedMpdNotifier.
+/// Muxer threads enqueue segment events, which a single background thread
+/// applies to the wrapped notifier with deferred publishing enabled; after
+/// each drained batch the changed playlists are written once, so updates that
+/// arrive close together coalesce into one write per playlist. Running the
+/// publishes on their own task also overlaps them with MPD writes when both
+/// manifests are generated.
+///
+/// Setup and teardown notifications (new stream, sample duration, encryption
+/// updates) are forwarded synchronously after the pending events have
+/// drained, so the wrapped notifier observes all notifications in call order.
+class ThreadedHlsNotifier : public HlsNotifier {
+ public:
+  /// @param hls_params contains parameters for setting up the notifier.
+  /// @param notifier is the notifier that actually maintains the playlists.
+  ///        It must not be used directly while this object is alive.
+  ThreadedHlsNotifier(const HlsParams& hls_params,
+                      std::unique_ptr<HlsNotifier> notifier);
+  ~ThreadedHlsNotifier() override;
+
+  /// @name HlsNotifier implementation overrides.
+  /// NotifyNewSegment(), NotifyKeyFrame(), NotifyCueEvent() and Flush() are
+  /// asynchronous: they enqueue the notification and report whether all
+  /// notifications processed so far have succeeded. Use WaitUntilIdle() to
+  /// wait for the outcome of pending notifications.
+  /// @{
+  bool Init() override;
+  bool NotifyNewStream(const MediaInfo& media_info,
+                       const std::string& playlist_name,
+                       const std::string& stream_name,
+                       const std::string& group_id,
+                       uint32_t* stream_id) override;
+  bool NotifySampleDuration(uint32_t stream_id,
+                            int32_t sample_duration) override;
+  bool NotifyNewSegment(uint32_t stream_id,
+                        const std::string& segment_name,
+                        int64_t start_time,
+                        int64_t duration,
+                        uint64_t start_byte_offset,
+                        uint64_t size) override;
+  bool NotifyKeyFrame(uint32_t stream_id,
+                      int64_t timestamp,
+                      uint64_t start_byte_offset,
+                      uint64_t size) override;
+  bool NotifyCueEvent(uint32_t stream_id, int64_t timestamp) override;
+  bool NotifyEncryptionUpdate(
+      uint32_t stream_id,
+      const std::vector<uint8_t>& key_id,
+      const std::vector<uint8_t>& system_id,
+      const std::vector<uint8_t>& iv,
+      const std::vector<uint8_t>& protection_system_specific_data) override;
+  bool Flush() override;
+  /// @}
+
+  /// Blocks until all enqueued notifications have been applied to the wrapped
+  /// notifier.
+  /// @return true if every notification processed so far has succeeded.
+  bool WaitUntilIdle();
+
+ private:
+  ThreadedHlsNotifier(const ThreadedHlsNotifier&) = delete;
+  ThreadedHlsNotifier& operator=(const ThreadedHlsNotifier&) = delete;
+
+  struct Event {
+    enum class Type {
+      kNewSegment,
+      kKeyFrame,
+      kCueEvent,
+      kFlush,
+    };
+
+    Type type;
+    uint32_t stream_id = 0;
+    std::string segment_name;
+    int64_t start_time = 0;
+    int64_t duration = 0;
+    uint64_t start_byte_offset = 0;
+    uint64_t size = 0;
+    int64_t timestamp = 0;
+  };
+
+  // Enqueues |event| for the processing thread. Returns the sticky success
+  // state, i.e. whether all notifications processed so far have succeeded.
+  bool PostEvent(Event event);
+
+  // Condition predicates for |mutex_|.
+  bool IsIdle() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  bool HasWork() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Runs on a ThreadPool thread. Repeatedly drains the queue, applies the
+  // batched events to |notifier_| and publishes the changed playlists until
+  // the destructor stops it and the queue is empty.
+  void ProcessEventsTask();
+
+  std::unique_ptr<HlsNotifier> notifier_;
+
+  absl::Mutex mutex_;
+  std::deque<Event> events_ ABSL_GUARDED_BY(mutex_);
+  // True while the processing thread is applying a drained batch.
+  bool processing_ ABSL_GUARDED_BY(mutex_) = false;
+  bool stopped_ ABSL_GUARDED_BY(mutex_) = false;
+  // False if any notification applied by the processing thread has failed.
+  bool success_ ABSL_GUARDED_BY(mutex_) = true;
+
+  bool started_ = false;
+  absl::Notification task_exit_event_;
+};
+
+}  // namespace hls
+}  // namespace shaka
+
+#endif  // PACKAGER_HLS_BASE_THREADED_HLS_NOTIFIER_H_
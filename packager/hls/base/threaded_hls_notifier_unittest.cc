@@ -0,0 +1,192 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/hls/base/threaded_hls_notifier.h>
+
+#include <memory>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace shaka {
+namespace hls {
+
+using ::testing::AtMost;
+using ::testing::Between;
+using ::testing::Return;
+
+namespace {
+
+const uint32_t kStreamId = 1;
+const char kSegmentName[] = "memory://test/segment-1.mp4";
+const int64_t kStartTime = 100;
+const int64_t kDuration = 50;
+const uint64_t kSize = 12345;
+
+class MockHlsNotifier : public HlsNotifier {
+ public:
+  explicit MockHlsNotifier(const HlsParams& hls_params)
+      : HlsNotifier(hls_params) {}
+
+  MOCK_METHOD(bool, Init, (), (override));
+  MOCK_METHOD(bool,
+              NotifyNewStream,
+              (const MediaInfo& media_info,
+               const std::string& playlist_name,
+               const std::string& stream_name,
+               const std::string& group_id,
+               uint32_t* stream_id),
+              (override));
+  MOCK_METHOD(bool,
+              NotifySampleDuration,
+              (uint32_t stream_id, int32_t sample_duration),
+              (override));
+  MOCK_METHOD(bool,
+              NotifyNewSegment,
+              (uint32_t stream_id,
+               const std::string& segment_name,
+               int64_t start_time,
+               int64_t duration,
+               uint64_t start_byte_offset,
+               uint64_t size),
+              (override));
+  MOCK_METHOD(bool,
+              NotifyKeyFrame,
+              (uint32_t stream_id,
+               int64_t timestamp,
+               uint64_t start_byte_offset,
+               uint64_t size),
+              (override));
+  MOCK_METHOD(bool,
+              NotifyCueEvent,
+              (uint32_t stream_id, int64_t timestamp),
+              (override));
+  MOCK_METHOD(bool,
+              NotifyEncryptionUpdate,
+              (uint32_t stream_id,
+               const std::vector<uint8_t>& key_id,
+               const std::vector<uint8_t>& system_id,
+               const std::vector<uint8_t>& iv,
+               const std::vector<uint8_t>& protection_system_specific_data),
+              (override));
+  MOCK_METHOD(bool, Flush, (), (override));
+  MOCK_METHOD(void, SetPublishDeferred, (bool deferred), (override));
+  MOCK_METHOD(bool, WritePendingPlaylists, (), (override));
+};
+
+}  // namespace
+
+class ThreadedHlsNotifierTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    auto mock_notifier = std::make_unique<MockHlsNotifier>(hls_params_);
+    mock_notifier_ = mock_notifier.get();
+    notifier_.reset(
+        new ThreadedHlsNotifier(hls_params_, std::move(mock_notifier)));
+
+    EXPECT_CALL(*mock_notifier_, Init()).WillOnce(Return(true));
+    EXPECT_CALL(*mock_notifier_, SetPublishDeferred(true));
+    ASSERT_TRUE(notifier_->Init());
+  }
+
+  HlsParams hls_params_;
+  // Owned by |notifier_|.
+  MockHlsNotifier* mock_notifier_ = nullptr;
+  std::unique_ptr<ThreadedHlsNotifier> notifier_;
+};
+
+TEST_F(ThreadedHlsNotifierTest, ForwardsSegmentEvents) {
+  EXPECT_CALL(*mock_notifier_,
+              NotifyNewSegment(kStreamId, kSegmentName, kStartTime, kDuration,
+                               0u, kSize))
+      .WillOnce(Return(true));
+  EXPECT_CALL(*mock_notifier_, NotifyKeyFrame(kStreamId, kStartTime, 0u, kSize))
+      .WillOnce(Return(true));
+  EXPECT_CALL(*mock_notifier_, NotifyCueEvent(kStreamId, kStartTime))
+      .WillOnce(Return(true));
+  EXPECT_CALL(*mock_notifier_, WritePendingPlaylists())
+      .Times(Between(1, 3))
+      .WillRepeatedly(Return(true));
+
+  EXPECT_TRUE(notifier_->NotifyNewSegment(kStreamId, kSegmentName, kStartTime,
+                                          kDuration, 0, kSize));
+  EXPECT_TRUE(notifier_->NotifyKeyFrame(kStreamId, kStartTime, 0, kSize));
+  EXPECT_TRUE(notifier_->NotifyCueEvent(kStreamId, kStartTime));
+  EXPECT_TRUE(notifier_->WaitUntilIdle());
+}
+
+TEST_F(ThreadedHlsNotifierTest, CoalescesPlaylistWrites) {
+  const int kNumSegments = 100;
+  EXPECT_CALL(*mock_notifier_,
+              NotifyNewSegment(kStreamId, kSegmentName, ::testing::_, kDuration,
+                               0u, kSize))
+      .Times(kNumSegments)
+      .WillRepeatedly(Return(true));
+  // Segments pending in one drain pass publish with a single
+  // WritePendingPlaylists, so there are at most as many writes as segments
+  // and at least one.
+  EXPECT_CALL(*mock_notifier_, WritePendingPlaylists())
+      .Times(Between(1, kNumSegments))
+      .WillRepeatedly(Return(true));
+
+  for (int i = 0; i < kNumSegments; ++i) {
+    EXPECT_TRUE(notifier_->NotifyNewSegment(kStreamId, kSegmentName,
+                                            i * kDuration, kDuration, 0,
+                                            kSize));
+  }
+  EXPECT_TRUE(notifier_->WaitUntilIdle());
+}
+
+TEST_F(ThreadedHlsNotifierTest, FlushReplacesPendingPlaylistsPass) {
+  EXPECT_CALL(*mock_notifier_,
+              NotifyNewSegment(kStreamId, kSegmentName, kStartTime, kDuration,
+                               0u, kSize))
+      .WillOnce(Return(true));
+  EXPECT_CALL(*mock_notifier_, Flush()).WillOnce(Return(true));
+  // The batch containing the Flush must not also write pending playlists,
+  // but the segment may land in an earlier drain pass of its own.
+  EXPECT_CALL(*mock_notifier_, WritePendingPlaylists())
+      .Times(AtMost(1))
+      .WillRepeatedly(Return(true));
+
+  EXPECT_TRUE(notifier_->NotifyNewSegment(kStreamId, kSegmentName, kStartTime,
+                                          kDuration, 0, kSize));
+  EXPECT_TRUE(notifier_->Flush());
+  EXPECT_TRUE(notifier_->WaitUntilIdle());
+}
+
+TEST_F(ThreadedHlsNotifierTest, SynchronousNotificationsDrainPendingEvents) {
+  ::testing::InSequence sequence;
+  EXPECT_CALL(*mock_notifier_,
+              NotifyNewSegment(kStreamId, kSegmentName, kStartTime, kDuration,
+                               0u, kSize))
+      .WillOnce(Return(true));
+  EXPECT_CALL(*mock_notifier_, WritePendingPlaylists()).WillOnce(Return(true));
+  EXPECT_CALL(*mock_notifier_, NotifySampleDuration(kStreamId, kDuration))
+      .WillOnce(Return(true));
+
+  EXPECT_TRUE(notifier_->NotifyNewSegment(kStreamId, kSegmentName, kStartTime,
+                                          kDuration, 0, kSize));
+  // The synchronous notification must observe the queued segment first.
+  EXPECT_TRUE(
+      notifier_->NotifySampleDuration(kStreamId, static_cast<int32_t>(kDuration)));
+}
+
+TEST_F(ThreadedHlsNotifierTest, ReportsFailure) {
+  EXPECT_CALL(*mock_notifier_,
+              NotifyNewSegment(kStreamId, kSegmentName, kStartTime, kDuration,
+                               0u, kSize))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*mock_notifier_, WritePendingPlaylists())
+      .WillRepeatedly(Return(true));
+
+  notifier_->NotifyNewSegment(kStreamId, kSegmentName, kStartTime, kDuration,
+                              0, kSize);
+  EXPECT_FALSE(notifier_->WaitUntilIdle());
+}
+
+}  // namespace hls
+}  // namespace shaka
@@ -46,6 +46,19 @@ class AesCryptor {
     return plaintext_size;
   }
 
+  /// A contiguous byte range for the batched form of Crypt below.
+  struct CryptSpan {
+    /// Input text.
+    const uint8_t* text = nullptr;
+    size_t text_size = 0;
+    /// Output text. Can be the same address as @a text for in place
+    /// encryption/decryption.
+    uint8_t* crypt_text = nullptr;
+    /// Contains the capacity of @a crypt_text on input; updated to the actual
+    /// output size on success.
+    size_t crypt_text_size = 0;
+  };
+
   /// @name Various forms of crypt (Encrypt/Decrypt) calls.
   /// It is an Encrypt function for encryptor and a Decrypt function for
   /// decryptor. The text and crypt_text pointers can be the same address for
@@ -69,8 +82,34 @@ class AesCryptor {
       num_crypt_bytes_ += text_size;
     return CryptInternal(text, text_size, crypt_text, crypt_text_size);
   }
+  /// Crypt @a num_spans spans in one call, e.g. all protected subsamples of a
+  /// sample. Each span behaves exactly as an individual Crypt call would, so
+  /// constant-iv cryptors restart from iv() per span, while counter and
+  /// chaining modes carry their state from one span into the next. Batching
+  /// lets callers pay the per-call overhead once per sample instead of once
+  /// per subsample.
+  bool Crypt(CryptSpan* spans, size_t num_spans) {
+    for (size_t i = 0; i < num_spans; ++i) {
+      if (!Crypt(spans[i].text, spans[i].text_size, spans[i].crypt_text,
+                 &spans[i].crypt_text_size)) {
+        return false;
+      }
+    }
+    return true;
+  }
   /// @}
 
+  /// @return true if the cryptor can reproduce its cipher state at a span
+  ///         boundary without crypting the bytes, so the spans of one batched
+  ///         Crypt call may be split across cryptor clones using SkipSpan.
+  virtual bool SupportsSpanSkip() const { return use_constant_iv(); }
+
+  /// Advance the cipher state exactly as a Crypt call over @a text_size bytes
+  /// would, without reading or writing any text. Only valid when
+  /// SupportsSpanSkip() returns true.
+  /// @return true on success.
+  virtual bool SkipSpan(size_t text_size);
+
   /// Set IV. SetIv() implementation guarantees that the iv passed to SetIv()
   /// is set to iv() and then calls SetIvInternal().
   /// @return true if successful, false if the input is invalid.
@@ -81,6 +120,12 @@ class AesCryptor {
   /// This is used by encryptors only. It is a NOP if using kUseConstantIv.
   void UpdateIv();
 
+  /// Account for @a size bytes of text as if they had been crypted, so a
+  /// subsequent UpdateIv() advances the iv chain exactly as if Crypt had been
+  /// called. Used when the actual crypt is delegated to another cryptor (e.g.
+  /// a worker-owned clone) while this instance remains the iv source.
+  void AddCryptedBytes(size_t size) { num_crypt_bytes_ += size; }
+
   /// @return The current iv.
   const std::vector<uint8_t>& iv() const { return iv_; }
 
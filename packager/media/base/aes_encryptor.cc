@@ -6,11 +6,25 @@
 
 #include <packager/media/base/aes_encryptor.h>
 
+#include <algorithm>
+
 #include <absl/log/check.h>
 #include <absl/log/log.h>
 
 #include <packager/macros/crypto.h>
 
+// Vectorized keystream xor for counter mode. SSE2 is part of the x86-64
+// baseline and NEON is part of the AArch64 baseline, so no runtime CPU
+// dispatch is needed on either.
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PACKAGER_HAS_XOR_SIMD 1
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+#include <arm_neon.h>
+#define PACKAGER_HAS_XOR_SIMD 1
+#endif
+
 namespace {
 
 // Increment an 8-byte counter by 1. Return true if overflowed.
@@ -23,6 +37,105 @@ bool Increment64(uint8_t* counter) {
   return true;
 }
 
+// Add |addend| to an 8-byte big-endian counter. Overflow wraps around, as it
+// does with repeated Increment64 calls.
+void AddToCounter64(uint8_t* counter, uint64_t addend) {
+  DCHECK(counter);
+  for (int i = 7; i >= 0 && addend != 0; --i) {
+    addend += counter[i];
+    counter[i] = static_cast<uint8_t>(addend);
+    addend >>= 8;
+  }
+}
+
+// Xors |size| bytes of |keystream| into |plaintext|, writing the result to
+// |ciphertext|. |size| must be a multiple of AES_BLOCK_SIZE; none of the
+// pointers need to be aligned.
+#if defined(PACKAGER_HAS_XOR_SIMD)
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+
+void XorKeystream(const uint8_t* plaintext,
+                  const uint8_t* keystream,
+                  size_t size,
+                  uint8_t* ciphertext) {
+  size_t i = 0;
+  for (; i + 4 * AES_BLOCK_SIZE <= size; i += 4 * AES_BLOCK_SIZE) {
+    for (size_t j = i; j < i + 4 * AES_BLOCK_SIZE; j += AES_BLOCK_SIZE) {
+      const __m128i text =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(plaintext + j));
+      const __m128i stream =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(keystream + j));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(ciphertext + j),
+                       _mm_xor_si128(text, stream));
+    }
+  }
+  for (; i < size; i += AES_BLOCK_SIZE) {
+    const __m128i text =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(plaintext + i));
+    const __m128i stream =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(keystream + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(ciphertext + i),
+                     _mm_xor_si128(text, stream));
+  }
+}
+
+#else  // NEON
+
+void XorKeystream(const uint8_t* plaintext,
+                  const uint8_t* keystream,
+                  size_t size,
+                  uint8_t* ciphertext) {
+  size_t i = 0;
+  for (; i + 4 * AES_BLOCK_SIZE <= size; i += 4 * AES_BLOCK_SIZE) {
+    for (size_t j = i; j < i + 4 * AES_BLOCK_SIZE; j += AES_BLOCK_SIZE) {
+      vst1q_u8(ciphertext + j,
+               veorq_u8(vld1q_u8(plaintext + j), vld1q_u8(keystream + j)));
+    }
+  }
+  for (; i < size; i += AES_BLOCK_SIZE) {
+    vst1q_u8(ciphertext + i,
+             veorq_u8(vld1q_u8(plaintext + i), vld1q_u8(keystream + i)));
+  }
+}
+
+#endif
+
+#else  // !defined(PACKAGER_HAS_XOR_SIMD)
+
+// Word-sized scalar fallback. memcpy is used for the loads and stores as the
+// pointers are not necessarily aligned; it compiles down to plain word
+// accesses.
+void XorKeystream(const uint8_t* plaintext,
+                  const uint8_t* keystream,
+                  size_t size,
+                  uint8_t* ciphertext) {
+  size_t i = 0;
+  while (size - i >= 4 * AES_BLOCK_SIZE) {
+    uint64_t text[8];
+    uint64_t stream[8];
+    memcpy(text, plaintext + i, 4 * AES_BLOCK_SIZE);
+    memcpy(stream, keystream + i, 4 * AES_BLOCK_SIZE);
+    for (int j = 0; j < 8; ++j)
+      text[j] ^= stream[j];
+    memcpy(ciphertext + i, text, 4 * AES_BLOCK_SIZE);
+    i += 4 * AES_BLOCK_SIZE;
+  }
+  while (size - i >= AES_BLOCK_SIZE) {
+    uint64_t text[2];
+    uint64_t stream[2];
+    memcpy(text, plaintext + i, AES_BLOCK_SIZE);
+    memcpy(stream, keystream + i, AES_BLOCK_SIZE);
+    text[0] ^= stream[0];
+    text[1] ^= stream[1];
+    memcpy(ciphertext + i, text, AES_BLOCK_SIZE);
+    i += AES_BLOCK_SIZE;
+  }
+}
+
+#endif  // defined(PACKAGER_HAS_XOR_SIMD)
+
 }  // namespace
 
 namespace shaka {
@@ -68,28 +181,91 @@ bool AesCtrEncryptor::CryptInternal(const uint8_t* plaintext,
   }
   *ciphertext_size = plaintext_size;
 
-  for (size_t i = 0; i < plaintext_size; ++i) {
-    if (block_offset_ == 0) {
-      size_t ignored_output_size;
-      CHECK_EQ(
-          mbedtls_cipher_crypt(&cipher_ctx_, /* iv= */ NULL, /* iv_len= */ 0,
-                               &counter_[0], AES_BLOCK_SIZE,
-                               &encrypted_counter_[0], &ignored_output_size),
-          0);
-
-      // As mentioned in ISO/IEC 23001-7:2016 CENC spec, of the 16 byte counter
-      // block, bytes 8 to 15 (i.e. the least significant bytes) are used as a
-      // simple 64 bit unsigned integer that is incremented by one for each
-      // subsequent block of sample data processed and is kept in network byte
-      // order.
-      Increment64(&counter_[8]);
-    }
-    ciphertext[i] = plaintext[i] ^ encrypted_counter_[block_offset_];
+  size_t pos = 0;
+
+  // Consume the rest of the keystream block left over from the previous call,
+  // if any.
+  while (block_offset_ != 0 && pos < plaintext_size) {
+    ciphertext[pos] = plaintext[pos] ^ encrypted_counter_[block_offset_];
     block_offset_ = (block_offset_ + 1) % AES_BLOCK_SIZE;
+    ++pos;
+  }
+
+  const size_t remaining = plaintext_size - pos;
+  const size_t num_blocks =
+      (remaining + AES_BLOCK_SIZE - 1) / AES_BLOCK_SIZE;
+  if (num_blocks == 0)
+    return true;
+
+  // Since the counter progression is independent of the plaintext, the
+  // keystream for the rest of the call can be precomputed in one pass. The
+  // xor pass below then runs over plain buffers without interleaved cipher
+  // calls.
+  keystream_.resize(num_blocks * AES_BLOCK_SIZE);
+  for (size_t i = 0; i < num_blocks; ++i)
+    EncryptCounterBlock(&keystream_[i * AES_BLOCK_SIZE]);
+
+  // Xor the keystream over the whole blocks in one vectorized pass.
+  const size_t whole_blocks_size = remaining - remaining % AES_BLOCK_SIZE;
+  XorKeystream(plaintext + pos, keystream_.data(), whole_blocks_size,
+               ciphertext + pos);
+  size_t i = whole_blocks_size;
+
+  // Partial block at the end; the remaining keystream bytes are kept in
+  // |encrypted_counter_| for the next call.
+  if (i < remaining) {
+    memcpy(encrypted_counter_.data(), &keystream_[whole_blocks_size],
+           AES_BLOCK_SIZE);
+    for (; i < remaining; ++i) {
+      ciphertext[pos + i] =
+          plaintext[pos + i] ^ encrypted_counter_[i - whole_blocks_size];
+    }
+    block_offset_ = static_cast<uint32_t>(remaining - whole_blocks_size);
+  }
+  return true;
+}
+
+bool AesCtrEncryptor::SkipSpan(size_t text_size) {
+  AddCryptedBytes(text_size);
+
+  size_t remaining = text_size;
+  // Consume the rest of the keystream block left over from the previous call,
+  // if any.
+  if (block_offset_ != 0) {
+    const size_t leftover = std::min(
+        remaining, static_cast<size_t>(AES_BLOCK_SIZE - block_offset_));
+    block_offset_ = (block_offset_ + leftover) % AES_BLOCK_SIZE;
+    remaining -= leftover;
+  }
+
+  // Skip whole blocks by advancing the counter directly.
+  AddToCounter64(&counter_[8], remaining / AES_BLOCK_SIZE);
+
+  // A partial block at the end needs its keystream generated, as the next
+  // Crypt call consumes the remainder of it from |encrypted_counter_|.
+  const size_t partial_block_size = remaining % AES_BLOCK_SIZE;
+  if (partial_block_size != 0) {
+    EncryptCounterBlock(encrypted_counter_.data());
+    block_offset_ = static_cast<uint32_t>(partial_block_size);
   }
   return true;
 }
 
+void AesCtrEncryptor::EncryptCounterBlock(uint8_t* keystream_block) {
+  size_t ignored_output_size;
+  CHECK_EQ(mbedtls_cipher_crypt(&cipher_ctx_, /* iv= */ NULL, /* iv_len= */ 0,
+                                &counter_[0], AES_BLOCK_SIZE, keystream_block,
+                                &ignored_output_size),
+           0);
+
+  // As mentioned in ISO/IEC 23001-7:2016 CENC spec, of the 16 byte counter
+  // block, bytes 8 to 15 (i.e. the least significant bytes) are used as a
+  // simple 64 bit unsigned integer that is incremented by one for each
+  // subsequent block of sample data processed and is kept in network byte
+  // order.
+  Increment64(&counter_[8]);
+}
+
 void AesCtrEncryptor::SetIvInternal() {
   block_offset_ = 0;
   counter_ = iv();
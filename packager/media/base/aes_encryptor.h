@@ -31,6 +31,12 @@ class AesCtrEncryptor : public AesCryptor {
   bool InitializeWithIv(const std::vector<uint8_t>& key,
                         const std::vector<uint8_t>& iv) override;
 
+  /// The keystream position is a pure function of the iv and the number of
+  /// bytes crypted, so the counter can be fast-forwarded without generating
+  /// the skipped keystream.
+  bool SupportsSpanSkip() const override { return true; }
+  bool SkipSpan(size_t text_size) override;
+
  private:
   bool CryptInternal(const uint8_t* plaintext,
                      size_t plaintext_size,
@@ -38,12 +44,20 @@ class AesCtrEncryptor : public AesCryptor {
                      size_t* ciphertext_size) override;
   void SetIvInternal() override;
 
+  // Encrypt the current counter block into |keystream_block| (16 bytes) and
+  // advance the counter per CENC.
+  void EncryptCounterBlock(uint8_t* keystream_block);
+
   // Current block offset.
   uint32_t block_offset_;
   // Current AES-CTR counter.
   std::vector<uint8_t> counter_;
   // Encrypted counter.
   std::vector<uint8_t> encrypted_counter_;
+  // Reusable keystream scratch for CryptInternal. The keystream for a whole
+  // call is generated into it up front, so the xor pass runs over plain
+  // buffers without interleaved cipher calls.
+  std::vector<uint8_t> keystream_;
 
   DISALLOW_COPY_AND_ASSIGN(AesCtrEncryptor);
 };
@@ -52,29 +52,50 @@ bool AesPatternCryptor::CryptInternal(const uint8_t* text,
   }
   *crypt_text_size = text_size;
 
+  // CBCS in the wild is virtually always a 1:9 pattern; dispatch it to the
+  // specialization with compile-time stripe sizes.
+  if (crypt_byte_block_ == 1 && skip_byte_block_ == 9)
+    return CryptPattern<1, 9>(text, text_size, crypt_text);
+  return CryptPatternGeneric(text, text_size, crypt_text);
+}
+
+template <uint8_t kCryptByteBlock, uint8_t kSkipByteBlock>
+bool AesPatternCryptor::CryptPattern(const uint8_t* text,
+                                     size_t text_size,
+                                     uint8_t* crypt_text) {
+  constexpr size_t kCryptByteSize = kCryptByteBlock * AES_BLOCK_SIZE;
+  constexpr size_t kSkipByteSize = kSkipByteBlock * AES_BLOCK_SIZE;
+  constexpr size_t kStripeSize = kCryptByteSize + kSkipByteSize;
+
+  // Full stripes: one crypt call and one fixed-size copy per iteration.
+  while (text_size > kStripeSize) {
+    if (!cryptor_->Crypt(text, kCryptByteSize, crypt_text))
+      return false;
+    memcpy(crypt_text + kCryptByteSize, text + kCryptByteSize, kSkipByteSize);
+    text += kStripeSize;
+    text_size -= kStripeSize;
+    crypt_text += kStripeSize;
+  }
+
+  if (text_size > kCryptByteSize) {
+    // A final full crypt block followed by a short skip run.
+    if (!cryptor_->Crypt(text, kCryptByteSize, crypt_text))
+      return false;
+    memcpy(crypt_text + kCryptByteSize, text + kCryptByteSize,
+           text_size - kCryptByteSize);
+    return true;
+  }
+  return CryptLastStripe(text, text_size, crypt_text);
+}
+
+bool AesPatternCryptor::CryptPatternGeneric(const uint8_t* text,
+                                            size_t text_size,
+                                            uint8_t* crypt_text) {
   while (text_size > 0) {
     const size_t crypt_byte_size = crypt_byte_block_ * AES_BLOCK_SIZE;
 
-    if (text_size <= crypt_byte_size) {
-      const bool need_encrypt =
-          encryption_mode_ != kSkipIfCryptByteBlockRemaining &&
-          text_size >= AES_BLOCK_SIZE;
-      if (need_encrypt) {
-        // The partial pattern SHALL be followed with the partial 16-byte block
-        // remains unencrypted.
-        const size_t aligned_crypt_byte_size =
-            text_size / AES_BLOCK_SIZE * AES_BLOCK_SIZE;
-        if (!cryptor_->Crypt(text, aligned_crypt_byte_size, crypt_text))
-          return false;
-        text += aligned_crypt_byte_size;
-        text_size -= aligned_crypt_byte_size;
-        crypt_text += aligned_crypt_byte_size;
-      }
-
-      // The remaining bytes are not encrypted.
-      memcpy(crypt_text, text, text_size);
-      return true;
-    }
+    if (text_size <= crypt_byte_size)
+      return CryptLastStripe(text, text_size, crypt_text);
 
     if (!cryptor_->Crypt(text, crypt_byte_size, crypt_text))
       return false;
@@ -92,6 +113,57 @@ bool AesPatternCryptor::CryptInternal(const uint8_t* text,
   return true;
 }
 
+bool AesPatternCryptor::CryptLastStripe(const uint8_t* text,
+                                        size_t text_size,
+                                        uint8_t* crypt_text) {
+  const bool need_encrypt = encryption_mode_ != kSkipIfCryptByteBlockRemaining &&
+                            text_size >= AES_BLOCK_SIZE;
+  if (need_encrypt) {
+    // The partial pattern SHALL be followed with the partial 16-byte block
+    // remains unencrypted.
+    const size_t aligned_crypt_byte_size =
+        text_size / AES_BLOCK_SIZE * AES_BLOCK_SIZE;
+    if (!cryptor_->Crypt(text, aligned_crypt_byte_size, crypt_text))
+      return false;
+    text += aligned_crypt_byte_size;
+    text_size -= aligned_crypt_byte_size;
+    crypt_text += aligned_crypt_byte_size;
+  }
+
+  // The remaining bytes are not encrypted.
+  memcpy(crypt_text, text, text_size);
+  return true;
+}
+
+bool AesPatternCryptor::SkipSpan(size_t text_size) {
+  if (use_constant_iv())
+    return true;
+  // The pattern itself restarts on every span; only the wrapped cryptor
+  // carries state across spans, advanced by the bytes the pattern would hand
+  // to it.
+  return cryptor_->SkipSpan(PatternEncryptedSize(text_size));
+}
+
+size_t AesPatternCryptor::PatternEncryptedSize(size_t text_size) const {
+  const size_t crypt_byte_size =
+      static_cast<size_t>(crypt_byte_block_) * AES_BLOCK_SIZE;
+  const size_t skip_byte_size =
+      static_cast<size_t>(skip_byte_block_) * AES_BLOCK_SIZE;
+
+  size_t encrypted_size = 0;
+  while (text_size > crypt_byte_size) {
+    encrypted_size += crypt_byte_size;
+    text_size -= crypt_byte_size;
+    text_size -= std::min(skip_byte_size, text_size);
+  }
+  // Mirrors CryptLastStripe.
+  if (encryption_mode_ != kSkipIfCryptByteBlockRemaining &&
+      text_size >= AES_BLOCK_SIZE) {
+    encrypted_size += text_size / AES_BLOCK_SIZE * AES_BLOCK_SIZE;
+  }
+  return encrypted_size;
+}
+
 void AesPatternCryptor::SetIvInternal() {
   CHECK(cryptor_->SetIv(iv()));
 }
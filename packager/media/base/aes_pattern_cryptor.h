@@ -58,6 +58,10 @@ class AesPatternCryptor : public AesCryptor {
   /// @{
   bool InitializeWithIv(const std::vector<uint8_t>& key,
                         const std::vector<uint8_t>& iv) override;
+  bool SupportsSpanSkip() const override {
+    return use_constant_iv() || cryptor_->SupportsSpanSkip();
+  }
+  bool SkipSpan(size_t text_size) override;
   /// @}
 
  private:
@@ -67,6 +71,24 @@ class AesPatternCryptor : public AesCryptor {
                      size_t* crypt_text_size) override;
   void SetIvInternal() override;
 
+  // Pattern loop with the stripe layout fixed at compile time, so the
+  // crypt/skip sizes constant-fold and a full stripe is processed per
+  // iteration. Used for the dominant CBCS 1:9 pattern; other patterns go
+  // through the generic loop below with runtime stripe sizes.
+  template <uint8_t kCryptByteBlock, uint8_t kSkipByteBlock>
+  bool CryptPattern(const uint8_t* text, size_t text_size, uint8_t* crypt_text);
+  bool CryptPatternGeneric(const uint8_t* text,
+                           size_t text_size,
+                           uint8_t* crypt_text);
+  // Handles the final (possibly partial) crypt block of a pattern, where
+  // |encryption_mode_| decides whether the block-aligned remainder is
+  // encrypted; trailing partial-block bytes always stay clear.
+  bool CryptLastStripe(const uint8_t* text, size_t text_size,
+                       uint8_t* crypt_text);
+  // Number of bytes a crypt call over |text_size| bytes would hand to the
+  // wrapped cryptor, i.e. the pattern's encrypted bytes.
+  size_t PatternEncryptedSize(size_t text_size) const;
+
   uint8_t crypt_byte_block_;
   const uint8_t skip_byte_block_;
   const PatternEncryptionMode encryption_mode_;
@@ -6,10 +6,14 @@
 
 #include <packager/media/base/aes_pattern_cryptor.h>
 
+#include <utility>
+#include <vector>
+
 #include <absl/strings/escaping.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <packager/media/base/aes_encryptor.h>
 #include <packager/media/base/mock_aes_cryptor.h>
 
 using ::testing::_;
@@ -133,6 +137,65 @@ INSTANTIATE_TEST_CASE_P(PatternTestCases,
                         AesPatternCryptorVerificationTest,
                         ::testing::ValuesIn(kPatternTestCases));
 
+// The 1:9 pattern takes the compile-time specialized path; verify it against
+// the pattern definition around the stripe boundaries.
+TEST(AesPatternCryptor19Test, StripeBoundaries) {
+  struct TestCase {
+    size_t text_size;
+    // [start, end) byte ranges expected to be encrypted.
+    std::vector<std::pair<size_t, size_t>> encrypted_ranges;
+  };
+  const TestCase kTestCases[] = {
+      // Partial block stays clear.
+      {10, {}},
+      // Exactly one crypt block.
+      {16, {{0, 16}}},
+      // Crypt block plus a short skip run.
+      {20, {{0, 16}}},
+      // Exactly one full 160-byte stripe.
+      {160, {{0, 16}}},
+      // A full stripe plus one crypt block.
+      {176, {{0, 16}, {160, 176}}},
+      // Two full stripes plus a trailing partial block, which stays clear.
+      {330, {{0, 16}, {160, 176}}},
+      // Two full stripes plus one crypt block.
+      {336, {{0, 16}, {160, 176}, {320, 336}}},
+  };
+
+  for (const TestCase& test_case : kTestCases) {
+    MockAesCryptor* mock_cryptor = new MockAesCryptor;
+    AesPatternCryptor pattern_cryptor(
+        1, 9, AesPatternCryptor::kEncryptIfCryptByteBlockRemaining,
+        AesCryptor::kDontUseConstantIv,
+        std::unique_ptr<MockAesCryptor>(mock_cryptor));
+
+    ON_CALL(*mock_cryptor, CryptInternal(_, _, _, _))
+        .WillByDefault(Invoke([](const uint8_t* text, size_t text_size,
+                                 uint8_t* crypt_text,
+                                 size_t* crypt_text_size) {
+          *crypt_text_size = text_size;
+          for (size_t i = 0; i < text_size; ++i)
+            *crypt_text++ = *text++ + 0x10;
+          return true;
+        }));
+
+    std::vector<uint8_t> text(test_case.text_size);
+    for (size_t i = 0; i < text.size(); ++i)
+      text[i] = static_cast<uint8_t>(i);
+
+    std::vector<uint8_t> expected_crypt_text(text);
+    for (const auto& range : test_case.encrypted_ranges) {
+      for (size_t i = range.first; i < range.second; ++i)
+        expected_crypt_text[i] += 0x10;
+    }
+
+    std::vector<uint8_t> crypt_text;
+    ASSERT_TRUE(pattern_cryptor.Crypt(text, &crypt_text));
+    EXPECT_EQ(expected_crypt_text, crypt_text)
+        << "text_size=" << test_case.text_size;
+  }
+}
+
 TEST(AesPatternCryptorConstIvTest, UseConstantIv) {
   MockAesCryptor* mock_cryptor = new MockAesCryptor;
   AesPatternCryptor pattern_cryptor(
@@ -212,5 +275,45 @@ TEST(SampleAesPatternCryptor, MoreThan16Bytes) {
   ASSERT_TRUE(pattern_cryptor.Crypt("0123456789abcdef012", &crypt_text));
 }
 
+TEST(AesPatternCryptorSkipSpanTest, SkipSpanMatchesCrypt) {
+  const std::vector<uint8_t> key(16, 'k');
+  const std::vector<uint8_t> iv(8, 'i');
+  std::vector<uint8_t> plaintext(200);
+  for (size_t i = 0; i < plaintext.size(); ++i)
+    plaintext[i] = static_cast<uint8_t>(i);
+  // Two spans split at a boundary that is neither block nor stripe aligned.
+  const size_t kSplit = 75;
+
+  // Reference: both spans crypted by one cryptor, the pattern restarting per
+  // span while the wrapped CTR cryptor carries its counter across them.
+  AesPatternCryptor reference(
+      kCryptByteBlock, kSkipByteBlock,
+      AesPatternCryptor::kEncryptIfCryptByteBlockRemaining,
+      AesPatternCryptor::kDontUseConstantIv,
+      std::unique_ptr<AesCryptor>(new AesCtrEncryptor));
+  ASSERT_TRUE(reference.InitializeWithIv(key, iv));
+  std::vector<uint8_t> expected(plaintext.size(), 0);
+  ASSERT_TRUE(reference.Crypt(plaintext.data(), kSplit, expected.data()));
+  ASSERT_TRUE(reference.Crypt(plaintext.data() + kSplit,
+                              plaintext.size() - kSplit,
+                              expected.data() + kSplit));
+
+  // A clone that skips the first span must produce the same second span.
+  AesPatternCryptor skipper(
+      kCryptByteBlock, kSkipByteBlock,
+      AesPatternCryptor::kEncryptIfCryptByteBlockRemaining,
+      AesPatternCryptor::kDontUseConstantIv,
+      std::unique_ptr<AesCryptor>(new AesCtrEncryptor));
+  ASSERT_TRUE(skipper.InitializeWithIv(key, iv));
+  EXPECT_TRUE(skipper.SupportsSpanSkip());
+  ASSERT_TRUE(skipper.SkipSpan(kSplit));
+  std::vector<uint8_t> actual(plaintext.size(), 0);
+  ASSERT_TRUE(skipper.Crypt(plaintext.data() + kSplit,
+                            plaintext.size() - kSplit,
+                            actual.data() + kSplit));
+  EXPECT_EQ(std::vector<uint8_t>(expected.begin() + kSplit, expected.end()),
+            std::vector<uint8_t>(actual.begin() + kSplit, actual.end()));
+}
+
 }  // namespace media
 }  // namespace shaka
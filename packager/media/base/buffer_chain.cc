@@ -0,0 +1,56 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/base/buffer_chain.h>
+
+#include <absl/log/check.h>
+
+#include <packager/file.h>
+#include <packager/media/base/buffer_writer.h>
+
+namespace shaka {
+namespace media {
+
+BufferChain::BufferChain() = default;
+BufferChain::~BufferChain() = default;
+
+void BufferChain::AppendExtent(std::vector<uint8_t> extent) {
+  if (extent.empty())
+    return;
+  size_ += extent.size();
+  extents_.push_back(std::move(extent));
+}
+
+void BufferChain::AppendBuffer(BufferWriter* buffer) {
+  DCHECK(buffer);
+  std::vector<uint8_t> extent;
+  buffer->SwapBuffer(&extent);
+  AppendExtent(std::move(extent));
+}
+
+Status BufferChain::WriteToFile(File* file) {
+  DCHECK(file);
+  DCHECK(!extents_.empty());
+
+  std::vector<File::IoVec> iov;
+  iov.reserve(extents_.size());
+  for (const std::vector<uint8_t>& extent : extents_)
+    iov.push_back({extent.data(), extent.size()});
+
+  const int64_t bytes_written =
+      file->WriteV(iov.data(), static_cast<int>(iov.size()));
+  if (bytes_written < 0 || static_cast<size_t>(bytes_written) != size_) {
+    return Status(error::FILE_FAILURE,
+                  "Fail to write to file in BufferChain");
+  }
+
+  extents_.clear();
+  size_ = 0;
+  return Status::OK;
+}
+
+}  // namespace media
+}  // namespace shaka
@@ -0,0 +1,60 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_MEDIA_BASE_BUFFER_CHAIN_H_
+#define PACKAGER_MEDIA_BASE_BUFFER_CHAIN_H_
+
+#include <cstdint>
+#include <vector>
+
+#include <packager/macros/classes.h>
+#include <packager/status.h>
+
+namespace shaka {
+
+class File;
+
+namespace media {
+
+class BufferWriter;
+
+/// Holds an ordered sequence of non-contiguous buffer extents and writes them
+/// out with a single vectored I/O call (File::WriteV). Muxers that assemble
+/// headers and payload in separate BufferWriters can chain them here instead
+/// of flattening everything into one contiguous buffer first.
+class BufferChain {
+ public:
+  BufferChain();
+  ~BufferChain();
+
+  /// Append an extent, taking ownership of the bytes without copying.
+  void AppendExtent(std::vector<uint8_t> extent);
+
+  /// Move the contents of @a buffer onto the chain as a new extent, leaving
+  /// @a buffer empty. No bytes are copied.
+  /// @param buffer should not be NULL.
+  void AppendBuffer(BufferWriter* buffer);
+
+  /// @return Total number of bytes across all extents.
+  size_t Size() const { return size_; }
+
+  /// Write all extents to file in order with a single WriteV call. The chain
+  /// is cleared after writing.
+  /// @param file should not be NULL.
+  /// @return OK on success.
+  Status WriteToFile(File* file);
+
+ private:
+  std::vector<std::vector<uint8_t>> extents_;
+  size_t size_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(BufferChain);
+};
+
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_MEDIA_BASE_BUFFER_CHAIN_H_
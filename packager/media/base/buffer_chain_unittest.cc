@@ -0,0 +1,70 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/base/buffer_chain.h>
+
+#include <gtest/gtest.h>
+
+#include <absl/log/log.h>
+
+#include <packager/file.h>
+#include <packager/file/file_test_util.h>
+#include <packager/media/base/buffer_writer.h>
+#include <packager/status/status_test_util.h>
+
+namespace {
+const uint8_t kHeader[] = {1, 2, 3};
+const uint8_t kPayload[] = {10, 20, 30, 40, 50};
+}  // namespace
+
+namespace shaka {
+namespace media {
+
+TEST(BufferChainTest, AppendTracksSize) {
+  BufferChain chain;
+  ASSERT_EQ(0u, chain.Size());
+
+  chain.AppendExtent(std::vector<uint8_t>(kHeader, kHeader + sizeof(kHeader)));
+  ASSERT_EQ(sizeof(kHeader), chain.Size());
+
+  BufferWriter writer;
+  writer.AppendArray(kPayload, sizeof(kPayload));
+  chain.AppendBuffer(&writer);
+  ASSERT_EQ(0u, writer.Size());
+  ASSERT_EQ(sizeof(kHeader) + sizeof(kPayload), chain.Size());
+}
+
+TEST(BufferChainTest, WriteToFile) {
+  TempFile temp_file;
+  LOG(INFO) << "Created temporary file: " << temp_file.path();
+
+  BufferChain chain;
+  chain.AppendExtent(std::vector<uint8_t>(kHeader, kHeader + sizeof(kHeader)));
+  chain.AppendExtent(
+      std::vector<uint8_t>(kPayload, kPayload + sizeof(kPayload)));
+
+  File* const output_file = File::Open(temp_file.path().c_str(), "w");
+  ASSERT_TRUE(output_file != NULL);
+  ASSERT_OK(chain.WriteToFile(output_file));
+  ASSERT_EQ(0u, chain.Size());
+  ASSERT_TRUE(output_file->Close());
+
+  // Read the file and verify the extents landed back to back.
+  File* const input_file = File::Open(temp_file.path().c_str(), "r");
+  ASSERT_TRUE(input_file != NULL);
+  std::vector<uint8_t> data_read(sizeof(kHeader) + sizeof(kPayload), 0);
+  EXPECT_EQ(data_read.size(), static_cast<size_t>(input_file->Read(
+                                  &data_read[0], data_read.size())));
+  ASSERT_TRUE(input_file->Close());
+
+  for (size_t i = 0; i < sizeof(kHeader); ++i)
+    EXPECT_EQ(kHeader[i], data_read[i]);
+  for (size_t i = 0; i < sizeof(kPayload); ++i)
+    EXPECT_EQ(kPayload[i], data_read[sizeof(kHeader) + i]);
+}
+
+}  // namespace media
+}  // namespace shaka
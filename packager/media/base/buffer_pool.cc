@@ -0,0 +1,93 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/base/buffer_pool.h>
+
+#include <utility>
+
+namespace shaka {
+namespace media {
+namespace {
+
+// Size classes are powers of two from 4 KiB (smaller buffers are cheap to
+// allocate directly) to 64 MiB (anything larger is left to the heap so one
+// oversized segment does not pin memory for the life of a thread).
+constexpr size_t kMinClassShift = 12;
+constexpr size_t kMaxClassShift = 26;
+constexpr size_t kNumClasses = kMaxClassShift - kMinClassShift + 1;
+
+// Buffers kept per class and thread. A stream only has a handful of
+// BufferWriters in flight at a time, so a small cap suffices.
+constexpr size_t kMaxBuffersPerClass = 8;
+
+// Smallest class whose base size is >= |capacity|, clamped to the class
+// range. Buffers in that class and above are guaranteed large enough.
+size_t CeilShift(size_t capacity) {
+  size_t shift = kMinClassShift;
+  while (shift < kMaxClassShift && (size_t(1) << shift) < capacity)
+    shift++;
+  return shift;
+}
+
+// Largest class whose base size is <= |capacity|, clamped to the class range.
+size_t FloorShift(size_t capacity) {
+  size_t shift = kMinClassShift;
+  while (shift < kMaxClassShift && (size_t(1) << (shift + 1)) <= capacity)
+    shift++;
+  return shift;
+}
+
+struct FreeLists {
+  std::vector<std::vector<uint8_t>> classes[kNumClasses];
+};
+
+FreeLists& free_lists() {
+  static thread_local FreeLists lists;
+  return lists;
+}
+
+}  // namespace
+
+std::vector<uint8_t> BufferPool::Acquire(size_t capacity_hint) {
+  if (capacity_hint <= (size_t(1) << kMaxClassShift)) {
+    FreeLists& lists = free_lists();
+    // Classes are floor-binned on release, so every buffer in class |shift|
+    // has capacity >= 1 << shift; any class at or above the ceiling class of
+    // the hint fits.
+    for (size_t shift = CeilShift(capacity_hint); shift <= kMaxClassShift;
+         shift++) {
+      std::vector<std::vector<uint8_t>>& free_class =
+          lists.classes[shift - kMinClassShift];
+      if (!free_class.empty()) {
+        std::vector<uint8_t> buffer = std::move(free_class.back());
+        free_class.pop_back();
+        return buffer;
+      }
+    }
+  }
+  std::vector<uint8_t> buffer;
+  if (capacity_hint > 0)
+    buffer.reserve(capacity_hint);
+  return buffer;
+}
+
+void BufferPool::Release(std::vector<uint8_t>&& buffer) {
+  const size_t capacity = buffer.capacity();
+  if (capacity < (size_t(1) << kMinClassShift) ||
+      capacity >= (size_t(1) << (kMaxClassShift + 1))) {
+    return;  // Freed on return.
+  }
+  FreeLists& lists = free_lists();
+  std::vector<std::vector<uint8_t>>& free_class =
+      lists.classes[FloorShift(capacity) - kMinClassShift];
+  if (free_class.size() >= kMaxBuffersPerClass)
+    return;  // Freed on return.
+  buffer.clear();
+  free_class.push_back(std::move(buffer));
+}
+
+}  // namespace media
+}  // namespace shaka
@@ -0,0 +1,44 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_MEDIA_BASE_BUFFER_POOL_H_
+#define PACKAGER_MEDIA_BASE_BUFFER_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace shaka {
+namespace media {
+
+/// Thread-local recycling store for the byte buffers behind BufferWriter.
+/// Fragment and segment serialization construct a BufferWriter per segment,
+/// which used to grow a fresh multi-megabyte vector every segment interval
+/// per rendition. Released buffers are instead kept on thread-local free
+/// lists in power-of-two size classes and handed back to later acquisitions,
+/// so the grown capacity survives across segments. Thread-local lists avoid
+/// locking on the hot path; each class is bounded so idle threads hold a
+/// limited amount of memory.
+class BufferPool {
+ public:
+  /// @param capacity_hint is the expected number of bytes to be written.
+  /// @return a cleared (size 0) vector with capacity of at least
+  ///         @a capacity_hint, recycled when a suitable buffer is available
+  ///         and freshly reserved otherwise.
+  static std::vector<uint8_t> Acquire(size_t capacity_hint);
+
+  /// Donate the storage of @a buffer to the calling thread's free lists.
+  /// Buffers too small or too large to be worth recycling are simply freed.
+  static void Release(std::vector<uint8_t>&& buffer);
+
+ private:
+  BufferPool() = delete;
+};
+
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_MEDIA_BASE_BUFFER_POOL_H_
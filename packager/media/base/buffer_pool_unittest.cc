@@ -0,0 +1,44 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/base/buffer_pool.h>
+
+#include <gtest/gtest.h>
+
+namespace shaka {
+namespace media {
+
+TEST(BufferPoolTest, AcquireReservesHint) {
+  std::vector<uint8_t> buffer = BufferPool::Acquire(100 * 1024);
+  EXPECT_TRUE(buffer.empty());
+  EXPECT_GE(buffer.capacity(), 100 * 1024u);
+}
+
+TEST(BufferPoolTest, RecyclesReleasedCapacity) {
+  std::vector<uint8_t> buffer = BufferPool::Acquire(100 * 1024);
+  buffer.resize(100 * 1024, 0xab);
+  const uint8_t* storage = buffer.data();
+  const size_t capacity = buffer.capacity();
+  BufferPool::Release(std::move(buffer));
+
+  // A smaller request is satisfied from the recycled storage, cleared.
+  std::vector<uint8_t> recycled = BufferPool::Acquire(64 * 1024);
+  EXPECT_EQ(storage, recycled.data());
+  EXPECT_EQ(capacity, recycled.capacity());
+  EXPECT_TRUE(recycled.empty());
+}
+
+TEST(BufferPoolTest, TinyBuffersAreNotPooled) {
+  std::vector<uint8_t> buffer = BufferPool::Acquire(16);
+  buffer.resize(16);
+  // Must not crash or pool storage below the minimum size class.
+  BufferPool::Release(std::move(buffer));
+  std::vector<uint8_t> another = BufferPool::Acquire(16);
+  EXPECT_GE(another.capacity(), 16u);
+}
+
+}  // namespace media
+}  // namespace shaka
@@ -45,6 +45,15 @@ bool BufferReader::ReadNBytesInto8s(int64_t* v, size_t num_bytes) {
   return ReadNBytes(v, num_bytes);
 }
 
+bool BufferReader::ReadUInt32Array(uint32_t* v, size_t count) {
+  DCHECK(v != NULL);
+  if (!HasBytes(count * sizeof(uint32_t)))
+    return false;
+  for (size_t i = 0; i < count; ++i)
+    ReadUnchecked(&v[i]);
+  return true;
+}
+
 bool BufferReader::ReadToVector(std::vector<uint8_t>* vec, size_t count) {
   DCHECK(vec != NULL);
   if (!HasBytes(count))
@@ -9,6 +9,7 @@
 
 #include <cstdint>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include <packager/macros/classes.h>
@@ -51,6 +52,25 @@ class BufferReader {
   [[nodiscard]] bool ReadNBytesInto8s(int64_t* v, size_t num_bytes);
   /// @}
 
+  /// Read a fixed-shape group of numeric fields with a single bounds check:
+  /// the group size is derived from the field types at compile time and each
+  /// field is then decoded with an unchecked big-endian load. Intended for
+  /// hot fixed-layout field groups, e.g. MP4 box headers.
+  /// @return false if there are not enough bytes in the buffer for the whole
+  ///         group, in which case no field is modified.
+  template <typename... T>
+  [[nodiscard]] bool ReadGroup(T*... fields) {
+    if (!HasBytes((sizeof(*fields) + ...)))
+      return false;
+    (ReadUnchecked(fields), ...);
+    return true;
+  }
+
+  /// Read @a count big-endian 32-bit integers with a single bounds check.
+  /// @return false if there are not enough bytes in the buffer, in which case
+  ///         the output array is not modified.
+  [[nodiscard]] bool ReadUInt32Array(uint32_t* v, size_t count);
+
   [[nodiscard]] bool ReadToVector(std::vector<uint8_t>* t, size_t count);
   [[nodiscard]] bool ReadToString(std::string* str, size_t size);
 
@@ -67,6 +87,17 @@ class BufferReader {
   size_t pos() const { return pos_; }
 
  private:
+  // Decode a big-endian value at the current position without a bounds check.
+  // The caller must have validated the extent.
+  template <typename T>
+  void ReadUnchecked(T* v) {
+    typename std::make_unsigned<T>::type tmp = 0;
+    for (size_t i = 0; i < sizeof(T); ++i)
+      tmp = (tmp << 8) | buf_[pos_ + i];
+    pos_ += sizeof(T);
+    *v = static_cast<T>(tmp);
+  }
+
   // Internal implementation of multi-byte reads.
   template <typename T>
   [[nodiscard]] bool Read(T* t);
@@ -6,23 +6,32 @@
 
 #include <packager/media/base/buffer_writer.h>
 
+#include <cstring>
+
 #include <absl/base/internal/endian.h>
 #include <absl/log/check.h>
 #include <absl/log/log.h>
 
 #include <packager/file.h>
+#include <packager/media/base/buffer_pool.h>
 
 namespace shaka {
 namespace media {
 
-BufferWriter::BufferWriter() {
-  const size_t kDefaultReservedCapacity = 0x40000;  // 256KB.
-  buf_.reserve(kDefaultReservedCapacity);
-}
-BufferWriter::BufferWriter(size_t reserved_size_in_bytes) {
-  buf_.reserve(reserved_size_in_bytes);
+namespace {
+const size_t kDefaultReservedCapacity = 0x40000;  // 256KB.
+}  // namespace
+
+// The backing store comes from BufferPool, so segment-sized capacities are
+// recycled across the BufferWriters constructed per fragment and segment
+// instead of being allocated and freed every time.
+BufferWriter::BufferWriter()
+    : buf_(BufferPool::Acquire(kDefaultReservedCapacity)) {}
+BufferWriter::BufferWriter(size_t reserved_size_in_bytes)
+    : buf_(BufferPool::Acquire(reserved_size_in_bytes)) {}
+BufferWriter::~BufferWriter() {
+  BufferPool::Release(std::move(buf_));
 }
-BufferWriter::~BufferWriter() {}
 
 void BufferWriter::AppendInt(uint8_t v) {
   buf_.push_back(v);
@@ -46,6 +55,16 @@ void BufferWriter::AppendInt(int64_t v) {
   AppendInternal(absl::big_endian::FromHost64(v));
 }
 
+void BufferWriter::AppendUInt32Array(const uint32_t* v, size_t count) {
+  const size_t old_size = buf_.size();
+  buf_.resize(old_size + count * sizeof(uint32_t));
+  uint8_t* dest = buf_.data() + old_size;
+  for (size_t i = 0; i < count; ++i) {
+    const uint32_t big_endian = absl::big_endian::FromHost32(v[i]);
+    memcpy(dest + i * sizeof(uint32_t), &big_endian, sizeof(uint32_t));
+  }
+}
+
 void BufferWriter::AppendNBytes(uint64_t v, size_t num_bytes) {
   DCHECK_GE(sizeof(v), num_bytes);
   v = absl::big_endian::FromHost64(v);
@@ -53,6 +72,10 @@ void BufferWriter::AppendNBytes(uint64_t v, size_t num_bytes) {
   AppendArray(&data[sizeof(v) - num_bytes], num_bytes);
 }
 
+void BufferWriter::AppendZeros(size_t num_bytes) {
+  buf_.resize(buf_.size() + num_bytes, 0);
+}
+
 void BufferWriter::AppendVector(const std::vector<uint8_t>& v) {
   buf_.insert(buf_.end(), v.begin(), v.end());
 }
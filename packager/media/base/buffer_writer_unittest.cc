@@ -97,6 +97,15 @@ TEST_F(BufferWriterTest, AppendNBytes) {
   ReadAndExpect(static_cast<uint32_t>(kuint64 & 0xFFFFFFFF));
 }
 
+TEST_F(BufferWriterTest, AppendZeros) {
+  writer_->AppendInt(kuint8);
+  writer_->AppendZeros(3);
+  ASSERT_EQ(4u, writer_->Size());
+  EXPECT_EQ(0, writer_->Buffer()[1]);
+  EXPECT_EQ(0, writer_->Buffer()[2]);
+  EXPECT_EQ(0, writer_->Buffer()[3]);
+}
+
 TEST_F(BufferWriterTest, AppendEmptyVector) {
   std::vector<uint8_t> v;
   writer_->AppendVector(v);
@@ -0,0 +1,210 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/base/byte_codec.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <map>
+
+#include <absl/synchronization/mutex.h>
+
+// Vectorized hex encoding. SSE2 is part of the x86-64 baseline and NEON is
+// part of the AArch64 baseline, so no runtime CPU dispatch is needed on
+// either.
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PACKAGER_HAS_HEX_ENCODE_SIMD 1
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+#include <arm_neon.h>
+#define PACKAGER_HAS_HEX_ENCODE_SIMD 1
+#endif
+
+namespace shaka {
+namespace media {
+namespace {
+
+const char kBase64Alphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+const char kLowerHexDigits[] = "0123456789abcdef";
+
+// Two output characters per 12 input bits, so the encode loop does two table
+// lookups and two 2-byte stores per 3 input bytes instead of four alphabet
+// lookups.
+using Base64PairTable = std::array<std::array<char, 2>, 4096>;
+
+const Base64PairTable& GetBase64PairTable() {
+  static const Base64PairTable* table = []() {
+    auto* t = new Base64PairTable;
+    for (int i = 0; i < 4096; ++i) {
+      (*t)[i][0] = kBase64Alphabet[i >> 6];
+      (*t)[i][1] = kBase64Alphabet[i & 0x3f];
+    }
+    return t;
+  }();
+  return *table;
+}
+
+// Two output characters per input byte for the scalar hex tail.
+using HexPairTable = std::array<std::array<char, 2>, 256>;
+
+const HexPairTable& GetHexPairTable() {
+  static const HexPairTable* table = []() {
+    auto* t = new HexPairTable;
+    for (int i = 0; i < 256; ++i) {
+      (*t)[i][0] = kLowerHexDigits[i >> 4];
+      (*t)[i][1] = kLowerHexDigits[i & 0xf];
+    }
+    return t;
+  }();
+  return *table;
+}
+
+#if defined(PACKAGER_HAS_HEX_ENCODE_SIMD)
+
+const size_t kHexBlockSize = 16;
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+
+// SSE2 has no byte shuffle, but the nibble-to-character mapping
+// c = n + '0' + (n > 9 ? 'a' - '0' - 10 : 0) needs only compares and adds.
+inline __m128i NibblesToHexChars(__m128i nibbles) {
+  const __m128i gap =
+      _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)),
+                    _mm_set1_epi8('a' - '0' - 10));
+  return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), gap);
+}
+
+inline void EncodeHexBlock(const uint8_t* in, char* out) {
+  const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+  const __m128i mask = _mm_set1_epi8(0x0f);
+  const __m128i hi =
+      NibblesToHexChars(_mm_and_si128(_mm_srli_epi16(block, 4), mask));
+  const __m128i lo = NibblesToHexChars(_mm_and_si128(block, mask));
+  // Interleave so the high nibble's character comes first for each byte.
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                   _mm_unpacklo_epi8(hi, lo));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16),
+                   _mm_unpackhi_epi8(hi, lo));
+}
+
+#else  // NEON
+
+inline uint8x16_t NibblesToHexChars(uint8x16_t nibbles) {
+  const uint8x16_t gap =
+      vandq_u8(vcgtq_u8(nibbles, vdupq_n_u8(9)), vdupq_n_u8('a' - '0' - 10));
+  return vaddq_u8(vaddq_u8(nibbles, vdupq_n_u8('0')), gap);
+}
+
+inline void EncodeHexBlock(const uint8_t* in, char* out) {
+  const uint8x16_t block = vld1q_u8(in);
+  uint8x16x2_t chars;
+  chars.val[0] = NibblesToHexChars(vshrq_n_u8(block, 4));
+  chars.val[1] = NibblesToHexChars(vandq_u8(block, vdupq_n_u8(0x0f)));
+  // The interleaving store puts the high nibble's character first.
+  vst2q_u8(reinterpret_cast<uint8_t*>(out), chars);
+}
+
+#endif
+
+#endif  // defined(PACKAGER_HAS_HEX_ENCODE_SIMD)
+
+// PSSH blobs are at most a few KB and a multi-DRM channel rotates a handful
+// of them at a time, so a small cache holds the working set; stale rotations
+// are evicted oldest first.
+const size_t kMaxCachedEncodings = 256;
+
+struct Base64Cache {
+  absl::Mutex mutex;
+  std::map<std::string, std::string, std::less<>> encodings
+      ABSL_GUARDED_BY(mutex);
+  std::deque<std::string> insertion_order ABSL_GUARDED_BY(mutex);
+};
+
+Base64Cache* GetBase64Cache() {
+  static Base64Cache* cache = new Base64Cache;
+  return cache;
+}
+
+}  // namespace
+
+std::string EncodeBase64(std::string_view input) {
+  const Base64PairTable& table = GetBase64PairTable();
+  std::string output((input.size() + 2) / 3 * 4, '=');
+  const uint8_t* in = reinterpret_cast<const uint8_t*>(input.data());
+  char* out = output.data();
+
+  size_t i = 0;
+  for (; i + 3 <= input.size(); i += 3) {
+    const uint32_t group = static_cast<uint32_t>(in[i]) << 16 |
+                           static_cast<uint32_t>(in[i + 1]) << 8 | in[i + 2];
+    memcpy(out, table[group >> 12].data(), 2);
+    memcpy(out + 2, table[group & 0xfff].data(), 2);
+    out += 4;
+  }
+
+  const size_t remaining = input.size() - i;
+  if (remaining == 1) {
+    out[0] = kBase64Alphabet[in[i] >> 2];
+    out[1] = kBase64Alphabet[(in[i] & 0x3) << 4];
+  } else if (remaining == 2) {
+    out[0] = kBase64Alphabet[in[i] >> 2];
+    out[1] = kBase64Alphabet[(in[i] & 0x3) << 4 | in[i + 1] >> 4];
+    out[2] = kBase64Alphabet[(in[i + 1] & 0xf) << 2];
+  }
+  return output;
+}
+
+std::string EncodeLowerHex(std::string_view input) {
+  std::string output(input.size() * 2, '\0');
+  const uint8_t* in = reinterpret_cast<const uint8_t*>(input.data());
+  char* out = output.data();
+
+  size_t i = 0;
+#if defined(PACKAGER_HAS_HEX_ENCODE_SIMD)
+  for (; i + kHexBlockSize <= input.size(); i += kHexBlockSize) {
+    EncodeHexBlock(in + i, out);
+    out += 2 * kHexBlockSize;
+  }
+#endif
+  const HexPairTable& table = GetHexPairTable();
+  for (; i < input.size(); ++i) {
+    memcpy(out, table[in[i]].data(), 2);
+    out += 2;
+  }
+  return output;
+}
+
+std::string CachedEncodeBase64(std::string_view input) {
+  Base64Cache* cache = GetBase64Cache();
+  {
+    absl::MutexLock lock(&cache->mutex);
+    auto iter = cache->encodings.find(input);
+    if (iter != cache->encodings.end())
+      return iter->second;
+  }
+
+  // Encode outside the lock; concurrent misses on the same blob just encode
+  // twice and the second insert is a no-op.
+  std::string encoded = EncodeBase64(input);
+
+  absl::MutexLock lock(&cache->mutex);
+  if (cache->encodings.emplace(std::string(input), encoded).second) {
+    cache->insertion_order.emplace_back(input);
+    while (cache->encodings.size() > kMaxCachedEncodings) {
+      cache->encodings.erase(cache->insertion_order.front());
+      cache->insertion_order.pop_front();
+    }
+  }
+  return encoded;
+}
+
+}  // namespace media
+}  // namespace shaka
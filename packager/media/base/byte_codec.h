@@ -0,0 +1,38 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+//
+// Fast base64 and hex encoders for the manifest paths. PSSH blobs and key
+// ids are re-encoded on every manifest flush and key rotation; these
+// replace the byte-at-a-time scalar loops with table and SIMD kernels, and
+// offer a content-keyed cache so unchanged blobs are never re-encoded.
+
+#ifndef PACKAGER_MEDIA_BASE_BYTE_CODEC_H_
+#define PACKAGER_MEDIA_BASE_BYTE_CODEC_H_
+
+#include <string>
+#include <string_view>
+
+namespace shaka {
+namespace media {
+
+/// Encode @a input as standard base64 with padding. Produces the same output
+/// as absl::Base64Escape, using a two-characters-per-lookup kernel.
+std::string EncodeBase64(std::string_view input);
+
+/// Encode @a input as lowercase hex. Produces the same output as
+/// absl::BytesToHexString, vectorized on the x86-64 and AArch64 baseline
+/// instruction sets.
+std::string EncodeLowerHex(std::string_view input);
+
+/// Like EncodeBase64(), but backed by a bounded process-wide cache keyed by
+/// the blob content, so a PSSH blob that is flushed into manifests over and
+/// over is encoded once per rotation instead of once per flush.
+std::string CachedEncodeBase64(std::string_view input);
+
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_MEDIA_BASE_BYTE_CODEC_H_
@@ -0,0 +1,75 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/base/byte_codec.h>
+
+#include <cstdint>
+#include <random>
+
+#include <absl/strings/escaping.h>
+#include <gtest/gtest.h>
+
+namespace shaka {
+namespace media {
+namespace {
+
+std::string RandomBytes(size_t size, uint32_t seed) {
+  std::mt19937 random(seed);
+  std::string bytes(size, '\0');
+  for (char& byte : bytes)
+    byte = static_cast<char>(random());
+  return bytes;
+}
+
+}  // namespace
+
+TEST(ByteCodecTest, EncodeBase64MatchesAbsl) {
+  // Cover every tail length around the 3-byte groups and the SIMD-free
+  // small cases.
+  for (size_t size = 0; size <= 70; ++size) {
+    const std::string input = RandomBytes(size, static_cast<uint32_t>(size));
+    std::string expected;
+    absl::Base64Escape(input, &expected);
+    EXPECT_EQ(expected, EncodeBase64(input)) << "size=" << size;
+  }
+}
+
+TEST(ByteCodecTest, EncodeBase64AllByteValues) {
+  std::string input(256, '\0');
+  for (int i = 0; i < 256; ++i)
+    input[i] = static_cast<char>(i);
+  std::string expected;
+  absl::Base64Escape(input, &expected);
+  EXPECT_EQ(expected, EncodeBase64(input));
+}
+
+TEST(ByteCodecTest, EncodeLowerHexMatchesAbsl) {
+  // Cover the vector blocks and every scalar tail length.
+  for (size_t size = 0; size <= 70; ++size) {
+    const std::string input = RandomBytes(size, static_cast<uint32_t>(size));
+    EXPECT_EQ(absl::BytesToHexString(input), EncodeLowerHex(input))
+        << "size=" << size;
+  }
+}
+
+TEST(ByteCodecTest, EncodeLowerHexAllByteValues) {
+  std::string input(256, '\0');
+  for (int i = 0; i < 256; ++i)
+    input[i] = static_cast<char>(i);
+  EXPECT_EQ(absl::BytesToHexString(input), EncodeLowerHex(input));
+}
+
+TEST(ByteCodecTest, CachedEncodeBase64) {
+  const std::string input = RandomBytes(1024, 42);
+  std::string expected;
+  absl::Base64Escape(input, &expected);
+  // Identical on the cold (encoding) and warm (cached) paths.
+  EXPECT_EQ(expected, CachedEncodeBase64(input));
+  EXPECT_EQ(expected, CachedEncodeBase64(input));
+}
+
+}  // namespace media
+}  // namespace shaka
@@ -27,23 +27,26 @@ Status CcStreamFilter::Process(std::unique_ptr<StreamData> stream_data) {
     }
   } else if (stream_data->stream_data_type == StreamDataType::kStreamInfo) {
     if (stream_data->stream_info->stream_type() == kStreamText) {
-      // Overwrite the per-input-stream language with our per-output-stream
-      // language; this requires cloning the stream info as it is used by other
-      // output streams.
-      auto clone = stream_data->stream_info->Clone();
-      if (!language_.empty()) {
-        clone->set_language(language_);
-      } else {
+      // Determine the per-output-stream language first; the stream info is
+      // shared with other output streams, so it is cloned only when the
+      // language actually needs to be overwritten.
+      std::string language = language_;
+      if (language.empty()) {
         // Try to find the language in the sub-stream info.
-        auto* text_info = static_cast<TextStreamInfo*>(clone.get());
+        const auto* text_info = static_cast<const TextStreamInfo*>(
+            stream_data->stream_info.get());
         auto it = text_info->sub_streams().find(cc_index_);
-        if (it != text_info->sub_streams().end()) {
-          clone->set_language(it->second.language);
-        }
+        if (it != text_info->sub_streams().end())
+          language = it->second.language;
       }
 
-      stream_data = StreamData::FromStreamInfo(stream_data->stream_index,
-                                               std::move(clone));
+      if (!language.empty() &&
+          language != stream_data->stream_info->language()) {
+        auto clone = stream_data->stream_info->Clone();
+        clone->set_language(language);
+        stream_data = StreamData::FromStreamInfo(stream_data->stream_index,
+                                                 std::move(clone));
+      }
     }
   }
 
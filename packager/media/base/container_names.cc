@@ -1664,6 +1664,33 @@ bool CheckTtml(const uint8_t* buffer, int buffer_size) {
   return root_node_name == "tt";
 }
 
+// Cheap signals over the whole probe window, computed in one pass by
+// ComputeProbeSignals(). Each of the scanning checks in DetermineContainer()
+// walks the buffer looking for its own sync pattern; gathering the necessary
+// conditions for all of them in a single scan lets the checks that cannot
+// possibly succeed on this buffer be skipped entirely.
+struct ProbeSignals {
+  // Occurrences of each byte value.
+  int byte_count[256] = {0};
+  // Occurrences of a zero byte followed by 0x00 or 0x01, the prefix common to
+  // the MPEG style start codes (H.261 through H.264, MPEG4 bit streams, VC1
+  // and MPEG2 program streams).
+  int start_code_prefix_count = 0;
+};
+
+ProbeSignals ComputeProbeSignals(const uint8_t* buffer, int buffer_size) {
+  ProbeSignals signals;
+  uint8_t previous = 0xff;
+  for (int i = 0; i < buffer_size; ++i) {
+    const uint8_t byte = buffer[i];
+    ++signals.byte_count[byte];
+    if (previous == 0 && byte <= 1)
+      ++signals.start_code_prefix_count;
+    previous = byte;
+  }
+  return signals;
+}
+
 }  // namespace
 
 // Attempt to determine the container name from the buffer provided.
@@ -1684,34 +1711,51 @@ MediaContainerName DetermineContainer(const uint8_t* buffer, int buffer_size) {
   if (CheckWebVtt(buffer, buffer_size))
       return CONTAINER_WEBVTT;
 
-  // Additional checks that may scan a portion of the buffer.
-  if (CheckMpeg2ProgramStream(buffer, buffer_size))
+  // Additional checks that may scan a portion of the buffer. Compute the
+  // sync pattern counters for all of them in a single pass first, so that
+  // scans that cannot possibly succeed are skipped instead of each walking
+  // the buffer to discover the same thing.
+  const ProbeSignals signals = ComputeProbeSignals(buffer, buffer_size);
+  const bool has_start_code_prefix = signals.start_code_prefix_count > 0;
+  // A transport stream has a sync byte at the start of every 188 to 208 byte
+  // packet, so the buffer must contain at least one 0x47 per 208 bytes (the
+  // first packet may start up to 20 bytes in).
+  const bool enough_ts_sync_bytes =
+      signals.byte_count[kMpeg2SyncWord] >= (buffer_size - 26) / 208;
+  // GSM blocks are 33 bytes and each starts with a 0xd high nibble.
+  int gsm_magic_count = 0;
+  for (int i = 0xd0; i <= 0xdf; ++i)
+    gsm_magic_count += signals.byte_count[i];
+
+  if (has_start_code_prefix && CheckMpeg2ProgramStream(buffer, buffer_size))
     return CONTAINER_MPEG2PS;
-  if (CheckMpeg2TransportStream(buffer, buffer_size))
+  if (enough_ts_sync_bytes && CheckMpeg2TransportStream(buffer, buffer_size))
     return CONTAINER_MPEG2TS;
   if (CheckMJpeg(buffer, buffer_size))
     return CONTAINER_MJPEG;
   if (CheckDV(buffer, buffer_size))
     return CONTAINER_DV;
-  if (CheckH261(buffer, buffer_size))
+  if (has_start_code_prefix && CheckH261(buffer, buffer_size))
     return CONTAINER_H261;
-  if (CheckH263(buffer, buffer_size))
+  if (has_start_code_prefix && CheckH263(buffer, buffer_size))
     return CONTAINER_H263;
-  if (CheckH264(buffer, buffer_size))
+  if (has_start_code_prefix && CheckH264(buffer, buffer_size))
     return CONTAINER_H264;
-  if (CheckMpeg4BitStream(buffer, buffer_size))
+  if (has_start_code_prefix && CheckMpeg4BitStream(buffer, buffer_size))
     return CONTAINER_MPEG4BS;
-  if (CheckVC1(buffer, buffer_size))
+  if (has_start_code_prefix && CheckVC1(buffer, buffer_size))
     return CONTAINER_VC1;
   if (CheckSrt(buffer, buffer_size))
     return CONTAINER_SRT;
-  if (CheckGsm(buffer, buffer_size))
+  if (gsm_magic_count >= buffer_size / 33 && CheckGsm(buffer, buffer_size))
     return CONTAINER_GSM;
 
   // AC3/EAC3 might not start at the beginning of the stream,
-  // so scan for a start code.
+  // so scan for a start code, but only when both bytes of the sync word
+  // occur somewhere in the buffer.
   int offset = 1;  // No need to start at byte 0 due to First4 check.
-  if (AdvanceToStartCode(buffer, buffer_size, &offset, 4, 16, kAc3SyncWord)) {
+  if (signals.byte_count[0x0b] > 0 && signals.byte_count[0x77] > 0 &&
+      AdvanceToStartCode(buffer, buffer_size, &offset, 4, 16, kAc3SyncWord)) {
     if (CheckAc3(buffer + offset, buffer_size - offset))
       return CONTAINER_AC3;
     if (CheckEac3(buffer + offset, buffer_size - offset))
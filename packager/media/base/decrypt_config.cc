@@ -12,18 +12,18 @@ namespace media {
 
 DecryptConfig::DecryptConfig(const std::vector<uint8_t>& key_id,
                              const std::vector<uint8_t>& iv,
-                             const std::vector<SubsampleEntry>& subsamples)
+                             absl::Span<const SubsampleEntry> subsamples)
     : DecryptConfig(key_id, iv, subsamples, FOURCC_cenc, 0, 0) {}
 
 DecryptConfig::DecryptConfig(const std::vector<uint8_t>& key_id,
                              const std::vector<uint8_t>& iv,
-                             const std::vector<SubsampleEntry>& subsamples,
+                             absl::Span<const SubsampleEntry> subsamples,
                              FourCC protection_scheme,
                              uint8_t crypt_byte_block,
                              uint8_t skip_byte_block)
     : key_id_(key_id),
       iv_(iv),
-      subsamples_(subsamples),
+      subsamples_(subsamples.begin(), subsamples.end()),
       protection_scheme_(protection_scheme),
       crypt_byte_block_(crypt_byte_block),
       skip_byte_block_(skip_byte_block) {
@@ -9,6 +9,9 @@
 #include <string>
 #include <vector>
 
+#include <absl/container/inlined_vector.h>
+#include <absl/types/span.h>
+
 #include <packager/macros/classes.h>
 #include <packager/media/base/fourccs.h>
 
@@ -34,6 +37,11 @@ struct SubsampleEntry {
   uint32_t cipher_bytes;
 };
 
+/// Subsample list with inline storage. Typical frames carry only a handful of
+/// subsamples (one per NAL unit for video, one for audio), so keeping the
+/// first entries inline avoids a heap allocation per encrypted sample.
+using SubsampleVector = absl::InlinedVector<SubsampleEntry, 8>;
+
 /// Contains all the information that a decryptor needs to decrypt a media
 /// sample.
 class DecryptConfig {
@@ -49,7 +57,7 @@ class DecryptConfig {
   ///        in size to the sum of the subsample sizes.
   DecryptConfig(const std::vector<uint8_t>& key_id,
                 const std::vector<uint8_t>& iv,
-                const std::vector<SubsampleEntry>& subsamples);
+                absl::Span<const SubsampleEntry> subsamples);
 
   /// Create a general decrypt config with possible pattern-based encryption.
   /// @param key_id is the ID that references the decryption key.
@@ -65,7 +73,7 @@ class DecryptConfig {
   ///        in pattern based encryption, 'cens' and 'cbcs'. Ignored otherwise.
   DecryptConfig(const std::vector<uint8_t>& key_id,
                 const std::vector<uint8_t>& iv,
-                const std::vector<SubsampleEntry>& subsamples,
+                absl::Span<const SubsampleEntry> subsamples,
                 FourCC protection_scheme,
                 uint8_t crypt_byte_block,
                 uint8_t skip_byte_block);
@@ -85,7 +93,7 @@ class DecryptConfig {
 
   const std::vector<uint8_t>& key_id() const { return key_id_; }
   const std::vector<uint8_t>& iv() const { return iv_; }
-  const std::vector<SubsampleEntry>& subsamples() const { return subsamples_; }
+  const SubsampleVector& subsamples() const { return subsamples_; }
   FourCC protection_scheme() const { return protection_scheme_; }
   uint8_t crypt_byte_block() const { return crypt_byte_block_; }
   uint8_t skip_byte_block() const { return skip_byte_block_; }
@@ -98,7 +106,7 @@ class DecryptConfig {
 
   // Subsample information. May be empty for some formats, meaning entire frame
   // (less data ignored by data_offset_) is encrypted.
-  std::vector<SubsampleEntry> subsamples_;
+  SubsampleVector subsamples_;
 
   const FourCC protection_scheme_;
   // For pattern-based protection schemes, like CENS and CBCS.
@@ -111,10 +111,14 @@ bool DecryptorSource::DecryptSampleBuffer(const DecryptConfig* decrypt_config,
     return true;
   }
 
-  // Subsample decryption.
-  const std::vector<SubsampleEntry>& subsamples = decrypt_config->subsamples();
+  // Subsample decryption. Validate the layout and copy the clear parts
+  // first, then hand all protected ranges to the decryptor in one batched
+  // call, which pays the per-call overhead once per sample instead of once
+  // per subsample.
+  const auto& subsamples = decrypt_config->subsamples();
   const uint8_t* current_ptr = encrypted_buffer;
   const uint8_t* const buffer_end = encrypted_buffer + buffer_size;
+  crypt_spans_.clear();
   for (const auto& subsample : subsamples) {
     if ((current_ptr + subsample.clear_bytes + subsample.cipher_bytes) >
         buffer_end) {
@@ -124,14 +128,21 @@ bool DecryptorSource::DecryptSampleBuffer(const DecryptConfig* decrypt_config,
     memcpy(decrypted_buffer, current_ptr, subsample.clear_bytes);
     current_ptr += subsample.clear_bytes;
     decrypted_buffer += subsample.clear_bytes;
-    if (!decryptor->Crypt(current_ptr, subsample.cipher_bytes,
-                          decrypted_buffer)) {
-      LOG(ERROR) << "Error decrypting subsample buffer.";
-      return false;
+    if (subsample.cipher_bytes > 0) {
+      AesCryptor::CryptSpan span;
+      span.text = current_ptr;
+      span.text_size = subsample.cipher_bytes;
+      span.crypt_text = decrypted_buffer;
+      span.crypt_text_size = subsample.cipher_bytes;
+      crypt_spans_.push_back(span);
     }
     current_ptr += subsample.cipher_bytes;
     decrypted_buffer += subsample.cipher_bytes;
   }
+  if (!decryptor->Crypt(crypt_spans_.data(), crypt_spans_.size())) {
+    LOG(ERROR) << "Error decrypting subsample buffer.";
+    return false;
+  }
   return true;
 }
 
@@ -44,6 +44,10 @@ class DecryptorSource {
  private:
   KeySource* key_source_;
   std::map<std::vector<uint8_t>, std::unique_ptr<AesCryptor>> decryptor_map_;
+  // Scratch span list reused across DecryptSampleBuffer calls, so the
+  // protected ranges of a sample can be batched into a single Crypt call
+  // without a per-sample allocation.
+  std::vector<AesCryptor::CryptSpan> crypt_spans_;
 
   DISALLOW_COPY_AND_ASSIGN(DecryptorSource);
 };
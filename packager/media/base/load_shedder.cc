@@ -0,0 +1,115 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/base/load_shedder.h>
+
+#include <atomic>
+#include <chrono>
+#include <map>
+
+#include <absl/strings/str_format.h>
+#include <absl/synchronization/mutex.h>
+
+namespace shaka {
+namespace media {
+namespace {
+
+const size_t kNumPriorities = 3;
+
+std::atomic<bool> g_enabled(false);
+
+// Per-stream publication accounting. The wall-clock baseline is the stream's
+// first report, so job startup (probing, header parsing) does not count as
+// lag.
+struct StreamClock {
+  double first_report_time = 0;
+  double published_seconds = 0;
+};
+
+struct State {
+  double lag_seconds = 0;
+  std::map<const void*, StreamClock> streams;
+  uint64_t shed_counts[kNumPriorities] = {};
+};
+
+// Leaked on purpose so shedding checks are safe at any point of shutdown.
+absl::Mutex* StateMutex() {
+  static absl::Mutex* mutex = new absl::Mutex;
+  return mutex;
+}
+
+State* GetState() {
+  static State* state = new State;
+  return state;
+}
+
+double NowSeconds() {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Largest publication lag across streams; the slowest stream decides.
+double MaxLagSeconds(const State& state, double now) {
+  double max_lag = 0;
+  for (const auto& pair : state.streams) {
+    const double lag =
+        (now - pair.second.first_report_time) - pair.second.published_seconds;
+    if (lag > max_lag)
+      max_lag = lag;
+  }
+  return max_lag;
+}
+
+}  // namespace
+
+void LoadShedder::Enable(double lag_seconds) {
+  absl::MutexLock lock(StateMutex());
+  GetState()->lag_seconds = lag_seconds;
+  g_enabled.store(true, std::memory_order_relaxed);
+}
+
+void LoadShedder::Disable() {
+  absl::MutexLock lock(StateMutex());
+  g_enabled.store(false, std::memory_order_relaxed);
+  GetState()->streams.clear();
+}
+
+void LoadShedder::OnMediaPublished(const void* token, double seconds) {
+  if (!g_enabled.load(std::memory_order_relaxed))
+    return;
+  absl::MutexLock lock(StateMutex());
+  StreamClock& clock = GetState()->streams[token];
+  if (clock.first_report_time == 0)
+    clock.first_report_time = NowSeconds();
+  clock.published_seconds += seconds;
+}
+
+bool LoadShedder::ShouldShed(Priority priority) {
+  if (!g_enabled.load(std::memory_order_relaxed))
+    return false;
+  absl::MutexLock lock(StateMutex());
+  State* state = GetState();
+  const double threshold =
+      state->lag_seconds * (static_cast<int>(priority) + 1);
+  if (MaxLagSeconds(*state, NowSeconds()) <= threshold)
+    return false;
+  state->shed_counts[static_cast<size_t>(priority)]++;
+  return true;
+}
+
+std::string LoadShedder::DumpJson() {
+  absl::MutexLock lock(StateMutex());
+  const State* state = GetState();
+  return absl::StrFormat(
+      "{\"lag_seconds\":%.3f,\"shed\":{\"media_info\":%d,\"trick_play\":%d,"
+      "\"manifest_flush\":%d}}",
+      state->lag_seconds, state->shed_counts[0], state->shed_counts[1],
+      state->shed_counts[2]);
+}
+
+}  // namespace media
+}  // namespace shaka
@@ -0,0 +1,66 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_MEDIA_BASE_LOAD_SHEDDER_H_
+#define PACKAGER_MEDIA_BASE_LOAD_SHEDDER_H_
+
+#include <cstdint>
+#include <string>
+
+namespace shaka {
+namespace media {
+
+/// Deadline-aware shedding of non-critical pipeline work for live jobs.
+///
+/// Producers of published media (the muxer listeners) report how many seconds
+/// of media they have delivered; the shedder compares that against wall time.
+/// When publication lags real time, secondary work starts getting shed by
+/// priority — lowest priority first, and progressively more as the lag grows —
+/// so the primary media path keeps real time while secondary artifacts batch
+/// or drop. Disabled (never sheds) until Enable() is called; see
+/// PackagingParams::load_shedding_lag_seconds.
+class LoadShedder {
+ public:
+  /// Sheddable work classes. Lower values are shed first: work of priority
+  /// @a p is shed once publication lags wall time by more than
+  /// (p + 1) * the configured lag.
+  enum class Priority {
+    /// media_info dump output. Reserved: in the current tree media_info
+    /// files are written once at end of stream and are never shed.
+    kMediaInfoDump = 0,
+    /// Trick-play output branches; shedding skips trick frames, which the
+    /// previous trick frame spans.
+    kTrickPlay = 1,
+    /// Per-segment manifest rewrites; shedding batches them into the next
+    /// unshed rewrite.
+    kManifestFlush = 2,
+  };
+
+  /// Start shedding decisions with the given lag threshold in seconds.
+  static void Enable(double lag_seconds);
+  /// Stop shedding; also clears the published-media accounting so a later
+  /// job in the same process starts fresh. Counters are kept for stats.
+  static void Disable();
+
+  /// Report @a seconds of published media from a completed segment.
+  /// @a token identifies the reporting stream (typically the listener's
+  /// `this`); lag is evaluated per stream and the worst stream decides.
+  static void OnMediaPublished(const void* token, double seconds);
+
+  /// @return true if work of @a priority should be shed right now.
+  ///         Every true return is counted for stats.
+  static bool ShouldShed(Priority priority);
+
+  /// @return a JSON object with the configured lag and per-priority shed
+  ///         counts. Backs the load_shedding entry of
+  ///         Packager::DumpPipelineStats().
+  static std::string DumpJson();
+};
+
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_MEDIA_BASE_LOAD_SHEDDER_H_
@@ -0,0 +1,46 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/base/load_shedder.h>
+
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace shaka {
+namespace media {
+
+TEST(LoadShedderTest, DisabledNeverSheds) {
+  EXPECT_FALSE(LoadShedder::ShouldShed(LoadShedder::Priority::kMediaInfoDump));
+  EXPECT_FALSE(LoadShedder::ShouldShed(LoadShedder::Priority::kTrickPlay));
+  EXPECT_FALSE(LoadShedder::ShouldShed(LoadShedder::Priority::kManifestFlush));
+}
+
+TEST(LoadShedderTest, NoShedWithoutLag) {
+  LoadShedder::Enable(3600);
+  int token;
+  LoadShedder::OnMediaPublished(&token, 1.0);
+  EXPECT_FALSE(LoadShedder::ShouldShed(LoadShedder::Priority::kMediaInfoDump));
+  EXPECT_FALSE(LoadShedder::ShouldShed(LoadShedder::Priority::kManifestFlush));
+  LoadShedder::Disable();
+}
+
+TEST(LoadShedderTest, ShedsUnderLag) {
+  LoadShedder::Enable(0.001);
+  int token;
+  // Publishing no media while wall time advances puts the stream behind.
+  LoadShedder::OnMediaPublished(&token, 0.0);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_TRUE(LoadShedder::ShouldShed(LoadShedder::Priority::kMediaInfoDump));
+  EXPECT_TRUE(LoadShedder::ShouldShed(LoadShedder::Priority::kManifestFlush));
+  EXPECT_NE(LoadShedder::DumpJson().find("\"shed\""), std::string::npos);
+  LoadShedder::Disable();
+  EXPECT_FALSE(LoadShedder::ShouldShed(LoadShedder::Priority::kMediaInfoDump));
+}
+
+}  // namespace media
+}  // namespace shaka
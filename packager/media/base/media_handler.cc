@@ -6,10 +6,167 @@
 
 #include <packager/media/base/media_handler.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <iterator>
+#include <typeinfo>
+#include <unordered_set>
+
+#ifdef __GNUG__
+#include <cxxabi.h>
+
+#include <cstdlib>
+#endif
+
+#include <absl/strings/str_format.h>
+#include <absl/synchronization/mutex.h>
+#include <absl/synchronization/notification.h>
+
+#include <packager/file/thread_pool.h>
 #include <packager/macros/status.h>
+#include <packager/utils/trace_event.h>
+#include <packager/utils/watchdog.h>
 
 namespace shaka {
 namespace media {
+namespace {
+
+std::atomic<bool> g_stats_timing_enabled(false);
+
+// Registered handlers in construction order. Function-local statics (leaked
+// on purpose) so registration from static-storage handlers is safe.
+absl::Mutex* RegistryMutex() {
+  static absl::Mutex* mutex = new absl::Mutex;
+  return mutex;
+}
+
+std::vector<MediaHandler*>* Registry() {
+  static std::vector<MediaHandler*>* handlers = new std::vector<MediaHandler*>;
+  return handlers;
+}
+
+std::string HandlerTypeName(const MediaHandler& handler) {
+  const char* name = typeid(handler).name();
+#ifdef __GNUG__
+  int status = 0;
+  char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+  if (status == 0 && demangled) {
+    std::string result(demangled);
+    free(demangled);
+    return result;
+  }
+#endif
+  return name;
+}
+
+// Graph shapes that already passed validation, keyed by
+// MediaHandler::GraphFingerprint(). Same leaked-static pattern as the
+// registry above.
+absl::Mutex* ValidatedShapesMutex() {
+  static absl::Mutex* mutex = new absl::Mutex;
+  return mutex;
+}
+
+std::unordered_set<uint64_t>* ValidatedShapes() {
+  static std::unordered_set<uint64_t>* shapes = new std::unordered_set<uint64_t>;
+  return shapes;
+}
+
+// 64-bit FNV-1a accumulator used for graph fingerprints.
+uint64_t FnvMixBytes(uint64_t hash, const void* data, size_t size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+void RecordInput(MediaHandlerStats* stats, const StreamData& stream_data) {
+  stats->samples_in.fetch_add(1, std::memory_order_relaxed);
+  if (stream_data.media_sample) {
+    stats->bytes_in.fetch_add(stream_data.media_sample->data_size(),
+                              std::memory_order_relaxed);
+  }
+}
+
+}  // namespace
+
+void MediaHandlerStatsRegistry::SetTimingEnabled(bool enabled) {
+  g_stats_timing_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool MediaHandlerStatsRegistry::timing_enabled() {
+  return g_stats_timing_enabled.load(std::memory_order_relaxed);
+}
+
+std::string MediaHandlerStatsRegistry::DumpJson() {
+  std::string json = "{\"handlers\":[";
+  absl::MutexLock lock(RegistryMutex());
+  bool first = true;
+  for (const MediaHandler* handler : *Registry()) {
+    const MediaHandlerStats& stats = handler->stats();
+    absl::StrAppendFormat(
+        &json,
+        "%s{\"name\":\"%s\",\"samples_in\":%" PRIu64 ",\"samples_out\":%" PRIu64
+        ",\"bytes_in\":%" PRIu64 ",\"processing_ns\":%" PRIu64 "}",
+        first ? "" : ",",
+        handler->handler_name().empty() ? "(uninitialized)"
+                                        : handler->handler_name(),
+        stats.samples_in.load(std::memory_order_relaxed),
+        stats.samples_out.load(std::memory_order_relaxed),
+        stats.bytes_in.load(std::memory_order_relaxed),
+        stats.processing_ns.load(std::memory_order_relaxed));
+    first = false;
+  }
+  json += "]}";
+  return json;
+}
+
+void MediaHandlerStatsRegistry::GetSinkTotals(uint64_t* samples,
+                                              uint64_t* bytes) {
+  *samples = 0;
+  *bytes = 0;
+  absl::MutexLock lock(RegistryMutex());
+  for (const MediaHandler* handler : *Registry()) {
+    const MediaHandlerStats& stats = handler->stats();
+    if (stats.samples_out.load(std::memory_order_relaxed) != 0)
+      continue;
+    *samples += stats.samples_in.load(std::memory_order_relaxed);
+    *bytes += stats.bytes_in.load(std::memory_order_relaxed);
+  }
+}
+
+void MediaHandlerStatsRegistry::Register(MediaHandler* handler) {
+  absl::MutexLock lock(RegistryMutex());
+  Registry()->push_back(handler);
+}
+
+void MediaHandlerStatsRegistry::Unregister(MediaHandler* handler) {
+  absl::MutexLock lock(RegistryMutex());
+  auto* handlers = Registry();
+  handlers->erase(std::remove(handlers->begin(), handlers->end(), handler),
+                  handlers->end());
+}
+
+bool ValidatedPipelineCache::Contains(uint64_t fingerprint) {
+  absl::MutexLock lock(ValidatedShapesMutex());
+  return ValidatedShapes()->count(fingerprint) != 0;
+}
+
+void ValidatedPipelineCache::Add(uint64_t fingerprint) {
+  absl::MutexLock lock(ValidatedShapesMutex());
+  ValidatedShapes()->insert(fingerprint);
+}
+
+MediaHandler::MediaHandler() {
+  MediaHandlerStatsRegistry::Register(this);
+}
+
+MediaHandler::~MediaHandler() {
+  MediaHandlerStatsRegistry::Unregister(this);
+}
 
 std::string StreamDataTypeToString(StreamDataType type) {
   switch (type) {
@@ -43,23 +200,56 @@ Status MediaHandler::SetHandler(size_t output_stream_index,
   return Status::OK;
 }
 
+Status MediaHandler::RemoveHandler(size_t output_stream_index) {
+  if (output_handlers_.erase(output_stream_index) == 0) {
+    return Status(error::NOT_FOUND,
+                  "No output handler exist at the specified index.");
+  }
+  return Status::OK;
+}
+
 Status MediaHandler::Initialize() {
   if (initialized_)
     return Status::OK;
+  // The dynamic type is available here, unlike in the constructor.
+  if (handler_name_.empty())
+    handler_name_ = HandlerTypeName(*this);
+  // Connectivity validation only depends on the graph shape, so a subtree
+  // whose shape already validated in this process (e.g. an earlier job with
+  // the same configuration) skips the per-handler checks. InitializeInternal()
+  // still runs: it sets up per-instance state.
+  const uint64_t fingerprint = GraphFingerprint();
+  const bool shape_validated = ValidatedPipelineCache::Contains(fingerprint);
   Status status = InitializeInternal();
   if (!status.ok())
     return status;
   for (auto& pair : output_handlers_) {
-    if (!ValidateOutputStreamIndex(pair.first))
+    if (!shape_validated && !ValidateOutputStreamIndex(pair.first))
       return Status(error::INVALID_ARGUMENT, "Invalid output stream index");
     status = pair.second.first->Initialize();
     if (!status.ok())
       return status;
   }
+  if (!shape_validated)
+    ValidatedPipelineCache::Add(fingerprint);
   initialized_ = true;
   return Status::OK;
 }
 
+uint64_t MediaHandler::GraphFingerprint() const {
+  const std::string type_name = HandlerTypeName(*this);
+  uint64_t hash = FnvMixBytes(0xcbf29ce484222325ull, type_name.data(),
+                              type_name.size());
+  hash = FnvMixBytes(hash, &num_input_streams_, sizeof(num_input_streams_));
+  for (const auto& pair : output_handlers_) {
+    hash = FnvMixBytes(hash, &pair.first, sizeof(pair.first));
+    hash = FnvMixBytes(hash, &pair.second.second, sizeof(pair.second.second));
+    const uint64_t downstream = pair.second.first->GraphFingerprint();
+    hash = FnvMixBytes(hash, &downstream, sizeof(downstream));
+  }
+  return hash;
+}
+
 Status MediaHandler::Chain(
     const std::vector<std::shared_ptr<MediaHandler>>& list) {
   std::shared_ptr<MediaHandler> previous;
@@ -80,6 +270,14 @@ Status MediaHandler::Chain(
   return Status::OK;
 }
 
+Status MediaHandler::ProcessBatch(
+    std::vector<std::unique_ptr<StreamData>> stream_data_list) {
+  for (auto& stream_data : stream_data_list) {
+    RETURN_IF_ERROR(Process(std::move(stream_data)));
+  }
+  return Status::OK;
+}
+
 Status MediaHandler::OnFlushRequest(size_t input_stream_index) {
   // The default implementation treats the output stream index to be identical
   // to the input stream index, which is true for most handlers.
@@ -99,7 +297,83 @@ Status MediaHandler::Dispatch(std::unique_ptr<StreamData> stream_data) const {
                   "No output handler exist at the specified index.");
   }
   stream_data->stream_index = handler_it->second.second;
-  return handler_it->second.first->Process(std::move(stream_data));
+
+  MediaHandler* handler = handler_it->second.first.get();
+  stats_.samples_out.fetch_add(1, std::memory_order_relaxed);
+  RecordInput(&handler->stats_, *stream_data);
+  if (Watchdog::Enabled()) {
+    // handler_name() is fixed once Initialize() ran, so storing the pointer
+    // is safe for the handler's lifetime.
+    const MediaSample* sample = stream_data->media_sample.get();
+    Watchdog::Pulse(handler->handler_name().c_str(),
+                    sample ? sample->dts() : Watchdog::kNoTimestamp);
+  }
+  TraceBuffer::ScopedEvent trace("pipeline", "dispatch",
+                                 handler->handler_name());
+  if (!MediaHandlerStatsRegistry::timing_enabled())
+    return handler->Process(std::move(stream_data));
+
+  const auto start = std::chrono::steady_clock::now();
+  Status status = handler->Process(std::move(stream_data));
+  handler->stats_.processing_ns.fetch_add(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start)
+          .count(),
+      std::memory_order_relaxed);
+  return status;
+}
+
+Status MediaHandler::DispatchBatch(
+    std::vector<std::unique_ptr<StreamData>> stream_data_list) const {
+  // Hand off contiguous runs that target the same downstream handler in one
+  // ProcessBatch() call each. With single-output handlers (the common case on
+  // sample paths) the whole batch goes down in a single call.
+  size_t run_start = 0;
+  while (run_start < stream_data_list.size()) {
+    const size_t output_stream_index =
+        stream_data_list[run_start]->stream_index;
+    auto handler_it = output_handlers_.find(output_stream_index);
+    if (handler_it == output_handlers_.end()) {
+      return Status(error::NOT_FOUND,
+                    "No output handler exist at the specified index.");
+    }
+
+    MediaHandler* handler = handler_it->second.first.get();
+    size_t run_end = run_start;
+    while (run_end < stream_data_list.size() &&
+           stream_data_list[run_end]->stream_index == output_stream_index) {
+      stream_data_list[run_end]->stream_index = handler_it->second.second;
+      RecordInput(&handler->stats_, *stream_data_list[run_end]);
+      run_end++;
+    }
+    stats_.samples_out.fetch_add(run_end - run_start,
+                                 std::memory_order_relaxed);
+
+    std::vector<std::unique_ptr<StreamData>> run(
+        std::make_move_iterator(stream_data_list.begin() + run_start),
+        std::make_move_iterator(stream_data_list.begin() + run_end));
+    if (Watchdog::Enabled()) {
+      const MediaSample* sample = run.front()->media_sample.get();
+      Watchdog::Pulse(handler->handler_name().c_str(),
+                      sample ? sample->dts() : Watchdog::kNoTimestamp);
+    }
+    TraceBuffer::ScopedEvent trace("pipeline", "dispatch_batch",
+                                   handler->handler_name());
+    if (MediaHandlerStatsRegistry::timing_enabled()) {
+      const auto start = std::chrono::steady_clock::now();
+      Status status = handler->ProcessBatch(std::move(run));
+      handler->stats_.processing_ns.fetch_add(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now() - start)
+              .count(),
+          std::memory_order_relaxed);
+      RETURN_IF_ERROR(status);
+    } else {
+      RETURN_IF_ERROR(handler->ProcessBatch(std::move(run)));
+    }
+    run_start = run_end;
+  }
+  return Status::OK;
 }
 
 Status MediaHandler::FlushDownstream(size_t output_stream_index) {
@@ -112,13 +386,66 @@ Status MediaHandler::FlushDownstream(size_t output_stream_index) {
 }
 
 Status MediaHandler::FlushAllDownstreams() {
+  // One task per distinct downstream handler, carrying the input stream
+  // indexes that feed it in output index order. Flushes for the same handler
+  // must stay serial; handlers are not required to accept concurrent calls.
+  struct FlushTask {
+    MediaHandler* handler = nullptr;
+    std::vector<size_t> stream_indexes;
+    Status status;
+    absl::Notification done;
+  };
+  std::vector<std::unique_ptr<FlushTask>> tasks;
   for (const auto& pair : output_handlers_) {
-    Status status = pair.second.first->OnFlushRequest(pair.second.second);
-    if (!status.ok()) {
-      return status;
+    MediaHandler* handler = pair.second.first.get();
+    auto it = std::find_if(
+        tasks.begin(), tasks.end(),
+        [handler](const std::unique_ptr<FlushTask>& task) {
+          return task->handler == handler;
+        });
+    if (it == tasks.end()) {
+      tasks.push_back(std::make_unique<FlushTask>());
+      tasks.back()->handler = handler;
+      it = std::prev(tasks.end());
     }
+    (*it)->stream_indexes.push_back(pair.second.second);
   }
-  return Status::OK;
+  if (tasks.empty())
+    return Status::OK;
+
+  const auto run_task = [](FlushTask* task) {
+    for (size_t stream_index : task->stream_indexes) {
+      task->status = task->handler->OnFlushRequest(stream_index);
+      if (!task->status.ok())
+        break;
+    }
+    task->done.Notify();
+  };
+
+  if (tasks.size() == 1) {
+    run_task(tasks[0].get());
+    return tasks[0]->status;
+  }
+
+  // The branches below distinct handlers are independent chains, so their
+  // flush cascades -- dominated by muxer finalization at end of stream --
+  // run concurrently. Shared endpoints such as the manifest notifiers
+  // already take concurrent notifications from parallel jobs. The pool
+  // grows on demand, so nested fan-out cannot starve the flush.
+  for (size_t i = 1; i < tasks.size(); ++i) {
+    ThreadPool::instance.PostTask(
+        [run_task, task = tasks[i].get()]() { run_task(task); });
+  }
+  run_task(tasks[0].get());
+
+  // Wait for every branch even after a failure; the tasks reference this
+  // frame.
+  Status status;
+  for (auto& task : tasks) {
+    task->done.WaitForNotification();
+    status.Update(task->status);
+  }
+  return status;
 }
 }  // namespace media
 }  // namespace shaka
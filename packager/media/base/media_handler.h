@@ -7,11 +7,15 @@
 #ifndef PACKAGER_MEDIA_BASE_MEDIA_HANDLER_H_
 #define PACKAGER_MEDIA_BASE_MEDIA_HANDLER_H_
 
+#include <atomic>
 #include <map>
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include <packager/media/base/media_sample.h>
+#include <packager/media/base/object_pool.h>
 #include <packager/media/base/stream_info.h>
 #include <packager/media/base/text_sample.h>
 #include <packager/status.h>
@@ -67,6 +71,15 @@ struct SegmentInfo {
 
 // TODO(kqyang): Should we use protobuf?
 struct StreamData {
+  // StreamData wrappers are allocated once per sample; recycle the fixed-size
+  // slots through ObjectPool so the sample path stays off the global heap.
+  static void* operator new(size_t size) {
+    return ObjectPool<StreamData>::Allocate(size);
+  }
+  static void operator delete(void* ptr, size_t size) {
+    ObjectPool<StreamData>::Deallocate(ptr, size);
+  }
+
   size_t stream_index = static_cast<size_t>(-1);
   StreamDataType stream_data_type = StreamDataType::kUnknown;
 
@@ -138,6 +151,61 @@ struct StreamData {
   }
 };
 
+/// Per-handler processing counters, updated on the sample path with relaxed
+/// atomics. The block is cache-line aligned so counters of handlers running
+/// on different threads never share a line.
+struct alignas(64) MediaHandlerStats {
+  /// Stream data entries received by this handler's Process()/ProcessBatch().
+  std::atomic<uint64_t> samples_in{0};
+  /// Stream data entries this handler dispatched downstream.
+  std::atomic<uint64_t> samples_out{0};
+  /// Media sample payload bytes received by this handler.
+  std::atomic<uint64_t> bytes_in{0};
+  /// Cumulative time spent in this handler's Process()/ProcessBatch(),
+  /// including its downstream dispatches. Only collected while
+  /// MediaHandlerStatsRegistry timing is enabled.
+  std::atomic<uint64_t> processing_ns{0};
+};
+
+/// Process-wide view over the counters of every live MediaHandler. Backs
+/// Packager::DumpPipelineStats().
+class MediaHandlerStatsRegistry {
+ public:
+  /// Turn collection of per-handler processing time on or off. Sample and
+  /// byte counters are always maintained; timing adds two clock reads per
+  /// dispatch and is therefore opt-in.
+  static void SetTimingEnabled(bool enabled);
+  static bool timing_enabled();
+
+  /// @return a JSON document with one entry per live handler, in handler
+  ///         construction order.
+  static std::string DumpJson();
+
+  /// Aggregate counters of sink handlers, i.e. handlers that never dispatched
+  /// anything downstream (the muxers): stream data entries and media sample
+  /// bytes delivered to them. Used for end-to-end throughput reporting.
+  static void GetSinkTotals(uint64_t* samples, uint64_t* bytes);
+
+ private:
+  friend class MediaHandler;
+  static void Register(MediaHandler* handler);
+  static void Unregister(MediaHandler* handler);
+};
+
+/// Process-wide cache of pipeline shapes that already passed validation.
+/// A handler graph is fingerprinted by handler types, stream counts and
+/// connection indices (see MediaHandler::GraphFingerprint()); once a graph of
+/// a given shape validated OK, later graphs with the same fingerprint (e.g. a
+/// fleet of short jobs reusing one configuration) skip the per-handler
+/// connectivity checks in MediaHandler::Initialize().
+class ValidatedPipelineCache {
+ public:
+  /// @return true if a graph with this fingerprint already validated OK.
+  static bool Contains(uint64_t fingerprint);
+  /// Record a fingerprint whose graph passed validation.
+  static void Add(uint64_t fingerprint);
+};
+
 /// MediaHandler is the base media processing unit. Media handlers transform
 /// the input streams and propagate the outputs to downstream media handlers.
 /// There are three different types of media handlers:
@@ -155,8 +223,8 @@ struct StreamData {
 /// Other types of media handlers are disallowed and not supported.
 class MediaHandler {
  public:
-  MediaHandler() = default;
-  virtual ~MediaHandler() = default;
+  MediaHandler();
+  virtual ~MediaHandler();
 
   /// Connect downstream handler at the specified output stream index.
   Status SetHandler(size_t output_stream_index,
@@ -167,6 +235,13 @@ class MediaHandler {
     return SetHandler(next_output_stream_index_, handler);
   }
 
+  /// Disconnect the downstream handler at the specified output stream index.
+  /// The caller is responsible for flushing the handler first if its output
+  /// needs to be finalized. Note that the downstream handler keeps its input
+  /// stream count, so it can be reconnected but not rewired to a different
+  /// index.
+  Status RemoveHandler(size_t output_stream_index);
+
   /// Initialize the handler and downstream handlers. Note that it should be
   /// called after setting up the graph before running the graph.
   Status Initialize();
@@ -176,6 +251,20 @@ class MediaHandler {
 
   static Status Chain(const std::vector<std::shared_ptr<MediaHandler>>& list);
 
+  /// Shape fingerprint of this handler and its downstream graph: a hash over
+  /// handler types, input stream counts and connection indices. Identically
+  /// built pipelines produce identical fingerprints; per-job state (file
+  /// names, keys, ...) does not contribute. Backs ValidatedPipelineCache.
+  uint64_t GraphFingerprint() const;
+
+  /// Processing counters for this handler. Updated by the dispatch path; see
+  /// MediaHandlerStats for what is collected when.
+  const MediaHandlerStats& stats() const { return stats_; }
+
+  /// Human readable handler name used in stats dumps. Derived from the
+  /// dynamic type in Initialize(); empty before then.
+  const std::string& handler_name() const { return handler_name_; }
+
  protected:
   /// Internal implementation of initialize. Note that it should only initialize
   /// the MediaHandler itself. Downstream handlers are handled in Initialize().
@@ -187,6 +276,14 @@ class MediaHandler {
   /// handlers after finishing processing if needed.
   virtual Status Process(std::unique_ptr<StreamData> stream_data) = 0;
 
+  /// Process a batch of incoming stream data. The default implementation
+  /// calls Process() on each entry in order. Handlers on hot sample paths
+  /// (e.g. high-cadence audio) can override this to amortize virtual dispatch
+  /// and lock acquisitions across the whole batch. The same requirements as
+  /// Process() apply to every entry.
+  virtual Status ProcessBatch(
+      std::vector<std::unique_ptr<StreamData>> stream_data_list);
+
   /// Event handler for flush request at the specific input stream index.
   virtual Status OnFlushRequest(size_t input_stream_index);
 
@@ -197,6 +294,13 @@ class MediaHandler {
   /// stream_data.stream_index should be the output stream index.
   Status Dispatch(std::unique_ptr<StreamData> stream_data) const;
 
+  /// Dispatch a batch of stream data to downstream handlers with a single
+  /// ProcessBatch() call per downstream handler. Entries keep their relative
+  /// order. Note that stream_data.stream_index of every entry should be the
+  /// output stream index.
+  Status DispatchBatch(
+      std::vector<std::unique_ptr<StreamData>> stream_data_list) const;
+
   /// Dispatch the stream info to downstream handlers.
   Status DispatchStreamInfo(
       size_t stream_index,
@@ -272,6 +376,10 @@ class MediaHandler {
   // map.
   std::map<size_t, std::pair<std::shared_ptr<MediaHandler>, size_t>>
       output_handlers_;
+
+  std::string handler_name_;
+  // Mutable so the const dispatch path can bump counters.
+  mutable MediaHandlerStats stats_;
 };
 
 }  // namespace media
@@ -0,0 +1,166 @@
+// Copyright 2017 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/base/media_handler.h>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <packager/media/base/media_handler_test_base.h>
+#include <packager/status/status_test_util.h>
+
+using ::testing::ElementsAre;
+
+namespace shaka {
+namespace media {
+namespace {
+const int64_t kDuration = 100;
+const bool kKeyFrame = true;
+
+// Upstream handler that exposes the protected batch dispatch for testing.
+class BatchSourceHandler : public MediaHandler {
+ public:
+  using MediaHandler::DispatchBatch;
+
+ private:
+  Status InitializeInternal() override { return Status::OK; }
+  Status Process(std::unique_ptr<StreamData> stream_data) override {
+    return Status::OK;
+  }
+  bool ValidateOutputStreamIndex(size_t stream_index) const override {
+    return true;
+  }
+};
+
+// Downstream handler that records the size of every ProcessBatch() run it
+// receives, along with the (translated) entries in arrival order.
+class RunRecordingHandler : public MediaHandler {
+ public:
+  const std::vector<size_t>& run_sizes() const { return run_sizes_; }
+  const std::vector<std::unique_ptr<StreamData>>& received() const {
+    return received_;
+  }
+
+ private:
+  Status InitializeInternal() override { return Status::OK; }
+  Status Process(std::unique_ptr<StreamData> stream_data) override {
+    received_.push_back(std::move(stream_data));
+    return Status::OK;
+  }
+  Status ProcessBatch(
+      std::vector<std::unique_ptr<StreamData>> stream_data_list) override {
+    run_sizes_.push_back(stream_data_list.size());
+    for (auto& stream_data : stream_data_list)
+      received_.push_back(std::move(stream_data));
+    return Status::OK;
+  }
+  bool ValidateOutputStreamIndex(size_t stream_index) const override {
+    return true;
+  }
+
+  std::vector<size_t> run_sizes_;
+  std::vector<std::unique_ptr<StreamData>> received_;
+};
+
+}  // namespace
+
+class MediaHandlerBatchTest : public MediaHandlerTestBase {
+ protected:
+  std::unique_ptr<StreamData> GetMediaSampleStreamData(size_t stream_index,
+                                                       int64_t timestamp) {
+    return StreamData::FromMediaSample(
+        stream_index, GetMediaSample(timestamp, kDuration, kKeyFrame));
+  }
+
+  BatchSourceHandler source_;
+};
+
+TEST_F(MediaHandlerBatchTest, DispatchBatchSplitsRunsByOutputStream) {
+  auto output_0 = std::make_shared<RunRecordingHandler>();
+  auto output_1 = std::make_shared<RunRecordingHandler>();
+  ASSERT_OK(source_.SetHandler(0, output_0));
+  ASSERT_OK(source_.SetHandler(1, output_1));
+
+  std::vector<std::unique_ptr<StreamData>> batch;
+  batch.push_back(GetMediaSampleStreamData(0, 0));
+  batch.push_back(GetMediaSampleStreamData(0, kDuration));
+  batch.push_back(GetMediaSampleStreamData(1, 0));
+  batch.push_back(GetMediaSampleStreamData(0, 2 * kDuration));
+  ASSERT_OK(source_.DispatchBatch(std::move(batch)));
+
+  // The run targeting stream 1 splits the batch into three ProcessBatch()
+  // calls; each handler sees its entries in dispatch order.
+  EXPECT_THAT(output_0->run_sizes(), ElementsAre(2u, 1u));
+  EXPECT_THAT(output_1->run_sizes(), ElementsAre(1u));
+  EXPECT_THAT(output_0->received(),
+              ElementsAre(IsMediaSample(0u, 0, kDuration, false, kKeyFrame),
+                          IsMediaSample(0u, kDuration, kDuration, false,
+                                        kKeyFrame),
+                          IsMediaSample(0u, 2 * kDuration, kDuration, false,
+                                        kKeyFrame)));
+  EXPECT_THAT(output_1->received(),
+              ElementsAre(IsMediaSample(0u, 0, kDuration, false, kKeyFrame)));
+}
+
+TEST_F(MediaHandlerBatchTest, DispatchBatchTranslatesStreamIndex) {
+  // The same downstream handler connected at both outputs: its input stream
+  // indexes are 0 and 1, so entries must arrive with translated indexes.
+  auto output = std::make_shared<RunRecordingHandler>();
+  ASSERT_OK(source_.SetHandler(0, output));
+  ASSERT_OK(source_.SetHandler(1, output));
+
+  std::vector<std::unique_ptr<StreamData>> batch;
+  batch.push_back(GetMediaSampleStreamData(0, 0));
+  batch.push_back(GetMediaSampleStreamData(0, kDuration));
+  batch.push_back(GetMediaSampleStreamData(1, 0));
+  batch.push_back(GetMediaSampleStreamData(1, kDuration));
+  ASSERT_OK(source_.DispatchBatch(std::move(batch)));
+
+  EXPECT_THAT(output->run_sizes(), ElementsAre(2u, 2u));
+  EXPECT_THAT(
+      output->received(),
+      ElementsAre(
+          IsMediaSample(0u, 0, kDuration, false, kKeyFrame),
+          IsMediaSample(0u, kDuration, kDuration, false, kKeyFrame),
+          IsMediaSample(1u, 0, kDuration, false, kKeyFrame),
+          IsMediaSample(1u, kDuration, kDuration, false, kKeyFrame)));
+}
+
+TEST_F(MediaHandlerBatchTest, DispatchBatchFailsOnUnknownOutputStream) {
+  auto output = std::make_shared<RunRecordingHandler>();
+  ASSERT_OK(source_.SetHandler(0, output));
+
+  std::vector<std::unique_ptr<StreamData>> batch;
+  batch.push_back(GetMediaSampleStreamData(0, 0));
+  batch.push_back(GetMediaSampleStreamData(7, 0));
+  EXPECT_EQ(error::NOT_FOUND,
+            source_.DispatchBatch(std::move(batch)).error_code());
+  // The leading run was already delivered.
+  EXPECT_THAT(output->run_sizes(), ElementsAre(1u));
+}
+
+TEST_F(MediaHandlerBatchTest, DefaultProcessBatchFallsBackToProcess) {
+  // CachingMediaHandler does not override ProcessBatch(), so the default
+  // implementation must hand every entry to Process() in order.
+  auto output = std::make_shared<CachingMediaHandler>();
+  ASSERT_OK(source_.SetHandler(0, output));
+
+  std::vector<std::unique_ptr<StreamData>> batch;
+  batch.push_back(GetMediaSampleStreamData(0, 0));
+  batch.push_back(GetMediaSampleStreamData(0, kDuration));
+  batch.push_back(GetMediaSampleStreamData(0, 2 * kDuration));
+  ASSERT_OK(source_.DispatchBatch(std::move(batch)));
+
+  EXPECT_THAT(output->Cache(),
+              ElementsAre(IsMediaSample(0u, 0, kDuration, false, kKeyFrame),
+                          IsMediaSample(0u, kDuration, kDuration, false,
+                                        kKeyFrame),
+                          IsMediaSample(0u, 2 * kDuration, kDuration, false,
+                                        kKeyFrame)));
+}
+
+}  // namespace media
+}  // namespace shaka
@@ -68,6 +68,16 @@ class MediaParser {
                     const NewTextSampleCB& new_text_sample_cb,
                     KeySource* decryption_key_source) = 0;
 
+  /// Notify the parser that the caller will discard every sample of the given
+  /// track. Parsers may use the hint to stop assembling samples for the track
+  /// altogether, so demux cost is proportional to the tracks actually
+  /// consumed. Must only be called after the init callback has been invoked,
+  /// and never from within a parser callback. The default implementation
+  /// ignores the hint, which is always safe: unconsumed samples are simply
+  /// dropped by the caller.
+  /// @param track_id is the track id reported in the init callback.
+  virtual void ExcludeTrack(uint32_t /*track_id*/) {}
+
   /// Flush data currently in the parser and put the parser in a state where it
   /// can receive data for a new seek point.
   /// @return true if successful, false otherwise.
@@ -68,6 +68,23 @@ std::shared_ptr<MediaSample> MediaSample::FromMetadata(const uint8_t* metadata,
       new MediaSample(nullptr, 0, metadata, metadata_size, false));
 }
 
+// static
+std::shared_ptr<MediaSample> MediaSample::FromSharedBuffer(
+    std::shared_ptr<const uint8_t> buffer,
+    size_t offset,
+    size_t size,
+    bool is_key_frame) {
+  CHECK(buffer);
+  CHECK_GT(size, 0u);
+  std::shared_ptr<MediaSample> sample(new MediaSample);
+  sample->is_key_frame_ = is_key_frame;
+  // The aliasing constructor keeps the whole buffer alive while pointing at
+  // the slice, so no payload bytes are copied.
+  sample->data_ = std::shared_ptr<const uint8_t>(buffer, buffer.get() + offset);
+  sample->data_size_ = size;
+  return sample;
+}
+
 // static
 std::shared_ptr<MediaSample> MediaSample::CreateEmptyMediaSample() {
   return std::shared_ptr<MediaSample>(new MediaSample);
@@ -91,6 +108,7 @@ std::shared_ptr<MediaSample> MediaSample::Clone() const {
   new_media_sample->side_data_ = side_data_;
   new_media_sample->side_data_size_ = side_data_size_;
   new_media_sample->config_id_ = config_id_;
+  new_media_sample->nalu_extents_ = nalu_extents_;
   if (decrypt_config_) {
     new_media_sample->decrypt_config_.reset(new DecryptConfig(
         decrypt_config_->key_id(), decrypt_config_->iv(),
@@ -101,6 +119,21 @@ std::shared_ptr<MediaSample> MediaSample::Clone() const {
   return new_media_sample;
 }
 
+uint8_t* MediaSample::writable_data() {
+  DCHECK(!end_of_stream());
+  // Detach from co-owners (clones, other slices of a shared buffer) before
+  // handing out a mutable pointer, so writes never leak into samples on other
+  // branches of the graph. Sole ownership means nobody else can observe the
+  // buffer, making the const_cast safe.
+  if (data_.use_count() > 1) {
+    std::shared_ptr<uint8_t> detached_data(new uint8_t[data_size_],
+                                           std::default_delete<uint8_t[]>());
+    memcpy(detached_data.get(), data_.get(), data_size_);
+    data_ = std::move(detached_data);
+  }
+  return const_cast<uint8_t*>(data_.get());
+}
+
 void MediaSample::TransferData(std::shared_ptr<uint8_t> data,
                                size_t data_size) {
   data_ = std::move(data);
@@ -17,13 +17,38 @@
 
 #include <packager/macros/classes.h>
 #include <packager/media/base/decrypt_config.h>
+#include <packager/media/base/object_pool.h>
 
 namespace shaka {
 namespace media {
 
+/// Location and type of one NAL unit within a sample's payload. A table of
+/// these can be attached to a MediaSample when the frame is first parsed, so
+/// downstream handlers iterate the units from the table instead of rescanning
+/// the bytes.
+struct NaluExtent {
+  /// Offset of the NAL unit header within the sample data, past any length
+  /// field or start code.
+  uint32_t offset;
+  /// Size of the NAL unit (header and payload), excluding the length field.
+  uint32_t size;
+  /// The NAL unit type, e.g. Nalu::H264NaluType.
+  uint8_t type;
+};
+
 /// Class to hold a media sample.
 class MediaSample {
  public:
+  /// MediaSample headers are allocated once per sample; recycle the
+  /// fixed-size slots through ObjectPool so the sample path stays off the
+  /// global heap.
+  static void* operator new(size_t size) {
+    return ObjectPool<MediaSample>::Allocate(size);
+  }
+  static void operator delete(void* ptr, size_t size) {
+    ObjectPool<MediaSample>::Deallocate(ptr, size);
+  }
+
   /// Create a MediaSample object from input.
   /// @param data points to the buffer containing the sample data.
   ///        Must not be NULL.
@@ -57,6 +82,22 @@ class MediaSample {
   static std::shared_ptr<MediaSample> FromMetadata(const uint8_t* metadata,
                                                    size_t metadata_size);
 
+  /// Create a MediaSample that references a slice of a shared immutable
+  /// buffer without copying. The sample holds a reference on @a buffer, so
+  /// many samples (or fan-out branches) can alias disjoint or overlapping
+  /// slices of one demuxed buffer. Use writable_data() if the payload needs
+  /// to be modified later; it copies on write only when the buffer is still
+  /// shared.
+  /// @param buffer is the shared immutable buffer holding the payload.
+  /// @param offset is the byte offset of the slice within @a buffer.
+  /// @param size is the size of the slice in bytes. Must not be 0.
+  /// @param is_key_frame indicates whether the sample is a key frame.
+  static std::shared_ptr<MediaSample> FromSharedBuffer(
+      std::shared_ptr<const uint8_t> buffer,
+      size_t offset,
+      size_t size,
+      bool is_key_frame);
+
   /// Create a MediaSample object with default members.
   static std::shared_ptr<MediaSample> CreateEmptyMediaSample();
 
@@ -127,6 +168,19 @@ class MediaSample {
     return data_size_;
   }
 
+  /// @return the shared buffer backing data(), for consumers that need to
+  ///         keep the payload alive without copying it.
+  std::shared_ptr<const uint8_t> shared_data() const {
+    DCHECK(!end_of_stream());
+    return data_;
+  }
+
+  /// @return a mutable pointer to the payload, detaching it first if it is
+  ///         still shared with other samples (copy-on-write). Cheap when this
+  ///         sample is the sole owner, e.g. a sample that was never cloned or
+  ///         whose clones have been released.
+  uint8_t* writable_data();
+
   const uint8_t* side_data() const { return side_data_.get(); }
 
   size_t side_data_size() const { return side_data_size_; }
@@ -145,6 +199,14 @@ class MediaSample {
     decrypt_config_ = std::move(decrypt_config);
   }
 
+  /// NALU extent table attached when the frame was first parsed; empty when
+  /// the sample has not been annotated. The table describes data() and
+  /// remains valid across subsample encryption, which preserves NALU sizes.
+  const std::vector<NaluExtent>& nalu_extents() const { return nalu_extents_; }
+  void set_nalu_extents(std::vector<NaluExtent> nalu_extents) {
+    nalu_extents_ = std::move(nalu_extents);
+  }
+
   // If there's no data in this buffer, it represents end of stream.
   bool end_of_stream() const { return data_size_ == 0; }
 
@@ -190,6 +252,9 @@ class MediaSample {
   // Decrypt configuration.
   std::unique_ptr<DecryptConfig> decrypt_config_;
 
+  // NALU extent table; empty unless attached by the demuxer or first parser.
+  std::vector<NaluExtent> nalu_extents_;
+
   DISALLOW_COPY_AND_ASSIGN(MediaSample);
 };
 
@@ -0,0 +1,57 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/base/memory_tracker.h>
+
+#include <absl/log/check.h>
+
+namespace shaka {
+namespace media {
+
+MemoryTracker::MemoryTracker(uint64_t budget_bytes)
+    : budget_bytes_(budget_bytes),
+      pressure_bytes_(budget_bytes / 4 * 3),
+      release_bytes_(budget_bytes / 2) {
+  DCHECK_GT(budget_bytes, 0u);
+}
+
+void MemoryTracker::Add(uint64_t bytes) {
+  bool fire_callback = false;
+  uint64_t current_bytes = 0;
+  {
+    absl::MutexLock lock(&mutex_);
+    current_bytes_ += bytes;
+    if (!under_pressure_ && current_bytes_ >= pressure_bytes_) {
+      under_pressure_ = true;
+      fire_callback = pressure_callback_ != nullptr;
+      current_bytes = current_bytes_;
+    }
+  }
+  // Outside the lock so the callback may query the tracker.
+  if (fire_callback)
+    pressure_callback_(current_bytes, budget_bytes_);
+}
+
+void MemoryTracker::Remove(uint64_t bytes) {
+  absl::MutexLock lock(&mutex_);
+  DCHECK_GE(current_bytes_, bytes);
+  current_bytes_ -= bytes;
+  if (under_pressure_ && current_bytes_ < release_bytes_)
+    under_pressure_ = false;
+}
+
+bool MemoryTracker::UnderPressure() const {
+  absl::MutexLock lock(&mutex_);
+  return under_pressure_;
+}
+
+uint64_t MemoryTracker::current_bytes() const {
+  absl::MutexLock lock(&mutex_);
+  return current_bytes_;
+}
+
+}  // namespace media
+}  // namespace shaka
@@ -0,0 +1,73 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_MEDIA_BASE_MEMORY_TRACKER_H_
+#define PACKAGER_MEDIA_BASE_MEMORY_TRACKER_H_
+
+#include <cstdint>
+#include <functional>
+
+#include <absl/base/thread_annotations.h>
+#include <absl/synchronization/mutex.h>
+
+namespace shaka {
+namespace media {
+
+/// Thread-safe byte accounting for the buffered media of one packaging job.
+/// The queues along a job's pipeline (demuxer dispatch queues, handler
+/// sample queues) register the payload bytes they hold, so the job's total
+/// buffered memory is known at any time. When the total crosses the
+/// pressure watermark (three quarters of the budget) the tracker reports
+/// pressure and fires the pressure callback once; owners react by spilling
+/// to disk or throttling the parser. Pressure holds until usage falls back
+/// below half of the budget, giving the hysteresis that keeps queues from
+/// oscillating between spilling and refilling at the boundary.
+class MemoryTracker {
+ public:
+  /// Called when buffered bytes first cross the pressure watermark, once
+  /// per pressure episode, from whichever packaging thread pushed the
+  /// crossing bytes.
+  using PressureCallback =
+      std::function<void(uint64_t current_bytes, uint64_t budget_bytes)>;
+
+  /// @param budget_bytes is the job's byte budget; must be nonzero.
+  explicit MemoryTracker(uint64_t budget_bytes);
+
+  /// Must be called before the first Add(); not thread-safe against it.
+  void set_pressure_callback(PressureCallback callback) {
+    pressure_callback_ = std::move(callback);
+  }
+
+  /// Account @a bytes of newly buffered payload.
+  void Add(uint64_t bytes);
+  /// Release @a bytes of previously added payload.
+  void Remove(uint64_t bytes);
+
+  /// True from the moment usage crosses the pressure watermark until it
+  /// falls back below the release watermark.
+  bool UnderPressure() const;
+
+  uint64_t current_bytes() const;
+  uint64_t budget_bytes() const { return budget_bytes_; }
+
+ private:
+  MemoryTracker(const MemoryTracker&) = delete;
+  MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+  const uint64_t budget_bytes_;
+  const uint64_t pressure_bytes_;
+  const uint64_t release_bytes_;
+  PressureCallback pressure_callback_;
+
+  mutable absl::Mutex mutex_;
+  uint64_t current_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool under_pressure_ ABSL_GUARDED_BY(mutex_) = false;
+};
+
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_MEDIA_BASE_MEMORY_TRACKER_H_
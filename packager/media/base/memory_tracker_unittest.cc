@@ -0,0 +1,71 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/base/memory_tracker.h>
+
+#include <gtest/gtest.h>
+
+namespace shaka {
+namespace media {
+
+TEST(MemoryTrackerTest, AccountsBytes) {
+  MemoryTracker tracker(1000);
+  EXPECT_EQ(0u, tracker.current_bytes());
+  EXPECT_EQ(1000u, tracker.budget_bytes());
+
+  tracker.Add(300);
+  tracker.Add(200);
+  EXPECT_EQ(500u, tracker.current_bytes());
+  tracker.Remove(500);
+  EXPECT_EQ(0u, tracker.current_bytes());
+}
+
+TEST(MemoryTrackerTest, PressureWithHysteresis) {
+  MemoryTracker tracker(1000);
+  EXPECT_FALSE(tracker.UnderPressure());
+
+  // Pressure starts at three quarters of the budget.
+  tracker.Add(749);
+  EXPECT_FALSE(tracker.UnderPressure());
+  tracker.Add(1);
+  EXPECT_TRUE(tracker.UnderPressure());
+
+  // ... and holds until usage falls below half of it.
+  tracker.Remove(200);
+  EXPECT_TRUE(tracker.UnderPressure());
+  tracker.Remove(51);
+  EXPECT_FALSE(tracker.UnderPressure());
+}
+
+TEST(MemoryTrackerTest, CallbackFiresOncePerEpisode) {
+  MemoryTracker tracker(1000);
+  int calls = 0;
+  uint64_t reported_bytes = 0;
+  tracker.set_pressure_callback(
+      [&](uint64_t current_bytes, uint64_t budget_bytes) {
+        ++calls;
+        reported_bytes = current_bytes;
+        EXPECT_EQ(1000u, budget_bytes);
+      });
+
+  tracker.Add(800);
+  EXPECT_EQ(1, calls);
+  EXPECT_EQ(800u, reported_bytes);
+
+  // Still under pressure; more additions do not re-fire.
+  tracker.Add(100);
+  EXPECT_EQ(1, calls);
+
+  // Release and cross again: a new episode fires again.
+  tracker.Remove(600);
+  EXPECT_FALSE(tracker.UnderPressure());
+  tracker.Add(500);
+  EXPECT_EQ(2, calls);
+  EXPECT_EQ(800u, reported_bytes);
+}
+
+}  // namespace media
+}  // namespace shaka
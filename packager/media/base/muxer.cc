@@ -9,11 +9,14 @@
 #include <algorithm>
 #include <chrono>
 
+#include <absl/log/check.h>
+
 #include <packager/macros/compiler.h>
 #include <packager/macros/logging.h>
 #include <packager/macros/status.h>
 #include <packager/media/base/media_sample.h>
 #include <packager/media/base/muxer_util.h>
+#include <packager/utils/trace_event.h>
 
 namespace shaka {
 namespace media {
@@ -28,6 +31,14 @@ Muxer::Muxer(const MuxerOptions& options)
   // support one file per Representation per Period when there are Ad Cues.
   if (options_.output_file_name.find("$") != std::string::npos)
     output_file_template_ = options_.output_file_name;
+
+  // The segment template has been validated before the muxer is created;
+  // compile it once so per-segment name generation does not re-parse it.
+  if (!options_.segment_template.empty()) {
+    const Status status =
+        segment_name_template_.Compile(options_.segment_template);
+    DCHECK_EQ(Status::OK, status);
+  }
 }
 
 Muxer::~Muxer() {}
@@ -69,6 +80,22 @@ Status Muxer::Process(std::unique_ptr<StreamData> stream_data) {
           muxer_listener_->OnEncryptionStart();
         }
       }
+      // Advance virtual time to the end of the segment before finalizing it,
+      // so the manifest updates triggered by the segment see the new time.
+      if (virtual_clock_ && stream_data->stream_index < streams_.size()) {
+        const int32_t time_scale =
+            streams_[stream_data->stream_index]->time_scale();
+        if (time_scale > 0) {
+          virtual_clock_->AdvanceToMediaTime(
+              static_cast<double>(segment_info.start_time +
+                                  segment_info.duration) /
+              time_scale);
+        }
+      }
+      TraceBuffer::ScopedEvent trace("muxer", "finalize_segment",
+                                     options().output_file_name.empty()
+                                         ? options().segment_template
+                                         : options().output_file_name);
       return FinalizeSegment(stream_data->stream_index, segment_info);
     }
     case StreamDataType::kMediaSample:
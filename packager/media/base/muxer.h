@@ -14,10 +14,12 @@
 
 #include <packager/media/base/media_handler.h>
 #include <packager/media/base/muxer_options.h>
+#include <packager/media/base/muxer_util.h>
 #include <packager/media/event/muxer_listener.h>
 #include <packager/media/event/progress_listener.h>
 #include <packager/mpd/base/mpd_builder.h>
 #include <packager/status.h>
+#include <packager/utils/virtual_clock.h>
 
 namespace shaka {
 namespace media {
@@ -56,6 +58,17 @@ class Muxer : public MediaHandler {
   /// @param clock is the Clock to be injected.
   void set_clock(std::shared_ptr<Clock> clock) { clock_ = clock; }
 
+  /// Inject a media-time driven clock (see
+  /// PackagingParams::enable_virtual_clock). Like set_clock(), but the muxer
+  /// also advances the clock to the end of every segment it finalizes, so
+  /// everything keyed on the clock sees time progress at the pipeline's
+  /// packaging speed instead of wall clock speed.
+  /// @param clock is the VirtualClock to be injected.
+  void set_virtual_clock(std::shared_ptr<VirtualClock> clock) {
+    virtual_clock_ = clock;
+    clock_ = std::move(clock);
+  }
+
  protected:
   /// @name MediaHandler implementation overrides.
   /// @{
@@ -65,6 +78,12 @@ class Muxer : public MediaHandler {
   /// @}
 
   const MuxerOptions& options() const { return options_; }
+  /// @return The precompiled form of |options().segment_template|, for
+  ///         per-segment name generation. Only valid if the template is
+  ///         non-empty.
+  const SegmentNameTemplate& segment_name_template() const {
+    return segment_name_template_;
+  }
   MuxerListener* muxer_listener() { return muxer_listener_.get(); }
   ProgressListener* progress_listener() { return progress_listener_.get(); }
 
@@ -105,6 +124,7 @@ class Muxer : public MediaHandler {
   Status ReinitializeMuxer(int64_t timestamp);
 
   MuxerOptions options_;
+  SegmentNameTemplate segment_name_template_;
   std::vector<std::shared_ptr<const StreamInfo>> streams_;
   std::vector<uint8_t> current_key_id_;
   bool encryption_started_ = false;
@@ -113,6 +133,8 @@ class Muxer : public MediaHandler {
   std::unique_ptr<MuxerListener> muxer_listener_;
   std::unique_ptr<ProgressListener> progress_listener_;
   std::shared_ptr<Clock> clock_;
+  // Set when |clock_| is a VirtualClock; advanced on every finalized segment.
+  std::shared_ptr<VirtualClock> virtual_clock_;
 
   // In VOD single segment case with Ad Cues, |output_file_name| is allowed to
   // be a template. In this case, there will be NumAdCues + 1 files generated.
@@ -27,6 +27,13 @@ struct MuxerOptions {
   // compensate for negative timestamps in the input.
   int32_t transport_stream_timestamp_offset_ms = 0;
 
+  /// If nonzero, MPEG2-TS segments are muxed at this constant rate, in bits
+  /// per second: null packets are interleaved on a precomputed schedule so
+  /// every segment occupies exactly its duration at the rate, and PCRs are
+  /// restamped to the scheduled packet departure times. Zero keeps the
+  /// default variable-rate output.
+  int64_t ts_mux_rate_bps = 0;
+
   /// Output file name. If segment_template is not specified, the Muxer
   /// generates this single output file with all segments concatenated;
   /// Otherwise, it specifies the init segment name.
@@ -41,6 +48,11 @@ struct MuxerOptions {
   /// Specify temporary directory for intermediate files.
   std::string temp_dir;
 
+  /// Initial value of the zero-based counter substituted for $Number$ in
+  /// @a segment_template. Non-zero when resuming a live channel from a
+  /// checkpoint, so new segments continue the numbering of the previous run.
+  uint64_t initial_segment_number = 0;
+
   /// User-specified bit rate for the media stream. If zero, the muxer will
   /// attempt to estimate.
   uint32_t bandwidth = 0;
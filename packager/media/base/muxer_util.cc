@@ -6,14 +6,15 @@
 
 #include <packager/media/base/muxer_util.h>
 
+#include <algorithm>
 #include <cinttypes>
+#include <cstdio>
 #include <string>
 #include <vector>
 
 #include <absl/log/check.h>
 #include <absl/log/log.h>
 #include <absl/strings/numbers.h>
-#include <absl/strings/str_format.h>
 #include <absl/strings/str_split.h>
 
 #include <packager/media/base/video_stream_info.h>
@@ -38,6 +39,17 @@ Status ValidateFormatTag(const std::string& format_tag) {
       error::INVALID_ARGUMENT,
       "Format tag should follow this prototype: %0[width]d if exist.");
 }
+
+// Appends |value| zero-padded to at least |min_width| digits. The digits are
+// rendered into a stack buffer with a constant format string, so there is no
+// format parsing on this path.
+void AppendUint64(uint64_t value, int min_width, std::string* out) {
+  char digits[24];  // A uint64_t has at most 20 digits.
+  const int num_digits = snprintf(digits, sizeof(digits), "%" PRIu64, value);
+  if (num_digits < min_width)
+    out->append(min_width - num_digits, '0');
+  out->append(digits, num_digits);
+}
 }  // namespace
 
 namespace media {
@@ -108,66 +120,102 @@ Status ValidateSegmentTemplate(const std::string& segment_template) {
   return Status::OK;
 }
 
-std::string GetSegmentName(const std::string& segment_template,
-                           int64_t segment_start_time,
-                           uint32_t segment_index,
-                           uint32_t bandwidth) {
-  DCHECK_EQ(Status::OK, ValidateSegmentTemplate(segment_template));
+Status SegmentNameTemplate::Compile(const std::string& segment_template) {
+  Status status = ValidateSegmentTemplate(segment_template);
+  if (!status.ok())
+    return status;
+
+  ops_.clear();
+  reserve_size_ = 0;
 
   std::vector<std::string> splits = absl::StrSplit(segment_template, "$");
   // "$" always appears in pairs, so there should be odd number of splits.
   DCHECK_EQ(1u, splits.size() % 2);
 
-  std::string segment_name;
   for (size_t i = 0; i < splits.size(); ++i) {
-    // Every second substring in split output should be an identifier.
-    // Simply copy the non-identifier part.
-    if (i % 2 == 0) {
-      segment_name += splits[i];
-      continue;
-    }
-    if (splits[i].empty()) {
-      // "$$" is an escape sequence, replaced with a single "$".
-      segment_name += "$";
+    // Every second substring in split output should be an identifier; the
+    // others are literal spans. "$$" is an escape sequence for a single "$".
+    if (i % 2 == 0 || splits[i].empty()) {
+      const std::string literal = (i % 2 == 0) ? splits[i] : "$";
+      if (literal.empty())
+        continue;
+      // Merge adjacent literal spans into one op.
+      if (!ops_.empty() && ops_.back().field == Field::kLiteral)
+        ops_.back().literal += literal;
+      else
+        ops_.push_back({Field::kLiteral, literal, 0});
+      reserve_size_ += literal.size();
       continue;
     }
-    size_t format_pos = splits[i].find('%');
-    std::string identifier = splits[i].substr(0, format_pos);
+
+    const size_t format_pos = splits[i].find('%');
+    const std::string identifier = splits[i].substr(0, format_pos);
     DCHECK(identifier == "Number" || identifier == "Time" ||
            identifier == "Bandwidth");
 
-    std::string format_tag;
+    // Format tags follow the prototype %0[width]d and have already been
+    // validated; no tag means the default "%01d".
+    int min_width = 1;
     if (format_pos != std::string::npos) {
-      format_tag = splits[i].substr(format_pos);
-      DCHECK_EQ(Status::OK, ValidateFormatTag(format_tag));
-      // Replace %d formatting to correctly format uint64_t.
-      format_tag = format_tag.substr(0, format_tag.size() - 1) + PRIu64;
-    } else {
-      // Default format tag "%01d", modified to format uint64_t correctly.
-      format_tag = "%01" PRIu64;
+      unsigned width = 0;
+      CHECK(absl::SimpleAtoi(
+          splits[i].substr(format_pos + 2, splits[i].size() - format_pos - 3),
+          &width));
+      min_width = static_cast<int>(width);
     }
 
-    // absl::StrFormat requires compile-time constants for format strings.
-    // If you don't have that, you build the formatter using this interface
-    // instead.
-    std::vector<absl::FormatArg> format_args;
-    absl::UntypedFormatSpec format(format_tag);
+    Field field;
     if (identifier == "Number") {
-      // SegmentNumber starts from 1.
-      format_args.emplace_back(static_cast<uint64_t>(segment_index + 1));
+      field = Field::kNumber;
     } else if (identifier == "Time") {
-      format_args.emplace_back(static_cast<uint64_t>(segment_start_time));
-    } else if (identifier == "Bandwidth") {
-      format_args.emplace_back(static_cast<uint64_t>(bandwidth));
+      field = Field::kTime;
+    } else {
+      field = Field::kBandwidth;
     }
+    ops_.push_back({field, std::string(), min_width});
+    reserve_size_ += std::max(min_width, 20);
+  }
+  return Status::OK;
+}
 
-    std::string format_output;
-    if (absl::FormatUntyped(&format_output, format, format_args)) {
-      segment_name += format_output;
+std::string SegmentNameTemplate::Apply(int64_t segment_start_time,
+                                       uint32_t segment_index,
+                                       uint32_t bandwidth) const {
+  std::string segment_name;
+  segment_name.reserve(reserve_size_);
+  for (const Op& op : ops_) {
+    switch (op.field) {
+      case Field::kLiteral:
+        segment_name += op.literal;
+        break;
+      case Field::kNumber:
+        // SegmentNumber starts from 1.
+        AppendUint64(static_cast<uint64_t>(segment_index) + 1, op.min_width,
+                     &segment_name);
+        break;
+      case Field::kTime:
+        AppendUint64(static_cast<uint64_t>(segment_start_time), op.min_width,
+                     &segment_name);
+        break;
+      case Field::kBandwidth:
+        AppendUint64(bandwidth, op.min_width, &segment_name);
+        break;
     }
   }
   return segment_name;
 }
 
+std::string GetSegmentName(const std::string& segment_template,
+                           int64_t segment_start_time,
+                           uint32_t segment_index,
+                           uint32_t bandwidth) {
+  SegmentNameTemplate compiled;
+  const Status status = compiled.Compile(segment_template);
+  DCHECK_EQ(Status::OK, status);
+  if (!status.ok())
+    return std::string();
+  return compiled.Apply(segment_start_time, segment_index, bandwidth);
+}
+
 }  // namespace media
 }  // namespace shaka
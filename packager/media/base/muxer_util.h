@@ -10,6 +10,8 @@
 #define PACKAGER_MEDIA_BASE_MUXER_UTIL_H_
 
 #include <cstdint>
+#include <string>
+#include <vector>
 
 #include <packager/status.h>
 
@@ -18,6 +20,41 @@ namespace media {
 
 class StreamInfo;
 
+/// Precompiled form of a segment template. The template string is parsed once
+/// by Compile() into a fixed list of literal spans and field formatters;
+/// Apply() then renders a segment name without re-parsing the template, which
+/// matters when names are generated per segment for many renditions.
+class SegmentNameTemplate {
+ public:
+  SegmentNameTemplate() = default;
+
+  /// Compiles @a segment_template, which must comply with ISO/IEC
+  /// 23009-1:2012 5.3.9.4.4. Replaces any previously compiled template.
+  /// @return OK if the template is valid, an error status otherwise.
+  Status Compile(const std::string& segment_template);
+
+  /// Renders the segment name. Compile() must have succeeded beforehand.
+  /// @param segment_start_time specifies the segment start time.
+  /// @param segment_index specifies the segment index.
+  /// @param bandwidth represents the bit rate, in bits/sec, of the stream.
+  /// @return The segment name with identifiers substituted.
+  std::string Apply(int64_t segment_start_time,
+                    uint32_t segment_index,
+                    uint32_t bandwidth) const;
+
+ private:
+  enum class Field { kLiteral, kNumber, kTime, kBandwidth };
+  struct Op {
+    Field field;
+    std::string literal;  // Set iff |field| is kLiteral.
+    int min_width;        // Zero-pad width. Set iff |field| is not kLiteral.
+  };
+
+  std::vector<Op> ops_;
+  // Capacity hint for the rendered name.
+  size_t reserve_size_ = 0;
+};
+
 /// Validates the segment template against segment URL construction rule
 /// specified in ISO/IEC 23009-1:2012 5.3.9.4.4.
 /// @param segment_template is the template to be validated.
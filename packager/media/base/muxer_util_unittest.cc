@@ -142,6 +142,20 @@ TEST(MuxerUtilTest, GetSegmentNameWithIndexZero) {
                            kBandwidth));
 }
 
+TEST(MuxerUtilTest, SegmentNameTemplate) {
+  SegmentNameTemplate compiled;
+  EXPECT_NE(Status::OK, compiled.Compile("$Garbage$"));
+  ASSERT_EQ(Status::OK, compiled.Compile("seg-$Number%05d$-$Bandwidth$.m4s"));
+
+  // The compiled template can be applied repeatedly without re-parsing.
+  EXPECT_EQ("seg-00001-1234.m4s", compiled.Apply(0, 0, 1234));
+  EXPECT_EQ("seg-00012-1234.m4s", compiled.Apply(180180, 11, 1234));
+
+  // Recompiling replaces the previous template.
+  ASSERT_EQ(Status::OK, compiled.Compile("$$$Time$$$"));
+  EXPECT_EQ("$180180$", compiled.Apply(180180, 11, 1234));
+}
+
 TEST(MuxerUtilTest, GetSegmentNameLargeTime) {
   const int64_t kSegmentStartTime = 1601599839840ULL;
   const uint32_t kSegmentIndex = 8888888;
@@ -0,0 +1,101 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_MEDIA_BASE_OBJECT_POOL_H_
+#define PACKAGER_MEDIA_BASE_OBJECT_POOL_H_
+
+#include <cstddef>
+#include <new>
+
+namespace shaka {
+namespace media {
+
+/// Recycling allocator for the fixed-size objects churned on the sample path
+/// (StreamData wrappers, MediaSample headers). Freed slots go onto a
+/// thread-local free list and are handed back to subsequent allocations, so
+/// steady-state packaging stops hitting the global heap for these objects.
+/// A true arena is not practical here because samples are released in an
+/// unpredictable order as they drain through the handler graph; a per-type
+/// free list gives the same zero-global-allocation steady state without
+/// lifetime coupling.
+///
+/// Slots may be freed on a different thread than the one that allocated them;
+/// they are simply recycled by the freeing thread. Lists are capped at
+/// kMaxFreeSlots entries per thread and overflow falls back to the global
+/// heap, which bounds memory held by idle threads.
+template <typename T>
+class ObjectPool {
+ public:
+  /// Allocate a slot of sizeof(T) bytes, reusing a recycled slot when one is
+  /// available. Sizes other than sizeof(T) (e.g. a hypothetical subclass) fall
+  /// back to the global heap.
+  static void* Allocate(size_t size) {
+    if (size != sizeof(T))
+      return ::operator new(size);
+    FreeList& list = free_list();
+    if (list.head) {
+      FreeNode* node = list.head;
+      list.head = node->next;
+      list.size--;
+      return node;
+    }
+    return ::operator new(sizeof(T));
+  }
+
+  /// Return a slot to the pool (or to the global heap if the slot is foreign
+  /// sized or this thread's list is full).
+  static void Deallocate(void* ptr, size_t size) {
+    if (!ptr)
+      return;
+    if (size != sizeof(T)) {
+      ::operator delete(ptr);
+      return;
+    }
+    FreeList& list = free_list();
+    if (list.size >= kMaxFreeSlots) {
+      ::operator delete(ptr);
+      return;
+    }
+    FreeNode* node = static_cast<FreeNode*>(ptr);
+    node->next = list.head;
+    list.head = node;
+    list.size++;
+  }
+
+ private:
+  static const size_t kMaxFreeSlots = 4096;
+
+  // A freed slot is reused to hold the free-list link, so slots must be at
+  // least pointer sized; that holds for every pooled type here.
+  static_assert(sizeof(T) >= sizeof(void*), "Pooled type too small");
+
+  struct FreeNode {
+    FreeNode* next;
+  };
+
+  struct FreeList {
+    FreeNode* head = nullptr;
+    size_t size = 0;
+
+    ~FreeList() {
+      while (head) {
+        FreeNode* node = head;
+        head = node->next;
+        ::operator delete(node);
+      }
+    }
+  };
+
+  static FreeList& free_list() {
+    static thread_local FreeList list;
+    return list;
+  }
+};
+
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_MEDIA_BASE_OBJECT_POOL_H_
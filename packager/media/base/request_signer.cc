@@ -71,7 +71,21 @@ RsaRequestSigner* RsaRequestSigner::CreateSigner(
 
 bool RsaRequestSigner::GenerateSignature(const std::string& message,
                                          std::string* signature) {
-  return rsa_private_key_->GenerateSignature(message, signature);
+  // License requests are signed again unchanged on retries and when several
+  // streams share a crypto period. RSASSA-PSS is randomized, but any valid
+  // signature for a message verifies, so reuse the previous signature for an
+  // identical message instead of doing another private-key operation.
+  absl::MutexLock lock(&mutex_);
+  if (!last_signature_.empty() && message == last_message_) {
+    *signature = last_signature_;
+    return true;
+  }
+
+  if (!rsa_private_key_->GenerateSignature(message, signature))
+    return false;
+  last_message_ = message;
+  last_signature_ = *signature;
+  return true;
 }
 
 }  // namespace media
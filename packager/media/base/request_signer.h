@@ -11,6 +11,9 @@
 #include <string>
 #include <vector>
 
+#include <absl/base/thread_annotations.h>
+#include <absl/synchronization/mutex.h>
+
 #include <packager/macros/classes.h>
 
 namespace shaka {
@@ -65,7 +68,10 @@ class AesRequestSigner : public RequestSigner {
   DISALLOW_COPY_AND_ASSIGN(AesRequestSigner);
 };
 
-/// RsaRequestSigner uses RSA-PSS signing.
+/// RsaRequestSigner uses RSA-PSS signing. The signer keeps the private key
+/// contexts alive for its whole lifetime and caches the signature of the most
+/// recently signed message, so retried or repeated requests do not pay for
+/// another private-key operation.
 class RsaRequestSigner : public RequestSigner {
  public:
   ~RsaRequestSigner() override;
@@ -85,6 +91,10 @@ class RsaRequestSigner : public RequestSigner {
 
   std::unique_ptr<RsaPrivateKey> rsa_private_key_;
 
+  absl::Mutex mutex_;
+  std::string last_message_ ABSL_GUARDED_BY(mutex_);
+  std::string last_signature_ ABSL_GUARDED_BY(mutex_);
+
   DISALLOW_COPY_AND_ASSIGN(RsaRequestSigner);
 };
 
@@ -112,6 +112,17 @@ bool RsaPrivateKey::Deserialize(const std::string& serialized_key) {
     return false;
   }
 
+  // mbedtls defers part of the private key setup until the first private-key
+  // operation: the CRT helper values and the initial blinding pair are only
+  // computed on demand. Do one throwaway signature now so that the cost is
+  // paid at key load time rather than on the first request signed with this
+  // key.
+  std::string warm_up_signature;
+  if (!GenerateSignature("warm-up", &warm_up_signature)) {
+    LOG(ERROR) << "RSA private key failed warm-up signing.";
+    return false;
+  }
+
   return true;
 }
 
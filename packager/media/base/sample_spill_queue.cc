@@ -0,0 +1,176 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/base/sample_spill_queue.h>
+
+#include <iterator>
+
+#include <absl/log/check.h>
+#include <absl/log/log.h>
+
+#include <packager/file.h>
+#include <packager/file/file_util.h>
+#include <packager/macros/status.h>
+#include <packager/media/base/memory_tracker.h>
+
+namespace shaka {
+namespace media {
+
+SampleSpillQueue::~SampleSpillQueue() {
+  if (memory_tracker_)
+    memory_tracker_->Remove(in_memory_bytes_);
+  if (spill_file_) {
+    spill_file_->Close();
+    if (!File::Delete(spill_file_path_.c_str()))
+      LOG(WARNING) << "Failed to delete spill file " << spill_file_path_;
+  }
+}
+
+void SampleSpillQueue::EnableSpill(const std::string& temp_dir,
+                                   uint64_t memory_limit_bytes) {
+  DCHECK(entries_.empty());
+  temp_dir_ = temp_dir;
+  memory_limit_bytes_ = memory_limit_bytes;
+}
+
+void SampleSpillQueue::set_memory_tracker(MemoryTracker* memory_tracker) {
+  DCHECK(entries_.empty());
+  memory_tracker_ = memory_tracker;
+}
+
+namespace {
+
+bool HasPayload(const StreamData& data) {
+  return data.stream_data_type == StreamDataType::kMediaSample &&
+         data.media_sample && !data.media_sample->end_of_stream();
+}
+
+}  // namespace
+
+Status SampleSpillQueue::PushBack(std::unique_ptr<StreamData> data) {
+  Entry entry;
+  entry.data = std::move(data);
+  if (HasPayload(*entry.data)) {
+    const uint64_t payload_bytes = entry.data->media_sample->data_size();
+    in_memory_bytes_ += payload_bytes;
+    if (memory_tracker_)
+      memory_tracker_->Add(payload_bytes);
+  }
+  entries_.push_back(std::move(entry));
+
+  // Job-level memory pressure shrinks the effective budget to zero, so every
+  // payload but the newest spills even when this queue is under its own
+  // limit (or has no limit of its own).
+  uint64_t effective_limit_bytes = memory_limit_bytes_;
+  bool spill_enabled = memory_limit_bytes_ > 0;
+  if (memory_tracker_ && memory_tracker_->UnderPressure()) {
+    effective_limit_bytes = 0;
+    spill_enabled = true;
+  }
+  if (!spill_enabled || in_memory_bytes_ <= effective_limit_bytes)
+    return Status::OK;
+
+  // Spill newest-first but never the entry just pushed: entries near the
+  // back wait the longest before being popped, and the pushing handler may
+  // keep adjusting the newest sample's header (e.g. extending its duration)
+  // until the next push. The budget can therefore be exceeded by at most
+  // one payload.
+  for (auto it = std::prev(entries_.end());
+       in_memory_bytes_ > effective_limit_bytes && it != entries_.begin();) {
+    --it;
+    if (it->spilled_sample || !HasPayload(*it->data))
+      continue;
+    RETURN_IF_ERROR(SpillEntry(&*it));
+    in_memory_bytes_ -= it->spill_size;
+    if (memory_tracker_)
+      memory_tracker_->Remove(it->spill_size);
+  }
+  return Status::OK;
+}
+
+Status SampleSpillQueue::PopFront(std::unique_ptr<StreamData>* data) {
+  DCHECK(data);
+  DCHECK(!entries_.empty());
+  Entry& entry = entries_.front();
+
+  if (entry.spilled_sample) {
+    std::shared_ptr<uint8_t> payload(new uint8_t[entry.spill_size],
+                                     std::default_delete<uint8_t[]>());
+    if (!spill_file_->Seek(entry.spill_offset)) {
+      return Status(error::FILE_FAILURE,
+                    "Cannot seek in spill file " + spill_file_path_);
+    }
+    uint64_t bytes_read = 0;
+    while (bytes_read < entry.spill_size) {
+      const int64_t read = spill_file_->Read(payload.get() + bytes_read,
+                                             entry.spill_size - bytes_read);
+      if (read <= 0) {
+        return Status(error::FILE_FAILURE,
+                      "Cannot read back spilled sample from " +
+                          spill_file_path_);
+      }
+      bytes_read += read;
+    }
+    entry.spilled_sample->TransferData(std::move(payload), entry.spill_size);
+  } else if (entry.data->stream_data_type == StreamDataType::kMediaSample &&
+             entry.data->media_sample &&
+             !entry.data->media_sample->end_of_stream()) {
+    const uint64_t payload_bytes = entry.data->media_sample->data_size();
+    DCHECK_GE(in_memory_bytes_, payload_bytes);
+    in_memory_bytes_ -= payload_bytes;
+    if (memory_tracker_)
+      memory_tracker_->Remove(payload_bytes);
+  }
+
+  *data = std::move(entry.data);
+  entries_.pop_front();
+  return Status::OK;
+}
+
+Status SampleSpillQueue::SpillEntry(Entry* entry) {
+  if (!spill_file_) {
+    if (!TempFilePath(temp_dir_, &spill_file_path_)) {
+      return Status(error::FILE_FAILURE,
+                    "Cannot create a temporary spill file.");
+    }
+    spill_file_ = File::Open(spill_file_path_.c_str(), "w+");
+    if (!spill_file_) {
+      return Status(error::FILE_FAILURE,
+                    "Cannot open spill file " + spill_file_path_);
+    }
+  }
+
+  const MediaSample& sample = *entry->data->media_sample;
+  if (!spill_file_->Seek(spill_file_size_)) {
+    return Status(error::FILE_FAILURE,
+                  "Cannot seek in spill file " + spill_file_path_);
+  }
+  uint64_t bytes_written = 0;
+  while (bytes_written < sample.data_size()) {
+    const int64_t written = spill_file_->Write(
+        sample.data() + bytes_written, sample.data_size() - bytes_written);
+    if (written <= 0) {
+      return Status(error::FILE_FAILURE,
+                    "Cannot write sample to spill file " + spill_file_path_);
+    }
+    bytes_written += written;
+  }
+
+  entry->spill_offset = spill_file_size_;
+  entry->spill_size = sample.data_size();
+  spill_file_size_ += sample.data_size();
+
+  // Replace the buffered sample with a payload-less clone. The original
+  // object is left untouched since other branches of the graph may still
+  // hold it; only this queue's reference on the payload is released.
+  entry->spilled_sample = sample.Clone();
+  entry->spilled_sample->TransferData(nullptr, 0);
+  entry->data->media_sample = entry->spilled_sample;
+  return Status::OK;
+}
+
+}  // namespace media
+}  // namespace shaka
@@ -0,0 +1,112 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_MEDIA_BASE_SAMPLE_SPILL_QUEUE_H_
+#define PACKAGER_MEDIA_BASE_SAMPLE_SPILL_QUEUE_H_
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+
+#include <packager/media/base/media_handler.h>
+#include <packager/status.h>
+
+namespace shaka {
+
+class File;
+
+namespace media {
+
+class MemoryTracker;
+
+/// A FIFO of StreamData whose buffered media sample payloads are
+/// transparently spilled to a temporary file once the in-memory payload
+/// bytes exceed a limit, and read back when entries are popped. Handlers
+/// that can buffer many seconds of content waiting for a sync point (cue
+/// alignment, trick play) use it to cap their worst-case memory. Entries
+/// keep their headers (type, timestamps, flags) in memory, so peeking at
+/// front() or back() never touches the disk; payloads are appended to the
+/// file in arrival order and popped in the same order, so rehydration is a
+/// sequential read that the OS read-ahead stays in front of.
+///
+/// Without EnableSpill() the queue behaves like a plain list. Not
+/// thread-safe; meant to be owned by a single handler.
+class SampleSpillQueue {
+ public:
+  SampleSpillQueue() = default;
+  ~SampleSpillQueue();
+
+  /// Turn spilling on. Must be called before the first PushBack().
+  /// @param temp_dir is where the spill file is created; empty uses the OS
+  ///        temporary directory.
+  /// @param memory_limit_bytes is the payload byte budget kept in memory;
+  ///        samples pushed beyond it go to the spill file.
+  void EnableSpill(const std::string& temp_dir, uint64_t memory_limit_bytes);
+
+  /// Attach the owning job's memory accounting. Buffered payload bytes are
+  /// registered with @a memory_tracker, and while the tracker reports
+  /// pressure every payload but the newest is spilled regardless of this
+  /// queue's own budget (EnableSpill() must still have been called so the
+  /// spill file location is known). Must be called before the first
+  /// PushBack(); @a memory_tracker must outlive the queue.
+  void set_memory_tracker(MemoryTracker* memory_tracker);
+
+  /// Append an entry. When the memory budget is exceeded, older media
+  /// sample payloads are written to the spill file and dropped from memory;
+  /// the entry just pushed is never spilled, so the caller may keep
+  /// adjusting its header (e.g. extending a duration) until the next push.
+  Status PushBack(std::unique_ptr<StreamData> data);
+
+  /// Pop the oldest entry into @a data, reading its payload back from the
+  /// spill file if it was spilled.
+  Status PopFront(std::unique_ptr<StreamData>* data);
+
+  /// Peek the oldest entry. A spilled entry's media sample has no payload
+  /// attached, but its header fields are valid.
+  const StreamData& front() const { return *entries_.front().data; }
+  /// Peek the newest entry; same caveat as front().
+  const StreamData& back() const { return *entries_.back().data; }
+
+  size_t size() const { return entries_.size(); }
+  bool empty() const { return entries_.empty(); }
+
+ private:
+  SampleSpillQueue(const SampleSpillQueue&) = delete;
+  SampleSpillQueue& operator=(const SampleSpillQueue&) = delete;
+
+  struct Entry {
+    std::unique_ptr<StreamData> data;
+    // Set when the payload lives in the spill file: the sample object whose
+    // payload is restored in place on pop, and where to find the bytes.
+    std::shared_ptr<MediaSample> spilled_sample;
+    uint64_t spill_offset = 0;
+    size_t spill_size = 0;
+  };
+
+  // Writes the payload of |entry|'s media sample to the spill file and
+  // replaces the sample with a payload-less clone, releasing this queue's
+  // reference on the in-memory bytes.
+  Status SpillEntry(Entry* entry);
+
+  std::string temp_dir_;
+  uint64_t memory_limit_bytes_ = 0;
+  MemoryTracker* memory_tracker_ = nullptr;
+  // Payload bytes of unspilled media samples currently in |entries_|.
+  uint64_t in_memory_bytes_ = 0;
+
+  // Created lazily on the first spill, deleted in the destructor.
+  File* spill_file_ = nullptr;
+  std::string spill_file_path_;
+  uint64_t spill_file_size_ = 0;
+
+  std::list<Entry> entries_;
+};
+
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_MEDIA_BASE_SAMPLE_SPILL_QUEUE_H_
@@ -0,0 +1,142 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/base/sample_spill_queue.h>
+
+#include <gtest/gtest.h>
+
+#include <packager/media/base/media_sample.h>
+#include <packager/media/base/memory_tracker.h>
+#include <packager/status/status_test_util.h>
+
+namespace shaka {
+namespace media {
+namespace {
+
+const size_t kStreamIndex = 0;
+
+std::unique_ptr<StreamData> MakeSample(uint8_t fill, size_t size) {
+  std::vector<uint8_t> payload(size, fill);
+  std::shared_ptr<MediaSample> sample =
+      MediaSample::CopyFrom(payload.data(), payload.size(), true);
+  return StreamData::FromMediaSample(kStreamIndex, std::move(sample));
+}
+
+void ExpectPayload(const StreamData& data, uint8_t fill, size_t size) {
+  ASSERT_TRUE(data.media_sample);
+  ASSERT_EQ(size, data.media_sample->data_size());
+  for (size_t i = 0; i < size; i++)
+    EXPECT_EQ(fill, data.media_sample->data()[i]);
+}
+
+}  // namespace
+
+TEST(SampleSpillQueueTest, PreservesOrderAndPayloadsWithoutSpill) {
+  SampleSpillQueue queue;
+  ASSERT_OK(queue.PushBack(MakeSample(0x11, 100)));
+  ASSERT_OK(queue.PushBack(MakeSample(0x22, 100)));
+  ASSERT_EQ(2u, queue.size());
+
+  std::unique_ptr<StreamData> data;
+  ASSERT_OK(queue.PopFront(&data));
+  ExpectPayload(*data, 0x11, 100);
+  ASSERT_OK(queue.PopFront(&data));
+  ExpectPayload(*data, 0x22, 100);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(SampleSpillQueueTest, SpilledPayloadsAreRestoredInOrder) {
+  SampleSpillQueue queue;
+  // Budget fits a single 100 byte payload, so every push beyond the first
+  // spills the older queued payloads.
+  queue.EnableSpill("", 100);
+
+  ASSERT_OK(queue.PushBack(MakeSample(0x11, 100)));
+  ASSERT_OK(queue.PushBack(MakeSample(0x22, 100)));
+  ASSERT_OK(queue.PushBack(MakeSample(0x33, 100)));
+  ASSERT_EQ(3u, queue.size());
+  // Header peeks must work even for spilled entries.
+  EXPECT_EQ(StreamDataType::kMediaSample, queue.front().stream_data_type);
+
+  std::unique_ptr<StreamData> data;
+  ASSERT_OK(queue.PopFront(&data));
+  ExpectPayload(*data, 0x11, 100);
+  ASSERT_OK(queue.PopFront(&data));
+  ExpectPayload(*data, 0x22, 100);
+  ASSERT_OK(queue.PopFront(&data));
+  ExpectPayload(*data, 0x33, 100);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(SampleSpillQueueTest, NewestEntryIsNeverSpilled) {
+  SampleSpillQueue queue;
+  queue.EnableSpill("", 1);  // Everything but the newest entry spills.
+
+  std::shared_ptr<MediaSample> first;
+  {
+    std::vector<uint8_t> payload(100, 0x11);
+    first = MediaSample::CopyFrom(payload.data(), payload.size(), true);
+  }
+  ASSERT_OK(queue.PushBack(StreamData::FromMediaSample(kStreamIndex, first)));
+
+  // The pushing handler may keep adjusting the newest entry's header until
+  // the next push; the trick play handler extends durations this way.
+  first->set_duration(42);
+  ASSERT_OK(queue.PushBack(MakeSample(0x22, 100)));
+
+  std::unique_ptr<StreamData> data;
+  ASSERT_OK(queue.PopFront(&data));
+  ExpectPayload(*data, 0x11, 100);
+  EXPECT_EQ(42, data->media_sample->duration());
+}
+
+TEST(SampleSpillQueueTest, NonSampleEntriesPassThrough) {
+  SampleSpillQueue queue;
+  queue.EnableSpill("", 1);
+
+  std::shared_ptr<SegmentInfo> segment_info = std::make_shared<SegmentInfo>();
+  segment_info->duration = 9000;
+  ASSERT_OK(queue.PushBack(
+      StreamData::FromSegmentInfo(kStreamIndex, std::move(segment_info))));
+  ASSERT_OK(queue.PushBack(MakeSample(0x11, 100)));
+
+  EXPECT_EQ(StreamDataType::kSegmentInfo, queue.front().stream_data_type);
+  std::unique_ptr<StreamData> data;
+  ASSERT_OK(queue.PopFront(&data));
+  EXPECT_EQ(9000, data->segment_info->duration);
+}
+
+TEST(SampleSpillQueueTest, MemoryPressureForcesSpill) {
+  MemoryTracker tracker(1000);
+  SampleSpillQueue queue;
+  // No budget of its own: without pressure the queue keeps everything in
+  // memory.
+  queue.EnableSpill("", 0);
+  queue.set_memory_tracker(&tracker);
+
+  ASSERT_OK(queue.PushBack(MakeSample(0x11, 100)));
+  EXPECT_EQ(100u, tracker.current_bytes());
+  EXPECT_FALSE(tracker.UnderPressure());
+
+  // Another queue of the same job pushes the tracker over the watermark;
+  // the next push spills everything but the newest entry, releasing the
+  // spilled bytes from the job's accounting.
+  tracker.Add(700);
+  ASSERT_OK(queue.PushBack(MakeSample(0x22, 100)));
+  EXPECT_TRUE(tracker.UnderPressure());
+  EXPECT_EQ(800u, tracker.current_bytes());
+
+  std::unique_ptr<StreamData> data;
+  ASSERT_OK(queue.PopFront(&data));
+  ExpectPayload(*data, 0x11, 100);
+  ASSERT_OK(queue.PopFront(&data));
+  ExpectPayload(*data, 0x22, 100);
+  tracker.Remove(700);
+  EXPECT_EQ(0u, tracker.current_bytes());
+}
+
+}  // namespace media
+}  // namespace shaka
@@ -0,0 +1,50 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_MEDIA_BASE_SEGMENT_SIZE_PREDICTOR_H_
+#define PACKAGER_MEDIA_BASE_SEGMENT_SIZE_PREDICTOR_H_
+
+#include <cstddef>
+
+namespace shaka {
+namespace media {
+
+/// Predicts the size of the next segment or fragment from an exponentially
+/// weighted moving average of recently finalized sizes, so output buffers can
+/// be reserved up front instead of growing through repeated reallocations.
+/// On steady-state live content consecutive segments have similar sizes, so
+/// the prediction plus a small margin almost always fits.
+class SegmentSizePredictor {
+ public:
+  /// Records the size of a finalized segment.
+  void AddSample(size_t size) {
+    if (average_ == 0.0) {
+      average_ = static_cast<double>(size);
+    } else {
+      average_ += kAlpha * (static_cast<double>(size) - average_);
+    }
+  }
+
+  /// @return The predicted size of the next segment, including a safety
+  ///         margin, or 0 if no segment has been recorded yet.
+  size_t PredictedSize() const {
+    return static_cast<size_t>(average_ * kMargin);
+  }
+
+ private:
+  // Weight of the most recent sample in the moving average.
+  static constexpr double kAlpha = 0.25;
+  // Headroom over the average so slightly larger segments still fit without
+  // a reallocation.
+  static constexpr double kMargin = 1.25;
+
+  double average_ = 0.0;
+};
+
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_MEDIA_BASE_SEGMENT_SIZE_PREDICTOR_H_
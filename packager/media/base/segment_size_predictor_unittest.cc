@@ -0,0 +1,44 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/base/segment_size_predictor.h>
+
+#include <gtest/gtest.h>
+
+namespace shaka {
+namespace media {
+
+TEST(SegmentSizePredictorTest, NoPredictionWithoutSamples) {
+  SegmentSizePredictor predictor;
+  EXPECT_EQ(0u, predictor.PredictedSize());
+}
+
+TEST(SegmentSizePredictorTest, FirstSampleSetsAverage) {
+  SegmentSizePredictor predictor;
+  predictor.AddSample(1000);
+  // 1000 plus the safety margin.
+  EXPECT_EQ(1250u, predictor.PredictedSize());
+}
+
+TEST(SegmentSizePredictorTest, StableSizesPredictWithMargin) {
+  SegmentSizePredictor predictor;
+  for (int i = 0; i < 10; ++i)
+    predictor.AddSample(2000);
+  EXPECT_EQ(2500u, predictor.PredictedSize());
+}
+
+TEST(SegmentSizePredictorTest, TracksChangedSizes) {
+  SegmentSizePredictor predictor;
+  predictor.AddSample(1000);
+  for (int i = 0; i < 100; ++i)
+    predictor.AddSample(4000);
+  // The average converges towards the new steady-state size.
+  EXPECT_GT(predictor.PredictedSize(), 4000u);
+  EXPECT_LE(predictor.PredictedSize(), 5000u);
+}
+
+}  // namespace media
+}  // namespace shaka
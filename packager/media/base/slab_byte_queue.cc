@@ -0,0 +1,144 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/base/slab_byte_queue.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <absl/base/thread_annotations.h>
+#include <absl/log/check.h>
+#include <absl/synchronization/mutex.h>
+
+namespace shaka {
+namespace media {
+namespace {
+
+// Upper bound on idle slabs kept for reuse, per queue.
+const size_t kMaxFreeSlabs = 16;
+
+}  // namespace
+
+class SlabByteQueue::SlabPool {
+ public:
+  std::unique_ptr<uint8_t[]> Take() {
+    absl::MutexLock lock(&mutex_);
+    if (free_.empty())
+      return nullptr;
+    std::unique_ptr<uint8_t[]> slab = std::move(free_.back());
+    free_.pop_back();
+    return slab;
+  }
+
+  // Called from the slab deleter, possibly on a downstream thread that held
+  // the last view into the slab.
+  void Put(uint8_t* slab) {
+    absl::MutexLock lock(&mutex_);
+    if (free_.size() < kMaxFreeSlabs) {
+      free_.emplace_back(slab);
+      return;
+    }
+    delete[] slab;
+  }
+
+ private:
+  absl::Mutex mutex_;
+  std::vector<std::unique_ptr<uint8_t[]>> free_ ABSL_GUARDED_BY(mutex_);
+};
+
+SlabByteQueue::SlabByteQueue() : pool_(new SlabPool) {}
+
+SlabByteQueue::~SlabByteQueue() {}
+
+void SlabByteQueue::Reset() {
+  slabs_.clear();
+  slab_base_ = 0;
+  head_ = 0;
+  tail_ = 0;
+}
+
+std::shared_ptr<uint8_t> SlabByteQueue::NewSlab() {
+  std::unique_ptr<uint8_t[]> slab = pool_->Take();
+  if (!slab)
+    slab.reset(new uint8_t[kSlabSize]);
+  return std::shared_ptr<uint8_t>(
+      slab.release(), [pool = pool_](uint8_t* p) { pool->Put(p); });
+}
+
+void SlabByteQueue::Push(const uint8_t* buf, int size) {
+  DCHECK(buf);
+  while (size > 0) {
+    const size_t tail_used = static_cast<size_t>(tail_ - slab_base_) -
+                             (slabs_.empty() ? 0 : slabs_.size() - 1) *
+                                 kSlabSize;
+    if (slabs_.empty() || tail_used == kSlabSize) {
+      slabs_.push_back(NewSlab());
+      continue;
+    }
+    const size_t chunk =
+        std::min(static_cast<size_t>(size), kSlabSize - tail_used);
+    memcpy(slabs_.back().get() + tail_used, buf, chunk);
+    buf += chunk;
+    size -= static_cast<int>(chunk);
+    tail_ += chunk;
+  }
+}
+
+size_t SlabByteQueue::CopyAt(int64_t offset, size_t size, uint8_t* dest) const {
+  DCHECK_GE(offset, head_);
+  if (offset >= tail_)
+    return 0;
+  size = std::min(size, static_cast<size_t>(tail_ - offset));
+
+  size_t copied = 0;
+  while (copied < size) {
+    const int64_t pos = offset + copied - slab_base_;
+    const size_t index = static_cast<size_t>(pos / kSlabSize);
+    const size_t within = static_cast<size_t>(pos % kSlabSize);
+    const size_t chunk = std::min(size - copied, kSlabSize - within);
+    memcpy(dest + copied, slabs_[index].get() + within, chunk);
+    copied += chunk;
+  }
+  return copied;
+}
+
+std::shared_ptr<const uint8_t> SlabByteQueue::GetShared(int64_t offset,
+                                                        size_t size) {
+  DCHECK_GT(size, 0u);
+  if (offset < head_ || offset + static_cast<int64_t>(size) > tail_)
+    return nullptr;
+
+  const int64_t pos = offset - slab_base_;
+  const size_t index = static_cast<size_t>(pos / kSlabSize);
+  const size_t within = static_cast<size_t>(pos % kSlabSize);
+  if (within + size <= kSlabSize) {
+    // Alias into the slab; the aliasing constructor keeps the slab (and thus
+    // its pool entry) alive until the view drops.
+    return std::shared_ptr<const uint8_t>(slabs_[index],
+                                          slabs_[index].get() + within);
+  }
+
+  // The range straddles slabs; fall back to a one-off copy.
+  std::shared_ptr<uint8_t> copy(new uint8_t[size],
+                                std::default_delete<uint8_t[]>());
+  CHECK_EQ(size, CopyAt(offset, size, copy.get()));
+  return copy;
+}
+
+bool SlabByteQueue::Trim(int64_t max_offset) {
+  const bool success = max_offset <= tail_;
+  head_ = std::min(std::max(head_, max_offset), tail_);
+  while (!slabs_.empty() && slab_base_ + static_cast<int64_t>(kSlabSize) <=
+                                std::min(head_, tail_)) {
+    slabs_.pop_front();
+    slab_base_ += kSlabSize;
+  }
+  return success;
+}
+
+}  // namespace media
+}  // namespace shaka
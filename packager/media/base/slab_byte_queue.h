@@ -0,0 +1,100 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_MEDIA_BASE_SLAB_BYTE_QUEUE_H_
+#define PACKAGER_MEDIA_BASE_SLAB_BYTE_QUEUE_H_
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+
+#include <packager/macros/classes.h>
+
+namespace shaka {
+namespace media {
+
+/// A byte queue built from a chain of fixed-size refcounted slabs, addressed
+/// by monotonically-increasing absolute offsets like OffsetByteQueue. Push()
+/// appends into the tail slab and never moves bytes that are already
+/// buffered, so a demuxer that keeps a large window resident (e.g. a
+/// referenced 'mdat' while its runs are emitted) does not pay the repeated
+/// memmove that the contiguous ByteQueue performs on every wrap. Consumers
+/// take refcounted views with GetShared(): the view pins its slab, Trim() can
+/// run ahead and drop the slab from the chain, and the slab's memory is
+/// recycled through an internal pool when the last view drops.
+class SlabByteQueue {
+ public:
+  /// Slab size. Large enough that typical boxes and samples land in a single
+  /// slab, making GetShared() zero-copy for them.
+  static constexpr size_t kSlabSize = 512 * 1024;
+
+  SlabByteQueue();
+  ~SlabByteQueue();
+
+  /// Reset the queue to the empty state, with offsets restarting at 0.
+  void Reset();
+
+  /// Append new bytes to the end of the queue. Previously buffered bytes are
+  /// never copied or moved.
+  void Push(const uint8_t* buf, int size);
+
+  /// Copy up to @a size buffered bytes starting at absolute offset @a offset
+  /// into @a dest, crossing slab boundaries as needed.
+  /// @return the number of bytes copied, clamped at tail().
+  size_t CopyAt(int64_t offset, size_t size, uint8_t* dest) const;
+
+  /// Get a refcounted contiguous view of [@a offset, @a offset + @a size).
+  /// When the range lies within one slab the returned pointer aliases the
+  /// slab and keeps it alive, so the view stays valid after Trim() releases
+  /// the range and even after the queue itself is destroyed; when the range
+  /// straddles slabs the bytes are copied into a fresh buffer. Note that an
+  /// aliasing view pins the whole slab, so long-lived views hold up to
+  /// kSlabSize bytes each.
+  /// @return null if the range is not fully buffered.
+  std::shared_ptr<const uint8_t> GetShared(int64_t offset, size_t size);
+
+  /// Mark the bytes up to (but not including) @a max_offset as consumed.
+  /// Fully consumed slabs are dropped from the chain immediately; their
+  /// memory is recycled once the last GetShared() view into them drops.
+  ///
+  /// @return true if the full range of bytes were successfully trimmed,
+  ///         including the case where @a max_offset is less than the current
+  ///         head.
+  /// @return false if @a max_offset > tail() (although all bytes currently
+  ///         buffered are still cleared).
+  bool Trim(int64_t max_offset);
+
+  /// @return The head position, in terms of the stream's absolute offset.
+  int64_t head() const { return head_; }
+  /// @return The tail position (exclusive), in terms of the stream's absolute
+  ///         offset.
+  int64_t tail() const { return tail_; }
+
+ private:
+  // Recycles slab buffers between uses. Held by shared_ptr so slabs released
+  // from another thread after the queue is gone still have a pool to return
+  // to.
+  class SlabPool;
+
+  // Allocates (or reuses) a slab whose memory returns to |pool_| when the
+  // last reference drops.
+  std::shared_ptr<uint8_t> NewSlab();
+
+  std::shared_ptr<SlabPool> pool_;
+  std::deque<std::shared_ptr<uint8_t>> slabs_;
+  // Absolute offset of the first byte of slabs_.front(). head_ may be past it
+  // when the front slab is partially consumed.
+  int64_t slab_base_ = 0;
+  int64_t head_ = 0;
+  int64_t tail_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(SlabByteQueue);
+};
+
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_MEDIA_BASE_SLAB_BYTE_QUEUE_H_
@@ -0,0 +1,133 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/base/slab_byte_queue.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace shaka {
+namespace media {
+namespace {
+
+// Spans three slabs so slab boundaries are exercised.
+const size_t kTestDataSize = 2 * SlabByteQueue::kSlabSize + 1000;
+
+std::vector<uint8_t> MakeTestData() {
+  std::vector<uint8_t> data(kTestDataSize);
+  for (size_t i = 0; i < data.size(); i++)
+    data[i] = static_cast<uint8_t>(i * 7 + i / 256);
+  return data;
+}
+
+}  // namespace
+
+class SlabByteQueueTest : public testing::Test {
+ public:
+  void SetUp() override {
+    data_ = MakeTestData();
+    // Push in uneven chunks so slab fills do not line up with pushes.
+    size_t offset = 0;
+    while (offset < data_.size()) {
+      const size_t chunk = std::min<size_t>(100 * 1000 + 3, data_.size() - offset);
+      queue_.Push(&data_[offset], static_cast<int>(chunk));
+      offset += chunk;
+    }
+  }
+
+ protected:
+  std::vector<uint8_t> data_;
+  SlabByteQueue queue_;
+};
+
+TEST_F(SlabByteQueueTest, PushAndCopyAt) {
+  EXPECT_EQ(0, queue_.head());
+  EXPECT_EQ(static_cast<int64_t>(kTestDataSize), queue_.tail());
+
+  // A range crossing both slab boundaries.
+  const int64_t offset = SlabByteQueue::kSlabSize - 500;
+  std::vector<uint8_t> copy(SlabByteQueue::kSlabSize + 1000);
+  ASSERT_EQ(copy.size(), queue_.CopyAt(offset, copy.size(), copy.data()));
+  EXPECT_EQ(0, memcmp(copy.data(), &data_[offset], copy.size()));
+
+  // Reads are clamped at tail().
+  uint8_t tail_byte = 0;
+  EXPECT_EQ(1u, queue_.CopyAt(queue_.tail() - 1, 100, &tail_byte));
+  EXPECT_EQ(data_.back(), tail_byte);
+}
+
+TEST_F(SlabByteQueueTest, GetSharedWithinSlabIsZeroCopy) {
+  std::shared_ptr<const uint8_t> view = queue_.GetShared(1000, 500);
+  ASSERT_TRUE(view);
+  EXPECT_EQ(0, memcmp(view.get(), &data_[1000], 500));
+
+  // Within a slab the view aliases the slab, so a second view of the same
+  // range points at the same bytes.
+  std::shared_ptr<const uint8_t> view2 = queue_.GetShared(1000, 500);
+  EXPECT_EQ(view.get(), view2.get());
+}
+
+TEST_F(SlabByteQueueTest, GetSharedAcrossSlabsCopies) {
+  const int64_t offset = SlabByteQueue::kSlabSize - 100;
+  std::shared_ptr<const uint8_t> view = queue_.GetShared(offset, 300);
+  ASSERT_TRUE(view);
+  EXPECT_EQ(0, memcmp(view.get(), &data_[offset], 300));
+}
+
+TEST_F(SlabByteQueueTest, GetSharedNotBuffered) {
+  EXPECT_FALSE(queue_.GetShared(queue_.tail() - 10, 11));
+  queue_.Trim(100);
+  EXPECT_FALSE(queue_.GetShared(50, 100));
+}
+
+TEST_F(SlabByteQueueTest, ViewSurvivesTrim) {
+  std::shared_ptr<const uint8_t> view = queue_.GetShared(2000, 1000);
+  ASSERT_TRUE(view);
+
+  // Trim past the whole first slab; the view keeps its slab alive.
+  EXPECT_TRUE(queue_.Trim(SlabByteQueue::kSlabSize + 500));
+  EXPECT_EQ(static_cast<int64_t>(SlabByteQueue::kSlabSize) + 500,
+            queue_.head());
+  EXPECT_EQ(0, memcmp(view.get(), &data_[2000], 1000));
+}
+
+TEST_F(SlabByteQueueTest, TrimAndPushBeyondTail) {
+  EXPECT_TRUE(queue_.Trim(0));
+  EXPECT_TRUE(queue_.Trim(queue_.tail()));
+  EXPECT_EQ(queue_.head(), queue_.tail());
+  // Trimming to an earlier offset is a no-op.
+  EXPECT_TRUE(queue_.Trim(5));
+  EXPECT_EQ(static_cast<int64_t>(kTestDataSize), queue_.head());
+
+  // Trimming beyond tail clears the queue but reports failure.
+  queue_.Push(data_.data(), 100);
+  EXPECT_FALSE(queue_.Trim(queue_.tail() + 50));
+  EXPECT_EQ(queue_.head(), queue_.tail());
+
+  // Offsets keep increasing after the queue drains.
+  queue_.Push(data_.data(), 100);
+  std::shared_ptr<const uint8_t> view = queue_.GetShared(queue_.head(), 100);
+  ASSERT_TRUE(view);
+  EXPECT_EQ(0, memcmp(view.get(), data_.data(), 100));
+}
+
+TEST_F(SlabByteQueueTest, Reset) {
+  queue_.Reset();
+  EXPECT_EQ(0, queue_.head());
+  EXPECT_EQ(0, queue_.tail());
+
+  queue_.Push(data_.data(), 256);
+  EXPECT_EQ(256, queue_.tail());
+  std::shared_ptr<const uint8_t> view = queue_.GetShared(0, 256);
+  ASSERT_TRUE(view);
+  EXPECT_EQ(0, memcmp(view.get(), data_.data(), 256));
+}
+
+}  // namespace media
+}  // namespace shaka
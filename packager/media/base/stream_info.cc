@@ -7,9 +7,11 @@
 #include <packager/media/base/stream_info.h>
 
 #include <cinttypes>
+#include <map>
 
 #include <absl/log/log.h>
 #include <absl/strings/str_format.h>
+#include <absl/synchronization/mutex.h>
 
 #include <packager/macros/logging.h>
 #include <packager/media/base/timestamp.h>
@@ -49,16 +51,57 @@ StreamInfo::StreamInfo(StreamType stream_type,
       time_scale_(time_scale),
       duration_(duration),
       codec_(codec),
-      codec_string_(codec_string),
-      language_(language),
+      codec_string_(&InternString(codec_string)),
+      language_(&InternString(language)),
       is_encrypted_(is_encrypted) {
   if (codec_config_size > 0) {
-    codec_config_.assign(codec_config, codec_config + codec_config_size);
+    codec_config_ = InternCodecConfig(codec_config, codec_config_size);
   }
 }
 
 StreamInfo::~StreamInfo() {}
 
+void StreamInfo::set_codec_config(const std::vector<uint8_t>& data) {
+  codec_config_ =
+      data.empty() ? nullptr : InternCodecConfig(data.data(), data.size());
+}
+
+const std::vector<uint8_t>& StreamInfo::EmptyCodecConfig() {
+  static const std::vector<uint8_t>& empty = *new std::vector<uint8_t>;
+  return empty;
+}
+
+std::shared_ptr<const std::vector<uint8_t>> StreamInfo::InternCodecConfig(
+    const uint8_t* data,
+    size_t size) {
+  // A process packages a handful of distinct codec configurations but copies
+  // them into many stream infos (one per track and trick play factor, plus
+  // mid-stream updates), so identical blobs are shared through this table.
+  // Entries do not keep blobs alive; expired ones are pruned on insert.
+  static absl::Mutex& mutex = *new absl::Mutex;
+  static auto& interned_configs =
+      *new std::map<std::string, std::weak_ptr<const std::vector<uint8_t>>>;
+
+  const std::string key(reinterpret_cast<const char*>(data), size);
+  absl::MutexLock lock(&mutex);
+  auto it = interned_configs.find(key);
+  if (it != interned_configs.end()) {
+    if (auto config = it->second.lock())
+      return config;
+  }
+  for (auto prune_it = interned_configs.begin();
+       prune_it != interned_configs.end();) {
+    if (prune_it->second.expired())
+      prune_it = interned_configs.erase(prune_it);
+    else
+      ++prune_it;
+  }
+  auto config =
+      std::make_shared<const std::vector<uint8_t>>(data, data + size);
+  interned_configs[key] = config;
+  return config;
+}
+
 std::string StreamInfo::ToString() const {
   std::string duration;
   if (duration_ == kInfiniteDuration) {
@@ -71,7 +114,7 @@ std::string StreamInfo::ToString() const {
   return absl::StrFormat(
       "type: %s\n codec_string: %s\n time_scale: %d\n duration: "
       "%s\n is_encrypted: %s\n",
-      StreamTypeToString(stream_type_).c_str(), codec_string_.c_str(),
+      StreamTypeToString(stream_type_).c_str(), codec_string_->c_str(),
       time_scale_, duration.c_str(), is_encrypted_ ? "true" : "false");
 }
 
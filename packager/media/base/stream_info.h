@@ -12,6 +12,7 @@
 #include <vector>
 
 #include <packager/media/base/encryption_config.h>
+#include <packager/utils/string_interner.h>
 
 namespace shaka {
 namespace media {
@@ -100,9 +101,11 @@ class StreamInfo {
   int32_t time_scale() const { return time_scale_; }
   int64_t duration() const { return duration_; }
   Codec codec() const { return codec_; }
-  const std::string& codec_string() const { return codec_string_; }
-  const std::vector<uint8_t>& codec_config() const { return codec_config_; }
-  const std::string& language() const { return language_; }
+  const std::string& codec_string() const { return *codec_string_; }
+  const std::vector<uint8_t>& codec_config() const {
+    return codec_config_ ? *codec_config_ : EmptyCodecConfig();
+  }
+  const std::string& language() const { return *language_; }
   bool is_encrypted() const { return is_encrypted_; }
   bool has_clear_lead() const { return has_clear_lead_; }
   const EncryptionConfig& encryption_config() const {
@@ -111,13 +114,13 @@ class StreamInfo {
 
   void set_duration(int64_t duration) { duration_ = duration; }
   void set_codec(Codec codec) { codec_ = codec; }
-  void set_codec_config(const std::vector<uint8_t>& data) {
-    codec_config_ = data;
-  }
+  void set_codec_config(const std::vector<uint8_t>& data);
   void set_codec_string(const std::string& codec_string) {
-    codec_string_ = codec_string;
+    codec_string_ = &InternString(codec_string);
+  }
+  void set_language(const std::string& language) {
+    language_ = &InternString(language);
   }
-  void set_language(const std::string& language) { language_ = language; }
   void set_is_encrypted(bool is_encrypted) { is_encrypted_ = is_encrypted; }
   void set_has_clear_lead(bool has_clear_lead) {
     has_clear_lead_ = has_clear_lead;
@@ -127,6 +130,13 @@ class StreamInfo {
   }
 
  private:
+  static const std::vector<uint8_t>& EmptyCodecConfig();
+  // Returns a shared immutable copy of the blob, reusing an existing one
+  // with identical bytes if any stream info in the process still holds it.
+  static std::shared_ptr<const std::vector<uint8_t>> InternCodecConfig(
+      const uint8_t* data,
+      size_t size);
+
   // Whether the stream is Audio or Video.
   StreamType stream_type_;
   uint32_t track_id_;
@@ -135,8 +145,10 @@ class StreamInfo {
   // Duration base on time_scale.
   int64_t duration_;
   Codec codec_;
-  std::string codec_string_;
-  std::string language_;
+  // Interned (see InternString()): many streams share one canonical copy of
+  // each codec string and language instead of carrying their own.
+  const std::string* codec_string_ = &InternString("");
+  const std::string* language_ = &InternString("");
   // Whether the stream is potentially encrypted.
   // Note that in a potentially encrypted stream, individual buffers
   // can be encrypted or not encrypted.
@@ -145,8 +157,11 @@ class StreamInfo {
   bool has_clear_lead_ = false;
   EncryptionConfig encryption_config_;
   // Optional byte data required for some audio/video decoders such as Vorbis
-  // codebooks.
-  std::vector<uint8_t> codec_config_;
+  // codebooks. Shared and immutable, so the copies made on every handler hop
+  // during stream info propagation (Clone() in the handler graph) reference
+  // one blob instead of deep-copying it; identical blobs are interned across
+  // streams. Null when there is no codec config.
+  std::shared_ptr<const std::vector<uint8_t>> codec_config_;
 
   // Not using DISALLOW_COPY_AND_ASSIGN here intentionally to allow the compiler
   // generated copy constructor and assignment operator. Since the extra data is
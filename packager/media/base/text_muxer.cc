@@ -88,7 +88,7 @@ Status TextMuxer::FinalizeSegment(size_t stream_id,
   const uint32_t bandwidth = options().bandwidth;
 
   const std::string filename =
-      GetSegmentName(segment_template, start, index, bandwidth);
+      segment_name_template().Apply(start, index, bandwidth);
   uint64_t size;
   RETURN_IF_ERROR(WriteToFile(filename, &size));
 
@@ -93,6 +93,8 @@ struct TextFragment {
       : style(style), body(body) {}
   TextFragment(const TextFragmentStyle& style, const std::string& body)
       : style(style), body(body) {}
+  TextFragment(const TextFragmentStyle& style, std::string&& body)
+      : style(style), body(std::move(body)) {}
   TextFragment(const TextFragmentStyle& style,
                const std::vector<uint8_t>& image)
       : style(style), image(image) {}
@@ -259,14 +259,33 @@ Status WidevineKeySource::GetKeyInternal(uint32_t crypto_period_index,
   DCHECK(key);
 
   std::shared_ptr<EncryptionKeyMap> encryption_key_map;
-  Status status = key_pool_->Peek(crypto_period_index, &encryption_key_map,
-                                  kGetKeyTimeoutInSeconds * 1000);
-  if (!status.ok()) {
-    if (status.error_code() == error::STOPPED) {
-      CHECK(!common_encryption_request_status_.ok());
-      return common_encryption_request_status_;
+  {
+    absl::MutexLock scoped_lock(&key_cache_mutex_);
+    auto cached = key_cache_.find(crypto_period_index);
+    if (cached != key_cache_.end())
+      encryption_key_map = cached->second;
+  }
+
+  if (!encryption_key_map) {
+    Status status = key_pool_->Peek(crypto_period_index, &encryption_key_map,
+                                    kGetKeyTimeoutInSeconds * 1000);
+    if (!status.ok()) {
+      if (status.error_code() == error::STOPPED) {
+        CHECK(!common_encryption_request_status_.ok());
+        return common_encryption_request_status_;
+      }
+      return status;
+    }
+
+    absl::MutexLock scoped_lock(&key_cache_mutex_);
+    key_cache_[crypto_period_index] = encryption_key_map;
+    // Drop periods that have fallen behind the retention window; tracks may
+    // lag each other by a period or two, but never by a whole fetch batch.
+    if (crypto_period_index > static_cast<uint32_t>(crypto_period_count_)) {
+      key_cache_.erase(key_cache_.begin(),
+                       key_cache_.lower_bound(crypto_period_index -
+                                              crypto_period_count_));
     }
-    return status;
   }
 
   if (encryption_key_map->find(stream_label) == encryption_key_map->end()) {
@@ -11,6 +11,7 @@
 #include <memory>
 #include <thread>
 
+#include <absl/base/thread_annotations.h>
 #include <absl/synchronization/mutex.h>
 #include <absl/synchronization/notification.h>
 
@@ -145,6 +146,15 @@ class WidevineKeySource : public KeySource {
   EncryptionKeyMap encryption_key_map_;  // For non key rotation request.
   Status common_encryption_request_status_;
 
+  // Warmed cache of recently served crypto period key maps. The background
+  // production thread keeps |key_pool_| filled ahead of playback, but every
+  // track of a pipeline asks for the same crypto period at a rotation
+  // boundary; serving repeats from here keeps those lookups off the shared
+  // pool.
+  absl::Mutex key_cache_mutex_;
+  std::map<uint32_t, std::shared_ptr<EncryptionKeyMap>> key_cache_
+      ABSL_GUARDED_BY(key_cache_mutex_);
+
   std::thread key_production_thread_;
 
   DISALLOW_COPY_AND_ASSIGN(WidevineKeySource);
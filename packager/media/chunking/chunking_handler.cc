@@ -54,7 +54,8 @@ Status ChunkingHandler::Process(std::unique_ptr<StreamData> stream_data) {
       VLOG(3) << "Droppping existing segment info.";
       return Status::OK;
     case StreamDataType::kMediaSample:
-      return OnMediaSample(std::move(stream_data->media_sample));
+      return OnMediaSample(std::move(stream_data->media_sample),
+                           /*batched_output=*/nullptr);
     default:
       VLOG(3) << "Stream data type "
               << static_cast<int>(stream_data->stream_data_type) << " ignored.";
@@ -62,8 +63,34 @@ Status ChunkingHandler::Process(std::unique_ptr<StreamData> stream_data) {
   }
 }
 
+Status ChunkingHandler::ProcessBatch(
+    std::vector<std::unique_ptr<StreamData>> stream_data_list) {
+  // Media samples dominate batches from upstream (high-cadence audio in
+  // particular). Collect the samples and the segment boundaries they produce
+  // and forward them downstream in a single DispatchBatch() call instead of
+  // one Dispatch() per entry. Non-sample entries are rare; flush what has
+  // been collected to preserve ordering, then take the per-entry path.
+  std::vector<std::unique_ptr<StreamData>> batched_output;
+  batched_output.reserve(stream_data_list.size());
+  for (auto& stream_data : stream_data_list) {
+    if (stream_data->stream_data_type == StreamDataType::kMediaSample) {
+      RETURN_IF_ERROR(
+          OnMediaSample(std::move(stream_data->media_sample), &batched_output));
+      continue;
+    }
+    if (!batched_output.empty()) {
+      RETURN_IF_ERROR(DispatchBatch(std::move(batched_output)));
+      batched_output.clear();
+    }
+    RETURN_IF_ERROR(Process(std::move(stream_data)));
+  }
+  if (!batched_output.empty())
+    RETURN_IF_ERROR(DispatchBatch(std::move(batched_output)));
+  return Status::OK;
+}
+
 Status ChunkingHandler::OnFlushRequest(size_t /*input_stream_index*/) {
-  RETURN_IF_ERROR(EndSegmentIfStarted());
+  RETURN_IF_ERROR(EndSegmentIfStarted(/*batched_output=*/nullptr));
   return FlushDownstream(kStreamIndex);
 }
 
@@ -77,7 +104,7 @@ Status ChunkingHandler::OnStreamInfo(std::shared_ptr<const StreamInfo> info) {
 }
 
 Status ChunkingHandler::OnCueEvent(std::shared_ptr<const CueEvent> event) {
-  RETURN_IF_ERROR(EndSegmentIfStarted());
+  RETURN_IF_ERROR(EndSegmentIfStarted(/*batched_output=*/nullptr));
   const double event_time_in_seconds = event->time_in_seconds;
   RETURN_IF_ERROR(DispatchCueEvent(kStreamIndex, std::move(event)));
 
@@ -90,7 +117,8 @@ Status ChunkingHandler::OnCueEvent(std::shared_ptr<const CueEvent> event) {
 }
 
 Status ChunkingHandler::OnMediaSample(
-    std::shared_ptr<const MediaSample> sample) {
+    std::shared_ptr<const MediaSample> sample,
+    std::vector<std::unique_ptr<StreamData>>* batched_output) {
   DCHECK_GT(time_scale_, 0) << "kStreamInfo should arrive before kMediaSample";
 
   const int64_t timestamp = sample->pts();
@@ -108,7 +136,7 @@ Status ChunkingHandler::OnMediaSample(
       // Reset subsegment index.
       current_subsegment_index_ = 0;
 
-      RETURN_IF_ERROR(EndSegmentIfStarted());
+      RETURN_IF_ERROR(EndSegmentIfStarted(batched_output));
       segment_start_time_ = timestamp;
       subsegment_start_time_ = timestamp;
       max_segment_time_ = timestamp + sample->duration();
@@ -123,7 +151,7 @@ Status ChunkingHandler::OnMediaSample(
   if (!started_new_segment && chunking_params_.low_latency_dash_mode) {
     current_subsegment_index_++;
 
-    RETURN_IF_ERROR(EndSubsegmentIfStarted());
+    RETURN_IF_ERROR(EndSubsegmentIfStarted(batched_output));
     subsegment_start_time_ = timestamp;
   }
 
@@ -140,7 +168,7 @@ Status ChunkingHandler::OnMediaSample(
       if (IsNewSegmentIndex(subsegment_index, current_subsegment_index_)) {
         current_subsegment_index_ = subsegment_index;
 
-        RETURN_IF_ERROR(EndSubsegmentIfStarted());
+        RETURN_IF_ERROR(EndSubsegmentIfStarted(batched_output));
         subsegment_start_time_ = timestamp;
       }
     }
@@ -160,10 +188,16 @@ Status ChunkingHandler::OnMediaSample(
   subsegment_start_time_ = std::min(subsegment_start_time_.value(), timestamp);
   max_segment_time_ =
       std::max(max_segment_time_, timestamp + sample->duration());
+  if (batched_output) {
+    batched_output->push_back(
+        StreamData::FromMediaSample(kStreamIndex, std::move(sample)));
+    return Status::OK;
+  }
   return DispatchMediaSample(kStreamIndex, std::move(sample));
 }
 
-Status ChunkingHandler::EndSegmentIfStarted() const {
+Status ChunkingHandler::EndSegmentIfStarted(
+    std::vector<std::unique_ptr<StreamData>>* batched_output) const {
   if (!segment_start_time_)
     return Status::OK;
 
@@ -174,10 +208,16 @@ Status ChunkingHandler::EndSegmentIfStarted() const {
     segment_info->is_chunk = true;
     segment_info->is_final_chunk_in_seg = true;
   }
+  if (batched_output) {
+    batched_output->push_back(
+        StreamData::FromSegmentInfo(kStreamIndex, std::move(segment_info)));
+    return Status::OK;
+  }
   return DispatchSegmentInfo(kStreamIndex, std::move(segment_info));
 }
 
-Status ChunkingHandler::EndSubsegmentIfStarted() const {
+Status ChunkingHandler::EndSubsegmentIfStarted(
+    std::vector<std::unique_ptr<StreamData>>* batched_output) const {
   if (!subsegment_start_time_)
     return Status::OK;
 
@@ -188,6 +228,11 @@ Status ChunkingHandler::EndSubsegmentIfStarted() const {
   subsegment_info->is_subsegment = true;
   if (chunking_params_.low_latency_dash_mode)
     subsegment_info->is_chunk = true;
+  if (batched_output) {
+    batched_output->push_back(
+        StreamData::FromSegmentInfo(kStreamIndex, std::move(subsegment_info)));
+    return Status::OK;
+  }
   return DispatchSegmentInfo(kStreamIndex, std::move(subsegment_info));
 }
 
@@ -8,8 +8,10 @@
 #define PACKAGER_MEDIA_CHUNKING_CHUNKING_HANDLER_
 
 #include <atomic>
+#include <memory>
 #include <optional>
 #include <queue>
+#include <vector>
 
 #include <absl/log/log.h>
 
@@ -47,6 +49,8 @@ class ChunkingHandler : public MediaHandler {
   /// @{
   Status InitializeInternal() override;
   Status Process(std::unique_ptr<StreamData> stream_data) override;
+  Status ProcessBatch(
+      std::vector<std::unique_ptr<StreamData>> stream_data_list) override;
   Status OnFlushRequest(size_t input_stream_index) override;
   /// @}
 
@@ -58,10 +62,17 @@ class ChunkingHandler : public MediaHandler {
 
   Status OnStreamInfo(std::shared_ptr<const StreamInfo> info);
   Status OnCueEvent(std::shared_ptr<const CueEvent> event);
-  Status OnMediaSample(std::shared_ptr<const MediaSample> sample);
-
-  Status EndSegmentIfStarted() const;
-  Status EndSubsegmentIfStarted() const;
+  // If |batched_output| is not null, the sample and any segment info it
+  // produces are appended there instead of being dispatched; ProcessBatch()
+  // then forwards the collected entries in one DispatchBatch() call.
+  Status OnMediaSample(
+      std::shared_ptr<const MediaSample> sample,
+      std::vector<std::unique_ptr<StreamData>>* batched_output);
+
+  Status EndSegmentIfStarted(
+      std::vector<std::unique_ptr<StreamData>>* batched_output) const;
+  Status EndSubsegmentIfStarted(
+      std::vector<std::unique_ptr<StreamData>>* batched_output) const;
 
   bool IsSubsegmentEnabled() {
     return subsegment_duration_ > 0 &&
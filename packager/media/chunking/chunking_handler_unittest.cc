@@ -42,6 +42,11 @@ class ChunkingHandlerTest : public MediaHandlerGraphTestBase {
     return chunking_handler_->Process(std::move(stream_data));
   }
 
+  Status ProcessBatch(
+      std::vector<std::unique_ptr<StreamData>> stream_data_list) {
+    return chunking_handler_->ProcessBatch(std::move(stream_data_list));
+  }
+
   Status OnFlushRequest(int stream_index) {
     return chunking_handler_->OnFlushRequest(stream_index);
   }
@@ -87,6 +92,79 @@ TEST_F(ChunkingHandlerTest, AudioNoSubsegmentsThenFlush) {
                                 !kIsSubsegment, !kEncrypted)));
 }
 
+TEST_F(ChunkingHandlerTest, AudioProcessBatchMatchesPerSampleOutput) {
+  ChunkingParams chunking_params;
+  chunking_params.segment_duration_in_seconds = 1;
+  SetUpChunkingHandler(1, chunking_params);
+
+  ASSERT_OK(Process(StreamData::FromStreamInfo(
+      kStreamIndex, GetAudioStreamInfo(kTimeScale0))));
+  ClearOutputStreamDataVector();
+
+  // The same five samples as AudioNoSubsegmentsThenFlush, delivered as one
+  // batch: the segment boundary must appear in the same place as on the
+  // per-sample path, before the sample that starts the new segment.
+  std::vector<std::unique_ptr<StreamData>> batch;
+  for (int i = 0; i < 5; ++i) {
+    batch.push_back(StreamData::FromMediaSample(
+        kStreamIndex, GetMediaSample(i * kDuration, kDuration, kKeyFrame)));
+  }
+  ASSERT_OK(ProcessBatch(std::move(batch)));
+  EXPECT_THAT(
+      GetOutputStreamDataVector(),
+      ElementsAre(
+          IsMediaSample(kStreamIndex, 0, kDuration, !kEncrypted, _),
+          IsMediaSample(kStreamIndex, kDuration, kDuration, !kEncrypted, _),
+          IsMediaSample(kStreamIndex, 2 * kDuration, kDuration, !kEncrypted, _),
+          IsSegmentInfo(kStreamIndex, 0, kDuration * 3, !kIsSubsegment,
+                        !kEncrypted),
+          IsMediaSample(kStreamIndex, 3 * kDuration, kDuration, !kEncrypted, _),
+          IsMediaSample(kStreamIndex, 4 * kDuration, kDuration, !kEncrypted,
+                        _)));
+}
+
+TEST_F(ChunkingHandlerTest, ProcessBatchWithCueEvent) {
+  ChunkingParams chunking_params;
+  chunking_params.segment_duration_in_seconds = 1;
+  SetUpChunkingHandler(1, chunking_params);
+
+  ASSERT_OK(Process(StreamData::FromStreamInfo(
+      kStreamIndex, GetVideoStreamInfo(kTimeScale1))));
+  ClearOutputStreamDataVector();
+
+  const int64_t kVideoStartTimestamp = 12345;
+  const double kCueTimeInSeconds =
+      static_cast<double>(kVideoStartTimestamp + kDuration) / kTimeScale1;
+  auto cue_event = std::make_shared<CueEvent>();
+  cue_event->time_in_seconds = kCueTimeInSeconds;
+
+  // A non-sample entry in the middle of a batch must not reorder the outputs:
+  // collected samples are flushed before it takes the per-entry path.
+  std::vector<std::unique_ptr<StreamData>> batch;
+  batch.push_back(StreamData::FromMediaSample(
+      kStreamIndex, GetMediaSample(kVideoStartTimestamp, kDuration,
+                                   kKeyFrame)));
+  batch.push_back(StreamData::FromCueEvent(kStreamIndex, cue_event));
+  for (int i = 1; i < 3; ++i) {
+    batch.push_back(StreamData::FromMediaSample(
+        kStreamIndex, GetMediaSample(kVideoStartTimestamp + i * kDuration,
+                                     kDuration, kKeyFrame)));
+  }
+  ASSERT_OK(ProcessBatch(std::move(batch)));
+  EXPECT_THAT(
+      GetOutputStreamDataVector(),
+      ElementsAre(
+          IsMediaSample(kStreamIndex, kVideoStartTimestamp, kDuration,
+                        !kEncrypted, _),
+          IsSegmentInfo(kStreamIndex, kVideoStartTimestamp, kDuration,
+                        !kIsSubsegment, !kEncrypted),
+          IsCueEvent(kStreamIndex, kCueTimeInSeconds),
+          IsMediaSample(kStreamIndex, kVideoStartTimestamp + kDuration,
+                        kDuration, !kEncrypted, _),
+          IsMediaSample(kStreamIndex, kVideoStartTimestamp + kDuration * 2,
+                        kDuration, !kEncrypted, _)));
+}
+
 TEST_F(ChunkingHandlerTest, AudioWithSubsegments) {
   ChunkingParams chunking_params;
   chunking_params.segment_duration_in_seconds = 1;
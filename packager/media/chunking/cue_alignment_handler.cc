@@ -7,6 +7,7 @@
 #include <packager/media/chunking/cue_alignment_handler.h>
 
 #include <algorithm>
+#include <limits>
 
 #include <absl/log/check.h>
 
@@ -80,13 +81,39 @@ Status GetNextCue(double hint,
 CueAlignmentHandler::CueAlignmentHandler(SyncPointQueue* sync_points)
     : sync_points_(sync_points) {}
 
+CueAlignmentHandler::CueAlignmentHandler(SyncPointQueue* sync_points,
+                                         const std::string& spill_temp_dir,
+                                         uint64_t spill_memory_bytes)
+    : sync_points_(sync_points),
+      spill_temp_dir_(spill_temp_dir),
+      spill_memory_bytes_(spill_memory_bytes) {}
+
+CueAlignmentHandler::CueAlignmentHandler(
+    SyncPointQueue* sync_points,
+    const std::string& spill_temp_dir,
+    uint64_t spill_memory_bytes,
+    std::shared_ptr<MemoryTracker> memory_tracker)
+    : sync_points_(sync_points),
+      spill_temp_dir_(spill_temp_dir),
+      spill_memory_bytes_(spill_memory_bytes),
+      memory_tracker_(std::move(memory_tracker)) {}
+
 Status CueAlignmentHandler::InitializeInternal() {
   sync_points_->AddThread();
   stream_states_.resize(num_input_streams());
+  // A job-level tracker alone enables spilling too, so pressure can push
+  // payloads out even when no per-stream budget was configured.
+  if (spill_memory_bytes_ > 0 || memory_tracker_) {
+    for (StreamState& stream_state : stream_states_) {
+      stream_state.samples.EnableSpill(spill_temp_dir_, spill_memory_bytes_);
+      stream_state.samples.set_memory_tracker(memory_tracker_.get());
+    }
+  }
 
   // Get the first hint for the stream. Use a negative hint so that if there is
   // suppose to be a sync point at zero, we will still respect it.
   hint_ = sync_points_->GetHint(-1);
+  runtime_cues_enabled_ = sync_points_->runtime_cues_enabled();
 
   return Status::OK;
 }
@@ -133,7 +160,10 @@ Status CueAlignmentHandler::OnFlushRequest(size_t stream_index) {
   }
 
   // It is possible that we did not get all the cues. |hint_| will get updated
-  // when we call |UseNextSyncPoint|.
+  // when we call |UseNextSyncPoint|. Note that the hint is deliberately not
+  // refreshed here: a runtime cue injected this late may not be seen by the
+  // handlers that already finished flushing, and blocking on it here would
+  // wait for threads that will never arrive. Such a cue is simply dropped.
   while (sync_points_->HasMore(hint_)) {
     std::shared_ptr<const CueEvent> next_cue;
     RETURN_IF_ERROR(GetNextCue(hint_, sync_points_, &next_cue));
@@ -222,7 +252,13 @@ Status CueAlignmentHandler::OnNonVideoSample(
   // point determined. It also means that there are no video streams and we need
   // to wait for all streams to converge on a hint so that we can get the next
   // sync point.
-  if (EveryoneWaitingAtHint()) {
+  //
+  // The buffered samples may span several upcoming cues (e.g. frequent ad
+  // cues), so keep promoting until some stream drains below the hint. This
+  // releases the buffers in one sweep instead of advancing one cue per
+  // arriving sample, which keeps the resident queues bounded by the cue
+  // spacing rather than by the number of pending cues.
+  while (EveryoneWaitingAtHint()) {
     std::shared_ptr<const CueEvent> next_sync;
     RETURN_IF_ERROR(GetNextCue(hint_, sync_points_, &next_sync));
     RETURN_IF_ERROR(UseNewSyncPoint(next_sync));
@@ -244,6 +280,8 @@ Status CueAlignmentHandler::OnSample(std::unique_ptr<StreamData> sample) {
 
   const size_t stream_index = sample->stream_index;
 
+  RefreshHint();
+
   if (sample->text_sample) {
     StreamState& stream = stream_states_[stream_index];
     stream.max_text_sample_end_time_seconds =
@@ -261,6 +299,7 @@ Status CueAlignmentHandler::OnSample(std::unique_ptr<StreamData> sample) {
 
 Status CueAlignmentHandler::UseNewSyncPoint(
     std::shared_ptr<const CueEvent> new_sync) {
+  last_cue_time_ = new_sync->time_in_seconds;
   hint_ = sync_points_->GetHint(new_sync->time_in_seconds);
   DCHECK_GT(hint_, new_sync->time_in_seconds);
 
@@ -275,6 +314,14 @@ Status CueAlignmentHandler::UseNewSyncPoint(
   return Status::OK;
 }
 
+void CueAlignmentHandler::RefreshHint() {
+  // Asking only when the hint says "no cue ahead" keeps the extra queue lock
+  // off the sample path while cues are pending; promoted cues at or before
+  // |last_cue_time_| were already used and are skipped by GetHint().
+  if (runtime_cues_enabled_ && hint_ == std::numeric_limits<double>::max())
+    hint_ = sync_points_->GetHint(last_cue_time_);
+}
+
 bool CueAlignmentHandler::EveryoneWaitingAtHint() const {
   for (const StreamState& stream_state : stream_states_) {
     if (stream_state.samples.empty()) {
@@ -294,7 +341,7 @@ Status CueAlignmentHandler::AcceptSample(std::unique_ptr<StreamData> sample,
   // the sample to the queue.
   const size_t stream_index = sample->stream_index;
 
-  stream->samples.push_back(std::move(sample));
+  RETURN_IF_ERROR(stream->samples.PushBack(std::move(sample)));
 
   if (stream->samples.size() > kMaxBufferSize) {
     LOG(ERROR) << "Stream " << stream_index << " has buffered "
@@ -313,11 +360,12 @@ Status CueAlignmentHandler::RunThroughSamples(StreamState* stream) {
   while (stream->cues.size() && stream->samples.size()) {
     const double cue_time = stream->cues.front()->cue_event->time_in_seconds;
     const double sample_time =
-        TimeInSeconds(*stream->info, *stream->samples.front());
+        TimeInSeconds(*stream->info, stream->samples.front());
 
     if (sample_time < cue_time) {
-      RETURN_IF_ERROR(Dispatch(std::move(stream->samples.front())));
-      stream->samples.pop_front();
+      std::unique_ptr<StreamData> sample;
+      RETURN_IF_ERROR(stream->samples.PopFront(&sample));
+      RETURN_IF_ERROR(Dispatch(std::move(sample)));
     } else {
       RETURN_IF_ERROR(Dispatch(std::move(stream->cues.front())));
       stream->cues.pop_front();
@@ -328,9 +376,10 @@ Status CueAlignmentHandler::RunThroughSamples(StreamState* stream) {
   // now work up to the hint. So now send all samples that come before the hint
   // downstream.
   while (stream->samples.size() &&
-         TimeInSeconds(*stream->info, *stream->samples.front()) < hint_) {
-    RETURN_IF_ERROR(Dispatch(std::move(stream->samples.front())));
-    stream->samples.pop_front();
+         TimeInSeconds(*stream->info, stream->samples.front()) < hint_) {
+    std::unique_ptr<StreamData> sample;
+    RETURN_IF_ERROR(stream->samples.PopFront(&sample));
+    RETURN_IF_ERROR(Dispatch(std::move(sample)));
   }
 
   return Status::OK;
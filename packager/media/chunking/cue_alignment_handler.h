@@ -9,8 +9,12 @@
 
 #include <deque>
 #include <list>
+#include <memory>
+#include <string>
 
 #include <packager/media/base/media_handler.h>
+#include <packager/media/base/memory_tracker.h>
+#include <packager/media/base/sample_spill_queue.h>
 #include <packager/media/chunking/sync_point_queue.h>
 
 namespace shaka {
@@ -26,6 +30,20 @@ namespace media {
 class CueAlignmentHandler : public MediaHandler {
  public:
   explicit CueAlignmentHandler(SyncPointQueue* sync_points);
+  /// As above, but with the buffered sample payloads capped: each stream's
+  /// queue spills payloads beyond @a spill_memory_bytes to a temporary file
+  /// in @a spill_temp_dir and reads them back on dispatch.
+  CueAlignmentHandler(SyncPointQueue* sync_points,
+                      const std::string& spill_temp_dir,
+                      uint64_t spill_memory_bytes);
+  /// As above, but additionally registers the buffered payload bytes with
+  /// @a memory_tracker (the owning job's accounting, may be null); under
+  /// job-level memory pressure the queues spill regardless of
+  /// @a spill_memory_bytes.
+  CueAlignmentHandler(SyncPointQueue* sync_points,
+                      const std::string& spill_temp_dir,
+                      uint64_t spill_memory_bytes,
+                      std::shared_ptr<MemoryTracker> memory_tracker);
   ~CueAlignmentHandler() = default;
 
  private:
@@ -36,8 +54,9 @@ class CueAlignmentHandler : public MediaHandler {
     // Information for the stream.
     std::shared_ptr<const StreamInfo> info;
     // Cached samples that cannot be dispatched. All the samples should be at or
-    // after |hint|.
-    std::list<std::unique_ptr<StreamData>> samples;
+    // after |hint|. Payloads beyond the configured spill budget live in a
+    // temporary file instead of memory.
+    SampleSpillQueue samples;
     // If set, the stream is pending to be flushed.
     bool to_be_flushed = false;
     // Only set for text stream.
@@ -63,6 +82,12 @@ class CueAlignmentHandler : public MediaHandler {
   // Update stream states with new sync point.
   Status UseNewSyncPoint(std::shared_ptr<const CueEvent> new_sync);
 
+  // Re-check |sync_points_| for cues added at runtime. With a fixed cue list
+  // the hint only moves when a cue is used, but runtime cues appear behind
+  // our back, so when no cue is ahead ask the queue again. Only does work
+  // when the queue accepts runtime cues.
+  void RefreshHint();
+
   // Check if everyone is waiting for new hint points.
   bool EveryoneWaitingAtHint() const;
 
@@ -76,6 +101,14 @@ class CueAlignmentHandler : public MediaHandler {
   SyncPointQueue* const sync_points_ = nullptr;
   std::deque<StreamState> stream_states_;
 
+  // Spill configuration applied to every stream's sample queue; a zero byte
+  // budget keeps all payloads in memory.
+  std::string spill_temp_dir_;
+  uint64_t spill_memory_bytes_ = 0;
+  // Job-level memory accounting shared with every stream's sample queue;
+  // may be null.
+  std::shared_ptr<MemoryTracker> memory_tracker_;
+
   // A common hint used by all streams. When a new cue is given to all streams,
   // the hint will be updated. The hint will always be larger than any cue. The
   // hint represents the min time in seconds for the next cue appear. The hints
@@ -85,6 +118,11 @@ class CueAlignmentHandler : public MediaHandler {
   // event. If all streams get to the hint and there are no video streams, the
   // thread will block until |sync_points_| gives back a promoted cue event.
   double hint_;
+  // Cached from |sync_points_| at initialization; gates RefreshHint().
+  bool runtime_cues_enabled_ = false;
+  // The time of the last cue this handler used, so RefreshHint() does not see
+  // already-used cues again. -1 until the first cue is used.
+  double last_cue_time_ = -1;
 };
 
 }  // namespace media
@@ -363,6 +363,60 @@ TEST_F(CueAlignmentHandlerTest, VideoInputWithCues) {
   ASSERT_OK(FlushAll({kVideoStream}));
 }
 
+TEST_F(CueAlignmentHandlerTest, VideoInputWithRuntimeInjectedCue) {
+  const size_t kVideoStream = 0;
+
+  const int64_t kSampleDuration = 1000;
+  const int64_t kSample0Start = 0;
+  const int64_t kSample1Start = kSample0Start + kSampleDuration;
+  const int64_t kSample2Start = kSample1Start + kSampleDuration;
+
+  const double kSample2StartInSeconds =
+      static_cast<double>(kSample2Start) / kMsTimeScale;
+
+  // Start with no cues at all; the cue is injected while samples flow, as a
+  // live cue injection channel would do it.
+  auto sync_points = CreateSyncPoints({});
+  sync_points->EnableRuntimeCues();
+  auto handler = std::make_shared<CueAlignmentHandler>(sync_points.get());
+  ASSERT_OK(SetUpAndInitializeGraph(handler, kOneInput, kOneOutput));
+
+  {
+    testing::InSequence s;
+
+    EXPECT_CALL(*Output(kVideoStream),
+                OnProcess(IsStreamInfo(_, kMsTimeScale, _, _)));
+    EXPECT_CALL(
+        *Output(kVideoStream),
+        OnProcess(IsMediaSample(_, kSample0Start, kSampleDuration, _, _)));
+    EXPECT_CALL(
+        *Output(kVideoStream),
+        OnProcess(IsMediaSample(_, kSample1Start, kSampleDuration, _, _)));
+    // The cue is injected between two key frames and must be promoted at the
+    // next key frame, just like a cue from the startup cue list.
+    EXPECT_CALL(*Output(kVideoStream),
+                OnProcess(IsCueEvent(_, kSample2StartInSeconds)));
+    EXPECT_CALL(
+        *Output(kVideoStream),
+        OnProcess(IsMediaSample(_, kSample2Start, kSampleDuration, _, _)));
+    EXPECT_CALL(*Output(kVideoStream), OnFlush(_));
+  }
+
+  ASSERT_OK(DispatchVideoInfo(kVideoStream));
+  ASSERT_OK(DispatchMediaSample(kVideoStream, kSample0Start, kSampleDuration,
+                                kKeyFrame));
+
+  EXPECT_TRUE(sync_points->AddCuePoint(static_cast<double>(kSample1Start) /
+                                       kMsTimeScale));
+
+  ASSERT_OK(DispatchMediaSample(kVideoStream, kSample1Start, kSampleDuration,
+                                !kKeyFrame));
+  ASSERT_OK(DispatchMediaSample(kVideoStream, kSample2Start, kSampleDuration,
+                                kKeyFrame));
+
+  ASSERT_OK(FlushAll({kVideoStream}));
+}
+
 TEST_F(CueAlignmentHandlerTest, AudioInputWithCues) {
   const size_t kAudioStream = 0;
 
@@ -12,6 +12,7 @@
 #include <absl/log/check.h>
 
 #include <packager/media/base/media_handler.h>
+#include <packager/utils/stall_monitor.h>
 
 namespace shaka {
 namespace media {
@@ -30,11 +31,12 @@ void SyncPointQueue::AddThread() {
 }
 
 void SyncPointQueue::Cancel() {
-  {
-    absl::MutexLock lock(&mutex_);
-    cancelled_ = true;
-  }
-  sync_condition_.SignalAll();
+  // The slots are only valid while their threads block in GetNext(), so they
+  // have to be signaled with the lock held.
+  absl::MutexLock lock(&mutex_);
+  cancelled_ = true;
+  for (WaitSlot* slot : wait_slots_)
+    slot->cond.Signal();
 }
 
 double SyncPointQueue::GetHint(double time_in_seconds) {
@@ -71,14 +73,24 @@ std::shared_ptr<const CueEvent> SyncPointQueue::GetNext(
       return cue;
     }
 
+    // Register a wait slot so PromoteAtNoLocking() can wake exactly the
+    // waiters a promotion satisfies. This blocks until such a cue is
+    // promoted or the queue is cancelled; if this thread was the last one
+    // running, the self-promotion above has already happened instead.
+    // Spurious signal events are possible with most condition variable
+    // implementations, so the outer loop re-checks the promoted cues.
+    WaitSlot slot(hint_in_seconds);
+    wait_slots_.push_back(&slot);
     waiting_thread_count_++;
-    // This blocks until either a cue is promoted or all threads are blocked
-    // (in which case, the unpromoted cue at the hint will be self-promoted
-    // and returned - see section above). Spurious signal events are possible
-    // with most condition variable implementations, so if it returns, we go
-    // back and check if a cue is actually promoted or not.
-    sync_condition_.Wait(&mutex_);
+    {
+      // A stream blocked here is waiting for the other streams to reach the
+      // next cue; long waits point at a slow sibling stream, not this one.
+      StallMonitor::ScopedWait stall_wait("sync_point_queue.wait", "");
+      while (!slot.signaled && !cancelled_)
+        slot.cond.Wait(&mutex_);
+    }
     waiting_thread_count_--;
+    wait_slots_.remove(&slot);
   }
   return nullptr;
 }
@@ -89,6 +101,24 @@ std::shared_ptr<const CueEvent> SyncPointQueue::PromoteAt(
   return PromoteAtNoLocking(time_in_seconds);
 }
 
+bool SyncPointQueue::AddCuePoint(double time_in_seconds) {
+  absl::MutexLock lock(&mutex_);
+  if (cancelled_)
+    return false;
+  // A cue that is not after the latest promoted cue can never be promoted in
+  // order; reject it so a late injection is an explicit error for the caller
+  // instead of a cue that is silently discarded later.
+  if (!promoted_.empty() && time_in_seconds <= promoted_.rbegin()->first)
+    return false;
+  std::shared_ptr<CueEvent> event = std::make_shared<CueEvent>();
+  event->time_in_seconds = time_in_seconds;
+  unpromoted_[time_in_seconds] = std::move(event);
+  // No waiter needs a wakeup here: waiters wait for a promotion, and a thread
+  // only blocks in GetNext() when at least one other thread is still running
+  // and will eventually promote.
+  return true;
+}
+
 bool SyncPointQueue::HasMore(double hint_in_seconds) const {
   return hint_in_seconds < std::numeric_limits<double>::max();
 }
@@ -124,8 +154,16 @@ std::shared_ptr<const CueEvent> SyncPointQueue::PromoteAtNoLocking(
   // extra unused cues are simply ignored.
   unpromoted_.erase(unpromoted_.begin(), iter);
 
-  // Wake up other threads that may be waiting.
-  sync_condition_.SignalAll();
+  // Wake only the waiters this promotion satisfies (their hint is not
+  // greater than the promoted time); the rest keep sleeping instead of the
+  // previous broadcast, which woke every waiting stream on every promotion
+  // only to have most of them re-check and block again.
+  for (WaitSlot* slot : wait_slots_) {
+    if (!slot->signaled && slot->hint <= time_in_seconds) {
+      slot->signaled = true;
+      slot->cond.Signal();
+    }
+  }
   return cue;
 }
 
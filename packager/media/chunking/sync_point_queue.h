@@ -4,6 +4,7 @@
 // license that can be found in the LICENSE file or at
 // https://developers.google.com/open-source/licenses/bsd
 
+#include <list>
 #include <map>
 #include <memory>
 
@@ -47,6 +48,21 @@ class SyncPointQueue {
   /// unpromoted cues before the cue will be discarded.
   std::shared_ptr<const CueEvent> PromoteAt(double time_in_seconds);
 
+  /// Add a cue point while the streams are running, e.g. from an out-of-band
+  /// ad schedule update. The cue is aligned and promoted exactly like a cue
+  /// point given at construction: it takes effect at the next key frame at or
+  /// after @a time_in_seconds. Thread safe.
+  /// @return False if the queue has been cancelled or the cue is not after
+  ///         the latest promoted cue, i.e. the streams are already past it.
+  bool AddCuePoint(double time_in_seconds);
+
+  /// Mark this queue as accepting runtime cue points. Must be called before
+  /// the packaging threads start. CueAlignmentHandler re-checks the queue for
+  /// new cues only when this is set, so pipelines with a fixed cue list do
+  /// not pay for the extra lock acquisitions.
+  void EnableRuntimeCues() { runtime_cues_enabled_ = true; }
+  bool runtime_cues_enabled() const { return runtime_cues_enabled_; }
+
   /// @return True if there are more cues after the given hint. The hint must
   ///         be a hint returned from |GetHint|. Using any other value results
   ///         in undefined behavior.
@@ -60,11 +76,24 @@ class SyncPointQueue {
   // functions that have locks.
   std::shared_ptr<const CueEvent> PromoteAtNoLocking(double time_in_seconds);
 
+  // One wait slot per blocked GetNext() caller, so a promotion wakes only
+  // the waiters whose hint it satisfies instead of broadcasting to every
+  // waiting stream. Slots live on the waiters' stacks; a slot is only in the
+  // list while its thread blocks in GetNext().
+  struct WaitSlot {
+    explicit WaitSlot(double hint) : hint(hint) {}
+    const double hint;
+    absl::CondVar cond;
+    bool signaled = false;
+  };
+
   absl::Mutex mutex_;
-  absl::CondVar sync_condition_ ABSL_GUARDED_BY(mutex_);
+  std::list<WaitSlot*> wait_slots_ ABSL_GUARDED_BY(mutex_);
   size_t thread_count_ = 0;
   size_t waiting_thread_count_ = 0;
   bool cancelled_ = false;
+  // Written before the packaging threads start, read-only afterwards.
+  bool runtime_cues_enabled_ = false;
 
   std::map<double, std::shared_ptr<CueEvent>> unpromoted_;
   std::map<double, std::shared_ptr<CueEvent>> promoted_;
@@ -16,8 +16,10 @@ namespace {
 const size_t kStreamIndex = 0;
 }  // namespace
 
-TextChunker::TextChunker(double segment_duration_in_seconds)
-    : segment_duration_in_seconds_(segment_duration_in_seconds){};
+TextChunker::TextChunker(double segment_duration_in_seconds,
+                         int64_t zero_start_bias_ms)
+    : segment_duration_in_seconds_(segment_duration_in_seconds),
+      zero_start_bias_ms_(zero_start_bias_ms) {}
 
 Status TextChunker::Process(std::unique_ptr<StreamData> data) {
   switch (data->stream_data_type) {
@@ -76,13 +78,20 @@ Status TextChunker::OnTextSample(std::shared_ptr<const TextSample> sample) {
   // Output all segments that come before our new sample.
   const int64_t sample_start = sample->start_time();
 
-  // If we have not seen a sample yet, base all segments off the first sample's
-  // start time.
+  // If we have not seen a sample yet, decide where the timeline starts.
   if (segment_start_ < 0) {
-    // Force the first segment to start at the segment that would have started
-    // before the sample. This should allow segments from different streams to
-    // align.
-    segment_start_ = (sample_start / segment_duration_) * segment_duration_;
+    const int64_t zero_start_bias = ScaleTime(zero_start_bias_ms_ / 1000.0);
+    if (zero_start_bias_ms_ && sample_start > zero_start_bias) {
+      // The first sample comes too late to assume the stream starts at time
+      // zero. Force the first segment to start at the segment that would have
+      // started before the sample. This should allow segments from different
+      // streams to align.
+      segment_start_ = (sample_start / segment_duration_) * segment_duration_;
+    } else {
+      // Assume the stream starts at time zero. The loop below synthesizes the
+      // leading empty segments up to the sample; no filler samples needed.
+      segment_start_ = 0;
+    }
   }
 
   // We need to write all the segments that would have ended before the new
@@ -92,7 +101,9 @@ Status TextChunker::OnTextSample(std::shared_ptr<const TextSample> sample) {
     RETURN_IF_ERROR(DispatchSegment(segment_duration_));
   }
 
-  samples_in_current_segment_.push_back(std::move(sample));
+  const auto iterator = samples_in_current_segment_.insert(
+      samples_in_current_segment_.end(), std::move(sample));
+  sample_ends_.push(SampleEnd{(*iterator)->EndTime(), iterator});
 
   return Status::OK;
 }
@@ -116,13 +127,16 @@ Status TextChunker::DispatchSegment(int64_t duration) {
   segment_start_ = new_segment_start;
 
   // Remove all samples that end before the (new) current segment started.
-  samples_in_current_segment_.remove_if(
-      [new_segment_start](const std::shared_ptr<const TextSample>& sample) {
-        // For the sample to even be in this list, it should have started
-        // before the (new) current segment.
-        DCHECK_LT(sample->start_time(), new_segment_start);
-        return sample->EndTime() <= new_segment_start;
-      });
+  // The end-time heap means only the samples that actually end here get
+  // touched; samples spanning many segments are left alone.
+  while (!sample_ends_.empty() &&
+         sample_ends_.top().end_time <= new_segment_start) {
+    // For the sample to even be in this list, it should have started before
+    // the (new) current segment.
+    DCHECK_LT((*sample_ends_.top().iterator)->start_time(), new_segment_start);
+    samples_in_current_segment_.erase(sample_ends_.top().iterator);
+    sample_ends_.pop();
+  }
 
   return Status::OK;
 }
@@ -7,7 +7,10 @@
 #ifndef PACKAGER_MEDIA_CHUNKING_TEXT_CHUNKER_H_
 #define PACKAGER_MEDIA_CHUNKING_TEXT_CHUNKER_H_
 
+#include <functional>
 #include <list>
+#include <queue>
+#include <vector>
 
 #include <packager/media/base/media_handler.h>
 
@@ -18,9 +21,18 @@ namespace media {
 // segment info based on a fixed segment duration and on cue events. The
 // only time a segment's duration will not match the fixed segment duration
 // is when a cue event is seen.
+//
+// The chunker handles sparse timelines natively: gaps between samples and
+// the gap before the first sample produce empty segments (a segment info
+// with no samples) directly, without materializing filler samples.
 class TextChunker : public MediaHandler {
  public:
-  explicit TextChunker(double segment_duration_in_seconds);
+  // |zero_start_bias_ms| is the threshold used to determine if the stream
+  // should be assumed to actually start at time zero. If the first sample
+  // starts before |zero_start_bias_ms|, segments are synthesized from time
+  // zero up to it; otherwise the first segment starts at the segment boundary
+  // preceding the first sample, as the stream's start time cannot be assumed.
+  TextChunker(double segment_duration_in_seconds, int64_t zero_start_bias_ms);
 
  private:
   TextChunker(const TextChunker&) = delete;
@@ -45,6 +57,7 @@ class TextChunker : public MediaHandler {
   int64_t ScaleTime(double seconds) const;
 
   double segment_duration_in_seconds_;
+  const int64_t zero_start_bias_ms_;
 
   int64_t time_scale_ = -1;  // Set in OnStreamInfo
 
@@ -54,8 +67,24 @@ class TextChunker : public MediaHandler {
 
   // All samples that make up the current segment. We must store the samples
   // until the segment ends because a cue event may end the segment sooner
-  // than we expected.
+  // than we expected. The list preserves arrival order, which is the order
+  // samples are dispatched in within each segment.
   std::list<std::shared_ptr<const TextSample>> samples_in_current_segment_;
+
+  // Min-heap of open samples keyed by end time, holding iterators into
+  // |samples_in_current_segment_|. At each segment boundary only the samples
+  // that actually end are popped and erased, so long-lived cues are not
+  // rescanned segment after segment.
+  struct SampleEnd {
+    int64_t end_time;
+    std::list<std::shared_ptr<const TextSample>>::iterator iterator;
+
+    bool operator>(const SampleEnd& other) const {
+      return end_time > other.end_time;
+    }
+  };
+  std::priority_queue<SampleEnd, std::vector<SampleEnd>, std::greater<SampleEnd>>
+      sample_ends_;
 };
 
 }  // namespace media
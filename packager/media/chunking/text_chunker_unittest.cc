@@ -36,14 +36,77 @@ const char* kNoPayload = "";
 
 class TextChunkerTest : public MediaHandlerTestBase {
  protected:
-  Status Init(double segment_duration) {
+  // A zero bias of zero means the stream is always assumed to start at time
+  // zero, which is the pipeline default.
+  Status Init(double segment_duration) { return Init(segment_duration, 0); }
+
+  Status Init(double segment_duration, int64_t zero_start_bias_ms) {
     return SetUpAndInitializeGraph(
-        std::make_shared<TextChunker>(segment_duration), kInputs, kOutputs);
+        std::make_shared<TextChunker>(segment_duration, zero_start_bias_ms),
+        kInputs, kOutputs);
   }
 };
 
-// Verify that the chunker will use the first sample's start time as the start
-// time for the first segment.
+// Verify that by default segments are synthesized from time zero up to the
+// first sample, without any filler samples being created.
+//
+// Segment Duration = 100 MS
+//
+// TIME (ms):0     5     1     1     2     2     3
+//                 0     0     5     0     5     0
+//                       0     0     0     0     0
+// SAMPLES  :               [-----A-----]
+// SEGMENTS :^           ^           ^           ^
+//
+TEST_F(TextChunkerTest, SegmentsStartAtZero) {
+  const double kSegmentDurationSec = 0.1;
+  const int64_t kSegmentDurationMs = 100;
+  const int64_t kSegment0Start = 0;
+  const int64_t kSegment1Start = 100;
+  const int64_t kSegment2Start = 200;
+
+  const int64_t kSampleAStart = 120;
+  const int64_t kSampleAEnd = 220;
+
+  ASSERT_OK(Init(kSegmentDurationSec));
+
+  {
+    testing::InSequence s;
+
+    EXPECT_CALL(*Output(kOutput), OnProcess(IsStreamInfo(_, _, _, _)));
+
+    // Segment One (empty, covers the gap before the first sample).
+    EXPECT_CALL(
+        *Output(kOutput),
+        OnProcess(IsSegmentInfo(_, kSegment0Start, kSegmentDurationMs, _, _)));
+
+    // Segment Two
+    EXPECT_CALL(*Output(kOutput),
+                OnProcess(IsTextSample(_, _, kSampleAStart, kSampleAEnd)));
+    EXPECT_CALL(
+        *Output(kOutput),
+        OnProcess(IsSegmentInfo(_, kSegment1Start, kSegmentDurationMs, _, _)));
+
+    // Segment Three
+    EXPECT_CALL(*Output(kOutput),
+                OnProcess(IsTextSample(_, _, kSampleAStart, kSampleAEnd)));
+    EXPECT_CALL(
+        *Output(kOutput),
+        OnProcess(IsSegmentInfo(_, kSegment2Start, kSegmentDurationMs, _, _)));
+    EXPECT_CALL(*Output(kOutput), OnFlush(kStreamIndex));
+  }
+
+  ASSERT_OK(Input(kInput)->Dispatch(StreamData::FromStreamInfo(
+      kStreamIndex, GetTextStreamInfo(kTimescaleMs))));
+  ASSERT_OK(Input(kInput)->Dispatch(StreamData::FromTextSample(
+      kStreamIndex,
+      GetTextSample(kNoId, kSampleAStart, kSampleAEnd, kNoPayload))));
+  ASSERT_OK(Input(kInput)->FlushAllDownstreams());
+}
+
+// Verify that when the first sample starts after the zero start bias, the
+// chunker uses the first sample's start time as the start time for the first
+// segment instead of assuming the stream starts at time zero.
 //
 // Segment Duration = 100 MS
 //
@@ -53,16 +116,17 @@ class TextChunkerTest : public MediaHandlerTestBase {
 // SAMPLES  :               [-----A-----]
 // SEGMENTS :            ^           ^           ^
 //
-TEST_F(TextChunkerTest, SegmentsStartAtFirstSample) {
+TEST_F(TextChunkerTest, SegmentsStartAtFirstSampleBeyondBias) {
   const double kSegmentDurationSec = 0.1;
   const int64_t kSegmentDurationMs = 100;
+  const int64_t kZeroStartBiasMs = 100;
   const int64_t kSegment0Start = 100;
   const int64_t kSegment1Start = 200;
 
   const int64_t kSampleAStart = 120;
   const int64_t kSampleAEnd = 220;
 
-  ASSERT_OK(Init(kSegmentDurationSec));
+  ASSERT_OK(Init(kSegmentDurationSec, kZeroStartBiasMs));
 
   {
     testing::InSequence s;
@@ -89,6 +153,52 @@ TEST_F(TextChunkerTest, SegmentsStartAtFirstSample) {
   ASSERT_OK(Input(kInput)->FlushAllDownstreams());
 }
 
+// Verify that a sample starting within the zero start bias anchors the
+// timeline at zero even though it does not start exactly at zero.
+//
+// Segment Duration = 100 MS, Zero Start Bias = 200 MS
+//
+// TIME (ms):0     5     1     1     2
+//                 0     0     5     0
+//                       0     0     0
+// SAMPLES  :               [--A--]
+// SEGMENTS :^           ^           ^
+//
+TEST_F(TextChunkerTest, SegmentsStartAtZeroWithinBias) {
+  const double kSegmentDurationSec = 0.1;
+  const int64_t kSegmentDurationMs = 100;
+  const int64_t kZeroStartBiasMs = 200;
+  const int64_t kSegment0Start = 0;
+  const int64_t kSegment1Start = 100;
+
+  const int64_t kSampleAStart = 120;
+  const int64_t kSampleAEnd = 200;
+
+  ASSERT_OK(Init(kSegmentDurationSec, kZeroStartBiasMs));
+
+  {
+    testing::InSequence s;
+
+    EXPECT_CALL(*Output(kOutput), OnProcess(IsStreamInfo(_, _, _, _)));
+    EXPECT_CALL(
+        *Output(kOutput),
+        OnProcess(IsSegmentInfo(_, kSegment0Start, kSegmentDurationMs, _, _)));
+    EXPECT_CALL(*Output(kOutput),
+                OnProcess(IsTextSample(_, _, kSampleAStart, kSampleAEnd)));
+    EXPECT_CALL(
+        *Output(kOutput),
+        OnProcess(IsSegmentInfo(_, kSegment1Start, kSegmentDurationMs, _, _)));
+    EXPECT_CALL(*Output(kOutput), OnFlush(kStreamIndex));
+  }
+
+  ASSERT_OK(Input(kInput)->Dispatch(StreamData::FromStreamInfo(
+      kStreamIndex, GetTextStreamInfo(kTimescaleMs))));
+  ASSERT_OK(Input(kInput)->Dispatch(StreamData::FromTextSample(
+      kStreamIndex,
+      GetTextSample(kNoId, kSampleAStart, kSampleAEnd, kNoPayload))));
+  ASSERT_OK(Input(kInput)->FlushAllDownstreams());
+}
+
 // Verify that when a sample elapses a full segment, that it only appears
 // in the one segment.
 //
@@ -5,9 +5,12 @@
 #include <packager/media/codecs/aac_audio_specific_config.h>
 
 #include <algorithm>
+#include <deque>
+#include <map>
 
 #include <absl/log/check.h>
 #include <absl/log/log.h>
+#include <absl/synchronization/mutex.h>
 
 #include <packager/media/base/bit_reader.h>
 #include <packager/media/base/rcheck.h>
@@ -41,6 +44,25 @@ bool CountChannels(uint8_t num_elements,
   return true;
 }
 
+// The same decoder specific information repeats unchanged across the
+// renditions of a channel and across jobs in engine mode, and shows up again
+// whenever the config is carried in-band, so successful parses are memoized
+// process-wide keyed by the raw bytes. The working set is a handful of
+// configs; stale entries are evicted oldest first.
+const size_t kMaxCachedConfigs = 64;
+
+struct ConfigCache {
+  absl::Mutex mutex;
+  std::map<std::vector<uint8_t>, AACAudioSpecificConfig> parsed
+      ABSL_GUARDED_BY(mutex);
+  std::deque<std::vector<uint8_t>> insertion_order ABSL_GUARDED_BY(mutex);
+};
+
+ConfigCache* GetConfigCache() {
+  static ConfigCache* cache = new ConfigCache;
+  return cache;
+}
+
 }  // namespace
 
 AACAudioSpecificConfig::AACAudioSpecificConfig() {}
@@ -48,6 +70,31 @@ AACAudioSpecificConfig::AACAudioSpecificConfig() {}
 AACAudioSpecificConfig::~AACAudioSpecificConfig() {}
 
 bool AACAudioSpecificConfig::Parse(const std::vector<uint8_t>& data) {
+  ConfigCache* cache = GetConfigCache();
+  {
+    absl::MutexLock lock(&cache->mutex);
+    auto iter = cache->parsed.find(data);
+    if (iter != cache->parsed.end()) {
+      *this = iter->second;
+      return true;
+    }
+  }
+
+  if (!ParseInternal(data))
+    return false;
+
+  absl::MutexLock lock(&cache->mutex);
+  if (cache->parsed.emplace(data, *this).second) {
+    cache->insertion_order.push_back(data);
+    while (cache->parsed.size() > kMaxCachedConfigs) {
+      cache->parsed.erase(cache->insertion_order.front());
+      cache->insertion_order.pop_front();
+    }
+  }
+  return true;
+}
+
+bool AACAudioSpecificConfig::ParseInternal(const std::vector<uint8_t>& data) {
   if (data.empty())
     return false;
 
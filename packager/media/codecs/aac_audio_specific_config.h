@@ -79,6 +79,9 @@ class AACAudioSpecificConfig {
   /// ElementaryStreamDescriptor, then it will parse the
   /// ElementaryStreamDescriptor to get audio stream configurations.
   /// @param data contains decoder specific information from an @b esds box.
+  /// Successful parses are memoized in a process-wide cache keyed by the raw
+  /// config bytes; identical configs (repeated in-band, or shared across
+  /// renditions and jobs) reduce to a lookup instead of a bit-level reparse.
   /// @return true if successful, false otherwise.
   virtual bool Parse(const std::vector<uint8_t>& data);
 
@@ -113,6 +116,8 @@ class AACAudioSpecificConfig {
   void set_sbr_present(bool sbr_present) { sbr_present_ = sbr_present; }
 
  private:
+  // Parses |data| without consulting the process-wide config cache.
+  bool ParseInternal(const std::vector<uint8_t>& data);
   bool ParseAudioObjectType(BitReader* bit_reader);
   bool ParseDecoderGASpecificConfig(BitReader* bit_reader);
   bool SkipErrorSpecificConfig() const;
@@ -23,6 +23,25 @@ TEST(AACAudioSpecificConfigTest, BasicProfileTest) {
             aac_audio_specific_config.GetAudioObjectType());
 }
 
+TEST(AACAudioSpecificConfigTest, RepeatedParseIsConsistent) {
+  uint8_t buffer[] = {0x12, 0x10};
+  std::vector<uint8_t> data(buffer, buffer + sizeof(buffer));
+
+  // The first parse populates the process-wide config cache, the second is
+  // served from it; both must yield the same values, and mutating one
+  // object must not leak into later parses of the same bytes.
+  AACAudioSpecificConfig first;
+  EXPECT_TRUE(first.Parse(data));
+  first.set_sbr_present(true);
+
+  AACAudioSpecificConfig second;
+  EXPECT_TRUE(second.Parse(data));
+  EXPECT_EQ(44100u, second.GetSamplesPerSecond());
+  EXPECT_EQ(2u, second.GetNumChannels());
+  EXPECT_EQ(AACAudioSpecificConfig::AOT_AAC_LC, second.GetAudioObjectType());
+  EXPECT_FALSE(second.sbr_present());
+}
+
 TEST(AACAudioSpecificConfigTest, ExtensionTest) {
   AACAudioSpecificConfig aac_audio_specific_config;
   uint8_t buffer[] = {0x13, 0x08, 0x56, 0xe5, 0x9d, 0x48, 0x80};
@@ -7,6 +7,7 @@
 #include <packager/media/codecs/av1_parser.h>
 
 #include <algorithm>
+#include <cstring>
 
 #include <absl/log/check.h>
 #include <absl/log/log.h>
@@ -262,14 +263,15 @@ bool AV1Parser::Parse(const uint8_t* data,
 
   BitReader reader(data, data_size);
   while (reader.bits_available() > 0) {
-    if (!ParseOpenBitstreamUnit(&reader, tiles))
+    if (!ParseOpenBitstreamUnit(data, &reader, tiles))
       return false;
   }
   return true;
 }
 
 // 5.3.1. General OBU syntax.
-bool AV1Parser::ParseOpenBitstreamUnit(BitReader* reader,
+bool AV1Parser::ParseOpenBitstreamUnit(const uint8_t* data,
+                                       BitReader* reader,
                                        std::vector<Tile>* tiles) {
   ObuHeader obu_header;
   RCHECK(ParseObuHeader(reader, &obu_header));
@@ -283,10 +285,28 @@ bool AV1Parser::ParseOpenBitstreamUnit(BitReader* reader,
   VLOG(4) << "OBU " << obu_header.obu_type << " size " << obu_size;
 
   const size_t start_position = reader->bit_position();
+  bool reused_sequence_header = false;
   switch (obu_header.obu_type) {
-    case OBU_SEQUENCE_HEADER:
+    case OBU_SEQUENCE_HEADER: {
+      // OBU headers and sizes are whole bytes, so the payload starts byte
+      // aligned and can be compared as raw bytes. Sequence headers are
+      // repeated verbatim throughout a stream; when the payload matches the
+      // one parsed last time, |sequence_header_| is already up to date and the
+      // whole OBU (trailing bits included) can be skipped.
+      DCHECK_EQ(start_position % 8, 0u);
+      const uint8_t* payload = data + start_position / 8;
+      if (obu_size > 0 && obu_size == last_sequence_header_payload_.size() &&
+          memcmp(payload, last_sequence_header_payload_.data(), obu_size) ==
+              0) {
+        RCHECK(reader->SkipBits(obu_size * 8));
+        reused_sequence_header = true;
+        break;
+      }
       RCHECK(ParseSequenceHeaderObu(reader));
+      if (obu_size > 0)
+        last_sequence_header_payload_.assign(payload, payload + obu_size);
       break;
+    }
     case OBU_FRAME_HEADER:
     case OBU_REDUNDENT_FRAME_HEADER:
       RCHECK(ParseFrameHeaderObu(obu_header, reader));
@@ -308,6 +328,10 @@ bool AV1Parser::ParseOpenBitstreamUnit(BitReader* reader,
   if (obu_header.obu_type == OBU_TILE_GROUP ||
       obu_header.obu_type == OBU_FRAME) {
     RCHECK(payload_bits == obu_size * 8);
+  } else if (reused_sequence_header) {
+    // The skip above consumed the trailing bits, which were validated when
+    // this sequence header was first parsed.
+    RCHECK(payload_bits == obu_size * 8);
   } else if (obu_size > 0) {
     RCHECK(payload_bits <= obu_size * 8);
     RCHECK(ParseTrailingBits(obu_size * 8 - payload_bits, reader));
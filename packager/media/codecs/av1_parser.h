@@ -194,7 +194,9 @@ class AV1Parser {
     bool subsampling_y = false;
   };
 
-  bool ParseOpenBitstreamUnit(BitReader* reader, std::vector<Tile>* tiles);
+  bool ParseOpenBitstreamUnit(const uint8_t* data,
+                              BitReader* reader,
+                              std::vector<Tile>* tiles);
   bool ParseObuHeader(BitReader* reader, ObuHeader* obu_header);
   bool ParseObuExtensionHeader(BitReader* reader,
                                ObuExtensionHeader* obu_extension_header);
@@ -276,6 +278,11 @@ class AV1Parser {
   int GetQIndex(bool ignore_delta_q, int segment_id);
 
   SequenceHeaderObu sequence_header_;
+  // Raw payload of the last parsed sequence header OBU. Encoders repeat the
+  // sequence header verbatim (e.g. in front of every key frame), so when the
+  // incoming payload is byte-identical we keep |sequence_header_| as is
+  // instead of re-parsing it.
+  std::vector<uint8_t> last_sequence_header_payload_;
   FrameHeaderObu frame_header_;
   static constexpr int kNumRefFrames = 8;
   ReferenceFrame reference_frames_[kNumRefFrames];
@@ -31,5 +31,19 @@ TEST(AV1ParserTest, ParseIFrameSuccess) {
   EXPECT_THAT(tiles, ElementsAre(AV1Parser::Tile{0x1d, 0x4e1}));
 }
 
+TEST(AV1ParserTest, ReparseWithRepeatedSequenceHeader) {
+  const std::vector<uint8_t> buffer = ReadTestDataFile("av1-I-frame-320x240");
+  ASSERT_FALSE(buffer.empty());
+
+  // The second pass sees the byte-identical sequence header again and takes
+  // the cached fast path; the parsed output must not change.
+  AV1Parser parser;
+  std::vector<AV1Parser::Tile> tiles;
+  for (int i = 0; i < 2; i++) {
+    ASSERT_TRUE(parser.Parse(buffer.data(), buffer.size(), &tiles));
+    EXPECT_THAT(tiles, ElementsAre(AV1Parser::Tile{0x1d, 0x4e1}));
+  }
+}
+
 }  // namespace media
 }  // namespace shaka
@@ -4,7 +4,11 @@
 
 #include <packager/media/codecs/es_descriptor.h>
 
+#include <deque>
+#include <map>
+
 #include <absl/log/check.h>
+#include <absl/synchronization/mutex.h>
 
 #include <packager/media/base/bit_reader.h>
 #include <packager/media/base/buffer_writer.h>
@@ -197,6 +201,52 @@ size_t SLConfigDescriptor::ComputeDataSize() {
   return 1;
 }
 
+namespace {
+
+// The same esds payload repeats unchanged across the renditions of a channel
+// and across jobs in engine mode, so successful parses are memoized
+// process-wide keyed by the raw bytes. The working set is a handful of
+// descriptors; stale entries are evicted oldest first.
+const size_t kMaxCachedDescriptors = 64;
+
+struct DescriptorCache {
+  absl::Mutex mutex;
+  std::map<std::vector<uint8_t>, ESDescriptor> parsed ABSL_GUARDED_BY(mutex);
+  std::deque<std::vector<uint8_t>> insertion_order ABSL_GUARDED_BY(mutex);
+};
+
+DescriptorCache* GetDescriptorCache() {
+  static DescriptorCache* cache = new DescriptorCache;
+  return cache;
+}
+
+}  // namespace
+
+bool ESDescriptor::Parse(const std::vector<uint8_t>& data) {
+  DescriptorCache* cache = GetDescriptorCache();
+  {
+    absl::MutexLock lock(&cache->mutex);
+    auto iter = cache->parsed.find(data);
+    if (iter != cache->parsed.end()) {
+      *this = iter->second;
+      return true;
+    }
+  }
+
+  if (!BaseDescriptor::Parse(data))
+    return false;
+
+  absl::MutexLock lock(&cache->mutex);
+  if (cache->parsed.emplace(data, *this).second) {
+    cache->insertion_order.push_back(data);
+    while (cache->parsed.size() > kMaxCachedDescriptors) {
+      cache->parsed.erase(cache->insertion_order.front());
+      cache->insertion_order.pop_front();
+    }
+  }
+  return true;
+}
+
 bool ESDescriptor::ReadData(BitReader* reader) {
   bool stream_dependency_flag;
   bool url_flag;
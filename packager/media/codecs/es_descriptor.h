@@ -173,6 +173,13 @@ class ESDescriptor : public BaseDescriptor {
  public:
   ESDescriptor() : BaseDescriptor(DescriptorTag::kES) {}
 
+  /// Parse the descriptor from input data. Shadows BaseDescriptor::Parse to
+  /// memoize successful parses in a process-wide cache keyed by the raw
+  /// bytes; the same esds payload repeats unchanged across renditions and
+  /// jobs, so repeated parses reduce to a lookup.
+  /// @param data contains the descriptor data.
+  bool Parse(const std::vector<uint8_t>& data);
+
   uint16_t esid() const { return esid_; }
 
   const DecoderConfigDescriptor& decoder_config_descriptor() const {
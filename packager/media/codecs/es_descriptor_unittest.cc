@@ -71,6 +71,49 @@ TEST(ESDescriptorTest, SingleByteLengthTest) {
       ElementsAreArray(kBuffer));
 }
 
+TEST(ESDescriptorTest, RepeatedParseIsConsistent) {
+  // clang-format off
+  const uint8_t kBuffer[] = {
+      // ESDescriptor tag with one byte size.
+      0x03, 0x19,
+        // ESDescriptor fields.
+        0x00, 0x00, 0x00,
+        // DecoderConfigDescriptor tag with one byte size.
+        0x04, 0x11,
+          // Object Type.
+          0x40,
+          // Three 4-byte fields: dummy, max bitrate, avg bitrate.
+          0x15, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          // DecoderSpecificInfo tag with one byte size.
+          0x05, 0x02,
+            // DecoderSpecificInfo fields.
+            0x12, 0x10,
+        // SLConfig tag with one byte size.
+        0x06, 0x01,
+          // SLConfig fields.
+          0x02,
+  };
+  // clang-format on
+  std::vector<uint8_t> data(std::begin(kBuffer), std::end(kBuffer));
+
+  // The first parse populates the process-wide descriptor cache, the second
+  // is served from it; both must yield the same values, and mutating one
+  // descriptor must not leak into later parses of the same bytes.
+  ESDescriptor first;
+  EXPECT_TRUE(first.Parse(data));
+  first.mutable_decoder_config_descriptor()->set_object_type(
+      ObjectType::kForbidden);
+
+  ESDescriptor second;
+  EXPECT_TRUE(second.Parse(data));
+  EXPECT_EQ(ObjectType::kISO_14496_3,
+            second.decoder_config_descriptor().object_type());
+  EXPECT_THAT(
+      second.decoder_config_descriptor().decoder_specific_info_descriptor()
+          .data(),
+      ElementsAre(0x12, 0x10));
+}
+
 TEST(ESDescriptorTest, NonAACTest) {
   // clang-format off
   const uint8_t kBuffer[] = {
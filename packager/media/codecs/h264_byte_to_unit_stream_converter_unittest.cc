@@ -81,6 +81,80 @@ TEST(H264ByteToUnitStreamConverter, ConversionFailure) {
   EXPECT_FALSE(converter.GetDecoderConfigurationRecord(&decoder_config));
 }
 
+TEST(H264ByteToUnitStreamConverter, InPlaceConversion) {
+  const uint8_t kByteStream[] = {
+      0x00, 0x00, 0x00, 0x01,  // Start code
+      0x09,                    // AUD Type
+      0xF0,                    // Primary pic type
+      0x00, 0x00, 0x00, 0x01,  // Start code
+      // Some SEI data
+      0x06, 0xFD, 0x78, 0xA4,
+  };
+  std::vector<uint8_t> in_place_frame(std::begin(kByteStream),
+                                      std::end(kByteStream));
+
+  H264ByteToUnitStreamConverter converter(
+      H26xStreamFormat::kNalUnitStreamWithParameterSetNalus);
+  ASSERT_TRUE(converter.ConvertByteStreamToNalUnitStreamInPlace(
+      in_place_frame.data(), in_place_frame.size()));
+
+  // The in-place result must match the copying conversion.
+  std::vector<uint8_t> copied_frame;
+  ASSERT_TRUE(converter.ConvertByteStreamToNalUnitStream(
+      kByteStream, sizeof(kByteStream), &copied_frame));
+  EXPECT_EQ(copied_frame, in_place_frame);
+
+  const uint8_t kExpectedUnitStream[] = {
+      0x00, 0x00, 0x00, 0x02, 0x09, 0xF0,
+      0x00, 0x00, 0x00, 0x04, 0x06, 0xFD, 0x78, 0xA4,
+  };
+  EXPECT_EQ(std::vector<uint8_t>(std::begin(kExpectedUnitStream),
+                                 std::end(kExpectedUnitStream)),
+            in_place_frame);
+}
+
+TEST(H264ByteToUnitStreamConverter, InPlaceConversionRejectsThreeByteStartCode) {
+  const uint8_t kByteStream[] = {
+      0x00, 0x00, 0x00, 0x01,  // Start code
+      0x09,                    // AUD Type
+      0xF0,                    // Primary pic type
+      0x00, 0x00, 0x01,        // Three-byte start code
+      // Some SEI data
+      0x06, 0xFD, 0x78, 0xA4,
+  };
+  std::vector<uint8_t> frame(std::begin(kByteStream), std::end(kByteStream));
+
+  H264ByteToUnitStreamConverter converter(
+      H26xStreamFormat::kNalUnitStreamWithParameterSetNalus);
+  EXPECT_FALSE(converter.ConvertByteStreamToNalUnitStreamInPlace(frame.data(),
+                                                                 frame.size()));
+  // The frame must be left untouched for the copying fallback.
+  EXPECT_EQ(std::vector<uint8_t>(std::begin(kByteStream),
+                                 std::end(kByteStream)),
+            frame);
+}
+
+TEST(H264ByteToUnitStreamConverter, InPlaceConversionRejectsStrippedNalu) {
+  std::vector<uint8_t> input_frame =
+      ReadTestDataFile("avc-byte-stream-frame.h264");
+  ASSERT_FALSE(input_frame.empty());
+
+  // The frame carries SPS/PPS which must be stripped in avc1 mode, so the
+  // in-place conversion does not apply and the frame must be left untouched
+  // for the copying fallback.
+  H264ByteToUnitStreamConverter converter(
+      H26xStreamFormat::kNalUnitStreamWithoutParameterSetNalus);
+  std::vector<uint8_t> frame = input_frame;
+  EXPECT_FALSE(converter.ConvertByteStreamToNalUnitStreamInPlace(frame.data(),
+                                                                 frame.size()));
+  EXPECT_EQ(input_frame, frame);
+
+  std::vector<uint8_t> output_frame;
+  ASSERT_TRUE(converter.ConvertByteStreamToNalUnitStream(
+      frame.data(), frame.size(), &output_frame));
+  EXPECT_EQ(ReadTestDataFile("avc1-unit-stream-frame.h264"), output_frame);
+}
+
 TEST(H264ByteToUnitStreamConverter, NaluConversionWithSpsExtension) {
   const uint8_t kByteStreamWithSpsExtension[] = {
       0x00, 0x00, 0x00, 0x01,  // Start code
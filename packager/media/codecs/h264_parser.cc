@@ -5,7 +5,9 @@
 #include <packager/media/codecs/h264_parser.h>
 
 #include <memory>
+#include <string_view>
 
+#include <absl/hash/hash.h>
 #include <absl/log/check.h>
 #include <absl/log/log.h>
 
@@ -22,6 +24,29 @@
 namespace shaka {
 namespace media {
 
+namespace {
+
+// 64-bit content hash of a NALU payload, used to recognize parameter sets
+// that are byte-identical to ones already decoded.
+uint64_t HashNaluPayload(const Nalu& nalu) {
+  return absl::Hash<std::string_view>{}(std::string_view(
+      reinterpret_cast<const char*>(nalu.data() + nalu.header_size()),
+      nalu.payload_size()));
+}
+
+// Drops memoized payload hashes that resolved to |id|, which is about to be
+// replaced by a newly parsed parameter set.
+void EraseCachedPayloadsForId(std::map<uint64_t, int>* cache, int id) {
+  for (auto itr = cache->begin(); itr != cache->end();) {
+    if (itr->second == id)
+      itr = cache->erase(itr);
+    else
+      ++itr;
+  }
+}
+
+}  // namespace
+
 // Implemented according to ISO/IEC 14496-10:2005 7.4.2.1 Sequence parameter set
 // RBSP semantics.
 bool ExtractResolutionFromSps(const H264Sps& sps,
@@ -585,6 +610,16 @@ H264Parser::Result H264Parser::ParseSps(const Nalu& nalu, int* sps_id) {
   // See 7.4.2.1.
   int data;
   Result res;
+
+  // Live encoders repeat identical parameter sets ahead of every IDR; if the
+  // payload is byte-identical to an SPS already decoded, reuse it.
+  const uint64_t payload_hash = HashNaluPayload(nalu);
+  const auto cached = sps_id_by_payload_hash_.find(payload_hash);
+  if (cached != sps_id_by_payload_hash_.end()) {
+    *sps_id = cached->second;
+    return kOk;
+  }
+
   H26xBitReader reader;
   reader.Initialize(nalu.data() + nalu.header_size(), nalu.payload_size());
   H26xBitReader* br = &reader;
@@ -698,6 +733,8 @@ H264Parser::Result H264Parser::ParseSps(const Nalu& nalu, int* sps_id) {
   // If an SPS with the same id already exists, replace it.
   *sps_id = sps->seq_parameter_set_id;
   active_SPSes_[*sps_id] = std::move(sps);
+  EraseCachedPayloadsForId(&sps_id_by_payload_hash_, *sps_id);
+  sps_id_by_payload_hash_[payload_hash] = *sps_id;
 
   return kOk;
 }
@@ -706,6 +743,14 @@ H264Parser::Result H264Parser::ParsePps(const Nalu& nalu, int* pps_id) {
   // See 7.4.2.2.
   const H264Sps* sps;
   Result res;
+
+  const uint64_t payload_hash = HashNaluPayload(nalu);
+  const auto cached = pps_id_by_payload_hash_.find(payload_hash);
+  if (cached != pps_id_by_payload_hash_.end()) {
+    *pps_id = cached->second;
+    return kOk;
+  }
+
   H26xBitReader reader;
   reader.Initialize(nalu.data() + nalu.header_size(), nalu.payload_size());
   H26xBitReader* br = &reader;
@@ -771,6 +816,8 @@ H264Parser::Result H264Parser::ParsePps(const Nalu& nalu, int* pps_id) {
   // If a PPS with the same id already exists, replace it.
   *pps_id = pps->pic_parameter_set_id;
   active_PPSes_[*pps_id] = std::move(pps);
+  EraseCachedPayloadsForId(&pps_id_by_payload_hash_, *pps_id);
+  pps_id_by_payload_hash_[payload_hash] = *pps_id;
 
   return kOk;
 }
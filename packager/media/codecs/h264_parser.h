@@ -332,6 +332,12 @@ class H264Parser {
   SpsById active_SPSes_;
   PpsById active_PPSes_;
 
+  // Content hashes of the raw payloads the active parameter sets were parsed
+  // from, so byte-identical repeats (common in live streams, once per IDR)
+  // skip the Exp-Golomb re-parse.
+  std::map<uint64_t, int> sps_id_by_payload_hash_;
+  std::map<uint64_t, int> pps_id_by_payload_hash_;
+
   DISALLOW_COPY_AND_ASSIGN(H264Parser);
 };
 
@@ -8,7 +8,9 @@
 
 #include <algorithm>
 #include <cmath>
+#include <string_view>
 
+#include <absl/hash/hash.h>
 #include <absl/log/check.h>
 #include <absl/log/log.h>
 
@@ -51,6 +53,25 @@ namespace shaka {
 namespace media {
 
 namespace {
+
+// 64-bit content hash of a NALU payload; repeated parameter sets are
+// recognized by hash instead of being re-parsed.
+uint64_t HashNaluPayload(const Nalu& nalu) {
+  return absl::Hash<std::string_view>{}(std::string_view(
+      reinterpret_cast<const char*>(nalu.data() + nalu.header_size()),
+      nalu.payload_size()));
+}
+
+// Invalidates memoized payloads that resolved to |id| before it is replaced.
+void EraseCachedPayloadsForId(std::map<uint64_t, int>* cache, int id) {
+  for (auto itr = cache->begin(); itr != cache->end();) {
+    if (itr->second == id)
+      itr = cache->erase(itr);
+    else
+      ++itr;
+  }
+}
+
 int GetNumPicTotalCurr(const H265SliceHeader& slice_header,
                        const H265Sps& sps) {
   int num_pic_total_curr = 0;
@@ -420,6 +441,15 @@ H265Parser::Result H265Parser::ParseSliceHeader(const Nalu& nalu,
 H265Parser::Result H265Parser::ParsePps(const Nalu& nalu, int* pps_id) {
   DCHECK_EQ(Nalu::H265_PPS, nalu.type());
 
+  // Live encoders repeat identical parameter sets ahead of every IDR; if the
+  // payload is byte-identical to a PPS already decoded, reuse it.
+  const uint64_t payload_hash = HashNaluPayload(nalu);
+  const auto cached = pps_id_by_payload_hash_.find(payload_hash);
+  if (cached != pps_id_by_payload_hash_.end()) {
+    *pps_id = cached->second;
+    return kOk;
+  }
+
   // Reads most of the element, not reading the extension data.
   H26xBitReader reader;
   reader.Initialize(nalu.data() + nalu.header_size(), nalu.payload_size());
@@ -521,6 +551,8 @@ H265Parser::Result H265Parser::ParsePps(const Nalu& nalu, int* pps_id) {
   // This will replace any existing PPS instance.
   *pps_id = pps->pic_parameter_set_id;
   active_ppses_[*pps_id] = std::move(pps);
+  EraseCachedPayloadsForId(&pps_id_by_payload_hash_, *pps_id);
+  pps_id_by_payload_hash_[payload_hash] = *pps_id;
 
   return kOk;
 }
@@ -528,6 +560,13 @@ H265Parser::Result H265Parser::ParsePps(const Nalu& nalu, int* pps_id) {
 H265Parser::Result H265Parser::ParseSps(const Nalu& nalu, int* sps_id) {
   DCHECK_EQ(Nalu::H265_SPS, nalu.type());
 
+  const uint64_t payload_hash = HashNaluPayload(nalu);
+  const auto cached = sps_id_by_payload_hash_.find(payload_hash);
+  if (cached != sps_id_by_payload_hash_.end()) {
+    *sps_id = cached->second;
+    return kOk;
+  }
+
   // Reads most of the element, not reading the extension data.
   H26xBitReader reader;
   reader.Initialize(nalu.data() + nalu.header_size(), nalu.payload_size());
@@ -638,6 +677,8 @@ H265Parser::Result H265Parser::ParseSps(const Nalu& nalu, int* sps_id) {
   // This will replace any existing SPS instance.
   *sps_id = sps->seq_parameter_set_id;
   active_spses_[*sps_id] = std::move(sps);
+  EraseCachedPayloadsForId(&sps_id_by_payload_hash_, *sps_id);
+  sps_id_by_payload_hash_[payload_hash] = *sps_id;
 
   return kOk;
 }
@@ -365,6 +365,11 @@ class H265Parser {
   SpsById active_spses_;
   PpsById active_ppses_;
 
+  // Content hashes of the raw payloads the active parameter sets were parsed
+  // from; byte-identical repeats skip the re-parse.
+  std::map<uint64_t, int> sps_id_by_payload_hash_;
+  std::map<uint64_t, int> pps_id_by_payload_hash_;
+
   DISALLOW_COPY_AND_ASSIGN(H265Parser);
 };
 
@@ -4,8 +4,11 @@
 
 #include <packager/media/codecs/h26x_bit_reader.h>
 
+#include <cstring>
+
 #include <absl/log/check.h>
 #include <absl/log/log.h>
+#include <absl/numeric/bits.h>
 
 namespace shaka {
 namespace media {
@@ -16,17 +19,46 @@ bool CheckAnyBitsSet(int byte, int valid_bits) {
   return (byte & ((1 << valid_bits) - 1)) != 0;
 }
 
+// Finds the next emulation prevention byte (the 0x03 of a 00 00 03 sequence)
+// in [data, data + size), or NULL if there is none. memchr compiles to a
+// vectorized scan on the toolchains we care about, so the common no-escape
+// case is proven at close to memory bandwidth.
+const uint8_t* FindEmulationPreventionByte(const uint8_t* data, size_t size) {
+  const uint8_t* const end = data + size;
+  const uint8_t* search = data;
+  while (search + 3 <= end) {
+    const uint8_t* candidate = static_cast<const uint8_t*>(
+        memchr(search + 2, 0x03, end - search - 2));
+    if (!candidate)
+      return NULL;
+    if (candidate[-1] == 0x00 && candidate[-2] == 0x00)
+      return candidate;
+    search = candidate - 1;
+  }
+  return NULL;
+}
+
+// Thread-local home for the RBSP scratch buffer while no reader is using it.
+// The parsers construct a reader per NALU, so keeping the capacity here
+// avoids an allocation per escaped NALU.
+std::vector<uint8_t>& ScratchBufferPool() {
+  thread_local std::vector<uint8_t> pool;
+  return pool;
+}
+
 }  // namespace
 
 H26xBitReader::H26xBitReader()
     : data_(NULL),
       bytes_left_(0),
+      total_bytes_(0),
       curr_byte_(0),
-      num_remaining_bits_in_curr_byte_(0),
-      prev_two_bytes_(0),
-      emulation_prevention_bytes_(0) {}
+      num_remaining_bits_in_curr_byte_(0) {}
 
-H26xBitReader::~H26xBitReader() {}
+H26xBitReader::~H26xBitReader() {
+  if (rbsp_buffer_.capacity() > ScratchBufferPool().capacity())
+    ScratchBufferPool().swap(rbsp_buffer_);
+}
 
 bool H26xBitReader::Initialize(const uint8_t* data, off_t size) {
   DCHECK(data);
@@ -34,13 +66,41 @@ bool H26xBitReader::Initialize(const uint8_t* data, off_t size) {
   if (size < 1)
     return false;
 
-  data_ = data;
-  bytes_left_ = size;
   num_remaining_bits_in_curr_byte_ = 0;
-  // Initially set to 0xffff to accept all initial two-byte sequences.
-  prev_two_bytes_ = 0xffff;
-  emulation_prevention_bytes_ = 0;
+  epb_offsets_.clear();
+
+  // If the NALU contains no emulation prevention bytes, read straight from
+  // the caller's buffer. Otherwise strip the escapes once up front so the
+  // per-bit hot path never has to look for them.
+  const uint8_t* epb = FindEmulationPreventionByte(data, size);
+  if (!epb) {
+    data_ = data;
+    bytes_left_ = size;
+    total_bytes_ = size;
+    return true;
+  }
+
+  if (rbsp_buffer_.capacity() == 0)
+    rbsp_buffer_.swap(ScratchBufferPool());
+  rbsp_buffer_.clear();
+  rbsp_buffer_.reserve(size);
+
+  const uint8_t* const end = data + size;
+  while (epb) {
+    // Copy everything up to, but not including, the 0x03.
+    rbsp_buffer_.insert(rbsp_buffer_.end(), data, epb);
+    epb_offsets_.push_back(rbsp_buffer_.size());
+    data = epb + 1;
+    // Note that the scan restarts after the escape: a new 00 00 03 sequence
+    // needs three fresh bytes, matching the spec (and the previous
+    // byte-at-a-time implementation).
+    epb = FindEmulationPreventionByte(data, end - data);
+  }
+  rbsp_buffer_.insert(rbsp_buffer_.end(), data, end);
 
+  data_ = rbsp_buffer_.data();
+  bytes_left_ = rbsp_buffer_.size();
+  total_bytes_ = bytes_left_;
   return true;
 }
 
@@ -48,27 +108,12 @@ bool H26xBitReader::UpdateCurrByte() {
   if (bytes_left_ < 1)
     return false;
 
-  // Emulation prevention three-byte detection.
-  // If a sequence of 0x000003 is found, skip (ignore) the last byte (0x03).
-  if (*data_ == 0x03 && (prev_two_bytes_ & 0xffff) == 0) {
-    // Detected 0x000003, skip last byte.
-    ++data_;
-    --bytes_left_;
-    ++emulation_prevention_bytes_;
-    // Need another full three bytes before we can detect the sequence again.
-    prev_two_bytes_ = 0xffff;
-
-    if (bytes_left_ < 1)
-      return false;
-  }
-
-  // Load a new byte and advance pointers.
+  // Load a new byte and advance pointers. Emulation prevention bytes were
+  // already stripped in Initialize().
   curr_byte_ = *data_++ & 0xff;
   --bytes_left_;
   num_remaining_bits_in_curr_byte_ = 8;
 
-  prev_two_bytes_ = (prev_two_bytes_ << 8) | curr_byte_;
-
   return true;
 }
 
@@ -109,30 +154,40 @@ bool H26xBitReader::SkipBits(int num_bits) {
 }
 
 bool H26xBitReader::ReadUE(int* val) {
-  int num_bits = -1;
-  int bit;
-  int rest;
-
-  // Count the number of contiguous zero bits.
-  do {
-    if (!ReadBits(1, &bit))
-      return false;
-    num_bits++;
-  } while (bit == 0);
-
-  if (num_bits > 31)
+  // Slice headers read dozens of exp-Golomb values, so instead of counting
+  // leading zeros bit by bit, assemble a 64-bit window of upcoming bits and
+  // let a count-leading-zeros instruction find the whole symbol at once. The
+  // longest valid code (31 zeros, marker bit, 31 value bits) fits in the
+  // window. Emulation prevention bytes were already stripped in Initialize().
+  uint64_t window = 0;
+  int window_bits = 0;
+  if (num_remaining_bits_in_curr_byte_ > 0) {
+    window = curr_byte_ & ((1 << num_remaining_bits_in_curr_byte_) - 1);
+    window_bits = num_remaining_bits_in_curr_byte_;
+  }
+  const uint8_t* next_byte = data_;
+  off_t next_bytes_left = bytes_left_;
+  while (window_bits <= 56 && next_bytes_left > 0) {
+    window = (window << 8) | *next_byte++;
+    window_bits += 8;
+    next_bytes_left--;
+  }
+  if (window_bits == 0)
     return false;
 
-  // Calculate exp-Golomb code value of size num_bits.
-  *val = (1 << num_bits) - 1;
-
-  if (num_bits > 0) {
-    if (!ReadBits(num_bits, &rest))
-      return false;
-    *val += rest;
-  }
+  const uint64_t aligned = window << (64 - window_bits);
+  const int num_zero_bits = absl::countl_zero(aligned);
+  const int total_bits = 2 * num_zero_bits + 1;
+  // Also catches a run of zeros that continues past the available bits: the
+  // window is zero padded, so the apparent run is then longer than the data.
+  if (num_zero_bits > 31 || total_bits > window_bits)
+    return false;
 
-  return true;
+  // The zero prefix, the marker bit and the value bits together read as
+  // value + 1 (chapter 9.1 of the spec).
+  const uint64_t code = aligned >> (64 - total_bits);
+  *val = static_cast<int>(code - 1);
+  return SkipBits(total_bits);
 }
 
 bool H26xBitReader::ReadSE(int* val) {
@@ -181,7 +236,16 @@ bool H26xBitReader::HasMoreRBSPData() {
 }
 
 size_t H26xBitReader::NumEmulationPreventionBytesRead() {
-  return emulation_prevention_bytes_;
+  // An emulation prevention byte counts as read once the byte that followed
+  // it has been loaded, same as when the escapes were stripped inline.
+  const off_t bytes_loaded = total_bytes_ - bytes_left_;
+  size_t count = 0;
+  for (size_t offset : epb_offsets_) {
+    if (static_cast<off_t>(offset) >= bytes_loaded)
+      break;
+    ++count;
+  }
+  return count;
 }
 
 }  // namespace media
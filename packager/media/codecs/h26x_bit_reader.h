@@ -10,6 +10,7 @@
 #include <sys/types.h>
 
 #include <cstdint>
+#include <vector>
 
 #include <packager/macros/classes.h>
 
@@ -73,12 +74,17 @@ class H26xBitReader {
   // Return false on end of stream.
   bool UpdateCurrByte();
 
-  // Pointer to the next unread (not in curr_byte_) byte in the stream.
+  // Pointer to the next unread (not in curr_byte_) byte in the stream. This
+  // points into the caller's buffer, or into |rbsp_buffer_| when the NALU
+  // contained emulation prevention bytes.
   const uint8_t* data_;
 
   // Bytes left in the stream (without the curr_byte_).
   off_t bytes_left_;
 
+  // Total bytes available after Initialize(), post stripping.
+  off_t total_bytes_;
+
   // Contents of the current byte; first unread bit starting at position
   // 8 - num_remaining_bits_in_curr_byte_ from MSB.
   int curr_byte_;
@@ -86,12 +92,15 @@ class H26xBitReader {
   // Number of bits remaining in curr_byte_
   int num_remaining_bits_in_curr_byte_;
 
-  // Used in emulation prevention three byte detection (see spec).
-  // Initially set to 0xffff to accept all initial two-byte sequences.
-  int prev_two_bytes_;
+  // For each emulation prevention byte (0x000003) stripped by Initialize(),
+  // the stripped-buffer offset of the byte that followed it, in increasing
+  // order. Used to report NumEmulationPreventionBytesRead().
+  std::vector<size_t> epb_offsets_;
 
-  // Number of emulation preventation bytes (0x000003) we met.
-  size_t emulation_prevention_bytes_;
+  // Holds the stripped RBSP when the NALU contains emulation prevention
+  // bytes. Backed by a thread-local pool so the per-NALU readers the parsers
+  // create do not allocate each time.
+  std::vector<uint8_t> rbsp_buffer_;
 
   DISALLOW_COPY_AND_ASSIGN(H26xBitReader);
 };
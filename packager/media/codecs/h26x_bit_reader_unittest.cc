@@ -117,6 +117,66 @@ TEST(H26xBitReaderTest, SkipBits) {
   EXPECT_EQ(4, reader.NumBitsLeft());
 }
 
+TEST(H26xBitReaderTest, ReadUE) {
+  H26xBitReader reader;
+  // ue(v) codes for 0, 1, 2, 8 and 127, in order:
+  // 1 | 010 | 011 | 0001001 | 00000001000 0000, packed to bytes.
+  const unsigned char rbsp[] = {0xa6, 0x24, 0x04, 0x00};
+  int value = -1;
+
+  EXPECT_TRUE(reader.Initialize(rbsp, sizeof(rbsp)));
+  EXPECT_TRUE(reader.ReadUE(&value));
+  EXPECT_EQ(0, value);
+  EXPECT_TRUE(reader.ReadUE(&value));
+  EXPECT_EQ(1, value);
+  EXPECT_TRUE(reader.ReadUE(&value));
+  EXPECT_EQ(2, value);
+  EXPECT_TRUE(reader.ReadUE(&value));
+  EXPECT_EQ(8, value);
+  EXPECT_TRUE(reader.ReadUE(&value));
+  EXPECT_EQ(127, value);
+  EXPECT_EQ(3, reader.NumBitsLeft());
+  // Only zero bits remain, which cannot hold another code.
+  EXPECT_FALSE(reader.ReadUE(&value));
+}
+
+TEST(H26xBitReaderTest, ReadUELongCodeAcrossBytes) {
+  H26xBitReader reader;
+  // A 16-zero prefix straddling byte boundaries: 3 one-bit codes for 0, then
+  // 0000 0000 0000 0000 1 | 1010 0101 1010 0101 (value 0x1a5a5 - 1), then a
+  // stop bit and padding.
+  const unsigned char rbsp[] = {0xe0, 0x00, 0x1a, 0x5a, 0x58, 0x00};
+  int value = -1;
+
+  EXPECT_TRUE(reader.Initialize(rbsp, sizeof(rbsp)));
+  for (int i = 0; i < 3; i++) {
+    EXPECT_TRUE(reader.ReadUE(&value));
+    EXPECT_EQ(0, value);
+  }
+  EXPECT_TRUE(reader.ReadUE(&value));
+  EXPECT_EQ(0x1a5a5 - 1, value);
+}
+
+TEST(H26xBitReaderTest, ReadSE) {
+  H26xBitReader reader;
+  // se(v) codes for 0, 1, -1, 2, -2: 1 | 010 | 011 | 00100 | 00101, then
+  // padding.
+  const unsigned char rbsp[] = {0xa6, 0x42, 0x80};
+  int value = 99;
+
+  EXPECT_TRUE(reader.Initialize(rbsp, sizeof(rbsp)));
+  EXPECT_TRUE(reader.ReadSE(&value));
+  EXPECT_EQ(0, value);
+  EXPECT_TRUE(reader.ReadSE(&value));
+  EXPECT_EQ(1, value);
+  EXPECT_TRUE(reader.ReadSE(&value));
+  EXPECT_EQ(-1, value);
+  EXPECT_TRUE(reader.ReadSE(&value));
+  EXPECT_EQ(2, value);
+  EXPECT_TRUE(reader.ReadSE(&value));
+  EXPECT_EQ(-2, value);
+}
+
 TEST(H26xBitReaderTest, StopBitOccupyFullByte) {
   H26xBitReader reader;
   const unsigned char rbsp[] = {0xab, 0x80};
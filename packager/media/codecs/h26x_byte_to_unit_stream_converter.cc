@@ -84,6 +84,68 @@ bool H26xByteToUnitStreamConverter::ConvertByteStreamToNalUnitStream(
   return true;
 }
 
+bool H26xByteToUnitStreamConverter::ConvertByteStreamToNalUnitStreamInPlace(
+    uint8_t* frame,
+    size_t frame_size) {
+  DCHECK(frame);
+
+  Nalu nalu;
+  NaluReader reader(type_, kIsAnnexbByteStream, frame, frame_size);
+  if (!reader.StartsWithStartCode()) {
+    LOG(ERROR) << "H.26x byte stream frame did not begin with start code.";
+    return false;
+  }
+
+  // Offsets (relative to |frame|) of the NAL units whose preceding start code
+  // is to be overwritten with a length field, recorded together with the unit
+  // sizes. The frame must stay untouched until the whole frame is known to
+  // qualify, so that the caller can still run the copying conversion on
+  // fallback; ProcessNalu() is idempotent, so the fallback re-processing the
+  // same parameter sets is harmless.
+  struct LengthPatch {
+    size_t nalu_offset;
+    uint32_t nalu_size;
+  };
+  std::vector<LengthPatch> patches;
+
+  const uint8_t* expected_nalu_start = frame + kUnitStreamNaluLengthSize;
+  while (reader.Advance(&nalu) == NaluReader::kOk) {
+    const uint64_t nalu_size = nalu.payload_size() + nalu.header_size();
+    DCHECK_LE(nalu_size, std::numeric_limits<uint32_t>::max());
+
+    // Only a 4-byte start code with no extra padding in front occupies
+    // exactly the bytes a length field needs.
+    if (nalu.data() != expected_nalu_start)
+      return false;
+
+    if (ProcessNalu(nalu)) {
+      // Stripping a unit changes the frame size; cannot be done in place.
+      return false;
+    }
+
+    patches.push_back({static_cast<size_t>(nalu.data() - frame),
+                       static_cast<uint32_t>(nalu_size)});
+    expected_nalu_start = nalu.data() + nalu_size + kUnitStreamNaluLengthSize;
+  }
+
+  // The last NAL unit must extend to the end of the frame; otherwise the
+  // reader stopped early on an invalid stream and the copying path's error
+  // handling should take over.
+  if (patches.empty() ||
+      expected_nalu_start - kUnitStreamNaluLengthSize != frame + frame_size) {
+    return false;
+  }
+
+  for (const LengthPatch& patch : patches) {
+    uint8_t* length_pos = frame + patch.nalu_offset - kUnitStreamNaluLengthSize;
+    length_pos[0] = static_cast<uint8_t>(patch.nalu_size >> 24);
+    length_pos[1] = static_cast<uint8_t>(patch.nalu_size >> 16);
+    length_pos[2] = static_cast<uint8_t>(patch.nalu_size >> 8);
+    length_pos[3] = static_cast<uint8_t>(patch.nalu_size);
+  }
+  return true;
+}
+
 void H26xByteToUnitStreamConverter::WarnIfNotMatch(
     int nalu_type,
     const uint8_t* nalu_ptr,
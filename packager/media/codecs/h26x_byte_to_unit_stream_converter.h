@@ -47,6 +47,24 @@ class H26xByteToUnitStreamConverter {
                                         size_t input_frame_size,
                                         std::vector<uint8_t>* output_frame);
 
+  /// Zero-copy variant of the above for the common case where every NAL
+  /// unit in the frame is preceded by exactly four bytes of start code:
+  /// since a 4-byte start code and the 4-byte length field are the same
+  /// size, each start code is overwritten with the unit's length directly
+  /// in @a frame and no output buffer is needed. The frame is left
+  /// untouched and false is returned when it does not qualify — a 3-byte
+  /// start code, extra zero padding between units, or a unit that must be
+  /// stripped — in which case the caller should fall back to
+  /// ConvertByteStreamToNalUnitStream(). Parameter set state used for
+  /// GetDecoderConfigurationRecord() is updated on both outcomes.
+  /// @param frame is a buffer containing a whole H.26x frame in byte stream
+  ///        format; it is converted to NAL unit stream format in place on
+  ///        success.
+  /// @param frame_size is the size of the H.26x frame, in bytes.
+  /// @return true if the frame was converted in place, false otherwise.
+  bool ConvertByteStreamToNalUnitStreamInPlace(uint8_t* frame,
+                                               size_t frame_size);
+
   /// Creates either an AVCDecoderConfigurationRecord or a
   /// HEVCDecoderConfigurationRecord from the units extracted from the byte
   /// stream.
@@ -15,6 +15,7 @@
 #include <packager/media/base/bit_reader.h>
 #include <packager/media/base/buffer_reader.h>
 #include <packager/media/base/buffer_writer.h>
+#include <packager/media/base/media_sample.h>
 #include <packager/media/codecs/nalu_reader.h>
 
 namespace shaka {
@@ -268,6 +269,61 @@ bool NalUnitToByteStreamConverter::ConvertUnitToByteStream(
       nullptr);  // Skip subsample update.
 }
 
+bool NalUnitToByteStreamConverter::ConvertUnitToByteStreamFast(
+    const uint8_t* sample,
+    size_t sample_size,
+    bool is_key_frame,
+    std::vector<uint8_t>* output) {
+  DCHECK_EQ(nalu_length_size_, static_cast<int>(std::size(kNaluStartCode)));
+
+  // Prescan the access unit. Any NAL unit that the general path would drop
+  // (AUD) or compare against the decoder configuration (SPS, SPS extension,
+  // PPS), and anything malformed, defers to the general path.
+  nalu_offsets_.clear();
+  size_t pos = 0;
+  while (pos < sample_size) {
+    if (pos + std::size(kNaluStartCode) > sample_size)
+      return false;
+    const uint32_t nalu_length = (sample[pos] << 24) | (sample[pos + 1] << 16) |
+                                 (sample[pos + 2] << 8) | sample[pos + 3];
+    const size_t header_pos = pos + std::size(kNaluStartCode);
+    if (nalu_length == 0 || nalu_length > sample_size - header_pos)
+      return false;
+    // forbidden_zero_bit must be 0.
+    if (sample[header_pos] & 0x80)
+      return false;
+    const int nalu_type = sample[header_pos] & 0x1F;
+    if (nalu_type == Nalu::H264_AUD || nalu_type == Nalu::H264_SPS ||
+        nalu_type == Nalu::H264_SPSExtension || nalu_type == Nalu::H264_PPS) {
+      return false;
+    }
+    nalu_offsets_.push_back(pos);
+    pos = header_pos + nalu_length;
+  }
+
+  output->clear();
+  output->reserve(std::size(kNaluStartCode) + 2 +
+                  decoder_configuration_in_byte_stream_.size() + sample_size);
+  output->insert(output->end(), kNaluStartCode,
+                 kNaluStartCode + std::size(kNaluStartCode));
+  output->push_back(static_cast<uint8_t>(Nalu::H264_AUD));
+  output->push_back(kAccessUnitDelimiterRbspAnyPrimaryPicType);
+  if (is_key_frame) {
+    output->insert(output->end(), decoder_configuration_in_byte_stream_.begin(),
+                   decoder_configuration_in_byte_stream_.end());
+  }
+
+  // Copy the whole access unit once, then turn each length field into a start
+  // code in place.
+  const size_t sample_start = output->size();
+  output->insert(output->end(), sample, sample + sample_size);
+  for (const size_t nalu_offset : nalu_offsets_) {
+    memcpy(output->data() + sample_start + nalu_offset, kNaluStartCode,
+           std::size(kNaluStartCode));
+  }
+  return true;
+}
+
 // This ignores all AUD, SPS, and PPS in the sample. Instead uses the data
 // parsed in Initialize(). However, if the SPS and PPS are different to
 // those parsed in Initialized(), they are kept.
@@ -278,11 +334,48 @@ bool NalUnitToByteStreamConverter::ConvertUnitToByteStreamWithSubsamples(
     bool escape_encrypted_nalu,
     std::vector<uint8_t>* output,
     std::vector<SubsampleEntry>* subsamples) {
+  return ConvertUnitToByteStreamWithSubsamplesInternal(
+      sample, sample_size, is_key_frame, escape_encrypted_nalu,
+      /* nalu_extents= */ nullptr, output, subsamples);
+}
+
+bool NalUnitToByteStreamConverter::ConvertUnitToByteStreamWithSubsamples(
+    const MediaSample& sample,
+    bool escape_encrypted_nalu,
+    std::vector<uint8_t>* output,
+    std::vector<SubsampleEntry>* subsamples) {
+  if (sample.nalu_extents().empty()) {
+    // Goes through the virtual method so tests can intercept the conversion.
+    return ConvertUnitToByteStreamWithSubsamples(
+        sample.data(), sample.data_size(), sample.is_key_frame(),
+        escape_encrypted_nalu, output, subsamples);
+  }
+  return ConvertUnitToByteStreamWithSubsamplesInternal(
+      sample.data(), sample.data_size(), sample.is_key_frame(),
+      escape_encrypted_nalu, &sample.nalu_extents(), output, subsamples);
+}
+
+bool NalUnitToByteStreamConverter::ConvertUnitToByteStreamWithSubsamplesInternal(
+    const uint8_t* sample,
+    size_t sample_size,
+    bool is_key_frame,
+    bool escape_encrypted_nalu,
+    const std::vector<NaluExtent>* nalu_extents,
+    std::vector<uint8_t>* output,
+    std::vector<SubsampleEntry>* subsamples) {
   if (!sample || sample_size == 0) {
     LOG(WARNING) << "Sample is empty.";
     return true;
   }
 
+  // Without subsample bookkeeping there is nothing to escape, and with 4-byte
+  // length fields the access unit can usually be emitted with a single copy.
+  if ((!subsamples || subsamples->empty()) &&
+      nalu_length_size_ == static_cast<int>(std::size(kNaluStartCode)) &&
+      ConvertUnitToByteStreamFast(sample, sample_size, is_key_frame, output)) {
+    return true;
+  }
+
   std::vector<SubsampleEntry> temp_subsamples;
 
   BufferWriter buffer_writer(sample_size);
@@ -298,7 +391,8 @@ bool NalUnitToByteStreamConverter::ConvertUnitToByteStreamWithSubsamples(
                      &temp_subsamples);
   }
 
-  NaluReader nalu_reader(Nalu::kH264, nalu_length_size_, sample, sample_size);
+  FrameNaluIterator nalu_reader(Nalu::kH264, nalu_length_size_, sample,
+                                sample_size, nalu_extents);
   Nalu nalu;
   NaluReader::Result result = nalu_reader.Advance(&nalu);
 
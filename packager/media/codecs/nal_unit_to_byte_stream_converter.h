@@ -18,7 +18,9 @@ namespace shaka {
 namespace media {
 
 class BufferWriter;
+class MediaSample;
 class VideoStreamInfo;
+struct NaluExtent;
 
 /// Inserts emulation prevention byte (0x03) where necessary.
 /// It is safe to call this again on the output, i.e. it is OK to "re-escape".
@@ -80,12 +82,53 @@ class NalUnitToByteStreamConverter {
       std::vector<uint8_t>* output,
       std::vector<SubsampleEntry>* subsamples);
 
+  /// Same as above, but when @a sample carries a NALU extent table attached
+  /// by the demuxer or first parser, the NAL units are materialized from the
+  /// table instead of rescanning the frame.
+  /// @param sample is the sample to be converted.
+  /// @param escape_encrypted_nalu indicates whether an encrypted nalu should
+  ///        be escaped; see above.
+  /// @param[out] output is set to the the converted sample, on success.
+  /// @param[in,out] subsamples has the input subsamples and output updated
+  ///                subsamples, on success.
+  /// @return true on success, false otherwise.
+  bool ConvertUnitToByteStreamWithSubsamples(
+      const MediaSample& sample,
+      bool escape_encrypted_nalu,
+      std::vector<uint8_t>* output,
+      std::vector<SubsampleEntry>* subsamples);
+
  private:
   friend class NalUnitToByteStreamConverterTest;
 
+  // Shared implementation of the conversions above; iterates the NAL units
+  // from @a nalu_extents when non-null, otherwise scans @a sample.
+  bool ConvertUnitToByteStreamWithSubsamplesInternal(
+      const uint8_t* sample,
+      size_t sample_size,
+      bool is_key_frame,
+      bool escape_encrypted_nalu,
+      const std::vector<NaluExtent>* nalu_extents,
+      std::vector<uint8_t>* output,
+      std::vector<SubsampleEntry>* subsamples);
+
+  // Fast path for the common case: 4-byte NAL unit length fields (the same
+  // size as a start code) and no subsample bookkeeping. The access unit is
+  // prescanned; if every NAL unit passes through unmodified, the sample is
+  // copied in one pass and the length fields are overwritten with start codes
+  // in place. Returns false, without touching @a output, if the access unit
+  // needs the general conversion path (e.g. it carries AUD or parameter set
+  // NAL units, or is malformed).
+  bool ConvertUnitToByteStreamFast(const uint8_t* sample,
+                                   size_t sample_size,
+                                   bool is_key_frame,
+                                   std::vector<uint8_t>* output);
+
   int nalu_length_size_;
   AVCDecoderConfigurationRecord decoder_config_;
   std::vector<uint8_t> decoder_configuration_in_byte_stream_;
+  // Scratch list of NAL unit offsets reused across fast path conversions.
+  std::vector<size_t> nalu_offsets_;
 
   DISALLOW_COPY_AND_ASSIGN(NalUnitToByteStreamConverter);
 };
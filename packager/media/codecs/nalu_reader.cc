@@ -10,11 +10,24 @@
 
 #include <absl/log/check.h>
 #include <absl/log/log.h>
+#include <absl/numeric/bits.h>
 
 #include <packager/macros/logging.h>
 #include <packager/media/base/buffer_reader.h>
 #include <packager/media/codecs/h264_parser.h>
 
+// Vectorized zero-byte scanning for the Annex-B start code search. SSE2 is
+// part of the x86-64 baseline and NEON is part of the AArch64 baseline, so no
+// runtime CPU dispatch is needed on either.
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PACKAGER_HAS_ZERO_BYTE_SCAN 1
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+#include <arm_neon.h>
+#define PACKAGER_HAS_ZERO_BYTE_SCAN 1
+#endif
+
 namespace shaka {
 namespace media {
 
@@ -23,6 +36,40 @@ inline bool IsStartCode(const uint8_t* data) {
   return data[0] == 0x00 && data[1] == 0x00 && data[2] == 0x01;
 }
 
+#if defined(PACKAGER_HAS_ZERO_BYTE_SCAN)
+
+const uint64_t kZeroScanBlockSize = 16;
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+
+// One mask bit per input byte, set if the byte is zero.
+const int kZeroScanMaskBitsPerByte = 1;
+
+inline uint64_t ZeroByteMask(const uint8_t* data) {
+  const __m128i block =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+  return static_cast<uint64_t>(
+      _mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_setzero_si128())));
+}
+
+#else  // NEON
+
+// NEON has no movemask; narrowing the comparison result yields four
+// (identical) mask bits per input byte instead.
+const int kZeroScanMaskBitsPerByte = 4;
+
+inline uint64_t ZeroByteMask(const uint8_t* data) {
+  const uint8x16_t equal_zero = vceqq_u8(vld1q_u8(data), vdupq_n_u8(0));
+  const uint8x8_t narrowed =
+      vshrn_n_u16(vreinterpretq_u16_u8(equal_zero), 4);
+  return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+}
+
+#endif
+
+#endif  // defined(PACKAGER_HAS_ZERO_BYTE_SCAN)
+
 // Edits |subsamples| given the number of consumed bytes.
 void UpdateSubsamples(uint64_t consumed_bytes,
                       std::vector<SubsampleEntry>* subsamples) {
@@ -318,6 +365,34 @@ bool NaluReader::FindStartCode(const uint8_t* data,
                                uint8_t* start_code_size) {
   uint64_t bytes_left = data_size;
 
+#if defined(PACKAGER_HAS_ZERO_BYTE_SCAN)
+  // A start code must begin with a zero byte, so blocks containing no zero
+  // byte can be skipped a whole vector register at a time. The "+ 2" keeps
+  // the scalar look-ahead of the last in-block candidate within bounds.
+  while (bytes_left >= kZeroScanBlockSize + 2) {
+    uint64_t zero_mask = ZeroByteMask(data);
+    while (zero_mask != 0) {
+      const int index =
+          absl::countr_zero(zero_mask) / kZeroScanMaskBitsPerByte;
+      zero_mask &= ~(((uint64_t{1} << kZeroScanMaskBitsPerByte) - 1)
+                     << (index * kZeroScanMaskBitsPerByte));
+      if (data[index + 1] == 0x00 && data[index + 2] == 0x01) {
+        *offset = data_size - bytes_left + index;
+        *start_code_size = 3;
+        // If there is a zero byte before this start code, then it's actually
+        // a four-byte start code, so backtrack one byte.
+        if (*offset > 0 && data[index - 1] == 0x00) {
+          --(*offset);
+          ++(*start_code_size);
+        }
+        return true;
+      }
+    }
+    data += kZeroScanBlockSize;
+    bytes_left -= kZeroScanBlockSize;
+  }
+#endif  // defined(PACKAGER_HAS_ZERO_BYTE_SCAN)
+
   while (bytes_left >= 3) {
     if (IsStartCode(data)) {
       // Found three-byte start code, set pointer at its beginning.
@@ -473,5 +548,62 @@ bool NaluReader::LocateNaluByStartCode(uint64_t* nalu_size,
   return true;
 }
 
+FrameNaluIterator::FrameNaluIterator(Nalu::CodecType type,
+                                     uint8_t nalu_length_size,
+                                     const uint8_t* stream,
+                                     uint64_t stream_size,
+                                     const std::vector<NaluExtent>* extents)
+    : nalu_type_(type),
+      stream_(stream),
+      stream_size_(stream_size),
+      extents_(extents && !extents->empty() ? extents : nullptr) {
+  if (!extents_) {
+    reader_.reset(
+        new NaluReader(type, nalu_length_size, stream, stream_size));
+  }
+}
+
+NaluReader::Result FrameNaluIterator::Advance(Nalu* nalu) {
+  if (reader_)
+    return reader_->Advance(nalu);
+  if (next_extent_ == extents_->size())
+    return NaluReader::kEOStream;
+  const NaluExtent& extent = (*extents_)[next_extent_++];
+  if (extent.size == 0 ||
+      static_cast<uint64_t>(extent.offset) + extent.size > stream_size_) {
+    LOG(ERROR) << "NALU extent [" << extent.offset << ", "
+               << extent.offset + extent.size
+               << ") is out of range of the frame of size " << stream_size_;
+    return NaluReader::kInvalidStream;
+  }
+  if (!nalu->Initialize(nalu_type_, stream_ + extent.offset, extent.size))
+    return NaluReader::kInvalidStream;
+  return NaluReader::kOk;
+}
+
+bool ParseNaluExtents(Nalu::CodecType type,
+                      uint8_t nalu_length_size,
+                      const uint8_t* stream,
+                      uint64_t stream_size,
+                      std::vector<NaluExtent>* extents) {
+  extents->clear();
+  NaluReader reader(type, nalu_length_size, stream, stream_size);
+  Nalu nalu;
+  NaluReader::Result result;
+  while ((result = reader.Advance(&nalu)) == NaluReader::kOk) {
+    NaluExtent extent;
+    extent.offset = static_cast<uint32_t>(nalu.data() - stream);
+    extent.size =
+        static_cast<uint32_t>(nalu.header_size() + nalu.payload_size());
+    extent.type = static_cast<uint8_t>(nalu.type());
+    extents->push_back(extent);
+  }
+  if (result != NaluReader::kEOStream) {
+    extents->clear();
+    return false;
+  }
+  return true;
+}
+
 }  // namespace media
 }  // namespace shaka
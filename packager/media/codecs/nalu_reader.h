@@ -9,9 +9,12 @@
 
 #include <cstdint>
 #include <cstdlib>
+#include <memory>
+#include <vector>
 
 #include <packager/macros/classes.h>
 #include <packager/media/base/decrypt_config.h>
+#include <packager/media/base/media_sample.h>
 
 namespace shaka {
 namespace media {
@@ -250,6 +253,60 @@ class NaluReader {
   DISALLOW_COPY_AND_ASSIGN(NaluReader);
 };
 
+/// Iterates over the NAL units of one frame. When a NALU extent table was
+/// attached to the frame at demux time, the units are materialized straight
+/// from the table; otherwise the frame is scanned with NaluReader. Consumers
+/// that walk a frame's units should use this instead of NaluReader directly,
+/// so the frame is parsed once per pipeline.
+class FrameNaluIterator {
+ public:
+  /// @param type is the codec type of the NAL units.
+  /// @param nalu_length_size should be set to 0 for AnnexB byte streams;
+  ///        otherwise, it indicates the size of NAL unit length for the NAL
+  ///        unit stream. Only used when scanning.
+  /// @param stream is the frame data.
+  /// @param stream_size is the size of @a stream.
+  /// @param extents is the extent table attached to the frame, or nullptr
+  ///        (or empty) to scan @a stream instead.
+  FrameNaluIterator(Nalu::CodecType type,
+                    uint8_t nalu_length_size,
+                    const uint8_t* stream,
+                    uint64_t stream_size,
+                    const std::vector<NaluExtent>* extents);
+
+  /// See NaluReader::Advance.
+  NaluReader::Result Advance(Nalu* nalu);
+
+ private:
+  const Nalu::CodecType nalu_type_;
+  const uint8_t* const stream_;
+  const uint64_t stream_size_;
+  // Non-null when iterating from the extent table.
+  const std::vector<NaluExtent>* const extents_;
+  size_t next_extent_ = 0;
+  // Set when scanning the stream instead.
+  std::unique_ptr<NaluReader> reader_;
+
+  DISALLOW_COPY_AND_ASSIGN(FrameNaluIterator);
+};
+
+/// Walks the NAL units of a frame once and builds its extent table, to be
+/// attached to the MediaSample with MediaSample::set_nalu_extents.
+/// @param type is the codec type of the NAL units.
+/// @param nalu_length_size should be set to 0 for AnnexB byte streams;
+///        otherwise, it indicates the size of NAL unit length for the NAL
+///        unit stream.
+/// @param stream is the frame data.
+/// @param stream_size is the size of @a stream.
+/// @param[out] extents receives the extent table on success.
+/// @return true on success; false if the frame is not a valid NAL unit
+///         stream, in which case @a extents is left empty.
+bool ParseNaluExtents(Nalu::CodecType type,
+                      uint8_t nalu_length_size,
+                      const uint8_t* stream,
+                      uint64_t stream_size,
+                      std::vector<NaluExtent>* extents);
+
 }  // namespace media
 }  // namespace shaka
 
@@ -400,5 +400,72 @@ TEST(NaluReaderTest, EncryptedNaluLengthNaluStream) {
   ASSERT_EQ(NaluReader::kInvalidStream, reader.Advance(&nalu));
 }
 
+TEST(NaluReaderTest, ParseNaluExtents) {
+  const uint8_t kNaluData[] = {
+      // First NALU
+      0x00, 0x00, 0x00, 0x07, 0x06, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+      // Second NALU
+      0x00, 0x00, 0x00, 0x03, 0x67, 0x0a, 0x0b,
+  };
+
+  std::vector<NaluExtent> extents;
+  ASSERT_TRUE(
+      ParseNaluExtents(Nalu::kH264, 4, kNaluData, std::size(kNaluData),
+                       &extents));
+  ASSERT_EQ(2u, extents.size());
+  EXPECT_EQ(4u, extents[0].offset);
+  EXPECT_EQ(7u, extents[0].size);
+  EXPECT_EQ(6, extents[0].type);
+  EXPECT_EQ(15u, extents[1].offset);
+  EXPECT_EQ(3u, extents[1].size);
+  EXPECT_EQ(7, extents[1].type);
+
+  // A truncated frame is not annotated.
+  ASSERT_FALSE(ParseNaluExtents(Nalu::kH264, 4, kNaluData,
+                                std::size(kNaluData) - 1, &extents));
+  EXPECT_TRUE(extents.empty());
+}
+
+TEST(NaluReaderTest, FrameNaluIteratorMatchesScanning) {
+  const uint8_t kNaluData[] = {
+      // First NALU
+      0x00, 0x00, 0x00, 0x07, 0x06, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+      // Second NALU
+      0x00, 0x00, 0x00, 0x03, 0x67, 0x0a, 0x0b,
+  };
+
+  std::vector<NaluExtent> extents;
+  ASSERT_TRUE(
+      ParseNaluExtents(Nalu::kH264, 4, kNaluData, std::size(kNaluData),
+                       &extents));
+
+  FrameNaluIterator from_extents(Nalu::kH264, 4, kNaluData,
+                                 std::size(kNaluData), &extents);
+  FrameNaluIterator from_scan(Nalu::kH264, 4, kNaluData, std::size(kNaluData),
+                              nullptr);
+  Nalu expected;
+  Nalu actual;
+  while (from_scan.Advance(&expected) == NaluReader::kOk) {
+    ASSERT_EQ(NaluReader::kOk, from_extents.Advance(&actual));
+    EXPECT_EQ(expected.data(), actual.data());
+    EXPECT_EQ(expected.header_size(), actual.header_size());
+    EXPECT_EQ(expected.payload_size(), actual.payload_size());
+    EXPECT_EQ(expected.type(), actual.type());
+  }
+  EXPECT_EQ(NaluReader::kEOStream, from_extents.Advance(&actual));
+}
+
+TEST(NaluReaderTest, FrameNaluIteratorRejectsOutOfRangeExtent) {
+  const uint8_t kNaluData[] = {
+      0x00, 0x00, 0x00, 0x03, 0x67, 0x0a, 0x0b,
+  };
+
+  std::vector<NaluExtent> extents = {{4, 10, 7}};
+  FrameNaluIterator iterator(Nalu::kH264, 4, kNaluData, std::size(kNaluData),
+                             &extents);
+  Nalu nalu;
+  EXPECT_EQ(NaluReader::kInvalidStream, iterator.Advance(&nalu));
+}
+
 }  // namespace media
 }  // namespace shaka
@@ -6,6 +6,8 @@
 
 #include <packager/media/codecs/vp9_parser.h>
 
+#include <cstring>
+
 #include <absl/log/check.h>
 #include <absl/log/log.h>
 
@@ -464,6 +466,30 @@ bool VP9Parser::Parse(const uint8_t* data,
 
   for (auto& vpx_frame : *vpx_frames) {
     VLOG(4) << "process frame with size " << vpx_frame.frame_size;
+
+    // Fast path: the uncompressed header parse is a deterministic function of
+    // the header bytes and the parser state left by the previous frame, so if
+    // this frame starts with exactly the same header bytes as the last parsed
+    // frame, the previous result can be reused without re-reading the header.
+    // The compressed header size check mirrors the checks at the end of the
+    // full parse below, which depend on the size of this frame.
+    if (!last_header_bytes_.empty() &&
+        vpx_frame.frame_size >= last_header_bytes_.size() &&
+        last_compressed_header_size_ * 8u <=
+            vpx_frame.frame_size * 8 - last_header_bits_read_ &&
+        memcmp(data, last_header_bytes_.data(), last_header_bytes_.size()) ==
+            0) {
+      vpx_frame.is_keyframe = last_header_info_.is_keyframe;
+      vpx_frame.uncompressed_header_size =
+          last_header_info_.uncompressed_header_size;
+      vpx_frame.width = last_header_info_.width;
+      vpx_frame.height = last_header_info_.height;
+      width_ = last_header_info_.width;
+      height_ = last_header_info_.height;
+      data += vpx_frame.frame_size;
+      continue;
+    }
+
     BitReader reader(data, vpx_frame.frame_size);
     uint8_t frame_marker;
     RCHECK(reader.ReadBits(2, &frame_marker));
@@ -567,6 +593,14 @@ bool VP9Parser::Parse(const uint8_t* data,
     RCHECK(header_size > 0);
     RCHECK(header_size * 8u <= reader.bits_available());
 
+    // Memoize this header so identical headers on subsequent frames can take
+    // the fast path above. show_existing_frame frames are not memoized; they
+    // skip the full parse already.
+    last_header_bytes_.assign(data, data + vpx_frame.uncompressed_header_size);
+    last_header_info_ = vpx_frame;
+    last_header_bits_read_ = reader.bit_position();
+    last_compressed_header_size_ = header_size;
+
     data += vpx_frame.frame_size;
   }
   return true;
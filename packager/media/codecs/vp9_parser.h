@@ -9,6 +9,7 @@
 
 #include <cstdint>
 #include <cstdlib>
+#include <vector>
 
 #include <packager/macros/classes.h>
 #include <packager/media/codecs/vpx_parser.h>
@@ -45,6 +46,16 @@ class VP9Parser : public VPxParser {
   uint32_t width_;
   uint32_t height_;
 
+  // Memoized result of the most recent full uncompressed header parse.
+  // Encoders rarely change loop-filter, quantization or segmentation setup
+  // between frames, so consecutive frames frequently carry byte-identical
+  // headers; when they do, the parse result can be reused without re-reading
+  // the header. |last_header_bytes_| is empty until a header has been parsed.
+  std::vector<uint8_t> last_header_bytes_;
+  VPxFrameInfo last_header_info_ = {};
+  size_t last_header_bits_read_ = 0;
+  uint16_t last_compressed_header_size_ = 0;
+
   DISALLOW_COPY_AND_ASSIGN(VP9Parser);
 };
 
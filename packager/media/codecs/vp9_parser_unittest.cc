@@ -82,6 +82,30 @@ TEST(VP9ParserTest, KeyframeChroma420) {
               ElementsAre(EqualVPxFrame(std::size(kData), 18u, true, 32u, 8u)));
 }
 
+TEST(VP9ParserTest, RepeatedHeaderUsesMemoizedParse) {
+  // Same data as KeyframeChroma420. Parsing it twice with the same parser
+  // makes the second parse hit the memoized-header fast path; the result must
+  // be identical to the full parse.
+  const uint8_t kData[] = {
+      0x82, 0x49, 0x83, 0x42, 0x00, 0x01, 0xf0, 0x00, 0x74, 0x04, 0x38, 0x24,
+      0x1c, 0x18, 0x34, 0x00, 0x00, 0x90, 0x3e, 0x9e, 0xe3, 0xe1, 0xdf, 0x9c,
+      0x6c, 0x00, 0x00, 0x41, 0x4d, 0xe4, 0x39, 0x94, 0xcd, 0x7b, 0x78, 0x30,
+      0x4e, 0xb5, 0xb1, 0x78, 0x40, 0x6f, 0xe5, 0x75, 0xa4, 0x28, 0x93, 0xf7,
+      0x97, 0x9f, 0x4f, 0xdf, 0xbf, 0xfc, 0xe2, 0x73, 0xfa, 0xef, 0xab, 0xcd,
+      0x2a, 0x93, 0xed, 0xfc, 0x17, 0x32, 0x8f, 0x40, 0x15, 0xfa, 0xd5, 0x3e,
+      0x35, 0x7a, 0x88, 0x69, 0xf7, 0x1f, 0x26, 0x8b,
+  };
+
+  VP9Parser parser;
+  std::vector<VPxFrameInfo> frames;
+  ASSERT_TRUE(parser.Parse(kData, std::size(kData), &frames));
+  ASSERT_TRUE(parser.Parse(kData, std::size(kData), &frames));
+  EXPECT_EQ("vp09.00.10.08.01.02.02.02.00",
+            parser.codec_config().GetCodecString(kCodecVP9));
+  EXPECT_THAT(frames,
+              ElementsAre(EqualVPxFrame(std::size(kData), 18u, true, 32u, 8u)));
+}
+
 TEST(VP9ParserTest, KeyframeProfile1Chroma422) {
   const uint8_t kData[] = {
       0xa2, 0x49, 0x83, 0x42, 0x08, 0x01, 0x3e, 0x00, 0xb2, 0x80, 0xc7, 0x04,
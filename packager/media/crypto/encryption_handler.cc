@@ -9,14 +9,21 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
 
 #include <absl/log/check.h>
+#include <absl/strings/str_format.h>
+#include <absl/synchronization/mutex.h>
 
+#include <packager/file/thread_pool.h>
 #include <packager/macros/logging.h>
 #include <packager/macros/status.h>
 #include <packager/media/base/aes_encryptor.h>
 #include <packager/media/base/audio_stream_info.h>
 #include <packager/media/base/common_pssh_generator.h>
+#include <packager/media/base/fourccs.h>
 #include <packager/media/base/key_source.h>
 #include <packager/media/base/media_sample.h>
 #include <packager/media/base/playready_pssh_generator.h>
@@ -33,6 +40,19 @@ namespace {
 // The encryption handler only supports a single output.
 const size_t kStreamIndex = 0;
 
+// Bound on queued encryption tasks per worker, so a slow downstream applies
+// back pressure to the dispatching thread instead of buffering samples
+// without limit.
+const size_t kEncryptTasksPerWorker = 4;
+
+// Frames whose protected bytes reach this size are split at subsample
+// boundaries and encrypted on the thread pool; smaller frames are not worth
+// the synchronization overhead.
+const size_t kParallelCryptThresholdBytes = 1024 * 1024;
+// Target protected bytes per shard and bound on shards per frame.
+const size_t kParallelCryptShardBytes = 512 * 1024;
+const size_t kMaxParallelCryptShards = 8;
+
 // The default KID, KEY and IV for key rotation are all 0s.
 // They are placeholders and are not really being used to encrypt data.
 const uint8_t kKeyRotationDefaultKeyId[] = {
@@ -123,6 +143,49 @@ void AddProtectionSystemIfNotExist(
   encryption_config->key_system_info.push_back(pssh_info);
 }
 
+// Generated PSSH boxes, memoized across streams and handlers. All renditions
+// of a channel share keys and encryption parameters, so the generation - for
+// PlayReady it builds and base64 encodes an XML header - runs once per DRM
+// system and key set instead of once per stream. Process-wide on purpose:
+// EncryptionHandlers are created per stream and would each start with a cold
+// cache of their own.
+struct PsshCache {
+  absl::Mutex mutex;
+  std::map<std::string, std::vector<ProtectionSystemSpecificInfo>> entries
+      ABSL_GUARDED_BY(mutex);
+};
+
+PsshCache& GetPsshCache() {
+  static PsshCache* const cache = new PsshCache;
+  return *cache;
+}
+
+// Everything the generated PSSH boxes depend on: the enabled protection
+// systems and their configuration from |encryption_params| plus the key
+// material. Binary fields are length-prefixed so adjacent fields cannot
+// alias.
+std::string PsshCacheKey(const EncryptionParams& encryption_params,
+                         const EncryptionKey& encryption_key) {
+  std::string cache_key = absl::StrFormat(
+      "%u:%u:%zu:%s:%d:%d:",
+      static_cast<uint32_t>(encryption_params.protection_systems),
+      encryption_params.protection_scheme,
+      encryption_params.playready_extra_header_data.size(),
+      encryption_params.playready_extra_header_data,
+      encryption_params.key_provider == KeyProvider::kRawKey,
+      encryption_params.raw_key.pssh.empty());
+  absl::StrAppendFormat(
+      &cache_key, "%zu:%s:%zu:%s:", encryption_key.key_id.size(),
+      std::string(encryption_key.key_id.begin(), encryption_key.key_id.end()),
+      encryption_key.key.size(),
+      std::string(encryption_key.key.begin(), encryption_key.key.end()));
+  for (const std::vector<uint8_t>& key_id : encryption_key.key_ids) {
+    absl::StrAppendFormat(&cache_key, "%zu:%s:", key_id.size(),
+                          std::string(key_id.begin(), key_id.end()));
+  }
+  return cache_key;
+}
+
 Status FillProtectionSystemInfo(const EncryptionParams& encryption_params,
                                 const EncryptionKey& encryption_key,
                                 EncryptionConfig* encryption_config) {
@@ -134,22 +197,41 @@ Status FillProtectionSystemInfo(const EncryptionParams& encryption_params,
   std::vector<std::vector<uint8_t>> no_pssh_systems;
   FillPsshGenerators(encryption_params, &pssh_generators, &no_pssh_systems);
 
-  encryption_config->key_system_info = encryption_key.key_system_info;
-  for (const auto& pssh_generator : pssh_generators) {
-    const bool support_multiple_keys = pssh_generator->SupportMultipleKeys();
-    if (support_multiple_keys) {
-      ProtectionSystemSpecificInfo info;
-      RETURN_IF_ERROR(pssh_generator->GeneratePsshFromKeyIds(
-          encryption_key.key_ids, &info));
-      AddProtectionSystemIfNotExist(info, encryption_config);
-    } else {
+  PsshCache& cache = GetPsshCache();
+  const std::string cache_key =
+      PsshCacheKey(encryption_params, encryption_key);
+  std::vector<ProtectionSystemSpecificInfo> generated;
+  bool cached = false;
+  {
+    absl::MutexLock lock(&cache.mutex);
+    auto iter = cache.entries.find(cache_key);
+    if (iter != cache.entries.end()) {
+      generated = iter->second;
+      cached = true;
+    }
+  }
+
+  if (!cached) {
+    for (const auto& pssh_generator : pssh_generators) {
+      const bool support_multiple_keys = pssh_generator->SupportMultipleKeys();
       ProtectionSystemSpecificInfo info;
-      RETURN_IF_ERROR(pssh_generator->GeneratePsshFromKeyIdAndKey(
-          encryption_key.key_id, encryption_key.key, &info));
-      AddProtectionSystemIfNotExist(info, encryption_config);
+      if (support_multiple_keys) {
+        RETURN_IF_ERROR(pssh_generator->GeneratePsshFromKeyIds(
+            encryption_key.key_ids, &info));
+      } else {
+        RETURN_IF_ERROR(pssh_generator->GeneratePsshFromKeyIdAndKey(
+            encryption_key.key_id, encryption_key.key, &info));
+      }
+      generated.push_back(std::move(info));
     }
+    absl::MutexLock lock(&cache.mutex);
+    cache.entries[cache_key] = generated;
   }
 
+  encryption_config->key_system_info = encryption_key.key_system_info;
+  for (const ProtectionSystemSpecificInfo& info : generated)
+    AddProtectionSystemIfNotExist(info, encryption_config);
+
   for (const auto& no_pssh_system : no_pssh_systems) {
     ProtectionSystemSpecificInfo info;
     info.system_id = no_pssh_system;
@@ -171,7 +253,12 @@ EncryptionHandler::EncryptionHandler(const EncryptionParams& encryption_params,
           new SubsampleGenerator(encryption_params.vp9_subsample_encryption)),
       encryptor_factory_(new AesEncryptorFactory) {}
 
-EncryptionHandler::~EncryptionHandler() = default;
+EncryptionHandler::~EncryptionHandler() {
+  if (task_queue_)
+    task_queue_->Stop();
+  for (std::thread& worker : workers_)
+    worker.join();
+}
 
 Status EncryptionHandler::InitializeInternal() {
   if (!encryption_params_.stream_label_func) {
@@ -181,10 +268,25 @@ Status EncryptionHandler::InitializeInternal() {
     return Status(error::INVALID_ARGUMENT,
                   "Expects exactly one input and output.");
   }
+  if (encryption_params_.encryption_worker_count > 0) {
+    task_queue_.reset(new ProducerConsumerQueue<std::shared_ptr<EncryptTask>>(
+        kEncryptTasksPerWorker * encryption_params_.encryption_worker_count));
+    for (int32_t i = 0; i < encryption_params_.encryption_worker_count; ++i)
+      workers_.emplace_back(&EncryptionHandler::EncryptionWorkerLoop, this);
+  }
   return Status::OK;
 }
 
 Status EncryptionHandler::Process(std::unique_ptr<StreamData> stream_data) {
+  if (task_queue_) {
+    // Surface worker errors on the dispatching thread, so an encryption or
+    // downstream failure stops the pipeline instead of being noticed at
+    // flush time.
+    absl::MutexLock lock(&dispatch_mutex_);
+    if (!worker_status_.ok())
+      return worker_status_;
+  }
+
   switch (stream_data->stream_data_type) {
     case StreamDataType::kStreamInfo:
       return ProcessStreamInfo(*stream_data->stream_info);
@@ -204,22 +306,26 @@ Status EncryptionHandler::Process(std::unique_ptr<StreamData> stream_data) {
           remaining_clear_lead_ -= segment_info->duration;
       }
 
-      return DispatchSegmentInfo(kStreamIndex, segment_info);
+      return DeliverStreamData(
+          StreamData::FromSegmentInfo(kStreamIndex, segment_info));
     }
     case StreamDataType::kMediaSample:
       return ProcessMediaSample(std::move(stream_data->media_sample));
     default:
       VLOG(3) << "Stream data type "
               << static_cast<int>(stream_data->stream_data_type) << " ignored.";
-      return Dispatch(std::move(stream_data));
+      return DeliverStreamData(std::move(stream_data));
   }
 }
 
+Status EncryptionHandler::OnFlushRequest(size_t input_stream_index) {
+  RETURN_IF_ERROR(WaitForOutstandingTasks());
+  return MediaHandler::OnFlushRequest(input_stream_index);
+}
+
 Status EncryptionHandler::ProcessStreamInfo(const StreamInfo& clear_info) {
-  if (clear_info.is_encrypted()) {
-    return Status(error::INVALID_ARGUMENT,
-                  "Input stream is already encrypted.");
-  }
+  if (clear_info.is_encrypted())
+    return SetupEncryptedStreamPassThrough(clear_info);
 
   DCHECK_NE(kStreamUnknown, clear_info.stream_type());
   DCHECK_NE(kStreamText, clear_info.stream_type());
@@ -259,18 +365,72 @@ Status EncryptionHandler::ProcessStreamInfo(const StreamInfo& clear_info) {
   stream_info->set_has_clear_lead(encryption_params_.clear_lead_in_seconds > 0);
   stream_info->set_encryption_config(*encryption_config_);
 
-  return DispatchStreamInfo(kStreamIndex, stream_info);
+  return DeliverStreamData(
+      StreamData::FromStreamInfo(kStreamIndex, stream_info));
+}
+
+Status EncryptionHandler::SetupEncryptedStreamPassThrough(
+    const StreamInfo& stream_info) {
+  // Already-encrypted input can only be forwarded as is, which is valid when
+  // the input protection matches the target scheme and key - the typical
+  // manifest-only refresh that repackages CENC content with the same keys.
+  // The samples then keep their existing subsample info and no AES work is
+  // done.
+  if (encryption_params_.crypto_period_duration_in_seconds != 0) {
+    return Status(error::INVALID_ARGUMENT,
+                  "Input stream is already encrypted; it cannot be "
+                  "repackaged with key rotation.");
+  }
+
+  const EncryptionConfig& input_config = stream_info.encryption_config();
+  if (input_config.protection_scheme != protection_scheme_) {
+    return Status(
+        error::INVALID_ARGUMENT,
+        "Input stream is already encrypted with protection scheme '" +
+            FourCCToString(input_config.protection_scheme) +
+            "', which does not match the target scheme '" +
+            FourCCToString(protection_scheme_) + "'.");
+  }
+
+  stream_label_ = GetStreamLabelForEncryption(
+      stream_info, encryption_params_.stream_label_func);
+  EncryptionKey encryption_key;
+  RETURN_IF_ERROR(key_source_->GetKey(stream_label_, &encryption_key));
+  if (encryption_key.key_id != input_config.key_id) {
+    return Status(error::INVALID_ARGUMENT,
+                  "Input stream is already encrypted with a different key; "
+                  "it cannot be repackaged without re-encryption.");
+  }
+
+  pass_through_ = true;
+  // Keep the input protection parameters for signaling; only the protection
+  // system info is refreshed from the key source.
+  encryption_config_.reset(new EncryptionConfig(input_config));
+  RETURN_IF_ERROR(FillProtectionSystemInfo(encryption_params_, encryption_key,
+                                           encryption_config_.get()));
+
+  std::shared_ptr<StreamInfo> updated_info = stream_info.Clone();
+  updated_info->set_encryption_config(*encryption_config_);
+  return DeliverStreamData(
+      StreamData::FromStreamInfo(kStreamIndex, updated_info));
 }
 
 Status EncryptionHandler::ProcessMediaSample(
     std::shared_ptr<const MediaSample> clear_sample) {
   DCHECK(clear_sample);
 
+  // In pass-through mode the sample is already encrypted and carries its
+  // decrypt config; forward it untouched.
+  if (pass_through_) {
+    return DeliverStreamData(
+        StreamData::FromMediaSample(kStreamIndex, std::move(clear_sample)));
+  }
+
   // Process the frame even if the frame is not encrypted as the next
   // (encrypted) frame may be dependent on this clear frame.
   std::vector<SubsampleEntry> subsamples;
-  RETURN_IF_ERROR(subsample_generator_->GenerateSubsamples(
-      clear_sample->data(), clear_sample->data_size(), &subsamples));
+  RETURN_IF_ERROR(
+      subsample_generator_->GenerateSubsamples(*clear_sample, &subsamples));
 
   // Need to setup the encryptor for new segments even if this segment does not
   // need to be encrypted, so we can signal encryption metadata earlier to
@@ -297,52 +457,47 @@ Status EncryptionHandler::ProcessMediaSample(
   // Since there is no encryption needed right now, send the clear copy
   // downstream so we can save the costs of copying it.
   if (remaining_clear_lead_ > 0) {
-    return DispatchMediaSample(kStreamIndex, std::move(clear_sample));
+    return DeliverStreamData(
+        StreamData::FromMediaSample(kStreamIndex, std::move(clear_sample)));
   }
 
-  size_t ciphertext_size =
-      encryptor_->RequiredOutputSize(clear_sample->data_size());
-
-  std::shared_ptr<uint8_t> cipher_sample_data(new uint8_t[ciphertext_size],
-                                              std::default_delete<uint8_t[]>());
+  if (task_queue_) {
+    // Hand the sample to the worker pool with its own encryptor, initialized
+    // with this sample's iv, so workers can encrypt independently while the
+    // dispatching thread moves on to the next sample.
+    auto task = std::make_shared<EncryptTask>();
+    task->clear_sample = std::move(clear_sample);
+    task->subsamples = std::move(subsamples);
+    task->key_id = encryption_config_->key_id;
+    task->key = current_key_.key;
+    task->iv = encryptor_->iv();
+    task->encryptor = encryptor_factory_->CreateEncryptor(
+        protection_scheme_, crypt_byte_block_, skip_byte_block_, codec_,
+        current_key_.key, task->iv);
+    if (!task->encryptor) {
+      return Status(error::ENCRYPTION_FAILURE,
+                    "Failed to create worker encryptor");
+    }
 
-  const uint8_t* source = clear_sample->data();
-  uint8_t* dest = cipher_sample_data.get();
-  if (!subsamples.empty()) {
-    size_t total_size = 0;
-    for (const SubsampleEntry& subsample : subsamples) {
-      if (subsample.clear_bytes > 0) {
-        // clear_bytes is the number of bytes to leave in the clear
-        memcpy(dest, source, subsample.clear_bytes);
-        source += subsample.clear_bytes;
-        dest += subsample.clear_bytes;
-        total_size += subsample.clear_bytes;
-      }
-      if (subsample.cipher_bytes > 0) {
-        // cipher_bytes is the number of bytes we want to encrypt
-        EncryptBytes(source, subsample.cipher_bytes, dest, ciphertext_size);
-        source += subsample.cipher_bytes;
-        dest += subsample.cipher_bytes;
-        total_size += subsample.cipher_bytes;
-      }
+    // Advance the iv chain here, as the worker's encryptor is throwaway. The
+    // number of bytes the sample will encrypt is known from the subsamples.
+    size_t cipher_bytes = 0;
+    if (task->subsamples.empty()) {
+      cipher_bytes = task->clear_sample->data_size();
+    } else {
+      for (const SubsampleEntry& subsample : task->subsamples)
+        cipher_bytes += subsample.cipher_bytes;
     }
-    DCHECK_EQ(total_size, clear_sample->data_size());
-  } else {
-    EncryptBytes(source, clear_sample->data_size(), dest, ciphertext_size);
+    encryptor_->AddCryptedBytes(cipher_bytes);
+    encryptor_->UpdateIv();
+
+    return EnqueueEncryptTask(std::move(task));
   }
 
-  std::shared_ptr<MediaSample> cipher_sample(clear_sample->Clone());
-  cipher_sample->TransferData(std::move(cipher_sample_data),
-                              clear_sample->data_size());
-
-  // Finish initializing the sample before sending it downstream. We must
-  // wait until now to finish the initialization as we will lose access to
-  // |decrypt_config| once we set it.
-  cipher_sample->set_is_encrypted(true);
-  std::unique_ptr<DecryptConfig> decrypt_config(new DecryptConfig(
-      encryption_config_->key_id, encryptor_->iv(), subsamples,
-      protection_scheme_, crypt_byte_block_, skip_byte_block_));
-  cipher_sample->set_decrypt_config(std::move(decrypt_config));
+  std::shared_ptr<MediaSample> cipher_sample =
+      EncryptSample(*clear_sample, subsamples, encryptor_.get(),
+                    current_key_.key, encryption_config_->key_id,
+                    encryptor_->iv(), &crypt_spans_);
 
   encryptor_->UpdateIv();
 
@@ -370,6 +525,17 @@ bool EncryptionHandler::CreateEncryptor(const EncryptionKey& encryption_key) {
   if (!encryptor)
     return false;
   encryptor_ = std::move(encryptor);
+  // Keep the key around so per-sample worker encryptors can be created from
+  // it.
+  current_key_ = encryption_key;
+
+  // Monomorphize the per-sample encrypt driver on the scheme's capability:
+  // the intra-frame parallel split is only compiled into the variant for
+  // span-skipping (constant-iv) schemes, and the hot path never queries the
+  // scheme per sample.
+  encrypt_sample_fn_ = encryptor_->SupportsSpanSkip()
+                           ? &EncryptionHandler::EncryptSampleImpl<true>
+                           : &EncryptionHandler::EncryptSampleImpl<false>;
 
   encryption_config_.reset(new EncryptionConfig);
   encryption_config_->protection_scheme = protection_scheme_;
@@ -390,14 +556,235 @@ bool EncryptionHandler::CreateEncryptor(const EncryptionKey& encryption_key) {
   return status.ok();
 }
 
-void EncryptionHandler::EncryptBytes(const uint8_t* source,
-                                     size_t source_size,
-                                     uint8_t* dest,
-                                     size_t dest_size) {
-  DCHECK(source);
-  DCHECK(dest);
-  DCHECK(encryptor_);
-  CHECK(encryptor_->Crypt(source, source_size, dest, &dest_size));
+std::shared_ptr<MediaSample> EncryptionHandler::EncryptSample(
+    const MediaSample& clear_sample,
+    const std::vector<SubsampleEntry>& subsamples,
+    AesCryptor* encryptor,
+    const std::vector<uint8_t>& key,
+    const std::vector<uint8_t>& key_id,
+    const std::vector<uint8_t>& iv,
+    std::vector<AesCryptor::CryptSpan>* crypt_spans) {
+  DCHECK(encrypt_sample_fn_);
+  return (this->*encrypt_sample_fn_)(clear_sample, subsamples, encryptor, key,
+                                     key_id, iv, crypt_spans);
+}
+
+template <bool kSupportsSpanSkip>
+std::shared_ptr<MediaSample> EncryptionHandler::EncryptSampleImpl(
+    const MediaSample& clear_sample,
+    const std::vector<SubsampleEntry>& subsamples,
+    AesCryptor* encryptor,
+    const std::vector<uint8_t>& key,
+    const std::vector<uint8_t>& key_id,
+    const std::vector<uint8_t>& iv,
+    std::vector<AesCryptor::CryptSpan>* crypt_spans) {
+  DCHECK(encryptor);
+  DCHECK_EQ(kSupportsSpanSkip, encryptor->SupportsSpanSkip());
+
+  const size_t ciphertext_size =
+      encryptor->RequiredOutputSize(clear_sample.data_size());
+
+  std::shared_ptr<uint8_t> cipher_sample_data(new uint8_t[ciphertext_size],
+                                              std::default_delete<uint8_t[]>());
+
+  const uint8_t* source = clear_sample.data();
+  uint8_t* dest = cipher_sample_data.get();
+  if (!subsamples.empty()) {
+    // Copy the clear ranges and collect the protected ranges, then encrypt
+    // them all in one batched call so the encryptor is entered once per
+    // sample rather than once per subsample.
+    crypt_spans->clear();
+    size_t total_size = 0;
+    size_t total_cipher_bytes = 0;
+    for (const SubsampleEntry& subsample : subsamples) {
+      if (subsample.clear_bytes > 0) {
+        // clear_bytes is the number of bytes to leave in the clear
+        memcpy(dest, source, subsample.clear_bytes);
+        source += subsample.clear_bytes;
+        dest += subsample.clear_bytes;
+        total_size += subsample.clear_bytes;
+      }
+      if (subsample.cipher_bytes > 0) {
+        // cipher_bytes is the number of bytes we want to encrypt
+        AesCryptor::CryptSpan span;
+        span.text = source;
+        span.text_size = subsample.cipher_bytes;
+        span.crypt_text = dest;
+        span.crypt_text_size = subsample.cipher_bytes;
+        crypt_spans->push_back(span);
+        source += subsample.cipher_bytes;
+        dest += subsample.cipher_bytes;
+        total_size += subsample.cipher_bytes;
+        total_cipher_bytes += subsample.cipher_bytes;
+      }
+    }
+    DCHECK_EQ(total_size, clear_sample.data_size());
+    // Large intra frames are otherwise a single-threaded multi-megabyte AES
+    // job; split them across the thread pool when the scheme allows it.
+    const bool crypted_in_parallel =
+        kSupportsSpanSkip &&
+        total_cipher_bytes >= kParallelCryptThresholdBytes &&
+        crypt_spans->size() > 1 &&
+        CryptSpansInParallel(encryptor, key, iv, crypt_spans->data(),
+                             crypt_spans->size(), total_cipher_bytes);
+    if (!crypted_in_parallel)
+      CHECK(encryptor->Crypt(crypt_spans->data(), crypt_spans->size()));
+  } else {
+    size_t dest_size = ciphertext_size;
+    CHECK(encryptor->Crypt(source, clear_sample.data_size(), dest, &dest_size));
+  }
+
+  std::shared_ptr<MediaSample> cipher_sample(clear_sample.Clone());
+  cipher_sample->TransferData(std::move(cipher_sample_data),
+                              clear_sample.data_size());
+
+  // Finish initializing the sample before sending it downstream. We must
+  // wait until now to finish the initialization as we will lose access to
+  // |decrypt_config| once we set it.
+  cipher_sample->set_is_encrypted(true);
+  std::unique_ptr<DecryptConfig> decrypt_config(
+      new DecryptConfig(key_id, iv, subsamples, protection_scheme_,
+                        crypt_byte_block_, skip_byte_block_));
+  cipher_sample->set_decrypt_config(std::move(decrypt_config));
+
+  return cipher_sample;
+}
+
+bool EncryptionHandler::CryptSpansInParallel(AesCryptor* encryptor,
+                                             const std::vector<uint8_t>& key,
+                                             const std::vector<uint8_t>& iv,
+                                             AesCryptor::CryptSpan* spans,
+                                             size_t num_spans,
+                                             size_t total_cipher_bytes) {
+  const size_t num_shards = std::min(
+      {kMaxParallelCryptShards, num_spans,
+       std::max<size_t>(total_cipher_bytes / kParallelCryptShardBytes, 2)});
+  const size_t bytes_per_shard = total_cipher_bytes / num_shards;
+
+  // Cut the span list into up to |num_shards| runs of roughly equal cipher
+  // bytes. The first run reuses |encryptor|, which is already at the right
+  // cipher state; every other run gets a clone fast-forwarded across the
+  // spans before it. Nothing is encrypted until the partitioning succeeded,
+  // so the caller can still fall back to the serial path.
+  struct Shard {
+    AesCryptor* encryptor;
+    AesCryptor::CryptSpan* spans;
+    size_t num_spans;
+  };
+  std::vector<Shard> shards;
+  std::vector<std::unique_ptr<AesCryptor>> clones;
+  size_t first_shard_cipher_bytes = 0;
+  size_t shard_start = 0;
+  size_t shard_bytes = 0;
+  AesCryptor* shard_encryptor = encryptor;
+  for (size_t i = 0; i < num_spans; ++i) {
+    shard_bytes += spans[i].text_size;
+    const bool last_span = i + 1 == num_spans;
+    if (!last_span &&
+        (shard_bytes < bytes_per_shard || shards.size() + 1 == num_shards)) {
+      continue;
+    }
+    if (shards.empty())
+      first_shard_cipher_bytes = shard_bytes;
+    shards.push_back({shard_encryptor, spans + shard_start,
+                      i + 1 - shard_start});
+    if (last_span)
+      break;
+    shard_start = i + 1;
+    shard_bytes = 0;
+    std::unique_ptr<AesCryptor> clone = encryptor_factory_->CreateEncryptor(
+        protection_scheme_, crypt_byte_block_, skip_byte_block_, codec_, key,
+        iv);
+    if (!clone)
+      return false;
+    for (size_t j = 0; j < shard_start; ++j) {
+      if (!clone->SkipSpan(spans[j].text_size))
+        return false;
+    }
+    shard_encryptor = clone.get();
+    clones.push_back(std::move(clone));
+  }
+
+  absl::Mutex mutex;
+  bool crypt_ok = true;                          // Protected by |mutex|.
+  size_t pending_shards = shards.size() - 1;     // Protected by |mutex|.
+  for (size_t i = 1; i < shards.size(); ++i) {
+    const Shard* shard = &shards[i];
+    ThreadPool::instance.PostTask(
+        [shard, &mutex, &crypt_ok, &pending_shards]() {
+          const bool ok =
+              shard->encryptor->Crypt(shard->spans, shard->num_spans);
+          absl::MutexLock lock(&mutex);
+          crypt_ok = crypt_ok && ok;
+          --pending_shards;
+        });
+  }
+
+  bool ok = encryptor->Crypt(shards[0].spans, shards[0].num_spans);
+  {
+    absl::MutexLock lock(&mutex);
+    mutex.Await(absl::Condition(
+        +[](size_t* pending) { return *pending == 0; }, &pending_shards));
+    ok = ok && crypt_ok;
+  }
+  CHECK(ok);
+  // |encryptor| only crypted the first shard itself; account for the rest so
+  // a subsequent UpdateIv() advances the iv chain over the whole sample.
+  encryptor->AddCryptedBytes(total_cipher_bytes - first_shard_cipher_bytes);
+  return true;
+}
+
+Status EncryptionHandler::DeliverStreamData(
+    std::unique_ptr<StreamData> stream_data) {
+  if (!task_queue_)
+    return Dispatch(std::move(stream_data));
+
+  // Queue a pass-through task so the data keeps its order relative to the
+  // samples being encrypted on the workers.
+  auto task = std::make_shared<EncryptTask>();
+  task->stream_data = std::move(stream_data);
+  return EnqueueEncryptTask(std::move(task));
+}
+
+Status EncryptionHandler::EnqueueEncryptTask(
+    std::shared_ptr<EncryptTask> task) {
+  DCHECK(task_queue_);
+  task->sequence_number = next_task_sequence_++;
+  return task_queue_->Push(task, kInfiniteTimeout);
+}
+
+void EncryptionHandler::EncryptionWorkerLoop() {
+  std::vector<AesCryptor::CryptSpan> crypt_spans;
+  std::shared_ptr<EncryptTask> task;
+  while (task_queue_->Pop(&task, kInfiniteTimeout).ok()) {
+    if (task->clear_sample) {
+      std::shared_ptr<MediaSample> cipher_sample =
+          EncryptSample(*task->clear_sample, task->subsamples,
+                        task->encryptor.get(), task->key, task->key_id,
+                        task->iv, &crypt_spans);
+      task->stream_data =
+          StreamData::FromMediaSample(kStreamIndex, std::move(cipher_sample));
+    }
+
+    // Dispatch in sequence order, one worker at a time.
+    absl::MutexLock lock(&dispatch_mutex_);
+    while (next_dispatch_sequence_ != task->sequence_number)
+      dispatch_cv_.Wait(&dispatch_mutex_);
+    if (worker_status_.ok())
+      worker_status_.Update(Dispatch(std::move(task->stream_data)));
+    ++next_dispatch_sequence_;
+    dispatch_cv_.SignalAll();
+    task.reset();
+  }
+}
+
+Status EncryptionHandler::WaitForOutstandingTasks() {
+  if (!task_queue_)
+    return Status::OK;
+  absl::MutexLock lock(&dispatch_mutex_);
+  while (next_dispatch_sequence_ != next_task_sequence_)
+    dispatch_cv_.Wait(&dispatch_mutex_);
+  return worker_status_;
 }
 
 void EncryptionHandler::InjectSubsampleGeneratorForTesting(
@@ -7,14 +7,20 @@
 #ifndef PACKAGER_MEDIA_CRYPTO_ENCRYPTION_HANDLER_H_
 #define PACKAGER_MEDIA_CRYPTO_ENCRYPTION_HANDLER_H_
 
+#include <thread>
+
+#include <absl/base/thread_annotations.h>
+#include <absl/synchronization/mutex.h>
+
 #include <packager/crypto_params.h>
+#include <packager/media/base/aes_cryptor.h>
 #include <packager/media/base/key_source.h>
 #include <packager/media/base/media_handler.h>
+#include <packager/media/base/producer_consumer_queue.h>
 
 namespace shaka {
 namespace media {
 
-class AesCryptor;
 class AesEncryptorFactory;
 class SubsampleGenerator;
 struct EncryptionKey;
@@ -31,6 +37,7 @@ class EncryptionHandler : public MediaHandler {
   /// @{
   Status InitializeInternal() override;
   Status Process(std::unique_ptr<StreamData> stream_data) override;
+  Status OnFlushRequest(size_t input_stream_index) override;
   /// @}
 
  private:
@@ -39,8 +46,33 @@ class EncryptionHandler : public MediaHandler {
   EncryptionHandler(const EncryptionHandler&) = delete;
   EncryptionHandler& operator=(const EncryptionHandler&) = delete;
 
+  // A unit of work for the encryption worker pool: either a media sample to
+  // encrypt or already prepared stream data to pass through. Tasks are
+  // dispatched downstream in |sequence_number| order.
+  struct EncryptTask {
+    uint64_t sequence_number = 0;
+    // Prepared stream data, dispatched as is. For sample tasks this is filled
+    // in by the worker once the sample is encrypted.
+    std::unique_ptr<StreamData> stream_data;
+    // The fields below are only set for samples that need to be encrypted.
+    std::shared_ptr<const MediaSample> clear_sample;
+    std::vector<SubsampleEntry> subsamples;
+    std::vector<uint8_t> key_id;
+    // Key and iv the task's encryptor was created with, kept so large frames
+    // can clone it for intra-frame parallel encryption.
+    std::vector<uint8_t> key;
+    std::vector<uint8_t> iv;
+    std::unique_ptr<AesCryptor> encryptor;
+  };
+
   // Processes |stream_info| and sets up stream specific variables.
   Status ProcessStreamInfo(const StreamInfo& stream_info);
+  // Handles already-encrypted input. When the input protection matches the
+  // target scheme and key, the stream is switched to pass-through mode:
+  // samples are forwarded with their existing subsample info untouched and
+  // only the signaling (PSSH etc.) is refreshed from the key source. Returns
+  // an error when the input protection does not match.
+  Status SetupEncryptedStreamPassThrough(const StreamInfo& stream_info);
   // Processes media sample and encrypts it if needed.
   Status ProcessMediaSample(std::shared_ptr<const MediaSample> clear_sample);
 
@@ -51,12 +83,60 @@ class EncryptionHandler : public MediaHandler {
   bool SampleAesEncryptEac3Frame(const uint8_t* source,
                                  size_t source_size,
                                  uint8_t* dest);
-  // Encrypt an array with size |source_size|. |dest| should have at
-  // least |source_size| bytes.
-  void EncryptBytes(const uint8_t* source,
-                    size_t source_size,
-                    uint8_t* dest,
-                    size_t dest_size);
+  // Encrypts |clear_sample| with |encryptor| and returns the encrypted sample
+  // carrying the DecryptConfig built from |key_id|, |iv| and |subsamples|.
+  // |key| is the key |encryptor| was created with, needed to clone it when a
+  // large frame is encrypted in parallel. |crypt_spans| is caller-provided
+  // scratch so each thread reuses its own span list. Calls through
+  // |encrypt_sample_fn_|, the driver variant selected for the scheme at
+  // encryptor creation.
+  std::shared_ptr<MediaSample> EncryptSample(
+      const MediaSample& clear_sample,
+      const std::vector<SubsampleEntry>& subsamples,
+      AesCryptor* encryptor,
+      const std::vector<uint8_t>& key,
+      const std::vector<uint8_t>& key_id,
+      const std::vector<uint8_t>& iv,
+      std::vector<AesCryptor::CryptSpan>* crypt_spans);
+  // The monomorphic per-sample encrypt driver. |kSupportsSpanSkip| is the
+  // scheme's AesCryptor::SupportsSpanSkip() capability baked in at compile
+  // time, so the variant for chained-iv schemes carries no intra-frame
+  // parallelism checks at all and neither variant queries the scheme per
+  // sample.
+  template <bool kSupportsSpanSkip>
+  std::shared_ptr<MediaSample> EncryptSampleImpl(
+      const MediaSample& clear_sample,
+      const std::vector<SubsampleEntry>& subsamples,
+      AesCryptor* encryptor,
+      const std::vector<uint8_t>& key,
+      const std::vector<uint8_t>& key_id,
+      const std::vector<uint8_t>& iv,
+      std::vector<AesCryptor::CryptSpan>* crypt_spans);
+  // Splits |spans| at span boundaries into shards of roughly equal cipher
+  // bytes and encrypts them on the thread pool, each shard with its own clone
+  // of |encryptor| fast-forwarded to the shard's cipher state. |encryptor|
+  // itself crypts the first shard and ends up accounting for all
+  // |total_cipher_bytes|, so its iv chain advances as if it had encrypted the
+  // whole sample. Returns false without touching any payload if a clone
+  // cannot be created or positioned; the caller then falls back to the serial
+  // batched Crypt.
+  bool CryptSpansInParallel(AesCryptor* encryptor,
+                            const std::vector<uint8_t>& key,
+                            const std::vector<uint8_t>& iv,
+                            AesCryptor::CryptSpan* spans,
+                            size_t num_spans,
+                            size_t total_cipher_bytes);
+  // Dispatches |stream_data| downstream, or queues it behind outstanding
+  // encryption tasks when the worker pool is enabled so ordering is kept.
+  Status DeliverStreamData(std::unique_ptr<StreamData> stream_data);
+  // Hands |task| to the worker pool, assigning its dispatch sequence number.
+  Status EnqueueEncryptTask(std::shared_ptr<EncryptTask> task);
+  // Worker thread loop: encrypts queued samples and dispatches tasks
+  // downstream in sequence order.
+  void EncryptionWorkerLoop();
+  // Waits until every queued task has been dispatched downstream and returns
+  // the accumulated worker status. No-op without the worker pool.
+  Status WaitForOutstandingTasks();
 
   // An E-AC3 frame comprises of one or more syncframes. This function extracts
   // the syncframe sizes from the source bytes.
@@ -86,9 +166,47 @@ class EncryptionHandler : public MediaHandler {
   // Previous crypto period index if key rotation is enabled.
   int64_t prev_crypto_period_index_ = -1;
   bool check_new_crypto_period_ = false;
+  // Input is already encrypted with the target scheme and key; samples are
+  // forwarded without decryption or re-encryption.
+  bool pass_through_ = false;
 
   std::unique_ptr<SubsampleGenerator> subsample_generator_;
   std::unique_ptr<AesEncryptorFactory> encryptor_factory_;
+  // Per-sample encrypt driver, specialized for the protection scheme when the
+  // encryptor is created; see EncryptSampleImpl.
+  using EncryptSampleFn = std::shared_ptr<MediaSample> (EncryptionHandler::*)(
+      const MediaSample&,
+      const std::vector<SubsampleEntry>&,
+      AesCryptor*,
+      const std::vector<uint8_t>&,
+      const std::vector<uint8_t>&,
+      const std::vector<uint8_t>&,
+      std::vector<AesCryptor::CryptSpan>*);
+  EncryptSampleFn encrypt_sample_fn_ = nullptr;
+  // Scratch list of protected byte ranges of the sample being encrypted, so
+  // the per-subsample spans can be batched into a single Crypt call without
+  // allocating per sample. Only used when encrypting inline; workers keep
+  // their own scratch.
+  std::vector<AesCryptor::CryptSpan> crypt_spans_;
+  // Current key, kept to create per-sample worker encryptors.
+  EncryptionKey current_key_;
+
+  // Worker pool for background sample encryption; null unless
+  // encryption_params_.encryption_worker_count is positive.
+  std::unique_ptr<ProducerConsumerQueue<std::shared_ptr<EncryptTask>>>
+      task_queue_;
+  std::vector<std::thread> workers_;
+  // Sequence number for the next task; only touched on the dispatching
+  // thread.
+  uint64_t next_task_sequence_ = 0;
+  // Serializes downstream dispatches from the workers and enforces task
+  // order.
+  absl::Mutex dispatch_mutex_;
+  absl::CondVar dispatch_cv_;
+  uint64_t next_dispatch_sequence_ ABSL_GUARDED_BY(dispatch_mutex_) = 0;
+  // First error hit by a worker; once set, remaining tasks are drained
+  // without dispatching.
+  Status worker_status_ ABSL_GUARDED_BY(dispatch_mutex_);
   // Number of encrypted blocks (16-byte-block) in pattern based encryption.
   uint8_t crypt_byte_block_ = 0;
   /// Number of unencrypted blocks (16-byte-block) in pattern based encryption.
@@ -11,6 +11,7 @@
 #include <gtest/gtest.h>
 
 #include <packager/media/base/aes_cryptor.h>
+#include <packager/media/base/encryption_config.h>
 #include <packager/media/base/media_handler_test_base.h>
 #include <packager/media/base/mock_aes_cryptor.h>
 #include <packager/media/base/protection_system_ids.h>
@@ -28,6 +29,7 @@ using ::testing::ByMove;
 using ::testing::Combine;
 using ::testing::DoAll;
 using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
 using ::testing::Invoke;
 using ::testing::Mock;
 using ::testing::Return;
@@ -216,6 +218,57 @@ const size_t kDataSize = sizeof(kData);
 
 }  // namespace
 
+TEST_F(EncryptionHandlerTest, PassThroughMatchingProtection) {
+  const EncryptionKey mock_encryption_key = GetMockEncryptionKey();
+  EXPECT_CALL(mock_key_source_, GetKey(_, _))
+      .WillOnce(
+          DoAll(SetArgPointee<1>(mock_encryption_key), Return(Status::OK)));
+
+  std::shared_ptr<StreamInfo> stream_info =
+      GetVideoStreamInfo(kTimeScale, kCodecH264);
+  stream_info->set_is_encrypted(true);
+  EncryptionConfig input_config;
+  input_config.protection_scheme = FOURCC_cenc;
+  input_config.key_id = mock_encryption_key.key_id;
+  stream_info->set_encryption_config(input_config);
+
+  ASSERT_OK(Process(StreamData::FromStreamInfo(kStreamIndex, stream_info)));
+
+  // The already-encrypted sample must be forwarded untouched.
+  ASSERT_OK(Process(StreamData::FromMediaSample(
+      kStreamIndex,
+      GetMediaSample(0, kSegmentDuration, kIsKeyFrame, kData, kDataSize))));
+
+  EXPECT_THAT(
+      GetOutputStreamDataVector(),
+      ElementsAre(IsStreamInfo(kStreamIndex, kTimeScale, kEncrypted, _),
+                  IsMediaSample(kStreamIndex, 0, kSegmentDuration, _, _)));
+  const MediaSample* media_sample =
+      GetOutputStreamDataVector().back()->media_sample.get();
+  ASSERT_TRUE(media_sample);
+  EXPECT_EQ(std::vector<uint8_t>(kData, kData + kDataSize),
+            std::vector<uint8_t>(
+                media_sample->data(),
+                media_sample->data() + media_sample->data_size()));
+}
+
+TEST_F(EncryptionHandlerTest, PassThroughKeyMismatch) {
+  EXPECT_CALL(mock_key_source_, GetKey(_, _))
+      .WillOnce(
+          DoAll(SetArgPointee<1>(GetMockEncryptionKey()), Return(Status::OK)));
+
+  std::shared_ptr<StreamInfo> stream_info =
+      GetVideoStreamInfo(kTimeScale, kCodecH264);
+  stream_info->set_is_encrypted(true);
+  EncryptionConfig input_config;
+  input_config.protection_scheme = FOURCC_cenc;
+  input_config.key_id.assign(16, 0xFF);
+  stream_info->set_encryption_config(input_config);
+
+  ASSERT_NOT_OK(
+      Process(StreamData::FromStreamInfo(kStreamIndex, stream_info)));
+}
+
 class EncryptionHandlerEncryptionTest
     : public EncryptionHandlerTest,
       public WithParamInterface<std::tuple<FourCC, Codec>> {
@@ -557,7 +610,8 @@ TEST_P(EncryptionHandlerSubsampleTest, SubsampleTest) {
       std::vector<uint8_t>(sample.data(), sample.data() + sample.data_size()));
 
   const DecryptConfig& decrypt_config = *sample.decrypt_config();
-  EXPECT_EQ(GetParam().subsamples, decrypt_config.subsamples());
+  EXPECT_THAT(decrypt_config.subsamples(),
+              ElementsAreArray(GetParam().subsamples));
 }
 
 class EncryptionHandlerTrackTypeTest : public EncryptionHandlerTest {};
@@ -6,7 +6,7 @@
 
 #include <packager/media/crypto/sample_aes_ec3_cryptor.h>
 
-#include <algorithm>
+#include <cstring>
 
 #include <absl/log/check.h>
 #include <absl/log/log.h>
@@ -83,8 +83,7 @@ bool SampleAesEc3Cryptor::CryptInternal(const uint8_t* text,
   }
   *crypt_text_size = text_size;
 
-  std::vector<size_t> syncframe_sizes;
-  if (!ExtractEac3SyncframeSizes(text, text_size, &syncframe_sizes))
+  if (!ExtractEac3SyncframeSizes(text, text_size, &syncframe_sizes_))
     return false;
 
   // MPEG-2 Stream Encryption Format for HTTP Live Streaming 2.3.1.3 Enhanced
@@ -92,21 +91,30 @@ bool SampleAesEc3Cryptor::CryptInternal(const uint8_t* text,
   // encrypted.
   const size_t kLeadingClearBytesSize = 16u;
 
-  for (size_t syncframe_size : syncframe_sizes) {
-    memcpy(crypt_text, text, std::min(syncframe_size, kLeadingClearBytesSize));
+  // Copy the whole sample once instead of copying the clear leading bytes
+  // syncframe by syncframe; the batched crypt below overwrites the protected
+  // bytes.
+  memcpy(crypt_text, text, text_size);
+
+  crypt_spans_.clear();
+  size_t offset = 0;
+  for (size_t syncframe_size : syncframe_sizes_) {
     if (syncframe_size > kLeadingClearBytesSize) {
-      // The residual block is left untouched (copied without
-      // encryption/decryption). No need to do special handling here.
-      if (!cryptor_->Crypt(text + kLeadingClearBytesSize,
-                           syncframe_size - kLeadingClearBytesSize,
-                           crypt_text + kLeadingClearBytesSize)) {
-        return false;
-      }
+      CryptSpan span;
+      span.text = text + offset + kLeadingClearBytesSize;
+      span.text_size = syncframe_size - kLeadingClearBytesSize;
+      span.crypt_text = crypt_text + offset + kLeadingClearBytesSize;
+      span.crypt_text_size = span.text_size;
+      crypt_spans_.push_back(span);
     }
-    text += syncframe_size;
-    crypt_text += syncframe_size;
+    offset += syncframe_size;
   }
-  return true;
+  // One batched call covers every syncframe of the sample; the cipher block
+  // chain of |cryptor_| carries from one span into the next exactly as the
+  // previous per-syncframe calls did. The residual block of each span is left
+  // untouched (copied without encryption/decryption) by the cryptor, so no
+  // special handling here.
+  return cryptor_->Crypt(crypt_spans_.data(), crypt_spans_.size());
 }
 
 void SampleAesEc3Cryptor::SetIvInternal() {
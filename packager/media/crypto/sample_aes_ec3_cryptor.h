@@ -7,6 +7,8 @@
 #ifndef PACKAGER_MEDIA_CRYPTO_SAMPLE_AES_EC3_CRYPTOR_H_
 #define PACKAGER_MEDIA_CRYPTO_SAMPLE_AES_EC3_CRYPTOR_H_
 
+#include <vector>
+
 #include <packager/media/base/aes_cryptor.h>
 
 namespace shaka {
@@ -39,6 +41,10 @@ class SampleAesEc3Cryptor : public AesCryptor {
   void SetIvInternal() override;
 
   std::unique_ptr<AesCryptor> cryptor_;
+  // Reusable scratch for CryptInternal, to avoid per-sample allocations in
+  // the hot audio encryption path.
+  std::vector<size_t> syncframe_sizes_;
+  std::vector<CryptSpan> crypt_spans_;
 };
 
 }  // namespace media
@@ -13,8 +13,10 @@
 
 #include <packager/macros/compiler.h>
 #include <packager/media/base/decrypt_config.h>
+#include <packager/media/base/media_sample.h>
 #include <packager/media/base/video_stream_info.h>
 #include <packager/media/codecs/av1_parser.h>
+#include <packager/media/codecs/nalu_reader.h>
 #include <packager/media/codecs/video_slice_header_parser.h>
 #include <packager/media/codecs/vp8_parser.h>
 #include <packager/media/codecs/vp9_parser.h>
@@ -130,6 +132,38 @@ Status SubsampleGenerator::Initialize(FourCC protection_scheme,
   codec_ = stream_info.codec();
   nalu_length_size_ = GetNaluLengthSize(stream_info);
 
+  // Determine the clear/cipher layout rules of the scheme first: with leading
+  // clear bytes (SAMPLE-AES) the H.26x layout is a pure function of the NALU
+  // structure, so the slice header parser is never consulted and its
+  // construction (including the SPS/PPS parse) can be skipped entirely.
+  if (protection_scheme == kAppleSampleAesProtectionScheme) {
+    const size_t kH264LeadingClearBytesSize = 32u;
+    const size_t kAudioLeadingClearBytesSize = 16u;
+    switch (codec_) {
+      case kCodecH264:
+        leading_clear_bytes_size_ = kH264LeadingClearBytesSize;
+        min_protected_data_size_ =
+            leading_clear_bytes_size_ + kAesBlockSize + 1u;
+        break;
+      case kCodecAAC:
+        FALLTHROUGH_INTENDED;
+      case kCodecAC3:
+        leading_clear_bytes_size_ = kAudioLeadingClearBytesSize;
+        min_protected_data_size_ = leading_clear_bytes_size_ + kAesBlockSize;
+        break;
+      case kCodecEAC3:
+        // E-AC3 encryption is handled by SampleAesEc3Cryptor, which also
+        // manages leading clear bytes.
+        leading_clear_bytes_size_ = 0;
+        min_protected_data_size_ = leading_clear_bytes_size_ + kAesBlockSize;
+        break;
+      default:
+        LOG(ERROR) << "Unexpected codec for SAMPLE-AES " << codec_;
+        return Status(error::ENCRYPTION_FAILURE,
+                      "Unexpected codec for SAMPLE-AES.");
+    }
+  }
+
   switch (codec_) {
     case kCodecAV1:
       av1_parser_.reset(new AV1Parser);
@@ -139,11 +173,20 @@ Status SubsampleGenerator::Initialize(FourCC protection_scheme,
         vpx_parser_.reset(new VP9Parser);
       break;
     case kCodecH264:
-      header_parser_.reset(new H264VideoSliceHeaderParser);
+      if (leading_clear_bytes_size_ == 0) {
+        header_parser_.reset(new H264VideoSliceHeaderParser);
+        header_parser_nalu_types_ =
+            1ull << Nalu::H264_SPS | 1ull << Nalu::H264_PPS;
+      }
       break;
     case kCodecH265:
     case kCodecH265DolbyVision:
-      header_parser_.reset(new H265VideoSliceHeaderParser);
+      if (leading_clear_bytes_size_ == 0) {
+        header_parser_.reset(new H265VideoSliceHeaderParser);
+        header_parser_nalu_types_ = 1ull << Nalu::H265_VPS |
+                                    1ull << Nalu::H265_SPS |
+                                    1ull << Nalu::H265_PPS;
+      }
       break;
     default:
       // Other codecs should have nalu length size == 0.
@@ -179,34 +222,6 @@ Status SubsampleGenerator::Initialize(FourCC protection_scheme,
 
   align_protected_data_ = ShouldAlignProtectedData(codec_, protection_scheme,
                                                    vp9_subsample_encryption_);
-
-  if (protection_scheme == kAppleSampleAesProtectionScheme) {
-    const size_t kH264LeadingClearBytesSize = 32u;
-    const size_t kAudioLeadingClearBytesSize = 16u;
-    switch (codec_) {
-      case kCodecH264:
-        leading_clear_bytes_size_ = kH264LeadingClearBytesSize;
-        min_protected_data_size_ =
-            leading_clear_bytes_size_ + kAesBlockSize + 1u;
-        break;
-      case kCodecAAC:
-        FALLTHROUGH_INTENDED;
-      case kCodecAC3:
-        leading_clear_bytes_size_ = kAudioLeadingClearBytesSize;
-        min_protected_data_size_ = leading_clear_bytes_size_ + kAesBlockSize;
-        break;
-      case kCodecEAC3:
-        // E-AC3 encryption is handled by SampleAesEc3Cryptor, which also
-        // manages leading clear bytes.
-        leading_clear_bytes_size_ = 0;
-        min_protected_data_size_ = leading_clear_bytes_size_ + kAesBlockSize;
-        break;
-      default:
-        LOG(ERROR) << "Unexpected codec for SAMPLE-AES " << codec_;
-        return Status(error::ENCRYPTION_FAILURE,
-                      "Unexpected codec for SAMPLE-AES.");
-    }
-  }
   return Status::OK;
 }
 
@@ -222,7 +237,9 @@ Status SubsampleGenerator::GenerateSubsamples(
       FALLTHROUGH_INTENDED;
     case kCodecH265:
     case kCodecH265DolbyVision:
-      return GenerateSubsamplesFromH26xFrame(frame, frame_size, subsamples);
+      return GenerateSubsamplesFromH26xFrame(frame, frame_size,
+                                             /* nalu_extents= */ nullptr,
+                                             subsamples);
     case kCodecVP9:
       if (vp9_subsample_encryption_)
         return GenerateSubsamplesFromVPxFrame(frame, frame_size, subsamples);
@@ -246,6 +263,19 @@ Status SubsampleGenerator::GenerateSubsamples(
   return Status::OK;
 }
 
+Status SubsampleGenerator::GenerateSubsamples(
+    const MediaSample& sample,
+    std::vector<SubsampleEntry>* subsamples) {
+  const bool is_h26x = codec_ == kCodecH264 || codec_ == kCodecH265 ||
+                       codec_ == kCodecH265DolbyVision;
+  if (is_h26x && !sample.nalu_extents().empty()) {
+    subsamples->clear();
+    return GenerateSubsamplesFromH26xFrame(sample.data(), sample.data_size(),
+                                           &sample.nalu_extents(), subsamples);
+  }
+  return GenerateSubsamples(sample.data(), sample.data_size(), subsamples);
+}
+
 void SubsampleGenerator::InjectVpxParserForTesting(
     std::unique_ptr<VPxParser> vpx_parser) {
   vpx_parser_ = std::move(vpx_parser);
@@ -295,23 +325,37 @@ Status SubsampleGenerator::GenerateSubsamplesFromVPxFrame(
 Status SubsampleGenerator::GenerateSubsamplesFromH26xFrame(
     const uint8_t* frame,
     size_t frame_size,
+    const std::vector<NaluExtent>* nalu_extents,
     std::vector<SubsampleEntry>* subsamples) {
   DCHECK_NE(nalu_length_size_, 0u);
-  DCHECK(header_parser_);
-
-  SubsampleOrganizer subsample_organizer(align_protected_data_, subsamples);
 
   const Nalu::CodecType nalu_type =
       (codec_ == kCodecH265 || codec_ == kCodecH265DolbyVision) ? Nalu::kH265
                                                                 : Nalu::kH264;
-  NaluReader reader(nalu_type, nalu_length_size_, frame, frame_size);
+  FrameNaluIterator reader(nalu_type, nalu_length_size_, frame, frame_size,
+                           nalu_extents);
+
+  // With leading clear bytes (SAMPLE-AES), the clear/cipher split of every
+  // NALU is a pure function of its size and whether it is a protected video
+  // slice, so a frame repeating the previous frame's NALU structure can reuse
+  // the memoized layout. CENC layouts additionally depend on each slice
+  // header's parsed size and are always computed below.
+  if (leading_clear_bytes_size_ > 0)
+    return GenerateSubsamplesFromNaluStructure(&reader, subsamples);
+
+  DCHECK(header_parser_);
+  SubsampleOrganizer subsample_organizer(align_protected_data_, subsamples);
 
   Nalu nalu;
   NaluReader::Result result;
   while ((result = reader.Advance(&nalu)) == NaluReader::kOk) {
-    // |header_parser_| is only used if |leading_clear_bytes_size_| is not
-    // availble. See lines below.
-    if (leading_clear_bytes_size_ == 0 && !header_parser_->ProcessNalu(nalu)) {
+    // Only the parameter set types in |header_parser_nalu_types_| update the
+    // slice header parser's state. Everything else - slices, SEI and, for
+    // Dolby Vision, the RPU/EL units carried in unspecified NAL types - is
+    // dispositioned from the NALU header alone, so the parser is not
+    // consulted for them.
+    if (((header_parser_nalu_types_ >> nalu.type()) & 1) &&
+        !header_parser_->ProcessNalu(nalu)) {
       LOG(ERROR) << "Failed to process NAL unit: NAL type = " << nalu.type();
       return Status(error::ENCRYPTION_FAILURE, "Failed to process NAL unit.");
     }
@@ -347,19 +391,66 @@ Status SubsampleGenerator::GenerateSubsamplesFromH26xFrame(
   return Status::OK;
 }
 
+Status SubsampleGenerator::GenerateSubsamplesFromNaluStructure(
+    FrameNaluIterator* nalu_iterator,
+    std::vector<SubsampleEntry>* subsamples) {
+  DCHECK_GT(leading_clear_bytes_size_, 0u);
+
+  nalu_structure_.clear();
+
+  Nalu nalu;
+  NaluReader::Result result;
+  while ((result = nalu_iterator->Advance(&nalu)) == NaluReader::kOk) {
+    const size_t nalu_total_size = nalu.header_size() + nalu.payload_size();
+    const bool is_protected =
+        nalu.is_video_slice() && nalu_total_size >= min_protected_data_size_;
+    // Pack the size and the protection flag into one entry; sizes are far
+    // below 2^63.
+    nalu_structure_.push_back(nalu_total_size << 1 |
+                              static_cast<size_t>(is_protected));
+  }
+  if (result != NaluReader::kEOStream) {
+    LOG(ERROR) << "Failed to parse NAL units.";
+    return Status(error::ENCRYPTION_FAILURE, "Failed to parse NAL units.");
+  }
+
+  if (layout_memo_valid_ && nalu_structure_ == memoized_nalu_structure_) {
+    *subsamples = memoized_subsamples_;
+    return Status::OK;
+  }
+
+  {
+    SubsampleOrganizer subsample_organizer(align_protected_data_, subsamples);
+    for (const size_t packed : nalu_structure_) {
+      const size_t nalu_total_size = packed >> 1;
+      const bool is_protected = (packed & 1) != 0;
+      const size_t clear_bytes =
+          is_protected ? leading_clear_bytes_size_ : nalu_total_size;
+      const size_t cipher_bytes = nalu_total_size - clear_bytes;
+      subsample_organizer.AddSubsample(nalu_length_size_ + clear_bytes,
+                                       cipher_bytes);
+    }
+    // The organizer flushes trailing clear bytes on destruction.
+  }
+
+  memoized_nalu_structure_.swap(nalu_structure_);
+  memoized_subsamples_ = *subsamples;
+  layout_memo_valid_ = true;
+  return Status::OK;
+}
+
 Status SubsampleGenerator::GenerateSubsamplesFromAV1Frame(
     const uint8_t* frame,
     size_t frame_size,
     std::vector<SubsampleEntry>* subsamples) {
   DCHECK(av1_parser_);
-  std::vector<AV1Parser::Tile> av1_tiles;
-  if (!av1_parser_->Parse(frame, frame_size, &av1_tiles))
+  if (!av1_parser_->Parse(frame, frame_size, &av1_tiles_))
     return Status(error::ENCRYPTION_FAILURE, "Failed to parse AV1 frame.");
 
   SubsampleOrganizer subsample_organizer(align_protected_data_, subsamples);
 
   size_t last_tile_end_offset = 0;
-  for (const AV1Parser::Tile& tile : av1_tiles) {
+  for (const AV1Parser::Tile& tile : av1_tiles_) {
     DCHECK_LE(last_tile_end_offset, tile.start_offset_in_bytes);
     // Per AV1 in ISO-BMFF spec [1], only decode_tile is encrypted.
     // [1] https://aomediacodec.github.io/av1-isobmff/#subsample-encryption
@@ -12,14 +12,17 @@
 
 #include <packager/media/base/fourccs.h>
 #include <packager/media/base/stream_info.h>
+#include <packager/media/codecs/av1_parser.h>
 #include <packager/status.h>
 
 namespace shaka {
 namespace media {
 
-class AV1Parser;
+class FrameNaluIterator;
+class MediaSample;
 class VideoSliceHeaderParser;
 class VPxParser;
+struct NaluExtent;
 struct SubsampleEntry;
 
 /// Parsing and generating encryption subsamples from bitstreams. Note that the
@@ -60,6 +63,15 @@ class SubsampleGenerator {
                                     size_t frame_size,
                                     std::vector<SubsampleEntry>* subsamples);
 
+  /// Same as above, but when @a sample carries a NALU extent table attached
+  /// by the demuxer or first parser, the NAL units are materialized from the
+  /// table instead of rescanning the frame.
+  /// @param sample is the frame to generate subsamples for.
+  /// @param[out] subsamples will contain the output subsamples on success.
+  /// @returns OK on success, an error status otherwise.
+  Status GenerateSubsamples(const MediaSample& sample,
+                            std::vector<SubsampleEntry>* subsamples);
+
   // Testing injections.
   void InjectVpxParserForTesting(std::unique_ptr<VPxParser> vpx_parser);
   void InjectVideoSliceHeaderParserForTesting(
@@ -77,6 +89,13 @@ class SubsampleGenerator {
   Status GenerateSubsamplesFromH26xFrame(
       const uint8_t* frame,
       size_t frame_size,
+      const std::vector<NaluExtent>* nalu_extents,
+      std::vector<SubsampleEntry>* subsamples);
+  // Computes the layout for NAL structured streams whose clear/cipher split
+  // depends only on the NALU structure (SAMPLE-AES), reusing the memoized
+  // layout when the structure matches the previous frame.
+  Status GenerateSubsamplesFromNaluStructure(
+      FrameNaluIterator* nalu_iterator,
       std::vector<SubsampleEntry>* subsamples);
   Status GenerateSubsamplesFromAV1Frame(
       const uint8_t* frame,
@@ -96,6 +115,24 @@ class SubsampleGenerator {
   // bytes are encrypted. The size is 48+1 bytes for video NAL and 32 bytes for
   // audio according to MPEG-2 Stream Encryption Format for HTTP Live Streaming.
   size_t min_protected_data_size_ = 0;
+  // Bitmask over NAL unit types (bit n set for type n) for which
+  // |header_parser_| has to be consulted, i.e. the parameter sets that update
+  // its state. Built per codec in Initialize(). Every other type - slices,
+  // SEI and, for Dolby Vision, the RPU/EL units carried in unspecified NAL
+  // types - is dispositioned from the NALU header alone.
+  uint64_t header_parser_nalu_types_ = 0;
+
+  // Memoized subsample layout for SAMPLE-AES NAL structured streams, whose
+  // clear/cipher split is a pure function of the NALU structure. CBR encoders
+  // repeat the same structure often, so a frame matching the previous
+  // structure reuses the computed layout. Not applicable to CENC layouts:
+  // there the split depends on each slice header's parsed size, which varies
+  // with slice content even when the NALU sizes repeat.
+  bool layout_memo_valid_ = false;
+  // Scratch for the current frame's structure; one packed entry per NALU.
+  std::vector<size_t> nalu_structure_;
+  std::vector<size_t> memoized_nalu_structure_;
+  std::vector<SubsampleEntry> memoized_subsamples_;
 
   // VPx parser for VPx streams.
   std::unique_ptr<VPxParser> vpx_parser_;
@@ -103,6 +140,9 @@ class SubsampleGenerator {
   std::unique_ptr<VideoSliceHeaderParser> header_parser_;
   // AV1 parser for AV1 streams.
   std::unique_ptr<AV1Parser> av1_parser_;
+  // Scratch for the current frame's tile extents, reused across frames so the
+  // capacity is only grown once per stream.
+  std::vector<AV1Parser::Tile> av1_tiles_;
 };
 
 }  // namespace media
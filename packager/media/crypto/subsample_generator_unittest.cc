@@ -10,8 +10,10 @@
 #include <gtest/gtest.h>
 
 #include <packager/media/base/audio_stream_info.h>
+#include <packager/media/base/media_sample.h>
 #include <packager/media/base/video_stream_info.h>
 #include <packager/media/codecs/av1_parser.h>
+#include <packager/media/codecs/nalu_reader.h>
 #include <packager/media/codecs/video_slice_header_parser.h>
 #include <packager/media/codecs/vpx_parser.h>
 #include <packager/status/status_test_util.h>
@@ -21,7 +23,6 @@ namespace media {
 namespace {
 
 using ::testing::_;
-using ::testing::AtLeast;
 using ::testing::DoAll;
 using ::testing::ElementsAre;
 using ::testing::ElementsAreArray;
@@ -293,8 +294,8 @@ TEST_P(SubsampleGeneratorTest, H264ParseFailed) {
 
   std::unique_ptr<MockVideoSliceHeaderParser> mock_video_slice_header_parser(
       new MockVideoSliceHeaderParser);
-  EXPECT_CALL(*mock_video_slice_header_parser, ProcessNalu(_))
-      .WillOnce(Return(true));
+  // The frame contains no parameter sets, so ProcessNalu is never consulted.
+  EXPECT_CALL(*mock_video_slice_header_parser, ProcessNalu(_)).Times(0);
   EXPECT_CALL(*mock_video_slice_header_parser, GetHeaderSize(_))
       .WillOnce(Return(-1));
 
@@ -347,9 +348,10 @@ TEST_P(SubsampleGeneratorTest, H264SubsampleEncryption) {
 
   std::unique_ptr<MockVideoSliceHeaderParser> mock_video_slice_header_parser(
       new MockVideoSliceHeaderParser);
+  // Only the SPS NALU is routed to ProcessNalu; the slices are dispositioned
+  // from their NALU headers alone.
   EXPECT_CALL(*mock_video_slice_header_parser, ProcessNalu(_))
-      .Times(AtLeast(2))
-      .WillRepeatedly(Return(true));
+      .WillOnce(Return(true));
   EXPECT_CALL(*mock_video_slice_header_parser, GetHeaderSize(_))
       .WillOnce(Return(kSliceHeaderSize[0]))
       .WillOnce(Return(kSliceHeaderSize[1]));
@@ -366,6 +368,51 @@ TEST_P(SubsampleGeneratorTest, H264SubsampleEncryption) {
     EXPECT_THAT(subsamples, ElementsAreArray(kExpectedAlignedSubsamples));
 }
 
+TEST_P(SubsampleGeneratorTest, H264SubsampleEncryptionFromNaluExtents) {
+  SubsampleGenerator generator(kVP9SubsampleEncryption);
+  ASSERT_OK(
+      generator.Initialize(protection_scheme_, GetVideoStreamInfo(kCodecH264)));
+
+  constexpr uint8_t kFrame[] = {
+      // First NALU (nalu_size = 9).
+      0x09, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09,
+      // Second non-video-slice NALU (nalu_size = 6).
+      0x06, 0x67, 0x02, 0x03, 0x04, 0x05, 0x06};
+  constexpr size_t kFrameSize = sizeof(kFrame);
+  const size_t kSliceHeaderSize = 4;
+
+  std::unique_ptr<MockVideoSliceHeaderParser> mock_video_slice_header_parser(
+      new MockVideoSliceHeaderParser);
+  // One SPS per generation pass (scan and extents) reaches ProcessNalu.
+  EXPECT_CALL(*mock_video_slice_header_parser, ProcessNalu(_))
+      .Times(2)
+      .WillRepeatedly(Return(true));
+  EXPECT_CALL(*mock_video_slice_header_parser, GetHeaderSize(_))
+      .Times(2)
+      .WillRepeatedly(Return(kSliceHeaderSize));
+
+  generator.InjectVideoSliceHeaderParserForTesting(
+      std::move(mock_video_slice_header_parser));
+
+  std::vector<SubsampleEntry> subsamples_from_scan;
+  ASSERT_OK(
+      generator.GenerateSubsamples(kFrame, kFrameSize, &subsamples_from_scan));
+
+  // A sample annotated with its NALU extent table must produce the same
+  // layout without rescanning the frame.
+  std::shared_ptr<MediaSample> sample =
+      MediaSample::CopyFrom(kFrame, kFrameSize, true);
+  std::vector<NaluExtent> nalu_extents;
+  ASSERT_TRUE(ParseNaluExtents(Nalu::kH264, 1, kFrame, kFrameSize,
+                               &nalu_extents));
+  sample->set_nalu_extents(std::move(nalu_extents));
+
+  std::vector<SubsampleEntry> subsamples_from_extents;
+  ASSERT_OK(generator.GenerateSubsamples(*sample, &subsamples_from_extents));
+  EXPECT_THAT(subsamples_from_extents,
+              ElementsAreArray(subsamples_from_scan));
+}
+
 TEST_P(SubsampleGeneratorTest, AV1ParserFailed) {
   SubsampleGenerator generator(kVP9SubsampleEncryption);
   ASSERT_OK(
@@ -450,6 +497,17 @@ INSTANTIATE_TEST_CASE_P(
     SubsampleGeneratorTest,
     Values(FOURCC_cenc, FOURCC_cens, FOURCC_cbc1, FOURCC_cbcs));
 
+TEST(SampleAesSubsampleGeneratorTest, H264SkipsSliceHeaderParsing) {
+  SubsampleGenerator generator(kVP9SubsampleEncryption);
+  // The SAMPLE-AES layout is a pure function of the NALU structure, so the
+  // slice header parser is bypassed entirely: an unparsable codec config must
+  // not fail initialization.
+  VideoStreamInfo stream_info = GetVideoStreamInfo(kCodecH264);
+  stream_info.set_codec_config({0xde, 0xad, 0xbe, 0xef});
+  ASSERT_OK(
+      generator.Initialize(kAppleSampleAesProtectionScheme, stream_info));
+}
+
 TEST(SampleAesSubsampleGeneratorTest, AAC) {
   SubsampleGenerator generator(kVP9SubsampleEncryption);
   ASSERT_OK(generator.Initialize(kAppleSampleAesProtectionScheme,
@@ -21,6 +21,7 @@
 #include <packager/media/base/decryptor_source.h>
 #include <packager/media/base/key_source.h>
 #include <packager/media/base/media_sample.h>
+#include <packager/media/base/memory_tracker.h>
 #include <packager/media/base/stream_info.h>
 #include <packager/media/formats/mp2t/mp2t_media_parser.h>
 #include <packager/media/formats/mp4/mp4_media_parser.h>
@@ -36,6 +37,19 @@ const size_t kBufSize = 0x200000;  // 2MB
 // samples before seeing init_event, something is not right. The number
 // set here is arbitrary though.
 const size_t kQueuedSamplesLimit = 10000;
+// Capacity of each per-stream dispatch queue in parallel dispatch mode. Deep
+// enough to ride out short downstream stalls, small enough that backpressure
+// kicks in before samples pile up.
+const size_t kDispatchQueueCapacity = 256;
+// Maximum number of queued samples a dispatch thread coalesces into one
+// DispatchBatch() call. Bounds how long dispatched samples stay counted
+// against the byte watermark before their bytes are released.
+const size_t kDispatchBatchMaxSamples = 64;
+// Default per-stream byte budget (high watermark) of the dispatch queues in
+// parallel dispatch mode; the low watermark is half of it. Roughly a second
+// of a heavy 4K rendition, while an audio stream's queue shrinks to what its
+// bitrate can actually fill instead of the full sample-count capacity.
+const uint64_t kDefaultDispatchBufferBytes = 8 << 20;
 const size_t kInvalidStreamIndex = static_cast<size_t>(-1);
 const size_t kBaseVideoOutputStreamIndex = 0x100;
 const size_t kBaseAudioOutputStreamIndex = 0x200;
@@ -79,9 +93,12 @@ namespace shaka {
 namespace media {
 
 Demuxer::Demuxer(const std::string& file_name)
-    : file_name_(file_name), buffer_(new uint8_t[kBufSize]) {}
+    : file_name_(file_name), buffer_(new uint8_t[kBufSize]) {
+  read_size_ = kBufSize;
+}
 
 Demuxer::~Demuxer() {
+  StopDispatchThreads();
   if (media_file_)
     media_file_->Close();
 }
@@ -95,8 +112,10 @@ Status Demuxer::Run() {
   Status status = InitializeParser();
   // ParserInitEvent callback is called after a few calls to Parse(), which sets
   // up the streams. Only after that, we can verify the outputs below.
-  while (!all_streams_ready_ && status.ok())
+  while (!all_streams_ready_ && !cancelled_ && status.ok())
     status.Update(Parse());
+  if (cancelled_)
+    return Status(error::CANCELLED, "Demuxer run cancelled");
   // If no output is defined, then return success after receiving all stream
   // info.
   if (all_streams_ready_ && output_handlers().empty())
@@ -115,9 +134,29 @@ Status Demuxer::Run() {
     }
   }
 
+  // Push stream selection down into the parser: samples of tracks that no
+  // output consumes are then discarded before assembly instead of after.
+  for (const auto& pair : track_id_to_stream_index_map_) {
+    if (pair.second == kInvalidStreamIndex)
+      parser_->ExcludeTrack(pair.first);
+  }
+
   while (!cancelled_ && status.ok())
     status.Update(Parse());
-  if (cancelled_ && status.ok())
+
+  // Let the per-stream dispatch queues drain (and surface any errors from
+  // the dispatch threads) before flushing downstream.
+  StopDispatchThreads();
+  {
+    absl::MutexLock lock(&dispatch_status_mutex_);
+    status.Update(dispatch_status_);
+  }
+
+  // Cancellation may surface as END_OF_STREAM instead of an exit of the loop
+  // above: closing the input's IoCache makes Read() return short, which looks
+  // like end of file. Report CANCELLED either way and skip the downstream
+  // flush, which would finalize partial outputs.
+  if (cancelled_ && (status.ok() || status.error_code() == error::END_OF_STREAM))
     return Status(error::CANCELLED, "Demuxer run cancelled");
 
   if (status.error_code() == error::END_OF_STREAM) {
@@ -165,6 +204,17 @@ Status Demuxer::InitializeParser() {
                   "Cannot open file for reading " + file_name_);
   }
 
+  // Size reads to the input's transport. A live source caps the read so
+  // polling stays latency-bounded; remote storage asks for large pipelined
+  // reads to amortize per-request overhead, in which case the read buffer is
+  // grown to match. A hint of 0 keeps the default.
+  const uint64_t optimal_read_size = media_file_->OptimalReadSize();
+  if (optimal_read_size > 0) {
+    read_size_ = optimal_read_size;
+    if (read_size_ > kBufSize)
+      buffer_.reset(new uint8_t[read_size_]);
+  }
+
   int64_t bytes_read = 0;
   bool eof = false;
   if (input_format_.empty()) {
@@ -306,9 +356,141 @@ void Demuxer::ParserInitEvent(
     }
     ++base_stream_index;
   }
+
+  if (parallel_stream_dispatch_) {
+    // Spin up one bounded queue + drain thread per output stream, so sample
+    // processing for the individual tracks overlaps with parsing.
+    const uint64_t dispatch_buffer_bytes = dispatch_buffer_bytes_
+                                               ? dispatch_buffer_bytes_
+                                               : kDefaultDispatchBufferBytes;
+    for (size_t stream_index : stream_indexes_) {
+      if (stream_dispatchers_.find(stream_index) != stream_dispatchers_.end())
+        continue;
+      auto dispatcher = std::make_unique<StreamDispatcher>(
+          kDispatchQueueCapacity, dispatch_buffer_bytes,
+          memory_tracker_.get());
+      dispatcher->thread = std::thread(&Demuxer::DispatchThreadMain, this,
+                                       stream_index, dispatcher.get());
+      stream_dispatchers_[stream_index] = std::move(dispatcher);
+    }
+  }
+
   all_streams_ready_ = true;
 }
 
+Demuxer::StreamDispatcher::StreamDispatcher(size_t capacity,
+                                            uint64_t high_watermark_bytes,
+                                            MemoryTracker* memory_tracker)
+    : queue(capacity),
+      high_watermark_bytes(high_watermark_bytes),
+      low_watermark_bytes(high_watermark_bytes / 2),
+      memory_tracker(memory_tracker) {}
+
+Demuxer::StreamDispatcher::~StreamDispatcher() {
+  if (memory_tracker) {
+    absl::MutexLock lock(&mutex);
+    memory_tracker->Remove(queued_bytes);
+  }
+}
+
+void Demuxer::StreamDispatcher::AddBytes(uint64_t bytes) {
+  absl::MutexLock lock(&mutex);
+  if (throttled) {
+    mutex.Await(absl::Condition(
+        +[](StreamDispatcher* self) {
+          self->mutex.AssertHeld();
+          return self->stopped ||
+                 self->queued_bytes <= self->low_watermark_bytes;
+        },
+        this));
+    throttled = false;
+  }
+  queued_bytes += bytes;
+  if (memory_tracker)
+    memory_tracker->Add(bytes);
+  // Under job-level memory pressure the low watermark doubles as the high
+  // one, so the parser stalls earlier and the queue drains to half of its
+  // normal footprint until the pressure clears.
+  const uint64_t effective_high_watermark_bytes =
+      memory_tracker && memory_tracker->UnderPressure()
+          ? low_watermark_bytes
+          : high_watermark_bytes;
+  if (queued_bytes >= effective_high_watermark_bytes)
+    throttled = true;
+}
+
+void Demuxer::StreamDispatcher::RemoveBytes(uint64_t bytes) {
+  absl::MutexLock lock(&mutex);
+  DCHECK_GE(queued_bytes, bytes);
+  queued_bytes -= bytes;
+  if (memory_tracker)
+    memory_tracker->Remove(bytes);
+}
+
+void Demuxer::StreamDispatcher::StopByteThrottling() {
+  absl::MutexLock lock(&mutex);
+  stopped = true;
+}
+
+void Demuxer::DispatchThreadMain(size_t stream_index,
+                                 StreamDispatcher* dispatcher) {
+  std::vector<std::unique_ptr<StreamData>> batch;
+  for (;;) {
+    PendingSample pending;
+    Status pop_status = dispatcher->queue.Pop(&pending, kInfiniteTimeout);
+    if (!pop_status.ok()) {
+      // STOPPED with a drained queue: normal end of stream.
+      return;
+    }
+    // Coalesce whatever else is already queued into one DispatchBatch() call,
+    // so a backlog of high-cadence (typically audio) samples costs a single
+    // virtual dispatch into the downstream chain instead of one per sample.
+    batch.clear();
+    uint64_t batch_bytes = 0;
+    for (;;) {
+      if (pending.media_sample) {
+        batch_bytes += pending.media_sample->data_size();
+        batch.push_back(StreamData::FromMediaSample(
+            stream_index, std::move(pending.media_sample)));
+      } else {
+        batch.push_back(StreamData::FromTextSample(
+            stream_index, std::move(pending.text_sample)));
+      }
+      if (batch.size() >= kDispatchBatchMaxSamples)
+        break;
+      if (!dispatcher->queue.Pop(&pending, 0).ok())
+        break;
+    }
+    // Media bytes are released only after the samples have been dispatched, so
+    // in-flight samples still count against the watermark.
+    Status status = DispatchBatch(std::move(batch));
+    if (batch_bytes)
+      dispatcher->RemoveBytes(batch_bytes);
+    if (!status.ok()) {
+      LOG(ERROR) << "Failed to process sample " << stream_index << " "
+                 << status;
+      {
+        absl::MutexLock lock(&dispatch_status_mutex_);
+        dispatch_status_.Update(status);
+      }
+      // Unblock the producer; remaining queued samples are dropped.
+      dispatcher->StopByteThrottling();
+      dispatcher->queue.Stop();
+      return;
+    }
+  }
+}
+
+void Demuxer::StopDispatchThreads() {
+  for (auto& pair : stream_dispatchers_) {
+    pair.second->StopByteThrottling();
+    pair.second->queue.Stop();
+    if (pair.second->thread.joinable())
+      pair.second->thread.join();
+  }
+  stream_dispatchers_.clear();
+}
+
 bool Demuxer::NewMediaSampleEvent(uint32_t track_id,
                                   std::shared_ptr<MediaSample> sample) {
   if (!all_streams_ready_) {
@@ -366,6 +548,16 @@ bool Demuxer::PushMediaSample(uint32_t track_id,
   }
   if (stream_index_iter->second == kInvalidStreamIndex)
     return true;
+  auto dispatcher_iter = stream_dispatchers_.find(stream_index_iter->second);
+  if (dispatcher_iter != stream_dispatchers_.end()) {
+    PendingSample pending;
+    pending.media_sample = std::move(sample);
+    // Byte watermark first, then the sample-count bound: either blocking is
+    // the backpressure that keeps parsing from outrunning a slow downstream
+    // chain.
+    dispatcher_iter->second->AddBytes(pending.media_sample->data_size());
+    return dispatcher_iter->second->queue.Push(pending, kInfiniteTimeout).ok();
+  }
   Status status = DispatchMediaSample(stream_index_iter->second, sample);
   if (!status.ok()) {
     LOG(ERROR) << "Failed to process sample " << stream_index_iter->second
@@ -384,6 +576,12 @@ bool Demuxer::PushTextSample(uint32_t track_id,
   }
   if (stream_index_iter->second == kInvalidStreamIndex)
     return true;
+  auto dispatcher_iter = stream_dispatchers_.find(stream_index_iter->second);
+  if (dispatcher_iter != stream_dispatchers_.end()) {
+    PendingSample pending;
+    pending.text_sample = std::move(sample);
+    return dispatcher_iter->second->queue.Push(pending, kInfiniteTimeout).ok();
+  }
   Status status = DispatchTextSample(stream_index_iter->second, sample);
   if (!status.ok()) {
     LOG(ERROR) << "Failed to process sample " << stream_index_iter->second
@@ -398,7 +596,39 @@ Status Demuxer::Parse() {
   DCHECK(parser_);
   DCHECK(buffer_);
 
-  int64_t bytes_read = media_file_->Read(buffer_.get(), kBufSize);
+  if (!map_attempted_) {
+    map_attempted_ = true;
+    // Try to switch to zero-copy reads for sources that support memory
+    // mapping. All bytes consumed so far went through Read(), so the mapped
+    // cursor picks up at the current read position.
+    const int64_t file_size = media_file_->Size();
+    uint64_t position = 0;
+    if (file_size > 0 && media_file_->Tell(&position)) {
+      mapped_base_ = media_file_->MapReadRegion(0, file_size);
+      if (mapped_base_) {
+        mapped_size_ = file_size;
+        mapped_pos_ = position;
+      }
+    }
+  }
+
+  if (mapped_base_) {
+    if (mapped_pos_ >= mapped_size_) {
+      if (!parser_->Flush())
+        return Status(error::PARSER_FAILURE, "Failed to flush.");
+      return Status(error::END_OF_STREAM, "");
+    }
+    const uint64_t chunk_size =
+        std::min(static_cast<uint64_t>(read_size_), mapped_size_ - mapped_pos_);
+    const uint8_t* chunk = mapped_base_ + mapped_pos_;
+    mapped_pos_ += chunk_size;
+    return parser_->Parse(chunk, chunk_size)
+               ? Status::OK
+               : Status(error::PARSER_FAILURE,
+                        "Cannot parse media file " + file_name_);
+  }
+
+  int64_t bytes_read = media_file_->Read(buffer_.get(), read_size_);
   if (bytes_read == 0) {
     if (!parser_->Flush())
       return Status(error::PARSER_FAILURE, "Failed to flush.");
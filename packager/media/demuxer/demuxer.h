@@ -8,11 +8,17 @@
 #define PACKAGER_MEDIA_BASE_DEMUXER_H_
 
 #include <deque>
+#include <map>
 #include <memory>
+#include <thread>
 #include <vector>
 
+#include <absl/base/thread_annotations.h>
+#include <absl/synchronization/mutex.h>
+
 #include <packager/macros/classes.h>
 #include <packager/media/base/container_names.h>
+#include <packager/media/base/producer_consumer_queue.h>
 #include <packager/media/origin/origin_handler.h>
 #include <packager/status.h>
 
@@ -26,6 +32,7 @@ class Decryptor;
 class KeySource;
 class MediaParser;
 class MediaSample;
+class MemoryTracker;
 class StreamInfo;
 
 /// Demuxer is responsible for extracting elementary stream samples from a
@@ -79,6 +86,36 @@ class Demuxer : public OriginHandler {
     input_format_ = input_format;
   }
 
+  /// Enable parallel stream dispatch: samples for each output stream are
+  /// handed to a per-stream bounded queue drained by a dedicated thread, so
+  /// per-track downstream processing overlaps with parsing instead of
+  /// serializing on the demux thread. The queues provide backpressure when a
+  /// downstream handler falls behind. Only safe when the downstream handler
+  /// chains of the individual streams are independent of each other (i.e. no
+  /// handler receives multiple streams of this demuxer).
+  void set_parallel_stream_dispatch(bool enabled) {
+    parallel_stream_dispatch_ = enabled;
+  }
+
+  /// Set the per-stream byte budget of the parallel dispatch queues. The
+  /// parser is throttled once a stream holds this many undispatched sample
+  /// bytes (the high watermark) and resumes below half of it (the low
+  /// watermark), so queue memory follows each stream's actual bitrate
+  /// instead of a fixed sample count. A value of zero keeps the built-in
+  /// default. Only meaningful with set_parallel_stream_dispatch().
+  void set_dispatch_buffer_bytes(uint64_t bytes) {
+    dispatch_buffer_bytes_ = bytes;
+  }
+
+  /// Attach the job's memory accounting. The parallel dispatch queues
+  /// register their queued sample bytes with @a memory_tracker, and while
+  /// the tracker reports pressure the parser is throttled at the low
+  /// watermark instead of the high one, shrinking this job's buffered
+  /// memory until the pressure clears. Must be called before Run().
+  void set_memory_tracker(std::shared_ptr<MemoryTracker> memory_tracker) {
+    memory_tracker_ = std::move(memory_tracker);
+  }
+
  protected:
   /// @name MediaHandler implementation overrides.
   /// @{
@@ -130,8 +167,58 @@ class Demuxer : public OriginHandler {
   // Read from the source and send it to the parser.
   Status Parse();
 
+  // One queued unit of work for parallel stream dispatch. Exactly one of the
+  // two sample pointers is set.
+  struct PendingSample {
+    std::shared_ptr<const MediaSample> media_sample;
+    std::shared_ptr<const TextSample> text_sample;
+  };
+  struct StreamDispatcher {
+    StreamDispatcher(size_t capacity,
+                     uint64_t high_watermark_bytes,
+                     MemoryTracker* memory_tracker);
+    ~StreamDispatcher();
+
+    // Producer-side byte accounting. Blocks once |queued_bytes| has reached
+    // the high watermark until the drain thread has taken it below the low
+    // watermark (or the dispatcher is stopped). Large video samples thus hit
+    // backpressure well before the sample-count bound, while audio queues no
+    // longer reserve hundreds of slots their bitrate cannot fill.
+    void AddBytes(uint64_t bytes);
+    // Drain-thread-side byte accounting.
+    void RemoveBytes(uint64_t bytes);
+    // Unblocks a throttled producer, for shutdown and dispatch errors.
+    void StopByteThrottling();
+
+    ProducerConsumerQueue<PendingSample> queue;
+    std::thread thread;
+    const uint64_t high_watermark_bytes;
+    const uint64_t low_watermark_bytes;
+    // Job-level accounting shared with the other queues of this pipeline;
+    // may be null. Owned by the Demuxer, which outlives its dispatchers.
+    MemoryTracker* const memory_tracker;
+    absl::Mutex mutex;
+    uint64_t queued_bytes ABSL_GUARDED_BY(mutex) = 0;
+    bool throttled ABSL_GUARDED_BY(mutex) = false;
+    bool stopped ABSL_GUARDED_BY(mutex) = false;
+  };
+
+  // Drains the dispatch queue of the stream at |stream_index| until it is
+  // stopped and empty.
+  void DispatchThreadMain(size_t stream_index, StreamDispatcher* dispatcher);
+  // Stops all dispatch queues (letting them drain), joins the threads and
+  // folds any dispatch errors into |dispatch_status_|.
+  void StopDispatchThreads();
+
   std::string file_name_;
   File* media_file_ = nullptr;
+  // Zero-copy read state. When the input file supports memory mapping (local
+  // VOD sources), Parse() feeds the parser directly from the mapped pages
+  // instead of copying through |buffer_|.
+  bool map_attempted_ = false;
+  const uint8_t* mapped_base_ = nullptr;
+  uint64_t mapped_size_ = 0;
+  uint64_t mapped_pos_ = 0;
   // A stream is considered ready after receiving the stream info.
   bool all_streams_ready_ = false;
   // Queued samples received in NewSampleEvent() before ParserInitEvent().
@@ -147,6 +234,10 @@ class Demuxer : public OriginHandler {
   std::map<size_t, std::string> language_overrides_;
   MediaContainerName container_name_ = CONTAINER_UNKNOWN;
   std::unique_ptr<uint8_t[]> buffer_;
+  // Per-call read size, set from the input's File::OptimalReadSize() hint in
+  // InitializeParser(): latency-bounded for live sources, pipelined for
+  // remote storage, a fixed default otherwise.
+  size_t read_size_ = 0;
   std::unique_ptr<KeySource> key_source_;
   bool cancelled_ = false;
   // Whether to dump stream info when it is received.
@@ -154,6 +245,18 @@ class Demuxer : public OriginHandler {
   Status init_event_status_;
   // Explicitly defined input format, for avoiding autodetection.
   std::string input_format_;
+
+  // Parallel stream dispatch state; see set_parallel_stream_dispatch().
+  bool parallel_stream_dispatch_ = false;
+  // Per-stream dispatch queue byte budget; see set_dispatch_buffer_bytes().
+  uint64_t dispatch_buffer_bytes_ = 0;
+  // Job-level memory accounting; see set_memory_tracker().
+  std::shared_ptr<MemoryTracker> memory_tracker_;
+  // StreamIndex -> dispatcher map, populated in ParserInitEvent.
+  std::map<size_t, std::unique_ptr<StreamDispatcher>> stream_dispatchers_;
+  absl::Mutex dispatch_status_mutex_;
+  // First error reported by any dispatch thread.
+  Status dispatch_status_ ABSL_GUARDED_BY(dispatch_status_mutex_);
 };
 
 }  // namespace media
@@ -0,0 +1,101 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/event/key_frame_index_muxer_listener.h>
+
+#include <memory>
+
+#include <absl/log/log.h>
+
+#include <packager/file.h>
+#include <packager/file/file_closer.h>
+#include <packager/media/base/buffer_writer.h>
+
+namespace shaka {
+namespace media {
+namespace {
+
+const uint8_t kIndexFileMagic[] = {'K', 'F', 'I', 'X'};
+const uint32_t kIndexFileVersion = 1;
+// Size of one key frame record: timestamp, start byte offset and size.
+const size_t kKeyFrameRecordSize = sizeof(int64_t) + 2 * sizeof(uint64_t);
+
+}  // namespace
+
+KeyFrameIndexMuxerListener::KeyFrameIndexMuxerListener(
+    const std::string& output_file_name)
+    : output_file_name_(output_file_name) {}
+
+KeyFrameIndexMuxerListener::~KeyFrameIndexMuxerListener() {}
+
+void KeyFrameIndexMuxerListener::OnEncryptionInfoReady(
+    bool /*is_initial_encryption_info*/,
+    FourCC /*protection_scheme*/,
+    const std::vector<uint8_t>& /*default_key_id*/,
+    const std::vector<uint8_t>& /*iv*/,
+    const std::vector<ProtectionSystemSpecificInfo>& /*key_system_info*/) {}
+
+void KeyFrameIndexMuxerListener::OnEncryptionStart() {}
+
+void KeyFrameIndexMuxerListener::OnMediaStart(
+    const MuxerOptions& /*muxer_options*/,
+    const StreamInfo& /*stream_info*/,
+    int32_t time_scale,
+    ContainerType /*container_type*/) {
+  time_scale_ = time_scale;
+}
+
+void KeyFrameIndexMuxerListener::OnSampleDurationReady(
+    int32_t /*sample_duration*/) {}
+
+void KeyFrameIndexMuxerListener::OnMediaEnd(const MediaRanges& /*media_ranges*/,
+                                            float /*duration_seconds*/) {
+  if (!WriteIndexFile()) {
+    LOG(ERROR) << "Failed to write key frame index to " << output_file_name_;
+  }
+}
+
+void KeyFrameIndexMuxerListener::OnNewSegment(const std::string& /*file_name*/,
+                                              int64_t /*start_time*/,
+                                              int64_t /*duration*/,
+                                              uint64_t /*segment_file_size*/) {}
+
+void KeyFrameIndexMuxerListener::OnKeyFrame(int64_t timestamp,
+                                            uint64_t start_byte_offset,
+                                            uint64_t size) {
+  key_frames_.push_back({timestamp, start_byte_offset, size});
+}
+
+void KeyFrameIndexMuxerListener::OnCueEvent(int64_t /*timestamp*/,
+                                            const std::string& /*cue_data*/) {}
+
+bool KeyFrameIndexMuxerListener::WriteIndexFile() {
+  BufferWriter writer(sizeof(kIndexFileMagic) + 2 * sizeof(uint32_t) +
+                      sizeof(uint64_t) +
+                      key_frames_.size() * kKeyFrameRecordSize);
+  writer.AppendArray(kIndexFileMagic, sizeof(kIndexFileMagic));
+  writer.AppendInt(kIndexFileVersion);
+  writer.AppendInt(static_cast<uint32_t>(time_scale_));
+  writer.AppendInt(static_cast<uint64_t>(key_frames_.size()));
+  for (const KeyFrameRecord& key_frame : key_frames_) {
+    writer.AppendInt(key_frame.timestamp);
+    writer.AppendInt(key_frame.start_byte_offset);
+    writer.AppendInt(key_frame.size);
+  }
+
+  std::unique_ptr<File, FileCloser> file(
+      File::Open(output_file_name_.c_str(), "w"));
+  if (!file) {
+    LOG(ERROR) << "Failed to open " << output_file_name_;
+    return false;
+  }
+  if (!writer.WriteToFile(file.get()).ok())
+    return false;
+  return file.release()->Close();
+}
+
+}  // namespace media
+}  // namespace shaka
@@ -0,0 +1,86 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+//
+// Implementation of MuxerListener that records the key frames of the muxed
+// stream and dumps them to a compact binary sidecar file, so later trick-play
+// or thumbnail packaging jobs can seek straight to key frames without
+// demuxing the rendition again.
+
+#ifndef PACKAGER_MEDIA_EVENT_KEY_FRAME_INDEX_MUXER_LISTENER_H_
+#define PACKAGER_MEDIA_EVENT_KEY_FRAME_INDEX_MUXER_LISTENER_H_
+
+#include <string>
+#include <vector>
+
+#include <packager/macros/classes.h>
+#include <packager/media/event/muxer_listener.h>
+
+namespace shaka {
+namespace media {
+
+/// MuxerListener that writes a key frame index sidecar when muxing finishes.
+///
+/// The file layout is big-endian:
+///   4 bytes  magic 'K' 'F' 'I' 'X'
+///   uint32   version (currently 1)
+///   uint32   timescale of the timestamps below
+///   uint64   number of key frames
+/// followed by one record per key frame:
+///   int64    timestamp, in the timescale above
+///   uint64   start byte offset in the media file
+///   uint64   size in bytes
+class KeyFrameIndexMuxerListener : public MuxerListener {
+ public:
+  explicit KeyFrameIndexMuxerListener(const std::string& output_file_name);
+  ~KeyFrameIndexMuxerListener() override;
+
+  /// @name MuxerListener implementation overrides.
+  /// @{
+  void OnEncryptionInfoReady(bool is_initial_encryption_info,
+                             FourCC protection_scheme,
+                             const std::vector<uint8_t>& default_key_id,
+                             const std::vector<uint8_t>& iv,
+                             const std::vector<ProtectionSystemSpecificInfo>&
+                                 key_system_info) override;
+  void OnEncryptionStart() override;
+  void OnMediaStart(const MuxerOptions& muxer_options,
+                    const StreamInfo& stream_info,
+                    int32_t time_scale,
+                    ContainerType container_type) override;
+  void OnSampleDurationReady(int32_t sample_duration) override;
+  void OnMediaEnd(const MediaRanges& media_ranges,
+                  float duration_seconds) override;
+  void OnNewSegment(const std::string& file_name,
+                    int64_t start_time,
+                    int64_t duration,
+                    uint64_t segment_file_size) override;
+  void OnKeyFrame(int64_t timestamp,
+                  uint64_t start_byte_offset,
+                  uint64_t size) override;
+  void OnCueEvent(int64_t timestamp, const std::string& cue_data) override;
+  /// @}
+
+ private:
+  struct KeyFrameRecord {
+    int64_t timestamp;
+    uint64_t start_byte_offset;
+    uint64_t size;
+  };
+
+  // Writes the index file. Returns false if the file could not be written.
+  bool WriteIndexFile();
+
+  const std::string output_file_name_;
+  int32_t time_scale_ = 0;
+  std::vector<KeyFrameRecord> key_frames_;
+
+  DISALLOW_COPY_AND_ASSIGN(KeyFrameIndexMuxerListener);
+};
+
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_MEDIA_EVENT_KEY_FRAME_INDEX_MUXER_LISTENER_H_
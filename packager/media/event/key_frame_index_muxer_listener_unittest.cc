@@ -0,0 +1,109 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/event/key_frame_index_muxer_listener.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <packager/file.h>
+#include <packager/media/base/buffer_reader.h>
+#include <packager/media/event/muxer_listener_test_helper.h>
+
+namespace shaka {
+namespace media {
+
+namespace {
+const char kOutputFileName[] = "memory://key_frame_index";
+const int32_t kReferenceTimeScale = 90000;
+}  // namespace
+
+class KeyFrameIndexMuxerListenerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    listener_.reset(new KeyFrameIndexMuxerListener(kOutputFileName));
+  }
+
+  void TearDown() override { File::Delete(kOutputFileName); }
+
+  void FireOnMediaStart() {
+    std::shared_ptr<StreamInfo> stream_info =
+        CreateVideoStreamInfo(GetDefaultVideoStreamInfoParams());
+    MuxerOptions muxer_options;
+    SetDefaultMuxerOptions(&muxer_options);
+    listener_->OnMediaStart(muxer_options, *stream_info, kReferenceTimeScale,
+                            MuxerListener::kContainerMp4);
+  }
+
+  void FireOnMediaEnd() {
+    listener_->OnMediaEnd(GetDefaultOnMediaEndParams().media_ranges,
+                          GetDefaultOnMediaEndParams().duration_seconds);
+  }
+
+  std::unique_ptr<KeyFrameIndexMuxerListener> listener_;
+};
+
+TEST_F(KeyFrameIndexMuxerListenerTest, WritesKeyFrameRecords) {
+  FireOnMediaStart();
+  listener_->OnKeyFrame(0, 100, 1000);
+  listener_->OnKeyFrame(180000, 5000, 2000);
+  FireOnMediaEnd();
+
+  std::string contents;
+  ASSERT_TRUE(File::ReadFileToString(kOutputFileName, &contents));
+
+  BufferReader reader(reinterpret_cast<const uint8_t*>(contents.data()),
+                      contents.size());
+  std::vector<uint8_t> magic;
+  ASSERT_TRUE(reader.ReadToVector(&magic, 4));
+  EXPECT_EQ(std::vector<uint8_t>({'K', 'F', 'I', 'X'}), magic);
+
+  uint32_t version = 0;
+  uint32_t time_scale = 0;
+  uint64_t num_key_frames = 0;
+  ASSERT_TRUE(reader.Read4(&version));
+  ASSERT_TRUE(reader.Read4(&time_scale));
+  ASSERT_TRUE(reader.Read8(&num_key_frames));
+  EXPECT_EQ(1u, version);
+  EXPECT_EQ(static_cast<uint32_t>(kReferenceTimeScale), time_scale);
+  ASSERT_EQ(2u, num_key_frames);
+
+  uint64_t timestamp = 0;
+  uint64_t start_byte_offset = 0;
+  uint64_t size = 0;
+  ASSERT_TRUE(reader.Read8(&timestamp));
+  ASSERT_TRUE(reader.Read8(&start_byte_offset));
+  ASSERT_TRUE(reader.Read8(&size));
+  EXPECT_EQ(0u, timestamp);
+  EXPECT_EQ(100u, start_byte_offset);
+  EXPECT_EQ(1000u, size);
+
+  ASSERT_TRUE(reader.Read8(&timestamp));
+  ASSERT_TRUE(reader.Read8(&start_byte_offset));
+  ASSERT_TRUE(reader.Read8(&size));
+  EXPECT_EQ(180000u, timestamp);
+  EXPECT_EQ(5000u, start_byte_offset);
+  EXPECT_EQ(2000u, size);
+
+  // No trailing bytes.
+  EXPECT_FALSE(reader.HasBytes(1));
+}
+
+TEST_F(KeyFrameIndexMuxerListenerTest, WritesEmptyIndexWithoutKeyFrames) {
+  FireOnMediaStart();
+  FireOnMediaEnd();
+
+  std::string contents;
+  ASSERT_TRUE(File::ReadFileToString(kOutputFileName, &contents));
+  // Magic, version, timescale and a zero key frame count.
+  EXPECT_EQ(4u + 4u + 4u + 8u, contents.size());
+}
+
+}  // namespace media
+}  // namespace shaka
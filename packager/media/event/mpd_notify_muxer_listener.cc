@@ -13,6 +13,7 @@
 
 #include <packager/macros/compiler.h>
 #include <packager/media/base/audio_stream_info.h>
+#include <packager/media/base/load_shedder.h>
 #include <packager/media/base/protection_system_specific_info.h>
 #include <packager/media/base/video_stream_info.h>
 #include <packager/media/event/muxer_listener_internal.h>
@@ -205,8 +206,17 @@ void MpdNotifyMuxerListener::OnNewSegment(const std::string& file_name,
   if (mpd_notifier_->dash_profile() == DashProfile::kLive) {
     mpd_notifier_->NotifyNewSegment(notification_id_.value(), start_time,
                                     duration, segment_file_size);
-    if (mpd_notifier_->mpd_type() == MpdType::kDynamic)
+    if (media_info_->reference_time_scale() > 0) {
+      LoadShedder::OnMediaPublished(
+          this, static_cast<double>(duration) /
+                    media_info_->reference_time_scale());
+    }
+    if (mpd_notifier_->mpd_type() == MpdType::kDynamic &&
+        !LoadShedder::ShouldShed(LoadShedder::Priority::kManifestFlush)) {
+      // A shed rewrite is batched: this segment is already recorded in the
+      // notifier and goes out with the next unshed flush.
       mpd_notifier_->Flush();
+    }
   } else {
     EventInfo event_info;
     event_info.type = EventInfoType::kSegment;
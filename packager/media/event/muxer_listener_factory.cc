@@ -15,9 +15,12 @@
 #include <packager/hls/base/hls_notifier.h>
 #include <packager/media/event/combined_muxer_listener.h>
 #include <packager/media/event/hls_notify_muxer_listener.h>
+#include <packager/media/event/key_frame_index_muxer_listener.h>
 #include <packager/media/event/mpd_notify_muxer_listener.h>
 #include <packager/media/event/multi_codec_muxer_listener.h>
 #include <packager/media/event/muxer_listener.h>
+#include <packager/media/event/segment_checkpoint_muxer_listener.h>
+#include <packager/media/event/segment_digest_muxer_listener.h>
 #include <packager/media/event/vod_media_info_dump_muxer_listener.h>
 #include <packager/mpd/base/mpd_notifier.h>
 
@@ -25,14 +28,17 @@ namespace shaka {
 namespace media {
 namespace {
 const char kMediaInfoSuffix[] = ".media_info";
+const char kKeyFrameIndexSuffix[] = ".key_frame_index";
+const char kSegmentDigestSuffix[] = ".sha256";
 
 std::unique_ptr<MuxerListener> CreateMediaInfoDumpListenerInternal(
     const std::string& output,
-    bool use_segment_list) {
+    bool use_segment_list,
+    bool use_binary_format) {
   DCHECK(!output.empty());
 
-  std::unique_ptr<MuxerListener> listener(
-      new VodMediaInfoDumpMuxerListener(output + kMediaInfoSuffix, use_segment_list));
+  std::unique_ptr<MuxerListener> listener(new VodMediaInfoDumpMuxerListener(
+      output + kMediaInfoSuffix, use_segment_list, use_binary_format));
   return listener;
 }
 
@@ -89,10 +95,18 @@ std::list<std::unique_ptr<MuxerListener>> CreateHlsListenersInternal(
 MuxerListenerFactory::MuxerListenerFactory(bool output_media_info,
                                            bool use_segment_list,
                                            MpdNotifier* mpd_notifier,
-                                           hls::HlsNotifier* hls_notifier)
+                                           hls::HlsNotifier* hls_notifier,
+                                           SegmentCheckpoint* segment_checkpoint,
+                                           bool output_key_frame_index,
+                                           bool output_media_info_binary,
+                                           bool output_segment_digests)
     : output_media_info_(output_media_info),
+      output_media_info_binary_(output_media_info_binary),
       mpd_notifier_(mpd_notifier),
       hls_notifier_(hls_notifier),
+      segment_checkpoint_(segment_checkpoint),
+      output_key_frame_index_(output_key_frame_index),
+      output_segment_digests_(output_segment_digests),
       use_segment_list_(use_segment_list) {}
 
 std::unique_ptr<MuxerListener> MuxerListenerFactory::CreateListener(
@@ -111,9 +125,9 @@ std::unique_ptr<MuxerListener> MuxerListenerFactory::CreateListener(
     std::unique_ptr<CombinedMuxerListener> combined_listener(
         new CombinedMuxerListener);
     if (output_media_info_) {
-      combined_listener->AddListener(
-          CreateMediaInfoDumpListenerInternal(stream.media_info_output,
-                                              use_segment_list_));
+      combined_listener->AddListener(CreateMediaInfoDumpListenerInternal(
+          stream.media_info_output, use_segment_list_,
+          output_media_info_binary_));
     }
 
     if (mpd_notifier_ && !stream.hls_only) {
@@ -128,6 +142,24 @@ std::unique_ptr<MuxerListener> MuxerListenerFactory::CreateListener(
       }
     }
 
+    if (segment_checkpoint_) {
+      combined_listener->AddListener(
+          std::make_unique<SegmentCheckpointMuxerListener>(
+              segment_checkpoint_));
+    }
+
+    if (output_key_frame_index_ && !stream.media_info_output.empty()) {
+      combined_listener->AddListener(
+          std::make_unique<KeyFrameIndexMuxerListener>(
+              stream.media_info_output + kKeyFrameIndexSuffix));
+    }
+
+    if (output_segment_digests_ && !stream.media_info_output.empty()) {
+      combined_listener->AddListener(
+          std::make_unique<SegmentDigestMuxerListener>(
+              stream.media_info_output + kSegmentDigestSuffix));
+    }
+
     multi_codec_listener->AddListener(std::move(combined_listener));
   }
 
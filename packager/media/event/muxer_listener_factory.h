@@ -21,6 +21,7 @@ class HlsNotifier;
 
 namespace media {
 class MuxerListener;
+class SegmentCheckpoint;
 
 /// Factory class for creating MuxerListeners. Will produce a single muxer
 /// listener that will wrap the various muxer listeners that the factory
@@ -37,7 +38,7 @@ class MuxerListenerFactory {
   /// factory needs in order to create listeners for the stream.
   struct StreamData {
     // The stream's output destination. Will only be used if the factory is
-    // told to output media info.
+    // told to output media info or a key frame index.
     std::string media_info_output;
 
     // Explicit input format, for avoiding autodetection when needed.
@@ -73,10 +74,27 @@ class MuxerListenerFactory {
   ///        mpd listener.
   /// @param hls_notifier must be non-null for the combined listener to include
   ///        an HLS listener.
+  /// @param segment_checkpoint, when non-null, makes the combined listener
+  ///        record live packaging positions after every segment. Must outlive
+  ///        the created listeners.
+  /// @param output_key_frame_index, when true, makes the combined listener
+  ///        dump a binary key frame index sidecar (suffixed with
+  ///        `.key_frame_index`) next to each stream output.
+  /// @param output_media_info_binary, when true, makes the media info dump
+  ///        listener write protobuf binary wire format instead of text
+  ///        format.
+  /// @param output_segment_digests, when true, makes the combined listener
+  ///        record the SHA-256 digest of every finalized segment in a
+  ///        sha256sum-compatible sidecar (suffixed with `.sha256`) next to
+  ///        each stream output. Requires HashingFile to be enabled.
   MuxerListenerFactory(bool output_media_info,
                        bool use_segment_list,
                        MpdNotifier* mpd_notifier,
-                       hls::HlsNotifier* hls_notifier);
+                       hls::HlsNotifier* hls_notifier,
+                       SegmentCheckpoint* segment_checkpoint = nullptr,
+                       bool output_key_frame_index = false,
+                       bool output_media_info_binary = false,
+                       bool output_segment_digests = false);
 
   /// Create a listener for a stream.
   std::unique_ptr<MuxerListener> CreateListener(const StreamData& stream);
@@ -90,8 +108,12 @@ class MuxerListenerFactory {
   MuxerListenerFactory operator=(const MuxerListenerFactory&) = delete;
 
   bool output_media_info_;
+  bool output_media_info_binary_;
   MpdNotifier* mpd_notifier_;
   hls::HlsNotifier* hls_notifier_;
+  SegmentCheckpoint* segment_checkpoint_;
+  bool output_key_frame_index_;
+  bool output_segment_digests_;
 
   /// This is set when mpd_notifier_ is NULL and --output_media_info is set.
   bool use_segment_list_;
@@ -0,0 +1,69 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/event/progress_aggregator.h>
+
+#include <algorithm>
+
+namespace shaka {
+namespace media {
+
+ProgressAggregator* ProgressAggregator::Instance() {
+  static ProgressAggregator instance;
+  return &instance;
+}
+
+ProgressAggregator::ProgressAggregator()
+    : start_time_(std::chrono::steady_clock::now()) {}
+
+void ProgressAggregator::Reset() {
+  absl::MutexLock lock(&mutex_);
+  slots_.clear();
+  start_time_ = std::chrono::steady_clock::now();
+}
+
+std::unique_ptr<ProgressListener> ProgressAggregator::CreateListener() {
+  // Not make_shared: Slot is over-aligned and C++17 make_shared does not
+  // honor the alignment.
+  std::shared_ptr<Slot> slot(new Slot);
+  absl::MutexLock lock(&mutex_);
+  slots_.push_back(slot);
+  return std::unique_ptr<ProgressListener>(new SlotListener(std::move(slot)));
+}
+
+double ProgressAggregator::GetProgress() const {
+  absl::MutexLock lock(&mutex_);
+  if (slots_.empty())
+    return 0.0;
+  uint64_t total_ppm = 0;
+  for (const std::shared_ptr<Slot>& slot : slots_)
+    total_ppm += slot->progress_ppm.load(std::memory_order_relaxed);
+  return static_cast<double>(total_ppm) / slots_.size() / 1e6;
+}
+
+double ProgressAggregator::GetEtaSeconds() const {
+  double elapsed_seconds;
+  {
+    absl::MutexLock lock(&mutex_);
+    elapsed_seconds = std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - start_time_)
+                          .count();
+  }
+  const double progress = GetProgress();
+  if (progress <= 0.0)
+    return -1.0;
+  return elapsed_seconds * (1.0 - progress) / progress;
+}
+
+void ProgressAggregator::SlotListener::OnProgress(double progress) {
+  // Clamp: segmenters may slightly overshoot their progress target.
+  const double clamped = std::min(std::max(progress, 0.0), 1.0);
+  slot_->progress_ppm.store(static_cast<uint64_t>(clamped * 1e6),
+                            std::memory_order_relaxed);
+}
+
+}  // namespace media
+}  // namespace shaka
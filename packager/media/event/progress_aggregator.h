@@ -0,0 +1,89 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_MEDIA_EVENT_PROGRESS_AGGREGATOR_H_
+#define PACKAGER_MEDIA_EVENT_PROGRESS_AGGREGATOR_H_
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include <absl/base/thread_annotations.h>
+#include <absl/synchronization/mutex.h>
+
+#include <packager/macros/classes.h>
+#include <packager/media/event/progress_listener.h>
+
+namespace shaka {
+namespace media {
+
+/// Process-wide lock-free progress aggregation. Every muxer publishes its
+/// normalized progress through a ProgressListener from CreateListener(); each
+/// listener owns a cache-line sized slot, and OnProgress() is a single
+/// relaxed atomic store, so external pollers reading GetProgress() at a high
+/// rate never contend with the muxing threads. The mutex only guards slot
+/// creation and job reset, both cold paths.
+class ProgressAggregator {
+ public:
+  static ProgressAggregator* Instance();
+
+  /// Forgets the slots of the previous job and restarts the ETA clock.
+  /// Called when a new packaging job is initialized. Listeners handed out
+  /// before the reset share ownership of their slots, so they stay safe to
+  /// use (e.g. by a concurrently running Packager instance); they merely
+  /// stop contributing to the aggregate.
+  void Reset();
+
+  /// @return a listener that publishes into a dedicated slot of this
+  ///         aggregator. The slot stays part of the aggregate (at its final
+  ///         value) after the listener is destroyed, until the next Reset().
+  std::unique_ptr<ProgressListener> CreateListener();
+
+  /// @return the mean progress over all slots, in [0, 1]. 0 if no listener
+  ///         has been created since the last Reset().
+  double GetProgress() const;
+
+  /// @return the estimated remaining time in seconds, extrapolated from the
+  ///         wall clock time elapsed since the last Reset() and
+  ///         GetProgress(). Negative if there is no progress to extrapolate
+  ///         from yet.
+  double GetEtaSeconds() const;
+
+ private:
+  ProgressAggregator();
+  ~ProgressAggregator() = default;
+
+  // One muxer's progress in parts per million, padded so slots written by
+  // different muxing threads never share a cache line.
+  struct alignas(64) Slot {
+    std::atomic<uint64_t> progress_ppm{0};
+  };
+
+  class SlotListener : public ProgressListener {
+   public:
+    explicit SlotListener(std::shared_ptr<Slot> slot)
+        : slot_(std::move(slot)) {}
+    void OnProgress(double progress) override;
+
+   private:
+    const std::shared_ptr<Slot> slot_;
+  };
+
+  mutable absl::Mutex mutex_;
+  // Ownership is shared with the listeners: Reset() only drops the
+  // aggregator's references, so a listener from an earlier job keeps a live
+  // slot to write into instead of a dangling pointer.
+  std::vector<std::shared_ptr<Slot>> slots_ ABSL_GUARDED_BY(mutex_);
+  std::chrono::steady_clock::time_point start_time_ ABSL_GUARDED_BY(mutex_);
+
+  DISALLOW_COPY_AND_ASSIGN(ProgressAggregator);
+};
+
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_MEDIA_EVENT_PROGRESS_AGGREGATOR_H_
@@ -0,0 +1,71 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/event/progress_aggregator.h>
+
+#include <gtest/gtest.h>
+
+namespace shaka {
+namespace media {
+
+class ProgressAggregatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override { ProgressAggregator::Instance()->Reset(); }
+};
+
+TEST_F(ProgressAggregatorTest, NoListeners) {
+  EXPECT_EQ(0.0, ProgressAggregator::Instance()->GetProgress());
+  EXPECT_LT(ProgressAggregator::Instance()->GetEtaSeconds(), 0.0);
+}
+
+TEST_F(ProgressAggregatorTest, AveragesOverListeners) {
+  ProgressAggregator* aggregator = ProgressAggregator::Instance();
+  std::unique_ptr<ProgressListener> first = aggregator->CreateListener();
+  std::unique_ptr<ProgressListener> second = aggregator->CreateListener();
+
+  EXPECT_EQ(0.0, aggregator->GetProgress());
+  first->OnProgress(0.5);
+  second->OnProgress(1.0);
+  EXPECT_DOUBLE_EQ(0.75, aggregator->GetProgress());
+  EXPECT_GE(aggregator->GetEtaSeconds(), 0.0);
+}
+
+TEST_F(ProgressAggregatorTest, SlotOutlivesListener) {
+  ProgressAggregator* aggregator = ProgressAggregator::Instance();
+  std::unique_ptr<ProgressListener> listener = aggregator->CreateListener();
+  listener->OnProgress(1.0);
+  listener.reset();
+  // A finished muxer keeps contributing its final progress until the next
+  // job resets the aggregator.
+  EXPECT_DOUBLE_EQ(1.0, aggregator->GetProgress());
+}
+
+TEST_F(ProgressAggregatorTest, ListenerFromPreviousJobSafeAfterReset) {
+  ProgressAggregator* aggregator = ProgressAggregator::Instance();
+  std::unique_ptr<ProgressListener> stale = aggregator->CreateListener();
+
+  // Another Packager instance initializing resets the aggregator while the
+  // first instance's muxers still hold their listeners. Those listeners must
+  // keep a live slot to write into; they just stop contributing.
+  aggregator->Reset();
+  stale->OnProgress(0.5);
+  EXPECT_EQ(0.0, aggregator->GetProgress());
+
+  std::unique_ptr<ProgressListener> current = aggregator->CreateListener();
+  current->OnProgress(1.0);
+  stale->OnProgress(0.25);
+  EXPECT_DOUBLE_EQ(1.0, aggregator->GetProgress());
+}
+
+TEST_F(ProgressAggregatorTest, OvershootIsClamped) {
+  ProgressAggregator* aggregator = ProgressAggregator::Instance();
+  std::unique_ptr<ProgressListener> listener = aggregator->CreateListener();
+  listener->OnProgress(1.2);
+  EXPECT_DOUBLE_EQ(1.0, aggregator->GetProgress());
+}
+
+}  // namespace media
+}  // namespace shaka
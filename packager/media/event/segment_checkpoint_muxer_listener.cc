@@ -0,0 +1,139 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/event/segment_checkpoint_muxer_listener.h>
+
+#include <cinttypes>
+
+#include <absl/log/log.h>
+#include <absl/strings/numbers.h>
+#include <absl/strings/str_format.h>
+#include <absl/strings/str_split.h>
+
+#include <packager/file.h>
+#include <packager/media/base/muxer_options.h>
+
+namespace shaka {
+namespace media {
+namespace {
+
+// Comment lines start with '#'; every other line is
+//   next_segment_number <value> <segment_template>
+// The segment template comes last since it may contain spaces.
+const char kCheckpointHeader[] = "# packager live checkpoint v1\n";
+const char kNextSegmentNumberKey[] = "next_segment_number";
+
+}  // namespace
+
+SegmentCheckpoint::SegmentCheckpoint(const std::string& file_path)
+    : file_path_(file_path) {}
+
+Status SegmentCheckpoint::LoadFrom(const std::string& file_path) {
+  std::string contents;
+  if (!File::ReadFileToString(file_path.c_str(), &contents)) {
+    return Status(error::FILE_FAILURE,
+                  "Cannot read checkpoint file " + file_path);
+  }
+
+  absl::MutexLock lock(&mutex_);
+  for (absl::string_view line : absl::StrSplit(contents, '\n')) {
+    if (line.empty() || line[0] == '#')
+      continue;
+    const std::vector<absl::string_view> fields =
+        absl::StrSplit(line, absl::MaxSplits(' ', 2));
+    uint64_t next_segment_number = 0;
+    if (fields.size() != 3 || fields[0] != kNextSegmentNumberKey ||
+        !absl::SimpleAtoi(fields[1], &next_segment_number)) {
+      return Status(error::INVALID_ARGUMENT,
+                    "Malformed line in checkpoint file " + file_path + ": " +
+                        std::string(line));
+    }
+    next_segment_numbers_[std::string(fields[2])] = next_segment_number;
+  }
+  return Status::OK;
+}
+
+uint64_t SegmentCheckpoint::GetNextSegmentNumber(
+    const std::string& segment_template) const {
+  absl::MutexLock lock(&mutex_);
+  auto it = next_segment_numbers_.find(segment_template);
+  return it == next_segment_numbers_.end() ? 0 : it->second;
+}
+
+void SegmentCheckpoint::SetNextSegmentNumber(
+    const std::string& segment_template,
+    uint64_t next_segment_number) {
+  absl::MutexLock lock(&mutex_);
+  next_segment_numbers_[segment_template] = next_segment_number;
+  Write();
+}
+
+void SegmentCheckpoint::Write() {
+  if (file_path_.empty())
+    return;
+  std::string contents(kCheckpointHeader);
+  for (const auto& entry : next_segment_numbers_) {
+    absl::StrAppendFormat(&contents, "%s %" PRIu64 " %s\n",
+                          kNextSegmentNumberKey, entry.second, entry.first);
+  }
+  // A failed write only costs the restart position, not the running job, so
+  // it is logged instead of failing the pipeline.
+  if (!File::WriteStringToFile(file_path_.c_str(), contents))
+    LOG(WARNING) << "Failed to write checkpoint file " << file_path_;
+}
+
+SegmentCheckpointMuxerListener::SegmentCheckpointMuxerListener(
+    SegmentCheckpoint* checkpoint)
+    : checkpoint_(checkpoint) {}
+
+void SegmentCheckpointMuxerListener::OnEncryptionInfoReady(
+    bool /*is_initial_encryption_info*/,
+    FourCC /*protection_scheme*/,
+    const std::vector<uint8_t>& /*key_id*/,
+    const std::vector<uint8_t>& /*iv*/,
+    const std::vector<ProtectionSystemSpecificInfo>& /*key_system_info*/) {}
+
+void SegmentCheckpointMuxerListener::OnEncryptionStart() {}
+
+void SegmentCheckpointMuxerListener::OnMediaStart(
+    const MuxerOptions& muxer_options,
+    const StreamInfo& /*stream_info*/,
+    int32_t /*time_scale*/,
+    ContainerType /*container_type*/) {
+  segment_template_ = muxer_options.segment_template;
+  next_segment_number_ = muxer_options.initial_segment_number;
+}
+
+void SegmentCheckpointMuxerListener::OnSampleDurationReady(
+    int32_t /*sample_duration*/) {}
+
+void SegmentCheckpointMuxerListener::OnMediaEnd(
+    const MediaRanges& /*media_ranges*/,
+    float /*duration_seconds*/) {}
+
+void SegmentCheckpointMuxerListener::OnNewSegment(
+    const std::string& /*segment_name*/,
+    int64_t /*start_time*/,
+    int64_t /*duration*/,
+    uint64_t /*segment_file_size*/) {
+  // Without a segment template there are no numbered segments to resume;
+  // OnNewSegment then signals subsegments of a single output file.
+  if (segment_template_.empty())
+    return;
+  ++next_segment_number_;
+  checkpoint_->SetNextSegmentNumber(segment_template_, next_segment_number_);
+}
+
+void SegmentCheckpointMuxerListener::OnKeyFrame(int64_t /*timestamp*/,
+                                                uint64_t /*start_byte_offset*/,
+                                                uint64_t /*size*/) {}
+
+void SegmentCheckpointMuxerListener::OnCueEvent(
+    int64_t /*timestamp*/,
+    const std::string& /*cue_data*/) {}
+
+}  // namespace media
+}  // namespace shaka
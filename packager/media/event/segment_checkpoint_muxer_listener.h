@@ -0,0 +1,107 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_MEDIA_EVENT_SEGMENT_CHECKPOINT_MUXER_LISTENER_H_
+#define PACKAGER_MEDIA_EVENT_SEGMENT_CHECKPOINT_MUXER_LISTENER_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include <absl/synchronization/mutex.h>
+
+#include <packager/media/event/muxer_listener.h>
+#include <packager/status.h>
+
+namespace shaka {
+namespace media {
+
+/// Records live packaging positions - the next $Number$ of every stream with a
+/// segment template - in a small text file, so a restarted packager can
+/// continue segment numbering at the live edge instead of starting over.
+/// One instance is shared by all streams of a packaging job.
+class SegmentCheckpoint {
+ public:
+  /// @param file_path is where checkpoints are written. If empty, positions
+  ///        are tracked but never persisted (restore-only use).
+  explicit SegmentCheckpoint(const std::string& file_path);
+
+  /// Load positions from a checkpoint file written by a previous run.
+  /// @return error if the file cannot be read or parsed.
+  Status LoadFrom(const std::string& file_path);
+
+  /// @return the recorded next segment number for @a segment_template, or 0
+  ///         if the stream has no recorded position.
+  uint64_t GetNextSegmentNumber(const std::string& segment_template) const;
+
+  /// Record that the next segment of @a segment_template will be
+  /// @a next_segment_number and rewrite the checkpoint file.
+  void SetNextSegmentNumber(const std::string& segment_template,
+                            uint64_t next_segment_number);
+
+ private:
+  SegmentCheckpoint(const SegmentCheckpoint&) = delete;
+  SegmentCheckpoint& operator=(const SegmentCheckpoint&) = delete;
+
+  // Serialize all positions to |file_path_|, if set.
+  void Write() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const std::string file_path_;
+  mutable absl::Mutex mutex_;
+  std::map<std::string, uint64_t> next_segment_numbers_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+/// MuxerListener that feeds a shared SegmentCheckpoint: it counts finalized
+/// segments of its stream, starting from the resumed position in
+/// MuxerOptions, and records the updated position after every segment.
+class SegmentCheckpointMuxerListener : public MuxerListener {
+ public:
+  /// @param checkpoint must outlive this listener. Shared with the listeners
+  ///        of the other streams.
+  explicit SegmentCheckpointMuxerListener(SegmentCheckpoint* checkpoint);
+
+  /// @name MuxerListener implementation overrides.
+  /// @{
+  void OnEncryptionInfoReady(bool is_initial_encryption_info,
+                             FourCC protection_scheme,
+                             const std::vector<uint8_t>& key_id,
+                             const std::vector<uint8_t>& iv,
+                             const std::vector<ProtectionSystemSpecificInfo>&
+                                 key_system_info) override;
+  void OnEncryptionStart() override;
+  void OnMediaStart(const MuxerOptions& muxer_options,
+                    const StreamInfo& stream_info,
+                    int32_t time_scale,
+                    ContainerType container_type) override;
+  void OnSampleDurationReady(int32_t sample_duration) override;
+  void OnMediaEnd(const MediaRanges& media_ranges,
+                  float duration_seconds) override;
+  void OnNewSegment(const std::string& segment_name,
+                    int64_t start_time,
+                    int64_t duration,
+                    uint64_t segment_file_size) override;
+  void OnKeyFrame(int64_t timestamp,
+                  uint64_t start_byte_offset,
+                  uint64_t size) override;
+  void OnCueEvent(int64_t timestamp, const std::string& cue_data) override;
+  /// @}
+
+ private:
+  SegmentCheckpointMuxerListener(const SegmentCheckpointMuxerListener&) =
+      delete;
+  SegmentCheckpointMuxerListener& operator=(
+      const SegmentCheckpointMuxerListener&) = delete;
+
+  SegmentCheckpoint* const checkpoint_;
+  std::string segment_template_;
+  uint64_t next_segment_number_ = 0;
+};
+
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_MEDIA_EVENT_SEGMENT_CHECKPOINT_MUXER_LISTENER_H_
@@ -0,0 +1,50 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/event/segment_checkpoint_muxer_listener.h>
+
+#include <gtest/gtest.h>
+
+#include <packager/file.h>
+
+namespace shaka {
+namespace media {
+namespace {
+const char kCheckpointFile[] = "memory://checkpoint_test/checkpoint";
+const char kSegmentTemplate[] = "video_$Number$.m4s";
+const char kOtherSegmentTemplate[] = "audio_$Number$.m4s";
+}  // namespace
+
+TEST(SegmentCheckpointTest, RoundTripsPositions) {
+  {
+    SegmentCheckpoint checkpoint(kCheckpointFile);
+    checkpoint.SetNextSegmentNumber(kSegmentTemplate, 42);
+    checkpoint.SetNextSegmentNumber(kOtherSegmentTemplate, 7);
+  }
+
+  SegmentCheckpoint restored("");
+  ASSERT_EQ(Status::OK, restored.LoadFrom(kCheckpointFile));
+  EXPECT_EQ(42u, restored.GetNextSegmentNumber(kSegmentTemplate));
+  EXPECT_EQ(7u, restored.GetNextSegmentNumber(kOtherSegmentTemplate));
+  EXPECT_EQ(0u, restored.GetNextSegmentNumber("unknown_$Number$.m4s"));
+}
+
+TEST(SegmentCheckpointTest, LoadFromMissingFileFails) {
+  SegmentCheckpoint checkpoint("");
+  EXPECT_NE(Status::OK,
+            checkpoint.LoadFrom("memory://checkpoint_test/does_not_exist"));
+}
+
+TEST(SegmentCheckpointTest, LoadFromMalformedFileFails) {
+  const char kMalformedFile[] = "memory://checkpoint_test/malformed";
+  ASSERT_TRUE(File::WriteStringToFile(kMalformedFile, "not a checkpoint\n"));
+
+  SegmentCheckpoint checkpoint("");
+  EXPECT_NE(Status::OK, checkpoint.LoadFrom(kMalformedFile));
+}
+
+}  // namespace media
+}  // namespace shaka
@@ -0,0 +1,86 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/event/segment_digest_muxer_listener.h>
+
+#include <memory>
+
+#include <absl/log/log.h>
+
+#include <packager/file.h>
+#include <packager/file/file_closer.h>
+#include <packager/file/hashing_file.h>
+
+namespace shaka {
+namespace media {
+
+SegmentDigestMuxerListener::SegmentDigestMuxerListener(
+    const std::string& output_file_name)
+    : output_file_name_(output_file_name) {}
+
+SegmentDigestMuxerListener::~SegmentDigestMuxerListener() {}
+
+void SegmentDigestMuxerListener::OnEncryptionInfoReady(
+    bool /*is_initial_encryption_info*/,
+    FourCC /*protection_scheme*/,
+    const std::vector<uint8_t>& /*default_key_id*/,
+    const std::vector<uint8_t>& /*iv*/,
+    const std::vector<ProtectionSystemSpecificInfo>& /*key_system_info*/) {}
+
+void SegmentDigestMuxerListener::OnEncryptionStart() {}
+
+void SegmentDigestMuxerListener::OnMediaStart(
+    const MuxerOptions& /*muxer_options*/,
+    const StreamInfo& /*stream_info*/,
+    int32_t /*time_scale*/,
+    ContainerType /*container_type*/) {}
+
+void SegmentDigestMuxerListener::OnSampleDurationReady(
+    int32_t /*sample_duration*/) {}
+
+void SegmentDigestMuxerListener::OnMediaEnd(const MediaRanges& /*media_ranges*/,
+                                            float /*duration_seconds*/) {}
+
+void SegmentDigestMuxerListener::OnNewSegment(
+    const std::string& file_name,
+    int64_t /*start_time*/,
+    int64_t /*duration*/,
+    uint64_t /*segment_file_size*/) {
+  std::string sha256_hex;
+  // No digest is recorded for subsegment notifications (they name the
+  // containing file, which is still open) and for files that were not
+  // written front to back; both are simply skipped.
+  if (!HashingFile::TakeDigest(file_name, &sha256_hex))
+    return;
+
+  digest_lines_ += sha256_hex + "  " + file_name + "\n";
+  if (!WriteDigestFile() && !write_error_logged_) {
+    LOG(ERROR) << "Failed to record segment digests in " << output_file_name_;
+    write_error_logged_ = true;
+  }
+}
+
+void SegmentDigestMuxerListener::OnKeyFrame(int64_t /*timestamp*/,
+                                            uint64_t /*start_byte_offset*/,
+                                            uint64_t /*size*/) {}
+
+void SegmentDigestMuxerListener::OnCueEvent(int64_t /*timestamp*/,
+                                            const std::string& /*cue_data*/) {}
+
+bool SegmentDigestMuxerListener::WriteDigestFile() {
+  std::unique_ptr<File, FileCloser> file(
+      File::Open(output_file_name_.c_str(), "w"));
+  if (!file)
+    return false;
+  if (file->Write(digest_lines_.data(), digest_lines_.size()) !=
+      static_cast<int64_t>(digest_lines_.size())) {
+    return false;
+  }
+  return file.release()->Close();
+}
+
+}  // namespace media
+}  // namespace shaka
@@ -0,0 +1,81 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+//
+// Implementation of MuxerListener that records the SHA-256 digest of every
+// finalized media segment in a sha256sum(1)-compatible sidecar file, so an
+// origin can verify checksummed uploads without ever re-reading a segment.
+
+#ifndef PACKAGER_MEDIA_EVENT_SEGMENT_DIGEST_MUXER_LISTENER_H_
+#define PACKAGER_MEDIA_EVENT_SEGMENT_DIGEST_MUXER_LISTENER_H_
+
+#include <string>
+#include <vector>
+
+#include <packager/macros/classes.h>
+#include <packager/media/event/muxer_listener.h>
+
+namespace shaka {
+namespace media {
+
+/// MuxerListener that records one `<hex digest>  <segment name>` line per
+/// finalized segment in a sidecar file. The sidecar is rewritten after every
+/// segment, so it is always a complete listing (and works for destinations
+/// without append support, e.g. HTTP uploads). The digests are computed
+/// inline by the File write path (see HashingFile), which must be enabled
+/// for the whole process; this listener only claims and records them.
+/// Segments that were not written front to back (e.g. a single-file output
+/// finalized with backpatching seeks) have no valid linear digest and are
+/// skipped.
+class SegmentDigestMuxerListener : public MuxerListener {
+ public:
+  explicit SegmentDigestMuxerListener(const std::string& output_file_name);
+  ~SegmentDigestMuxerListener() override;
+
+  /// @name MuxerListener implementation overrides.
+  /// @{
+  void OnEncryptionInfoReady(bool is_initial_encryption_info,
+                             FourCC protection_scheme,
+                             const std::vector<uint8_t>& default_key_id,
+                             const std::vector<uint8_t>& iv,
+                             const std::vector<ProtectionSystemSpecificInfo>&
+                                 key_system_info) override;
+  void OnEncryptionStart() override;
+  void OnMediaStart(const MuxerOptions& muxer_options,
+                    const StreamInfo& stream_info,
+                    int32_t time_scale,
+                    ContainerType container_type) override;
+  void OnSampleDurationReady(int32_t sample_duration) override;
+  void OnMediaEnd(const MediaRanges& media_ranges,
+                  float duration_seconds) override;
+  void OnNewSegment(const std::string& file_name,
+                    int64_t start_time,
+                    int64_t duration,
+                    uint64_t segment_file_size) override;
+  void OnKeyFrame(int64_t timestamp,
+                  uint64_t start_byte_offset,
+                  uint64_t size) override;
+  void OnCueEvent(int64_t timestamp, const std::string& cue_data) override;
+  /// @}
+
+ private:
+  // Rewrites the sidecar file from |digest_lines_|. Returns false if it
+  // could not be written.
+  bool WriteDigestFile();
+
+  const std::string output_file_name_;
+  // One sha256sum-format line per recorded segment, in segment order.
+  std::string digest_lines_;
+  // Set after the first failed write, so a broken sidecar destination is
+  // reported once instead of once per segment.
+  bool write_error_logged_ = false;
+
+  DISALLOW_COPY_AND_ASSIGN(SegmentDigestMuxerListener);
+};
+
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_MEDIA_EVENT_SEGMENT_DIGEST_MUXER_LISTENER_H_
@@ -0,0 +1,102 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/event/segment_fan_out_muxer_listener.h>
+
+#include <absl/log/log.h>
+
+#include <packager/file.h>
+#include <packager/media/base/muxer_options.h>
+
+namespace shaka {
+namespace media {
+
+SegmentFanOutMuxerListener::SegmentFanOutMuxerListener(
+    const std::string& output,
+    const std::string& segment_template)
+    : output_(output), segment_template_(segment_template) {}
+
+SegmentFanOutMuxerListener::~SegmentFanOutMuxerListener() {}
+
+void SegmentFanOutMuxerListener::OnEncryptionInfoReady(
+    bool /*is_initial_encryption_info*/,
+    FourCC /*protection_scheme*/,
+    const std::vector<uint8_t>& /*default_key_id*/,
+    const std::vector<uint8_t>& /*iv*/,
+    const std::vector<ProtectionSystemSpecificInfo>& /*key_system_info*/) {}
+
+void SegmentFanOutMuxerListener::OnEncryptionStart() {}
+
+void SegmentFanOutMuxerListener::OnMediaStart(const MuxerOptions& muxer_options,
+                                              const StreamInfo& /*stream_info*/,
+                                              int32_t /*time_scale*/,
+                                              ContainerType /*container_type*/) {
+  primary_output_name_ = muxer_options.output_file_name;
+  segment_index_ = muxer_options.initial_segment_number;
+  bandwidth_ = muxer_options.bandwidth;
+  if (!segment_template_.empty()) {
+    const Status status = compiled_template_.Compile(segment_template_);
+    if (!status.ok()) {
+      LOG(ERROR) << "Invalid fan-out segment template '" << segment_template_
+                 << "': " << status << "; fan-out is disabled for this stream.";
+      failed_ = true;
+      return;
+    }
+    template_compiled_ = true;
+  }
+}
+
+void SegmentFanOutMuxerListener::OnSampleDurationReady(
+    int32_t /*sample_duration*/) {}
+
+void SegmentFanOutMuxerListener::OnMediaEnd(const MediaRanges& /*media_ranges*/,
+                                            float /*duration_seconds*/) {
+  // For non-segmented output the file only becomes complete here.
+  if (segment_template_.empty() && !output_.empty() &&
+      !primary_output_name_.empty()) {
+    Copy(primary_output_name_, output_);
+  }
+}
+
+void SegmentFanOutMuxerListener::OnNewSegment(const std::string& segment_name,
+                                              int64_t start_time,
+                                              int64_t /*duration*/,
+                                              uint64_t /*segment_file_size*/) {
+  if (!template_compiled_)
+    return;
+  // The init segment is fully written by the time the first media segment is
+  // finalized.
+  if (!init_segment_copied_) {
+    init_segment_copied_ = true;
+    if (!output_.empty() && !primary_output_name_.empty())
+      Copy(primary_output_name_, output_);
+  }
+  Copy(segment_name,
+       compiled_template_.Apply(start_time,
+                                static_cast<uint32_t>(segment_index_++),
+                                bandwidth_));
+}
+
+void SegmentFanOutMuxerListener::OnKeyFrame(int64_t /*timestamp*/,
+                                            uint64_t /*start_byte_offset*/,
+                                            uint64_t /*size*/) {}
+
+void SegmentFanOutMuxerListener::OnCueEvent(int64_t /*timestamp*/,
+                                            const std::string& /*cue_data*/) {}
+
+void SegmentFanOutMuxerListener::Copy(const std::string& from,
+                                      const std::string& to) {
+  if (failed_)
+    return;
+  if (!File::Copy(from.c_str(), to.c_str())) {
+    LOG(ERROR) << "Failed to fan out " << from << " to " << to
+               << "; fan-out is disabled for this stream.";
+    failed_ = true;
+  }
+}
+
+}  // namespace media
+}  // namespace shaka
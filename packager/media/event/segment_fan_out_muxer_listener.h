@@ -0,0 +1,92 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+//
+// Implementation of MuxerListener that republishes a muxed stream's files
+// under a second output naming, so duplicate stream descriptors can share one
+// pipeline while downstream consumers keep seeing every advertised name.
+
+#ifndef PACKAGER_MEDIA_EVENT_SEGMENT_FAN_OUT_MUXER_LISTENER_H_
+#define PACKAGER_MEDIA_EVENT_SEGMENT_FAN_OUT_MUXER_LISTENER_H_
+
+#include <string>
+#include <vector>
+
+#include <packager/macros/classes.h>
+#include <packager/media/base/muxer_util.h>
+#include <packager/media/event/muxer_listener.h>
+
+namespace shaka {
+namespace media {
+
+/// MuxerListener that copies every finalized file of the stream it observes
+/// to the output naming of a deduplicated descriptor: media segments are
+/// renamed through the alias segment template with the same numbering the
+/// muxer uses, the init segment (or the whole file for non-segmented output)
+/// is copied to the alias output name. Copy failures are logged and disable
+/// further fan-out for the stream; the primary output is never affected.
+class SegmentFanOutMuxerListener : public MuxerListener {
+ public:
+  /// @param output is the alias output file name (init segment for segmented
+  ///        output). May be empty.
+  /// @param segment_template is the alias segment template. May be empty for
+  ///        non-segmented output.
+  SegmentFanOutMuxerListener(const std::string& output,
+                             const std::string& segment_template);
+  ~SegmentFanOutMuxerListener() override;
+
+  /// @name MuxerListener implementation overrides.
+  /// @{
+  void OnEncryptionInfoReady(bool is_initial_encryption_info,
+                             FourCC protection_scheme,
+                             const std::vector<uint8_t>& default_key_id,
+                             const std::vector<uint8_t>& iv,
+                             const std::vector<ProtectionSystemSpecificInfo>&
+                                 key_system_info) override;
+  void OnEncryptionStart() override;
+  void OnMediaStart(const MuxerOptions& muxer_options,
+                    const StreamInfo& stream_info,
+                    int32_t time_scale,
+                    ContainerType container_type) override;
+  void OnSampleDurationReady(int32_t sample_duration) override;
+  void OnMediaEnd(const MediaRanges& media_ranges,
+                  float duration_seconds) override;
+  void OnNewSegment(const std::string& segment_name,
+                    int64_t start_time,
+                    int64_t duration,
+                    uint64_t segment_file_size) override;
+  void OnKeyFrame(int64_t timestamp,
+                  uint64_t start_byte_offset,
+                  uint64_t size) override;
+  void OnCueEvent(int64_t timestamp, const std::string& cue_data) override;
+  /// @}
+
+ private:
+  // Copies |from| to |to|. Logs and sets |failed_| on the first failure.
+  void Copy(const std::string& from, const std::string& to);
+
+  const std::string output_;
+  const std::string segment_template_;
+  // Compiled form of |segment_template_|; only valid when the template is
+  // not empty.
+  SegmentNameTemplate compiled_template_;
+  bool template_compiled_ = false;
+  // Primary output file name from OnMediaStart(): the init segment for
+  // segmented output, the whole file otherwise.
+  std::string primary_output_name_;
+  // Mirrors the muxer's segment numbering so the alias names line up with
+  // what the primary muxer would have produced under the alias template.
+  uint64_t segment_index_ = 0;
+  uint32_t bandwidth_ = 0;
+  bool init_segment_copied_ = false;
+  bool failed_ = false;
+
+  DISALLOW_COPY_AND_ASSIGN(SegmentFanOutMuxerListener);
+};
+
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_MEDIA_EVENT_SEGMENT_FAN_OUT_MUXER_LISTENER_H_
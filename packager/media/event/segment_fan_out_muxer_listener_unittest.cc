@@ -0,0 +1,75 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/event/segment_fan_out_muxer_listener.h>
+
+#include <gtest/gtest.h>
+
+#include <packager/file.h>
+#include <packager/file/file_test_util.h>
+#include <packager/media/base/muxer_options.h>
+#include <packager/media/event/muxer_listener_test_helper.h>
+
+namespace shaka {
+namespace media {
+namespace {
+
+const char kPrimaryInit[] = "memory://fan_out_test/audio_init.mp4";
+const char kPrimarySegment1[] = "memory://fan_out_test/audio_1.m4s";
+const char kPrimarySegment2[] = "memory://fan_out_test/audio_2.m4s";
+const char kAliasInit[] = "memory://fan_out_test/alias_init.mp4";
+const char kAliasTemplate[] = "memory://fan_out_test/alias_$Number$.m4s";
+
+}  // namespace
+
+TEST(SegmentFanOutMuxerListenerTest, CopiesInitAndSegmentsUnderAliasNames) {
+  ASSERT_TRUE(File::WriteStringToFile(kPrimaryInit, "init"));
+  ASSERT_TRUE(File::WriteStringToFile(kPrimarySegment1, "segment one"));
+  ASSERT_TRUE(File::WriteStringToFile(kPrimarySegment2, "segment two"));
+
+  SegmentFanOutMuxerListener listener(kAliasInit, kAliasTemplate);
+
+  MuxerOptions muxer_options;
+  SetDefaultMuxerOptions(&muxer_options);
+  muxer_options.output_file_name = kPrimaryInit;
+  muxer_options.segment_template = "memory://fan_out_test/audio_$Number$.m4s";
+  muxer_options.initial_segment_number = 1;
+  std::shared_ptr<StreamInfo> stream_info =
+      CreateVideoStreamInfo(GetDefaultVideoStreamInfoParams());
+  listener.OnMediaStart(muxer_options, *stream_info, 90000,
+                        MuxerListener::kContainerMp4);
+
+  listener.OnNewSegment(kPrimarySegment1, 0, 90000, 11);
+  listener.OnNewSegment(kPrimarySegment2, 90000, 90000, 11);
+
+  ASSERT_FILE_STREQ(kAliasInit, "init");
+  ASSERT_FILE_STREQ("memory://fan_out_test/alias_1.m4s", "segment one");
+  ASSERT_FILE_STREQ("memory://fan_out_test/alias_2.m4s", "segment two");
+}
+
+TEST(SegmentFanOutMuxerListenerTest, CopiesWholeFileOnMediaEnd) {
+  const char kPrimaryOutput[] = "memory://fan_out_test/audio.mp4";
+  const char kAliasOutput[] = "memory://fan_out_test/alias.mp4";
+  ASSERT_TRUE(File::WriteStringToFile(kPrimaryOutput, "whole file"));
+
+  SegmentFanOutMuxerListener listener(kAliasOutput, "");
+
+  MuxerOptions muxer_options;
+  SetDefaultMuxerOptions(&muxer_options);
+  muxer_options.output_file_name = kPrimaryOutput;
+  std::shared_ptr<StreamInfo> stream_info =
+      CreateVideoStreamInfo(GetDefaultVideoStreamInfoParams());
+  listener.OnMediaStart(muxer_options, *stream_info, 90000,
+                        MuxerListener::kContainerMp4);
+
+  MuxerListener::MediaRanges ranges;
+  listener.OnMediaEnd(ranges, 1.0);
+
+  ASSERT_FILE_STREQ(kAliasOutput, "whole file");
+}
+
+}  // namespace media
+}  // namespace shaka
@@ -25,9 +25,12 @@ namespace shaka {
 namespace media {
 
 VodMediaInfoDumpMuxerListener::VodMediaInfoDumpMuxerListener(
-    const std::string& output_file_path, bool use_segment_list)
+    const std::string& output_file_path,
+    bool use_segment_list,
+    bool use_binary_format)
     : output_file_name_(output_file_path),
-      use_segment_list_(use_segment_list) {}
+      use_segment_list_(use_segment_list),
+      use_binary_format_(use_binary_format) {}
 
 VodMediaInfoDumpMuxerListener::~VodMediaInfoDumpMuxerListener() {}
 
@@ -89,7 +92,7 @@ void VodMediaInfoDumpMuxerListener::OnMediaEnd(const MediaRanges& media_ranges,
   }
   if (!media_info_->has_bandwidth())
     media_info_->set_bandwidth(max_bitrate_);
-  WriteMediaInfoToFile(*media_info_, output_file_name_);
+  WriteMediaInfoToFile(*media_info_, output_file_name_, use_binary_format_);
 }
 
 void VodMediaInfoDumpMuxerListener::OnNewSegment(const std::string& file_name,
@@ -125,10 +128,14 @@ void VodMediaInfoDumpMuxerListener::OnCueEvent(int64_t timestamp,
 // static
 bool VodMediaInfoDumpMuxerListener::WriteMediaInfoToFile(
     const MediaInfo& media_info,
-    const std::string& output_file_path) {
+    const std::string& output_file_path,
+    bool binary_format) {
   std::string output_string;
-  if (!google::protobuf::TextFormat::PrintToString(media_info,
-                                                   &output_string)) {
+  // The binary wire format serializes through generated code without
+  // reflection and produces a fraction of the bytes of the text format.
+  if (binary_format ? !media_info.SerializeToString(&output_string)
+                    : !google::protobuf::TextFormat::PrintToString(
+                          media_info, &output_string)) {
     LOG(ERROR) << "Failed to serialize MediaInfo to string.";
     return false;
   }
@@ -27,7 +27,13 @@ namespace media {
 
 class VodMediaInfoDumpMuxerListener : public MuxerListener {
  public:
-  VodMediaInfoDumpMuxerListener(const std::string& output_file_name, bool use_segment_list);
+  /// @param use_binary_format, when true, writes the MediaInfo in protobuf
+  ///        binary wire format instead of human readable text format. Binary
+  ///        serialization avoids protobuf reflection and produces much
+  ///        smaller files.
+  VodMediaInfoDumpMuxerListener(const std::string& output_file_name,
+                                bool use_segment_list,
+                                bool use_binary_format = false);
   ~VodMediaInfoDumpMuxerListener() override;
 
   /// @name MuxerListener implementation overrides.
@@ -56,14 +62,17 @@ class VodMediaInfoDumpMuxerListener : public MuxerListener {
   void OnCueEvent(int64_t timestamp, const std::string& cue_data) override;
   /// @}
 
-  /// Write @a media_info to @a output_file_path in human readable format.
+  /// Write @a media_info to @a output_file_path.
   /// @param media_info is the MediaInfo to write out.
   /// @param output_file_path is the path of the output file.
+  /// @param binary_format, when true, writes protobuf binary wire format
+  ///        instead of human readable text format.
   /// @return true on success, false otherwise.
   // TODO(rkuroiwa): Move this to muxer_listener_internal and rename
   // muxer_listener_internal to muxer_listener_util.
   static bool WriteMediaInfoToFile(const MediaInfo& media_info,
-                                   const std::string& output_file_path);
+                                   const std::string& output_file_path,
+                                   bool binary_format = false);
 
   void set_use_segment_list(bool value) {use_segment_list_ = value;}
 
@@ -79,6 +88,7 @@ class VodMediaInfoDumpMuxerListener : public MuxerListener {
   std::vector<ProtectionSystemSpecificInfo> key_system_info_;
 
   bool use_segment_list_ = false;
+  bool use_binary_format_ = false;
 
   DISALLOW_COPY_AND_ASSIGN(VodMediaInfoDumpMuxerListener);
 };
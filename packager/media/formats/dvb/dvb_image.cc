@@ -101,15 +101,33 @@ DvbImageColorSpace::DvbImageColorSpace() {
     item = kNoColor;
   for (auto& item : color_map_8_)
     item = kNoColor;
+  InvalidateResolvedColors();
 }
 
 DvbImageColorSpace::~DvbImageColorSpace() {}
 
 RgbaColor DvbImageColorSpace::GetColor(BitDepth bit_depth,
                                        uint8_t entry_id) const {
+  RgbaColor* resolved;
+  switch (bit_depth) {
+    case BitDepth::k2Bit:
+      resolved = &resolved_color_2_[entry_id];
+      break;
+    case BitDepth::k4Bit:
+      resolved = &resolved_color_4_[entry_id];
+      break;
+    case BitDepth::k8Bit:
+      resolved = &resolved_color_8_[entry_id];
+      break;
+    default:
+      return kNoColor;
+  }
+  if (*resolved != kNoColor)
+    return *resolved;
+
   auto color = GetColorRaw(bit_depth, entry_id);
   if (color != kNoColor)
-    return color;
+    return *resolved = color;
 
   // If we don't have the exact bit-depth, try mapping to another bit-depth.
   // See ETSI EN 300 743 Section 9.
@@ -140,10 +158,10 @@ RgbaColor DvbImageColorSpace::GetColor(BitDepth bit_depth,
   }
 
   if (alt1 != kNoColor)
-    return alt1;
+    return *resolved = alt1;
   if (alt2 != kNoColor)
-    return alt2;
-  return default_color;
+    return *resolved = alt2;
+  return *resolved = default_color;
 }
 
 void DvbImageColorSpace::SetColor(BitDepth bit_depth,
@@ -163,18 +181,33 @@ void DvbImageColorSpace::SetColor(BitDepth bit_depth,
       color_map_8_[entry_id] = color;
       break;
   }
+  // A change in one bit-depth can affect resolved colors in the others, so
+  // drop everything.
+  InvalidateResolvedColors();
+}
+
+void DvbImageColorSpace::InvalidateResolvedColors() const {
+  for (auto& item : resolved_color_2_)
+    item = kNoColor;
+  for (auto& item : resolved_color_4_)
+    item = kNoColor;
+  for (auto& item : resolved_color_8_)
+    item = kNoColor;
 }
 
 void DvbImageColorSpace::Set2To4BitDepthMap(const uint8_t* map) {
   memcpy(bit_depth_2_to_4_, map, sizeof(bit_depth_2_to_4_));
+  InvalidateResolvedColors();
 }
 
 void DvbImageColorSpace::Set2To8BitDepthMap(const uint8_t* map) {
   memcpy(bit_depth_2_to_8_, map, sizeof(bit_depth_2_to_8_));
+  InvalidateResolvedColors();
 }
 
 void DvbImageColorSpace::Set4To8BitDepthMap(const uint8_t* map) {
   memcpy(bit_depth_4_to_8_, map, sizeof(bit_depth_4_to_8_));
+  InvalidateResolvedColors();
 }
 
 RgbaColor DvbImageColorSpace::GetColorRaw(BitDepth bit_depth,
@@ -211,14 +244,25 @@ DvbImageBuilder::~DvbImageBuilder() {}
 bool DvbImageBuilder::AddPixel(BitDepth bit_depth,
                                uint8_t byte_code,
                                bool is_top_rows) {
+  return AddPixels(bit_depth, byte_code, 1, is_top_rows);
+}
+
+bool DvbImageBuilder::AddPixels(BitDepth bit_depth,
+                                uint8_t byte_code,
+                                size_t count,
+                                bool is_top_rows) {
+  if (count == 0)
+    return true;
+
   auto& pos = is_top_rows ? top_pos_ : bottom_pos_;
-  if (pos.x >= max_width_ || pos.y >= max_height_) {
+  if (pos.y >= max_height_ || count > static_cast<size_t>(max_width_ - pos.x)) {
     LOG(ERROR) << "DVB-sub image cannot fit in region/window";
     return false;
   }
 
-  pixels_[pos.y * max_width_ + pos.x++] =
-      color_space_->GetColor(bit_depth, byte_code);
+  std::fill_n(&pixels_[pos.y * max_width_ + pos.x], count,
+              color_space_->GetColor(bit_depth, byte_code));
+  pos.x = static_cast<uint16_t>(pos.x + count);
   if (pos.x > width_)
     width_ = pos.x;
   return true;
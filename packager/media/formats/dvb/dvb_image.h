@@ -55,6 +55,9 @@ class DvbImageColorSpace {
   RgbaColor GetColor(BitDepth bit_depth, uint8_t entry_id) const;
 
   void SetColor(BitDepth bit_depth, uint8_t entry_id, RgbaColor color);
+  /// Invalidates colors memoized by GetColor.  Called internally by the
+  /// setters; only needed externally if color data is changed another way.
+  void InvalidateResolvedColors() const;
   /// Must pass a 4-element array; elements are copied over.
   void Set2To4BitDepthMap(const uint8_t* map);
   /// Must pass a 4-element array; elements are copied over.
@@ -70,6 +73,12 @@ class DvbImageColorSpace {
   RgbaColor color_map_2_[4];
   RgbaColor color_map_4_[16];
   RgbaColor color_map_8_[256];
+  // Memoized results of GetColor.  Resolving an entry can probe other
+  // bit-depths and compute spec defaults, which is too expensive to repeat for
+  // every pixel; kNoColor marks entries not resolved yet.
+  mutable RgbaColor resolved_color_2_[4];
+  mutable RgbaColor resolved_color_4_[16];
+  mutable RgbaColor resolved_color_8_[256];
   // See ETSI EN 300 743 Sections 10.4, 10.5, 10.6 for defaults.
   uint8_t bit_depth_2_to_4_[4] = {0x0, 0x7, 0x8, 0xf};
   uint8_t bit_depth_2_to_8_[4] = {0x0, 0x77, 0x88, 0xff};
@@ -101,6 +110,12 @@ class DvbImageBuilder {
   uint16_t max_height() const { return max_height_; }
 
   bool AddPixel(BitDepth bit_depth, uint8_t byte_code, bool is_top_rows);
+  /// Adds @a count pixels of the same byte-code, resolving the color only
+  /// once.  Used for the run-length codes in the pixel data streams.
+  bool AddPixels(BitDepth bit_depth,
+                 uint8_t byte_code,
+                 size_t count,
+                 bool is_top_rows);
   void NewRow(bool is_top_rows);
   /// Copies the top-rows to the bottom rows.
   void MirrorToBottomRows();
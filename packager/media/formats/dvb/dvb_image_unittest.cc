@@ -208,6 +208,41 @@ TEST(DvbImageBuilderTest, BasicFlow) {
   CheckImagePixels(&image, kWidth, {kRed, kBlue, kGreen, kBlack, kWhite});
 }
 
+TEST(DvbImageBuilderTest, AddsPixelRuns) {
+  DvbImageColorSpace colors;
+  FillDefaultColorSpace(&colors);
+  const uint16_t kWidth = 6;
+
+  DvbImageBuilder image(&colors, kBlack, kWidth, 3);
+  ASSERT_TRUE(image.AddPixels(BitDepth::k8Bit, kRedId, 4, kTopRow));
+  ASSERT_TRUE(image.AddPixels(BitDepth::k8Bit, kGreenId, 2, kTopRow));
+  image.NewRow(kTopRow);
+  ASSERT_TRUE(image.AddPixels(BitDepth::k8Bit, kBlueId, kWidth, kBottomRow));
+  image.NewRow(kBottomRow);
+
+  uint16_t width, height;
+  const RgbaColor* pixels = nullptr;
+  ASSERT_TRUE(image.GetPixels(&pixels, &width, &height));
+  ASSERT_EQ(width, kWidth);
+  ASSERT_EQ(height, 2u);
+  for (size_t i = 0; i < 4; i++)
+    EXPECT_EQ(pixels[i], kRed);
+  for (size_t i = 4; i < kWidth; i++)
+    EXPECT_EQ(pixels[i], kGreen);
+  for (size_t i = 0; i < kWidth; i++)
+    EXPECT_EQ(pixels[image.max_width() + i], kBlue);
+}
+
+TEST(DvbImageBuilderTest, ValidatesPixelRunLength) {
+  DvbImageColorSpace colors;
+  FillDefaultColorSpace(&colors);
+
+  DvbImageBuilder image(&colors, kBlack, 4, 3);
+  ASSERT_TRUE(image.AddPixels(BitDepth::k8Bit, kRedId, 3, kTopRow));
+  // The run would extend past the max width.
+  ASSERT_FALSE(image.AddPixels(BitDepth::k8Bit, kRedId, 2, kTopRow));
+}
+
 TEST(DvbImageBuilderTest, AllowsSmallerImages) {
   DvbImageColorSpace colors;
   FillDefaultColorSpace(&colors);
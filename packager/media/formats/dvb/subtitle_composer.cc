@@ -6,6 +6,7 @@
 
 #include <packager/media/formats/dvb/subtitle_composer.h>
 
+#include <atomic>
 #include <cstring>
 
 #include <absl/log/check.h>
@@ -23,6 +24,40 @@ const uint16_t kDefaultWidth = 720;
 const uint16_t kDefaultHeight = 576;
 const RgbaColor kTransparent{0, 0, 0, 0};
 
+// Consecutive DVB pages usually repeat recently shown bitmaps, so a small
+// cache captures most of the re-encodes; it is cleared wholesale when full,
+// which keeps it bounded without LRU bookkeeping.
+const size_t kMaxCachedPngs = 32;
+
+// Process-wide counters behind GetPngDedupStats(); a packaging job can have
+// one composer per subtitle stream.
+std::atomic<uint64_t> g_png_encodes{0};
+std::atomic<uint64_t> g_png_dedup_hits{0};
+
+// 64-bit FNV-1a over the image dimensions and the visible part of each pixel
+// row (rows are padded to the builder's max_width). The cache is keyed by
+// hash alone; at 64 bits a collision reusing the wrong PNG is vanishingly
+// unlikely for the handful of bitmaps a subtitle stream cycles through.
+uint64_t HashPixels(const RgbaColor* pixels,
+                    uint16_t width,
+                    uint16_t height,
+                    uint16_t stride) {
+  uint64_t hash = 0xcbf29ce484222325ull;
+  auto hash_bytes = [&hash](const uint8_t* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+      hash ^= data[i];
+      hash *= 0x100000001b3ull;
+    }
+  };
+  hash_bytes(reinterpret_cast<const uint8_t*>(&width), sizeof(width));
+  hash_bytes(reinterpret_cast<const uint8_t*>(&height), sizeof(height));
+  for (size_t y = 0; y < height; y++) {
+    hash_bytes(reinterpret_cast<const uint8_t*>(pixels + y * stride),
+               static_cast<size_t>(width) * sizeof(RgbaColor));
+  }
+  return hash;
+}
+
 struct PngFreeHelper {
   PngFreeHelper(png_structp* png, png_infop* info) : png(png), info(info) {}
   ~PngFreeHelper() { png_destroy_write_struct(png, info); }
@@ -217,14 +252,15 @@ bool SubtitleComposer::GetSamples(
     }
 
     uint16_t width, height;
-    std::vector<uint8_t> image_data;
-    if (!GetImageData(&it->second, &image_data, &width, &height))
+    std::shared_ptr<const std::vector<uint8_t>> image_data =
+        GetOrEncodeImage(&it->second, &width, &height);
+    if (!image_data)
       return false;
-    if (image_data.empty()) {
+    if (image_data->empty()) {
       VLOG(1) << "Skipping transparent object";
       continue;
     }
-    TextFragment body({}, image_data);
+    TextFragment body({}, *image_data);
     DCHECK_LE(width, display_width_);
     DCHECK_LE(height, display_height_);
 
@@ -253,5 +289,37 @@ void SubtitleComposer::ClearObjects() {
   images_.clear();
 }
 
+void SubtitleComposer::GetPngDedupStats(uint64_t* encodes,
+                                        uint64_t* dedup_hits) {
+  *encodes = g_png_encodes.load(std::memory_order_relaxed);
+  *dedup_hits = g_png_dedup_hits.load(std::memory_order_relaxed);
+}
+
+std::shared_ptr<const std::vector<uint8_t>> SubtitleComposer::GetOrEncodeImage(
+    const DvbImageBuilder* image,
+    uint16_t* width,
+    uint16_t* height) const {
+  const RgbaColor* pixels;
+  if (!image->GetPixels(&pixels, width, height))
+    return nullptr;
+
+  const uint64_t hash =
+      HashPixels(pixels, *width, *height, image->max_width());
+  auto it = encoded_pngs_.find(hash);
+  if (it != encoded_pngs_.end()) {
+    g_png_dedup_hits.fetch_add(1, std::memory_order_relaxed);
+    return it->second;
+  }
+
+  auto data = std::make_shared<std::vector<uint8_t>>();
+  if (!GetImageData(image, data.get(), width, height))
+    return nullptr;
+  g_png_encodes.fetch_add(1, std::memory_order_relaxed);
+
+  if (encoded_pngs_.size() >= kMaxCachedPngs)
+    encoded_pngs_.clear();
+  return encoded_pngs_.emplace(hash, std::move(data)).first->second;
+}
+
 }  // namespace media
 }  // namespace shaka
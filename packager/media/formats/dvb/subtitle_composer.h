@@ -48,6 +48,11 @@ class SubtitleComposer {
                   std::vector<std::shared_ptr<TextSample>>* samples) const;
   void ClearObjects();
 
+  /// Process-wide counters for the PNG encode dedup cache: @a encodes is the
+  /// number of region bitmaps actually encoded and @a dedup_hits the number
+  /// served from the cache. Reported through Packager::DumpPipelineStats().
+  static void GetPngDedupStats(uint64_t* encodes, uint64_t* dedup_hits);
+
  private:
   struct RegionInfo {
     DvbImageColorSpace* color_space = nullptr;
@@ -64,11 +69,24 @@ class SubtitleComposer {
     uint16_t y = 0;
   };
 
+  // Returns the encoded PNG for |image|, reusing the cached bytes when an
+  // identical bitmap (by pixel hash) was encoded before. Returns null on
+  // encode failure and an empty image for fully transparent bitmaps.
+  std::shared_ptr<const std::vector<uint8_t>> GetOrEncodeImage(
+      const DvbImageBuilder* image,
+      uint16_t* width,
+      uint16_t* height) const;
+
   // Maps of IDs to their respective object.
   std::unordered_map<uint8_t, RegionInfo> regions_;
   std::unordered_map<uint8_t, DvbImageColorSpace> color_spaces_;
   std::unordered_map<uint16_t, ObjectInfo> objects_;
   std::unordered_map<uint16_t, DvbImageBuilder> images_;  // Uses object_id.
+  // Encoded PNGs keyed by region pixel hash. Survives ClearObjects() so
+  // bitmaps repeated across consecutive pages are not re-encoded.
+  mutable std::unordered_map<uint64_t,
+                             std::shared_ptr<const std::vector<uint8_t>>>
+      encoded_pngs_;
   uint16_t display_width_;
   uint16_t display_height_;
 };
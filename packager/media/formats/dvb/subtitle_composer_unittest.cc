@@ -143,6 +143,38 @@ TEST(SubtitleComposerTest, ClearObjects) {
   EXPECT_EQ(samples.size(), 1u);
 }
 
+TEST(SubtitleComposerTest, DedupsRepeatedImages) {
+  const uint8_t kColorSpaceId = 2;
+  const uint16_t kObjectId = 5;
+  const uint16_t kRegionId = 1;
+
+  SubtitleComposer composer;
+  ASSERT_TRUE(composer.SetRegionInfo(kRegionId, kColorSpaceId, 10, 10));
+  ASSERT_TRUE(composer.SetObjectInfo(kObjectId, kRegionId, 0, 0, kNoBgColor));
+  CreateDefaultImage(&composer, kObjectId);
+
+  uint64_t encodes_before, hits_before;
+  SubtitleComposer::GetPngDedupStats(&encodes_before, &hits_before);
+
+  std::vector<std::shared_ptr<TextSample>> samples;
+  ASSERT_TRUE(composer.GetSamples(0, 1, &samples));
+  ASSERT_EQ(samples.size(), 1u);
+
+  // The next page repeats the same bitmap; the cached PNG should be reused.
+  composer.ClearObjects();
+  ASSERT_TRUE(composer.SetRegionInfo(kRegionId, kColorSpaceId, 10, 10));
+  ASSERT_TRUE(composer.SetObjectInfo(kObjectId, kRegionId, 0, 0, kNoBgColor));
+  CreateDefaultImage(&composer, kObjectId);
+  ASSERT_TRUE(composer.GetSamples(1, 2, &samples));
+  ASSERT_EQ(samples.size(), 2u);
+  EXPECT_EQ(samples[0]->body().image, samples[1]->body().image);
+
+  uint64_t encodes_after, hits_after;
+  SubtitleComposer::GetPngDedupStats(&encodes_after, &hits_after);
+  EXPECT_EQ(encodes_after - encodes_before, 1u);
+  EXPECT_EQ(hits_after - hits_before, 1u);
+}
+
 TEST(SubtitleComposerTest, IgnoresEmptyImages) {
   const uint8_t kColorSpaceId = 1;
   const uint16_t kRegionId = 1;
@@ -9,6 +9,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <vector>
 
 namespace shaka {
@@ -41,6 +42,28 @@ class AudioHeader {
   /// @return true if successful, false otherwise.
   virtual bool Parse(const uint8_t* audio_frame, size_t audio_frame_size) = 0;
 
+  /// Same as Parse(), but memoized: audio headers are typically byte-identical
+  /// from frame to frame, so if the header bytes match the last successfully
+  /// parsed header the decoded fields are reused and the bit-level parse is
+  /// skipped. Any difference (e.g. a varying frame length or CRC) falls back
+  /// to a full Parse().
+  bool ParseWithCache(const uint8_t* audio_frame, size_t audio_frame_size) {
+    if (!last_header_.empty() && audio_frame_size >= last_header_.size() &&
+        memcmp(audio_frame, last_header_.data(), last_header_.size()) == 0) {
+      // The decoded fields from the previous Parse() are still valid.
+      return true;
+    }
+    if (!Parse(audio_frame, audio_frame_size))
+      return false;
+    const size_t header_size = GetHeaderSize();
+    if (audio_frame_size >= header_size) {
+      last_header_.assign(audio_frame, audio_frame + header_size);
+    } else {
+      last_header_.clear();
+    }
+    return true;
+  }
+
   /// Should only be called after a successful Parse.
   /// @return The size of audio header.
   virtual size_t GetHeaderSize() const = 0;
@@ -78,6 +101,9 @@ class AudioHeader {
  private:
   AudioHeader(const AudioHeader&) = delete;
   AudioHeader& operator=(const AudioHeader&) = delete;
+
+  // Header bytes from the last successful Parse(), used by ParseWithCache().
+  std::vector<uint8_t> last_header_;
 };
 
 }  // namespace mp2t
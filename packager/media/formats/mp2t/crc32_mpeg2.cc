@@ -0,0 +1,77 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/formats/mp2t/crc32_mpeg2.h>
+
+namespace shaka {
+namespace media {
+namespace mp2t {
+namespace {
+
+const uint32_t kCrcPoly = 0x04c11db7;
+
+// Slicing-by-8 lookup tables. |table[0]| is the classic byte-at-a-time table;
+// |table[k]| maps a byte to its CRC contribution when it sits k bytes further
+// from the end of the block, so eight bytes fold into the CRC with eight
+// table lookups and no per-byte dependency chain.
+struct Crc32Mpeg2Tables {
+  uint32_t table[8][256];
+};
+
+Crc32Mpeg2Tables BuildTables() {
+  Crc32Mpeg2Tables tables;
+  for (int i = 0; i < 256; ++i) {
+    uint32_t crc = static_cast<uint32_t>(i) << 24;
+    for (int bit = 0; bit < 8; ++bit)
+      crc = (crc & 0x80000000) ? (crc << 1) ^ kCrcPoly : (crc << 1);
+    tables.table[0][i] = crc;
+  }
+  for (int k = 1; k < 8; ++k) {
+    for (int i = 0; i < 256; ++i) {
+      const uint32_t prev = tables.table[k - 1][i];
+      tables.table[k][i] =
+          (prev << 8) ^ tables.table[0][(prev >> 24) & 0xff];
+    }
+  }
+  return tables;
+}
+
+const Crc32Mpeg2Tables& GetTables() {
+  static const Crc32Mpeg2Tables tables = BuildTables();
+  return tables;
+}
+
+}  // namespace
+
+uint32_t Crc32Mpeg2(const uint8_t* data, size_t size) {
+  const auto& table = GetTables().table;
+  uint32_t crc = 0xffffffff;
+  while (size >= 8) {
+    const uint32_t x = crc ^ (static_cast<uint32_t>(data[0]) << 24 |
+                              static_cast<uint32_t>(data[1]) << 16 |
+                              static_cast<uint32_t>(data[2]) << 8 | data[3]);
+    crc = table[7][x >> 24] ^ table[6][(x >> 16) & 0xff] ^
+          table[5][(x >> 8) & 0xff] ^ table[4][x & 0xff] ^
+          table[3][data[4]] ^ table[2][data[5]] ^ table[1][data[6]] ^
+          table[0][data[7]];
+    data += 8;
+    size -= 8;
+  }
+  while (size--)
+    crc = table[0][((crc >> 24) ^ *data++) & 0xff] ^ (crc << 8);
+  return crc;
+}
+
+bool VerifyCrc32Mpeg2(const uint8_t* section, size_t size) {
+  // CRC-32/MPEG-2 has no final xor, so running the CRC over the section
+  // including its stored CRC leaves a residue of 0 when the section is
+  // intact.
+  return Crc32Mpeg2(section, size) == 0;
+}
+
+}  // namespace mp2t
+}  // namespace media
+}  // namespace shaka
@@ -0,0 +1,33 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_MEDIA_FORMATS_MP2T_CRC32_MPEG2_H_
+#define PACKAGER_MEDIA_FORMATS_MP2T_CRC32_MPEG2_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace shaka {
+namespace media {
+namespace mp2t {
+
+/// Computes CRC-32/MPEG-2 (polynomial 0x04C11DB7, MSB first, initial value
+/// 0xFFFFFFFF, no final xor) over @a data as used by PSI sections
+/// (ISO/IEC 13818-1 Annex A). Implemented with slicing-by-8, which processes
+/// eight bytes per table round instead of one.
+/// Note there are dozens of CRCs; see
+/// http://reveng.sourceforge.net/crc-catalogue/all.htm.
+uint32_t Crc32Mpeg2(const uint8_t* data, size_t size);
+
+/// @return true if @a section, a complete PSI section with its trailing
+///         32-bit CRC, checks out. A valid section has a CRC residue of 0.
+bool VerifyCrc32Mpeg2(const uint8_t* section, size_t size);
+
+}  // namespace mp2t
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_MEDIA_FORMATS_MP2T_CRC32_MPEG2_H_
@@ -0,0 +1,67 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/formats/mp2t/crc32_mpeg2.h>
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace shaka {
+namespace media {
+namespace mp2t {
+namespace {
+
+// Byte-at-a-time reference implementation, to cross-check the slicing-by-8
+// fast path at every length including the partial tail.
+uint32_t ReferenceCrc32Mpeg2(const uint8_t* data, size_t size) {
+  uint32_t crc = 0xffffffff;
+  for (size_t i = 0; i < size; ++i) {
+    crc ^= static_cast<uint32_t>(data[i]) << 24;
+    for (int bit = 0; bit < 8; ++bit)
+      crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04c11db7 : (crc << 1);
+  }
+  return crc;
+}
+
+}  // namespace
+
+TEST(Crc32Mpeg2Test, CheckValue) {
+  // Standard check input for CRC-32/MPEG-2, e.g. from the reveng catalogue.
+  const uint8_t kInput[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+  EXPECT_EQ(0x0376e6e7u, Crc32Mpeg2(kInput, sizeof(kInput)));
+}
+
+TEST(Crc32Mpeg2Test, MatchesReferenceForAllTailLengths) {
+  // 1021 is the maximum PSI section length.
+  std::vector<uint8_t> data(1021);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<uint8_t>(i * 31 + 7);
+  for (size_t length = 0; length <= data.size(); ++length) {
+    ASSERT_EQ(ReferenceCrc32Mpeg2(data.data(), length),
+              Crc32Mpeg2(data.data(), length))
+        << "length " << length;
+  }
+}
+
+TEST(Crc32Mpeg2Test, VerifyAcceptsSectionWithTrailingCrc) {
+  std::vector<uint8_t> section = {0x00, 0xB0, 0x0D, 0x00, 0x01,
+                                  0xC1, 0x00, 0x00, 0x00, 0x01,
+                                  0xE0, 0x20};
+  const uint32_t crc = Crc32Mpeg2(section.data(), section.size());
+  section.push_back(crc >> 24);
+  section.push_back((crc >> 16) & 0xff);
+  section.push_back((crc >> 8) & 0xff);
+  section.push_back(crc & 0xff);
+  EXPECT_TRUE(VerifyCrc32Mpeg2(section.data(), section.size()));
+
+  section[4] ^= 1;
+  EXPECT_FALSE(VerifyCrc32Mpeg2(section.data(), section.size()));
+}
+
+}  // namespace mp2t
+}  // namespace media
+}  // namespace shaka
@@ -79,7 +79,7 @@ static bool LookForSyncWord(const uint8_t* raw_es,
       continue;
     }
 
-    if (!audio_header->Parse(cur_buf, frame_size))
+    if (!audio_header->ParseWithCache(cur_buf, frame_size))
       continue;
 
     *new_pos = offset;
@@ -119,17 +119,25 @@ bool EsParserAudio::Parse(const uint8_t* buf,
                           int64_t dts) {
   int raw_es_size;
   const uint8_t* raw_es;
+  es_byte_queue_.Peek(&raw_es, &raw_es_size);
 
   // The incoming PTS applies to the access unit that comes just after
   // the beginning of |buf|.
-  if (pts != kNoTimestamp) {
-    es_byte_queue_.Peek(&raw_es, &raw_es_size);
+  if (pts != kNoTimestamp)
     pts_list_.push_back(EsPts(raw_es_size, pts));
-  }
 
-  // Copy the input data to the ES buffer.
-  es_byte_queue_.Push(buf, static_cast<int>(size));
-  es_byte_queue_.Peek(&raw_es, &raw_es_size);
+  // When no bytes are pending from earlier PES packets, scan the payload in
+  // place and only buffer the trailing partial frame below, so complete
+  // frames never pass through the ES buffer. Otherwise copy the input data
+  // to the ES buffer.
+  const bool parse_in_place = (raw_es_size == 0);
+  if (parse_in_place) {
+    raw_es = buf;
+    raw_es_size = size;
+  } else {
+    es_byte_queue_.Push(buf, static_cast<int>(size));
+    es_byte_queue_.Peek(&raw_es, &raw_es_size);
+  }
 
   // Look for every frame in the ES buffer starting at offset = 0
   int es_position = 0;
@@ -181,8 +189,18 @@ bool EsParserAudio::Parse(const uint8_t* buf,
     es_position += static_cast<int>(audio_header_->GetFrameSize());
   }
 
-  // Discard all the bytes that have been processed.
-  DiscardEs(es_position);
+  if (parse_in_place) {
+    // Adjust the ES position of each PTS and buffer the unconsumed tail.
+    for (EsPtsList::iterator it = pts_list_.begin(); it != pts_list_.end();
+         ++it) {
+      it->first -= es_position;
+    }
+    if (es_position < raw_es_size)
+      es_byte_queue_.Push(raw_es + es_position, raw_es_size - es_position);
+  } else {
+    // Discard all the bytes that have been processed.
+    DiscardEs(es_position);
+  }
 
   return true;
 }
@@ -112,7 +112,9 @@ bool EsParserH26x::Flush() {
 }
 
 void EsParserH26x::Reset() {
-  es_queue_.reset(new media::OffsetByteQueue());
+  // Reuse the queue rather than recreating it, so the buffer it grew to
+  // hold the largest access unit is retained across resets.
+  es_queue_->Reset();
   current_search_position_ = 0;
   current_access_unit_position_ = 0;
   current_video_slice_info_.valid = false;
@@ -137,9 +139,17 @@ bool EsParserH26x::SearchForNalu(uint64_t* position, Nalu* nalu) {
       es, es_size, &start_code_offset, &start_code_size);
 
   if (!start_code_found) {
-    // We didn't find a start code, so we don't have to search this data again.
-    if (es_size > kStartCodeSize)
-      current_search_position_ += es_size - kStartCodeSize;
+    // We didn't find a start code, so we don't have to search this data
+    // again. Only a trailing partial start-code prefix (up to three zero
+    // bytes) is kept for the next round, so a start code straddling a PES
+    // packet boundary is still found while the scanned bytes are never
+    // replayed, however the stream fragments.
+    int trailing_zeros = 0;
+    while (trailing_zeros < kStartCodeSize && trailing_zeros < es_size &&
+           es[es_size - 1 - trailing_zeros] == 0x00) {
+      ++trailing_zeros;
+    }
+    current_search_position_ += es_size - trailing_zeros;
     return false;
   }
 
@@ -149,7 +159,10 @@ bool EsParserH26x::SearchForNalu(uint64_t* position, Nalu* nalu) {
   const int64_t next_nalu_size = es_size - start_code_offset - start_code_size;
   if (next_nalu_size <
       (type_ == Nalu::kH264 ? kH264NaluHeaderSize : kH265NaluHeaderSize)) {
-    // There was not enough data, wait for more.
+    // There was not enough data, wait for more. Resume at the start code so
+    // the bytes leading up to it are not scanned again; the next search
+    // re-finds it at offset zero.
+    current_search_position_ += start_code_offset;
     return false;
   }
 
@@ -303,12 +316,23 @@ bool EsParserH26x::EmitFrame(int64_t access_unit_pos,
   const uint8_t* es;
   es_queue_->PeekAt(access_unit_pos, &es, &es_size);
 
-  // Convert frame to unit stream format.
+  // Convert frame to unit stream format, preferably in place: the queue bytes
+  // of this access unit are never re-parsed once it is emitted (scanning
+  // resumes at |next_access_unit_position_|), so patching the start codes
+  // directly in the queue saves a full copy of the frame. Frames with 3-byte
+  // start codes or stripped parameter sets fall back to the copying path.
   std::vector<uint8_t> converted_frame;
-  if (!stream_converter_->ConvertByteStreamToNalUnitStream(
-          es, access_unit_size, &converted_frame)) {
-    DLOG(ERROR) << "Failure to convert video frame to unit stream format.";
-    return false;
+  const uint8_t* frame_data = es;
+  size_t frame_size = access_unit_size;
+  if (!stream_converter_->ConvertByteStreamToNalUnitStreamInPlace(
+          const_cast<uint8_t*>(es), access_unit_size)) {
+    if (!stream_converter_->ConvertByteStreamToNalUnitStream(
+            es, access_unit_size, &converted_frame)) {
+      DLOG(ERROR) << "Failure to convert video frame to unit stream format.";
+      return false;
+    }
+    frame_data = converted_frame.data();
+    frame_size = converted_frame.size();
   }
 
   // Update the video decoder configuration if needed.
@@ -316,8 +340,17 @@ bool EsParserH26x::EmitFrame(int64_t access_unit_pos,
 
   // Create the media sample, emitting always the previous sample after
   // calculating its duration.
-  std::shared_ptr<MediaSample> media_sample = MediaSample::CopyFrom(
-      converted_frame.data(), converted_frame.size(), is_key_frame);
+  std::shared_ptr<MediaSample> media_sample =
+      MediaSample::CopyFrom(frame_data, frame_size, is_key_frame);
+  // Attach the NALU extent table so downstream handlers (subsample
+  // generation, TS conversion) iterate the units from the table instead of
+  // rescanning the frame.
+  std::vector<NaluExtent> nalu_extents;
+  if (ParseNaluExtents(
+          type_, H26xByteToUnitStreamConverter::kUnitStreamNaluLengthSize,
+          media_sample->data(), media_sample->data_size(), &nalu_extents)) {
+    media_sample->set_nalu_extents(std::move(nalu_extents));
+  }
   media_sample->set_dts(current_timing_desc.dts);
   media_sample->set_pts(current_timing_desc.pts);
   if (pending_sample_) {
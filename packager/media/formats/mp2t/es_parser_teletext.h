@@ -68,6 +68,10 @@ class EsParserTeletext : public EsParser {
   bool sent_info_ = false;
   uint8_t magazine_;
   uint8_t page_number_;
+  // Whether the page announced by the last page header is listed in the
+  // subtitling descriptor. Rows of non-selected pages are dropped before any
+  // payload decoding.
+  bool page_selected_ = true;
   std::unordered_map<uint16_t, TextBlock> page_state_;
   uint8_t charset_code_;
   char current_charset_[96][3];
@@ -232,6 +232,33 @@ TEST_F(EsParserTeletextTest, pes_283413_line_emitted_on_next_pes) {
   EXPECT_EQ("Bon dia!", text_sample_->body().body);
 }
 
+TEST_F(EsParserTeletextTest, non_selected_page_is_discarded) {
+  // Same descriptor as DESCRIPTOR except that the second entry selects page
+  // 877 instead of 888, so the page carried in the PES packets below is not
+  // listed and its rows must be dropped.
+  const uint8_t kDescriptor[] = {0x56, 0x0a, 0x63, 0x61, 0x74, 0x09,
+                                 0x00, 0x63, 0x61, 0x74, 0x10, 0x77};
+
+  auto on_new_stream = std::bind(&EsParserTeletextTest::OnNewStreamInfo, this,
+                                 kPesPid, std::placeholders::_1);
+  auto on_emit_text = std::bind(&EsParserTeletextTest::OnEmitTextSample, this,
+                                kPesPid, std::placeholders::_1);
+
+  std::unique_ptr<EsParserTeletext> es_parser_teletext(new EsParserTeletext(
+      kPesPid, on_new_stream, on_emit_text, kDescriptor, 12));
+
+  auto parse_result =
+      es_parser_teletext->Parse(PES_283413, sizeof(PES_283413), 283413, 0);
+  EXPECT_TRUE(parse_result);
+
+  parse_result =
+      es_parser_teletext->Parse(PES_407876, sizeof(PES_407876), 407876, 0);
+  EXPECT_TRUE(parse_result);
+
+  EXPECT_TRUE(es_parser_teletext->Flush());
+  EXPECT_EQ(nullptr, text_sample_.get());
+}
+
 TEST_F(EsParserTeletextTest, multiple_lines_with_same_pts) {
   auto on_new_stream = std::bind(&EsParserTeletextTest::OnNewStreamInfo, this,
                                  kPesPid, std::placeholders::_1);
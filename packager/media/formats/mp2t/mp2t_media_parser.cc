@@ -155,6 +155,7 @@ void PidState::ResetState() {
 
 Mp2tMediaParser::Mp2tMediaParser()
     : sbr_in_mimetype_(false),
+      pids_(kNumPids),
       is_initialized_(false) {
 }
 
@@ -175,17 +176,39 @@ void Mp2tMediaParser::Init(const InitCB& init_cb,
   new_text_sample_cb_ = new_text_sample_cb;
 }
 
+void Mp2tMediaParser::ExcludeTrack(uint32_t track_id) {
+  // In a TS stream the track id is the PES PID. Disabling the PID drops its
+  // TS packets at the packet filter, so neither PES reassembly nor ES parsing
+  // is paid for a stream that is not packaged. The PID state itself is kept:
+  // it already contributed its config to the init callback.
+  PidState* pid_state =
+      track_id < pids_.size() ? pids_[track_id].get() : nullptr;
+  if (!pid_state)
+    return;
+  if (pid_state->pid_type() != PidState::kPidAudioPes &&
+      pid_state->pid_type() != PidState::kPidVideoPes &&
+      pid_state->pid_type() != PidState::kPidTextPes) {
+    return;
+  }
+  DVLOG(1) << "Excluding unselected pid: " << track_id;
+  pid_state->Disable();
+  pid_state->media_sample_queue_.clear();
+  pid_state->text_sample_queue_.clear();
+}
+
 bool Mp2tMediaParser::Flush() {
   DVLOG(1) << "Mp2tMediaParser::Flush";
 
   // Flush the buffers and reset the pids.
-  for (const auto& pair : pids_) {
-    DVLOG(1) << "Flushing PID: " << pair.first;
-    PidState* pid_state = pair.second.get();
-    RCHECK(pid_state->Flush());
+  for (size_t pid = 0; pid < pids_.size(); ++pid) {
+    if (!pids_[pid])
+      continue;
+    DVLOG(1) << "Flushing PID: " << pid;
+    RCHECK(pids_[pid]->Flush());
   }
   bool result = EmitRemainingSamples();
-  pids_.clear();
+  for (std::unique_ptr<PidState>& pid_state : pids_)
+    pid_state.reset();
 
   // Remove any bytes left in the TS buffer.
   // (i.e. any partial TS packet => less than 188 bytes).
@@ -228,10 +251,11 @@ bool Mp2tMediaParser::Parse(const uint8_t* buf, int size) {
                         << ts_packet->payload_unit_start_indicator()
                         << " continuity_counter="
                         << ts_packet->continuity_counter();
-    // Parse the section.
-    auto it = pids_.find(ts_packet->pid());
-    if (it == pids_.end() &&
-        ts_packet->pid() == TsSection::kPidPat) {
+    // Parse the section. The PID is a 13-bit field, so it is always a valid
+    // index into the PID table.
+    DCHECK_LT(static_cast<size_t>(ts_packet->pid()), pids_.size());
+    PidState* pid_state = pids_[ts_packet->pid()].get();
+    if (!pid_state && ts_packet->pid() == TsSection::kPidPat) {
       // Create the PAT state here if needed.
       std::unique_ptr<TsSection> pat_section_parser(new TsSectionPat(
           std::bind(&Mp2tMediaParser::RegisterPmt, this, std::placeholders::_1,
@@ -239,11 +263,12 @@ bool Mp2tMediaParser::Parse(const uint8_t* buf, int size) {
       std::unique_ptr<PidState> pat_pid_state(new PidState(
           ts_packet->pid(), PidState::kPidPat, std::move(pat_section_parser)));
       pat_pid_state->Enable();
-      it = pids_.emplace(ts_packet->pid(), std::move(pat_pid_state)).first;
+      pid_state = pat_pid_state.get();
+      pids_[ts_packet->pid()] = std::move(pat_pid_state);
     }
 
-    if (it != pids_.end()) {
-      RCHECK(it->second->PushTsPacket(*ts_packet));
+    if (pid_state) {
+      RCHECK(pid_state->PushTsPacket(*ts_packet));
     } else {
       DVLOG(LOG_LEVEL_TS) << "Ignoring TS packet for pid: " << ts_packet->pid();
     }
@@ -263,9 +288,9 @@ void Mp2tMediaParser::RegisterPmt(int program_number, int pmt_pid) {
 
   // Only one TS program is allowed. Ignore the incoming program map table,
   // if there is already one registered.
-  for (const auto& pair : pids_) {
-    if (pair.second->pid_type() == PidState::kPidPmt) {
-      if (pmt_pid != pair.first) {
+  for (size_t pid = 0; pid < pids_.size(); ++pid) {
+    if (pids_[pid] && pids_[pid]->pid_type() == PidState::kPidPmt) {
+      if (pmt_pid != static_cast<int>(pid)) {
         DVLOG(1) << "More than one program is defined";
       }
       return;
@@ -281,7 +306,8 @@ void Mp2tMediaParser::RegisterPmt(int program_number, int pmt_pid) {
   std::unique_ptr<PidState> pmt_pid_state(
       new PidState(pmt_pid, PidState::kPidPmt, std::move(pmt_section_parser)));
   pmt_pid_state->Enable();
-  pids_.emplace(pmt_pid, std::move(pmt_pid_state));
+  DCHECK_LT(static_cast<size_t>(pmt_pid), pids_.size());
+  pids_[pmt_pid] = std::move(pmt_pid_state);
 }
 
 void Mp2tMediaParser::RegisterPes(int pmt_pid,
@@ -292,7 +318,8 @@ void Mp2tMediaParser::RegisterPes(int pmt_pid,
                                   TsAudioType audio_type,
                                   const uint8_t* descriptor,
                                   size_t descriptor_length) {
-  if (pids_.count(pes_pid) != 0)
+  DCHECK_LT(static_cast<size_t>(pes_pid), pids_.size());
+  if (pids_[pes_pid])
     return;
   DVLOG(1) << "RegisterPes:"
            << " pes_pid=" << pes_pid << " stream_type=" << std::hex
@@ -354,7 +381,7 @@ void Mp2tMediaParser::RegisterPes(int pmt_pid,
   std::unique_ptr<PidState> pes_pid_state(
       new PidState(pes_pid, pid_type, std::move(pes_section_parser)));
   pes_pid_state->Enable();
-  pids_.emplace(pes_pid, std::move(pes_pid_state));
+  pids_[pes_pid] = std::move(pes_pid_state);
 
   // Store PES metadata.
   pes_metadata_.insert(
@@ -368,8 +395,9 @@ void Mp2tMediaParser::OnNewStreamInfo(
   DVLOG(1) << "OnVideoConfigChanged for pid=" << pes_pid
            << ", has_info=" << (new_stream_info ? "true" : "false");
 
-  auto pid_state = pids_.find(pes_pid);
-  if (pid_state == pids_.end()) {
+  PidState* pid_state =
+      pes_pid < pids_.size() ? pids_[pes_pid].get() : nullptr;
+  if (!pid_state) {
     LOG(ERROR) << "PID State for new stream not found (pid = "
                << new_stream_info->track_id() << ").";
     return;
@@ -388,10 +416,10 @@ void Mp2tMediaParser::OnNewStreamInfo(
       // and set here from audio_type
     }
 
-    pid_state->second->set_config(new_stream_info);
+    pid_state->set_config(new_stream_info);
   } else {
     LOG(WARNING) << "Ignoring unsupported stream with pid=" << pes_pid;
-    pid_state->second->Disable();
+    pid_state->Disable();
   }
 
   // Finish initialization if all streams have configs.
@@ -403,20 +431,18 @@ bool Mp2tMediaParser::FinishInitializationIfNeeded() {
   if (is_initialized_)
     return true;
 
-  // Wait for more data to come to finish initialization.
-  if (pids_.empty())
-    return true;
-
   std::vector<std::shared_ptr<StreamInfo>> all_stream_info;
   uint32_t num_es(0);
-  for (const auto& pair : pids_) {
-    if ((pair.second->pid_type() == PidState::kPidAudioPes ||
-         pair.second->pid_type() == PidState::kPidVideoPes ||
-         pair.second->pid_type() == PidState::kPidTextPes) &&
-        pair.second->IsEnabled()) {
+  for (const std::unique_ptr<PidState>& pid_state : pids_) {
+    if (!pid_state)
+      continue;
+    if ((pid_state->pid_type() == PidState::kPidAudioPes ||
+         pid_state->pid_type() == PidState::kPidVideoPes ||
+         pid_state->pid_type() == PidState::kPidTextPes) &&
+        pid_state->IsEnabled()) {
       ++num_es;
-      if (pair.second->config())
-        all_stream_info.push_back(pair.second->config());
+      if (pid_state->config())
+        all_stream_info.push_back(pid_state->config());
     }
   }
   if (num_es && (all_stream_info.size() == num_es)) {
@@ -440,13 +466,14 @@ void Mp2tMediaParser::OnEmitMediaSample(
                       << " pts=" << new_sample->pts();
 
   // Add the sample to the appropriate PID sample queue.
-  auto pid_state = pids_.find(pes_pid);
-  if (pid_state == pids_.end()) {
+  PidState* pid_state =
+      pes_pid < pids_.size() ? pids_[pes_pid].get() : nullptr;
+  if (!pid_state) {
     LOG(ERROR) << "PID State for new sample not found (pid = " << pes_pid
                << ").";
     return;
   }
-  pid_state->second->media_sample_queue_.push_back(std::move(new_sample));
+  pid_state->media_sample_queue_.push_back(std::move(new_sample));
 }
 
 void Mp2tMediaParser::OnEmitTextSample(uint32_t pes_pid,
@@ -457,13 +484,14 @@ void Mp2tMediaParser::OnEmitTextSample(uint32_t pes_pid,
                       << " start=" << new_sample->start_time();
 
   // Add the sample to the appropriate PID sample queue.
-  auto pid_state = pids_.find(pes_pid);
-  if (pid_state == pids_.end()) {
+  PidState* pid_state =
+      pes_pid < pids_.size() ? pids_[pes_pid].get() : nullptr;
+  if (!pid_state) {
     LOG(ERROR) << "PID State for new sample not found (pid = "
                << pes_pid << ").";
     return;
   }
-  pid_state->second->text_sample_queue_.push_back(std::move(new_sample));
+  pid_state->text_sample_queue_.push_back(std::move(new_sample));
 }
 
 bool Mp2tMediaParser::EmitRemainingSamples() {
@@ -474,16 +502,19 @@ bool Mp2tMediaParser::EmitRemainingSamples() {
     return true;
 
   // Buffer emission.
-  for (const auto& pid_pair : pids_) {
-    for (auto sample : pid_pair.second->media_sample_queue_) {
-      RCHECK(new_media_sample_cb_(pid_pair.first, sample));
+  for (size_t pid = 0; pid < pids_.size(); ++pid) {
+    PidState* pid_state = pids_[pid].get();
+    if (!pid_state)
+      continue;
+    for (auto sample : pid_state->media_sample_queue_) {
+      RCHECK(new_media_sample_cb_(pid, sample));
     }
-    pid_pair.second->media_sample_queue_.clear();
+    pid_state->media_sample_queue_.clear();
 
-    for (auto sample : pid_pair.second->text_sample_queue_) {
-      RCHECK(new_text_sample_cb_(pid_pair.first, sample));
+    for (auto sample : pid_state->text_sample_queue_) {
+      RCHECK(new_text_sample_cb_(pid, sample));
     }
-    pid_pair.second->text_sample_queue_.clear();
+    pid_state->text_sample_queue_.clear();
   }
 
   return true;
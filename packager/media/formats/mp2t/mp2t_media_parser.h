@@ -10,6 +10,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <packager/macros/classes.h>
 #include <packager/media/base/byte_queue.h>
@@ -46,6 +47,7 @@ class Mp2tMediaParser : public MediaParser {
             const NewMediaSampleCB& new_media_sample_cb,
             const NewTextSampleCB& new_text_sample_cb,
             KeySource* decryption_key_source) override;
+  void ExcludeTrack(uint32_t track_id) override;
   [[nodiscard]] bool Flush() override;
   [[nodiscard]] bool Parse(const uint8_t* buf, int size) override;
   /// @}
@@ -103,9 +105,12 @@ class Mp2tMediaParser : public MediaParser {
   // Bytes of the TS media.
   ByteQueue ts_byte_queue_;
 
-  // Map of PIDs and their states.  Use an ordered map so manifest generation
-  // has a deterministic order.
-  std::map<int, std::unique_ptr<PidState>> pids_;
+  // TS packets carry a 13-bit PID, so PID states are kept in a flat
+  // PID-indexed table: the per-packet dispatch in Parse() is then an array
+  // index instead of a map lookup. Iterating the table in index order keeps
+  // the deterministic (ascending PID) order manifest generation relies on.
+  static constexpr size_t kNumPids = 8192;
+  std::vector<std::unique_ptr<PidState>> pids_;
 
   // Map of PIDs and their metadata.
   std::map<int, PesMetadata> pes_metadata_;
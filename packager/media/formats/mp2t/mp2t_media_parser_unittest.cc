@@ -191,6 +191,33 @@ TEST_F(Mp2tMediaParserTest, PtsZeroDtsWrapAround) {
   EXPECT_GT(video_max_pts_, static_cast<int64_t>(1) << 33);
 }
 
+TEST_F(Mp2tMediaParserTest, ExcludeTrack) {
+  InitializeParser();
+
+  std::vector<uint8_t> buffer = ReadTestDataFile("bear-640x360.ts");
+  ASSERT_FALSE(buffer.empty());
+
+  // Feed data until the parser has reported the streams, then exclude every
+  // track and feed the rest of the file.
+  const size_t kPieceSize = 512;
+  size_t pos = 0;
+  while (stream_map_.empty() && pos < buffer.size()) {
+    size_t append_size = std::min(kPieceSize, buffer.size() - pos);
+    ASSERT_TRUE(AppendData(buffer.data() + pos, append_size));
+    pos += append_size;
+  }
+  ASSERT_FALSE(stream_map_.empty());
+  for (const auto& pair : stream_map_)
+    parser_->ExcludeTrack(pair.first);
+
+  const int video_frames_at_exclusion = video_frame_count_;
+  ASSERT_TRUE(
+      AppendDataInPieces(buffer.data() + pos, buffer.size() - pos, kPieceSize));
+  EXPECT_TRUE(parser_->Flush());
+  // Frames emitted before the exclusion are kept; nothing comes out after it.
+  EXPECT_EQ(video_frames_at_exclusion, video_frame_count_);
+}
+
 TEST_F(Mp2tMediaParserTest, PmtEsDescriptors) {
   //"bear-eng-visualy-impaired-audio.ts" consist of audio stream marked as
   // english audio with commentary for visualy impaired viewer and max
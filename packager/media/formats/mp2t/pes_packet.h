@@ -7,7 +7,9 @@
 #ifndef PACKAGER_MEDIA_FORMATS_MP2T_PES_PACKET_H_
 #define PACKAGER_MEDIA_FORMATS_MP2T_PES_PACKET_H_
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 #include <packager/macros/classes.h>
@@ -51,10 +53,33 @@ class PesPacket {
   /// @param is_key_frame indicates whether it is a key frame.
   void set_is_key_frame(bool is_key_frame) { is_key_frame_ = is_key_frame; }
 
+  /// @return the data owned by this PES. Empty if the packet references an
+  ///         external buffer instead; use payload() to cover both cases.
   const std::vector<uint8_t>& data() const { return data_; }
   /// @return mutable data for this PES.
   std::vector<uint8_t>* mutable_data() { return &data_; }
 
+  /// Make this packet reference @a size bytes of an external shared buffer
+  /// instead of owning a copy. The buffer is retained so the referenced bytes
+  /// stay alive for the lifetime of this packet. Any owned data is dropped.
+  /// @param data is the shared buffer holding the payload.
+  /// @param size is the size of the payload in bytes.
+  void SetDataReference(std::shared_ptr<const uint8_t> data, size_t size) {
+    data_ref_ = std::move(data);
+    data_ref_size_ = size;
+    data_.clear();
+  }
+
+  /// @return a pointer to the payload carried by this PES packet, whether
+  ///         owned or referenced.
+  const uint8_t* payload() const {
+    return data_ref_ ? data_ref_.get() : data_.data();
+  }
+  /// @return the size of the payload carried by this PES packet.
+  size_t payload_size() const {
+    return data_ref_ ? data_ref_size_ : data_.size();
+  }
+
  private:
   uint8_t stream_id_ = 0;
 
@@ -64,6 +89,10 @@ class PesPacket {
   bool is_key_frame_ = false;
 
   std::vector<uint8_t> data_;
+  // Set when the payload is a slice of an external buffer; see
+  // SetDataReference().
+  std::shared_ptr<const uint8_t> data_ref_;
+  size_t data_ref_size_ = 0;
 
   DISALLOW_COPY_AND_ASSIGN(PesPacket);
 };
@@ -105,13 +105,16 @@ bool PesPacketGenerator::PushSample(const MediaSample& sample) {
   if (stream_type_ == kStreamVideo) {
     DCHECK(converter_);
     std::vector<SubsampleEntry> subsamples;
-    if (sample.decrypt_config())
-      subsamples = sample.decrypt_config()->subsamples();
+    if (sample.decrypt_config()) {
+      // The converter amends the list in place, so copy into the
+      // std::vector its interface expects.
+      const auto& entries = sample.decrypt_config()->subsamples();
+      subsamples.assign(entries.begin(), entries.end());
+    }
     const bool kEscapeEncryptedNalu = true;
     std::vector<uint8_t> byte_stream;
     if (!converter_->ConvertUnitToByteStreamWithSubsamples(
-            sample.data(), sample.data_size(), sample.is_key_frame(),
-            kEscapeEncryptedNalu, &byte_stream, &subsamples)) {
+            sample, kEscapeEncryptedNalu, &byte_stream, &subsamples)) {
       LOG(ERROR) << "Failed to convert sample to byte stream.";
       return false;
     }
@@ -123,20 +126,22 @@ bool PesPacketGenerator::PushSample(const MediaSample& sample) {
   }
   DCHECK_EQ(stream_type_, kStreamAudio);
 
-  std::vector<uint8_t> audio_frame;
-
   // AAC is carried in ADTS.
   if (adts_converter_) {
+    std::vector<uint8_t> audio_frame;
     if (!adts_converter_->ConvertToADTS(sample.data(), sample.data_size(),
                                         &audio_frame))
       return false;
+    current_processing_pes_->mutable_data()->swap(audio_frame);
   } else {
-    audio_frame.assign(sample.data(), sample.data() + sample.data_size());
+    // No conversion is needed for AC3, E-AC3 and MP3; reference the sample
+    // payload instead of copying it.
+    current_processing_pes_->SetDataReference(sample.shared_data(),
+                                              sample.data_size());
   }
 
   // TODO(rkuriowa): Put multiple samples in the PES packet to reduce # of PES
   // packets.
-  current_processing_pes_->mutable_data()->swap(audio_frame);
   current_processing_pes_->set_stream_id(audio_stream_id_);
   pes_packets_.push_back(std::move(current_processing_pes_));
   return true;
@@ -19,7 +19,9 @@ namespace {
 const int32_t kTsTimescale = 90000;
 }  // namespace
 
-TsMuxer::TsMuxer(const MuxerOptions& muxer_options) : Muxer(muxer_options) {}
+TsMuxer::TsMuxer(const MuxerOptions& muxer_options)
+    : Muxer(muxer_options),
+      segment_number_(muxer_options.initial_segment_number) {}
 TsMuxer::~TsMuxer() {}
 
 Status TsMuxer::InitializeMuxer() {
@@ -81,8 +83,9 @@ Status TsMuxer::FinalizeSegment(size_t stream_id,
   std::string segment_path =
       options().segment_template.empty()
           ? options().output_file_name
-          : GetSegmentName(options().segment_template, segment_start_timestamp,
-                           segment_number_++, options().bandwidth);
+          : segment_name_template().Apply(segment_start_timestamp,
+                                          segment_number_++,
+                                          options().bandwidth);
 
   const int64_t file_size = segmenter_->segment_buffer()->Size();
 
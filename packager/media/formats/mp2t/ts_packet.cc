@@ -4,6 +4,7 @@
 
 #include <packager/media/formats/mp2t/ts_packet.h>
 
+#include <cstring>
 #include <memory>
 
 #include <absl/log/check.h>
@@ -21,11 +22,22 @@ static const uint8_t kTsHeaderSyncword = 0x47;
 // static
 int TsPacket::Sync(const uint8_t* buf, int size) {
   int k = 0;
-  for (; k < size; k++) {
+  while (k < size) {
+    // Find the next syncword candidate with memchr, which C libraries
+    // vectorize, instead of testing every byte by hand. For the common case
+    // of an already aligned buffer this is a single comparison.
+    const uint8_t* candidate = static_cast<const uint8_t*>(
+        memchr(&buf[k], kTsHeaderSyncword, size - k));
+    if (!candidate) {
+      k = size;
+      break;
+    }
+    k = static_cast<int>(candidate - buf);
+
     // Verify that we have 4 syncwords in a row when possible,
     // this should improve synchronization robustness.
     bool is_header = true;
-    for (int i = 0; i < 4; i++) {
+    for (int i = 1; i < 4; i++) {
       int idx = k + i * kPacketSize;
       if (idx >= size)
         break;
@@ -39,6 +51,7 @@ int TsPacket::Sync(const uint8_t* buf, int size) {
     }
     if (is_header)
       break;
+    k++;
   }
 
   if (k != 0) {
@@ -6,6 +6,8 @@
 
 #include <packager/media/formats/mp2t/ts_packet_writer_util.h>
 
+#include <algorithm>
+
 #include <absl/log/check.h>
 #include <absl/log/log.h>
 
@@ -122,6 +124,26 @@ void WritePayloadToBufferWriter(const uint8_t* payload,
                                 uint64_t pcr_base,
                                 ContinuityCounter* continuity_counter,
                                 BufferWriter* writer) {
+  const PayloadRegion region = {payload, payload_size};
+  WritePayloadRegionsToBufferWriter(&region, 1, payload_unit_start_indicator,
+                                    pid, has_pcr, pcr_base, continuity_counter,
+                                    writer);
+}
+
+void WritePayloadRegionsToBufferWriter(const PayloadRegion* regions,
+                                       size_t num_regions,
+                                       bool payload_unit_start_indicator,
+                                       int pid,
+                                       bool has_pcr,
+                                       uint64_t pcr_base,
+                                       ContinuityCounter* continuity_counter,
+                                       BufferWriter* writer) {
+  size_t payload_size = 0;
+  for (size_t i = 0; i < num_regions; ++i)
+    payload_size += regions[i].size;
+
+  size_t region_index = 0;
+  size_t region_offset = 0;
   size_t payload_bytes_written = 0;
 
   do {
@@ -141,20 +163,31 @@ void WritePayloadToBufferWriter(const uint8_t* payload,
     writer->AppendInt(static_cast<uint8_t>(adaptation_field_control << 4 |
                                            continuity_counter->GetNext()));
 
+    size_t write_bytes = kTsPacketMaximumPayloadSize;
     if (has_adaptation_field) {
       const size_t before = writer->Size();
       WriteAdaptationField(has_pcr, pcr_base, bytes_left, writer);
       const size_t bytes_for_adaptation_field = writer->Size() - before;
+      write_bytes -= bytes_for_adaptation_field;
+    }
 
-      const size_t write_bytes =
-          kTsPacketMaximumPayloadSize - bytes_for_adaptation_field;
-      writer->AppendArray(payload + payload_bytes_written, write_bytes);
-      payload_bytes_written += write_bytes;
-    } else {
-      writer->AppendArray(payload + payload_bytes_written,
-                          kTsPacketMaximumPayloadSize);
-      payload_bytes_written += kTsPacketMaximumPayloadSize;
+    // Gather the packet payload from the source regions.
+    size_t remaining = write_bytes;
+    while (remaining > 0) {
+      DCHECK_LT(region_index, num_regions);
+      const PayloadRegion& region = regions[region_index];
+      const size_t available = region.size - region_offset;
+      if (available == 0) {
+        ++region_index;
+        region_offset = 0;
+        continue;
+      }
+      const size_t chunk = std::min(remaining, available);
+      writer->AppendArray(region.data + region_offset, chunk);
+      region_offset += chunk;
+      remaining -= chunk;
     }
+    payload_bytes_written += write_bytes;
 
     // Once written, not needed for this payload.
     has_pcr = false;
@@ -40,6 +40,34 @@ void WritePayloadToBufferWriter(const uint8_t* payload,
                                 ContinuityCounter* continuity_counter,
                                 BufferWriter* output);
 
+/// A contiguous piece of payload. Multiple regions can be packetized as one
+/// logical payload without gathering them into a contiguous buffer first.
+struct PayloadRegion {
+  const uint8_t* data;
+  size_t size;
+};
+
+/// Scatter-gather variant of WritePayloadToBufferWriter(). The regions are
+/// packetized back to back as if they were one payload; the bytes are copied
+/// only once, from their source regions straight into the TS packets in
+/// @a output.
+/// @param regions points to the payload regions, in order.
+/// @param num_regions is the number of regions.
+/// @param payload_unit_start_indicator is the same as the definition in spec.
+/// @param pid is the same the same defition in the spec.
+/// @param has_pcr is true if @a pcr_base should be used.
+/// @param pcr_base is the PCR_base value in the spec.
+/// @param continuity_counter is the continuity_counter for this TS packet.
+/// @param output is where the TS packets get written.
+void WritePayloadRegionsToBufferWriter(const PayloadRegion* regions,
+                                       size_t num_regions,
+                                       bool payload_unit_start_indicator,
+                                       int pid,
+                                       bool has_pcr,
+                                       uint64_t pcr_base,
+                                       ContinuityCounter* continuity_counter,
+                                       BufferWriter* output);
+
 }  // namespace mp2t
 }  // namespace media
 }  // namespace shaka
@@ -12,33 +12,9 @@
 
 #include <packager/macros/logging.h>
 #include <packager/media/base/bit_reader.h>
+#include <packager/media/formats/mp2t/crc32_mpeg2.h>
 #include <packager/media/formats/mp2t/mp2t_common.h>
 
-static bool IsCrcValid(const uint8_t* buf, int size) {
-  uint32_t crc = 0xffffffffu;
-  const uint32_t kCrcPoly = 0x4c11db7;
-
-  for (int k = 0; k < size; k++) {
-    int nbits = 8;
-    uint32_t data_msb_aligned = buf[k];
-    data_msb_aligned <<= (32 - nbits);
-
-    while (nbits > 0) {
-      if ((data_msb_aligned ^ crc) & 0x80000000) {
-        crc <<= 1;
-        crc ^= kCrcPoly;
-      } else {
-        crc <<= 1;
-      }
-
-      data_msb_aligned <<= 1;
-      nbits--;
-    }
-  }
-
-  return (crc == 0);
-}
-
 namespace shaka {
 namespace media {
 namespace mp2t {
@@ -110,7 +86,7 @@ bool TsSectionPsi::Parse(bool payload_unit_start_indicator,
   }
 
   // Verify the CRC.
-  RCHECK(IsCrcValid(raw_psi, psi_length));
+  RCHECK(VerifyCrc32Mpeg2(raw_psi, psi_length));
 
   // Parse the PSI section.
   BitReader bit_reader(raw_psi, raw_psi_size);
@@ -6,9 +6,12 @@
 
 #include <packager/media/formats/mp2t/ts_segmenter.h>
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
 
 #include <absl/log/check.h>
+#include <absl/log/log.h>
 
 #include <packager/macros/status.h>
 #include <packager/media/base/audio_stream_info.h>
@@ -34,10 +37,61 @@ bool IsVideoCodec(Codec codec) {
   return codec >= kCodecVideo && codec < kCodecVideoMaxPlusOne;
 }
 
+const size_t kTsPacketSize = 188;
+const int64_t kTsPacketBits = kTsPacketSize * 8;
+// PCR base is a 33-bit 90 kHz counter.
+const uint64_t kPcrBaseModulus = 1ULL << 33;
+
+// A block of consecutive null (PID 0x1FFF) packets, so stuffing runs are
+// appended a block at a time instead of packet by packet.
+const size_t kNullBlockPackets = 8;
+
+const uint8_t* NullPacketBlock() {
+  static const uint8_t* block = []() {
+    // Header is sync byte, PID 0x1FFF, payload only, continuity counter 0;
+    // null packet payload bytes are arbitrary.
+    auto* data = new uint8_t[kNullBlockPackets * kTsPacketSize];
+    memset(data, 0xFF, kNullBlockPackets * kTsPacketSize);
+    for (size_t i = 0; i < kNullBlockPackets; ++i) {
+      uint8_t* packet = data + i * kTsPacketSize;
+      packet[0] = 0x47;
+      packet[1] = 0x1F;
+      packet[2] = 0xFF;
+      packet[3] = 0x10;
+    }
+    return data;
+  }();
+  return block;
+}
+
+bool PacketHasPcr(const uint8_t* packet) {
+  const bool has_adaptation_field = packet[3] & 0x20;
+  // Adaptation field length, then the flags byte with PCR_flag at 0x10.
+  return has_adaptation_field && packet[4] >= 1 && (packet[5] & 0x10);
+}
+
+uint64_t ReadPcrBase(const uint8_t* packet) {
+  return (uint64_t{packet[6]} << 25) | (uint64_t{packet[7]} << 17) |
+         (uint64_t{packet[8]} << 9) | (uint64_t{packet[9]} << 1) |
+         (packet[10] >> 7);
+}
+
+// Same layout as WriteAdaptationField() in ts_packet_writer_util.cc: 33-bit
+// base, 6 reserved bits set, 9-bit extension zero.
+void WritePcrBase(uint64_t pcr_base, uint8_t* packet) {
+  packet[6] = (pcr_base >> 25) & 0xFF;
+  packet[7] = (pcr_base >> 17) & 0xFF;
+  packet[8] = (pcr_base >> 9) & 0xFF;
+  packet[9] = (pcr_base >> 1) & 0xFF;
+  packet[10] = ((pcr_base & 1) << 7) | 0x7E;
+  packet[11] = 0;
+}
+
 }  // namespace
 
 TsSegmenter::TsSegmenter(const MuxerOptions& options, MuxerListener* listener)
     : listener_(listener),
+      mux_rate_bps_(options.ts_mux_rate_bps),
       transport_stream_timestamp_offset_(
           options.transport_stream_timestamp_offset_ms * kTsTimescale / 1000),
       pes_packet_generator_(
@@ -169,6 +223,102 @@ Status TsSegmenter::FinalizeSegment(int64_t start_timestamp, int64_t duration) {
   Status status = WritePesPackets();
   if (!status.ok())
     return status;
+  if (mux_rate_bps_ > 0 && segment_started_)
+    return ApplyCbrMuxSchedule(duration);
+  return Status::OK;
+}
+
+Status TsSegmenter::ApplyCbrMuxSchedule(int64_t duration) {
+  DCHECK_GT(mux_rate_bps_, 0);
+  if (segment_buffer_.Size() % kTsPacketSize != 0) {
+    return Status(error::MUXER_FAILURE,
+                  "Segment buffer is not TS packet aligned.");
+  }
+  const int64_t payload_packets = segment_buffer_.Size() / kTsPacketSize;
+  if (payload_packets == 0)
+    return Status::OK;
+
+  // |duration| is in the input timescale; the schedule is computed in TS's
+  // 90 kHz clock.
+  const int64_t duration_ticks =
+      static_cast<int64_t>(duration * timescale_scale_);
+  // The packet count that occupies exactly the segment duration at the mux
+  // rate. Every fractional tick kept by integer division is stuffing the
+  // next segment does not have to carry, so rounding down is safe.
+  const int64_t total_packets = duration_ticks * mux_rate_bps_ /
+                                (static_cast<int64_t>(kTsTimescale) *
+                                 kTsPacketBits);
+  if (total_packets <= payload_packets) {
+    LOG(WARNING) << "CBR mux rate " << mux_rate_bps_
+                 << " bps is below the stream's rate for this segment ("
+                 << payload_packets << " packets in " << duration_ticks
+                 << " ticks); leaving the segment variable-rate.";
+    return Status::OK;
+  }
+  const int64_t null_packets = total_packets - payload_packets;
+
+  // At a constant rate each packet departs 1504/rate seconds after its
+  // predecessor. Track the departure clock in 90 kHz ticks with an integer
+  // remainder so the schedule never drifts, and restamp every PCR to its
+  // carrier packet's scheduled departure. The first PCR anchors the schedule
+  // so timestamps stay aligned with the (unchanged) PTS/DTS.
+  const int64_t ticks_per_packet_num = kTsPacketBits * 90000;
+  int64_t departure_ticks = 0;
+  int64_t departure_remainder = 0;
+  const auto next_departure = [&]() {
+    departure_ticks += ticks_per_packet_num / mux_rate_bps_;
+    departure_remainder += ticks_per_packet_num % mux_rate_bps_;
+    if (departure_remainder >= mux_rate_bps_) {
+      ++departure_ticks;
+      departure_remainder -= mux_rate_bps_;
+    }
+  };
+
+  BufferWriter cbr_buffer(static_cast<size_t>(total_packets) * kTsPacketSize);
+  const uint8_t* input = segment_buffer_.Buffer();
+  bool have_pcr_anchor = false;
+  uint64_t pcr_anchor_base = 0;
+  // Token bucket spreading |null_packets| nulls over |payload_packets|
+  // payload packets: every payload packet deposits |null_packets| tokens and
+  // each emitted null costs |payload_packets|, which distributes the nulls
+  // evenly and exactly.
+  int64_t stuffing_tokens = 0;
+
+  for (int64_t i = 0; i < payload_packets; ++i) {
+    const uint8_t* packet = input + i * kTsPacketSize;
+    if (PacketHasPcr(packet)) {
+      uint8_t patched[kTsPacketSize];
+      memcpy(patched, packet, kTsPacketSize);
+      if (!have_pcr_anchor) {
+        pcr_anchor_base =
+            (ReadPcrBase(packet) + kPcrBaseModulus -
+             (departure_ticks % kPcrBaseModulus)) %
+            kPcrBaseModulus;
+        have_pcr_anchor = true;
+      }
+      WritePcrBase((pcr_anchor_base + departure_ticks) % kPcrBaseModulus,
+                   patched);
+      cbr_buffer.AppendArray(patched, kTsPacketSize);
+    } else {
+      cbr_buffer.AppendArray(packet, kTsPacketSize);
+    }
+    next_departure();
+
+    stuffing_tokens += null_packets;
+    int64_t run = stuffing_tokens / payload_packets;
+    stuffing_tokens %= payload_packets;
+    while (run > 0) {
+      const int64_t block = std::min<int64_t>(run, kNullBlockPackets);
+      cbr_buffer.AppendArray(NullPacketBlock(), block * kTsPacketSize);
+      for (int64_t j = 0; j < block; ++j)
+        next_departure();
+      run -= block;
+    }
+  }
+
+  DCHECK_EQ(cbr_buffer.Size(),
+            static_cast<size_t>(total_packets) * kTsPacketSize);
+  segment_buffer_.Swap(&cbr_buffer);
   return Status::OK;
 }
 
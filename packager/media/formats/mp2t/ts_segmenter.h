@@ -85,8 +85,18 @@ class TsSegmenter {
   // Writes PES packets (carried in TsPackets) to a buffer.
   Status WritePesPackets();
 
+  // Rewrites the finished segment in segment_buffer_ to constant rate:
+  // null packets are interleaved on an integer-arithmetic schedule so the
+  // segment occupies exactly |duration| (input timescale) at mux_rate_bps_,
+  // and PCRs are restamped to the scheduled packet departure times. Called
+  // from FinalizeSegment() when mux_rate_bps_ is nonzero.
+  Status ApplyCbrMuxSchedule(int64_t duration);
+
   MuxerListener* const listener_;
 
+  // Nonzero selects CBR output at this rate in bits per second.
+  const int64_t mux_rate_bps_ = 0;
+
   // Codec for the stream.
   Codec codec_ = kUnknownCodec;
   std::vector<uint8_t> audio_codec_config_;
@@ -6,6 +6,8 @@
 
 #include <packager/media/formats/mp2t/ts_segmenter.h>
 
+#include <cstring>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -397,6 +399,74 @@ TEST_F(TsSegmenterTest, EncryptedSample) {
   EXPECT_OK(segmenter.AddSample(*sample2));
 }
 
+TEST_F(TsSegmenterTest, CbrMuxScheduleStuffsToConstantRate) {
+  std::shared_ptr<VideoStreamInfo> stream_info(new VideoStreamInfo(
+      kTrackId, kTimeScale, kDuration, kH264Codec,
+      H26xStreamFormat::kAnnexbByteStream, kCodecString, kExtraData,
+      std::size(kExtraData), kWidth, kHeight, kPixelWidth, kPixelHeight,
+      kTransferCharacteristics, kTrickPlayFactor, kNaluLengthSize, kLanguage,
+      kIsEncrypted));
+  MuxerOptions options;
+  options.segment_template = "file$Number$.ts";
+  // 5 TS packets (188 bytes = 1504 bits each) per second.
+  options.ts_mux_rate_bps = 7520;
+  TsSegmenter segmenter(options, nullptr);
+
+  EXPECT_CALL(*mock_pes_packet_generator_, Initialize(_))
+      .WillOnce(Return(true));
+  EXPECT_CALL(*mock_pes_packet_generator_, Flush()).WillOnce(Return(true));
+  EXPECT_CALL(*mock_pes_packet_generator_, NumberOfReadyPesPackets())
+      .WillOnce(Return(0u));
+  segmenter.InjectPesPacketGeneratorForTesting(
+      std::move(mock_pes_packet_generator_));
+  EXPECT_OK(segmenter.Initialize(*stream_info));
+
+  // Hand-craft a two packet segment: a plain payload packet and one carrying
+  // a PCR (adaptation field with PCR_flag, base 900, extension 0).
+  const size_t kPacketSize = 188;
+  uint8_t plain[kPacketSize];
+  memset(plain, 0xAA, kPacketSize);
+  plain[0] = 0x47;
+  plain[1] = 0x00;
+  plain[2] = 0x50;
+  plain[3] = 0x10;
+  uint8_t with_pcr[kPacketSize];
+  memset(with_pcr, 0xBB, kPacketSize);
+  with_pcr[0] = 0x47;
+  with_pcr[1] = 0x00;
+  with_pcr[2] = 0x50;
+  with_pcr[3] = 0x30;
+  with_pcr[4] = 7;     // adaptation_field_length.
+  with_pcr[5] = 0x10;  // PCR_flag.
+  with_pcr[6] = 0x00;
+  with_pcr[7] = 0x00;
+  with_pcr[8] = 0x01;
+  with_pcr[9] = 0xC2;
+  with_pcr[10] = 0x7E;
+  with_pcr[11] = 0x00;
+  segmenter.segment_buffer()->AppendArray(plain, kPacketSize);
+  segmenter.segment_buffer()->AppendArray(with_pcr, kPacketSize);
+  segmenter.set_segment_started(true);
+
+  // One second at the input timescale (90 kHz): the segment must come out as
+  // exactly 5 packets, the 2 payload packets in order with 3 nulls spread
+  // between them.
+  EXPECT_OK(segmenter.FinalizeSegment(0, 90000));
+
+  BufferWriter* buffer = segmenter.segment_buffer();
+  ASSERT_EQ(5 * kPacketSize, buffer->Size());
+  const uint8_t* data = buffer->Buffer();
+  EXPECT_EQ(0xAA, data[0 * kPacketSize + 20]);
+  EXPECT_EQ(0xBB, data[2 * kPacketSize + 20]);
+  for (size_t null_index : {1, 3, 4}) {
+    EXPECT_EQ(0x47, data[null_index * kPacketSize]);
+    EXPECT_EQ(0x1F, data[null_index * kPacketSize + 1]);
+    EXPECT_EQ(0xFF, data[null_index * kPacketSize + 2]);
+  }
+  // The first PCR anchors the constant-rate schedule, so it is unchanged.
+  EXPECT_EQ(0, memcmp(with_pcr + 6, data + 2 * kPacketSize + 6, 6));
+}
+
 }  // namespace mp2t
 }  // namespace media
 }  // namespace shaka
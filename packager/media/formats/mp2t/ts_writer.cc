@@ -52,8 +52,7 @@ const bool kPayloadUnitStartIndicator = true;
 // without adaptation field or the payload.
 const int kTsPacketHeaderSize = 4;
 const int kTsPacketSize = 188;
-const int kTsPacketMaximumPayloadSize =
-    kTsPacketSize - kTsPacketHeaderSize;
+const size_t kTsPacketMaximumPayloadSize = kTsPacketSize - kTsPacketHeaderSize;
 
 const size_t kMaxPesPacketLengthValue = 0xFFFF;
 
@@ -90,95 +89,101 @@ void WritePtsOrDts(uint8_t leading_bits,
 
 bool WritePesToBuffer(const PesPacket& pes,
                       ContinuityCounter* continuity_counter,
+                      BufferWriter* pes_header_writer,
                       BufferWriter* current_buffer) {
   // The size of the length field.
   const int kAdaptationFieldLengthSize = 1;
   // The size of the flags field.
   const int kAdaptationFieldHeaderSize = 1;
   const int kPcrFieldSize = 6;
-  const int kTsPacketMaxPayloadWithPcr =
+  const size_t kTsPacketMaxPayloadWithPcr =
       kTsPacketMaximumPayloadSize - kAdaptationFieldLengthSize -
       kAdaptationFieldHeaderSize - kPcrFieldSize;
   const uint64_t pcr_base = pes.has_dts() ? pes.dts() : pes.pts();
   const int pid = ProgramMapTableWriter::kElementaryPid;
 
-  // This writer will hold part of PES packet after PES_packet_length field.
-  BufferWriter pes_header_writer;
+  uint8_t pes_header_data_length = 0;
+  if (pes.has_pts())
+    pes_header_data_length += 5;
+  if (pes.has_dts())
+    pes_header_data_length += 5;
+  // Size of the fields after PES_packet_length: the flag bytes, the header
+  // data length byte and the optional fields.
+  const size_t pes_packet_length =
+      pes.payload_size() + pes_header_data_length + 3;
+
+  // This writer holds the PES packet up to and including the header data; the
+  // payload itself is referenced below instead of being copied here.
+  pes_header_writer->Clear();
+  pes_header_writer->AppendNBytes(static_cast<uint64_t>(0x000001), 3);
+  pes_header_writer->AppendInt(pes.stream_id());
+  pes_header_writer->AppendInt(static_cast<uint16_t>(
+      pes_packet_length > kMaxPesPacketLengthValue ? 0 : pes_packet_length));
   // The first bit must be '10' for PES with video or audio stream id. The other
   // flags (bits) don't matter so they are 0.
-  pes_header_writer.AppendInt(static_cast<uint8_t>(0x80));
-  pes_header_writer.AppendInt(
+  pes_header_writer->AppendInt(static_cast<uint8_t>(0x80));
+  pes_header_writer->AppendInt(
       static_cast<uint8_t>(static_cast<int>(pes.has_pts()) << 7 |
                            static_cast<int>(pes.has_dts()) << 6
                            // Other fields are all 0.
                            ));
-  uint8_t pes_header_data_length = 0;
-  if (pes.has_pts())
-    pes_header_data_length += 5;
-  if (pes.has_dts())
-    pes_header_data_length += 5;
-  pes_header_writer.AppendInt(pes_header_data_length);
+  pes_header_writer->AppendInt(pes_header_data_length);
 
   if (pes.has_pts() && pes.has_dts()) {
-    WritePtsOrDts(0x03, pes.pts(), &pes_header_writer);
-    WritePtsOrDts(0x01, pes.dts(), &pes_header_writer);
+    WritePtsOrDts(0x03, pes.pts(), pes_header_writer);
+    WritePtsOrDts(0x01, pes.dts(), pes_header_writer);
   } else if (pes.has_pts()) {
-    WritePtsOrDts(0x02, pes.pts(), &pes_header_writer);
-  }
-
-  // Put the first TS packet's payload into a buffer. This contains the PES
-  // packet's header.
-  BufferWriter first_ts_packet_buffer(kTsPacketSize);
-  first_ts_packet_buffer.AppendNBytes(static_cast<uint64_t>(0x000001), 3);
-  first_ts_packet_buffer.AppendInt(pes.stream_id());
-  const size_t pes_packet_length = pes.data().size() + pes_header_writer.Size();
-  first_ts_packet_buffer.AppendInt(static_cast<uint16_t>(
-      pes_packet_length > kMaxPesPacketLengthValue ? 0 : pes_packet_length));
-  first_ts_packet_buffer.AppendBuffer(pes_header_writer);
-
-  const size_t available_payload =
-      kTsPacketMaxPayloadWithPcr - first_ts_packet_buffer.Size();
-  const size_t bytes_consumed = std::min(pes.data().size(), available_payload);
-  first_ts_packet_buffer.AppendArray(pes.data().data(), bytes_consumed);
-
-  BufferWriter output_writer;
-  WritePayloadToBufferWriter(first_ts_packet_buffer.Buffer(),
-                             first_ts_packet_buffer.Size(),
-                             kPayloadUnitStartIndicator, pid, kHasPcr, pcr_base,
-                             continuity_counter, &output_writer);
-
-  const size_t remaining_pes_data_size = pes.data().size() - bytes_consumed;
-  if (remaining_pes_data_size > 0) {
-    WritePayloadToBufferWriter(pes.data().data() + bytes_consumed,
-                               remaining_pes_data_size,
-                               !kPayloadUnitStartIndicator, pid, !kHasPcr, 0,
-                               continuity_counter, &output_writer);
+    WritePtsOrDts(0x02, pes.pts(), pes_header_writer);
   }
 
-  current_buffer->AppendBuffer(output_writer);
+  // Reserve the exact packetized size up front so the whole PES is laid out
+  // in one pass without growing |current_buffer|. The first packet carries
+  // the PCR; the rest are full payload packets, with a short tail stuffed to
+  // the packet size.
+  const size_t total_payload_size =
+      pes_header_writer->Size() + pes.payload_size();
+  const size_t first_packet_payload_size =
+      std::min(total_payload_size, kTsPacketMaxPayloadWithPcr);
+  const size_t remaining_size = total_payload_size - first_packet_payload_size;
+  const size_t num_packets =
+      1 + (remaining_size + kTsPacketMaximumPayloadSize - 1) /
+              kTsPacketMaximumPayloadSize;
+  current_buffer->Reserve(num_packets * kTsPacketSize);
+
+  // Packetize the header and the payload as one logical payload. The payload
+  // bytes go straight from the PES packet into |current_buffer| without an
+  // intermediate copy.
+  const PayloadRegion regions[] = {
+      {pes_header_writer->Buffer(), pes_header_writer->Size()},
+      {pes.payload(), pes.payload_size()},
+  };
+  WritePayloadRegionsToBufferWriter(regions, std::size(regions),
+                                    kPayloadUnitStartIndicator, pid, kHasPcr,
+                                    pcr_base, continuity_counter,
+                                    current_buffer);
   return true;
 }
 
 }  // namespace
 
 TsWriter::TsWriter(std::unique_ptr<ProgramMapTableWriter> pmt_writer)
-    : pmt_writer_(std::move(pmt_writer)) {}
+    : pes_header_scratch_(kTsPacketSize), pmt_writer_(std::move(pmt_writer)) {}
 
 TsWriter::~TsWriter() {}
 
 bool TsWriter::NewSegment(BufferWriter* buffer) {
-  BufferWriter psi;
-  WritePatToBuffer(kPat, std::size(kPat), &pat_continuity_counter_, &psi);
+  // The PSI writers append TS packets, so they can write straight into
+  // |buffer| without an intermediate buffer.
+  WritePatToBuffer(kPat, std::size(kPat), &pat_continuity_counter_, buffer);
   if (encrypted_) {
-    if (!pmt_writer_->EncryptedSegmentPmt(&psi)) {
+    if (!pmt_writer_->EncryptedSegmentPmt(buffer)) {
       return false;
     }
   } else {
-    if (!pmt_writer_->ClearSegmentPmt(&psi)) {
+    if (!pmt_writer_->ClearSegmentPmt(buffer)) {
       return false;
     }
   }
-  buffer->AppendBuffer(psi);
 
   return true;
 }
@@ -191,7 +196,7 @@ bool TsWriter::AddPesPacket(std::unique_ptr<PesPacket> pes_packet,
 		            BufferWriter* buffer) {
 
   if (!WritePesToBuffer(*pes_packet, &elementary_stream_continuity_counter_,
-                        buffer)) {
+                        &pes_header_scratch_, buffer)) {
     LOG(ERROR) << "Failed to write pes to buffer.";
     return false;
   }
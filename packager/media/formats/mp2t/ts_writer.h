@@ -58,6 +58,10 @@ class TsWriter {
   ContinuityCounter pat_continuity_counter_;
   ContinuityCounter elementary_stream_continuity_counter_;
 
+  // Scratch for the PES start code and header, reused across PES packets to
+  // avoid a per-packet allocation.
+  BufferWriter pes_header_scratch_;
+
   std::unique_ptr<ProgramMapTableWriter> pmt_writer_;
 };
 
@@ -30,6 +30,10 @@ void Box::Write(BufferWriter* writer) {
   uint32_t size = ComputeSize();
   DCHECK_EQ(size, box_size_);
 
+  // The size of the whole box tree is known now, so a single reservation
+  // covers all the field appends below.
+  writer->Reserve(size);
+
   size_t buffer_size_before_write = writer->Size();
   BoxBuffer buffer(writer);
   CHECK(ReadWriteInternal(&buffer));
@@ -113,6 +113,16 @@ class BoxBuffer {
   }
   /// @}
 
+  /// Read/write a fixed-shape group of numeric fields. In read mode the
+  /// bounds are checked once for the whole group instead of once per field.
+  template <typename... T>
+  bool ReadWriteGroup(T*... fields) {
+    if (reader_)
+      return reader_->ReadGroup(fields...);
+    (writer_->AppendInt(*fields), ...);
+    return true;
+  }
+
   /// Read/write the least significant |num_bytes| of |v| from/to the buffer.
   /// @param num_bytes should not be larger than sizeof(v), i.e. 8.
   /// @return true on success, false otherwise.
@@ -201,8 +211,7 @@ class BoxBuffer {
   bool IgnoreBytes(size_t num_bytes) {
     if (reader_)
       return reader_->SkipBytes(num_bytes);
-    std::vector<uint8_t> vector(num_bytes, 0);
-    writer_->AppendVector(vector);
+    writer_->AppendZeros(num_bytes);
     return true;
   }
 
@@ -214,8 +214,16 @@ bool SampleAuxiliaryInformationOffset::ReadWriteInternal(BoxBuffer* buffer) {
   offsets.resize(count);
 
   size_t num_bytes = (version == 1) ? sizeof(uint64_t) : sizeof(uint32_t);
-  for (uint32_t i = 0; i < count; ++i)
-    RCHECK(buffer->ReadWriteUInt64NBytes(&offsets[i], num_bytes));
+  if (buffer->Reading() && version == 0 && count > 0) {
+    // Decode the 32-bit offsets with a single bounds check, then widen.
+    std::vector<uint32_t> offsets32(count);
+    RCHECK(buffer->reader()->ReadUInt32Array(offsets32.data(), count));
+    for (uint32_t i = 0; i < count; ++i)
+      offsets[i] = offsets32[i];
+  } else {
+    for (uint32_t i = 0; i < count; ++i)
+      RCHECK(buffer->ReadWriteUInt64NBytes(&offsets[i], num_bytes));
+  }
   return true;
 }
 
@@ -239,8 +247,7 @@ bool SampleAuxiliaryInformationSize::ReadWriteInternal(BoxBuffer* buffer) {
   if (flags & 1)
     RCHECK(buffer->IgnoreBytes(8));
 
-  RCHECK(buffer->ReadWriteUInt8(&default_sample_info_size) &&
-         buffer->ReadWriteUInt32(&sample_count));
+  RCHECK(buffer->ReadWriteGroup(&default_sample_info_size, &sample_count));
   if (default_sample_info_size == 0)
     RCHECK(buffer->ReadWriteVector(&sample_info_sizes, sample_count));
   return true;
@@ -346,11 +353,21 @@ bool SampleEncryption::ReadWriteInternal(BoxBuffer* buffer) {
     return false;
   }
 
-  uint32_t sample_count =
+  if (!buffer->Reading() && sample_encryption_entries.empty() &&
+      sample_count > 0) {
+    // The entries were accumulated in wire format as the samples were
+    // encrypted; stitch the pre-built payload in as a single extent.
+    RCHECK(buffer->ReadWriteUInt32(&sample_count));
+    RCHECK(buffer->ReadWriteVector(&sample_encryption_data,
+                                   sample_encryption_data.size()));
+    return true;
+  }
+
+  uint32_t l_sample_count =
       static_cast<uint32_t>(sample_encryption_entries.size());
-  RCHECK(buffer->ReadWriteUInt32(&sample_count));
+  RCHECK(buffer->ReadWriteUInt32(&l_sample_count));
 
-  sample_encryption_entries.resize(sample_count);
+  sample_encryption_entries.resize(l_sample_count);
   for (auto& sample_encryption_entry : sample_encryption_entries) {
     RCHECK(sample_encryption_entry.ReadWrite(
                iv_size, (flags & kUseSubsampleEncryption) != 0, buffer) != 0);
@@ -359,22 +376,28 @@ bool SampleEncryption::ReadWriteInternal(BoxBuffer* buffer) {
 }
 
 size_t SampleEncryption::ComputeSizeInternal() {
-  const uint32_t sample_count =
+  if (sample_encryption_entries.empty() && sample_count > 0) {
+    // Pre-serialized payload; |sample_encryption_data| may legitimately be
+    // empty for full sample encryption with constant iv.
+    return HeaderSize() + sizeof(sample_count) + sample_encryption_data.size();
+  }
+
+  const uint32_t l_sample_count =
       static_cast<uint32_t>(sample_encryption_entries.size());
-  if (sample_count == 0) {
+  if (l_sample_count == 0) {
     // Sample encryption box is optional. Skip it if it is empty.
     return 0;
   }
 
   DCHECK(IsIvSizeValid(iv_size));
-  size_t box_size = HeaderSize() + sizeof(sample_count);
+  size_t box_size = HeaderSize() + sizeof(l_sample_count);
   if (flags & kUseSubsampleEncryption) {
     for (const SampleEncryptionEntry& sample_encryption_entry :
          sample_encryption_entries) {
       box_size += sample_encryption_entry.ComputeSize();
     }
   } else {
-    box_size += sample_count * iv_size;
+    box_size += l_sample_count * iv_size;
   }
   return box_size;
 }
@@ -2649,7 +2672,7 @@ FourCC TrackFragmentRun::BoxType() const {
 }
 
 bool TrackFragmentRun::ReadWriteInternal(BoxBuffer* buffer) {
-  if (!buffer->Reading()) {
+  if (!buffer->Reading() && !version_resolved) {
     // Determine whether version 0 or version 1 should be used.
     // Use version 0 if possible, use version 1 if there is a negative
     // sample_offset value.
@@ -2718,25 +2741,59 @@ bool TrackFragmentRun::ReadWriteInternal(BoxBuffer* buffer) {
       DCHECK(sample_composition_time_offsets.size() == sample_count);
   }
 
-  for (uint32_t i = 0; i < sample_count; ++i) {
-    if (sample_duration_present)
-      RCHECK(buffer->ReadWriteUInt32(&sample_durations[i]));
-    if (sample_size_present)
-      RCHECK(buffer->ReadWriteUInt32(&sample_sizes[i]));
-    if (sample_flags_present)
-      RCHECK(buffer->ReadWriteUInt32(&sample_flags[i]));
-
-    if (sample_composition_time_offsets_present) {
-      if (version == 0) {
-        uint32_t sample_offset = sample_composition_time_offsets[i];
-        RCHECK(buffer->ReadWriteUInt32(&sample_offset));
-        sample_composition_time_offsets[i] = sample_offset;
-      } else {
-        int32_t sample_offset = sample_composition_time_offsets[i];
-        RCHECK(buffer->ReadWriteInt32(&sample_offset));
-        sample_composition_time_offsets[i] = sample_offset;
+  if (buffer->Reading()) {
+    // Mirror of the bulk write below: every present per-sample field is a
+    // 4-byte big-endian value, so the interleaved rows are decoded with a
+    // single bounds check and then scattered into the field vectors.
+    const size_t fields_per_sample =
+        (sample_duration_present ? 1 : 0) + (sample_size_present ? 1 : 0) +
+        (sample_flags_present ? 1 : 0) +
+        (sample_composition_time_offsets_present ? 1 : 0);
+    std::vector<uint32_t> rows(static_cast<size_t>(sample_count) *
+                               fields_per_sample);
+    if (!rows.empty())
+      RCHECK(buffer->reader()->ReadUInt32Array(rows.data(), rows.size()));
+    size_t row = 0;
+    for (uint32_t i = 0; i < sample_count; ++i) {
+      if (sample_duration_present)
+        sample_durations[i] = rows[row++];
+      if (sample_size_present)
+        sample_sizes[i] = rows[row++];
+      if (sample_flags_present)
+        sample_flags[i] = rows[row++];
+
+      if (sample_composition_time_offsets_present) {
+        if (version == 0)
+          sample_composition_time_offsets[i] = rows[row++];
+        else
+          sample_composition_time_offsets[i] =
+              static_cast<int32_t>(rows[row++]);
+      }
+    }
+  } else {
+    // Stage the interleaved per-sample rows and append them in one bulk
+    // write. Every present field is a 4-byte big-endian value (signed
+    // composition offsets have the same byte pattern), so writing per field
+    // would cost sample_count * fields small appends per fragment.
+    std::vector<uint32_t> rows;
+    const size_t fields_per_sample =
+        (sample_duration_present ? 1 : 0) + (sample_size_present ? 1 : 0) +
+        (sample_flags_present ? 1 : 0) +
+        (sample_composition_time_offsets_present ? 1 : 0);
+    rows.reserve(static_cast<size_t>(sample_count) * fields_per_sample);
+    for (uint32_t i = 0; i < sample_count; ++i) {
+      if (sample_duration_present)
+        rows.push_back(sample_durations[i]);
+      if (sample_size_present)
+        rows.push_back(sample_sizes[i]);
+      if (sample_flags_present)
+        rows.push_back(sample_flags[i]);
+      if (sample_composition_time_offsets_present) {
+        rows.push_back(
+            static_cast<uint32_t>(sample_composition_time_offsets[i]));
       }
     }
+    buffer->writer()->AppendUInt32Array(rows.data(), rows.size());
   }
 
   if (buffer->Reading()) {
@@ -122,9 +122,15 @@ struct SampleEncryption : FullBox {
 
   /// We may not know @a iv_size before reading this box. In this case, we will
   /// store sample encryption data for parsing later when @a iv_size is known.
+  /// A muxer may also fill it with entries pre-serialized in wire format (with
+  /// @a sample_count set and @a sample_encryption_entries left empty); the
+  /// payload is then written out as a single extent.
   std::vector<uint8_t> sample_encryption_data;
 
   uint8_t iv_size = kInvalidIvSize;
+  /// Number of entries pre-serialized in @a sample_encryption_data. Unused
+  /// (zero) when the entries are carried in @a sample_encryption_entries.
+  uint32_t sample_count = 0;
   std::vector<SampleEncryptionEntry> sample_encryption_entries;
 };
 
@@ -790,6 +796,10 @@ struct TrackFragmentRun : FullBox {
   std::vector<uint32_t> sample_sizes;
   std::vector<uint32_t> sample_durations;
   std::vector<int64_t> sample_composition_time_offsets;
+  // When true, |version| was already resolved by the producer (tracked
+  // incrementally as composition offsets were added), so the write path does
+  // not rescan |sample_composition_time_offsets| for negative values.
+  bool version_resolved = false;
 };
 
 struct TrackFragment : Box {
@@ -71,16 +71,16 @@ bool BoxReader::ScanChildren() {
   scanned_ = true;
 
   while (pos() < size()) {
-    std::unique_ptr<BoxReader> child(
-        new BoxReader(&data()[pos()], size() - pos()));
+    const size_t child_offset = pos();
+    BoxReader child(&data()[child_offset], size() - child_offset);
     bool err;
-    if (!child->ReadHeader(&err))
+    if (!child.ReadHeader(&err))
       return false;
 
-    FourCC box_type = child->type();
-    size_t box_size = child->size();
-    children_.insert(std::pair<FourCC, std::unique_ptr<BoxReader>>(
-        box_type, std::move(child)));
+    FourCC box_type = child.type();
+    size_t box_size = child.size();
+    children_.insert(
+        std::make_pair(box_type, ChildView{child_offset, box_size}));
     VLOG(2) << "Child " << FourCCToString(box_type) << " size 0x" << std::hex
             << box_size << std::dec;
     RCHECK(SkipBytes(box_size));
@@ -96,7 +96,11 @@ bool BoxReader::ReadChild(Box* child) {
   ChildMap::iterator itr = children_.find(child_type);
   RCHECK(itr != children_.end());
   DVLOG(2) << "Found a " << FourCCToString(child_type) << " box.";
-  RCHECK(child->Parse(itr->second.get()));
+  // Materialize the child on first (and only) access.
+  BoxReader child_reader(&data()[itr->second.offset], itr->second.size);
+  bool err;
+  RCHECK(child_reader.ReadHeader(&err));
+  RCHECK(child->Parse(&child_reader));
   children_.erase(itr);
   return true;
 }
@@ -112,11 +116,16 @@ bool BoxReader::TryReadChild(Box* child) {
 }
 
 bool BoxReader::ReadHeader(bool* err) {
-  uint64_t size = 0;
   *err = false;
 
-  if (!ReadNBytesInto8(&size, sizeof(uint32_t)) || !ReadFourCC(&type_))
+  // Read the 32-bit size and the box type with a single bounds check; this
+  // runs once per box while scanning children.
+  uint32_t size32 = 0;
+  uint32_t type = 0;
+  if (!ReadGroup(&size32, &type))
     return false;
+  type_ = static_cast<FourCC>(type);
+  uint64_t size = size32;
 
   if (size == 0) {
     // Boxes that run to EOS are not supported.
@@ -60,7 +60,8 @@ class BoxReader : public BufferReader {
 
   /// Scan through all boxes within the current box, starting at the current
   /// buffer position. Must be called before any of the @b *Child functions
-  /// work.
+  /// work. Only the child headers are examined here; child contents are
+  /// parsed lazily when one of the @b *Child functions consumes them.
   /// @return true on success, false otherwise.
   [[nodiscard]] bool ScanChildren();
 
@@ -116,10 +117,17 @@ class BoxReader : public BufferReader {
 
   FourCC type_;
 
-  typedef std::multimap<FourCC, std::unique_ptr<BoxReader>> ChildMap;
-
-  // The set of child box FourCCs and their corresponding buffer readers. Only
-  // valid if scanned_ is true.
+  // Byte range of a child box within the parent's buffer, recorded by
+  // ScanChildren(). A BoxReader over the range is only materialized when the
+  // child is consumed.
+  struct ChildView {
+    size_t offset;
+    size_t size;
+  };
+  typedef std::multimap<FourCC, ChildView> ChildMap;
+
+  // The set of child box FourCCs and their byte ranges. Only valid if
+  // scanned_ is true.
   ChildMap children_;
   bool scanned_;
 
@@ -146,7 +154,10 @@ bool BoxReader::TryReadChildren(std::vector<T>* children) {
   children->resize(std::distance(start_itr, end_itr));
   typename std::vector<T>::iterator child_itr = children->begin();
   for (ChildMap::iterator itr = start_itr; itr != end_itr; ++itr) {
-    RCHECK(child_itr->Parse(itr->second.get()));
+    BoxReader child_reader(&data()[itr->second.offset], itr->second.size);
+    bool err;
+    RCHECK(child_reader.ReadHeader(&err));
+    RCHECK(child_itr->Parse(&child_reader));
     ++child_itr;
   }
   children_.erase(start_itr, end_itr);
@@ -33,20 +33,6 @@ int64_t GetSeekPreroll(const StreamInfo& stream_info) {
   return audio_stream_info.seek_preroll_ns();
 }
 
-void NewSampleEncryptionEntry(const DecryptConfig& decrypt_config,
-                              bool use_constant_iv,
-                              TrackFragment* traf) {
-  SampleEncryption& sample_encryption = traf->sample_encryption;
-  SampleEncryptionEntry sample_encryption_entry;
-  if (!use_constant_iv)
-    sample_encryption_entry.initialization_vector = decrypt_config.iv();
-  sample_encryption_entry.subsamples = decrypt_config.subsamples();
-  sample_encryption.sample_encryption_entries.push_back(
-      sample_encryption_entry);
-  traf->auxiliary_size.sample_info_sizes.push_back(
-      sample_encryption_entry.ComputeSize());
-}
-
 }  // namespace
 
 Fragmenter::Fragmenter(std::shared_ptr<const StreamInfo> stream_info,
@@ -85,10 +71,20 @@ Status Fragmenter::AddSample(const MediaSample& sample) {
       sample.is_key_frame() ? TrackFragmentHeader::kUnset
                             : TrackFragmentHeader::kNonKeySampleMask);
 
+  // Track value uniformity as samples arrive, so FinalizeFragment does not
+  // have to rescan the tables above to decide on default-value truns.
+  const TrackFragmentRun& run = traf_->runs[0];
+  if (run.sample_sizes.back() != run.sample_sizes.front())
+    uniform_sample_sizes_ = false;
+  if (run.sample_durations.back() != run.sample_durations.front())
+    uniform_sample_durations_ = false;
+  if (run.sample_flags.back() != run.sample_flags.front())
+    uniform_sample_flags_ = false;
+
   if (sample.decrypt_config()) {
-    NewSampleEncryptionEntry(
+    AddSampleEncryptionEntry(
         *sample.decrypt_config(),
-        !stream_info_->encryption_config().constant_iv.empty(), traf_);
+        !stream_info_->encryption_config().constant_iv.empty());
   }
 
   if (stream_info_->stream_type() == StreamType::kStreamVideo &&
@@ -98,9 +94,25 @@ Status Fragmenter::AddSample(const MediaSample& sample) {
 
   data_->AppendArray(sample.data(), sample.data_size());
 
-  traf_->runs[0].sample_composition_time_offsets.push_back(pts - dts);
-  if (pts != dts)
+  // The composition offset table is only built once a nonzero offset shows
+  // up, so audio and B-frame-free video never tabulate per-sample offsets at
+  // all. The size table always has one entry per sample and carries the
+  // count needed to backfill the zero offsets of the earlier samples.
+  const int64_t composition_time_offset = pts - dts;
+  if (composition_time_offset != 0 &&
+      !(traf_->runs[0].flags &
+        TrackFragmentRun::kSampleCompTimeOffsetsPresentMask)) {
+    traf_->runs[0].sample_composition_time_offsets.assign(
+        traf_->runs[0].sample_sizes.size() - 1, 0);
     traf_->runs[0].flags |= TrackFragmentRun::kSampleCompTimeOffsetsPresentMask;
+  }
+  if (traf_->runs[0].flags &
+      TrackFragmentRun::kSampleCompTimeOffsetsPresentMask) {
+    traf_->runs[0].sample_composition_time_offsets.push_back(
+        composition_time_offset);
+    if (composition_time_offset < 0)
+      has_negative_composition_offset_ = true;
+  }
 
   // Exclude the part of sample with negative pts out of duration calculation as
   // they are not presented.
@@ -144,16 +156,26 @@ Status Fragmenter::InitializeFragment(int64_t first_sample_dts) {
   traf_->auxiliary_size.sample_info_sizes.clear();
   traf_->auxiliary_offset.offsets.clear();
   traf_->sample_encryption.sample_encryption_entries.clear();
+  traf_->sample_encryption.sample_encryption_data.clear();
+  traf_->sample_encryption.sample_count = 0;
+  if (senc_data_)
+    senc_data_->Clear();
+  senc_sample_count_ = 0;
   traf_->sample_group_descriptions.clear();
   traf_->sample_to_groups.clear();
   traf_->header.sample_description_index = 1;  // 1-based.
   traf_->header.flags = TrackFragmentHeader::kDefaultBaseIsMoofMask |
                         TrackFragmentHeader::kSampleDescriptionIndexPresentMask;
 
+  uniform_sample_durations_ = true;
+  uniform_sample_sizes_ = true;
+  uniform_sample_flags_ = true;
+  has_negative_composition_offset_ = false;
+
   fragment_duration_ = 0;
   earliest_presentation_time_ = kInvalidTime;
   first_sap_time_ = kInvalidTime;
-  data_.reset(new BufferWriter());
+  data_.reset(new BufferWriter(data_size_predictor_.PredictedSize()));
   key_frame_infos_.clear();
   return Status::OK;
 }
@@ -171,20 +193,28 @@ Status Fragmenter::FinalizeFragment() {
   // Optimize trun box.
   traf_->runs[0].sample_count =
       static_cast<uint32_t>(traf_->runs[0].sample_sizes.size());
-  if (OptimizeSampleEntries(&traf_->runs[0].sample_durations,
+  // Offset signedness was tracked in AddSample, so the trun version (1 only
+  // when a negative composition offset exists) is resolved here without
+  // rescanning the offset table.
+  traf_->runs[0].version = has_negative_composition_offset_ ? 1 : 0;
+  traf_->runs[0].version_resolved = true;
+  if (OptimizeSampleEntries(uniform_sample_durations_,
+                            &traf_->runs[0].sample_durations,
                             &traf_->header.default_sample_duration)) {
     traf_->header.flags |=
         TrackFragmentHeader::kDefaultSampleDurationPresentMask;
   } else {
     traf_->runs[0].flags |= TrackFragmentRun::kSampleDurationPresentMask;
   }
-  if (OptimizeSampleEntries(&traf_->runs[0].sample_sizes,
+  if (OptimizeSampleEntries(uniform_sample_sizes_,
+                            &traf_->runs[0].sample_sizes,
                             &traf_->header.default_sample_size)) {
     traf_->header.flags |= TrackFragmentHeader::kDefaultSampleSizePresentMask;
   } else {
     traf_->runs[0].flags |= TrackFragmentRun::kSampleSizePresentMask;
   }
-  if (OptimizeSampleEntries(&traf_->runs[0].sample_flags,
+  if (OptimizeSampleEntries(uniform_sample_flags_,
+                            &traf_->runs[0].sample_flags,
                             &traf_->header.default_sample_flags)) {
     traf_->header.flags |= TrackFragmentHeader::kDefaultSampleFlagsPresentMask;
   } else {
@@ -221,6 +251,8 @@ Status Fragmenter::FinalizeFragment() {
         SampleToGroupEntry::kTrackFragmentGroupDescriptionIndexBase + 1;
   }
 
+  data_size_predictor_.AddSample(data_->Size());
+
   fragment_finalized_ = true;
   fragment_initialized_ = false;
   return Status::OK;
@@ -243,7 +275,7 @@ void Fragmenter::GenerateSegmentReference(SegmentReference* reference) const {
 
 Status Fragmenter::FinalizeFragmentForEncryption() {
   SampleEncryption& sample_encryption = traf_->sample_encryption;
-  if (sample_encryption.sample_encryption_entries.empty()) {
+  if (senc_sample_count_ == 0) {
     // This fragment is not encrypted.
     // There are two sample description entries, an encrypted entry and a clear
     // entry, are generated. The 1-based clear entry index is always 2.
@@ -251,21 +283,17 @@ Status Fragmenter::FinalizeFragmentForEncryption() {
     traf_->header.sample_description_index = kClearSampleDescriptionIndex;
     return Status::OK;
   }
-  if (sample_encryption.sample_encryption_entries.size() !=
-      traf_->runs[0].sample_sizes.size()) {
+  if (senc_sample_count_ != traf_->runs[0].sample_sizes.size()) {
     LOG(ERROR) << "Partially encrypted segment is not supported";
     return Status(error::MUXER_FAILURE,
                   "Partially encrypted segment is not supported.");
   }
 
-  const SampleEncryptionEntry& sample_encryption_entry =
-      sample_encryption.sample_encryption_entries.front();
-  const bool use_subsample_encryption =
-      !sample_encryption_entry.subsamples.empty();
-  if (use_subsample_encryption)
-    traf_->sample_encryption.flags |= SampleEncryption::kUseSubsampleEncryption;
-  traf_->sample_encryption.iv_size = static_cast<uint8_t>(
-      sample_encryption_entry.initialization_vector.size());
+  // The entries are already in wire format in |senc_data_|; hand the payload
+  // to the 'senc' box as a single pre-built extent.
+  DCHECK(senc_data_);
+  sample_encryption.sample_count = senc_sample_count_;
+  senc_data_->SwapBuffer(&sample_encryption.sample_encryption_data);
 
   // The offset will be adjusted in Segmenter after knowing moof size.
   traf_->auxiliary_offset.offsets.push_back(0);
@@ -274,7 +302,7 @@ Status Fragmenter::FinalizeFragmentForEncryption() {
   SampleAuxiliaryInformationSize& saiz = traf_->auxiliary_size;
   saiz.sample_count = static_cast<uint32_t>(saiz.sample_info_sizes.size());
   DCHECK_EQ(saiz.sample_info_sizes.size(),
-            traf_->sample_encryption.sample_encryption_entries.size());
+            static_cast<size_t>(senc_sample_count_));
   if (!OptimizeSampleEntries(&saiz.sample_info_sizes,
                              &saiz.default_sample_info_size)) {
     saiz.default_sample_info_size = 0;
@@ -283,7 +311,8 @@ Status Fragmenter::FinalizeFragmentForEncryption() {
   // It should only happen with full sample encryption + constant iv, i.e.
   // 'cbcs' applying to audio.
   if (saiz.default_sample_info_size == 0 && saiz.sample_info_sizes.empty()) {
-    DCHECK(!use_subsample_encryption);
+    DCHECK(!(sample_encryption.flags &
+             SampleEncryption::kUseSubsampleEncryption));
     // ISO/IEC 23001-7:2016(E) The sample auxiliary information would then be
     // empty and should be omitted. Clear saiz and saio boxes so they are not
     // written.
@@ -293,6 +322,38 @@ Status Fragmenter::FinalizeFragmentForEncryption() {
   return Status::OK;
 }
 
+void Fragmenter::AddSampleEncryptionEntry(const DecryptConfig& decrypt_config,
+                                          bool use_constant_iv) {
+  if (!senc_data_)
+    senc_data_.reset(new BufferWriter());
+
+  SampleEncryption& sample_encryption = traf_->sample_encryption;
+  uint32_t entry_size = 0;
+  if (!use_constant_iv) {
+    const std::vector<uint8_t>& iv = decrypt_config.iv();
+    senc_data_->AppendVector(iv);
+    entry_size += static_cast<uint32_t>(iv.size());
+  }
+  const auto& subsamples = decrypt_config.subsamples();
+  if (!subsamples.empty()) {
+    senc_data_->AppendInt(static_cast<uint16_t>(subsamples.size()));
+    for (const SubsampleEntry& subsample : subsamples) {
+      senc_data_->AppendInt(subsample.clear_bytes);
+      senc_data_->AppendInt(subsample.cipher_bytes);
+    }
+    entry_size += static_cast<uint32_t>(
+        sizeof(uint16_t) +
+        (sizeof(uint16_t) + sizeof(uint32_t)) * subsamples.size());
+    sample_encryption.flags |= SampleEncryption::kUseSubsampleEncryption;
+  }
+  if (senc_sample_count_ == 0) {
+    sample_encryption.iv_size =
+        use_constant_iv ? 0 : static_cast<uint8_t>(decrypt_config.iv().size());
+  }
+  ++senc_sample_count_;
+  traf_->auxiliary_size.sample_info_sizes.push_back(entry_size);
+}
+
 bool Fragmenter::StartsWithSAP() const {
   DCHECK(!traf_->runs.empty());
   uint32_t start_sample_flag;
@@ -14,12 +14,14 @@
 #include <absl/log/log.h>
 
 #include <packager/macros/classes.h>
+#include <packager/media/base/segment_size_predictor.h>
 #include <packager/status.h>
 
 namespace shaka {
 namespace media {
 
 class BufferWriter;
+class DecryptConfig;
 class MediaSample;
 class StreamInfo;
 
@@ -83,8 +85,20 @@ class Fragmenter {
   template <typename T>
   bool OptimizeSampleEntries(std::vector<T>* entries, T* default_value);
 
+  /// Variant of the above driven by an incrementally maintained
+  /// @a all_values_identical flag instead of a scan of @a entries, so
+  /// finalizing a fragment stays O(1) in the number of samples.
+  template <typename T>
+  bool OptimizeSampleEntries(bool all_values_identical,
+                             std::vector<T>* entries,
+                             T* default_value);
+
  private:
   Status FinalizeFragmentForEncryption();
+  // Serialize one sample's encryption metadata straight into |senc_data_| in
+  // 'senc' wire format and record its auxiliary information size.
+  void AddSampleEncryptionEntry(const DecryptConfig& decrypt_config,
+                                bool use_constant_iv);
   // Check if the current fragment starts with SAP.
   bool StartsWithSAP() const;
 
@@ -94,10 +108,28 @@ class Fragmenter {
   int64_t seek_preroll_ = 0;
   bool fragment_initialized_ = false;
   bool fragment_finalized_ = false;
+  // Track whether all samples in the current fragment share the same
+  // duration / size / flags. Maintained incrementally in AddSample.
+  bool uniform_sample_durations_ = true;
+  bool uniform_sample_sizes_ = true;
+  bool uniform_sample_flags_ = true;
+  // Whether any composition offset in the current fragment is negative.
+  // Maintained incrementally in AddSample so FinalizeFragment can resolve
+  // the trun version without rescanning the offset table.
+  bool has_negative_composition_offset_ = false;
   int64_t fragment_duration_ = 0;
   int64_t earliest_presentation_time_ = 0;
   int64_t first_sap_time_ = 0;
   std::unique_ptr<BufferWriter> data_;
+  // Sample encryption entries for the current fragment, accumulated directly
+  // in 'senc' wire format as encrypted samples arrive, so finalizing does not
+  // re-serialize per-sample structures. Allocated on the first encrypted
+  // sample; cleared (capacity retained) per fragment.
+  std::unique_ptr<BufferWriter> senc_data_;
+  uint32_t senc_sample_count_ = 0;
+  // Predicts the next fragment's data size from finalized fragments, so
+  // |data_| can be reserved up front instead of growing per sample.
+  SegmentSizePredictor data_size_predictor_;
   // Saves key frames information, for Video.
   std::vector<KeyFrameInfo> key_frame_infos_;
 
@@ -123,6 +155,22 @@ bool Fragmenter::OptimizeSampleEntries(std::vector<T>* entries,
   return true;
 }
 
+template <typename T>
+bool Fragmenter::OptimizeSampleEntries(bool all_values_identical,
+                                       std::vector<T>* entries,
+                                       T* default_value) {
+  DCHECK(entries);
+  DCHECK(default_value);
+  DCHECK(!entries->empty());
+
+  if (!all_values_identical)
+    return false;
+
+  *default_value = entries->front();
+  entries->clear();
+  return true;
+}
+
 }  // namespace mp4
 }  // namespace media
 }  // namespace shaka
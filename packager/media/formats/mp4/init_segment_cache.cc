@@ -0,0 +1,140 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/formats/mp4/init_segment_cache.h>
+
+#include <map>
+
+#include <absl/base/thread_annotations.h>
+#include <absl/log/check.h>
+#include <absl/synchronization/mutex.h>
+#include <mbedtls/md.h>
+
+#include <packager/file.h>
+#include <packager/file/file_closer.h>
+#include <packager/macros/logging.h>
+#include <packager/macros/status.h>
+#include <packager/media/base/buffer_writer.h>
+
+namespace shaka {
+namespace media {
+namespace mp4 {
+namespace {
+
+bool IsLocalPath(const std::string& path) {
+  return path.find("://") == std::string::npos;
+}
+
+std::string Sha256(const uint8_t* data, size_t size) {
+  const mbedtls_md_info_t* md_info =
+      mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+  DCHECK(md_info);
+  std::string hash(mbedtls_md_get_size(md_info), 0);
+  CHECK_EQ(0, mbedtls_md(md_info, data, size,
+                         reinterpret_cast<uint8_t*>(&hash[0])));
+  return hash;
+}
+
+// Process-wide registry of published init segments.
+class Registry {
+ public:
+  static Registry* Instance() {
+    static Registry instance;
+    return &instance;
+  }
+
+  // Returns the first path the given content was published to, or an empty
+  // string if it has not been published.
+  std::string GetPublishedPath(const std::string& hash) {
+    absl::MutexLock auto_lock(&mutex_);
+    auto iter = path_by_hash_.find(hash);
+    return iter == path_by_hash_.end() ? "" : iter->second;
+  }
+
+  // Returns the hash of the content last published to the given path, or an
+  // empty string if nothing has been published there.
+  std::string GetPublishedHash(const std::string& path) {
+    absl::MutexLock auto_lock(&mutex_);
+    auto iter = hash_by_path_.find(path);
+    return iter == hash_by_path_.end() ? "" : iter->second;
+  }
+
+  void OnPublished(const std::string& path, const std::string& hash) {
+    absl::MutexLock auto_lock(&mutex_);
+    // Rewriting a file with new content invalidates it as a copy source for
+    // its previous content.
+    auto iter = hash_by_path_.find(path);
+    if (iter != hash_by_path_.end() && iter->second != hash) {
+      auto canonical = path_by_hash_.find(iter->second);
+      if (canonical != path_by_hash_.end() && canonical->second == path)
+        path_by_hash_.erase(canonical);
+    }
+    hash_by_path_[path] = hash;
+    // The first published path stays the canonical copy source.
+    path_by_hash_.emplace(hash, path);
+  }
+
+ private:
+  absl::Mutex mutex_;
+  // SHA-256 of published init data to the first path it was published to.
+  std::map<std::string, std::string> path_by_hash_ ABSL_GUARDED_BY(mutex_);
+  // Published path to the SHA-256 of its current content.
+  std::map<std::string, std::string> hash_by_path_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace
+
+Status InitSegmentCache::Publish(const std::string& file_name,
+                                 BufferWriter* buffer) {
+  DCHECK(buffer);
+  DCHECK_NE(0u, buffer->Size());
+  const std::string hash = Sha256(buffer->Buffer(), buffer->Size());
+
+  Registry* registry = Registry::Instance();
+  if (registry->GetPublishedHash(file_name) == hash) {
+    // The file already holds exactly these bytes, e.g. the init segment is
+    // rewritten on finalization but the movie box did not change. Skip the
+    // write and, for remote storage, the redundant upload.
+    VLOG(1) << "Init segment " << file_name << " is unchanged; not rewritten.";
+    buffer->Clear();
+    return Status::OK;
+  }
+
+  bool published = false;
+  const std::string source = registry->GetPublishedPath(hash);
+  if (!source.empty() && source != file_name && IsLocalPath(source) &&
+      IsLocalPath(file_name) &&
+      File::GetFileSize(source.c_str()) ==
+          static_cast<int64_t>(buffer->Size())) {
+    // Byte-identical init data is already on local storage; clone the
+    // existing file instead of writing the same bytes again. The size check
+    // rejects sources that grew after publish, e.g. single-file outputs that
+    // append media segments after the init segment.
+    published = File::Copy(source.c_str(), file_name.c_str());
+    if (!published) {
+      LOG(WARNING) << "Failed to copy init segment from " << source << " to "
+                   << file_name << "; writing it instead.";
+    }
+  }
+
+  if (published) {
+    buffer->Clear();
+  } else {
+    std::unique_ptr<File, FileCloser> file(File::Open(file_name.c_str(), "w"));
+    if (!file) {
+      return Status(error::FILE_FAILURE,
+                    "Cannot open file for write " + file_name);
+    }
+    RETURN_IF_ERROR(buffer->WriteToFile(file.get()));
+  }
+
+  registry->OnPublished(file_name, hash);
+  return Status::OK;
+}
+
+}  // namespace mp4
+}  // namespace media
+}  // namespace shaka
@@ -0,0 +1,47 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_MEDIA_FORMATS_MP4_INIT_SEGMENT_CACHE_H_
+#define PACKAGER_MEDIA_FORMATS_MP4_INIT_SEGMENT_CACHE_H_
+
+#include <string>
+
+#include <packager/status.h>
+
+namespace shaka {
+namespace media {
+
+class BufferWriter;
+
+namespace mp4 {
+
+/// Content-addressed publisher for init segments. Multi-period and
+/// multi-rendition jobs frequently produce byte-identical init segments, and
+/// the init segment of a stream is rewritten on finalization even when its
+/// content did not change. InitSegmentCache keeps a process-wide registry of
+/// published init segments keyed by the SHA-256 of their bytes so that
+/// redundant writes (and, for remote storage, redundant uploads) are elided
+/// and repeats on local storage are published by file copy.
+class InitSegmentCache {
+ public:
+  /// Publishes the serialized init segment in @a buffer to @a file_name.
+  /// If @a file_name already holds exactly these bytes from an earlier
+  /// publish, the write is skipped. If byte-identical init data has been
+  /// published to another local file, @a file_name is created by copying that
+  /// file. Otherwise the buffer is written out. @a buffer is cleared on
+  /// success, matching BufferWriter::WriteToFile.
+  /// @return OK on success.
+  static Status Publish(const std::string& file_name, BufferWriter* buffer);
+
+ private:
+  InitSegmentCache() = delete;
+};
+
+}  // namespace mp4
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_MEDIA_FORMATS_MP4_INIT_SEGMENT_CACHE_H_
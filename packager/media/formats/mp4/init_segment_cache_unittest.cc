@@ -0,0 +1,79 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/formats/mp4/init_segment_cache.h>
+
+#include <gtest/gtest.h>
+
+#include <packager/file/file_test_util.h>
+#include <packager/media/base/buffer_writer.h>
+
+namespace shaka {
+namespace media {
+namespace mp4 {
+
+namespace {
+
+// The registry behind InitSegmentCache is process-wide, so every test uses
+// its own payload to stay independent of the others.
+void FillBuffer(const std::string& payload, BufferWriter* buffer) {
+  buffer->AppendString(payload);
+}
+
+}  // namespace
+
+TEST(InitSegmentCacheTest, PublishWritesBufferAndClearsIt) {
+  TempFile temp_file;
+  BufferWriter buffer;
+  FillBuffer("init segment one", &buffer);
+  ASSERT_EQ(Status::OK, InitSegmentCache::Publish(temp_file.path(), &buffer));
+  EXPECT_EQ(0u, buffer.Size());
+  ASSERT_FILE_STREQ(temp_file.path().c_str(), "init segment one");
+}
+
+TEST(InitSegmentCacheTest, UnchangedContentIsNotRewritten) {
+  const std::string path = generate_unique_temp_path();
+  BufferWriter buffer;
+  FillBuffer("init segment two", &buffer);
+  ASSERT_EQ(Status::OK, InitSegmentCache::Publish(path, &buffer));
+
+  // Republishing identical bytes skips the write entirely: the deleted file
+  // is not recreated.
+  delete_file(path);
+  FillBuffer("init segment two", &buffer);
+  ASSERT_EQ(Status::OK, InitSegmentCache::Publish(path, &buffer));
+  EXPECT_EQ(0u, buffer.Size());
+  std::string content;
+  EXPECT_FALSE(File::ReadFileToString(path.c_str(), &content));
+}
+
+TEST(InitSegmentCacheTest, IdenticalContentPublishedToSecondPath) {
+  TempFile first_file;
+  TempFile second_file;
+  BufferWriter buffer;
+  FillBuffer("init segment three", &buffer);
+  ASSERT_EQ(Status::OK, InitSegmentCache::Publish(first_file.path(), &buffer));
+
+  FillBuffer("init segment three", &buffer);
+  ASSERT_EQ(Status::OK, InitSegmentCache::Publish(second_file.path(), &buffer));
+  ASSERT_FILE_STREQ(second_file.path().c_str(), "init segment three");
+}
+
+TEST(InitSegmentCacheTest, RewrittenContentReplacesFile) {
+  TempFile temp_file;
+  BufferWriter buffer;
+  FillBuffer("init segment four", &buffer);
+  ASSERT_EQ(Status::OK, InitSegmentCache::Publish(temp_file.path(), &buffer));
+
+  // The finalization rewrite carries updated boxes; it must hit the file.
+  FillBuffer("init segment four, finalized", &buffer);
+  ASSERT_EQ(Status::OK, InitSegmentCache::Publish(temp_file.path(), &buffer));
+  ASSERT_FILE_STREQ(temp_file.path().c_str(), "init segment four, finalized");
+}
+
+}  // namespace mp4
+}  // namespace media
+}  // namespace shaka
@@ -21,6 +21,7 @@
 #include <packager/media/event/muxer_listener.h>
 #include <packager/media/formats/mp4/box_definitions.h>
 #include <packager/media/formats/mp4/fragmenter.h>
+#include <packager/media/formats/mp4/init_segment_cache.h>
 #include <packager/media/formats/mp4/key_frame_info.h>
 
 namespace shaka {
@@ -65,6 +66,8 @@ Status LowLatencySegmentSegmenter::DoInitialize() {
 }
 
 Status LowLatencySegmentSegmenter::DoFinalize() {
+  // Surface any error from the last deferred segment close.
+  RETURN_IF_ERROR(ClosePreviousSegmentFile());
   // Update init segment with media duration set.
   RETURN_IF_ERROR(WriteInitSegment());
   SetComplete();
@@ -85,17 +88,12 @@ Status LowLatencySegmentSegmenter::DoFinalizeChunk() {
 Status LowLatencySegmentSegmenter::WriteInitSegment() {
   DCHECK(ftyp());
   DCHECK(moov());
-  // Generate the output file with init segment.
-  std::unique_ptr<File, FileCloser> file(
-      File::Open(options().output_file_name.c_str(), "w"));
-  if (!file) {
-    return Status(error::FILE_FAILURE,
-                  "Cannot open file for write " + options().output_file_name);
-  }
-  std::unique_ptr<BufferWriter> buffer(new BufferWriter);
-  ftyp()->Write(buffer.get());
-  moov()->Write(buffer.get());
-  return buffer->WriteToFile(file.get());
+  // Generate the output file with init segment. Publishing through the cache
+  // dedups byte-identical init segments across renditions and periods.
+  BufferWriter buffer;
+  ftyp()->Write(&buffer);
+  moov()->Write(&buffer);
+  return InitSegmentCache::Publish(options().output_file_name, &buffer);
 }
 
 Status LowLatencySegmentSegmenter::WriteInitialChunk() {
@@ -103,6 +101,10 @@ Status LowLatencySegmentSegmenter::WriteInitialChunk() {
   DCHECK(fragment_buffer());
   DCHECK(styp_);
 
+  // The previous segment's close was deferred so its response wait overlaps
+  // with muxing this chunk; collect its result before opening the next file.
+  RETURN_IF_ERROR(ClosePreviousSegmentFile());
+
   DCHECK(!sidx()->references.empty());
   // earliest_presentation_time is the earliest presentation time of any access
   // unit in the reference stream in the first subsegment.
@@ -113,9 +115,9 @@ Status LowLatencySegmentSegmenter::WriteInitialChunk() {
     // Append the segment to output file if segment template is not specified.
     file_name_ = options().output_file_name.c_str();
   } else {
-    file_name_ = GetSegmentName(options().segment_template,
-                                sidx()->earliest_presentation_time,
-                                num_segments_, options().bandwidth);
+    file_name_ =
+        segment_name_template().Apply(sidx()->earliest_presentation_time,
+                                      num_segments_, options().bandwidth);
   }
 
   // Create the segment file
@@ -185,13 +187,11 @@ Status LowLatencySegmentSegmenter::FinalizeSegment() {
   if (muxer_listener()) {
     muxer_listener()->OnCompletedSegment(GetSegmentDuration(), segment_size_);
   }
-  // Close the file now that the final chunk has been written
-  if (!segment_file_.release()->Close()) {
-    return Status(
-        error::FILE_FAILURE,
-        "Cannot close file " + file_name_ +
-            ", possibly file permission issue or running out of disk space.");
-  }
+  // Signal end-of-data now so the final chunk is delivered immediately, but
+  // defer the blocking Close() - which for HTTP outputs waits for the
+  // server's response - until the next segment is being muxed.
+  segment_file_->CloseForWriting();
+  prev_segment_file_ = std::move(segment_file_);
 
   // Current segment is complete. Reset state in preparation for the next
   // segment.
@@ -202,6 +202,20 @@ Status LowLatencySegmentSegmenter::FinalizeSegment() {
   return Status::OK;
 }
 
+Status LowLatencySegmentSegmenter::ClosePreviousSegmentFile() {
+  if (!prev_segment_file_)
+    return Status::OK;
+
+  const std::string file_name = prev_segment_file_->file_name();
+  if (!prev_segment_file_.release()->Close()) {
+    return Status(
+        error::FILE_FAILURE,
+        "Cannot close file " + file_name +
+            ", possibly file permission issue or running out of disk space.");
+  }
+  return Status::OK;
+}
+
 uint64_t LowLatencySegmentSegmenter::GetSegmentDuration() {
   DCHECK(sidx());
 
@@ -53,6 +53,12 @@ class LowLatencySegmentSegmenter : public Segmenter {
   Status WriteInitialChunk();
   Status FinalizeSegment();
 
+  // Close the previous segment file, if one is still open. The blocking part
+  // of a segment close - for HTTP outputs, waiting for the server's response
+  // - is deferred until the next segment is being muxed, so it overlaps with
+  // muxing instead of stalling it. Returns the deferred close error, if any.
+  Status ClosePreviousSegmentFile();
+
   uint64_t GetSegmentDuration();
 
   std::unique_ptr<SegmentType> styp_;
@@ -60,6 +66,9 @@ class LowLatencySegmentSegmenter : public Segmenter {
   bool is_initial_chunk_in_seg_ = true;
   bool ll_dash_mpd_values_initialized_ = false;
   std::unique_ptr<File, FileCloser> segment_file_;
+  // Completed segment whose Close() has been deferred; see
+  // ClosePreviousSegmentFile().
+  std::unique_ptr<File, FileCloser> prev_segment_file_;
   std::string file_name_;
   size_t segment_size_ = 0u;
 
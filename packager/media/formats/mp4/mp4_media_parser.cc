@@ -5,12 +5,15 @@
 #include <packager/media/formats/mp4/mp4_media_parser.h>
 
 #include <algorithm>
+#include <filesystem>
 #include <functional>
 #include <limits>
 
+#include <absl/flags/flag.h>
 #include <absl/log/check.h>
 #include <absl/log/log.h>
 #include <absl/strings/numbers.h>
+#include <absl/strings/str_format.h>
 
 #include <packager/file.h>
 #include <packager/file/file_closer.h>
@@ -18,6 +21,7 @@
 #include <packager/macros/logging.h>
 #include <packager/media/base/audio_stream_info.h>
 #include <packager/media/base/buffer_reader.h>
+#include <packager/media/base/buffer_writer.h>
 #include <packager/media/base/decrypt_config.h>
 #include <packager/media/base/key_source.h>
 #include <packager/media/base/media_sample.h>
@@ -37,11 +41,106 @@
 #include <packager/media/formats/mp4/box_reader.h>
 #include <packager/media/formats/mp4/track_run_iterator.h>
 
+ABSL_FLAG(std::string,
+          mp4_moov_cache_dir,
+          "",
+          "MP4 only. If set, LoadMoov() caches the raw 'moov' box it locates "
+          "in this directory, keyed by input path, mtime and size. Repeated "
+          "jobs over the same asset then skip scanning the file for a "
+          "trailing 'moov' box.");
+
 namespace shaka {
 namespace media {
 namespace mp4 {
 namespace {
 
+// Layout of a moov cache entry: magic, version, input mtime, input size,
+// input path, then the raw 'moov' box bytes. The key fields are validated on
+// load, so a stale or colliding entry only causes a cache miss.
+const uint32_t kMoovCacheMagic = 0x6d766368;  // 'mvch'
+const uint32_t kMoovCacheVersion = 1;
+
+// Returns false if |file_path| does not refer to a local file that can be
+// stat'ed, in which case the moov cache is not used.
+bool GetMoovCacheKey(const std::string& file_path,
+                     uint64_t* mtime,
+                     uint64_t* size) {
+  std::error_code ec;
+  const std::filesystem::path path(file_path);
+  const uint64_t file_size = std::filesystem::file_size(path, ec);
+  if (ec)
+    return false;
+  const auto write_time = std::filesystem::last_write_time(path, ec);
+  if (ec)
+    return false;
+  *mtime = static_cast<uint64_t>(write_time.time_since_epoch().count());
+  *size = file_size;
+  return true;
+}
+
+std::string MoovCachePath(const std::string& cache_dir,
+                          const std::string& file_path) {
+  // FNV-1a hash of the input path to form a stable file name.
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (const char c : file_path) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 0x100000001b3ull;
+  }
+  return (std::filesystem::path(cache_dir) /
+          absl::StrFormat("%016x.moov", hash))
+      .string();
+}
+
+bool ReadMoovCache(const std::string& cache_path,
+                   const std::string& file_path,
+                   uint64_t mtime,
+                   uint64_t size,
+                   std::vector<uint8_t>* moov_data) {
+  std::string data;
+  if (!File::ReadFileToString(cache_path.c_str(), &data))
+    return false;
+  BufferReader reader(reinterpret_cast<const uint8_t*>(data.data()),
+                      data.size());
+  uint32_t magic;
+  uint32_t version;
+  RCHECK(reader.Read4(&magic) && reader.Read4(&version));
+  if (magic != kMoovCacheMagic || version != kMoovCacheVersion)
+    return false;
+  uint64_t cached_mtime;
+  uint64_t cached_size;
+  uint32_t path_size;
+  RCHECK(reader.Read8(&cached_mtime) && reader.Read8(&cached_size) &&
+         reader.Read4(&path_size));
+  std::string cached_path;
+  RCHECK(reader.ReadToString(&cached_path, path_size));
+  if (cached_mtime != mtime || cached_size != size || cached_path != file_path)
+    return false;
+  const size_t moov_size = data.size() - reader.pos();
+  RCHECK(moov_size > 0);
+  return reader.ReadToVector(moov_data, moov_size);
+}
+
+void WriteMoovCache(const std::string& cache_path,
+                    const std::string& file_path,
+                    uint64_t mtime,
+                    uint64_t size,
+                    const std::vector<uint8_t>& moov_data) {
+  BufferWriter writer;
+  writer.AppendInt(kMoovCacheMagic);
+  writer.AppendInt(kMoovCacheVersion);
+  writer.AppendInt(mtime);
+  writer.AppendInt(size);
+  writer.AppendInt(static_cast<uint32_t>(file_path.size()));
+  writer.AppendArray(reinterpret_cast<const uint8_t*>(file_path.data()),
+                     file_path.size());
+  writer.AppendArray(moov_data.data(), moov_data.size());
+  const std::string contents(reinterpret_cast<const char*>(writer.Buffer()),
+                             writer.Size());
+  if (!File::WriteFileAtomically(cache_path.c_str(), contents)) {
+    LOG(WARNING) << "Failed to write moov cache to '" << cache_path << "'";
+  }
+}
+
 int64_t Rescale(int64_t time_in_old_scale,
                 int32_t old_scale,
                 int32_t new_scale) {
@@ -206,6 +305,10 @@ void MP4MediaParser::Init(const InitCB& init_cb,
     decryptor_source_.reset(new DecryptorSource(decryption_key_source));
 }
 
+void MP4MediaParser::ExcludeTrack(uint32_t track_id) {
+  excluded_track_ids_.insert(track_id);
+}
+
 void MP4MediaParser::Reset() {
   queue_.Reset();
   runs_.reset();
@@ -255,6 +358,28 @@ bool MP4MediaParser::Parse(const uint8_t* buf, int size) {
 }
 
 bool MP4MediaParser::LoadMoov(const std::string& file_path) {
+  const std::string cache_dir = absl::GetFlag(FLAGS_mp4_moov_cache_dir);
+  std::string cache_path;
+  uint64_t asset_mtime = 0;
+  uint64_t asset_size = 0;
+  if (!cache_dir.empty() &&
+      GetMoovCacheKey(file_path, &asset_mtime, &asset_size)) {
+    cache_path = MoovCachePath(cache_dir, file_path);
+    std::vector<uint8_t> moov_data;
+    if (ReadMoovCache(cache_path, file_path, asset_mtime, asset_size,
+                      &moov_data)) {
+      DVLOG(1) << "Using cached 'moov' for '" << file_path << "'";
+      if (!Parse(moov_data.data(), static_cast<int>(moov_data.size()))) {
+        LOG(ERROR) << "Error parsing cached 'moov' for file '" << file_path
+                   << "'";
+        return false;
+      }
+      queue_.Reset();  // So that we don't need to adjust data offsets.
+      mdat_tail_ = 0;  // So it will skip boxes until mdat.
+      return true;
+    }
+  }
+
   std::unique_ptr<File, FileCloser> file(
       File::OpenWithNoBuffering(file_path.c_str(), "r"));
   if (!file) {
@@ -297,6 +422,10 @@ bool MP4MediaParser::LoadMoov(const std::string& file_path) {
         break;
       }
       // 'mdat' before 'moov'. Read and parse 'moov'.
+      // Keep the raw bytes around if they are going to be cached.
+      std::vector<uint8_t> moov_data;
+      if (!cache_path.empty())
+        moov_data.assign(buffer.begin(), buffer.begin() + bytes_read);
       if (!Parse(&buffer[0], bytes_read)) {
         LOG(ERROR) << "Error parsing mp4 file '" << file_path << "'";
         return false;
@@ -310,12 +439,20 @@ bool MP4MediaParser::LoadMoov(const std::string& file_path) {
                      << "'";
           return false;
         }
+        if (!cache_path.empty()) {
+          moov_data.insert(moov_data.end(), buffer.begin(),
+                           buffer.begin() + bytes_read);
+        }
         if (!Parse(&buffer[0], bytes_read)) {
           LOG(ERROR) << "Error parsing mp4 file '" << file_path << "'";
           return false;
         }
         bytes_to_read -= bytes_read;
       }
+      if (!cache_path.empty()) {
+        WriteMoovCache(cache_path, file_path, asset_mtime, asset_size,
+                       moov_data);
+      }
       queue_.Reset();  // So that we don't need to adjust data offsets.
       mdat_tail_ = 0;  // So it will skip boxes until mdat.
       break;  // Done.
@@ -329,18 +466,38 @@ bool MP4MediaParser::LoadMoov(const std::string& file_path) {
   return true;
 }
 
+bool MP4MediaParser::Seek(double timestamp_seconds) {
+  if (!moov_ || !runs_) {
+    LOG(ERROR) << "Seek is only valid after the 'moov' box has been parsed.";
+    return false;
+  }
+  return runs_->AdvanceToTimestamp(timestamp_seconds);
+}
+
 bool MP4MediaParser::ParseBox(bool* err) {
-  const uint8_t* buf;
-  int size;
-  queue_.Peek(&buf, &size);
-  if (!size)
+  // Finish any in-progress incremental discard (typically an unused 'mdat')
+  // before the next box header can be read.
+  if (queue_.head() < mdat_tail_) {
+    queue_.Trim(mdat_tail_);
+    if (queue_.head() < mdat_tail_)
+      return false;
+  }
+
+  // The box header may straddle a slab boundary; copy it out to decide how to
+  // handle the box before materializing any of its payload.
+  const size_t kBoxHeaderReadSize = 16;
+  uint8_t header[kBoxHeaderReadSize];
+  const size_t header_size =
+      queue_.CopyAt(queue_.head(), kBoxHeaderReadSize, header);
+  if (!header_size)
     return false;
 
-  std::unique_ptr<BoxReader> reader(BoxReader::ReadBox(buf, size, err));
-  if (reader.get() == NULL)
+  FourCC box_type;
+  uint64_t box_size;
+  if (!BoxReader::StartBox(header, header_size, &box_type, &box_size, err))
     return false;
 
-  if (reader->type() == FOURCC_mdat) {
+  if (box_type == FOURCC_mdat) {
     if (!moov_) {
       // For seekable files, we seek to the 'moov' and load the 'moov' first
       // then seek back (see LoadMoov function for details); we do not support
@@ -350,15 +507,32 @@ bool MP4MediaParser::ParseBox(bool* err) {
                           "box is not supported.";
       *err = true;
       return false;
-    } else {
-      // This can happen if there are unused 'mdat' boxes, which is unusual
-      // but allowed by the spec. Ignore the 'mdat' and proceed.
-      LOG(INFO)
-          << "Ignore unused 'mdat' box - this could be as a result of extra "
-             "not usable 'mdat' or 'mdat' associated with unrecognized track.";
     }
+    // This can happen if there are unused 'mdat' boxes, which is unusual
+    // but allowed by the spec. Ignore the 'mdat' and proceed.
+    LOG(INFO)
+        << "Ignore unused 'mdat' box - this could be as a result of extra "
+           "not usable 'mdat' or 'mdat' associated with unrecognized track.";
+
+    // Set up mdat offset for ReadMDATsUntil(). The payload of this 'mdat' is
+    // not referenced, so discard it as it streams in instead of waiting for
+    // the entire box to be buffered.
+    mdat_tail_ = queue_.head() + box_size;
+    queue_.Trim(mdat_tail_);
+    return queue_.head() >= mdat_tail_;
   }
 
+  // Other top-level boxes are parsed in full once buffered; the view is
+  // zero-copy unless the box straddles a slab.
+  std::shared_ptr<const uint8_t> box = queue_.GetShared(queue_.head(), box_size);
+  if (!box)
+    return false;
+
+  std::unique_ptr<BoxReader> reader(
+      BoxReader::ReadBox(box.get(), box_size, err));
+  if (reader.get() == NULL)
+    return false;
+
   // Set up mdat offset for ReadMDATsUntil().
   mdat_tail_ = queue_.head() + reader->size();
 
@@ -377,7 +551,7 @@ bool MP4MediaParser::ParseBox(bool* err) {
     VLOG(2) << "Skipping top-level box: " << FourCCToString(reader->type());
   }
 
-  queue_.Pop(static_cast<int>(reader->size()));
+  queue_.Trim(queue_.head() + reader->size());
   return !(*err);
 }
 
@@ -741,6 +915,15 @@ bool MP4MediaParser::ParseMoov(BoxReader* reader) {
       video_stream_info->set_colr_data((entry.colr.raw_box).data(),
                                        (entry.colr.raw_box).size());
 
+      if ((video_codec == kCodecH264 || video_codec == kCodecH265 ||
+           video_codec == kCodecH265DolbyVision) &&
+          nalu_length_size > 0) {
+        const VideoNaluInfo nalu_info = {
+            video_codec == kCodecH264 ? Nalu::kH264 : Nalu::kH265,
+            nalu_length_size};
+        video_nalu_info_by_track_[track->header.track_id] = nalu_info;
+      }
+
       // Set pssh raw data if it has.
       if (moov_->pssh.size() > 0) {
         std::vector<uint8_t> pssh_raw_data;
@@ -820,12 +1003,18 @@ bool MP4MediaParser::EnqueueSample(bool* err) {
 
   DCHECK(!(*err));
 
-  const uint8_t* buf;
-  int buf_size;
-  queue_.Peek(&buf, &buf_size);
-  if (!buf_size)
+  if (queue_.head() == queue_.tail())
     return false;
 
+  // Skip this entire run if stream selection excluded its track: the samples
+  // are dropped here, before any decryption or annotation work is done on
+  // them.
+  if (!excluded_track_ids_.empty() &&
+      excluded_track_ids_.count(runs_->track_id())) {
+    runs_->AdvanceRun();
+    return true;
+  }
+
   // Skip this entire track if it is not audio nor video.
   if (!runs_->is_audio() && !runs_->is_video())
     runs_->AdvanceRun();
@@ -838,16 +1027,17 @@ bool MP4MediaParser::EnqueueSample(bool* err) {
   // memory-constrained devices where the source buffer consumes a substantial
   // portion of the total system memory.
   if (runs_->AuxInfoNeedsToBeCached()) {
-    queue_.PeekAt(runs_->aux_info_offset() + moof_head_, &buf, &buf_size);
-    if (buf_size < runs_->aux_info_size())
+    std::shared_ptr<const uint8_t> aux_info = queue_.GetShared(
+        runs_->aux_info_offset() + moof_head_, runs_->aux_info_size());
+    if (!aux_info)
       return false;
-    *err = !runs_->CacheAuxInfo(buf, buf_size);
+    *err = !runs_->CacheAuxInfo(aux_info.get(), runs_->aux_info_size());
     return !*err;
   }
 
   int64_t sample_offset = runs_->sample_offset() + moof_head_;
-  queue_.PeekAt(sample_offset, &buf, &buf_size);
-  if (buf_size < runs_->sample_size()) {
+  const size_t media_data_size = runs_->sample_size();
+  if (sample_offset + static_cast<int64_t>(media_data_size) > queue_.tail()) {
     if (sample_offset < queue_.head()) {
       LOG(ERROR) << "Incorrect sample offset " << sample_offset
                  << " < " << queue_.head();
@@ -855,18 +1045,14 @@ bool MP4MediaParser::EnqueueSample(bool* err) {
     }
     return false;
   }
+  // Zero-copy unless the sample straddles a slab; the view keeps its slab
+  // alive after the queue trims past it.
+  std::shared_ptr<const uint8_t> media_data =
+      queue_.GetShared(sample_offset, media_data_size);
+  DCHECK(media_data);
 
-  const uint8_t* media_data = buf;
-  const size_t media_data_size = runs_->sample_size();
-  // Use a dummy data size of 0 to avoid copying overhead.
-  // Actual media data is set later.
-  const size_t kDummyDataSize = 0;
-  std::shared_ptr<MediaSample> stream_sample(
-      MediaSample::CopyFrom(media_data, kDummyDataSize, runs_->is_keyframe()));
-
+  std::shared_ptr<MediaSample> stream_sample;
   if (runs_->is_encrypted()) {
-    std::shared_ptr<uint8_t> decrypted_media_data(
-        new uint8_t[media_data_size], std::default_delete<uint8_t[]>());
     std::unique_ptr<DecryptConfig> decrypt_config = runs_->GetDecryptConfig();
     if (!decrypt_config) {
       *err = true;
@@ -875,30 +1061,52 @@ bool MP4MediaParser::EnqueueSample(bool* err) {
     }
 
     if (!decryptor_source_) {
-      stream_sample->SetData(media_data, media_data_size);
       // If the demuxer does not have the decryptor_source_, store
       // decrypt_config so that the demuxed sample can be decrypted later.
+      stream_sample = MediaSample::FromSharedBuffer(
+          media_data, 0, media_data_size, runs_->is_keyframe());
       stream_sample->set_decrypt_config(std::move(decrypt_config));
       stream_sample->set_is_encrypted(true);
     } else {
-      if (!decryptor_source_->DecryptSampleBuffer(decrypt_config.get(),
-                                                  media_data, media_data_size,
-                                                  decrypted_media_data.get())) {
+      std::shared_ptr<uint8_t> decrypted_media_data(
+          new uint8_t[media_data_size], std::default_delete<uint8_t[]>());
+      if (!decryptor_source_->DecryptSampleBuffer(
+              decrypt_config.get(), media_data.get(), media_data_size,
+              decrypted_media_data.get())) {
         *err = true;
         LOG(ERROR) << "Cannot decrypt samples.";
         return false;
       }
-      stream_sample->TransferData(std::move(decrypted_media_data),
-                                  media_data_size);
+      stream_sample = MediaSample::FromSharedBuffer(
+          std::move(decrypted_media_data), 0, media_data_size,
+          runs_->is_keyframe());
     }
   } else {
-    stream_sample->SetData(media_data, media_data_size);
+    stream_sample = MediaSample::FromSharedBuffer(
+        media_data, 0, media_data_size, runs_->is_keyframe());
   }
 
   stream_sample->set_dts(runs_->dts());
   stream_sample->set_pts(runs_->cts());
   stream_sample->set_duration(runs_->duration());
 
+  // Attach the NALU extent table for NAL structured video, so downstream
+  // handlers (subsample generation, TS conversion) iterate the units from
+  // the table instead of rescanning the frame. NALU length fields and
+  // headers stay clear under subsample encryption, so this is safe for
+  // encrypted samples too; a frame that fails to parse is simply left
+  // unannotated.
+  const auto nalu_info = video_nalu_info_by_track_.find(runs_->track_id());
+  if (nalu_info != video_nalu_info_by_track_.end()) {
+    std::vector<NaluExtent> nalu_extents;
+    if (ParseNaluExtents(nalu_info->second.nalu_type,
+                         nalu_info->second.nalu_length_size,
+                         stream_sample->data(), stream_sample->data_size(),
+                         &nalu_extents)) {
+      stream_sample->set_nalu_extents(std::move(nalu_extents));
+    }
+  }
+
   DVLOG(3) << "Pushing frame: "
            << ", key=" << runs_->is_keyframe()
            << ", dur=" << runs_->duration()
@@ -919,13 +1127,14 @@ bool MP4MediaParser::EnqueueSample(bool* err) {
 bool MP4MediaParser::ReadAndDiscardMDATsUntil(const int64_t offset) {
   bool err = false;
   while (mdat_tail_ < offset) {
-    const uint8_t* buf;
-    int size;
-    queue_.PeekAt(mdat_tail_, &buf, &size);
+    const size_t kBoxHeaderReadSize = 16;
+    uint8_t header[kBoxHeaderReadSize];
+    const size_t header_size =
+        queue_.CopyAt(mdat_tail_, kBoxHeaderReadSize, header);
 
     FourCC type;
     uint64_t box_sz;
-    if (!BoxReader::StartBox(buf, size, &type, &box_sz, &err))
+    if (!BoxReader::StartBox(header, header_size, &type, &box_sz, &err))
       break;
 
     mdat_tail_ += box_sz;
@@ -10,12 +10,14 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <set>
 #include <vector>
 
 #include <packager/macros/classes.h>
 #include <packager/media/base/decryptor_source.h>
 #include <packager/media/base/media_parser.h>
-#include <packager/media/base/offset_byte_queue.h>
+#include <packager/media/base/slab_byte_queue.h>
+#include <packager/media/codecs/nalu_reader.h>
 
 namespace shaka {
 namespace media {
@@ -37,6 +39,7 @@ class MP4MediaParser : public MediaParser {
             const NewMediaSampleCB& new_media_sample_cb,
             const NewTextSampleCB& new_text_sample_cb,
             KeySource* decryption_key_source) override;
+  void ExcludeTrack(uint32_t track_id) override;
   [[nodiscard]] bool Flush() override;
   [[nodiscard]] bool Parse(const uint8_t* buf, int size) override;
   /// @}
@@ -49,6 +52,19 @@ class MP4MediaParser : public MediaParser {
   /// @return true if successful, false otherwise.
   bool LoadMoov(const std::string& file_path);
 
+  /// Position the parser so sample emission resumes at the last sync sample
+  /// at or before @a timestamp_seconds, using the sample table index built
+  /// from the 'moov' box. Only valid after the 'moov' box has been parsed,
+  /// e.g. after LoadMoov(). Bytes pushed to Parse() ahead of the first
+  /// remaining sample are discarded without per-sample processing, so
+  /// partial repackage jobs do not pay for the media before the seek point.
+  /// Encrypted sources work the same way: per-sample decryption info comes
+  /// from 'senc' or saio/saiz, so nothing before the sync sample has to be
+  /// decrypted.
+  /// @param timestamp_seconds is the seek target in seconds.
+  /// @return true if successful, false otherwise.
+  bool Seek(double timestamp_seconds);
+
  private:
   enum State {
     kWaitingForInit,
@@ -86,7 +102,10 @@ class MP4MediaParser : public MediaParser {
   KeySource* decryption_key_source_;
   std::unique_ptr<DecryptorSource> decryptor_source_;
 
-  OffsetByteQueue queue_;
+  // Slab-based so a referenced 'mdat' can stay buffered while its runs are
+  // emitted without the contiguous queue's repeated memmove, and so samples
+  // can alias the slabs instead of copying out of them.
+  SlabByteQueue queue_;
 
   // These two parameters are only valid in the |kEmittingSegments| state.
   //
@@ -101,6 +120,18 @@ class MP4MediaParser : public MediaParser {
   std::unique_ptr<Movie> moov_;
   std::unique_ptr<TrackRunIterator> runs_;
 
+  // NALU layout info per NAL structured video track, used to annotate
+  // demuxed samples with their NALU extent table.
+  struct VideoNaluInfo {
+    Nalu::CodecType nalu_type;
+    uint8_t nalu_length_size;
+  };
+  std::map<uint32_t, VideoNaluInfo> video_nalu_info_by_track_;
+
+  // Tracks whose samples the caller discards; their runs are skipped without
+  // sample assembly. See MediaParser::ExcludeTrack().
+  std::set<uint32_t> excluded_track_ids_;
+
   DISALLOW_COPY_AND_ASSIGN(MP4MediaParser);
 };
 
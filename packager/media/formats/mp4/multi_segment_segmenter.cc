@@ -7,6 +7,7 @@
 #include <packager/media/formats/mp4/multi_segment_segmenter.h>
 
 #include <algorithm>
+#include <utility>
 
 #include <absl/log/check.h>
 #include <absl/strings/numbers.h>
@@ -21,18 +22,26 @@
 #include <packager/media/base/muxer_util.h>
 #include <packager/media/event/muxer_listener.h>
 #include <packager/media/formats/mp4/box_definitions.h>
+#include <packager/media/formats/mp4/init_segment_cache.h>
 #include <packager/media/formats/mp4/key_frame_info.h>
 
 namespace shaka {
 namespace media {
 namespace mp4 {
 
+namespace {
+// Maximum number of finalized segments queued behind the background writer
+// before segment finalization blocks. A couple of segments is enough to ride
+// out storage latency spikes without ballooning memory.
+const size_t kPendingWritesCapacity = 2;
+}  // namespace
+
 MultiSegmentSegmenter::MultiSegmentSegmenter(const MuxerOptions& options,
                                              std::unique_ptr<FileType> ftyp,
                                              std::unique_ptr<Movie> moov)
     : Segmenter(options, std::move(ftyp), std::move(moov)),
       styp_(new SegmentType),
-      num_segments_(0) {
+      num_segments_(static_cast<uint32_t>(options.initial_segment_number)) {
   // Use the same brands for styp as ftyp.
   styp_->major_brand = Segmenter::ftyp()->major_brand;
   styp_->compatible_brands = Segmenter::ftyp()->compatible_brands;
@@ -41,7 +50,9 @@ MultiSegmentSegmenter::MultiSegmentSegmenter(const MuxerOptions& options,
                FOURCC_cmfc, FOURCC_cmfs);
 }
 
-MultiSegmentSegmenter::~MultiSegmentSegmenter() {}
+MultiSegmentSegmenter::~MultiSegmentSegmenter() {
+  DrainPendingWrites();
+}
 
 bool MultiSegmentSegmenter::GetInitRange(size_t* offset, size_t* size) {
   VLOG(1) << "MultiSegmentSegmenter outputs init segment: "
@@ -64,6 +75,9 @@ Status MultiSegmentSegmenter::DoInitialize() {
 }
 
 Status MultiSegmentSegmenter::DoFinalize() {
+  // All queued segments must be on storage before the init segment is
+  // rewritten and completion is reported.
+  RETURN_IF_ERROR(DrainPendingWrites());
   // Update init segment with media duration set.
   RETURN_IF_ERROR(WriteInitSegment());
   SetComplete();
@@ -77,17 +91,13 @@ Status MultiSegmentSegmenter::DoFinalizeSegment() {
 Status MultiSegmentSegmenter::WriteInitSegment() {
   DCHECK(ftyp());
   DCHECK(moov());
-  // Generate the output file with init segment.
-  std::unique_ptr<File, FileCloser> file(
-      File::Open(options().output_file_name.c_str(), "w"));
-  if (!file) {
-    return Status(error::FILE_FAILURE,
-                  "Cannot open file for write " + options().output_file_name);
-  }
-  std::unique_ptr<BufferWriter> buffer(new BufferWriter);
-  ftyp()->Write(buffer.get());
-  moov()->Write(buffer.get());
-  return buffer->WriteToFile(file.get());
+  // Generate the output file with init segment. Publishing through the cache
+  // dedups byte-identical init segments across renditions and periods and
+  // skips the finalization rewrite when the content did not change.
+  BufferWriter buffer;
+  ftyp()->Write(&buffer);
+  moov()->Write(&buffer);
+  return InitSegmentCache::Publish(options().output_file_name, &buffer);
 }
 
 Status MultiSegmentSegmenter::WriteSegment() {
@@ -101,71 +111,173 @@ Status MultiSegmentSegmenter::WriteSegment() {
   sidx()->earliest_presentation_time =
       sidx()->references[0].earliest_presentation_time;
 
+  auto pending = std::make_shared<PendingSegmentWrite>();
   std::unique_ptr<BufferWriter> buffer(new BufferWriter());
-  std::unique_ptr<File, FileCloser> file;
-  std::string file_name;
   if (options().segment_template.empty()) {
     // Append the segment to output file if segment template is not specified.
-    file_name = options().output_file_name.c_str();
-    file.reset(File::Open(file_name.c_str(), "a"));
-    if (!file) {
-      return Status(error::FILE_FAILURE, "Cannot open file for append " +
-                                             options().output_file_name);
-    }
+    pending->file_name = options().output_file_name;
+    pending->append = true;
   } else {
-    file_name = GetSegmentName(options().segment_template,
-                               sidx()->earliest_presentation_time,
-                               num_segments_++, options().bandwidth);
-    file.reset(File::Open(file_name.c_str(), "w"));
-    if (!file) {
-      return Status(error::FILE_FAILURE,
-                    "Cannot open file for write " + file_name);
-    }
+    pending->file_name =
+        segment_name_template().Apply(sidx()->earliest_presentation_time,
+                                      num_segments_++, options().bandwidth);
     styp_->Write(buffer.get());
   }
 
   if (options().mp4_params.generate_sidx_in_media_segments)
     sidx()->Write(buffer.get());
 
-  const size_t segment_header_size = buffer->Size();
-  const size_t segment_size = segment_header_size + fragment_buffer()->Size();
-  DCHECK_NE(segment_size, 0u);
-
-  RETURN_IF_ERROR(buffer->WriteToFile(file.get()));
-  if (muxer_listener()) {
-    for (const KeyFrameInfo& key_frame_info : key_frame_infos()) {
-      muxer_listener()->OnKeyFrame(
-          key_frame_info.timestamp,
-          segment_header_size + key_frame_info.start_byte_offset,
-          key_frame_info.size);
+  buffer->SwapBuffer(&pending->header);
+  fragment_buffer()->SwapBuffer(&pending->fragment);
+  pending->segment_size = pending->header.size() + pending->fragment.size();
+  DCHECK_NE(pending->segment_size, 0u);
+
+  // The swap above leaves |fragment_buffer()| without capacity. Reserve the
+  // predicted size of the next segment so steady-state live segments are
+  // assembled without mid-segment reallocations.
+  segment_size_predictor_.AddSample(pending->fragment.size());
+  fragment_buffer()->Reserve(segment_size_predictor_.PredictedSize());
+
+  pending->earliest_presentation_time = sidx()->earliest_presentation_time;
+  // ISO/IEC 23009-1:2012: the value shall be identical to sum of the the
+  // values of all Subsegment_duration fields in the first ‘sidx’ box.
+  for (size_t i = 0; i < sidx()->references.size(); ++i)
+    pending->segment_duration += sidx()->references[i].subsegment_duration;
+  pending->sample_duration = sample_duration();
+  pending->key_frame_infos = key_frame_infos();
+
+  UpdateProgress(pending->segment_duration);
+
+  if (!options().mp4_params.async_segment_finalization) {
+    RETURN_IF_ERROR(WriteSegmentBytes(*pending));
+    EmitListenerEvents(*pending);
+    return Status::OK;
+  }
+
+  // Asynchronous mode: hand the segment to the background writers and start
+  // accepting samples for the next segment immediately.
+  pending->sequence = write_sequence_++;
+  if (writer_threads_.empty()) {
+    // Segments appended to one output file must be written in order, so the
+    // pool degenerates to a single writer there. Segment-template outputs
+    // are independent files and can be in flight concurrently; the reorder
+    // stage keeps listener events in segment order either way.
+    const int32_t num_writers =
+        pending->append
+            ? 1
+            : std::max(1, options().mp4_params.segment_writer_threads);
+    pending_writes_.reset(
+        new ProducerConsumerQueue<std::shared_ptr<PendingSegmentWrite>>(
+            std::max<size_t>(kPendingWritesCapacity, num_writers)));
+    for (int32_t i = 0; i < num_writers; ++i) {
+      writer_threads_.emplace_back(&MultiSegmentSegmenter::WriterThreadMain,
+                                   this);
     }
   }
-  RETURN_IF_ERROR(fragment_buffer()->WriteToFile(file.get()));
+  {
+    // Surface errors from segments that already failed to write.
+    absl::MutexLock lock(&write_status_mutex_);
+    RETURN_IF_ERROR(write_status_);
+  }
+  return pending_writes_->Push(pending, kInfiniteTimeout);
+}
+
+Status MultiSegmentSegmenter::WriteSegmentBytes(
+    const PendingSegmentWrite& pending) {
+  std::unique_ptr<File, FileCloser> file(
+      File::Open(pending.file_name.c_str(), pending.append ? "a" : "w"));
+  if (!file) {
+    return Status(error::FILE_FAILURE,
+                  "Cannot open file for write " + pending.file_name);
+  }
+
+  // Emit header and fragments with one vectored write; no coalescing copy.
+  File::IoVec iov[] = {{pending.header.data(), pending.header.size()},
+                       {pending.fragment.data(), pending.fragment.size()}};
+  const int64_t bytes_written = file->WriteV(iov, 2);
+  if (bytes_written < 0 ||
+      static_cast<uint64_t>(bytes_written) != pending.segment_size) {
+    return Status(error::FILE_FAILURE,
+                  "Error writing to file " + pending.file_name);
+  }
 
   // Close the file, which also does flushing, to make sure the file is written
   // before manifest is updated.
   if (!file.release()->Close()) {
     return Status(
         error::FILE_FAILURE,
-        "Cannot close file " + file_name +
+        "Cannot close file " + pending.file_name +
             ", possibly file permission issue or running out of disk space.");
   }
 
-  int64_t segment_duration = 0;
-  // ISO/IEC 23009-1:2012: the value shall be identical to sum of the the
-  // values of all Subsegment_duration fields in the first ‘sidx’ box.
-  for (size_t i = 0; i < sidx()->references.size(); ++i)
-    segment_duration += sidx()->references[i].subsegment_duration;
-
-  UpdateProgress(segment_duration);
-  if (muxer_listener()) {
-    muxer_listener()->OnSampleDurationReady(sample_duration());
-    muxer_listener()->OnNewSegment(file_name,
-                                   sidx()->earliest_presentation_time,
-                                   segment_duration, segment_size);
+  return Status::OK;
+}
+
+void MultiSegmentSegmenter::EmitListenerEvents(
+    const PendingSegmentWrite& pending) {
+  if (!muxer_listener())
+    return;
+  for (const KeyFrameInfo& key_frame_info : pending.key_frame_infos) {
+    muxer_listener()->OnKeyFrame(
+        key_frame_info.timestamp,
+        pending.header.size() + key_frame_info.start_byte_offset,
+        key_frame_info.size);
   }
+  muxer_listener()->OnSampleDurationReady(pending.sample_duration);
+  muxer_listener()->OnNewSegment(pending.file_name,
+                                 pending.earliest_presentation_time,
+                                 pending.segment_duration,
+                                 pending.segment_size);
+}
 
-  return Status::OK;
+void MultiSegmentSegmenter::SequenceCompletedWrite(
+    std::shared_ptr<PendingSegmentWrite> pending,
+    Status status) {
+  absl::MutexLock lock(&emit_mutex_);
+  completed_writes_.emplace(pending->sequence,
+                            std::make_pair(std::move(pending), status));
+  // Emit every segment that is now next in order. Listener calls happen
+  // under |emit_mutex_|, which also serializes listeners that are not
+  // thread safe.
+  auto it = completed_writes_.find(next_emit_sequence_);
+  while (it != completed_writes_.end()) {
+    if (it->second.second.ok()) {
+      EmitListenerEvents(*it->second.first);
+    } else {
+      // Record the first error; it is surfaced on the next WriteSegment()
+      // call and again when the writes are drained.
+      absl::MutexLock status_lock(&write_status_mutex_);
+      write_status_.Update(it->second.second);
+    }
+    completed_writes_.erase(it);
+    it = completed_writes_.find(++next_emit_sequence_);
+  }
+}
+
+void MultiSegmentSegmenter::WriterThreadMain() {
+  for (;;) {
+    std::shared_ptr<PendingSegmentWrite> pending;
+    if (!pending_writes_->Pop(&pending, kInfiniteTimeout).ok()) {
+      // STOPPED with a drained queue: normal shutdown.
+      return;
+    }
+    // Keep consuming the queue even after an error so the producer never
+    // blocks on a dead writer; the reorder stage records the failure.
+    Status status = WriteSegmentBytes(*pending);
+    SequenceCompletedWrite(std::move(pending), status);
+  }
+}
+
+Status MultiSegmentSegmenter::DrainPendingWrites() {
+  if (!writer_threads_.empty()) {
+    pending_writes_->Stop();
+    for (std::thread& thread : writer_threads_)
+      thread.join();
+    writer_threads_.clear();
+    pending_writes_.reset();
+  }
+  absl::MutexLock lock(&write_status_mutex_);
+  return write_status_;
 }
 
 }  // namespace mp4
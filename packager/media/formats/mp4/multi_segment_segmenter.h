@@ -7,7 +7,20 @@
 #ifndef PACKAGER_MEDIA_FORMATS_MP4_MULTI_SEGMENT_SEGMENTER_H_
 #define PACKAGER_MEDIA_FORMATS_MP4_MULTI_SEGMENT_SEGMENTER_H_
 
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <absl/base/thread_annotations.h>
+#include <absl/synchronization/mutex.h>
+
 #include <packager/macros/classes.h>
+#include <packager/media/base/producer_consumer_queue.h>
+#include <packager/media/base/segment_size_predictor.h>
+#include <packager/media/formats/mp4/key_frame_info.h>
 #include <packager/media/formats/mp4/segmenter.h>
 
 namespace shaka {
@@ -36,6 +49,26 @@ class MultiSegmentSegmenter : public Segmenter {
   /// @}
 
  private:
+  // A fully assembled media segment waiting to be written out, together with
+  // everything needed to notify the muxer listener once it is on disk.
+  struct PendingSegmentWrite {
+    // Position in segment order; the reorder stage fires listener events by
+    // ascending sequence no matter which writer finishes first.
+    uint64_t sequence = 0;
+    std::string file_name;
+    // Append to the main output file instead of creating a new segment file.
+    bool append = false;
+    // styp/sidx bytes preceding the fragments, if any.
+    std::vector<uint8_t> header;
+    // moof/mdat bytes.
+    std::vector<uint8_t> fragment;
+    uint64_t segment_size = 0;
+    int64_t earliest_presentation_time = 0;
+    int64_t segment_duration = 0;
+    int64_t sample_duration = 0;
+    std::vector<KeyFrameInfo> key_frame_infos;
+  };
+
   // Segmenter implementation overrides.
   Status DoInitialize() override;
   Status DoFinalize() override;
@@ -45,8 +78,42 @@ class MultiSegmentSegmenter : public Segmenter {
   Status WriteInitSegment();
   Status WriteSegment();
 
+  // Write a pending segment's bytes to its file. Called on the muxing thread
+  // in synchronous mode and on a writer thread in asynchronous mode; safe to
+  // run concurrently for different segments.
+  Status WriteSegmentBytes(const PendingSegmentWrite& pending);
+  // Fire the listener events for a written segment. Must be called in
+  // segment order.
+  void EmitListenerEvents(const PendingSegmentWrite& pending);
+  // Reorder stage: collects out-of-order writer completions and emits
+  // listener events strictly by segment sequence.
+  void SequenceCompletedWrite(std::shared_ptr<PendingSegmentWrite> pending,
+                              Status status);
+  // Background writer loop for asynchronous finalization.
+  void WriterThreadMain();
+  // Stop the background writers, wait for queued segments to hit storage and
+  // collect any write error.
+  Status DrainPendingWrites();
+
   std::unique_ptr<SegmentType> styp_;
   uint32_t num_segments_;
+  // Predicts the next segment's fragment size; see WriteSegment().
+  SegmentSizePredictor segment_size_predictor_;
+
+  // Asynchronous finalization state; see
+  // Mp4OutputParams::async_segment_finalization and segment_writer_threads.
+  std::vector<std::thread> writer_threads_;
+  std::unique_ptr<ProducerConsumerQueue<std::shared_ptr<PendingSegmentWrite>>>
+      pending_writes_;
+  // Sequence assigned to the next finalized segment; muxing thread only.
+  uint64_t write_sequence_ = 0;
+  absl::Mutex write_status_mutex_;
+  Status write_status_ ABSL_GUARDED_BY(write_status_mutex_);
+  // Reorder stage state.
+  absl::Mutex emit_mutex_;
+  uint64_t next_emit_sequence_ ABSL_GUARDED_BY(emit_mutex_) = 0;
+  std::map<uint64_t, std::pair<std::shared_ptr<PendingSegmentWrite>, Status>>
+      completed_writes_ ABSL_GUARDED_BY(emit_mutex_);
 
   DISALLOW_COPY_AND_ASSIGN(MultiSegmentSegmenter);
 };
@@ -0,0 +1,147 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/formats/mp4/sample_table_iterator.h>
+
+#include <algorithm>
+
+namespace shaka {
+namespace media {
+namespace mp4 {
+
+SampleTableIterator::SampleTableIterator(const SampleTable& sample_table)
+    : decoding_time_table_(sample_table.decoding_time_to_sample),
+      composition_offset_table_(sample_table.composition_time_to_sample),
+      sync_sample_table_(sample_table.sync_sample) {
+  for (const DecodingTime& entry : decoding_time_table_.decoding_time)
+    num_samples_ += entry.sample_count;
+  for (const CompositionOffset& entry :
+       composition_offset_table_.composition_offset) {
+    num_composition_samples_ += entry.sample_count;
+  }
+  has_composition_offset_ =
+      !composition_offset_table_.composition_offset.empty();
+
+  // Expand the stsc runs into one entry per chunk; the last run extends to
+  // the end of the chunk offset table.
+  const std::vector<ChunkInfo>& chunk_info_table =
+      sample_table.sample_to_chunk.chunk_info;
+  const size_t num_chunks = sample_table.chunk_large_offset.offsets.size();
+  if (!chunk_info_table.empty()) {
+    last_first_chunk_ = chunk_info_table.back().first_chunk;
+    chunks_.reserve(num_chunks);
+    for (size_t i = 0; i < chunk_info_table.size(); ++i) {
+      const size_t run_end = i + 1 < chunk_info_table.size()
+                                 ? chunk_info_table[i + 1].first_chunk - 1
+                                 : num_chunks;
+      const ChunkEntry entry = {chunk_info_table[i].samples_per_chunk,
+                                chunk_info_table[i].sample_description_index};
+      while (chunks_.size() < std::min(run_end, num_chunks))
+        chunks_.push_back(entry);
+    }
+  }
+
+  // Position the run-length cursors on the first sample, skipping empty
+  // entries in malformed tables.
+  const std::vector<DecodingTime>& deltas = decoding_time_table_.decoding_time;
+  while (delta_entry_index_ < deltas.size() &&
+         deltas[delta_entry_index_].sample_count == 0) {
+    ++delta_entry_index_;
+  }
+  if (delta_entry_index_ < deltas.size())
+    samples_left_in_delta_entry_ = deltas[delta_entry_index_].sample_count;
+
+  const std::vector<CompositionOffset>& offsets =
+      composition_offset_table_.composition_offset;
+  while (offset_entry_index_ < offsets.size() &&
+         offsets[offset_entry_index_].sample_count == 0) {
+    ++offset_entry_index_;
+  }
+  if (offset_entry_index_ < offsets.size())
+    samples_left_in_offset_entry_ = offsets[offset_entry_index_].sample_count;
+
+  if (!chunks_.empty())
+    samples_left_in_chunk_ = chunks_[0].samples_per_chunk;
+
+  SyncCurrentSample();
+}
+
+SampleTableIterator::~SampleTableIterator() {}
+
+bool SampleTableIterator::AdvanceSample() {
+  if (sample_number_ >= num_samples_)
+    return false;
+
+  const std::vector<uint32_t>& syncs = sync_sample_table_.sample_number;
+  if (sync_index_ < syncs.size() && syncs[sync_index_] == sample_number_)
+    ++sync_index_;
+  ++sample_number_;
+
+  const std::vector<DecodingTime>& deltas = decoding_time_table_.decoding_time;
+  if (samples_left_in_delta_entry_ > 0)
+    --samples_left_in_delta_entry_;
+  while (samples_left_in_delta_entry_ == 0 &&
+         ++delta_entry_index_ < deltas.size()) {
+    samples_left_in_delta_entry_ = deltas[delta_entry_index_].sample_count;
+  }
+
+  if (has_composition_offset_) {
+    const std::vector<CompositionOffset>& offsets =
+        composition_offset_table_.composition_offset;
+    if (samples_left_in_offset_entry_ > 0)
+      --samples_left_in_offset_entry_;
+    while (samples_left_in_offset_entry_ == 0 &&
+           ++offset_entry_index_ < offsets.size()) {
+      samples_left_in_offset_entry_ = offsets[offset_entry_index_].sample_count;
+    }
+  }
+
+  if (samples_left_in_chunk_ > 0)
+    --samples_left_in_chunk_;
+  while (samples_left_in_chunk_ == 0 && chunk_index_ + 1 < chunks_.size()) {
+    ++chunk_index_;
+    samples_left_in_chunk_ = chunks_[chunk_index_].samples_per_chunk;
+  }
+
+  SyncCurrentSample();
+  return true;
+}
+
+bool SampleTableIterator::IsValid() const {
+  return !decoding_time_table_.decoding_time.empty() && !chunks_.empty();
+}
+
+uint32_t SampleTableIterator::NumChunkSamples(uint32_t start_chunk,
+                                              uint32_t end_chunk) const {
+  uint32_t num_samples = 0;
+  const size_t end = std::min(static_cast<size_t>(end_chunk), chunks_.size());
+  for (size_t i = start_chunk > 0 ? start_chunk - 1 : 0; i < end; ++i)
+    num_samples += chunks_[i].samples_per_chunk;
+  return num_samples;
+}
+
+void SampleTableIterator::SyncCurrentSample() {
+  const std::vector<DecodingTime>& deltas = decoding_time_table_.decoding_time;
+  sample_delta_ = delta_entry_index_ < deltas.size()
+                      ? deltas[delta_entry_index_].sample_delta
+                      : 0;
+
+  if (has_composition_offset_) {
+    const std::vector<CompositionOffset>& offsets =
+        composition_offset_table_.composition_offset;
+    sample_offset_ = offset_entry_index_ < offsets.size()
+                         ? offsets[offset_entry_index_].sample_offset
+                         : 0;
+  }
+
+  const std::vector<uint32_t>& syncs = sync_sample_table_.sample_number;
+  is_sync_sample_ = syncs.empty() || (sync_index_ < syncs.size() &&
+                                      syncs[sync_index_] == sample_number_);
+}
+
+}  // namespace mp4
+}  // namespace media
+}  // namespace shaka
@@ -0,0 +1,116 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/formats/mp4/sample_table_iterator.h>
+
+#include <gtest/gtest.h>
+
+#include <packager/media/formats/mp4/chunk_info_iterator.h>
+#include <packager/media/formats/mp4/composition_offset_iterator.h>
+#include <packager/media/formats/mp4/decoding_time_iterator.h>
+#include <packager/media/formats/mp4/sync_sample_iterator.h>
+
+namespace shaka {
+namespace media {
+namespace mp4 {
+
+namespace {
+
+const DecodingTime kDecodingTimes[] = {{10, 8}, {9, 5}, {25, 7}, {48, 63},
+                                       {8, 2}};
+const CompositionOffset kCompositionOffsets[] = {{4, 8}, {26, 5}, {30, 7},
+                                                 {40, 63}};
+const ChunkInfo kChunkInfos[] = {{1, 8, 1}, {5, 5, 1}, {8, 7, 2}, {11, 8, 2}};
+const uint32_t kSyncSamples[] = {1, 10, 30, 35, 49, 80, 100};
+const uint32_t kNumChunks = 14;
+
+// All three sample counts agree: stts 10+9+25+48+8, ctts 4+26+30+40 and
+// stsc 4*8+3*5+3*7+4*8 each give 100 samples.
+SampleTable BuildSampleTable() {
+  SampleTable sample_table;
+  sample_table.decoding_time_to_sample.decoding_time.assign(
+      std::begin(kDecodingTimes), std::end(kDecodingTimes));
+  sample_table.composition_time_to_sample.composition_offset.assign(
+      std::begin(kCompositionOffsets), std::end(kCompositionOffsets));
+  sample_table.sample_to_chunk.chunk_info.assign(std::begin(kChunkInfos),
+                                                 std::end(kChunkInfos));
+  sample_table.sync_sample.sample_number.assign(std::begin(kSyncSamples),
+                                                std::end(kSyncSamples));
+  sample_table.chunk_large_offset.offsets.resize(kNumChunks);
+  return sample_table;
+}
+
+}  // namespace
+
+// The fused iterator must report, for every sample, exactly what the four
+// standalone table iterators report.
+TEST(SampleTableIteratorTest, MatchesStandaloneIterators) {
+  const SampleTable sample_table = BuildSampleTable();
+  SampleTableIterator fused(sample_table);
+
+  DecodingTimeIterator decoding_time(sample_table.decoding_time_to_sample);
+  CompositionOffsetIterator composition_offset(
+      sample_table.composition_time_to_sample);
+  ChunkInfoIterator chunk_info(sample_table.sample_to_chunk);
+  SyncSampleIterator sync_sample(sample_table.sync_sample);
+
+  ASSERT_TRUE(fused.IsValid());
+  ASSERT_TRUE(fused.has_composition_offset());
+  EXPECT_EQ(decoding_time.NumSamples(), fused.num_samples());
+  EXPECT_EQ(composition_offset.NumSamples(), fused.num_composition_samples());
+  EXPECT_EQ(chunk_info.LastFirstChunk(), fused.LastFirstChunk());
+  EXPECT_EQ(chunk_info.NumSamples(1, kNumChunks),
+            fused.NumChunkSamples(1, kNumChunks));
+
+  const uint32_t num_samples = fused.num_samples();
+  for (uint32_t sample = 1; sample <= num_samples; ++sample) {
+    EXPECT_EQ(chunk_info.current_chunk(), fused.current_chunk());
+    EXPECT_EQ(chunk_info.samples_per_chunk(), fused.samples_per_chunk());
+    EXPECT_EQ(chunk_info.sample_description_index(),
+              fused.sample_description_index());
+    EXPECT_EQ(decoding_time.sample_delta(), fused.sample_delta());
+    EXPECT_EQ(composition_offset.sample_offset(), fused.sample_offset());
+    EXPECT_EQ(sync_sample.IsSyncSample(), fused.IsSyncSample());
+
+    ASSERT_TRUE(chunk_info.AdvanceSample());
+    ASSERT_TRUE(sync_sample.AdvanceSample());
+    const bool more = sample != num_samples;
+    ASSERT_EQ(more, fused.AdvanceSample());
+    ASSERT_EQ(more, decoding_time.AdvanceSample());
+    ASSERT_EQ(more, composition_offset.AdvanceSample());
+  }
+  // Past the end, advancing keeps failing.
+  EXPECT_FALSE(fused.AdvanceSample());
+}
+
+TEST(SampleTableIteratorTest, NoCompositionOffsetAndNoSyncTable) {
+  SampleTable sample_table = BuildSampleTable();
+  sample_table.composition_time_to_sample.composition_offset.clear();
+  sample_table.sync_sample.sample_number.clear();
+
+  SampleTableIterator fused(sample_table);
+  ASSERT_TRUE(fused.IsValid());
+  EXPECT_FALSE(fused.has_composition_offset());
+  for (uint32_t sample = 1; sample <= fused.num_samples(); ++sample) {
+    EXPECT_EQ(0, fused.sample_offset());
+    // Without an stss table every sample is a sync sample.
+    EXPECT_TRUE(fused.IsSyncSample());
+    EXPECT_EQ(sample != fused.num_samples(), fused.AdvanceSample());
+  }
+}
+
+TEST(SampleTableIteratorTest, EmptyTables) {
+  SampleTable sample_table;
+  SampleTableIterator fused(sample_table);
+  EXPECT_FALSE(fused.IsValid());
+  EXPECT_EQ(0u, fused.num_samples());
+  EXPECT_EQ(0u, fused.LastFirstChunk());
+  EXPECT_FALSE(fused.AdvanceSample());
+}
+
+}  // namespace mp4
+}  // namespace media
+}  // namespace shaka
@@ -0,0 +1,197 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/formats/mp4/segment_rewriter.h>
+
+#include <limits>
+#include <string>
+
+#include <packager/macros/status.h>
+#include <packager/media/base/fourccs.h>
+
+namespace shaka {
+namespace media {
+namespace mp4 {
+
+namespace {
+
+uint32_t ReadUInt32(const uint8_t* buf) {
+  return (static_cast<uint32_t>(buf[0]) << 24) |
+         (static_cast<uint32_t>(buf[1]) << 16) |
+         (static_cast<uint32_t>(buf[2]) << 8) | buf[3];
+}
+
+uint64_t ReadUInt64(const uint8_t* buf) {
+  return (static_cast<uint64_t>(ReadUInt32(buf)) << 32) | ReadUInt32(buf + 4);
+}
+
+void WriteUInt32(uint8_t* buf, uint32_t v) {
+  buf[0] = static_cast<uint8_t>(v >> 24);
+  buf[1] = static_cast<uint8_t>(v >> 16);
+  buf[2] = static_cast<uint8_t>(v >> 8);
+  buf[3] = static_cast<uint8_t>(v);
+}
+
+void WriteUInt64(uint8_t* buf, uint64_t v) {
+  WriteUInt32(buf, static_cast<uint32_t>(v >> 32));
+  WriteUInt32(buf + 4, static_cast<uint32_t>(v));
+}
+
+Status MalformedSegment(const std::string& what) {
+  return Status(error::PARSER_FAILURE, "Malformed segment: " + what);
+}
+
+// Calls |callback(type, payload, payload_size)| for every box in
+// [buf, buf + size). |payload| points after the box header into the caller's
+// buffer, so the callback can patch box contents in place.
+template <typename Callback>
+Status ForEachBox(uint8_t* buf, size_t size, const Callback& callback) {
+  size_t pos = 0;
+  while (pos < size) {
+    const size_t remaining = size - pos;
+    if (remaining < 8)
+      return MalformedSegment("truncated box header");
+    uint64_t box_size = ReadUInt32(buf + pos);
+    const FourCC type = static_cast<FourCC>(ReadUInt32(buf + pos + 4));
+    size_t header_size = 8;
+    if (box_size == 1) {
+      if (remaining < 16)
+        return MalformedSegment("truncated 64-bit box header");
+      box_size = ReadUInt64(buf + pos + 8);
+      header_size = 16;
+    } else if (box_size == 0) {
+      // The box runs to the end of the buffer.
+      box_size = remaining;
+    }
+    if (box_size < header_size || box_size > remaining) {
+      return MalformedSegment("box '" + FourCCToString(type) +
+                              "' size out of range");
+    }
+    RETURN_IF_ERROR(callback(type, buf + pos + header_size,
+                             static_cast<size_t>(box_size) - header_size));
+    pos += static_cast<size_t>(box_size);
+  }
+  return Status::OK;
+}
+
+}  // namespace
+
+SegmentRewriter::SegmentRewriter(int64_t decode_time_offset,
+                                 int64_t sequence_number_offset)
+    : decode_time_offset_(decode_time_offset),
+      sequence_number_offset_(sequence_number_offset) {}
+
+SegmentRewriter::~SegmentRewriter() = default;
+
+Status SegmentRewriter::Rewrite(uint8_t* segment, size_t segment_size) {
+  return ForEachBox(
+      segment, segment_size,
+      [this](FourCC type, uint8_t* payload, size_t payload_size) {
+        switch (type) {
+          case FOURCC_moof:
+            return RewriteMovieFragment(payload, payload_size);
+          case FOURCC_sidx:
+            return RewriteSegmentIndex(payload, payload_size);
+          default:
+            // styp, mdat and anything else is reused as is.
+            return Status::OK;
+        }
+      });
+}
+
+Status SegmentRewriter::RewriteMovieFragment(uint8_t* box, size_t box_size) {
+  return ForEachBox(
+      box, box_size, [this](FourCC type, uint8_t* payload, size_t payload_size) {
+        switch (type) {
+          case FOURCC_mfhd: {
+            // FullBox header (4 bytes), then the sequence number.
+            if (payload_size < 8)
+              return MalformedSegment("mfhd too small");
+            const uint32_t sequence_number = ReadUInt32(payload + 4);
+            WriteUInt32(payload + 4,
+                        static_cast<uint32_t>(sequence_number +
+                                              sequence_number_offset_));
+            return Status::OK;
+          }
+          case FOURCC_traf:
+            return RewriteTrackFragment(payload, payload_size);
+          default:
+            return Status::OK;
+        }
+      });
+}
+
+Status SegmentRewriter::RewriteTrackFragment(uint8_t* box, size_t box_size) {
+  return ForEachBox(
+      box, box_size, [this](FourCC type, uint8_t* payload, size_t payload_size) {
+        if (type != FOURCC_tfdt)
+          return Status::OK;
+        if (payload_size < 4)
+          return MalformedSegment("tfdt too small");
+        const uint8_t version = payload[0];
+        if (version == 1) {
+          if (payload_size < 4 + sizeof(uint64_t))
+            return MalformedSegment("tfdt too small");
+          const uint64_t decode_time = ReadUInt64(payload + 4);
+          const int64_t shifted =
+              static_cast<int64_t>(decode_time) + decode_time_offset_;
+          if (shifted < 0) {
+            return Status(error::INVALID_ARGUMENT,
+                          "Shifted baseMediaDecodeTime is negative.");
+          }
+          WriteUInt64(payload + 4, static_cast<uint64_t>(shifted));
+        } else {
+          if (payload_size < 4 + sizeof(uint32_t))
+            return MalformedSegment("tfdt too small");
+          const int64_t shifted = ReadUInt32(payload + 4) + decode_time_offset_;
+          if (shifted < 0 ||
+              shifted > std::numeric_limits<uint32_t>::max()) {
+            // The field cannot grow in place; the segment would have to be
+            // repackaged with a version 1 tfdt.
+            return Status(error::INVALID_ARGUMENT,
+                          "Shifted baseMediaDecodeTime does not fit a "
+                          "version 0 tfdt.");
+          }
+          WriteUInt32(payload + 4, static_cast<uint32_t>(shifted));
+        }
+        return Status::OK;
+      });
+}
+
+Status SegmentRewriter::RewriteSegmentIndex(uint8_t* box, size_t box_size) {
+  // FullBox header (4 bytes), reference_ID (4), timescale (4), then
+  // earliestPresentationTime with a version dependent size.
+  if (box_size < 12)
+    return MalformedSegment("sidx too small");
+  const uint8_t version = box[0];
+  if (version == 1) {
+    if (box_size < 12 + sizeof(uint64_t))
+      return MalformedSegment("sidx too small");
+    const uint64_t presentation_time = ReadUInt64(box + 12);
+    const int64_t shifted =
+        static_cast<int64_t>(presentation_time) + decode_time_offset_;
+    if (shifted < 0) {
+      return Status(error::INVALID_ARGUMENT,
+                    "Shifted earliestPresentationTime is negative.");
+    }
+    WriteUInt64(box + 12, static_cast<uint64_t>(shifted));
+  } else {
+    if (box_size < 12 + sizeof(uint32_t))
+      return MalformedSegment("sidx too small");
+    const int64_t shifted = ReadUInt32(box + 12) + decode_time_offset_;
+    if (shifted < 0 || shifted > std::numeric_limits<uint32_t>::max()) {
+      return Status(error::INVALID_ARGUMENT,
+                    "Shifted earliestPresentationTime does not fit a "
+                    "version 0 sidx.");
+    }
+    WriteUInt32(box + 12, static_cast<uint32_t>(shifted));
+  }
+  return Status::OK;
+}
+
+}  // namespace mp4
+}  // namespace media
+}  // namespace shaka
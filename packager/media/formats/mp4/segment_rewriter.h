@@ -0,0 +1,64 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_MEDIA_FORMATS_MP4_SEGMENT_REWRITER_H_
+#define PACKAGER_MEDIA_FORMATS_MP4_SEGMENT_REWRITER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <packager/macros/classes.h>
+#include <packager/status.h>
+
+namespace shaka {
+namespace media {
+namespace mp4 {
+
+/// Rewrites the timestamps of already-packaged fMP4 (CMAF) segments in place,
+/// without running the demux/remux pipeline. Only the box headers of moof and
+/// sidx are parsed; the tfdt baseMediaDecodeTime, the mfhd sequence number
+/// and, when present, the sidx earliestPresentationTime are patched directly
+/// in the segment buffer and every other byte - in particular the mdat
+/// payload - is left untouched. This makes time-shift use cases such as live
+/// restart and catch-up, which only need a constant decode time shift, a
+/// per-segment header patch instead of a full repackaging job.
+class SegmentRewriter {
+ public:
+  /// @param decode_time_offset is added to each tfdt baseMediaDecodeTime and
+  ///        sidx earliestPresentationTime, in the media timescale. A sidx, if
+  ///        present, is expected to use the media timescale, which is how
+  ///        this packager writes it.
+  /// @param sequence_number_offset is added to each mfhd sequence number.
+  SegmentRewriter(int64_t decode_time_offset, int64_t sequence_number_offset);
+  ~SegmentRewriter();
+
+  /// Rewrite one segment in place.
+  /// @param segment is a buffer containing a whole segment, i.e. a sequence
+  ///        of top level boxes ([styp] [sidx] (moof mdat)+).
+  /// @param segment_size is the size of the segment, in bytes.
+  /// @return OK on success. An error is returned and the segment is left in
+  ///         a partially patched state if the box structure is malformed or
+  ///         a shifted value does not fit its field, e.g. a version 0 tfdt
+  ///         overflowing 32 bits.
+  Status Rewrite(uint8_t* segment, size_t segment_size);
+
+ private:
+  // Rewrites the children of a moof (mfhd and the traf tfdt boxes).
+  Status RewriteMovieFragment(uint8_t* box, size_t box_size);
+  Status RewriteTrackFragment(uint8_t* box, size_t box_size);
+  Status RewriteSegmentIndex(uint8_t* box, size_t box_size);
+
+  const int64_t decode_time_offset_;
+  const int64_t sequence_number_offset_;
+
+  DISALLOW_COPY_AND_ASSIGN(SegmentRewriter);
+};
+
+}  // namespace mp4
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_MEDIA_FORMATS_MP4_SEGMENT_REWRITER_H_
@@ -0,0 +1,132 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/media/formats/mp4/segment_rewriter.h>
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <packager/media/base/buffer_writer.h>
+#include <packager/media/formats/mp4/box_definitions.h>
+#include <packager/media/formats/mp4/box_reader.h>
+#include <packager/status/status_test_util.h>
+
+namespace shaka {
+namespace media {
+namespace mp4 {
+namespace {
+
+const uint32_t kTrackId = 1;
+const uint32_t kTimescale = 90000;
+const uint8_t kMdatPayload[] = {0xDE, 0xAD, 0xBE, 0xEF};
+
+// Builds a minimal segment: sidx, moof (mfhd + traf with tfhd/tfdt/trun) and
+// a small mdat.
+std::vector<uint8_t> BuildSegment(uint64_t decode_time,
+                                  uint32_t sequence_number) {
+  BufferWriter writer;
+
+  SegmentIndex sidx;
+  sidx.reference_id = kTrackId;
+  sidx.timescale = kTimescale;
+  sidx.earliest_presentation_time = decode_time;
+  sidx.Write(&writer);
+
+  MovieFragment moof;
+  moof.header.sequence_number = sequence_number;
+  moof.tracks.resize(1);
+  moof.tracks[0].header.track_id = kTrackId;
+  moof.tracks[0].decode_time.decode_time = decode_time;
+  moof.tracks[0].runs.resize(1);
+  moof.tracks[0].runs[0].flags =
+      TrackFragmentRun::kDataOffsetPresentMask;
+  moof.Write(&writer);
+
+  writer.AppendInt(
+      static_cast<uint32_t>(sizeof(uint32_t) * 2 + sizeof(kMdatPayload)));
+  writer.AppendInt(static_cast<uint32_t>(FOURCC_mdat));
+  writer.AppendArray(kMdatPayload, sizeof(kMdatPayload));
+
+  return std::vector<uint8_t>(writer.Buffer(), writer.Buffer() + writer.Size());
+}
+
+}  // namespace
+
+TEST(SegmentRewriterTest, ShiftsTimestampsAndSequenceNumber) {
+  const uint64_t kDecodeTime = 90000;
+  const uint32_t kSequenceNumber = 7;
+  const int64_t kDecodeTimeOffset = 45000;
+  const int64_t kSequenceNumberOffset = 3;
+
+  std::vector<uint8_t> segment = BuildSegment(kDecodeTime, kSequenceNumber);
+
+  SegmentRewriter rewriter(kDecodeTimeOffset, kSequenceNumberOffset);
+  ASSERT_OK(rewriter.Rewrite(segment.data(), segment.size()));
+
+  bool err = false;
+  std::unique_ptr<BoxReader> reader(
+      BoxReader::ReadBox(segment.data(), segment.size(), &err));
+  ASSERT_TRUE(reader);
+  ASSERT_EQ(FOURCC_sidx, reader->type());
+  SegmentIndex sidx;
+  ASSERT_TRUE(sidx.Parse(reader.get()));
+  EXPECT_EQ(kDecodeTime + kDecodeTimeOffset, sidx.earliest_presentation_time);
+
+  const size_t moof_offset = reader->size();
+  reader.reset(BoxReader::ReadBox(segment.data() + moof_offset,
+                                  segment.size() - moof_offset, &err));
+  ASSERT_TRUE(reader);
+  ASSERT_EQ(FOURCC_moof, reader->type());
+  MovieFragment moof;
+  ASSERT_TRUE(moof.Parse(reader.get()));
+  EXPECT_EQ(kSequenceNumber + kSequenceNumberOffset,
+            moof.header.sequence_number);
+  ASSERT_EQ(1u, moof.tracks.size());
+  EXPECT_EQ(kDecodeTime + kDecodeTimeOffset,
+            moof.tracks[0].decode_time.decode_time);
+
+  // The mdat payload must be untouched.
+  EXPECT_EQ(std::vector<uint8_t>(std::begin(kMdatPayload),
+                                 std::end(kMdatPayload)),
+            std::vector<uint8_t>(segment.end() - sizeof(kMdatPayload),
+                                 segment.end()));
+}
+
+TEST(SegmentRewriterTest, NegativeShift) {
+  const uint64_t kDecodeTime = 90000;
+  std::vector<uint8_t> segment = BuildSegment(kDecodeTime, 1);
+
+  SegmentRewriter rewriter(-45000, 0);
+  ASSERT_OK(rewriter.Rewrite(segment.data(), segment.size()));
+
+  bool err = false;
+  std::unique_ptr<BoxReader> reader(
+      BoxReader::ReadBox(segment.data(), segment.size(), &err));
+  ASSERT_TRUE(reader);
+  SegmentIndex sidx;
+  ASSERT_TRUE(sidx.Parse(reader.get()));
+  EXPECT_EQ(kDecodeTime - 45000, sidx.earliest_presentation_time);
+
+  // Shifting below zero must fail.
+  SegmentRewriter underflow_rewriter(-90000, 0);
+  EXPECT_EQ(error::INVALID_ARGUMENT,
+            underflow_rewriter.Rewrite(segment.data(), segment.size())
+                .error_code());
+}
+
+TEST(SegmentRewriterTest, MalformedSegment) {
+  std::vector<uint8_t> segment = BuildSegment(0, 1);
+  // Truncating the buffer makes the last box size run out of range.
+  SegmentRewriter rewriter(100, 0);
+  EXPECT_EQ(error::PARSER_FAILURE,
+            rewriter.Rewrite(segment.data(), segment.size() - 1).error_code());
+}
+
+}  // namespace mp4
+}  // namespace media
+}  // namespace shaka
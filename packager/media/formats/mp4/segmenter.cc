@@ -46,7 +46,15 @@ Segmenter::Segmenter(const MuxerOptions& options,
       moov_(std::move(moov)),
       moof_(new MovieFragment()),
       fragment_buffer_(new BufferWriter()),
-      sidx_(new SegmentIndex()) {}
+      sidx_(new SegmentIndex()) {
+  // The segment template has been validated before the segmenter is created;
+  // compile it once so per-segment name generation does not re-parse it.
+  if (!options_.segment_template.empty()) {
+    const Status status =
+        segment_name_template_.Compile(options_.segment_template);
+    DCHECK_EQ(Status::OK, status);
+  }
+}
 
 Segmenter::~Segmenter() {}
 
@@ -182,7 +190,7 @@ Status Segmenter::FinalizeSegment(size_t stream_id,
     TrackFragment& traf = moof_->tracks[i];
     if (traf.auxiliary_offset.offsets.size() > 0) {
       DCHECK_EQ(traf.auxiliary_offset.offsets.size(), 1u);
-      DCHECK(!traf.sample_encryption.sample_encryption_entries.empty());
+      DCHECK_GT(traf.sample_encryption.sample_count, 0u);
 
       next_traf_position += traf.box_size();
       // SampleEncryption 'senc' box should be the last box in 'traf'.
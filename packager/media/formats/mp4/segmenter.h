@@ -14,6 +14,7 @@
 
 #include <packager/macros/classes.h>
 #include <packager/media/base/fourccs.h>
+#include <packager/media/base/muxer_util.h>
 #include <packager/media/base/range.h>
 #include <packager/media/formats/mp4/box_definitions.h>
 #include <packager/status.h>
@@ -110,6 +111,11 @@ class Segmenter {
   void SetComplete();
 
   const MuxerOptions& options() const { return options_; }
+  // The precompiled form of |options().segment_template|, for per-segment
+  // name generation. Only valid if the template is non-empty.
+  const SegmentNameTemplate& segment_name_template() const {
+    return segment_name_template_;
+  }
   FileType* ftyp() { return ftyp_.get(); }
   Movie* moov() { return moov_.get(); }
   BufferWriter* fragment_buffer() { return fragment_buffer_.get(); }
@@ -139,6 +145,7 @@ class Segmenter {
       const EncryptionConfig& encryption_config);
 
   const MuxerOptions& options_;
+  SegmentNameTemplate segment_name_template_;
   std::unique_ptr<FileType> ftyp_;
   std::unique_ptr<Movie> moov_;
   std::unique_ptr<MovieFragment> moof_;
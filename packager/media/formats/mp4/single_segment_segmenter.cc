@@ -7,10 +7,15 @@
 #include <packager/media/formats/mp4/single_segment_segmenter.h>
 
 #include <algorithm>
+#include <cstring>
+#include <limits>
 
 #include <absl/log/check.h>
+#include <absl/log/log.h>
+#include <absl/synchronization/mutex.h>
 
 #include <packager/file/file_util.h>
+#include <packager/file/thread_pool.h>
 #include <packager/media/base/buffer_writer.h>
 #include <packager/media/base/muxer_options.h>
 #include <packager/media/event/progress_listener.h>
@@ -19,6 +24,46 @@
 namespace shaka {
 namespace media {
 namespace mp4 {
+namespace {
+
+const int kCopyBufferSize = 0x200000;  // 2MB.
+
+// Finalization copies the muxed media from the temp file into the output
+// right after the moov. The copy is pure I/O, so for large local outputs it
+// is split into byte ranges copied concurrently on the thread pool; each
+// worker uses its own file handles so the streams are independent.
+const int kMaxParallelCopyRanges = 8;
+const int64_t kMinBytesPerCopyRange = 32 * 1024 * 1024;  // 32MB.
+
+// Parallel range copies need seekable, independently writable handles, which
+// only local files provide.
+bool IsLocalFileName(const std::string& file_name) {
+  const size_t pos = file_name.find("://");
+  return pos == std::string::npos || file_name.find("file://") == 0;
+}
+
+// Byte size of one sidx reference entry on the wire.
+const size_t kSidxEntrySize = 12;
+
+// Serializes one sidx reference entry in wire form. The layout must match
+// SegmentIndex::ReadWriteInternal in box_definitions.cc.
+void EncodeSidxEntry(const SegmentReference& ref,
+                     uint8_t entry[kSidxEntrySize]) {
+  uint32_t reference_type_size = ref.referenced_size;
+  if (ref.reference_type)
+    reference_type_size |= (1 << 31);
+  uint32_t sap = (ref.sap_type << 28) | ref.sap_delta_time;
+  if (ref.starts_with_sap)
+    sap |= (1 << 31);
+  BufferWriter writer(kSidxEntrySize);
+  writer.AppendInt(reference_type_size);
+  writer.AppendInt(ref.subsegment_duration);
+  writer.AppendInt(sap);
+  DCHECK_EQ(kSidxEntrySize, writer.Size());
+  memcpy(entry, writer.Buffer(), kSidxEntrySize);
+}
+
+}  // namespace
 
 SingleSegmentSegmenter::SingleSegmentSegmenter(const MuxerOptions& options,
                                                std::unique_ptr<FileType> ftyp,
@@ -69,6 +114,87 @@ std::vector<Range> SingleSegmentSegmenter::GetSegmentRanges() {
   return ranges;
 }
 
+Status SingleSegmentSegmenter::RewriteSegment(size_t segment_index,
+                                              const SegmentReference& reference,
+                                              const uint8_t* segment_data,
+                                              size_t segment_size) {
+  DCHECK(segment_data);
+  if (!finalized_) {
+    return Status(error::INVALID_ARGUMENT,
+                  "Segments can only be rewritten after finalization.");
+  }
+  if (!IsLocalFileName(options().output_file_name)) {
+    return Status(error::INVALID_ARGUMENT,
+                  "In-place segment rewrite requires a local output file: " +
+                      options().output_file_name);
+  }
+  if (segment_index >= vod_sidx_->references.size()) {
+    return Status(error::INVALID_ARGUMENT, "No such segment to rewrite.");
+  }
+  // The byte extents of the following segments must not move, so the
+  // replacement must match the original segment byte for byte in size.
+  const SegmentReference& old_reference =
+      vod_sidx_->references[segment_index];
+  if (segment_size != old_reference.referenced_size ||
+      reference.referenced_size != old_reference.referenced_size) {
+    return Status(
+        error::INVALID_ARGUMENT,
+        "In-place segment rewrite requires an identically sized segment.");
+  }
+
+  // Patch the sidx reference. Reference entries are fixed width and the box
+  // header fields are untouched, so only the 12 bytes of this entry change
+  // on the wire.
+  vod_sidx_->references[segment_index] = reference;
+  DCHECK_LE((segment_index + 1) * kSidxEntrySize, vod_sidx_entries_.size());
+  EncodeSidxEntry(reference,
+                  &vod_sidx_entries_[segment_index * kSidxEntrySize]);
+
+  // "r+" leaves the rest of the file untouched.
+  std::unique_ptr<File, FileCloser> file(
+      File::Open(options().output_file_name.c_str(), "r+"));
+  if (!file) {
+    return Status(error::FILE_FAILURE,
+                  "Cannot open file to update " + options().output_file_name);
+  }
+
+  // References past the 16-bit sidx reference count were truncated from the
+  // written box, so there is no entry to patch for them.
+  if (options().mp4_params.generate_sidx_in_media_segments &&
+      segment_index < std::numeric_limits<uint16_t>::max()) {
+    const uint64_t sidx_offset = ftyp()->ComputeSize() + moov()->ComputeSize();
+    const size_t written_references =
+        std::min(vod_sidx_->references.size(),
+                 static_cast<size_t>(std::numeric_limits<uint16_t>::max()));
+    const uint64_t entry_offset =
+        sidx_offset +
+        (vod_sidx_->ComputeSize() - written_references * kSidxEntrySize) +
+        segment_index * kSidxEntrySize;
+    if (!file->Seek(entry_offset) ||
+        file->Write(&vod_sidx_entries_[segment_index * kSidxEntrySize],
+                    kSidxEntrySize) != static_cast<int64_t>(kSidxEntrySize)) {
+      return Status(error::FILE_FAILURE,
+                    "Failed to patch sidx in " + options().output_file_name);
+    }
+  }
+
+  const Range range = GetSegmentRanges()[segment_index];
+  if (!file->Seek(range.start) ||
+      file->Write(segment_data, segment_size) !=
+          static_cast<int64_t>(segment_size)) {
+    return Status(error::FILE_FAILURE,
+                  "Failed to rewrite segment in " + options().output_file_name);
+  }
+
+  if (!file.release()->Close()) {
+    return Status(
+        error::FILE_FAILURE,
+        "Cannot close file " + options().output_file_name +
+            ", possibly file permission issue or running out of disk space.");
+  }
+  return Status::OK;
+}
+
 Status SingleSegmentSegmenter::DoInitialize() {
   // Single segment segmentation involves two stages:
   //   Stage 1: Create media subsegments from media samples
@@ -117,12 +243,43 @@ Status SingleSegmentSegmenter::DoFinalize() {
   moov()->Write(buffer.get());
 
   if (options().mp4_params.generate_sidx_in_media_segments)
-    vod_sidx_->Write(buffer.get());
+    WriteVodSidx(buffer.get());
 
+  const uint64_t header_size = buffer->Size();
   Status status = buffer->WriteToFile(file.get());
   if (!status.ok())
     return status;
 
+  // The target of 2nd stage of single segment segmentation.
+  const uint64_t re_segment_progress_target = progress_target() * 0.5;
+
+  // Copy the media from the temp file in concurrent byte ranges when both
+  // files are local and large enough for the fan-out to pay off.
+  const int64_t temp_file_size = File::GetFileSize(temp_file_name_.c_str());
+  if (temp_file_size > 0 && IsLocalFileName(temp_file_name_) &&
+      IsLocalFileName(options().output_file_name)) {
+    const int num_ranges =
+        static_cast<int>(std::min<int64_t>(kMaxParallelCopyRanges,
+                                           temp_file_size /
+                                               kMinBytesPerCopyRange));
+    if (num_ranges > 1) {
+      if (!file.release()->Close()) {
+        return Status(
+            error::FILE_FAILURE,
+            "Cannot close file " + options().output_file_name +
+                ", possibly file permission issue or running out of disk "
+                "space.");
+      }
+      status = ParallelCopyTempFile(header_size, temp_file_size, num_ranges);
+      if (!status.ok())
+        return status;
+      UpdateProgress(re_segment_progress_target);
+      finalized_ = true;
+      SetComplete();
+      return Status::OK;
+    }
+  }
+
   // Load the temp file and write to output file.
   std::unique_ptr<File, FileCloser> temp_file(
       File::Open(temp_file_name_.c_str(), "r"));
@@ -131,13 +288,9 @@ Status SingleSegmentSegmenter::DoFinalize() {
                   "Cannot open file to read " + temp_file_name_);
   }
 
-  // The target of 2nd stage of single segment segmentation.
-  const uint64_t re_segment_progress_target = progress_target() * 0.5;
-
-  const int kBufSize = 0x200000;  // 2MB.
-  std::unique_ptr<uint8_t[]> buf(new uint8_t[kBufSize]);
+  std::unique_ptr<uint8_t[]> buf(new uint8_t[kCopyBufferSize]);
   while (true) {
-    int64_t size = temp_file->Read(buf.get(), kBufSize);
+    int64_t size = temp_file->Read(buf.get(), kCopyBufferSize);
     if (size == 0) {
       break;
     } else if (size < 0) {
@@ -162,10 +315,126 @@ Status SingleSegmentSegmenter::DoFinalize() {
         "Cannot close file " + options().output_file_name +
             ", possibly file permission issue or running out of disk space.");
   }
+  finalized_ = true;
   SetComplete();
   return Status::OK;
 }
 
+void SingleSegmentSegmenter::WriteVodSidx(BufferWriter* writer) {
+  DCHECK(vod_sidx_);
+  DCHECK_EQ(vod_sidx_->references.size() * kSidxEntrySize,
+            vod_sidx_entries_.size());
+
+  // ComputeSize() also picks the box version from the header field widths.
+  // The header layout must match FullBox::ReadWriteHeaderInternal and
+  // SegmentIndex::ReadWriteInternal; the reference entries were already
+  // serialized as the segments completed, so writing the box is a header
+  // write plus one bulk append regardless of the reference count.
+  writer->AppendInt(static_cast<uint32_t>(vod_sidx_->ComputeSize()));
+  uint32_t fourcc = FOURCC_sidx;
+  writer->AppendInt(fourcc);
+  writer->AppendInt((static_cast<uint32_t>(vod_sidx_->version) << 24) |
+                    vod_sidx_->flags);
+  writer->AppendInt(vod_sidx_->reference_id);
+  writer->AppendInt(vod_sidx_->timescale);
+  const size_t num_bytes =
+      (vod_sidx_->version == 1) ? sizeof(uint64_t) : sizeof(uint32_t);
+  writer->AppendNBytes(vod_sidx_->earliest_presentation_time, num_bytes);
+  writer->AppendNBytes(vod_sidx_->first_offset, num_bytes);
+
+  size_t reference_count = vod_sidx_->references.size();
+  if (reference_count > std::numeric_limits<uint16_t>::max()) {
+    reference_count = std::numeric_limits<uint16_t>::max();
+    LOG(WARNING) << "Seeing " << vod_sidx_->references.size()
+                 << " subsegment references, but at most " << reference_count
+                 << " references can be stored in 'sidx' box."
+                 << " The extra references are truncated.";
+  }
+  writer->AppendInt(static_cast<uint16_t>(0));  // reserved.
+  writer->AppendInt(static_cast<uint16_t>(reference_count));
+  writer->AppendArray(vod_sidx_entries_.data(),
+                      reference_count * kSidxEntrySize);
+}
+
+Status SingleSegmentSegmenter::ParallelCopyTempFile(uint64_t output_offset,
+                                                    int64_t temp_file_size,
+                                                    int num_ranges) {
+  const int64_t bytes_per_range = temp_file_size / num_ranges;
+
+  absl::Mutex mutex;
+  Status copy_status;                  // Protected by |mutex|.
+  int pending_ranges = num_ranges;     // Protected by |mutex|.
+
+  for (int i = 0; i < num_ranges; i++) {
+    const int64_t start = i * bytes_per_range;
+    const int64_t end =
+        (i == num_ranges - 1) ? temp_file_size : start + bytes_per_range;
+    ThreadPool::instance.PostTask(
+        [this, output_offset, start, end, &mutex, &copy_status,
+         &pending_ranges]() {
+          Status status = CopyTempFileRange(output_offset, start, end);
+          absl::MutexLock lock(&mutex);
+          copy_status.Update(status);
+          --pending_ranges;
+        });
+  }
+
+  absl::MutexLock lock(&mutex);
+  mutex.Await(absl::Condition(
+      +[](int* pending) { return *pending == 0; }, &pending_ranges));
+  return copy_status;
+}
+
+Status SingleSegmentSegmenter::CopyTempFileRange(uint64_t output_offset,
+                                                 int64_t start,
+                                                 int64_t end) {
+  // Open without buffering: the threaded I/O wrapper does not support seeking
+  // within an output file, and each worker streams its range sequentially
+  // anyway.
+  std::unique_ptr<File, FileCloser> temp_file(
+      File::OpenWithNoBuffering(temp_file_name_.c_str(), "r"));
+  if (!temp_file || !temp_file->Seek(start)) {
+    return Status(error::FILE_FAILURE,
+                  "Cannot open file to read " + temp_file_name_);
+  }
+  // "r+" leaves the already written file header in place.
+  std::unique_ptr<File, FileCloser> output_file(
+      File::OpenWithNoBuffering(options().output_file_name.c_str(), "r+"));
+  if (!output_file || !output_file->Seek(output_offset + start)) {
+    return Status(error::FILE_FAILURE,
+                  "Cannot open file to write " + options().output_file_name);
+  }
+
+  std::unique_ptr<uint8_t[]> buf(new uint8_t[kCopyBufferSize]);
+  int64_t remaining = end - start;
+  while (remaining > 0) {
+    const int64_t size = temp_file->Read(
+        buf.get(), std::min<int64_t>(kCopyBufferSize, remaining));
+    if (size <= 0) {
+      return Status(error::FILE_FAILURE,
+                    "Failed to read file " + temp_file_name_);
+    }
+    const int64_t size_written = output_file->Write(buf.get(), size);
+    if (size_written != size) {
+      return Status(error::FILE_FAILURE,
+                    "Failed to write file " + options().output_file_name);
+    }
+    remaining -= size;
+  }
+
+  if (!temp_file.release()->Close()) {
+    return Status(error::FILE_FAILURE, "Cannot close the temp file " +
+                                           temp_file_name_ + " after reading.");
+  }
+  if (!output_file.release()->Close()) {
+    return Status(
+        error::FILE_FAILURE,
+        "Cannot close file " + options().output_file_name +
+            ", possibly file permission issue or running out of disk space.");
+  }
+  return Status::OK;
+}
+
 Status SingleSegmentSegmenter::DoFinalizeSegment() {
   DCHECK(sidx());
   DCHECK(fragment_buffer());
@@ -206,6 +475,11 @@ Status SingleSegmentSegmenter::DoFinalizeSegment() {
     vod_sidx_->earliest_presentation_time = vod_ref.earliest_presentation_time;
   }
   vod_sidx_->references.push_back(vod_ref);
+  // Keep the serialized form of the reference list current, so finalization
+  // does not have to encode tens of thousands of references in one go.
+  vod_sidx_entries_.resize(vod_sidx_entries_.size() + kSidxEntrySize);
+  EncodeSidxEntry(vod_ref,
+                  &vod_sidx_entries_[vod_sidx_entries_.size() - kSidxEntrySize]);
 
   if (muxer_listener()) {
     for (const KeyFrameInfo& key_frame_info : key_frame_infos()) {
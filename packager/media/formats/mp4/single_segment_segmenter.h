@@ -7,6 +7,8 @@
 #ifndef PACKAGER_MEDIA_FORMATS_MP4_SINGLE_SEGMENT_SEGMENTER_H_
 #define PACKAGER_MEDIA_FORMATS_MP4_SINGLE_SEGMENT_SEGMENTER_H_
 
+#include <vector>
+
 #include <packager/file/file_closer.h>
 #include <packager/macros/classes.h>
 #include <packager/media/event/muxer_listener.h>
@@ -40,15 +42,52 @@ class SingleSegmentSegmenter : public Segmenter {
   std::vector<Range> GetSegmentRanges() override;
   /// @}
 
+  /// Rewrites one (sub)segment of the finalized single-file output in place.
+  /// @a segment_data holds the replacement moof+mdat bytes and must be exactly
+  /// as large as the segment it replaces: the byte extents of the following
+  /// segments (published as playlist byte ranges) cannot move. The sidx
+  /// reference for the segment is replaced with @a reference and the sidx box
+  /// is patched in place, so timing corrections (e.g. a discontinuity fix)
+  /// only touch the affected bytes instead of re-muxing the whole asset.
+  /// Can only be called after the output has been finalized, and requires a
+  /// local (seekable) output file.
+  /// @return OK on success.
+  Status RewriteSegment(size_t segment_index,
+                        const SegmentReference& reference,
+                        const uint8_t* segment_data,
+                        size_t segment_size);
+
  private:
   // Segmenter implementation overrides.
   Status DoInitialize() override;
   Status DoFinalize() override;
   Status DoFinalizeSegment() override;
 
+  // Copies the whole temp file into the output file at |output_offset| using
+  // |num_ranges| concurrent range copies on the thread pool. Requires both
+  // files to be local so each worker can operate on its own file handles.
+  Status ParallelCopyTempFile(uint64_t output_offset,
+                              int64_t temp_file_size,
+                              int num_ranges);
+  // Copies temp file bytes [start, end) to the output file at
+  // |output_offset| + |start|.
+  Status CopyTempFileRange(uint64_t output_offset, int64_t start, int64_t end);
+
+  // Serializes the VOD sidx box: the box header from |vod_sidx_| followed by
+  // the pre-encoded reference entries in |vod_sidx_entries_|.
+  void WriteVodSidx(BufferWriter* writer);
+
   std::unique_ptr<SegmentIndex> vod_sidx_;
+  // Wire-ready sidx reference entries, one fixed-width entry appended per
+  // finalized segment, so finalization writes the box header plus this blob
+  // instead of re-serializing every reference. Kept in sync with
+  // |vod_sidx_->references|.
+  std::vector<uint8_t> vod_sidx_entries_;
   std::string temp_file_name_;
   std::unique_ptr<File, FileCloser> temp_file_;
+  // Set once DoFinalize() has written the complete output file;
+  // RewriteSegment() is only valid from then on.
+  bool finalized_ = false;
 
   DISALLOW_COPY_AND_ASSIGN(SingleSegmentSegmenter);
 };
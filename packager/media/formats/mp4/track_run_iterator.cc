@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <map>
 
 #include <absl/flags/flag.h>
 #include <absl/log/check.h>
@@ -14,10 +15,7 @@
 #include <packager/media/base/buffer_reader.h>
 #include <packager/media/base/fourccs.h>
 #include <packager/media/base/rcheck.h>
-#include <packager/media/formats/mp4/chunk_info_iterator.h>
-#include <packager/media/formats/mp4/composition_offset_iterator.h>
-#include <packager/media/formats/mp4/decoding_time_iterator.h>
-#include <packager/media/formats/mp4/sync_sample_iterator.h>
+#include <packager/media/formats/mp4/sample_table_iterator.h>
 
 ABSL_FLAG(bool,
           mp4_reset_initial_composition_offset_to_zero,
@@ -52,6 +50,13 @@ struct TrackRunInfo {
   std::vector<SampleInfo> samples;
   int64_t timescale;
   int64_t start_dts;
+  // Decode timestamp right after the last sample of the run. Used by
+  // AdvanceToTimestamp() to drop whole runs before a seek target.
+  int64_t end_dts;
+  // Index of the first sample to emit. Nonzero only after
+  // AdvanceToTimestamp() skipped the samples ahead of a seek target within
+  // this run.
+  size_t first_sample;
   int64_t sample_start_offset;
 
   TrackType track_type;
@@ -77,6 +82,8 @@ TrackRunInfo::TrackRunInfo()
     : track_id(0),
       timescale(-1),
       start_dts(-1),
+      end_dts(-1),
+      first_sample(0),
       sample_start_offset(-1),
       track_type(kInvalid),
       audio_description(NULL),
@@ -171,15 +178,9 @@ bool TrackRunIterator::Init() {
       continue;
     }
 
-    DecodingTimeIterator decoding_time(
-        trak->media.information.sample_table.decoding_time_to_sample);
-    CompositionOffsetIterator composition_offset(
-        trak->media.information.sample_table.composition_time_to_sample);
-    bool has_composition_offset = composition_offset.IsValid();
-    ChunkInfoIterator chunk_info(
-        trak->media.information.sample_table.sample_to_chunk);
-    SyncSampleIterator sync_sample(
-        trak->media.information.sample_table.sync_sample);
+    // Single fused cursor over stts, ctts, stsc and stss; advanced once per
+    // sample below.
+    SampleTableIterator stbl(trak->media.information.sample_table);
     // Skip processing saiz and saio boxes for non-fragmented mp4 as we
     // don't support encrypted non-fragmented mp4.
 
@@ -196,24 +197,23 @@ bool TrackRunIterator::Init() {
     uint32_t num_chunks = static_cast<uint32_t>(chunk_offset_vector.size());
 
     // Check that total number of samples match.
-    DCHECK_EQ(num_samples, decoding_time.NumSamples());
-    if (has_composition_offset) {
-      DCHECK_EQ(num_samples, composition_offset.NumSamples());
+    DCHECK_EQ(num_samples, stbl.num_samples());
+    if (stbl.has_composition_offset()) {
+      DCHECK_EQ(num_samples, stbl.num_composition_samples());
     }
     if (num_chunks > 0) {
-      DCHECK_EQ(num_samples, chunk_info.NumSamples(1, num_chunks));
+      DCHECK_EQ(num_samples, stbl.NumChunkSamples(1, num_chunks));
     }
-    DCHECK_GE(num_chunks, chunk_info.LastFirstChunk());
+    DCHECK_GE(num_chunks, stbl.LastFirstChunk());
 
     if (num_samples > 0) {
       // Verify relevant tables are not empty.
-      RCHECK(decoding_time.IsValid());
-      RCHECK(chunk_info.IsValid());
+      RCHECK(stbl.IsValid());
     }
 
     uint32_t sample_index = 0;
     for (uint32_t chunk_index = 0; chunk_index < num_chunks; ++chunk_index) {
-      RCHECK(chunk_info.current_chunk() == chunk_index + 1);
+      RCHECK(stbl.current_chunk() == chunk_index + 1);
 
       TrackRunInfo tri;
       tri.track_id = trak->header.track_id;
@@ -221,7 +221,7 @@ bool TrackRunIterator::Init() {
       tri.start_dts = run_start_dts;
       tri.sample_start_offset = chunk_offset_vector[chunk_index];
 
-      uint32_t desc_idx = chunk_info.sample_description_index();
+      uint32_t desc_idx = stbl.sample_description_index();
       RCHECK(desc_idx > 0);  // Descriptions are one-indexed in the file.
       desc_idx -= 1;
 
@@ -244,36 +244,26 @@ bool TrackRunIterator::Init() {
                    .default_is_protected == 0);
       }
 
-      uint32_t samples_per_chunk = chunk_info.samples_per_chunk();
+      uint32_t samples_per_chunk = stbl.samples_per_chunk();
       tri.samples.resize(samples_per_chunk);
       for (uint32_t k = 0; k < samples_per_chunk; ++k) {
         SampleInfo& sample = tri.samples[k];
         sample.size = sample_size.sample_size != 0
                           ? sample_size.sample_size
                           : sample_size.sizes[sample_index];
-        sample.duration = decoding_time.sample_delta();
-        sample.cts_offset =
-            has_composition_offset ? composition_offset.sample_offset() : 0;
-        sample.is_keyframe = sync_sample.IsSyncSample();
+        sample.duration = stbl.sample_delta();
+        sample.cts_offset = stbl.sample_offset();
+        sample.is_keyframe = stbl.IsSyncSample();
 
         run_start_dts += sample.duration;
 
-        // Advance to next sample. Should success except for last sample.
+        // Advance to next sample. Should succeed except for the last sample,
+        // where all tables must end together.
         ++sample_index;
-        RCHECK(chunk_info.AdvanceSample() && sync_sample.AdvanceSample());
-        if (sample_index == num_samples) {
-          // We should hit end of tables for decoding time and composition
-          // offset.
-          RCHECK(!decoding_time.AdvanceSample());
-          if (has_composition_offset)
-            RCHECK(!composition_offset.AdvanceSample());
-        } else {
-          RCHECK(decoding_time.AdvanceSample());
-          if (has_composition_offset)
-            RCHECK(composition_offset.AdvanceSample());
-        }
+        RCHECK(stbl.AdvanceSample() == (sample_index != num_samples));
       }
 
+      tri.end_dts = run_start_dts;
       runs_.push_back(tri);
     }
   }
@@ -427,6 +417,7 @@ bool TrackRunIterator::Init(const MovieFragment& moof) {
         PopulateSampleInfo(*trex, traf.header, trun, k, &tri.samples[k]);
         run_start_dts += tri.samples[k].duration;
       }
+      tri.end_dts = run_start_dts;
       runs_.push_back(tri);
       sample_count_sum += trun.sample_count;
     }
@@ -444,12 +435,83 @@ void TrackRunIterator::AdvanceRun() {
   ResetRun();
 }
 
+bool TrackRunIterator::AdvanceToTimestamp(double timestamp_seconds) {
+  // Find, per track, the last sync sample at or before the target. Decode -
+  // and for encrypted sources decryption - can begin exactly there: the
+  // per-sample encryption info from 'senc' or saio/saiz is indexed by sample
+  // position within each run, so no earlier sample is required. For audio
+  // tracks every sample is a sync sample, so they snap to the last sample
+  // before the target.
+  std::map<uint32_t, int64_t> sync_dts_by_track;
+  for (const TrackRunInfo& tri : runs_) {
+    int64_t dts = tri.start_dts;
+    for (const SampleInfo& sample : tri.samples) {
+      if (static_cast<double>(dts) / tri.timescale > timestamp_seconds)
+        break;
+      if (sample.is_keyframe) {
+        auto result = sync_dts_by_track.emplace(tri.track_id, dts);
+        if (!result.second)
+          result.first->second = std::max(result.first->second, dts);
+      }
+      dts += sample.duration;
+    }
+  }
+
+  // Drop whole runs that end at or before the seek point of their track.
+  // Tracks without a sync sample before the target fall back to chunk
+  // granularity: the run containing the target is kept, as before. Runs are
+  // sorted by data offset, not by time, so each run is tested individually
+  // against its own timescale.
+  runs_.erase(
+      std::remove_if(runs_.begin(), runs_.end(),
+                     [&sync_dts_by_track,
+                      timestamp_seconds](const TrackRunInfo& tri) {
+                       const auto it = sync_dts_by_track.find(tri.track_id);
+                       if (it != sync_dts_by_track.end())
+                         return tri.end_dts <= it->second;
+                       return static_cast<double>(tri.end_dts) /
+                                  tri.timescale <=
+                              timestamp_seconds;
+                     }),
+      runs_.end());
+
+  // Within the run containing a track's sync sample, skip the samples ahead
+  // of it so emission resumes at the sync sample itself instead of the start
+  // of the chunk.
+  for (TrackRunInfo& tri : runs_) {
+    const auto it = sync_dts_by_track.find(tri.track_id);
+    if (it == sync_dts_by_track.end() || tri.start_dts > it->second ||
+        tri.end_dts <= it->second) {
+      continue;
+    }
+    int64_t dts = tri.start_dts;
+    size_t first_sample = 0;
+    while (first_sample < tri.samples.size() && dts < it->second) {
+      dts += tri.samples[first_sample].duration;
+      ++first_sample;
+    }
+    tri.first_sample = first_sample;
+  }
+
+  run_itr_ = runs_.begin();
+  ResetRun();
+  return true;
+}
+
 void TrackRunIterator::ResetRun() {
   if (!IsRunValid())
     return;
   sample_dts_ = run_itr_->start_dts;
   sample_offset_ = run_itr_->sample_start_offset;
   sample_itr_ = run_itr_->samples.begin();
+  // Skip samples ahead of a seek target set by AdvanceToTimestamp(). The
+  // run's encryption entries stay indexed by position within the whole run,
+  // so GetDecryptConfig() remains correct for the emitted samples.
+  for (size_t i = 0; i < run_itr_->first_sample; ++i) {
+    sample_dts_ += sample_itr_->duration;
+    sample_offset_ += sample_itr_->size;
+    ++sample_itr_;
+  }
 }
 
 void TrackRunIterator::AdvanceSample() {
@@ -51,6 +51,14 @@ class TrackRunIterator {
   /// Advance iterator to the next run. Require that the iterator point to a
   /// valid run.
   void AdvanceRun();
+  /// Discard everything before @a timestamp_seconds and position the
+  /// iterator at the first remaining run. Each track resumes at its last
+  /// sync sample at or before the timestamp, so decode - and decryption,
+  /// whose per-sample info is indexed within each run - can begin right
+  /// there. Tracks with no sync sample before the timestamp resume at the
+  /// chunk containing it.
+  /// @return true on success, false otherwise.
+  bool AdvanceToTimestamp(double timestamp_seconds);
   /// Advance iterator to the next sample. Require that the iterator point to a
   /// valid sample.
   void AdvanceSample();
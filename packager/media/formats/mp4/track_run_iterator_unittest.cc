@@ -355,6 +355,43 @@ TEST_F(TrackRunIteratorTest, BasicOperationTest) {
   EXPECT_FALSE(iter_->IsRunValid());
 }
 
+TEST_F(TrackRunIteratorTest, AdvanceToTimestampTest) {
+  iter_.reset(new TrackRunIterator(&moov_));
+  MovieFragment moof = CreateFragment();
+  ASSERT_TRUE(iter_->Init(moof));
+
+  // The video track's only sync sample is its first (dts 10, timescale 25,
+  // i.e. 0.4 seconds), which is after the 0.3 second target, so the video
+  // run resumes at the chunk start. The audio track (every sample a sync
+  // sample, timescale 48000) snaps to the last sample at or before 0.3
+  // seconds: dts 14336 in the second run, so the first run is dropped and
+  // the four earlier samples of the second run are skipped.
+  ASSERT_TRUE(iter_->AdvanceToTimestamp(0.3));
+  EXPECT_TRUE(iter_->IsRunValid());
+  EXPECT_EQ(iter_->track_id(), 2u);
+  EXPECT_EQ(iter_->dts(), 10);
+  iter_->AdvanceRun();
+  EXPECT_EQ(iter_->track_id(), 1u);
+  EXPECT_EQ(iter_->dts(), 1024 * 14);
+  iter_->AdvanceRun();
+  EXPECT_FALSE(iter_->IsRunValid());
+
+  // Seeking past the end of the media snaps back to the last sync sample of
+  // each track: the video run resumes at its first (only sync) sample and
+  // the audio track at its very last sample.
+  iter_.reset(new TrackRunIterator(&moov_));
+  ASSERT_TRUE(iter_->Init(moof));
+  ASSERT_TRUE(iter_->AdvanceToTimestamp(10.0));
+  EXPECT_TRUE(iter_->IsRunValid());
+  EXPECT_EQ(iter_->track_id(), 2u);
+  EXPECT_EQ(iter_->dts(), 10);
+  iter_->AdvanceRun();
+  EXPECT_EQ(iter_->track_id(), 1u);
+  EXPECT_EQ(iter_->dts(), 1024 * 19);
+  iter_->AdvanceRun();
+  EXPECT_FALSE(iter_->IsRunValid());
+}
+
 TEST_F(TrackRunIteratorTest, TrackExtendsDefaultsTest) {
   moov_.extends.tracks[0].default_sample_duration = 50;
   moov_.extends.tracks[0].default_sample_size = 3;
@@ -20,8 +20,8 @@ PackedAudioWriter::PackedAudioWriter(const MuxerOptions& muxer_options)
       transport_stream_timestamp_offset_(
           muxer_options.transport_stream_timestamp_offset_ms *
           kPackedAudioTimescale / 1000),
-      segmenter_(new PackedAudioSegmenter(transport_stream_timestamp_offset_)) {
-}
+      segmenter_(new PackedAudioSegmenter(transport_stream_timestamp_offset_)),
+      segment_number_(muxer_options.initial_segment_number) {}
 
 PackedAudioWriter::~PackedAudioWriter() = default;
 
@@ -69,6 +69,10 @@ Status PackedAudioWriter::AddMediaSample(size_t stream_id,
 Status PackedAudioWriter::FinalizeSegment(size_t stream_id,
                                           const SegmentInfo& segment_info) {
   DCHECK_EQ(stream_id, 0u);
+  // In low latency mode, chunks are flushed to the output file as they fill
+  // instead of accumulating the whole segment in memory.
+  if (segment_info.is_chunk)
+    return WriteChunk(segment_info);
   // PackedAudio does not support subsegment.
   if (segment_info.is_subsegment)
     return Status::OK;
@@ -80,8 +84,8 @@ Status PackedAudioWriter::FinalizeSegment(size_t stream_id,
   std::string segment_path =
       options().segment_template.empty()
           ? options().output_file_name
-          : GetSegmentName(options().segment_template, segment_timestamp,
-                           segment_number_++, options().bandwidth);
+          : segment_name_template().Apply(segment_timestamp, segment_number_++,
+                                          options().bandwidth);
 
   // Save |segment_size| as it will be cleared after writing.
   const size_t segment_size = segmenter_->segment_buffer()->Size();
@@ -97,6 +101,68 @@ Status PackedAudioWriter::FinalizeSegment(size_t stream_id,
   return Status::OK;
 }
 
+Status PackedAudioWriter::WriteChunk(const SegmentInfo& chunk_info) {
+  if (is_initial_chunk_in_segment_) {
+    // The first chunk of a segment starts at the segment start, so its
+    // timestamp can be used to name the segment before it is complete. The
+    // timestamp-tag header was written once into the buffer by the segmenter
+    // and goes out with this chunk.
+    segment_timestamp_ =
+        chunk_info.start_timestamp * segmenter_->TimescaleScale();
+    segment_path_ =
+        options().segment_template.empty()
+            ? options().output_file_name
+            : segment_name_template().Apply(segment_timestamp_,
+                                            segment_number_++,
+                                            options().bandwidth);
+    if (!output_file_) {
+      segment_file_.reset(File::Open(segment_path_.c_str(), "w"));
+      if (!segment_file_) {
+        return Status(error::FILE_FAILURE,
+                      "Cannot open file for write " + segment_path_);
+      }
+    }
+    is_initial_chunk_in_segment_ = false;
+  }
+
+  // WriteToFile() clears the buffer, so the next chunk starts accumulating
+  // from scratch.
+  segment_size_ += segmenter_->segment_buffer()->Size();
+  RETURN_IF_ERROR(segmenter_->segment_buffer()->WriteToFile(
+      output_file_ ? output_file_.get() : segment_file_.get()));
+
+  // A chunk that is not a subsegment marks the end of the segment.
+  if (chunk_info.is_subsegment)
+    return Status::OK;
+
+  RETURN_IF_ERROR(segmenter_->FinalizeSegment());
+
+  if (output_file_) {
+    // Single segment mode: remember the range the segment occupies.
+    Range range;
+    range.start = media_ranges_.subsegment_ranges.empty()
+                      ? 0
+                      : (media_ranges_.subsegment_ranges.back().end + 1);
+    range.end = range.start + segment_size_ - 1;
+    media_ranges_.subsegment_ranges.push_back(range);
+  } else {
+    RETURN_IF_ERROR(CloseFile(std::move(segment_file_)));
+  }
+  total_duration_ += chunk_info.duration;
+
+  // The HLS listener needs the final duration, so the segment is announced
+  // once it completes; its bytes have been available since the first chunk.
+  if (muxer_listener()) {
+    muxer_listener()->OnNewSegment(
+        segment_path_, segment_timestamp_ + transport_stream_timestamp_offset_,
+        chunk_info.duration * segmenter_->TimescaleScale(), segment_size_);
+  }
+
+  segment_size_ = 0;
+  is_initial_chunk_in_segment_ = true;
+  return Status::OK;
+}
+
 Status PackedAudioWriter::WriteSegment(const std::string& segment_path,
                                        BufferWriter* segment_buffer) {
   std::unique_ptr<File, FileCloser> file;
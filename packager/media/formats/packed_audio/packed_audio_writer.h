@@ -41,6 +41,14 @@ class PackedAudioWriter : public Muxer {
   Status WriteSegment(const std::string& segment_path,
                       BufferWriter* segment_buffer);
 
+  // Flushes the samples accumulated since the last chunk to the output file.
+  // Called for chunk boundaries in low latency mode, where the segment file
+  // is opened on the first chunk and appended to as chunks fill, so segment
+  // delivery latency follows the chunk duration instead of the segment
+  // duration. |chunk_info| with is_subsegment false marks the final chunk
+  // and completes the segment.
+  Status WriteChunk(const SegmentInfo& chunk_info);
+
   Status CloseFile(std::unique_ptr<File, FileCloser> file);
 
   const int32_t transport_stream_timestamp_offset_ = 0;
@@ -54,6 +62,15 @@ class PackedAudioWriter : public Muxer {
 
   // Used in multi-segment mode for segment template.
   uint64_t segment_number_ = 0;
+
+  // Chunked emission state, used in low latency mode. The segment file is
+  // opened when the first chunk of a segment is flushed; its name and
+  // timestamp are remembered for the listener notification on completion.
+  bool is_initial_chunk_in_segment_ = true;
+  std::unique_ptr<File, FileCloser> segment_file_;
+  std::string segment_path_;
+  int64_t segment_timestamp_ = 0;
+  size_t segment_size_ = 0;
 };
 
 }  // namespace media
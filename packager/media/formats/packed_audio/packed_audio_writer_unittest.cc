@@ -256,6 +256,81 @@ TEST_P(PackedAudioWriterTest, TwoSegments) {
   }
 }
 
+TEST_P(PackedAudioWriterTest, ChunkedSegment) {
+  ASSERT_OK(Input(kInput)->Dispatch(StreamData::FromStreamInfo(
+      kStreamIndex, GetAudioStreamInfo(kTimescale))));
+
+  const int64_t kTimestamp = 12345;
+  const int64_t kChunkDuration = 50;
+  const int64_t kSegmentDuration = 100;
+
+  auto chunk_info = std::make_shared<SegmentInfo>();
+  chunk_info->start_timestamp = kTimestamp;
+  chunk_info->duration = kChunkDuration;
+  chunk_info->is_subsegment = true;
+  chunk_info->is_chunk = true;
+
+  // The final chunk covers the whole segment and is not a subsegment.
+  auto final_chunk_info = std::make_shared<SegmentInfo>();
+  final_chunk_info->start_timestamp = kTimestamp;
+  final_chunk_info->duration = kSegmentDuration;
+  final_chunk_info->is_chunk = true;
+  final_chunk_info->is_final_chunk_in_seg = true;
+
+  const double kMockTimescaleScale = 10;
+  const char kMockChunk1Data[] = "hello ";
+  const char kMockChunk2Data[] = "chunk";
+  const size_t kSegmentDataSize =
+      sizeof(kMockChunk1Data) + sizeof(kMockChunk2Data) - 2;
+
+  EXPECT_CALL(*mock_segmenter_ptr_, TimescaleScale())
+      .WillRepeatedly(Return(kMockTimescaleScale));
+
+  // The segment is announced once it completes, with the full duration and
+  // the total size of all its chunks.
+  EXPECT_CALL(
+      *mock_muxer_listener_ptr_,
+      OnNewSegment(is_single_segment_mode_ ? kOutputFile : kSegment1Name,
+                   kTimestamp * kMockTimescaleScale,
+                   kSegmentDuration * kMockTimescaleScale, kSegmentDataSize));
+  EXPECT_CALL(*mock_segmenter_ptr_, FinalizeSegment())
+      .WillOnce(Return(Status::OK));
+
+  // Each chunk is flushed to the output file as soon as it is finalized, so
+  // the buffer must be empty between chunks.
+  mock_segmenter_ptr_->segment_buffer()->AppendString(kMockChunk1Data);
+  ASSERT_OK(Input(kInput)->Dispatch(
+      StreamData::FromSegmentInfo(kStreamIndex, chunk_info)));
+  ASSERT_EQ(0u, mock_segmenter_ptr_->segment_buffer()->Size());
+
+  mock_segmenter_ptr_->segment_buffer()->AppendString(kMockChunk2Data);
+  ASSERT_OK(Input(kInput)->Dispatch(
+      StreamData::FromSegmentInfo(kStreamIndex, final_chunk_info)));
+
+  const bool kHasInitRange = true;
+  const bool kHasIndexRange = true;
+  const bool kHasSegmentRange = true;
+  if (is_single_segment_mode_) {
+    EXPECT_CALL(
+        *mock_muxer_listener_ptr_,
+        OnMediaEndMock(
+            !kHasInitRange, 0, 0, !kHasIndexRange, 0, 0, kHasSegmentRange,
+            ElementsAre(AllOf(Field(&Range::start, Eq(0u)),
+                              Field(&Range::end, Eq(kSegmentDataSize - 1)))),
+            kSegmentDuration * kMockTimescaleScale));
+  } else {
+    EXPECT_CALL(*mock_muxer_listener_ptr_,
+                OnMediaEndMock(!kHasInitRange, 0, 0, !kHasIndexRange, 0, 0,
+                               !kHasSegmentRange, ElementsAre(),
+                               kSegmentDuration * kMockTimescaleScale));
+  }
+  ASSERT_OK(Input(kInput)->FlushDownstream(kStreamIndex));
+
+  ASSERT_FILE_STREQ(
+      is_single_segment_mode_ ? kOutputFile : kSegment1Name,
+      std::string(kMockChunk1Data) + std::string(kMockChunk2Data));
+}
+
 INSTANTIATE_TEST_CASE_P(SingleSegmentOrMultiSegment,
                         PackedAudioWriterTest,
                         Bool());
@@ -54,6 +54,7 @@ void TtmlGenerator::Initialize(const std::map<std::string, TextRegion>& regions,
   regions_ = regions;
   language_ = language;
   time_scale_ = time_scale;
+  head_.reset();
 }
 
 void TtmlGenerator::AddSample(const TextSample& sample) {
@@ -70,26 +71,33 @@ bool TtmlGenerator::Dump(std::string* result) const {
   RCHECK(root.SetStringAttribute("xmlns:tts",
                                  "http://www.w3.org/ns/ttml#styling"));
 
-  bool did_log = false;
-  xml::XmlNode head("head");
   RCHECK(root.SetStringAttribute("xml:lang", language_));
-  for (const auto& pair : regions_) {
-    if (!did_log && (pair.second.region_anchor_x.value != 0 &&
-                     pair.second.region_anchor_y.value != 0)) {
-      LOG(WARNING) << "TTML doesn't support non-0 region anchor";
-      did_log = true;
+  // The regions (and with them the whole <head>) are constant for the
+  // stream, so the subtree is built once and cloned into each segment's
+  // document; per segment only the <p> cues and any image metadata are
+  // constructed below.
+  if (!head_) {
+    bool did_log = false;
+    auto head = std::make_unique<xml::XmlNode>("head");
+    for (const auto& pair : regions_) {
+      if (!did_log && (pair.second.region_anchor_x.value != 0 &&
+                       pair.second.region_anchor_y.value != 0)) {
+        LOG(WARNING) << "TTML doesn't support non-0 region anchor";
+        did_log = true;
+      }
+
+      xml::XmlNode region("region");
+      const auto origin =
+          ToTtmlSize(pair.second.window_anchor_x, pair.second.window_anchor_y);
+      const auto extent = ToTtmlSize(pair.second.width, pair.second.height);
+      RCHECK(region.SetStringAttribute("xml:id", pair.first));
+      RCHECK(region.SetStringAttribute("tts:origin", origin));
+      RCHECK(region.SetStringAttribute("tts:extent", extent));
+      RCHECK(head->AddChild(std::move(region)));
     }
-
-    xml::XmlNode region("region");
-    const auto origin =
-        ToTtmlSize(pair.second.window_anchor_x, pair.second.window_anchor_y);
-    const auto extent = ToTtmlSize(pair.second.width, pair.second.height);
-    RCHECK(region.SetStringAttribute("xml:id", pair.first));
-    RCHECK(region.SetStringAttribute("tts:origin", origin));
-    RCHECK(region.SetStringAttribute("tts:extent", extent));
-    RCHECK(head.AddChild(std::move(region)));
+    head_ = std::move(head);
   }
-  RCHECK(root.AddChild(std::move(head)));
+  RCHECK(root.AddChild(head_->Clone()));
 
   size_t image_count = 0;
   xml::XmlNode metadata("metadata");
@@ -9,6 +9,7 @@
 
 #include <list>
 #include <map>
+#include <memory>
 #include <string>
 
 #include <packager/media/base/text_sample.h>
@@ -50,6 +51,9 @@ class TtmlGenerator {
   int32_t time_scale_;
   // This is modified in "const" methods to create unique IDs.
   mutable uint32_t region_id_ = 0;
+  // The <head> subtree depends only on the stream's regions, so it is built
+  // on the first Dump() and cloned into every segment's document afterwards.
+  mutable std::unique_ptr<xml::XmlNode> head_;
 };
 
 }  // namespace ttml
@@ -25,11 +25,14 @@ const uint8_t kKeyId[] = {
 const uint8_t kIv[] = {
     0x01, 0x23, 0x45, 0x67, 0x89, 0x01, 0x23, 0x45,
 };
+// The output is seekable, so the Cues are written into the region reserved
+// right after the segment header; the rest of the reservation is filled with
+// a Void element and the first Cluster starts after it.
 // clang-format off
-const uint8_t kBasicSupportData[] = {
+const uint8_t kBasicSupportHeaderData[] = {
   // ID: EBML Header omitted.
-  // ID: Segment, Payload Size: 439
-  0x18, 0x53, 0x80, 0x67, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xb7,
+  // ID: Segment, Payload Size: 4501
+  0x18, 0x53, 0x80, 0x67, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x11, 0x95,
     // ID: SeekHead, Payload Size: 58
     0x11, 0x4d, 0x9b, 0x74, 0xba,
       // ID: Seek, Payload Size: 11
@@ -54,8 +57,8 @@ const uint8_t kBasicSupportData[] = {
       0x4d, 0xbb, 0x8c,
         // SeekID: binary(4) (Cluster)
         0x53, 0xab, 0x84, 0x1f, 0x43, 0xb6, 0x75,
-        // SeekPosition: 320
-        0x53, 0xac, 0x82, 0x01, 0x40,
+        // SeekPosition: 4382
+        0x53, 0xac, 0x82, 0x11, 0x1e,
     // ID: Void, Payload Size: 24
     0xec, 0x98, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
@@ -132,8 +135,8 @@ const uint8_t kBasicSupportData[] = {
         0xb7, 0x87,
           // CueTrack: 1
           0xf7, 0x81, 0x01,
-          // CueClusterPosition: 320
-          0xf1, 0x82, 0x01, 0x40,
+          // CueClusterPosition: 4382
+          0xf1, 0x82, 0x11, 0x1e,
       // ID: CuePoint, Payload Size: 13
       0xbb, 0x8d,
         // CueTime: 3000
@@ -142,8 +145,11 @@ const uint8_t kBasicSupportData[] = {
         0xb7, 0x87,
           // CueTrack: 1
           0xf7, 0x81, 0x01,
-          // CueClusterPosition: 377
-          0xf1, 0x82, 0x01, 0x79,
+          // CueClusterPosition: 4439
+          0xf1, 0x82, 0x11, 0x57,
+};
+// The Clusters follow the Void padding of the reserved Cues region.
+const uint8_t kBasicSupportClusterData[] = {
     // ID: Cluster, Payload Size: 45
     0x1f, 0x43, 0xb6, 0x75, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2d,
       // Timecode: 0
@@ -197,6 +203,10 @@ const uint8_t kBasicSupportData[] = {
 };
 // clang-format on
 
+// Bytes of Void padding between the Cues and the first Cluster: the 4096-byte
+// reserved Cues region minus the 34-byte Cues element.
+const size_t kReservedCuesPadding = 4096 - 34;
+
 }  // namespace
 
 class EncryptedSegmenterTest : public SegmentTestBase {
@@ -247,7 +257,19 @@ TEST_F(EncryptedSegmenterTest, BasicSupport) {
       segmenter_->FinalizeSegment(3 * kDuration, 2 * kDuration, !kSubsegment));
   ASSERT_OK(segmenter_->Finalize());
 
-  ASSERT_FILE_ENDS_WITH(OutputFileName().c_str(), kBasicSupportData);
+  std::string contents;
+  ASSERT_TRUE(File::ReadFileToString(OutputFileName().c_str(), &contents));
+  const std::string header(
+      reinterpret_cast<const char*>(kBasicSupportHeaderData),
+      sizeof(kBasicSupportHeaderData));
+  const size_t header_pos = contents.find(header);
+  ASSERT_NE(std::string::npos, header_pos);
+  // The remainder of the reserved Cues region is a Void element.
+  EXPECT_EQ('\xec', contents[header_pos + header.size()]);
+  EXPECT_EQ(header_pos + header.size() + kReservedCuesPadding +
+                sizeof(kBasicSupportClusterData),
+            contents.size());
+  ASSERT_FILE_ENDS_WITH(OutputFileName().c_str(), kBasicSupportClusterData);
 }
 
 }  // namespace media
@@ -16,6 +16,7 @@
 namespace shaka {
 namespace media {
 
+class BufferWriter;
 class MediaSample;
 
 namespace webm {
@@ -29,6 +30,11 @@ Status UpdateTrackForEncryption(const std::vector<uint8_t>& key_id,
 /// encrypted.
 void UpdateFrameForEncryption(MediaSample* sample);
 
+/// Same as above, but builds the signal byte header in @a header_buffer,
+/// which is cleared first. Callers processing many frames can pass the same
+/// scratch buffer every time to avoid a per-frame allocation.
+void UpdateFrameForEncryption(MediaSample* sample, BufferWriter* header_buffer);
+
 }  // namespace webm
 }  // namespace media
 }  // namespace shaka
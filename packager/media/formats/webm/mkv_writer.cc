@@ -8,9 +8,18 @@
 
 #include <absl/log/check.h>
 
+#include <packager/macros/status.h>
+
 namespace shaka {
 namespace media {
 
+namespace {
+// mkvmuxer writes every element identifier and size separately; coalescing
+// turns a File::Write call per element into one per this many bytes, which
+// is what makes WebM output to remote files viable.
+const size_t kBufferCapacity = 64 * 1024;
+}  // namespace
+
 MkvWriter::MkvWriter() : position_(0) {}
 
 MkvWriter::~MkvWriter() {}
@@ -25,10 +34,13 @@ Status MkvWriter::Open(const std::string& name) {
   // on File.
   seekable_ = file_->Seek(0);
   position_ = 0;
+  buffer_.clear();
+  buffer_.reserve(kBufferCapacity);
   return Status::OK;
 }
 
 Status MkvWriter::Close() {
+  RETURN_IF_ERROR(FlushBuffer());
   const std::string file_name = file_->file_name();
   if (!file_.release()->Close()) {
     return Status(
@@ -42,28 +54,63 @@ Status MkvWriter::Close() {
 mkvmuxer::int32 MkvWriter::Write(const void* buf, mkvmuxer::uint32 len) {
   DCHECK(file_);
 
-  const char* data = reinterpret_cast<const char*>(buf);
-  int64_t total_bytes_written = 0;
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(buf);
+  if (buffer_.size() + len > kBufferCapacity) {
+    if (!FlushBuffer().ok())
+      return -1;
+    // A write that would fill the buffer on its own gains nothing from being
+    // buffered; hand it to the file directly.
+    if (len >= kBufferCapacity) {
+      const mkvmuxer::int32 result = WriteToFile(data, len);
+      if (result == 0)
+        position_ += len;
+      return result;
+    }
+  }
+
+  buffer_.insert(buffer_.end(), data, data + len);
+  position_ += len;
+  return 0;
+}
+
+mkvmuxer::int32 MkvWriter::WriteToFile(const uint8_t* data, size_t len) {
+  size_t total_bytes_written = 0;
   while (total_bytes_written < len) {
-    const int64_t written =
-        file_->Write(data + total_bytes_written, len - total_bytes_written);
+    const int64_t written = file_->Write(
+        reinterpret_cast<const char*>(data) + total_bytes_written,
+        len - total_bytes_written);
     if (written < 0)
-      return written;
+      return -1;
 
     total_bytes_written += written;
   }
 
   DCHECK_EQ(total_bytes_written, len);
-  position_ += len;
   return 0;
 }
 
+Status MkvWriter::FlushBuffer() {
+  if (buffer_.empty())
+    return Status::OK;
+
+  // |position_| was already advanced when the bytes were buffered; flushing
+  // only moves them to the file, whose write offset is where they belong.
+  if (WriteToFile(buffer_.data(), buffer_.size()) != 0) {
+    return Status(error::FILE_FAILURE,
+                  "Error writing buffered bytes to " + file_->file_name());
+  }
+  buffer_.clear();
+  return Status::OK;
+}
+
 int64_t MkvWriter::WriteFromFile(File* source) {
   return WriteFromFile(source, kWholeFile);
 }
 
 int64_t MkvWriter::WriteFromFile(File* source, int64_t max_copy) {
   DCHECK(file_);
+  if (!FlushBuffer().ok())
+    return -1;
 
   const int64_t size = File::Copy(source, file_.get(), max_copy);
   if (size < 0)
@@ -80,6 +127,10 @@ mkvmuxer::int64 MkvWriter::Position() const {
 mkvmuxer::int32 MkvWriter::Position(mkvmuxer::int64 position) {
   DCHECK(file_);
 
+  // The buffered bytes belong at the current write offset; they have to
+  // reach the file before it moves.
+  if (!FlushBuffer().ok())
+    return -1;
   if (file_->Seek(position)) {
     position_ = position;
     return 0;
@@ -9,6 +9,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <mkvmuxer/mkvmuxer.h>
 
@@ -19,7 +20,11 @@
 namespace shaka {
 namespace media {
 
-/// An implementation of IMkvWriter using our File type.
+/// An implementation of IMkvWriter using our File type. mkvmuxer emits many
+/// tiny writes (EBML IDs and sizes) per frame, so writes are coalesced in an
+/// internal buffer and handed to the File in large blocks; the buffer is
+/// flushed automatically before any seek or file-to-file copy, on Close(),
+/// and explicitly through FlushBuffer() at segment boundaries.
 class MkvWriter : public mkvmuxer::IMkvWriter {
  public:
   MkvWriter();
@@ -52,6 +57,13 @@ class MkvWriter : public mkvmuxer::IMkvWriter {
   void ElementStartNotify(mkvmuxer::uint64 element_id,
                           mkvmuxer::int64 position) override;
 
+  /// Writes any bytes held in the internal coalescing buffer to the file.
+  /// Writes, seeks and Close() flush as needed on their own; call this at
+  /// cluster boundaries to make the cluster's bytes visible to readers of
+  /// the (possibly remote) output file.
+  /// @return OK on success.
+  Status FlushBuffer();
+
   /// Writes the contents of the given file to this file.
   /// @return The number of bytes written; or < 0 on error.
   int64_t WriteFromFile(File* source);
@@ -60,10 +72,18 @@ class MkvWriter : public mkvmuxer::IMkvWriter {
   /// @return The number of bytes written; or < 0 on error.
   int64_t WriteFromFile(File* source, int64_t max_copy);
 
+  /// Note that buffered bytes are not visible through the File; call
+  /// FlushBuffer() first when accessing it directly.
   File* file() { return file_.get(); }
 
  private:
+  // Writes |len| bytes at |data| straight to |file_|, bypassing the buffer.
+  mkvmuxer::int32 WriteToFile(const uint8_t* data, size_t len);
+
   std::unique_ptr<File, FileCloser> file_;
+  // Coalesces the many small element writes into few large File writes. The
+  // bytes in the buffer always belong at the file's current write offset.
+  std::vector<uint8_t> buffer_;
   // Keep track of the position and whether we can seek.
   mkvmuxer::int64 position_;
   bool seekable_;
@@ -21,7 +21,8 @@ namespace media {
 namespace webm {
 
 MultiSegmentSegmenter::MultiSegmentSegmenter(const MuxerOptions& options)
-    : Segmenter(options), num_segment_(0) {}
+    : Segmenter(options),
+      num_segment_(static_cast<uint32_t>(options.initial_segment_number)) {}
 
 MultiSegmentSegmenter::~MultiSegmentSegmenter() {}
 
@@ -35,9 +36,8 @@ Status MultiSegmentSegmenter::FinalizeSegment(int64_t start_timestamp,
     return Status(error::FILE_FAILURE, "Error finalizing segment.");
 
   if (!is_subsegment) {
-    std::string segment_name =
-        GetSegmentName(options().segment_template, start_timestamp,
-                       num_segment_, options().bandwidth);
+    std::string segment_name = segment_name_template().Apply(
+        start_timestamp, num_segment_, options().bandwidth);
 
     // Close the file, which also does flushing, to make sure the file is
     // written before manifest is updated.
@@ -57,6 +57,10 @@ Status MultiSegmentSegmenter::FinalizeSegment(int64_t start_timestamp,
                                      duration_timestamp, size);
     }
     VLOG(1) << "WEBM file '" << segment_name << "' finalized.";
+  } else {
+    // Cluster boundary within a segment: push the finalized cluster out of
+    // the writer's coalescing buffer so the file holds complete clusters.
+    RETURN_IF_ERROR(writer_->FlushBuffer());
   }
   return Status::OK;
 }
@@ -92,9 +96,8 @@ Status MultiSegmentSegmenter::NewSegment(int64_t start_timestamp,
                                          bool is_subsegment) {
   if (!is_subsegment) {
     temp_file_name_ =
-        "memory://" + GetSegmentName(options().segment_template,
-                                     start_timestamp, num_segment_,
-                                     options().bandwidth);
+        "memory://" + segment_name_template().Apply(
+                          start_timestamp, num_segment_, options().bandwidth);
 
     writer_.reset(new MkvWriter);
     Status status = writer_->Open(temp_file_name_);
@@ -69,7 +69,15 @@ int64_t WebMTimecodeToNs(int64_t timecode, int64_t timecode_scale) {
 
 }  // namespace
 
-Segmenter::Segmenter(const MuxerOptions& options) : options_(options) {}
+Segmenter::Segmenter(const MuxerOptions& options) : options_(options) {
+  // The segment template has been validated before the segmenter is created;
+  // compile it once so per-segment name generation does not re-parse it.
+  if (!options_.segment_template.empty()) {
+    const Status status =
+        segment_name_template_.Compile(options_.segment_template);
+    DCHECK_EQ(Status::OK, status);
+  }
+}
 
 Segmenter::~Segmenter() {}
 
@@ -188,7 +196,7 @@ Status Segmenter::AddSample(const MediaSample& source_sample) {
     return status;
 
   if (is_encrypted_)
-    UpdateFrameForEncryption(sample.get());
+    UpdateFrameForEncryption(sample.get(), &encryption_header_scratch_);
 
   new_subsegment_ = false;
   new_segment_ = false;
@@ -12,6 +12,8 @@
 #include <mkvmuxer/mkvmuxer.h>
 
 #include <packager/macros/classes.h>
+#include <packager/media/base/buffer_writer.h>
+#include <packager/media/base/muxer_util.h>
 #include <packager/media/base/range.h>
 #include <packager/media/formats/webm/mkv_writer.h>
 #include <packager/media/formats/webm/seek_head.h>
@@ -93,6 +95,12 @@ class Segmenter {
   void set_progress_target(uint64_t target) { progress_target_ = target; }
 
   const MuxerOptions& options() const { return options_; }
+  /// @return The precompiled form of |options().segment_template|, for
+  ///         per-segment name generation. Only valid if the template is
+  ///         non-empty.
+  const SegmentNameTemplate& segment_name_template() const {
+    return segment_name_template_;
+  }
   mkvmuxer::Cluster* cluster() { return cluster_.get(); }
   mkvmuxer::Cues* cues() { return &cues_; }
   MuxerListener* muxer_listener() { return muxer_listener_; }
@@ -128,6 +136,7 @@ class Segmenter {
   int64_t reference_frame_timestamp_ = 0;
 
   const MuxerOptions& options_;
+  SegmentNameTemplate segment_name_template_;
 
   std::unique_ptr<mkvmuxer::Cluster> cluster_;
   mkvmuxer::Cues cues_;
@@ -160,6 +169,10 @@ class Segmenter {
   int64_t time_scale_ = 0;
   int64_t duration_ = 0;
 
+  // Scratch for the encrypted-frame signal byte header, reused across samples
+  // to avoid a per-frame allocation.
+  BufferWriter encryption_header_scratch_;
+
   DISALLOW_COPY_AND_ASSIGN(Segmenter);
 };
 
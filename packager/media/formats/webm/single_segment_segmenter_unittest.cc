@@ -20,13 +20,16 @@ const int64_t kSecondsToNs = 1000000000L;
 const int64_t kDuration = 1000000;
 const bool kSubsegment = true;
 
+// The output is seekable, so the Cues are written into the region reserved
+// right after the segment header; the rest of the reservation is filled with
+// a Void element and the first Cluster starts after it.
 // clang-format off
-const uint8_t kBasicSupportData[] = {
+const uint8_t kBasicSupportHeaderData[] = {
   // ID: EBML Header omitted.
-  // ID: Segment, Payload Size: 350
-  0x18, 0x53, 0x80, 0x67, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x5e,
+  // ID: Segment, Payload Size: 4428
+  0x18, 0x53, 0x80, 0x67, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x11, 0x4c,
     // ID: SeekHead, Payload Size: 57
-    0x11, 0x4d, 0x9b, 0x74, 0xb8,
+    0x11, 0x4d, 0x9b, 0x74, 0xb9,
       // ID: Seek, Payload Size: 11
       0x4d, 0xbb, 0x8b,
         // SeekID: binary(4) (Info)
@@ -39,22 +42,22 @@ const uint8_t kBasicSupportData[] = {
         0x53, 0xab, 0x84, 0x16, 0x54, 0xae, 0x6b,
         // SeekPosition: 189
         0x53, 0xac, 0x81, 0xbd,
-      // ID: Seek, Payload Size: 12
+      // ID: Seek, Payload Size: 11
       0x4d, 0xbb, 0x8b,
         // SeekID: binary(4) (Cues)
         0x53, 0xab, 0x84, 0x1c, 0x53, 0xbb, 0x6b,
         // SeekPosition: 235
         0x53, 0xac, 0x81, 0xeb,
-      // ID: Seek, Payload Size: 11
-      0x4d, 0xbb, 0x8b,
+      // ID: Seek, Payload Size: 12
+      0x4d, 0xbb, 0x8c,
         // SeekID: binary(4) (Cluster)
         0x53, 0xab, 0x84, 0x1f, 0x43, 0xb6, 0x75,
-        // SeekPosition: 253
-        0x53, 0xac, 0x81, 0xfd,
-    // ID: Void, Payload Size: 26
-    0xec, 0x9a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        // SeekPosition: 4331
+        0x53, 0xac, 0x82, 0x10, 0xeb,
+    // ID: Void, Payload Size: 25
+    0xec, 0x99, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00,
     // ID: Info, Payload Size: 95
     0x15, 0x49, 0xa9, 0x66, 0xdf,
       // TimecodeScale: 1000000
@@ -95,18 +98,21 @@ const uint8_t kBasicSupportData[] = {
           0x54, 0xb0, 0x81, 0x64,
           // DisplayHeight: 100
           0x54, 0xba, 0x81, 0x64,
-    // ID: Cues, Payload Size: 13
-    0x1c, 0x53, 0xbb, 0x6b, 0x8d,
-      // ID: CuePoint, Payload Size: 11
-      0xbb, 0x8b,
+    // ID: Cues, Payload Size: 14
+    0x1c, 0x53, 0xbb, 0x6b, 0x8e,
+      // ID: CuePoint, Payload Size: 12
+      0xbb, 0x8c,
         // CueTime: 0
         0xb3, 0x81, 0x00,
-        // ID: CueTrackPositions, Payload Size: 6
-        0xb7, 0x86,
+        // ID: CueTrackPositions, Payload Size: 7
+        0xb7, 0x87,
           // CueTrack: 1
           0xf7, 0x81, 0x01,
-          // CueClusterPosition: 253
-          0xf1, 0x81, 0xfd,
+          // CueClusterPosition: 4331
+          0xf1, 0x82, 0x10, 0xeb,
+};
+// The Cluster follows the Void padding of the reserved Cues region.
+const uint8_t kBasicSupportClusterData[] = {
     // ID: Cluster, Payload Size: 85
     0x1f, 0x43, 0xb6, 0x75, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x55,
       // Timecode: 0
@@ -138,6 +144,10 @@ const uint8_t kBasicSupportData[] = {
 };
 // clang-format on
 
+// Bytes of Void padding between the Cues and the first Cluster: the 4096-byte
+// reserved Cues region minus the 19-byte Cues element.
+const size_t kReservedCuesPadding = 4096 - 19;
+
 }  // namespace
 
 class SingleSegmentSegmenterTest : public SegmentTestBase {
@@ -170,7 +180,19 @@ TEST_F(SingleSegmentSegmenterTest, BasicSupport) {
   ASSERT_OK(segmenter_->FinalizeSegment(0, 5 * kDuration, !kSubsegment));
   ASSERT_OK(segmenter_->Finalize());
 
-  ASSERT_FILE_ENDS_WITH(OutputFileName().c_str(), kBasicSupportData);
+  std::string contents;
+  ASSERT_TRUE(File::ReadFileToString(OutputFileName().c_str(), &contents));
+  const std::string header(
+      reinterpret_cast<const char*>(kBasicSupportHeaderData),
+      sizeof(kBasicSupportHeaderData));
+  const size_t header_pos = contents.find(header);
+  ASSERT_NE(std::string::npos, header_pos);
+  // The remainder of the reserved Cues region is a Void element.
+  EXPECT_EQ('\xec', contents[header_pos + header.size()]);
+  EXPECT_EQ(header_pos + header.size() + kReservedCuesPadding +
+                sizeof(kBasicSupportClusterData),
+            contents.size());
+  ASSERT_FILE_ENDS_WITH(OutputFileName().c_str(), kBasicSupportClusterData);
 }
 
 TEST_F(SingleSegmentSegmenterTest, SplitsClustersOnSegment) {
@@ -13,6 +13,7 @@
 #include <mkvmuxer/mkvmuxerutil.h>
 
 #include <packager/file/file_util.h>
+#include <packager/macros/status.h>
 #include <packager/media/base/media_sample.h>
 #include <packager/media/base/muxer_options.h>
 #include <packager/media/base/stream_info.h>
@@ -70,6 +71,36 @@ TwoPassSingleSegmentSegmenter::TwoPassSingleSegmentSegmenter(
 TwoPassSingleSegmentSegmenter::~TwoPassSingleSegmentSegmenter() {}
 
 Status TwoPassSingleSegmentSegmenter::DoInitialize() {
+  // If the output is seekable the copying pass is unnecessary: reserve a
+  // bounded Cues region right after the segment header, mux the clusters
+  // directly into the output and backpatch the reservation at finalize.
+  // Cluster sizes are final as written, so nothing needs rewriting.
+  std::unique_ptr<MkvWriter> real_writer(new MkvWriter);
+  Status status = real_writer->Open(options().output_file_name);
+  if (!status.ok())
+    return status;
+  if (real_writer->Seekable()) {
+    single_pass_ = true;
+    set_writer(std::move(real_writer));
+
+    RETURN_IF_ERROR(WriteSegmentHeader(0, writer()));
+    set_init_end(writer()->Position() - 1);
+
+    cues_reserved_pos_ = writer()->Position();
+    reserved_cues_size_ = ComputeCuesReservation();
+    if (mkvmuxer::WriteVoidElement(writer(), reserved_cues_size_) !=
+        reserved_cues_size_) {
+      return Status(error::FILE_FAILURE, "Error reserving Cues space.");
+    }
+    seek_head()->set_cues_pos(cues_reserved_pos_ - segment_payload_pos());
+    seek_head()->set_cluster_pos(writer()->Position() -
+                                 segment_payload_pos());
+    return Status::OK;
+  }
+  // Non-seekable output, e.g. a pipe or callback file: mux to a temp file
+  // and rewrite the clusters on the second pass.
+  RETURN_IF_ERROR(real_writer->Close());
+
   // Assume the amount of time to copy the temp file as the same amount
   // of time as to make it.
   set_progress_target(duration() * 2);
@@ -77,7 +108,7 @@ Status TwoPassSingleSegmentSegmenter::DoInitialize() {
   if (!TempFilePath(options().temp_dir, &temp_file_name_))
     return Status(error::FILE_FAILURE, "Unable to create temporary file.");
   std::unique_ptr<MkvWriter> temp(new MkvWriter);
-  Status status = temp->Open(temp_file_name_);
+  status = temp->Open(temp_file_name_);
   if (!status.ok())
     return status;
   set_writer(std::move(temp));
@@ -86,6 +117,9 @@ Status TwoPassSingleSegmentSegmenter::DoInitialize() {
 }
 
 Status TwoPassSingleSegmentSegmenter::DoFinalize() {
+  if (single_pass_)
+    return FinalizeReservedHeader();
+
   const uint64_t header_size = init_end() + 1;
   const uint64_t cues_pos = header_size - segment_payload_pos();
   const uint64_t cues_size = UpdateCues(cues());
@@ -138,6 +172,71 @@ Status TwoPassSingleSegmentSegmenter::DoFinalize() {
   return real_writer->Close();
 }
 
+uint64_t TwoPassSingleSegmentSegmenter::ComputeCuesReservation() {
+  // One cue point is created per (sub)segment. The segment boundaries come
+  // from the upstream chunker, so the exact count is not known here; assume
+  // a pessimistic one cluster per second at the worst-case encoded cue point
+  // size, and bound the reservation so a bogus duration cannot balloon the
+  // header. Cues that outgrow the reservation are appended at the end of the
+  // file instead (see FinalizeReservedHeader()).
+  const uint64_t kWorstCaseBytesPerCuePoint = 48;
+  const uint64_t kMinReservedCuesBytes = 4 * 1024;
+  const uint64_t kMaxReservedCuesBytes = 1024 * 1024;
+  // WebM timecodes use the default 1ms timecode scale.
+  const uint64_t duration_ms = static_cast<uint64_t>(
+      std::max<int64_t>(FromBmffTimestamp(duration()), 0));
+  const uint64_t estimated_cues = duration_ms / 1000 + 1;
+  return std::min(
+      kMaxReservedCuesBytes,
+      std::max(kMinReservedCuesBytes,
+               estimated_cues * kWorstCaseBytesPerCuePoint));
+}
+
+Status TwoPassSingleSegmentSegmenter::FinalizeReservedHeader() {
+  uint64_t file_size = writer()->Position();
+  const uint64_t cues_size = cues()->Size();
+
+  // A Void element needs at least 2 bytes, so the Cues only fit if they
+  // either match the reservation exactly or leave room for the padding.
+  const bool cues_fit = cues_size == reserved_cues_size_ ||
+                        cues_size + 2 <= reserved_cues_size_;
+  if (cues_fit) {
+    writer()->Position(cues_reserved_pos_);
+    set_index_start(cues_reserved_pos_);
+    if (!cues()->Write(writer()))
+      return Status(error::FILE_FAILURE, "Error writing Cues data.");
+    set_index_end(writer()->Position() - 1);
+    const uint64_t remaining =
+        cues_reserved_pos_ + reserved_cues_size_ - writer()->Position();
+    if (remaining > 0 &&
+        mkvmuxer::WriteVoidElement(writer(), remaining) != remaining) {
+      return Status(error::FILE_FAILURE, "Error padding reserved Cues.");
+    }
+  } else {
+    // The reservation was too small; append the Cues at the end of the file
+    // and point the SeekHead there. The reserved region stays Void. The
+    // output is still valid, just without the cues-before-clusters layout.
+    LOG(WARNING) << "Reserved Cues region (" << reserved_cues_size_
+                 << " bytes) is too small for " << cues_size
+                 << " bytes of cues; appending the Cues at the end of "
+                 << options().output_file_name;
+    set_index_start(file_size);
+    seek_head()->set_cues_pos(file_size - segment_payload_pos());
+    if (!cues()->Write(writer()))
+      return Status(error::FILE_FAILURE, "Error writing Cues data.");
+    set_index_end(writer()->Position() - 1);
+    file_size = writer()->Position();
+  }
+
+  // Rewrite the header with the final duration and sizes. The header layout
+  // is identical to the one written in DoInitialize(), so the reserved
+  // offsets and the cluster positions recorded in the cues still hold.
+  writer()->Position(0);
+  Status status = WriteSegmentHeader(file_size, writer());
+  status.Update(writer()->Close());
+  return status;
+}
+
 bool TwoPassSingleSegmentSegmenter::CopyFileWithClusterRewrite(
     File* source,
     MkvWriter* dest,
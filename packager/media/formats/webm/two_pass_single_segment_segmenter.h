@@ -22,8 +22,12 @@ struct MuxerOptions;
 
 namespace webm {
 
-/// An implementation of a Segmenter for a single-segment that performs two
-/// passes.  This does not use seeking and is used for non-seekable files.
+/// An implementation of a Segmenter for a single-segment that places the Cues
+/// in front of the Clusters.  For seekable outputs this is done in a single
+/// pass: a bounded Cues region is reserved right after the segment header,
+/// clusters are written directly to the output and the reservation is
+/// backpatched at finalize.  For non-seekable outputs the clusters are muxed
+/// to a temp file first and copied over in a second pass.
 class TwoPassSingleSegmentSegmenter : public SingleSegmentSegmenter {
  public:
   explicit TwoPassSingleSegmentSegmenter(const MuxerOptions& options);
@@ -42,7 +46,19 @@ class TwoPassSingleSegmentSegmenter : public SingleSegmentSegmenter {
                                   MkvWriter* dest,
                                   uint64_t last_size);
 
+  // Estimates how many bytes to reserve for the Cues in single-pass mode.
+  uint64_t ComputeCuesReservation();
+  // Writes the Cues into the reserved region (or appends them at the end of
+  // the file if they outgrew it) and patches the header. Single-pass
+  // counterpart of the copying DoFinalize() path.
+  Status FinalizeReservedHeader();
+
   std::string temp_file_name_;
+  // Single-pass reserved-header mode; enabled in DoInitialize() when the
+  // output is seekable.
+  bool single_pass_ = false;
+  uint64_t cues_reserved_pos_ = 0;
+  uint64_t reserved_cues_size_ = 0;
 
   DISALLOW_COPY_AND_ASSIGN(TwoPassSingleSegmentSegmenter);
 };
@@ -758,6 +758,22 @@ int WebMListParser::Parse(const uint8_t* buf, int size) {
   int bytes_parsed = 0;
 
   while (cur_size > 0 && state_ != PARSE_ERROR && state_ != DONE_PARSING_LIST) {
+    if (state_ == INSIDE_LIST) {
+      // Media clusters are almost entirely runs of SimpleBlock elements;
+      // batch-consume them without the generic per-element dispatch below.
+      int block_bytes = ParseSimpleBlockRun(cur, cur_size);
+      if (block_bytes < 0) {
+        ChangeState(PARSE_ERROR);
+        return -1;
+      }
+      if (block_bytes > 0) {
+        cur += block_bytes;
+        cur_size -= block_bytes;
+        bytes_parsed += block_bytes;
+        continue;
+      }
+    }
+
     int element_id = 0;
     int64_t element_size = 0;
     int result = WebMParseElementHeader(cur, cur_size, &element_id,
@@ -983,6 +999,59 @@ bool WebMListParser::OnListEnd() {
   return true;
 }
 
+int WebMListParser::ParseSimpleBlockRun(const uint8_t* buf, int size) {
+  int bytes_consumed = 0;
+  while (size - bytes_consumed > 0 && !list_state_stack_.empty()) {
+    ListState& list_state = list_state_stack_.back();
+    if (list_state.id_ != kWebMIdCluster)
+      break;
+
+    const uint8_t* cur = buf + bytes_consumed;
+    const int cur_size = size - bytes_consumed;
+    // SimpleBlock has a one byte ID.
+    if (cur[0] != kWebMIdSimpleBlock)
+      break;
+
+    int64_t element_size = 0;
+    const int num_size_bytes =
+        ParseWebMElementHeaderField(cur + 1, cur_size - 1, 8, true,
+                                    &element_size);
+    // Defer to the generic path when the size field is incomplete or encodes
+    // an unknown size, so those cases keep their existing handling.
+    if (num_size_bytes <= 0 ||
+        element_size == std::numeric_limits<int64_t>::max()) {
+      break;
+    }
+
+    const int64_t total_element_size = 1 + num_size_bytes + element_size;
+    if (list_state.size_ != kWebMUnknownSize &&
+        list_state.size_ < list_state.bytes_parsed_ + total_element_size) {
+      // The block does not fit inside the Cluster.
+      return -1;
+    }
+    if (total_element_size > cur_size) {
+      // Partial block; the caller will resume when more data arrives.
+      break;
+    }
+
+    if (!list_state.client_->OnBinary(kWebMIdSimpleBlock,
+                                      cur + 1 + num_size_bytes,
+                                      static_cast<int>(element_size))) {
+      return -1;
+    }
+
+    list_state.bytes_parsed_ += total_element_size;
+    bytes_consumed += static_cast<int>(total_element_size);
+
+    if (list_state.bytes_parsed_ == list_state.size_) {
+      if (!OnListEnd())
+        return -1;
+      break;
+    }
+  }
+  return bytes_consumed;
+}
+
 bool WebMListParser::IsSiblingOrAncestor(int id_a, int id_b) const {
   DCHECK((id_a == kWebMIdSegment) || (id_a == kWebMIdCluster));
 
@@ -122,6 +122,16 @@ class WebMListParser {
   // Returns true if no errors occurred while ending this list(s).
   bool OnListEnd();
 
+  // Consumes a run of complete SimpleBlock elements at the head of |buf|
+  // while the innermost open list is a Cluster, dispatching each payload
+  // straight to the Cluster's client. This skips the per-element type lookup
+  // and generic dispatch for the dominant element type in media clusters.
+  //
+  // Returns the number of bytes consumed (0 if the next element is not a
+  // complete SimpleBlock), or < 0 if the client rejects a block or a block
+  // overflows the Cluster.
+  int ParseSimpleBlockRun(const uint8_t* buf, int size);
+
   // Checks to see if |id_b| is a sibling or ancestor of |id_a|.
   bool IsSiblingOrAncestor(int id_a, int id_b) const;
 
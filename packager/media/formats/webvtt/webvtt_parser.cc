@@ -6,8 +6,12 @@
 
 #include <packager/media/formats/webvtt/webvtt_parser.h>
 
+#include <string_view>
+#include <utility>
+
 #include <absl/log/check.h>
 #include <absl/log/log.h>
+#include <absl/strings/ascii.h>
 #include <absl/strings/numbers.h>
 #include <absl/strings/str_format.h>
 #include <absl/strings/str_split.h>
@@ -15,7 +19,6 @@
 #include <packager/kv_pairs/kv_pairs.h>
 #include <packager/media/base/text_stream_info.h>
 #include <packager/media/formats/webvtt/webvtt_utils.h>
-#include <packager/utils/string_trim_split.h>
 
 namespace shaka {
 namespace media {
@@ -78,10 +81,10 @@ bool IsLikelyRegion(const std::string& line) {
   return absl::StripTrailingAsciiWhitespace(line) == "REGION";
 }
 
-bool ParsePercent(const std::string& str, float* value) {
+bool ParsePercent(std::string_view str, float* value) {
   // https://www.w3.org/TR/webvtt1/#webvtt-percentage
   // E.g. "4%" or "1.5%"
-  if (str[str.size() - 1] != '%') {
+  if (str.empty() || str[str.size() - 1] != '%') {
     return false;
   }
 
@@ -93,15 +96,16 @@ bool ParsePercent(const std::string& str, float* value) {
   return true;
 }
 
-bool ParseDoublePercent(const std::string& str, float* a, float* b) {
-  std::vector<std::string> percents = SplitAndTrimSkipEmpty(str, ',');
+bool ParseDoublePercent(std::string_view str, float* a, float* b) {
+  const std::vector<std::string_view> percents =
+      absl::StrSplit(str, ',', absl::SkipWhitespace());
 
   if (percents.size() != 2) {
     return false;
   }
   float temp_a, temp_b;
-  if (!ParsePercent(percents[0], &temp_a) ||
-      !ParsePercent(percents[1], &temp_b)) {
+  if (!ParsePercent(absl::StripAsciiWhitespace(percents[0]), &temp_a) ||
+      !ParsePercent(absl::StripAsciiWhitespace(percents[1]), &temp_b)) {
     return false;
   }
   *a = temp_a;
@@ -109,12 +113,12 @@ bool ParseDoublePercent(const std::string& str, float* a, float* b) {
   return true;
 }
 
-void ParseSettings(const std::string& id,
-                   const std::string& value,
+void ParseSettings(std::string_view id,
+                   std::string_view value,
                    TextSettings* settings) {
   // https://www.w3.org/TR/webvtt1/#ref-for-parse-the-webvtt-cue-settings-1
   if (id == "region") {
-    settings->region = value;
+    settings->region = std::string(value);
   } else if (id == "vertical") {
     if (value == "rl") {
       settings->writing_direction = WritingDirection::kVerticalGrowingLeft;
@@ -125,10 +129,8 @@ void ParseSettings(const std::string& id,
     }
   } else if (id == "line") {
     const auto pos = value.find(',');
-    const std::string line = value.substr(0, pos);
-    const std::string align =
-        pos != std::string::npos ? value.substr(pos + 1) : "";
-    if (pos != std::string::npos) {
+    const std::string_view line = value.substr(0, pos);
+    if (pos != std::string_view::npos) {
       LOG(WARNING) << "WebVTT line alignment isn't supported";
     }
 
@@ -149,10 +151,8 @@ void ParseSettings(const std::string& id,
     }
   } else if (id == "position") {
     const auto pos = value.find(',');
-    const std::string position = value.substr(0, pos);
-    const std::string align =
-        pos != std::string::npos ? value.substr(pos + 1) : "";
-    if (pos != std::string::npos) {
+    const std::string_view position = value.substr(0, pos);
+    if (pos != std::string_view::npos) {
       LOG(WARNING) << "WebVTT position alignment isn't supported";
     }
 
@@ -243,7 +243,7 @@ bool WebVttParser::Parse() {
   return true;
 }
 
-bool WebVttParser::ParseBlock(const std::vector<std::string>& block) {
+bool WebVttParser::ParseBlock(std::vector<std::string>& block) {
   // NOTE
   if (IsLikelyNote(block[0])) {
     // We can safely ignore the whole block.
@@ -378,19 +378,20 @@ bool WebVttParser::ParseRegion(const std::vector<std::string>& block) {
   return true;
 }
 
-bool WebVttParser::ParseCueWithNoId(const std::vector<std::string>& block) {
+bool WebVttParser::ParseCueWithNoId(std::vector<std::string>& block) {
   return ParseCue("", block.data(), block.size());
 }
 
-bool WebVttParser::ParseCueWithId(const std::vector<std::string>& block) {
+bool WebVttParser::ParseCueWithId(std::vector<std::string>& block) {
   return ParseCue(block[0], block.data() + 1, block.size() - 1);
 }
 
 bool WebVttParser::ParseCue(const std::string& id,
-                            const std::string* block,
+                            std::string* block,
                             size_t block_size) {
-  std::vector<std::string> time_and_style =
-      SplitAndTrimSkipEmpty(block[0], ' ');
+  // Tokenize as views over the line; nothing here needs to outlive the call.
+  const std::vector<std::string_view> time_and_style = absl::StrSplit(
+      block[0], absl::ByAnyChar(" \t"), absl::SkipEmpty());
 
   int64_t start_time = 0;
   int64_t end_time = 0;
@@ -431,13 +432,12 @@ bool WebVttParser::ParseCue(const std::string& id,
   TextSettings settings;
   for (size_t i = 3; i < time_and_style.size(); i++) {
     const auto pos = time_and_style[i].find(':');
-    if (pos == std::string::npos) {
+    if (pos == std::string_view::npos) {
       continue;
     }
 
-    const std::string key = time_and_style[i].substr(0, pos);
-    const std::string value = time_and_style[i].substr(pos + 1);
-    ParseSettings(key, value, &settings);
+    ParseSettings(time_and_style[i].substr(0, pos),
+                  time_and_style[i].substr(pos + 1), &settings);
   }
 
   // The rest of the block is the payload.
@@ -448,7 +448,7 @@ bool WebVttParser::ParseCue(const std::string& id,
     if (i > 1 && i != block_size) {
       body.sub_fragments.emplace_back(no_styles, /* newline= */ true);
     }
-    body.sub_fragments.emplace_back(no_styles, block[i]);
+    body.sub_fragments.emplace_back(no_styles, std::move(block[i]));
   }
 
   const auto sample =
@@ -33,13 +33,13 @@ class WebVttParser : public MediaParser {
 
  private:
   bool Parse();
-  bool ParseBlock(const std::vector<std::string>& block);
+  // |block| is mutable so cue payload lines can be moved into the sample
+  // instead of copied.
+  bool ParseBlock(std::vector<std::string>& block);
   bool ParseRegion(const std::vector<std::string>& block);
-  bool ParseCueWithNoId(const std::vector<std::string>& block);
-  bool ParseCueWithId(const std::vector<std::string>& block);
-  bool ParseCue(const std::string& id,
-                const std::string* block,
-                size_t block_size);
+  bool ParseCueWithNoId(std::vector<std::string>& block);
+  bool ParseCueWithId(std::vector<std::string>& block);
+  bool ParseCue(const std::string& id, std::string* block, size_t block_size);
 
   void DispatchTextStreamInfo();
 
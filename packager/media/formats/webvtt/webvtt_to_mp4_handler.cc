@@ -73,18 +73,16 @@ void WriteSample(const TextSample& sample, BufferWriter* out) {
   box.Write(out);
 }
 
-void WriteSamples(const std::list<const TextSample*>& samples,
-                  BufferWriter* writer) {
-  DCHECK_GE(samples.size(), 0u);
-
-  for (const auto& sample : samples) {
-    WriteSample(*sample, writer);
-  }
-}
-
-void WriteEmptySample(BufferWriter* writer) {
-  mp4::VTTEmptyCueBox box;
-  box.Write(writer);
+// VTTEmptyCueBox has no fields, so its serialized form never changes;
+// serialize it once and reuse the bytes for every empty interval.
+const BufferWriter& EmptyCueBytes() {
+  static const BufferWriter* const empty_cue_bytes = []() {
+    BufferWriter* writer = new BufferWriter;
+    mp4::VTTEmptyCueBox box;
+    box.Write(writer);
+    return writer;
+  }();
+  return *empty_cue_bytes;
 }
 
 std::shared_ptr<MediaSample> CreateMediaSample(const BufferWriter& buffer,
@@ -169,6 +167,7 @@ Status WebVttToMp4Handler::OnSegmentInfo(
 
   RETURN_IF_ERROR(DispatchCurrentSegment(segment_start, segment_end));
   current_segment_.clear();
+  cue_payload_cache_.clear();
 
   return Dispatch(std::move(stream_data));
 }
@@ -261,12 +260,20 @@ Status WebVttToMp4Handler::MergeDispatchSamples(
     const std::list<const TextSample*>& state) {
   DCHECK_GT(end_time, start_time);
 
+  if (state.empty()) {
+    return DispatchMediaSample(
+        kTrackId, CreateMediaSample(EmptyCueBytes(), start_time, end_time));
+  }
+
   box_writer_.Clear();
 
-  if (state.size()) {
-    WriteSamples(state, &box_writer_);
-  } else {
-    WriteEmptySample(&box_writer_);
+  for (const TextSample* sample : state) {
+    // A cue usually spans several display intervals of the segment; its vttc
+    // box is serialized on first use and the bytes reused afterwards.
+    BufferWriter& cached = cue_payload_cache_[sample];
+    if (cached.Size() == 0)
+      WriteSample(*sample, &cached);
+    box_writer_.AppendBuffer(cached);
   }
 
   return DispatchMediaSample(
@@ -9,6 +9,7 @@
 
 #include <cstdint>
 #include <list>
+#include <map>
 #include <queue>
 
 #include <packager/media/base/buffer_writer.h>
@@ -46,6 +47,12 @@ class WebVttToMp4Handler : public MediaHandler {
 
   // This is the current state of the box we are writing.
   BufferWriter box_writer_;
+
+  // Serialized vttc box per cue of the current segment. Dense overlapping
+  // cues make one cue span many display intervals; caching the bytes makes
+  // the per-interval work a copy instead of a re-serialization. Cleared with
+  // |current_segment_|.
+  std::map<const TextSample*, BufferWriter> cue_payload_cache_;
 };
 
 }  // namespace media
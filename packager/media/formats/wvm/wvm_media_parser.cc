@@ -4,6 +4,7 @@
 
 #include <packager/media/formats/wvm/wvm_media_parser.h>
 
+#include <cstring>
 #include <map>
 #include <sstream>
 #include <vector>
@@ -126,16 +127,21 @@ void WvmMediaParser::Init(const InitCB& init_cb,
 
 bool WvmMediaParser::Parse(const uint8_t* buf, int size) {
   size_t num_bytes = 0;
-  size_t prev_size = 0;
   const uint8_t* read_ptr = buf;
   const uint8_t* end = read_ptr + size;
 
   while (read_ptr < end) {
     switch (parse_state_) {
       case StartCode1:
-        if (*read_ptr == kStartCode1) {
-          parse_state_ = StartCode2;
+        // Jump straight to the next candidate start byte. memchr runs
+        // word-at-a-time, instead of one state machine step per byte.
+        read_ptr = static_cast<const uint8_t*>(
+            memchr(read_ptr, kStartCode1, end - read_ptr));
+        if (read_ptr == NULL) {
+          read_ptr = end;
+          continue;
         }
+        parse_state_ = StartCode2;
         break;
       case StartCode2:
         if (*read_ptr == kStartCode2) {
@@ -392,9 +398,7 @@ bool WvmMediaParser::Parse(const uint8_t* buf, int size) {
         }
         if (num_bytes > 0) {
           pes_packet_bytes_ -= num_bytes;
-          prev_size = psm_data_.size();
-          psm_data_.resize(prev_size + num_bytes);
-          memcpy(&psm_data_[prev_size], read_ptr, num_bytes);
+          psm_data_.insert(psm_data_.end(), read_ptr, read_ptr + num_bytes);
         }
         read_ptr += num_bytes;
         continue;
@@ -406,9 +410,7 @@ bool WvmMediaParser::Parse(const uint8_t* buf, int size) {
         }
         if (num_bytes > 0) {
           pes_packet_bytes_ -= num_bytes;
-          prev_size = ecm_.size();
-          ecm_.resize(prev_size + num_bytes);
-          memcpy(&ecm_[prev_size], read_ptr, num_bytes);
+          ecm_.insert(ecm_.end(), read_ptr, read_ptr + num_bytes);
         }
         if ((pes_packet_bytes_ == 0) && !ecm_.empty()) {
           if (!ProcessEcm()) {
@@ -425,9 +427,8 @@ bool WvmMediaParser::Parse(const uint8_t* buf, int size) {
         }
         if (num_bytes > 0) {
           pes_packet_bytes_ -= num_bytes;
-          prev_size = index_data_.size();
-          index_data_.resize(prev_size + num_bytes);
-          memcpy(&index_data_[prev_size], read_ptr, num_bytes);
+          index_data_.insert(index_data_.end(), read_ptr,
+                             read_ptr + num_bytes);
         }
         if (pes_packet_bytes_ == 0 && !index_data_.empty()) {
           if (!metadata_is_complete_) {
@@ -446,9 +447,10 @@ bool WvmMediaParser::Parse(const uint8_t* buf, int size) {
         }
         pes_packet_bytes_ -= num_bytes;
         if (pes_stream_id_ !=  kV2MetadataStreamId) {
-          sample_data_.resize(sample_data_.size() + num_bytes);
-          memcpy(&sample_data_[sample_data_.size() - num_bytes], read_ptr,
-                 num_bytes);
+          // insert() appends in a single copy pass; resize() + memcpy would
+          // zero-fill the new bytes first.
+          sample_data_.insert(sample_data_.end(), read_ptr,
+                              read_ptr + num_bytes);
         }
         prev_pes_stream_id_ = pes_stream_id_;
         read_ptr += num_bytes;
@@ -820,14 +822,22 @@ bool WvmMediaParser::Output(bool output_encrypted_sample) {
     media_sample_->set_is_encrypted(true);
   } else {
     if ((prev_pes_stream_id_ & kPesStreamIdVideoMask) == kPesStreamIdVideo) {
-      // Convert video stream to unit stream and get config.
-      std::vector<uint8_t> nal_unit_stream;
-      if (!byte_to_unit_stream_converter_.ConvertByteStreamToNalUnitStream(
-              sample_data_.data(), sample_data_.size(), &nal_unit_stream)) {
-        LOG(ERROR) << "Could not convert h.264 byte stream sample";
-        return false;
+      // Convert video stream to unit stream and get config. |sample_data_| is
+      // cleared before the next sample is demuxed, so patching the start codes
+      // in place is safe and saves a copy; frames with 3-byte start codes or
+      // stripped parameter sets fall back to the copying conversion.
+      if (byte_to_unit_stream_converter_.ConvertByteStreamToNalUnitStreamInPlace(
+              sample_data_.data(), sample_data_.size())) {
+        media_sample_->SetData(sample_data_.data(), sample_data_.size());
+      } else {
+        std::vector<uint8_t> nal_unit_stream;
+        if (!byte_to_unit_stream_converter_.ConvertByteStreamToNalUnitStream(
+                sample_data_.data(), sample_data_.size(), &nal_unit_stream)) {
+          LOG(ERROR) << "Could not convert h.264 byte stream sample";
+          return false;
+        }
+        media_sample_->SetData(nal_unit_stream.data(), nal_unit_stream.size());
       }
-      media_sample_->SetData(nal_unit_stream.data(), nal_unit_stream.size());
       if (!is_initialized_) {
         // Set extra data for video stream from AVC Decoder Config Record.
         // Also, set codec string from the AVC Decoder Config Record.
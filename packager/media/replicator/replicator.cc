@@ -6,26 +6,79 @@
 
 #include <packager/media/replicator/replicator.h>
 
+#include <algorithm>
+
 #include <absl/log/check.h>
 #include <absl/log/log.h>
 
 namespace shaka {
 namespace media {
 
+Status Replicator::AttachOutput(std::shared_ptr<MediaHandler> handler) {
+  absl::MutexLock lock(&mutex_);
+  pending_attach_.push_back(std::move(handler));
+  return Status::OK;
+}
+
+Status Replicator::DetachOutput(const std::shared_ptr<MediaHandler>& handler) {
+  absl::MutexLock lock(&mutex_);
+
+  // If the branch has not been activated yet there is nothing to flush; just
+  // drop it from the pending list.
+  auto pending =
+      std::find(pending_attach_.begin(), pending_attach_.end(), handler);
+  if (pending != pending_attach_.end()) {
+    pending_attach_.erase(pending);
+    return Status::OK;
+  }
+
+  for (const auto& out : output_handlers()) {
+    if (out.second.first == handler) {
+      pending_detach_.push_back(handler);
+      return Status::OK;
+    }
+  }
+  return Status(error::NOT_FOUND,
+                "The handler is not attached to this replicator.");
+}
+
 Status Replicator::InitializeInternal() {
   return Status::OK;
 }
 
 Status Replicator::Process(std::unique_ptr<StreamData> stream_data) {
+  absl::MutexLock lock(&mutex_);
   Status status;
 
+  if (stream_data->stream_data_type == StreamDataType::kStreamInfo)
+    stream_info_ = stream_data->stream_info;
+  const bool segment_boundary =
+      stream_data->stream_data_type == StreamDataType::kSegmentInfo &&
+      !stream_data->segment_info->is_subsegment;
+
+  // The StreamData copies share the underlying message (stream info, sample,
+  // etc.) through their shared_ptr members; only the small StreamData header
+  // is duplicated per output. The original is moved to the last output so a
+  // single-output replication makes no copy at all.
+  const size_t num_outputs = output_handlers().size();
+  size_t output_index = 0;
   for (auto& out : output_handlers()) {
-    std::unique_ptr<StreamData> copy(new StreamData(*stream_data));
-    copy->stream_index = out.first;
+    ++output_index;
+    std::unique_ptr<StreamData> replicated =
+        (output_index == num_outputs)
+            ? std::move(stream_data)
+            : std::unique_ptr<StreamData>(new StreamData(*stream_data));
+    replicated->stream_index = out.first;
 
-    status.Update(Dispatch(std::move(copy)));
+    status.Update(Dispatch(std::move(replicated)));
   }
 
+  // Apply runtime reconfigurations at segment boundaries only, so detached
+  // branches end on a complete segment and attached ones start on a fresh
+  // one.
+  if (segment_boundary)
+    status.Update(ApplyPendingChangesNoLocking());
+
   return status;
 }
 
@@ -35,8 +88,46 @@ bool Replicator::ValidateOutputStreamIndex(size_t /* ignored */) const {
 
 Status Replicator::OnFlushRequest(size_t input_stream_index) {
   DCHECK_EQ(input_stream_index, 0u);
+  absl::MutexLock lock(&mutex_);
+  if (!pending_attach_.empty()) {
+    LOG(WARNING) << "Dropping " << pending_attach_.size()
+                 << " output(s) attached after the stream ended.";
+    pending_attach_.clear();
+  }
+  // Everything still connected is flushed below, so pending detaches do not
+  // need a separate flush.
+  pending_detach_.clear();
   return FlushAllDownstreams();
 }
 
+Status Replicator::ApplyPendingChangesNoLocking() {
+  mutex_.AssertHeld();
+  Status status;
+
+  for (const auto& handler : pending_detach_) {
+    for (const auto& out : output_handlers()) {
+      if (out.second.first == handler) {
+        status.Update(FlushDownstream(out.first));
+        status.Update(RemoveHandler(out.first));
+        break;
+      }
+    }
+  }
+  pending_detach_.clear();
+
+  for (auto& handler : pending_attach_) {
+    const size_t output_index = next_output_stream_index();
+    status.Update(AddHandler(handler));
+    status.Update(handler->Initialize());
+    // A branch attached mid-stream missed the stream info that flowed through
+    // at startup; replay the cached one so its muxer can set up.
+    if (stream_info_)
+      status.Update(DispatchStreamInfo(output_index, stream_info_));
+  }
+  pending_attach_.clear();
+
+  return status;
+}
+
 }  // namespace media
 }  // namespace shaka
@@ -7,6 +7,11 @@
 #ifndef PACKAGER_MEDIA_REPLICATOR_HANDLER_H_
 #define PACKAGER_MEDIA_REPLICATOR_HANDLER_H_
 
+#include <memory>
+#include <vector>
+
+#include <absl/synchronization/mutex.h>
+
 #include <packager/media/base/media_handler.h>
 
 namespace shaka {
@@ -17,11 +22,39 @@ namespace media {
 /// they are the original message. It is the responsibility of downstream
 /// handlers to make a copy before modifying the message.
 class Replicator : public MediaHandler {
+ public:
+  /// Attach a fully chained downstream branch while the pipeline is running.
+  /// The branch is connected at the next segment boundary: it is initialized,
+  /// receives the cached stream info and then every subsequent message, so
+  /// its first segment starts clean. Safe to call from any thread.
+  Status AttachOutput(std::shared_ptr<MediaHandler> handler);
+
+  /// Detach the branch rooted at @a handler at the next segment boundary. The
+  /// branch is flushed before it is disconnected so its output is finalized.
+  /// Branches that are still waiting to be attached are simply dropped. Safe
+  /// to call from any thread.
+  Status DetachOutput(const std::shared_ptr<MediaHandler>& handler);
+
  private:
   Status InitializeInternal() override;
   Status Process(std::unique_ptr<StreamData> stream_data) override;
   bool ValidateOutputStreamIndex(size_t stream_index) const override;
   Status OnFlushRequest(size_t input_stream_index) override;
+
+  // Flushes and disconnects the branches in |pending_detach_|, then connects,
+  // initializes and replays the cached stream info to the branches in
+  // |pending_attach_|. Called on the pipeline thread at segment boundaries.
+  Status ApplyPendingChangesNoLocking();
+
+  // Serializes Process() with runtime attach/detach requests. Uncontended on
+  // the sample path unless a reconfiguration is in flight.
+  absl::Mutex mutex_;
+  // The last stream info seen, replayed to branches attached at runtime.
+  std::shared_ptr<const StreamInfo> stream_info_ ABSL_GUARDED_BY(mutex_);
+  std::vector<std::shared_ptr<MediaHandler>> pending_attach_
+      ABSL_GUARDED_BY(mutex_);
+  std::vector<std::shared_ptr<MediaHandler>> pending_detach_
+      ABSL_GUARDED_BY(mutex_);
 };
 
 }  // namespace media
@@ -0,0 +1,204 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+//
+// Replays a corpus of media files (representative valid streams plus
+// malformed inputs) through the MediaParser implementations and reports
+// per-entry demux throughput. Without budgets this is a crash/hang smoke
+// test over the corpus; with --min_mbps and/or --max_millis_per_entry it is
+// a CI throughput gate that exits nonzero when a parsing change regresses
+// demux speed beyond the given thresholds.
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <absl/flags/flag.h>
+#include <absl/flags/parse.h>
+#include <absl/flags/usage.h>
+#include <absl/log/initialize.h>
+#include <absl/log/log.h>
+#include <absl/strings/str_split.h>
+
+#include <packager/media/base/container_names.h>
+#include <packager/media/base/media_parser.h>
+#include <packager/media/base/media_sample.h>
+#include <packager/media/base/stream_info.h>
+#include <packager/media/base/text_sample.h>
+#include <packager/media/formats/mp2t/mp2t_media_parser.h>
+#include <packager/media/formats/mp4/mp4_media_parser.h>
+#include <packager/media/formats/webm/webm_media_parser.h>
+#include <packager/media/formats/webvtt/webvtt_parser.h>
+#include <packager/media/formats/wvm/wvm_media_parser.h>
+#include <packager/media/test/test_data_util.h>
+
+ABSL_FLAG(std::string,
+          corpus,
+          "",
+          "Comma separated list of corpus files to replay. Defaults to a "
+          "built-in set of representative and malformed entries from the "
+          "checked-in test data.");
+ABSL_FLAG(int, iterations, 3, "Replays per entry; the best run is scored.");
+ABSL_FLAG(double,
+          min_mbps,
+          0,
+          "Minimum demux throughput in MB/s for every parsed entry. Entries "
+          "below the threshold fail the gate. 0 disables the check.");
+ABSL_FLAG(double,
+          max_millis_per_entry,
+          0,
+          "Wall-time budget for the best replay of each entry, in "
+          "milliseconds. 0 disables the check.");
+
+namespace shaka {
+namespace media {
+namespace {
+
+// Parsers read in demuxer-sized chunks, so replay mimics streaming input
+// rather than handing the parser one giant buffer.
+const size_t kChunkSize = 64 * 1024;
+
+// Entries replayed when --corpus is empty: one representative stream per
+// parser, plus malformed and truncated inputs that must be rejected without
+// crashing or hanging.
+const char* const kDefaultCorpus[] = {
+    "bear-640x360.mp4",
+    "bear-640x360-av_frag.mp4",
+    "bear-640x360.ts",
+    "bear-640x360.webm",
+    "bear-640x360.wvm",
+    "bear-english.vtt",
+    "vp8-corrupt-I-frame",
+    "no_streams.webm",
+    "webm_ebml_element",
+    "ten_byte_file",
+};
+
+std::unique_ptr<MediaParser> CreateParser(const uint8_t* data, size_t size) {
+  switch (DetermineContainer(data, size)) {
+    case CONTAINER_MOV:
+      return std::unique_ptr<MediaParser>(new mp4::MP4MediaParser());
+    case CONTAINER_MPEG2TS:
+      return std::unique_ptr<MediaParser>(new mp2t::Mp2tMediaParser());
+    case CONTAINER_WVM:
+      return std::unique_ptr<MediaParser>(new wvm::WvmMediaParser());
+    case CONTAINER_WEBM:
+      return std::unique_ptr<MediaParser>(new WebMMediaParser());
+    case CONTAINER_WEBVTT:
+      return std::unique_ptr<MediaParser>(new WebVttParser());
+    default:
+      return nullptr;
+  }
+}
+
+// Replays |data| through a fresh parser. Returns false if the parser
+// rejected the input, which is the expected outcome for malformed entries.
+bool ReplayOnce(const std::vector<uint8_t>& data, uint64_t* num_samples) {
+  std::unique_ptr<MediaParser> parser = CreateParser(data.data(), data.size());
+  if (!parser)
+    return false;
+
+  parser->Init(
+      [](const std::vector<std::shared_ptr<StreamInfo>>&) {},
+      [num_samples](uint32_t, std::shared_ptr<MediaSample>) {
+        ++*num_samples;
+        return true;
+      },
+      [num_samples](uint32_t, std::shared_ptr<TextSample>) {
+        ++*num_samples;
+        return true;
+      },
+      nullptr);
+
+  for (size_t offset = 0; offset < data.size(); offset += kChunkSize) {
+    const size_t chunk = std::min(kChunkSize, data.size() - offset);
+    if (!parser->Parse(data.data() + offset, static_cast<int>(chunk)))
+      return false;
+  }
+  return parser->Flush();
+}
+
+int ReplayCorpus() {
+  std::vector<std::string> corpus;
+  const std::string corpus_flag = absl::GetFlag(FLAGS_corpus);
+  if (corpus_flag.empty()) {
+    for (const char* name : kDefaultCorpus)
+      corpus.push_back(GetTestDataFilePath(name).string());
+  } else {
+    corpus = absl::StrSplit(corpus_flag, ',', absl::SkipEmpty());
+  }
+  const int iterations = std::max(1, absl::GetFlag(FLAGS_iterations));
+  const double min_mbps = absl::GetFlag(FLAGS_min_mbps);
+  const double max_millis = absl::GetFlag(FLAGS_max_millis_per_entry);
+
+  int num_failures = 0;
+  for (const std::string& path : corpus) {
+    std::filesystem::path fs_path(path);
+    const std::string data_string = GetPathContent(fs_path);
+    if (data_string.empty()) {
+      LOG(ERROR) << "Cannot read corpus entry " << path;
+      ++num_failures;
+      continue;
+    }
+    const std::vector<uint8_t> data(data_string.begin(), data_string.end());
+
+    double best_seconds = 0;
+    uint64_t num_samples = 0;
+    bool parsed = false;
+    for (int i = 0; i < iterations; ++i) {
+      num_samples = 0;
+      const auto start = std::chrono::steady_clock::now();
+      const bool ok = ReplayOnce(data, &num_samples);
+      const double seconds =
+          std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                        start)
+              .count();
+      if (i == 0 || seconds < best_seconds)
+        best_seconds = seconds;
+      parsed = ok;
+    }
+
+    // Rejected entries exercise the error paths; only a crash or hang fails
+    // them, and throughput budgets do not apply.
+    const double mbps = best_seconds > 0
+                            ? data.size() / best_seconds / (1024 * 1024)
+                            : 0;
+    printf("%-45s %9zu bytes  %8.3f ms  %8.1f MB/s  %6" PRIu64 " samples%s\n",
+           fs_path.filename().string().c_str(), data.size(),
+           best_seconds * 1000, mbps, num_samples,
+           parsed ? "" : "  (rejected)");
+
+    if (max_millis > 0 && best_seconds * 1000 > max_millis) {
+      LOG(ERROR) << path << ": best replay took " << best_seconds * 1000
+                 << " ms, over the " << max_millis << " ms budget.";
+      ++num_failures;
+    }
+    if (parsed && min_mbps > 0 && mbps < min_mbps) {
+      LOG(ERROR) << path << ": demuxed at " << mbps << " MB/s, under the "
+                 << min_mbps << " MB/s budget.";
+      ++num_failures;
+    }
+  }
+  return num_failures == 0 ? 0 : 1;
+}
+
+}  // namespace
+}  // namespace media
+}  // namespace shaka
+
+int main(int argc, char** argv) {
+  absl::SetProgramUsageMessage(
+      "Replays media corpora through the MediaParser implementations with "
+      "optional throughput budgets.");
+  absl::ParseCommandLine(argc, argv);
+  absl::InitializeLog();
+  return shaka::media::ReplayCorpus();
+}
@@ -9,6 +9,8 @@
 #include <absl/log/check.h>
 #include <absl/log/log.h>
 
+#include <packager/macros/status.h>
+#include <packager/media/base/load_shedder.h>
 #include <packager/media/base/video_stream_info.h>
 #include <packager/status.h>
 
@@ -24,7 +26,36 @@ TrickPlayHandler::TrickPlayHandler(uint32_t factor) : factor_(factor) {
       << "Trick Play Handles must have a factor of 1 or higher.";
 }
 
+TrickPlayHandler::TrickPlayHandler(uint32_t factor,
+                                   const std::string& spill_temp_dir,
+                                   uint64_t spill_memory_bytes)
+    : factor_(factor),
+      spill_temp_dir_(spill_temp_dir),
+      spill_memory_bytes_(spill_memory_bytes) {
+  DCHECK_GE(factor, 1u)
+      << "Trick Play Handles must have a factor of 1 or higher.";
+}
+
+TrickPlayHandler::TrickPlayHandler(
+    uint32_t factor,
+    const std::string& spill_temp_dir,
+    uint64_t spill_memory_bytes,
+    std::shared_ptr<MemoryTracker> memory_tracker)
+    : factor_(factor),
+      spill_temp_dir_(spill_temp_dir),
+      spill_memory_bytes_(spill_memory_bytes),
+      memory_tracker_(std::move(memory_tracker)) {
+  DCHECK_GE(factor, 1u)
+      << "Trick Play Handles must have a factor of 1 or higher.";
+}
+
 Status TrickPlayHandler::InitializeInternal() {
+  // A job-level tracker alone enables spilling too, so pressure can push
+  // payloads out even when no per-stream budget was configured.
+  if (spill_memory_bytes_ > 0 || memory_tracker_) {
+    delayed_messages_.EnableSpill(spill_temp_dir_, spill_memory_bytes_);
+    delayed_messages_.set_memory_tracker(memory_tracker_.get());
+  }
   return Status::OK;
 }
 
@@ -44,8 +75,7 @@ Status TrickPlayHandler::Process(std::unique_ptr<StreamData> stream_data) {
 
     case StreamDataType::kCueEvent:
       // Add the cue event to be dispatched later.
-      delayed_messages_.push_back(std::move(stream_data));
-      return Status::OK;
+      return delayed_messages_.PushBack(std::move(stream_data));
 
     default:
       return Status(error::TRICK_PLAY_ERROR,
@@ -61,8 +91,10 @@ Status TrickPlayHandler::OnFlushRequest(size_t input_stream_index) {
   // anything.
   Status s;
   while (s.ok() && delayed_messages_.size()) {
-    s.Update(Dispatch(std::move(delayed_messages_.front())));
-    delayed_messages_.pop_front();
+    std::unique_ptr<StreamData> message;
+    s.Update(delayed_messages_.PopFront(&message));
+    if (s.ok())
+      s.Update(Dispatch(std::move(message)));
   }
 
   return s.ok() ? MediaHandler::FlushAllDownstreams() : s;
@@ -90,10 +122,8 @@ Status TrickPlayHandler::OnStreamInfo(const StreamInfo& info) {
   // Add video info to the message queue so that it can be sent out with all
   // other messages. It won't be sent until the second trick play frame comes
   // through. Until then, it can be updated via the |video_info_| member.
-  delayed_messages_.push_back(
+  return delayed_messages_.PushBack(
       StreamData::FromStreamInfo(kStreamIndexOut, video_info_));
-
-  return Status::OK;
 }
 
 Status TrickPlayHandler::OnSegmentInfo(
@@ -109,7 +139,7 @@ Status TrickPlayHandler::OnSegmentInfo(
   }
 
   const StreamDataType previous_type =
-      delayed_messages_.back()->stream_data_type;
+      delayed_messages_.back().stream_data_type;
 
   switch (previous_type) {
     case StreamDataType::kSegmentInfo:
@@ -125,9 +155,8 @@ Status TrickPlayHandler::OnSegmentInfo(
       // not get sent downstream until the next trick play frame comes through
       // or flush is called.
       previous_segment_ = std::make_shared<SegmentInfo>(*info);
-      delayed_messages_.push_back(
+      return delayed_messages_.PushBack(
           StreamData::FromSegmentInfo(kStreamIndexOut, previous_segment_));
-      return Status::OK;
 
     default:
       return Status(error::TRICK_PLAY_ERROR,
@@ -143,7 +172,15 @@ Status TrickPlayHandler::OnMediaSample(const MediaSample& sample) {
     total_key_frames_++;
 
     if ((total_key_frames_ - 1) % factor_ == 0) {
-      return OnTrickFrame(sample);
+      // The trick-play branch is sheddable under deadline pressure: a shed
+      // trick frame is treated like any other skipped frame and spanned by
+      // the previous one. The first two trick frames are always kept so the
+      // stream info and playback rate stay well-defined.
+      const bool shed =
+          total_trick_frames_ >= 2 &&
+          LoadShedder::ShouldShed(LoadShedder::Priority::kTrickPlay);
+      if (!shed)
+        return OnTrickFrame(sample);
     }
   }
   // If the frame is not a trick play frame, then take the duration of this
@@ -159,12 +196,19 @@ Status TrickPlayHandler::OnMediaSample(const MediaSample& sample) {
 Status TrickPlayHandler::OnTrickFrame(const MediaSample& sample) {
   total_trick_frames_++;
 
-  // Make a message we can store until later.
+  // Make a message we can store until later. Clone() shares the frame's
+  // payload with the other trick play branches through the refcounted data
+  // buffer; only the sample header is duplicated so this branch can extend
+  // the frame's duration over the frames it drops. Memory is therefore
+  // bounded by the retained key frames themselves, no matter how many
+  // trick play factors fan out from the replicator.
   previous_trick_frame_ = sample.Clone();
 
-  // Add the message to our queue so that it will be ready to go out.
-  delayed_messages_.push_back(
-      StreamData::FromMediaSample(kStreamIndexOut, previous_trick_frame_));
+  // Add the message to our queue so that it will be ready to go out. The
+  // queue never spills its newest entry, so |previous_trick_frame_|'s
+  // duration can still be extended until the next frame is queued.
+  RETURN_IF_ERROR(delayed_messages_.PushBack(
+      StreamData::FromMediaSample(kStreamIndexOut, previous_trick_frame_)));
 
   // We need two trick play frames before we can send out our stream info, so we
   // cannot send this media sample until after we send our sample info
@@ -188,8 +232,10 @@ Status TrickPlayHandler::OnTrickFrame(const MediaSample& sample) {
   // added.
   Status s;
   while (s.ok() && delayed_messages_.size() > 1) {
-    s.Update(Dispatch(std::move(delayed_messages_.front())));
-    delayed_messages_.pop_front();
+    std::unique_ptr<StreamData> message;
+    s.Update(delayed_messages_.PopFront(&message));
+    if (s.ok())
+      s.Update(Dispatch(std::move(message)));
   }
   return s;
 }
@@ -7,9 +7,12 @@
 #ifndef PACKAGER_MEDIA_BASE_TRICK_PLAY_HANDLER_H_
 #define PACKAGER_MEDIA_BASE_TRICK_PLAY_HANDLER_H_
 
-#include <list>
+#include <memory>
+#include <string>
 
 #include <packager/media/base/media_handler.h>
+#include <packager/media/base/memory_tracker.h>
+#include <packager/media/base/sample_spill_queue.h>
 
 namespace shaka {
 namespace media {
@@ -24,6 +27,20 @@ class VideoStreamInfo;
 class TrickPlayHandler : public MediaHandler {
  public:
   explicit TrickPlayHandler(uint32_t factor);
+  /// As above, but with the delayed message payloads capped: frames beyond
+  /// @a spill_memory_bytes are spilled to a temporary file in
+  /// @a spill_temp_dir and read back on dispatch.
+  TrickPlayHandler(uint32_t factor,
+                   const std::string& spill_temp_dir,
+                   uint64_t spill_memory_bytes);
+  /// As above, but additionally registers the buffered payload bytes with
+  /// @a memory_tracker (the owning job's accounting, may be null); under
+  /// job-level memory pressure the queue spills regardless of
+  /// @a spill_memory_bytes.
+  TrickPlayHandler(uint32_t factor,
+                   const std::string& spill_temp_dir,
+                   uint64_t spill_memory_bytes,
+                   std::shared_ptr<MemoryTracker> memory_tracker);
 
  private:
   TrickPlayHandler(const TrickPlayHandler&) = delete;
@@ -64,8 +81,19 @@ class TrickPlayHandler : public MediaHandler {
   // messages that need to be sent down. At the start, we use this to queue
   // messages until we can send out |video_info_|. To ensure messages are
   // kept in order, messages are only dispatched through this queue and never
-  // directly.
-  std::list<std::unique_ptr<StreamData>> delayed_messages_;
+  // directly. Frame payloads beyond the configured spill budget live in a
+  // temporary file instead of memory; the newest entry is never spilled, so
+  // |previous_trick_frame_|'s duration can still be extended after it is
+  // queued.
+  SampleSpillQueue delayed_messages_;
+
+  // Spill configuration for |delayed_messages_|; a zero byte budget keeps
+  // all payloads in memory.
+  std::string spill_temp_dir_;
+  uint64_t spill_memory_bytes_ = 0;
+  // Job-level memory accounting shared with |delayed_messages_|; may be
+  // null.
+  std::shared_ptr<MemoryTracker> memory_tracker_;
 };
 
 }  // namespace media
@@ -176,7 +176,7 @@ AdaptationSet::AdaptationSet(const std::string& language,
                              const MpdOptions& mpd_options,
                              uint32_t* counter)
     : representation_counter_(counter),
-      language_(language),
+      language_(InternString(language)),
       mpd_options_(mpd_options) {
   DCHECK(counter);
 }
@@ -224,21 +224,47 @@ void AdaptationSet::AddContentProtectionElement(
     const ContentProtectionElement& content_protection_element) {
   content_protection_elements_.push_back(content_protection_element);
   RemoveDuplicateAttributes(&content_protection_elements_.back());
+  xml_dirty_ = true;
 }
 
 void AdaptationSet::UpdateContentProtectionPssh(const std::string& drm_uuid,
                                                 const std::string& pssh) {
   UpdateContentProtectionPsshHelper(drm_uuid, pssh,
                                     &content_protection_elements_);
+  xml_dirty_ = true;
 }
 
 void AdaptationSet::AddAccessibility(const std::string& scheme,
                                      const std::string& value) {
   accessibilities_.push_back(Accessibility{scheme, value});
+  xml_dirty_ = true;
 }
 
 void AdaptationSet::AddRole(Role role) {
   roles_.insert(role);
+  xml_dirty_ = true;
+}
+
+bool AdaptationSet::CanReuseXml() const {
+  if (xml_dirty_ || !cached_xml_.has_value() ||
+      !trick_play_references_.empty() || !switchable_adaptation_sets_.empty()) {
+    return false;
+  }
+  // Mirrors the suppression flags computed in GetXml(); a change in any of
+  // these sets also marks the subtree dirty, but the flags are cheap to
+  // recompute and keep this check self-contained.
+  int suppression_flags = 0;
+  if (video_widths_.size() == 1)
+    suppression_flags |= Representation::kSuppressWidth;
+  if (video_heights_.size() == 1)
+    suppression_flags |= Representation::kSuppressHeight;
+  if (video_frame_rates_.size() == 1)
+    suppression_flags |= Representation::kSuppressFrameRate;
+  for (const auto& representation_pair : representation_map_) {
+    if (!representation_pair.second->CanReuseXml(suppression_flags))
+      return false;
+  }
+  return true;
 }
 
 // Creates a copy of <AdaptationSet> xml element, iterate thru all the
@@ -248,14 +274,34 @@ void AdaptationSet::AddRole(Role role) {
 // example, if AdaptationSet@width is set, then Representation@width is
 // redundant and should not be set.
 std::optional<xml::XmlNode> AdaptationSet::GetXml() {
-  xml::AdaptationSetXmlNode adaptation_set;
-
-  bool suppress_representation_width = false;
-  bool suppress_representation_height = false;
-  bool suppress_representation_frame_rate = false;
+  // Note that std::{set,map} are ordered, so the last element is the max
+  // value. These also determine which attributes are suppressed on the child
+  // Representations, so they are computed up front.
+  const bool suppress_representation_width = video_widths_.size() == 1;
+  const bool suppress_representation_height = video_heights_.size() == 1;
+  const bool suppress_representation_frame_rate =
+      video_frame_rates_.size() == 1;
+
+  int suppression_flags = 0;
+  if (suppress_representation_width)
+    suppression_flags |= Representation::kSuppressWidth;
+  if (suppress_representation_height)
+    suppression_flags |= Representation::kSuppressHeight;
+  if (suppress_representation_frame_rate)
+    suppression_flags |= Representation::kSuppressFrameRate;
 
   if (index_.has_value())
     id_ = index_.value();
+
+  // Serve a copy of the cached subtree when neither this AdaptationSet nor
+  // any of its Representations changed since the last build. Sets that
+  // reference other AdaptationSets are always rebuilt, since the referenced
+  // ids may change without this set being notified.
+  if (CanReuseXml())
+    return cached_xml_->Clone();
+
+  xml::AdaptationSetXmlNode adaptation_set;
+
   if (id_ && !adaptation_set.SetId(id_.value()))
     return std::nullopt;
   if (!adaptation_set.SetStringAttribute("contentType", content_type_))
@@ -265,9 +311,7 @@ std::optional<xml::XmlNode> AdaptationSet::GetXml() {
     return std::nullopt;
   }
 
-  // Note that std::{set,map} are ordered, so the last element is the max value.
-  if (video_widths_.size() == 1) {
-    suppress_representation_width = true;
+  if (suppress_representation_width) {
     if (!adaptation_set.SetIntegerAttribute("width", *video_widths_.begin()))
       return std::nullopt;
   } else if (video_widths_.size() > 1) {
@@ -277,8 +321,7 @@ std::optional<xml::XmlNode> AdaptationSet::GetXml() {
     }
   }
 
-  if (video_heights_.size() == 1) {
-    suppress_representation_height = true;
+  if (suppress_representation_height) {
     if (!adaptation_set.SetIntegerAttribute("height", *video_heights_.begin()))
       return std::nullopt;
   } else if (video_heights_.size() > 1) {
@@ -297,8 +340,7 @@ std::optional<xml::XmlNode> AdaptationSet::GetXml() {
       return std::nullopt;
   }
 
-  if (video_frame_rates_.size() == 1) {
-    suppress_representation_frame_rate = true;
+  if (suppress_representation_frame_rate) {
     if (!adaptation_set.SetStringAttribute(
             "frameRate", video_frame_rates_.begin()->second)) {
       return std::nullopt;
@@ -408,6 +450,13 @@ std::optional<xml::XmlNode> AdaptationSet::GetXml() {
       return std::nullopt;
   }
 
+  // Only cache subtrees that do not reference other AdaptationSets; see the
+  // cache check above.
+  if (trick_play_references_.empty() && switchable_adaptation_sets_.empty()) {
+    cached_xml_ = adaptation_set.Clone();
+    xml_dirty_ = false;
+  }
+
   return adaptation_set;
 }
 
@@ -415,19 +464,23 @@ void AdaptationSet::ForceSetSegmentAlignment(bool segment_alignment) {
   segments_aligned_ =
       segment_alignment ? kSegmentAlignmentTrue : kSegmentAlignmentFalse;
   force_set_segment_alignment_ = true;
+  xml_dirty_ = true;
 }
 
 void AdaptationSet::AddAdaptationSetSwitching(
     const AdaptationSet* adaptation_set) {
   switchable_adaptation_sets_.push_back(adaptation_set);
+  xml_dirty_ = true;
 }
 
 void AdaptationSet::ForceSubsegmentStartswithSAP(uint32_t sap_value) {
   subsegment_start_with_sap_ = sap_value;
+  xml_dirty_ = true;
 }
 
 void AdaptationSet::ForceStartwithSAP(uint32_t sap_value) {
   start_with_sap_ = sap_value;
+  xml_dirty_ = true;
 }
 
 // For dynamic MPD, storing all start_time and duration will out-of-memory
@@ -439,12 +492,18 @@ void AdaptationSet::ForceStartwithSAP(uint32_t sap_value) {
 void AdaptationSet::OnNewSegmentForRepresentation(uint32_t representation_id,
                                                   int64_t start_time,
                                                   int64_t duration) {
+  // The set-level XML only depends on |segments_aligned_|, so only invalidate
+  // the cached subtree when the alignment status actually changes; the
+  // Representation that got the segment tracks its own dirtiness.
+  const SegmentAligmentStatus old_status = segments_aligned_;
   if (mpd_options_.mpd_type == MpdType::kDynamic) {
     CheckDynamicSegmentAlignment(representation_id, start_time, duration);
   } else {
     representation_segment_start_times_[representation_id].push_back(
         start_time);
   }
+  if (segments_aligned_ != old_status)
+    xml_dirty_ = true;
 }
 
 void AdaptationSet::OnSetFrameRateForRepresentation(uint32_t representation_id,
@@ -455,6 +514,7 @@ void AdaptationSet::OnSetFrameRateForRepresentation(uint32_t representation_id,
 
 void AdaptationSet::AddTrickPlayReference(const AdaptationSet* adaptation_set) {
   trick_play_references_.push_back(adaptation_set);
+  xml_dirty_ = true;
 }
 
 const std::list<Representation*> AdaptationSet::GetRepresentations() const {
@@ -510,6 +570,8 @@ void AdaptationSet::UpdateFromMediaInfo(const MediaInfo& media_info) {
       roles_.insert(MediaInfoTextTypeToRole(media_info.text_info().type()));
     }
   }
+
+  xml_dirty_ = true;
 }
 
 // This implementation assumes that each representations' segments' are
@@ -651,6 +713,7 @@ void AdaptationSet::RecordFrameRate(int32_t frame_duration, int32_t timescale) {
   }
   video_frame_rates_[static_cast<double>(timescale) / frame_duration] =
       absl::StrFormat("%d/%d", timescale, frame_duration);
+  xml_dirty_ = true;
 }
 
 }  // namespace shaka
@@ -18,6 +18,7 @@
 #include <vector>
 
 #include <packager/mpd/base/xml/xml_node.h>
+#include <packager/utils/string_interner.h>
 
 namespace shaka {
 
@@ -111,6 +112,12 @@ class AdaptationSet {
   ///         NULL scoped_xml_ptr.
   std::optional<xml::XmlNode> GetXml();
 
+  /// @return true if GetXml() would serve a copy of the cached subtree, i.e.
+  ///         neither this AdaptationSet nor any of its Representations
+  ///         changed since the last build. Used by Period to decide whether
+  ///         its own cached element is still valid.
+  bool CanReuseXml() const;
+
   /// Forces the (sub)segmentAlignment field to be set to @a segment_alignment.
   /// Use this if you are certain that the (sub)segments are alinged/unaligned
   /// for the AdaptationSet.
@@ -141,7 +148,10 @@ class AdaptationSet {
 
   /// Set AdaptationSet@id.
   /// @param id is the new ID to be set.
-  void set_id(uint32_t id) { id_ = id; }
+  void set_id(uint32_t id) {
+    id_ = id;
+    xml_dirty_ = true;
+  }
 
   /// Notifies the AdaptationSet instance that a new (sub)segment was added to
   /// the Representation with @a representation_id.
@@ -185,11 +195,11 @@ class AdaptationSet {
   bool IsVideo() const;
 
   /// @return codec.
-  const std::string& codec() const { return codec_; }
+  const std::string& codec() const { return *codec_; }
 
   /// Set AdaptationSet@codec.
   /// @param codec is the new codec to be set.
-  void set_codec(const std::string& codec) { codec_ = codec; };
+  void set_codec(const std::string& codec) { codec_ = &InternString(codec); };
 
   /// @return transfer_characteristics.
   uint32_t transfer_characteristics() const {
@@ -200,6 +210,7 @@ class AdaptationSet {
   /// @param transfer_characteristics is the video transfer characteristics.
   void set_transfer_characteristics(const uint32_t& transfer_characteristics) {
     transfer_characteristics_ = transfer_characteristics;
+    xml_dirty_ = true;
   };
 
  protected:
@@ -271,7 +282,9 @@ class AdaptationSet {
   uint32_t* const representation_counter_;
 
   std::optional<uint32_t> id_;
-  const std::string language_;
+  // Interned (see InternString()); one canonical copy is shared across all
+  // adaptation sets and streams with the same language.
+  const std::string& language_;
   const MpdOptions& mpd_options_;
 
   // An array of adaptation sets this adaptation set can switch to.
@@ -295,8 +308,8 @@ class AdaptationSet {
   // Determined by examining the MediaInfo passed to AddRepresentation().
   std::string content_type_;
 
-  // Codec of AdaptationSet.
-  std::string codec_;
+  // Codec of AdaptationSet. Interned; see InternString().
+  const std::string* codec_ = &InternString("");
 
   // This does not have to be a set, it could be a list or vector because all we
   // really care is whether there is more than one entry.
@@ -351,6 +364,12 @@ class AdaptationSet {
 
   // The label of this AdaptationSet.
   std::string label_;
+
+  // Dirty tracking for the cached XML subtree. GetXml() serves a copy of
+  // |cached_xml_| as long as neither this AdaptationSet nor any of its
+  // Representations changed since the cache was built.
+  bool xml_dirty_ = true;
+  std::optional<xml::XmlNode> cached_xml_;
 };
 
 }  // namespace shaka
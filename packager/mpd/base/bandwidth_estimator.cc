@@ -10,14 +10,26 @@
 #include <cmath>
 #include <numeric>
 
+#include <absl/flags/flag.h>
 #include <absl/log/check.h>
 #include <absl/log/log.h>
 
 #include <packager/macros/logging.h>
 
+ABSL_FLAG(double,
+          advertised_bandwidth_percentile,
+          0,
+          "If set to a value in (0, 100), the bandwidth advertised in the "
+          "manifest is the approximate percentile of the per-block bitrates "
+          "instead of the maximum, e.g. 95 advertises p95, which is less "
+          "sensitive to a single outlier segment. 0 (the default) keeps the "
+          "maximum.");
+
 namespace shaka {
 
-BandwidthEstimator::BandwidthEstimator() = default;
+BandwidthEstimator::BandwidthEstimator()
+    : percentile_(absl::GetFlag(FLAGS_advertised_bandwidth_percentile)),
+      bitrate_quantile_(percentile_ / 100) {}
 
 BandwidthEstimator::~BandwidthEstimator() = default;
 
@@ -44,13 +56,18 @@ void BandwidthEstimator::AddBlock(uint64_t size_in_bytes, double duration) {
     // to filter small blocks from bandwidth calculation.
     target_block_duration_ = GetAverageBlockDuration();
     for (const Block& block : initial_blocks_) {
-      max_bitrate_ =
-          std::max(max_bitrate_, GetBitrate(block, target_block_duration_));
+      const uint64_t bitrate = GetBitrate(block, target_block_duration_);
+      max_bitrate_ = std::max(max_bitrate_, bitrate);
+      if (percentile_ > 0 && bitrate > 0)
+        bitrate_quantile_.Add(static_cast<double>(bitrate));
     }
     return;
   }
-  max_bitrate_ = std::max(max_bitrate_, GetBitrate({size_in_bits, duration},
-                                                   target_block_duration_));
+  const uint64_t bitrate =
+      GetBitrate({size_in_bits, duration}, target_block_duration_);
+  max_bitrate_ = std::max(max_bitrate_, bitrate);
+  if (percentile_ > 0 && bitrate > 0)
+    bitrate_quantile_.Add(static_cast<double>(bitrate));
 }
 
 uint64_t BandwidthEstimator::Estimate() const {
@@ -77,6 +94,15 @@ uint64_t BandwidthEstimator::Max() const {
   return max_bitrate;
 }
 
+uint64_t BandwidthEstimator::Percentile() const {
+  if (percentile_ <= 0 || percentile_ >= 100)
+    return Max();
+  const double estimate = bitrate_quantile_.Get();
+  if (estimate <= 0)
+    return Max();
+  return static_cast<uint64_t>(ceil(estimate));
+}
+
 double BandwidthEstimator::GetAverageBlockDuration() const {
   if (initial_blocks_.empty())
     return 0.0;
@@ -114,4 +140,93 @@ uint64_t BandwidthEstimator::GetBitrate(const Block& block,
   return static_cast<uint64_t>(ceil(block.size_in_bits / block.duration));
 }
 
+BandwidthEstimator::P2QuantileEstimator::P2QuantileEstimator(double quantile)
+    : quantile_(quantile),
+      desired_increments_{0, quantile / 2, quantile, (1 + quantile) / 2, 1} {}
+
+void BandwidthEstimator::P2QuantileEstimator::Add(double value) {
+  // The algorithm needs five observations to initialize its markers; until
+  // then just collect them.
+  if (count_ < 5) {
+    heights_[count_] = value;
+    ++count_;
+    if (count_ == 5) {
+      std::sort(heights_, heights_ + 5);
+      for (size_t i = 0; i < 5; ++i)
+        positions_[i] = static_cast<double>(i + 1);
+      desired_positions_[0] = 1;
+      desired_positions_[1] = 1 + 2 * quantile_;
+      desired_positions_[2] = 1 + 4 * quantile_;
+      desired_positions_[3] = 3 + 2 * quantile_;
+      desired_positions_[4] = 5;
+    }
+    return;
+  }
+
+  // Find the cell the new observation falls into, adjusting the extreme
+  // markers if it falls outside the current range.
+  size_t cell;
+  if (value < heights_[0]) {
+    heights_[0] = value;
+    cell = 0;
+  } else if (value >= heights_[4]) {
+    heights_[4] = value;
+    cell = 3;
+  } else {
+    cell = 0;
+    while (value >= heights_[cell + 1])
+      ++cell;
+  }
+  ++count_;
+
+  for (size_t i = cell + 1; i < 5; ++i)
+    ++positions_[i];
+  for (size_t i = 0; i < 5; ++i)
+    desired_positions_[i] += desired_increments_[i];
+
+  // Move the middle markers toward their desired positions, using a
+  // piecewise-parabolic height prediction and falling back to linear
+  // interpolation when the parabola would break marker ordering.
+  for (size_t i = 1; i <= 3; ++i) {
+    const double delta = desired_positions_[i] - positions_[i];
+    const double gap_above = positions_[i + 1] - positions_[i];
+    const double gap_below = positions_[i - 1] - positions_[i];
+    if ((delta >= 1 && gap_above > 1) || (delta <= -1 && gap_below < -1)) {
+      const double direction = delta >= 1 ? 1 : -1;
+      const double parabolic =
+          heights_[i] +
+          direction / (gap_above - gap_below) *
+              ((direction - gap_below) * (heights_[i + 1] - heights_[i]) /
+                   gap_above +
+               (gap_above - direction) * (heights_[i] - heights_[i - 1]) /
+                   -gap_below);
+      if (heights_[i - 1] < parabolic && parabolic < heights_[i + 1]) {
+        heights_[i] = parabolic;
+      } else {
+        const size_t neighbor = direction > 0 ? i + 1 : i - 1;
+        heights_[i] += direction * (heights_[neighbor] - heights_[i]) /
+                       (positions_[neighbor] - positions_[i]);
+      }
+      positions_[i] += direction;
+    }
+  }
+}
+
+double BandwidthEstimator::P2QuantileEstimator::Get() const {
+  if (count_ == 0)
+    return 0;
+  if (count_ >= 5)
+    return heights_[2];
+
+  // Not enough observations for the marker-based estimate; fall back to the
+  // exact quantile of the values collected so far.
+  double sorted[5];
+  std::copy(heights_, heights_ + count_, sorted);
+  std::sort(sorted, sorted + count_);
+  const size_t index = std::min(
+      count_ - 1, static_cast<size_t>(ceil(quantile_ * count_)) -
+                      (quantile_ > 0 ? 1 : 0));
+  return sorted[index];
+}
+
 }  // namespace shaka
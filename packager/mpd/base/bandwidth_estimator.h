@@ -33,6 +33,12 @@ class BandwidthEstimator {
   ///         |target_block_duration| are not counted.
   uint64_t Max() const;
 
+  /// @return The approximate block bitrate percentile configured with
+  ///         --advertised_bandwidth_percentile, in bits per second, rounded up
+  ///         to the nearest integer. Returns Max() when the percentile mode is
+  ///         disabled (the default) or when there are no usable blocks yet.
+  uint64_t Percentile() const;
+
  private:
   BandwidthEstimator(const BandwidthEstimator&) = delete;
   BandwidthEstimator& operator=(const BandwidthEstimator&) = delete;
@@ -41,6 +47,27 @@ class BandwidthEstimator {
     uint64_t size_in_bits;
     double duration;
   };
+
+  // Streaming quantile estimator using the P-squared algorithm (Jain &
+  // Chlamtac, 1985). Tracks five markers and updates them in constant time
+  // and constant space per observation, so no per-block history is kept.
+  class P2QuantileEstimator {
+   public:
+    explicit P2QuantileEstimator(double quantile);
+
+    void Add(double value);
+
+    // Returns the current quantile estimate, or 0 if no value has been added.
+    double Get() const;
+
+   private:
+    const double quantile_;
+    size_t count_ = 0;
+    double heights_[5] = {};
+    double positions_[5] = {};
+    double desired_positions_[5] = {};
+    double desired_increments_[5] = {};
+  };
   // Return the average block duration of the blocks in |initial_blocks_|.
   double GetAverageBlockDuration() const;
   // Return the bitrate of the block. Note that a bitrate of 0 is returned if
@@ -55,6 +82,10 @@ class BandwidthEstimator {
   uint64_t total_size_in_bits_ = 0;
   double total_duration_ = 0;
   uint64_t max_bitrate_ = 0;
+
+  // 0 disables the percentile mode. See --advertised_bandwidth_percentile.
+  const double percentile_;
+  P2QuantileEstimator bitrate_quantile_;
 };
 
 }  // namespace shaka
@@ -6,8 +6,12 @@
 
 #include <packager/mpd/base/bandwidth_estimator.h>
 
+#include <absl/flags/declare.h>
+#include <absl/flags/flag.h>
 #include <gtest/gtest.h>
 
+ABSL_DECLARE_FLAG(double, advertised_bandwidth_percentile);
+
 namespace shaka {
 
 namespace {
@@ -63,4 +67,39 @@ TEST(BandwidthEstimatorTest, ExcludeShortBlocksMore) {
   EXPECT_EQ(kExpectedMax, be.Max());
 }
 
+TEST(BandwidthEstimatorTest, PercentileDisabledReturnsMax) {
+  const double kDuration = 1.0;
+  BandwidthEstimator be;
+  for (uint64_t i = 1; i <= 100; ++i)
+    be.AddBlock(i, kDuration);
+  EXPECT_EQ(be.Max(), be.Percentile());
+}
+
+TEST(BandwidthEstimatorTest, PercentileConstantBitrate) {
+  absl::SetFlag(&FLAGS_advertised_bandwidth_percentile, 95);
+  const double kDuration = 1.0;
+  BandwidthEstimator be;
+  for (int i = 0; i < 100; ++i)
+    be.AddBlock(100, kDuration);
+  EXPECT_EQ(100 * kBitsInByte, be.Percentile());
+  absl::SetFlag(&FLAGS_advertised_bandwidth_percentile, 0);
+}
+
+TEST(BandwidthEstimatorTest, PercentileIgnoresOutlier) {
+  absl::SetFlag(&FLAGS_advertised_bandwidth_percentile, 95);
+  const double kDuration = 1.0;
+  BandwidthEstimator be;
+  // 99 blocks at 800 bps with one 100x outlier in the middle. p95 should stay
+  // close to 800 bps while the max is dominated by the outlier.
+  for (int i = 0; i < 50; ++i)
+    be.AddBlock(100, kDuration);
+  be.AddBlock(10000, kDuration);
+  for (int i = 0; i < 49; ++i)
+    be.AddBlock(100, kDuration);
+  EXPECT_EQ(10000 * kBitsInByte, be.Max());
+  EXPECT_GE(be.Percentile(), 100 * kBitsInByte);
+  EXPECT_LT(be.Percentile(), be.Max() / 10);
+  absl::SetFlag(&FLAGS_advertised_bandwidth_percentile, 0);
+}
+
 } // namespace shaka
@@ -0,0 +1,124 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/mpd/base/manifest_delta_log.h>
+
+#include <vector>
+
+#include <absl/log/log.h>
+
+#include <packager/file.h>
+
+namespace shaka {
+namespace {
+
+const uint8_t kDeltaLogMagic[] = {'S', 'H', 'K', 'M', 'F', 'D', '0', '1'};
+
+// A snapshot is written at least this often so a new consumer never has to
+// scan far to find a bootstrap point.
+const uint32_t kRecordsPerSnapshot = 256;
+
+void AppendUInt32(uint32_t v, std::vector<uint8_t>* out) {
+  for (int i = 0; i < 4; ++i)
+    out->push_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+void AppendUInt64(uint64_t v, std::vector<uint8_t>* out) {
+  for (int i = 0; i < 8; ++i)
+    out->push_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+}  // namespace
+
+ManifestDeltaLog::ManifestDeltaLog(const std::string& manifest_path)
+    : manifest_path_(manifest_path), log_path_(manifest_path + ".delta") {}
+
+ManifestDeltaLog::~ManifestDeltaLog() {
+  if (log_file_) {
+    log_file_->Close();
+    log_file_ = nullptr;
+  }
+}
+
+void ManifestDeltaLog::OnStreamAdded(uint32_t stream_id) {
+  std::vector<uint8_t> record;
+  record.push_back(kStreamAdded);
+  AppendUInt32(stream_id, &record);
+  WriteRecord(record.data(), record.size());
+}
+
+void ManifestDeltaLog::OnSegmentAdded(uint32_t stream_id,
+                                      int64_t start_time,
+                                      int64_t duration,
+                                      uint64_t size) {
+  std::vector<uint8_t> record;
+  record.push_back(kSegmentAdded);
+  AppendUInt32(stream_id, &record);
+  AppendUInt64(static_cast<uint64_t>(start_time), &record);
+  AppendUInt64(static_cast<uint64_t>(duration), &record);
+  AppendUInt64(size, &record);
+  WriteRecord(record.data(), record.size());
+}
+
+void ManifestDeltaLog::OnKeyRotated(uint32_t stream_id) {
+  std::vector<uint8_t> record;
+  record.push_back(kKeyRotated);
+  AppendUInt32(stream_id, &record);
+  WriteRecord(record.data(), record.size());
+}
+
+void ManifestDeltaLog::OnManifestWritten() {
+  WriteSnapshot();
+  if (log_file_)
+    log_file_->Flush();
+}
+
+void ManifestDeltaLog::WriteSnapshot() {
+  // Reset first: the snapshot itself goes through WriteRecord and must not
+  // re-trigger the snapshot cadence.
+  records_since_snapshot_ = 0;
+  std::vector<uint8_t> record;
+  record.push_back(kSnapshot);
+  AppendUInt32(0, &record);  // Snapshots are not tied to a stream.
+  AppendUInt32(static_cast<uint32_t>(manifest_path_.size()), &record);
+  record.insert(record.end(), manifest_path_.begin(), manifest_path_.end());
+  WriteRecord(record.data(), record.size());
+}
+
+void ManifestDeltaLog::WriteRecord(const uint8_t* record, size_t size) {
+  if (failed_)
+    return;
+
+  if (!log_file_) {
+    log_file_ = File::Open(log_path_.c_str(), "w");
+    if (!log_file_ ||
+        log_file_->Write(kDeltaLogMagic, sizeof(kDeltaLogMagic)) !=
+            static_cast<int64_t>(sizeof(kDeltaLogMagic))) {
+      LOG(ERROR) << "Failed to start manifest delta log " << log_path_
+                 << "; the delta feed is disabled for this run.";
+      if (log_file_) {
+        log_file_->Close();
+        log_file_ = nullptr;
+      }
+      failed_ = true;
+      return;
+    }
+  }
+
+  if (log_file_->Write(record, size) != static_cast<int64_t>(size)) {
+    LOG(ERROR) << "Failed to write to manifest delta log " << log_path_
+               << "; abandoning the delta feed.";
+    log_file_->Close();
+    log_file_ = nullptr;
+    failed_ = true;
+    return;
+  }
+
+  if (++records_since_snapshot_ >= kRecordsPerSnapshot)
+    WriteSnapshot();
+}
+
+}  // namespace shaka
@@ -0,0 +1,84 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_MPD_BASE_MANIFEST_DELTA_LOG_H_
+#define PACKAGER_MPD_BASE_MANIFEST_DELTA_LOG_H_
+
+#include <cstdint>
+#include <string>
+
+namespace shaka {
+
+class File;
+
+/// An append-only binary feed of manifest changes, written next to a text
+/// manifest (DASH MPD or HLS playlist) as "<manifest path>.delta". Each
+/// notifier event becomes one compact record, so a downstream consumer (e.g.
+/// a CDN edge) learns about a new segment or a key rotation from O(change)
+/// bytes instead of re-parsing the full manifest text.
+///
+/// The file starts with an 8 byte magic ("SHKMFD01") followed by records of
+/// the form: 1 byte type, 4 byte stream id, then a type-specific payload,
+/// all fixed-width fields little endian. A snapshot record carrying the
+/// manifest path is written periodically and on every Flush(); it marks a
+/// point where the text manifest is consistent with the log, so consumers
+/// can bootstrap (or reconcile window trims) from the manifest there and
+/// then follow the log.
+///
+/// Write failures disable the log with an error; manifest generation itself
+/// is never affected. Callers serialize access (the notifiers call under
+/// their own lock).
+class ManifestDeltaLog {
+ public:
+  /// Record types, also part of the on-disk format.
+  enum RecordType : uint8_t {
+    kStreamAdded = 0,
+    kSegmentAdded = 1,
+    kKeyRotated = 2,
+    kSnapshot = 3,
+  };
+
+  /// @param manifest_path is the path of the manifest this log shadows. The
+  ///        log is written to "<manifest path>.delta", created lazily on the
+  ///        first record.
+  explicit ManifestDeltaLog(const std::string& manifest_path);
+  ~ManifestDeltaLog();
+
+  ManifestDeltaLog(const ManifestDeltaLog&) = delete;
+  ManifestDeltaLog& operator=(const ManifestDeltaLog&) = delete;
+
+  /// Records that a stream (representation / playlist) was added.
+  void OnStreamAdded(uint32_t stream_id);
+  /// Records a new segment. Times are in the stream's time scale.
+  void OnSegmentAdded(uint32_t stream_id,
+                      int64_t start_time,
+                      int64_t duration,
+                      uint64_t size);
+  /// Records a key rotation on the stream.
+  void OnKeyRotated(uint32_t stream_id);
+  /// Writes a snapshot record and flushes the log. Call after the text
+  /// manifest has been written so the snapshot marks a consistent point.
+  void OnManifestWritten();
+
+ private:
+  // Appends |size| bytes to the log, opening it first if needed. On failure
+  // the log is closed and further records are dropped.
+  void WriteRecord(const uint8_t* record, size_t size);
+  void WriteSnapshot();
+
+  const std::string manifest_path_;
+  const std::string log_path_;
+  File* log_file_ = nullptr;  // Owned.
+  // Once a write fails the log is abandoned; manifests are unaffected.
+  bool failed_ = false;
+  // Records since the last snapshot, to bound how far a new consumer has to
+  // scan back.
+  uint32_t records_since_snapshot_ = 0;
+};
+
+}  // namespace shaka
+
+#endif  // PACKAGER_MPD_BASE_MANIFEST_DELTA_LOG_H_
@@ -0,0 +1,114 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/mpd/base/manifest_delta_log.h>
+
+#include <cstdint>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <packager/file.h>
+
+namespace shaka {
+namespace {
+
+const char kManifestPath[] = "memory://test/output.mpd";
+const char kDeltaLogPath[] = "memory://test/output.mpd.delta";
+const size_t kMagicSize = 8;
+
+uint32_t ReadUInt32(const std::string& data, size_t offset) {
+  uint32_t v = 0;
+  for (int i = 3; i >= 0; --i)
+    v = (v << 8) | static_cast<uint8_t>(data[offset + i]);
+  return v;
+}
+
+uint64_t ReadUInt64(const std::string& data, size_t offset) {
+  uint64_t v = 0;
+  for (int i = 7; i >= 0; --i)
+    v = (v << 8) | static_cast<uint8_t>(data[offset + i]);
+  return v;
+}
+
+}  // namespace
+
+class ManifestDeltaLogTest : public ::testing::Test {
+ protected:
+  void TearDown() override { File::Delete(kDeltaLogPath); }
+
+  std::string ReadLog() {
+    std::string data;
+    EXPECT_TRUE(File::ReadFileToString(kDeltaLogPath, &data));
+    return data;
+  }
+};
+
+TEST_F(ManifestDeltaLogTest, NoRecordsNoFile) {
+  { ManifestDeltaLog log(kManifestPath); }
+  std::string data;
+  EXPECT_FALSE(File::ReadFileToString(kDeltaLogPath, &data));
+}
+
+TEST_F(ManifestDeltaLogTest, WritesMagicAndRecords) {
+  {
+    // MemoryFile does not allow concurrent open; scope the log so the file is
+    // closed before it is read back.
+    ManifestDeltaLog log(kManifestPath);
+    log.OnStreamAdded(7);
+    log.OnSegmentAdded(7, 90000, 180000, 123456);
+    log.OnKeyRotated(7);
+    log.OnManifestWritten();
+  }
+
+  const std::string data = ReadLog();
+  ASSERT_GE(data.size(), kMagicSize);
+  EXPECT_EQ("SHKMFD01", data.substr(0, kMagicSize));
+
+  // kStreamAdded: type + stream id.
+  size_t offset = kMagicSize;
+  EXPECT_EQ(ManifestDeltaLog::kStreamAdded, data[offset]);
+  EXPECT_EQ(7u, ReadUInt32(data, offset + 1));
+  offset += 1 + 4;
+
+  // kSegmentAdded: type + stream id + start time + duration + size.
+  EXPECT_EQ(ManifestDeltaLog::kSegmentAdded, data[offset]);
+  EXPECT_EQ(7u, ReadUInt32(data, offset + 1));
+  EXPECT_EQ(90000u, ReadUInt64(data, offset + 5));
+  EXPECT_EQ(180000u, ReadUInt64(data, offset + 13));
+  EXPECT_EQ(123456u, ReadUInt64(data, offset + 21));
+  offset += 1 + 4 + 8 + 8 + 8;
+
+  // kKeyRotated: type + stream id.
+  EXPECT_EQ(ManifestDeltaLog::kKeyRotated, data[offset]);
+  EXPECT_EQ(7u, ReadUInt32(data, offset + 1));
+  offset += 1 + 4;
+
+  // The snapshot from OnManifestWritten: type + stream id (0) + path.
+  EXPECT_EQ(ManifestDeltaLog::kSnapshot, data[offset]);
+  EXPECT_EQ(0u, ReadUInt32(data, offset + 1));
+  const uint32_t path_size = ReadUInt32(data, offset + 5);
+  EXPECT_EQ(kManifestPath, data.substr(offset + 9, path_size));
+  EXPECT_EQ(offset + 9 + path_size, data.size());
+}
+
+TEST_F(ManifestDeltaLogTest, PeriodicSnapshot) {
+  {
+    ManifestDeltaLog log(kManifestPath);
+    // Enough records to cross the snapshot cadence (256) without an explicit
+    // OnManifestWritten().
+    for (uint32_t i = 0; i < 300; ++i)
+      log.OnKeyRotated(i);
+  }
+
+  const std::string data = ReadLog();
+  const std::string snapshot_marker(1, ManifestDeltaLog::kSnapshot);
+  EXPECT_NE(std::string::npos,
+            data.find(snapshot_marker + std::string(4, '\0') +
+                      std::string(1, sizeof(kManifestPath) - 1)));
+}
+
+}  // namespace shaka
@@ -10,6 +10,7 @@
 #include <chrono>
 #include <filesystem>
 #include <optional>
+#include <vector>
 
 #include <absl/log/check.h>
 #include <absl/log/log.h>
@@ -18,6 +19,7 @@
 #include <absl/synchronization/mutex.h>
 
 #include <packager/file/file_util.h>
+#include <packager/file/thread_pool.h>
 #include <packager/macros/classes.h>
 #include <packager/macros/logging.h>
 #include <packager/media/base/rcheck.h>
@@ -182,8 +184,37 @@ std::optional<xml::XmlNode> MpdBuilder::GenerateMpd() {
     output_period_duration = periods_.size() > 1;
   }
 
-  for (const auto& period : periods_) {
-    auto period_node = period->GetXml(output_period_duration);
+  // Periods are independent subtrees, so serialize them concurrently into
+  // per-period nodes and stitch the results in order. Ad-stitched assets can
+  // carry hundreds of periods, which makes serial serialization the dominant
+  // cost of manifest generation.
+  std::vector<Period*> periods;
+  periods.reserve(periods_.size());
+  for (const auto& period : periods_)
+    periods.push_back(period.get());
+  std::vector<std::optional<XmlNode>> period_nodes(periods.size());
+  if (periods.size() > 1) {
+    absl::Mutex mutex;
+    size_t pending_periods = periods.size();  // Protected by |mutex|.
+    for (size_t i = 0; i < periods.size(); ++i) {
+      ThreadPool::instance.PostTask([&periods, &period_nodes, &mutex,
+                                     &pending_periods, output_period_duration,
+                                     i]() {
+        std::optional<XmlNode> period_node =
+            periods[i]->GetXml(output_period_duration);
+        absl::MutexLock lock(&mutex);
+        period_nodes[i] = std::move(period_node);
+        --pending_periods;
+      });
+    }
+    absl::MutexLock lock(&mutex);
+    mutex.Await(absl::Condition(
+        +[](size_t* pending) { return *pending == 0; }, &pending_periods));
+  } else {
+    for (size_t i = 0; i < periods.size(); ++i)
+      period_nodes[i] = periods[i]->GetXml(output_period_duration);
+  }
+  for (auto& period_node : period_nodes) {
     if (!period_node || !mpd.AddChild(std::move(*period_node)))
       return std::nullopt;
   }
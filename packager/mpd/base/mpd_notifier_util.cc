@@ -11,6 +11,7 @@
 
 #include <packager/file.h>
 #include <packager/macros/logging.h>
+#include <packager/media/base/byte_codec.h>
 #include <packager/mpd/base/mpd_utils.h>
 
 namespace shaka {
@@ -49,10 +50,9 @@ ContentType GetContentType(const MediaInfo& media_info) {
 }
 
 std::string Uint8VectorToBase64(const std::vector<uint8_t>& input) {
-  std::string output;
-  std::string input_in_string(input.begin(), input.end());
-  absl::Base64Escape(input_in_string, &output);
-  return output;
+  // Cached: the callers pass PSSH blobs, which only change on key rotation.
+  return media::CachedEncodeBase64(std::string_view(
+      reinterpret_cast<const char*>(input.data()), input.size()));
 }
 
 }  // namespace shaka
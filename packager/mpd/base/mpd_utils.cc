@@ -15,6 +15,7 @@
 #include <libxml/tree.h>
 
 #include <packager/macros/logging.h>
+#include <packager/media/base/byte_codec.h>
 #include <packager/media/base/language_utils.h>
 #include <packager/media/base/protection_system_specific_info.h>
 #include <packager/mpd/base/adaptation_set.h>
@@ -273,8 +274,7 @@ bool HexToUUID(const std::string& data, std::string* uuid_format) {
     return false;
   }
 
-  const std::string hex_encoded =
-      absl::AsciiStrToLower(absl::BytesToHexString(data));
+  const std::string hex_encoded = media::EncodeLowerHex(data);
   DCHECK_EQ(hex_encoded.size(), kExpectedUUIDSize * 2);
   std::string_view all(hex_encoded);
   // Note UUID has 5 parts separated with dashes.
@@ -367,8 +367,7 @@ Element GenerateMarlinContentIds(const std::string& key_id) {
   Element marlin_content_id;
   marlin_content_id.name = kMarlinContentIdName;
   marlin_content_id.content =
-      kMarlinContentIdPrefix +
-      absl::AsciiStrToLower(absl::BytesToHexString(key_id));
+      kMarlinContentIdPrefix + media::EncodeLowerHex(key_id);
 
   Element marlin_content_ids;
   marlin_content_ids.name = kMarlinContentIdsName;
@@ -378,12 +377,11 @@ Element GenerateMarlinContentIds(const std::string& key_id) {
 }
 
 Element GenerateCencPsshElement(const std::string& pssh) {
-  std::string base64_encoded_pssh;
-  absl::Base64Escape(std::string_view(pssh.data(), pssh.size()),
-                     &base64_encoded_pssh);
   Element cenc_pssh;
   cenc_pssh.name = kPsshElementName;
-  cenc_pssh.content = base64_encoded_pssh;
+  // Cached: the same PSSH blob is flushed into the manifest until the next
+  // key rotation.
+  cenc_pssh.content = media::CachedEncodeBase64(pssh);
   return cenc_pssh;
 }
 
@@ -397,14 +395,11 @@ Element GenerateMsprProElement(const std::string& pssh) {
     );
 
   const std::vector<uint8_t> *p_pssh = &b->pssh_data();
-  std::string base64_encoded_mspr;
-  absl::Base64Escape(
-      std::string_view(reinterpret_cast<const char*>(p_pssh->data()),
-                       p_pssh->size()),
-      &base64_encoded_mspr);
   Element mspr_pro;
   mspr_pro.name = kMsproElementName;
-  mspr_pro.content = base64_encoded_mspr;
+  mspr_pro.content = media::CachedEncodeBase64(
+      std::string_view(reinterpret_cast<const char*>(p_pssh->data()),
+                       p_pssh->size()));
   return mspr_pro;
 }
 
@@ -137,6 +137,22 @@ std::optional<xml::XmlNode> Period::GetXml(bool output_period_duration) {
         return adaptation_set_a->id() < adaptation_set_b->id();
       });
 
+  // Serve a copy of the cached element when nothing below this Period
+  // changed since the last build.
+  if (cached_xml_.has_value() &&
+      cached_output_period_duration_ == output_period_duration &&
+      cached_duration_seconds_ == duration_seconds_) {
+    bool adaptation_sets_clean = true;
+    for (const auto& adaptation_set : adaptation_sets_) {
+      if (!adaptation_set->CanReuseXml()) {
+        adaptation_sets_clean = false;
+        break;
+      }
+    }
+    if (adaptation_sets_clean)
+      return cached_xml_->Clone();
+  }
+
   xml::XmlNode period("Period");
 
   // Required for 'dynamic' MPDs.
@@ -185,6 +201,10 @@ std::optional<xml::XmlNode> Period::GetXml(bool output_period_duration) {
       return std::nullopt;
     }
   }
+
+  cached_xml_ = period.Clone();
+  cached_output_period_duration_ = output_period_duration;
+  cached_duration_seconds_ = duration_seconds_;
   return period;
 }
 
@@ -134,6 +134,15 @@ class Period {
   // AdaptationSet.
   std::map<std::string, std::list<AdaptationSet*>> trickplay_cache_;
 
+  // Dirty tracking for the cached <Period> element. GetXml() serves a copy
+  // of |cached_xml_| as long as every AdaptationSet can reuse its own cached
+  // subtree and the duration attributes match the ones the cache was built
+  // with. Ad-stitched assets carry many completed periods that never change
+  // between manifest updates.
+  std::optional<xml::XmlNode> cached_xml_;
+  bool cached_output_period_duration_ = false;
+  double cached_duration_seconds_ = -1;
+
   // Tracks ProtectedContent in AdaptationSet.
   class ProtectedAdaptationSetMap {
    public:
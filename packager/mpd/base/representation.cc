@@ -13,7 +13,6 @@
 #include <absl/log/log.h>
 #include <absl/strings/str_format.h>
 
-#include <packager/file.h>
 #include <packager/macros/logging.h>
 #include <packager/media/base/muxer_util.h>
 #include <packager/mpd/base/mpd_options.h>
@@ -162,12 +161,14 @@ void Representation::AddContentProtectionElement(
     const ContentProtectionElement& content_protection_element) {
   content_protection_elements_.push_back(content_protection_element);
   RemoveDuplicateAttributes(&content_protection_elements_.back());
+  xml_dirty_ = true;
 }
 
 void Representation::UpdateContentProtectionPssh(const std::string& drm_uuid,
                                                  const std::string& pssh) {
   UpdateContentProtectionPsshHelper(drm_uuid, pssh,
                                     &content_protection_elements_);
+  xml_dirty_ = true;
 }
 
 void Representation::AddNewSegment(int64_t start_time,
@@ -178,6 +179,8 @@ void Representation::AddNewSegment(int64_t start_time,
     return;
   }
 
+  xml_dirty_ = true;
+
   // In order for the oldest segment to be accessible for at least
   // |time_shift_buffer_depth| seconds, the latest segment should not be in the
   // sliding window since the player could be playing any part of the latest
@@ -210,6 +213,7 @@ void Representation::UpdateCompletedSegment(int64_t duration, uint64_t size) {
     return;
   }
 
+  xml_dirty_ = true;
   UpdateSegmentInfo(duration);
 
   current_buffer_depth_ += segment_infos_.back().duration;
@@ -221,8 +225,10 @@ void Representation::UpdateCompletedSegment(int64_t duration, uint64_t size) {
 void Representation::SetSampleDuration(int32_t frame_duration) {
   // Sample duration is used to generate approximate SegmentTimeline.
   // Text is required to have exactly the same segment duration.
-  if (media_info_.has_audio_info() || media_info_.has_video_info())
+  if (media_info_.has_audio_info() || media_info_.has_video_info()) {
     frame_duration_ = frame_duration;
+    xml_dirty_ = true;
+  }
 
   if (media_info_.has_video_info()) {
     media_info_.mutable_video_info()->set_frame_duration(frame_duration);
@@ -239,6 +245,7 @@ void Representation::SetSegmentDuration() {
   if (sd <= 0)
     return;
   media_info_.set_segment_duration(sd);
+  xml_dirty_ = true;
 }
 
 const MediaInfo& Representation::GetMediaInfo() const {
@@ -252,14 +259,24 @@ const MediaInfo& Representation::GetMediaInfo() const {
 // AudioChannelConfig elements), AddContentProtectionElements*(), and
 // AddVODOnlyInfo() (Adds segment info).
 std::optional<xml::XmlNode> Representation::GetXml() {
+  // Serve a copy of the cached fragment if nothing changed since it was
+  // built; this keeps repeated manifest updates from re-serializing every
+  // unchanged SegmentTimeline.
+  if (CanReuseXml(output_suppression_flags_)) {
+    output_suppression_flags_ = 0;
+    return cached_xml_->Clone();
+  }
+
   if (!HasRequiredMediaInfoFields()) {
     LOG(ERROR) << "MediaInfo missing required fields.";
     return std::nullopt;
   }
 
+  // Percentile() returns Max() unless --advertised_bandwidth_percentile is
+  // set.
   const uint64_t bandwidth = media_info_.has_bandwidth()
                                  ? media_info_.bandwidth()
-                                 : bandwidth_estimator_.Max();
+                                 : bandwidth_estimator_.Percentile();
 
   DCHECK(!(HasVODOnlyFields(media_info_) && HasLiveOnlyFields(media_info_)));
 
@@ -315,6 +332,10 @@ std::optional<xml::XmlNode> Representation::GetXml() {
   // TODO(rkuroiwa): It is likely that all representations have the exact same
   // SegmentTemplate. Optimize and propagate the tag up to AdaptationSet level.
 
+  cached_suppression_flags_ = output_suppression_flags_;
+  cached_xml_ = representation.Clone();
+  xml_dirty_ = false;
+
   output_suppression_flags_ = 0;
   return representation;
 }
@@ -328,7 +349,12 @@ void Representation::SetPresentationTimeOffset(
   int64_t pto = presentation_time_offset * media_info_.reference_time_scale();
   if (pto <= 0)
     return;
+  if (media_info_.has_presentation_time_offset() &&
+      media_info_.presentation_time_offset() == pto) {
+    return;
+  }
   media_info_.set_presentation_time_offset(pto);
+  xml_dirty_ = true;
 }
 
 void Representation::SetAvailabilityTimeOffset() {
@@ -346,6 +372,7 @@ void Representation::SetAvailabilityTimeOffset() {
   if (ato <= 0)
     return;
   media_info_.set_availability_time_offset(ato);
+  xml_dirty_ = true;
 }
 
 bool Representation::GetStartAndEndTimestamps(
@@ -480,13 +507,14 @@ void Representation::SlideWindow() {
       mpd_options_.mpd_type == MpdType::kStatic)
     return;
 
-  const int32_t time_scale = GetTimeScale(media_info_);
-  DCHECK_GT(time_scale, 0);
-
-  const int64_t time_shift_buffer_depth = static_cast<int64_t>(
-      mpd_options_.mpd_params.time_shift_buffer_depth * time_scale);
+  if (time_shift_buffer_depth_ < 0) {
+    const int32_t time_scale = GetTimeScale(media_info_);
+    DCHECK_GT(time_scale, 0);
+    time_shift_buffer_depth_ = static_cast<int64_t>(
+        mpd_options_.mpd_params.time_shift_buffer_depth * time_scale);
+  }
 
-  if (current_buffer_depth_ <= time_shift_buffer_depth)
+  if (current_buffer_depth_ <= time_shift_buffer_depth_)
     return;
 
   std::list<SegmentInfo>::iterator first = segment_infos_.begin();
@@ -495,7 +523,7 @@ void Representation::SlideWindow() {
     // Remove the current segment only if it falls completely out of time shift
     // buffer range.
     while (last->repeat >= 0 &&
-           current_buffer_depth_ - last->duration >= time_shift_buffer_depth) {
+           current_buffer_depth_ - last->duration >= time_shift_buffer_depth_) {
       current_buffer_depth_ -= last->duration;
       RemoveOldSegment(&*last);
       start_number_++;
@@ -519,12 +547,9 @@ void Representation::RemoveOldSegment(SegmentInfo* segment_info) {
                             start_number_ - 1, media_info_.bandwidth()));
   while (segments_to_be_removed_.size() >
          mpd_options_.mpd_params.preserved_segments_outside_live_window) {
-    VLOG(2) << "Deleting " << segments_to_be_removed_.front();
-    if (!File::Delete(segments_to_be_removed_.front().c_str())) {
-      LOG(WARNING) << "Failed to delete " << segments_to_be_removed_.front()
-                   << "; Will retry later.";
-      break;
-    }
+    // Deletion happens on a background thread so that a slow storage backend
+    // does not stall manifest updates.
+    segment_deleter_.Delete(segments_to_be_removed_.front());
     segments_to_be_removed_.pop_front();
   }
 }
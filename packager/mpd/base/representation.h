@@ -14,6 +14,7 @@
 #include <memory>
 #include <optional>
 
+#include <packager/file/async_file_deleter.h>
 #include <packager/mpd/base/bandwidth_estimator.h>
 #include <packager/mpd/base/media_info.pb.h>
 #include <packager/mpd/base/segment_info.h>
@@ -161,7 +162,10 @@ class Representation {
   /// @return ID number for <Representation>.
   uint32_t id() const { return id_; }
 
-  void set_media_info(const MediaInfo& media_info) { media_info_ = media_info; }
+  void set_media_info(const MediaInfo& media_info) {
+    media_info_ = media_info;
+    xml_dirty_ = true;
+  }
 
  protected:
   /// @param media_info is a MediaInfo containing information on the media.
@@ -230,17 +234,30 @@ class Representation {
   // Get Representation as string. For debugging.
   std::string RepresentationAsString() const;
 
+  // Returns true if GetXml() would serve the cached XML fragment, assuming
+  // |suppression_flags| will be applied before the call. Used by AdaptationSet
+  // to decide whether its own cached subtree is still valid.
+  bool CanReuseXml(int suppression_flags) const {
+    return !xml_dirty_ && cached_xml_.has_value() &&
+           suppression_flags == cached_suppression_flags_;
+  }
+
   // Init() checks that only one of VideoInfo, AudioInfo, or TextInfo is set. So
   // any logic using this can assume only one set.
   MediaInfo media_info_;
   std::list<ContentProtectionElement> content_protection_elements_;
 
   int64_t current_buffer_depth_ = 0;
+  // Time shift buffer depth in media timescale units, converted from seconds
+  // once on first use. -1 means not converted yet.
+  int64_t time_shift_buffer_depth_ = -1;
   // TODO(kqyang): Address sliding window issue with multiple periods.
   std::list<SegmentInfo> segment_infos_;
   // A list to hold the file names of the segments to be removed temporarily.
-  // Once a file is actually removed, it is removed from the list.
+  // Once a file is handed to |segment_deleter_|, it is removed from the list.
   std::list<std::string> segments_to_be_removed_;
+  // Deletes expired segment files off the manifest update path.
+  AsyncFileDeleter segment_deleter_;
 
   const uint32_t id_;
   std::string mime_type_;
@@ -259,6 +276,13 @@ class Representation {
   // Bit vector for tracking witch attributes should not be output.
   int output_suppression_flags_ = 0;
 
+  // Dirty tracking for the cached XML fragment. GetXml() serves a copy of
+  // |cached_xml_| as long as no state affecting the output has changed and
+  // the pending suppression flags match the ones the cache was built with.
+  bool xml_dirty_ = true;
+  int cached_suppression_flags_ = 0;
+  std::optional<xml::XmlNode> cached_xml_;
+
   // When set to true, allows segments to have slightly different durations (up
   // to one sample).
   const bool allow_approximate_segment_timeline_ = false;
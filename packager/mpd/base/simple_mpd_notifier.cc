@@ -26,6 +26,12 @@ SimpleMpdNotifier::SimpleMpdNotifier(const MpdOptions& mpd_options)
           mpd_options.mpd_params.generate_dash_if_iop_compliant_mpd) {
   for (const std::string& base_url : mpd_options.mpd_params.base_urls)
     mpd_builder_->AddBaseUrl(base_url);
+  if (mpd_options.mpd_params.generate_delta_feed && !output_path_.empty())
+    delta_log_.reset(new ManifestDeltaLog(output_path_));
+}
+
+void SimpleMpdNotifier::InjectClock(std::unique_ptr<Clock> clock) {
+  mpd_builder_->InjectClockForTesting(std::move(clock));
 }
 
 SimpleMpdNotifier::~SimpleMpdNotifier() {}
@@ -69,6 +75,8 @@ bool SimpleMpdNotifier::NotifyNewContainer(const MediaInfo& media_info,
     AddContentProtectionElements(media_info, representation);
   }
   representation_map_[representation->id()] = representation;
+  if (delta_log_)
+    delta_log_->OnStreamAdded(representation->id());
   return true;
 }
 
@@ -117,6 +125,8 @@ bool SimpleMpdNotifier::NotifyNewSegment(uint32_t container_id,
     return false;
   }
   it->second->AddNewSegment(start_time, duration, size);
+  if (delta_log_)
+    delta_log_->OnSegmentAdded(container_id, start_time, duration, size);
   return true;
 }
 
@@ -198,6 +208,8 @@ bool SimpleMpdNotifier::NotifyEncryptionUpdate(
     it->second->UpdateContentProtectionPssh(drm_uuid,
                                             Uint8VectorToBase64(new_pssh));
   }
+  if (delta_log_)
+    delta_log_->OnKeyRotated(container_id);
   return true;
 }
 
@@ -219,7 +231,11 @@ bool SimpleMpdNotifier::NotifyMediaInfoUpdate(uint32_t container_id,
 
 bool SimpleMpdNotifier::Flush() {
   absl::MutexLock lock(&lock_);
-  return WriteMpdToFile(output_path_, mpd_builder_.get());
+  if (!WriteMpdToFile(output_path_, mpd_builder_.get()))
+    return false;
+  if (delta_log_)
+    delta_log_->OnManifestWritten();
+  return true;
 }
 
 }  // namespace shaka
@@ -14,12 +14,14 @@
 
 #include <absl/synchronization/mutex.h>
 
+#include <packager/mpd/base/manifest_delta_log.h>
 #include <packager/mpd/base/mpd_notifier.h>
 #include <packager/mpd/base/mpd_notifier_util.h>
 
 namespace shaka {
 
 class AdaptationSet;
+class Clock;
 class MpdBuilder;
 class Representation;
 
@@ -58,6 +60,12 @@ class SimpleMpdNotifier : public MpdNotifier {
   bool Flush() override;
   /// @}
 
+  /// Replace the clock used for the MPD's publishTime and
+  /// availabilityStartTime, e.g. with a media-time driven clock (see
+  /// PackagingParams::enable_virtual_clock). Must be called before any
+  /// Notify*() method.
+  void InjectClock(std::unique_ptr<Clock> clock);
+
  private:
   SimpleMpdNotifier(const SimpleMpdNotifier&) = delete;
   SimpleMpdNotifier& operator=(const SimpleMpdNotifier&) = delete;
@@ -75,6 +83,8 @@ class SimpleMpdNotifier : public MpdNotifier {
   // MPD output path.
   std::string output_path_;
   std::unique_ptr<MpdBuilder> mpd_builder_;
+  // Binary feed of manifest changes; null unless enabled in MpdParams.
+  std::unique_ptr<ManifestDeltaLog> delta_log_;
   bool content_protection_in_adaptation_set_ = true;
   absl::Mutex lock_;
 
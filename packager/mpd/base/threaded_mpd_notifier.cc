@@ -0,0 +1,201 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/mpd/base/threaded_mpd_notifier.h>
+
+#include <functional>
+#include <utility>
+
+#include <absl/log/check.h>
+#include <absl/log/log.h>
+
+#include <packager/file/thread_pool.h>
+
+namespace shaka {
+
+ThreadedMpdNotifier::ThreadedMpdNotifier(const MpdOptions& mpd_options,
+                                         std::unique_ptr<MpdNotifier> notifier)
+    : MpdNotifier(mpd_options), notifier_(std::move(notifier)) {
+  DCHECK(notifier_);
+}
+
+ThreadedMpdNotifier::~ThreadedMpdNotifier() {
+  {
+    absl::MutexLock lock(&mutex_);
+    stopped_ = true;
+  }
+  if (started_)
+    task_exit_event_.WaitForNotification();
+}
+
+bool ThreadedMpdNotifier::Init() {
+  DCHECK(!started_);
+  if (!notifier_->Init())
+    return false;
+  started_ = true;
+  ThreadPool::instance.PostTask(std::bind(
+      &ThreadedMpdNotifier::ProcessEventsTask, this));
+  return true;
+}
+
+bool ThreadedMpdNotifier::NotifyNewContainer(const MediaInfo& media_info,
+                                             uint32_t* id) {
+  if (!WaitUntilIdle())
+    return false;
+  return notifier_->NotifyNewContainer(media_info, id);
+}
+
+bool ThreadedMpdNotifier::NotifyAvailabilityTimeOffset(uint32_t container_id) {
+  if (!WaitUntilIdle())
+    return false;
+  return notifier_->NotifyAvailabilityTimeOffset(container_id);
+}
+
+bool ThreadedMpdNotifier::NotifySampleDuration(uint32_t container_id,
+                                               int32_t sample_duration) {
+  if (!WaitUntilIdle())
+    return false;
+  return notifier_->NotifySampleDuration(container_id, sample_duration);
+}
+
+bool ThreadedMpdNotifier::NotifySegmentDuration(uint32_t container_id) {
+  if (!WaitUntilIdle())
+    return false;
+  return notifier_->NotifySegmentDuration(container_id);
+}
+
+bool ThreadedMpdNotifier::NotifyNewSegment(uint32_t container_id,
+                                           int64_t start_time,
+                                           int64_t duration,
+                                           uint64_t size) {
+  Event event;
+  event.type = Event::Type::kNewSegment;
+  event.container_id = container_id;
+  event.start_time = start_time;
+  event.duration = duration;
+  event.size = size;
+  return PostEvent(event);
+}
+
+bool ThreadedMpdNotifier::NotifyCompletedSegment(uint32_t container_id,
+                                                 int64_t duration,
+                                                 uint64_t size) {
+  Event event;
+  event.type = Event::Type::kCompletedSegment;
+  event.container_id = container_id;
+  event.duration = duration;
+  event.size = size;
+  return PostEvent(event);
+}
+
+bool ThreadedMpdNotifier::NotifyCueEvent(uint32_t container_id,
+                                         int64_t timestamp) {
+  Event event;
+  event.type = Event::Type::kCueEvent;
+  event.container_id = container_id;
+  event.timestamp = timestamp;
+  return PostEvent(event);
+}
+
+bool ThreadedMpdNotifier::NotifyEncryptionUpdate(
+    uint32_t container_id,
+    const std::string& drm_uuid,
+    const std::vector<uint8_t>& new_key_id,
+    const std::vector<uint8_t>& new_pssh) {
+  if (!WaitUntilIdle())
+    return false;
+  return notifier_->NotifyEncryptionUpdate(container_id, drm_uuid, new_key_id,
+                                           new_pssh);
+}
+
+bool ThreadedMpdNotifier::NotifyMediaInfoUpdate(uint32_t container_id,
+                                                const MediaInfo& media_info) {
+  if (!WaitUntilIdle())
+    return false;
+  return notifier_->NotifyMediaInfoUpdate(container_id, media_info);
+}
+
+bool ThreadedMpdNotifier::Flush() {
+  Event event;
+  event.type = Event::Type::kFlush;
+  return PostEvent(event);
+}
+
+bool ThreadedMpdNotifier::WaitUntilIdle() {
+  absl::MutexLock lock(&mutex_);
+  mutex_.Await(absl::Condition(this, &ThreadedMpdNotifier::IsIdle));
+  return success_;
+}
+
+bool ThreadedMpdNotifier::IsIdle() const {
+  return events_.empty() && !processing_;
+}
+
+bool ThreadedMpdNotifier::HasWork() const {
+  return stopped_ || !events_.empty();
+}
+
+bool ThreadedMpdNotifier::PostEvent(const Event& event) {
+  DCHECK(started_);
+  absl::MutexLock lock(&mutex_);
+  events_.push_back(event);
+  return success_;
+}
+
+void ThreadedMpdNotifier::ProcessEventsTask() {
+  std::deque<Event> batch;
+  while (true) {
+    {
+      absl::MutexLock lock(&mutex_);
+      mutex_.Await(absl::Condition(this, &ThreadedMpdNotifier::HasWork));
+      if (events_.empty()) {
+        DCHECK(stopped_);
+        break;
+      }
+      events_.swap(batch);
+      processing_ = true;
+    }
+
+    // Apply the batch outside the lock so new events can be enqueued without
+    // waiting for manifest updates. Flush requests in the batch collapse into
+    // a single Flush() after all events have been applied, so the MPD is
+    // serialized once per drain pass no matter how many muxers requested it.
+    bool batch_success = true;
+    bool flush_requested = false;
+    for (const Event& event : batch) {
+      switch (event.type) {
+        case Event::Type::kNewSegment:
+          batch_success &= notifier_->NotifyNewSegment(
+              event.container_id, event.start_time, event.duration,
+              event.size);
+          break;
+        case Event::Type::kCompletedSegment:
+          batch_success &= notifier_->NotifyCompletedSegment(
+              event.container_id, event.duration, event.size);
+          break;
+        case Event::Type::kCueEvent:
+          batch_success &=
+              notifier_->NotifyCueEvent(event.container_id, event.timestamp);
+          break;
+        case Event::Type::kFlush:
+          flush_requested = true;
+          break;
+      }
+    }
+    if (flush_requested)
+      batch_success &= notifier_->Flush();
+    if (!batch_success)
+      LOG(ERROR) << "Failed to apply MPD notifications.";
+    batch.clear();
+
+    absl::MutexLock lock(&mutex_);
+    processing_ = false;
+    success_ &= batch_success;
+  }
+  task_exit_event_.Notify();
+}
+
+}  // namespace shaka
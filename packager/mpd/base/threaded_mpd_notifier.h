@@ -0,0 +1,127 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef MPD_BASE_THREADED_MPD_NOTIFIER_H_
+#define MPD_BASE_THREADED_MPD_NOTIFIER_H_
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <absl/base/thread_annotations.h>
+#include <absl/synchronization/mutex.h>
+#include <absl/synchronization/notification.h>
+
+#include <packager/mpd/base/mpd_notifier.h>
+
+namespace shaka {
+
+/// An MpdNotifier decorator which moves per-segment notifications and manifest
+/// serialization off the caller's thread. Muxer threads enqueue segment events
+/// and flush requests, which a single background thread applies to the wrapped
+/// notifier; all flush requests pending in one drain pass are coalesced into a
+/// single Flush() on the wrapped notifier. This keeps concurrent muxers from
+/// contending on the manifest lock or waiting for MPD writes in their sample
+/// paths.
+///
+/// Setup and teardown notifications (new container, media info or encryption
+/// updates, etc.) are forwarded synchronously after the pending events have
+/// drained, so the wrapped notifier observes all notifications in call order.
+class ThreadedMpdNotifier : public MpdNotifier {
+ public:
+  /// @param mpd_options is the options for this MPD.
+  /// @param notifier is the notifier that actually maintains the manifest. It
+  ///        must not be used directly while this object is alive.
+  ThreadedMpdNotifier(const MpdOptions& mpd_options,
+                      std::unique_ptr<MpdNotifier> notifier);
+  ~ThreadedMpdNotifier() override;
+
+  /// @name MpdNotifier implementation overrides.
+  /// NotifyNewSegment(), NotifyCompletedSegment(), NotifyCueEvent() and
+  /// Flush() are asynchronous: they enqueue the notification and report
+  /// whether all notifications processed so far have succeeded. Use
+  /// WaitUntilIdle() to wait for the outcome of pending notifications.
+  /// @{
+  bool Init() override;
+  bool NotifyNewContainer(const MediaInfo& media_info, uint32_t* id) override;
+  bool NotifyAvailabilityTimeOffset(uint32_t container_id) override;
+  bool NotifySampleDuration(uint32_t container_id,
+                            int32_t sample_duration) override;
+  bool NotifySegmentDuration(uint32_t container_id) override;
+  bool NotifyNewSegment(uint32_t container_id,
+                        int64_t start_time,
+                        int64_t duration,
+                        uint64_t size) override;
+  bool NotifyCompletedSegment(uint32_t container_id,
+                              int64_t duration,
+                              uint64_t size) override;
+  bool NotifyCueEvent(uint32_t container_id, int64_t timestamp) override;
+  bool NotifyEncryptionUpdate(uint32_t container_id,
+                              const std::string& drm_uuid,
+                              const std::vector<uint8_t>& new_key_id,
+                              const std::vector<uint8_t>& new_pssh) override;
+  bool NotifyMediaInfoUpdate(uint32_t container_id,
+                             const MediaInfo& media_info) override;
+  bool Flush() override;
+  /// @}
+
+  /// Blocks until all enqueued notifications have been applied to the wrapped
+  /// notifier.
+  /// @return true if every notification processed so far has succeeded.
+  bool WaitUntilIdle();
+
+ private:
+  ThreadedMpdNotifier(const ThreadedMpdNotifier&) = delete;
+  ThreadedMpdNotifier& operator=(const ThreadedMpdNotifier&) = delete;
+
+  struct Event {
+    enum class Type {
+      kNewSegment,
+      kCompletedSegment,
+      kCueEvent,
+      kFlush,
+    };
+
+    Type type;
+    uint32_t container_id = 0;
+    int64_t start_time = 0;
+    int64_t duration = 0;
+    uint64_t size = 0;
+    int64_t timestamp = 0;
+  };
+
+  // Enqueues |event| for the processing thread. Returns the sticky success
+  // state, i.e. whether all notifications processed so far have succeeded.
+  bool PostEvent(const Event& event);
+
+  // Condition predicates for |mutex_|.
+  bool IsIdle() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  bool HasWork() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Runs on a ThreadPool thread. Repeatedly drains the queue and applies the
+  // batched events to |notifier_| until Stop() is called and the queue is
+  // empty.
+  void ProcessEventsTask();
+
+  std::unique_ptr<MpdNotifier> notifier_;
+
+  absl::Mutex mutex_;
+  std::deque<Event> events_ ABSL_GUARDED_BY(mutex_);
+  // True while the processing thread is applying a drained batch.
+  bool processing_ ABSL_GUARDED_BY(mutex_) = false;
+  bool stopped_ ABSL_GUARDED_BY(mutex_) = false;
+  // False if any notification applied by the processing thread has failed.
+  bool success_ ABSL_GUARDED_BY(mutex_) = true;
+
+  bool started_ = false;
+  absl::Notification task_exit_event_;
+};
+
+}  // namespace shaka
+
+#endif  // MPD_BASE_THREADED_MPD_NOTIFIER_H_
@@ -0,0 +1,111 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/mpd/base/threaded_mpd_notifier.h>
+
+#include <memory>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <packager/mpd/base/mock_mpd_notifier.h>
+#include <packager/mpd/base/mpd_options.h>
+
+namespace shaka {
+
+using ::testing::Between;
+using ::testing::Return;
+
+namespace {
+const uint32_t kContainerId = 1;
+const int64_t kStartTime = 100;
+const int64_t kDuration = 50;
+const uint64_t kSize = 12345;
+}  // namespace
+
+class ThreadedMpdNotifierTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std::unique_ptr<MockMpdNotifier> mock_notifier(
+        new MockMpdNotifier(mpd_options_));
+    mock_notifier_ = mock_notifier.get();
+    notifier_.reset(
+        new ThreadedMpdNotifier(mpd_options_, std::move(mock_notifier)));
+
+    EXPECT_CALL(*mock_notifier_, Init()).WillOnce(Return(true));
+    ASSERT_TRUE(notifier_->Init());
+  }
+
+  MpdOptions mpd_options_;
+  // Owned by |notifier_|.
+  MockMpdNotifier* mock_notifier_ = nullptr;
+  std::unique_ptr<ThreadedMpdNotifier> notifier_;
+};
+
+TEST_F(ThreadedMpdNotifierTest, ForwardsSegmentEvents) {
+  EXPECT_CALL(*mock_notifier_,
+              NotifyNewSegment(kContainerId, kStartTime, kDuration, kSize))
+      .WillOnce(Return(true));
+  EXPECT_CALL(*mock_notifier_, NotifyCueEvent(kContainerId, kStartTime))
+      .WillOnce(Return(true));
+  EXPECT_CALL(*mock_notifier_, NotifyCompletedSegment(kContainerId, kDuration,
+                                                      kSize))
+      .WillOnce(Return(true));
+
+  EXPECT_TRUE(
+      notifier_->NotifyNewSegment(kContainerId, kStartTime, kDuration, kSize));
+  EXPECT_TRUE(notifier_->NotifyCueEvent(kContainerId, kStartTime));
+  EXPECT_TRUE(
+      notifier_->NotifyCompletedSegment(kContainerId, kDuration, kSize));
+  EXPECT_TRUE(notifier_->WaitUntilIdle());
+}
+
+TEST_F(ThreadedMpdNotifierTest, CoalescesFlushes) {
+  const int kNumSegments = 100;
+  EXPECT_CALL(*mock_notifier_, NotifyNewSegment(kContainerId, ::testing::_,
+                                                kDuration, kSize))
+      .Times(kNumSegments)
+      .WillRepeatedly(Return(true));
+  // Flushes pending in one drain pass collapse into a single Flush, so there
+  // are at most as many flushes as segments and at least one.
+  EXPECT_CALL(*mock_notifier_, Flush())
+      .Times(Between(1, kNumSegments))
+      .WillRepeatedly(Return(true));
+
+  for (int i = 0; i < kNumSegments; ++i) {
+    EXPECT_TRUE(notifier_->NotifyNewSegment(kContainerId, i * kDuration,
+                                            kDuration, kSize));
+    EXPECT_TRUE(notifier_->Flush());
+  }
+  EXPECT_TRUE(notifier_->WaitUntilIdle());
+}
+
+TEST_F(ThreadedMpdNotifierTest, SynchronousNotificationsDrainPendingEvents) {
+  ::testing::InSequence sequence;
+  EXPECT_CALL(*mock_notifier_,
+              NotifyNewSegment(kContainerId, kStartTime, kDuration, kSize))
+      .WillOnce(Return(true));
+  EXPECT_CALL(*mock_notifier_, Flush()).WillOnce(Return(true));
+  EXPECT_CALL(*mock_notifier_, NotifySampleDuration(kContainerId, kDuration))
+      .WillOnce(Return(true));
+
+  EXPECT_TRUE(
+      notifier_->NotifyNewSegment(kContainerId, kStartTime, kDuration, kSize));
+  EXPECT_TRUE(notifier_->Flush());
+  // The synchronous notification must observe the queued segment first.
+  EXPECT_TRUE(notifier_->NotifySampleDuration(kContainerId, kDuration));
+}
+
+TEST_F(ThreadedMpdNotifierTest, ReportsFailure) {
+  EXPECT_CALL(*mock_notifier_,
+              NotifyNewSegment(kContainerId, kStartTime, kDuration, kSize))
+      .WillOnce(Return(false));
+
+  notifier_->NotifyNewSegment(kContainerId, kStartTime, kDuration, kSize);
+  EXPECT_FALSE(notifier_->WaitUntilIdle());
+}
+
+}  // namespace shaka
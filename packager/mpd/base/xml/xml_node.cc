@@ -33,6 +33,13 @@ ABSL_FLAG(bool,
           "Generates SegmentTemplate@duration if all segments except the "
           "last one has the same duration if this flag is set to true.");
 
+ABSL_FLAG(bool,
+          dash_omit_segment_timeline_times,
+          false,
+          "Omits SegmentTimeline S@t attributes that follow directly from "
+          "the previous S element, as allowed by ISO/IEC 23009-1. Shrinks "
+          "manifests with long DVR windows considerably.");
+
 ABSL_FLAG(bool,
           dash_add_last_segment_number_when_needed,
           false,
@@ -87,13 +94,25 @@ bool IsTimelineConstantDuration(const std::list<SegmentInfo>& segment_infos,
 
 bool PopulateSegmentTimeline(const std::list<SegmentInfo>& segment_infos,
                              XmlNode* segment_timeline) {
+  const bool omit_redundant_times =
+      absl::GetFlag(FLAGS_dash_omit_segment_timeline_times);
+  bool is_first_s_element = true;
+  int64_t expected_start_time = 0;
   for (const SegmentInfo& segment_info : segment_infos) {
     XmlNode s_element("S");
-    RCHECK(s_element.SetIntegerAttribute("t", segment_info.start_time));
+    // S@t is only required on the first S element and after gaps; anywhere
+    // else it is implied by the previous element (ISO/IEC 23009-1 5.3.9.6.2).
+    if (!omit_redundant_times || is_first_s_element ||
+        segment_info.start_time != expected_start_time) {
+      RCHECK(s_element.SetIntegerAttribute("t", segment_info.start_time));
+    }
     RCHECK(s_element.SetIntegerAttribute("d", segment_info.duration));
     if (segment_info.repeat > 0)
       RCHECK(s_element.SetIntegerAttribute("r", segment_info.repeat));
 
+    is_first_s_element = false;
+    expected_start_time = segment_info.start_time +
+                          segment_info.duration * (segment_info.repeat + 1);
     RCHECK(segment_timeline->AddChild(std::move(s_element)));
   }
 
@@ -126,6 +145,168 @@ void TraverseNodesAndCollectNamespaces(const xmlNode* node,
   }
 }
 
+// Streaming serializer used by XmlNode::ToString. It walks the libxml tree
+// directly and appends into a std::string, replacing the xmlDocDump path,
+// whose temporary document copy and xmlBuffer churn dominated manifest
+// flushes. The output is byte-identical to
+// xmlDocDumpFormatMemoryEnc(..., "UTF-8", 1) for the node types the MPD
+// builder produces (elements, text, entity references and comments).
+
+// Text content escaping, matching libxml's xmlEscapeEntities.
+void AppendEscapedText(const xmlChar* text, std::string* out) {
+  if (!text)
+    return;
+  for (const xmlChar* p = text; *p; ++p) {
+    switch (*p) {
+      case '<':
+        out->append("&lt;");
+        break;
+      case '>':
+        out->append("&gt;");
+        break;
+      case '&':
+        out->append("&amp;");
+        break;
+      case '\r':
+        out->append("&#13;");
+        break;
+      default:
+        out->push_back(static_cast<char>(*p));
+        break;
+    }
+  }
+}
+
+// Attribute value escaping, matching libxml's xmlAttrSerializeTxtContent.
+void AppendEscapedAttribute(const xmlChar* text, std::string* out) {
+  if (!text)
+    return;
+  for (const xmlChar* p = text; *p; ++p) {
+    switch (*p) {
+      case '<':
+        out->append("&lt;");
+        break;
+      case '>':
+        out->append("&gt;");
+        break;
+      case '&':
+        out->append("&amp;");
+        break;
+      case '"':
+        out->append("&quot;");
+        break;
+      case '\n':
+        out->append("&#10;");
+        break;
+      case '\r':
+        out->append("&#13;");
+        break;
+      case '\t':
+        out->append("&#9;");
+        break;
+      default:
+        out->push_back(static_cast<char>(*p));
+        break;
+    }
+  }
+}
+
+// libxml disables formatting inside elements with any text-ish child.
+bool NodeListContainsText(const xmlNode* children) {
+  for (const xmlNode* child = children; child; child = child->next) {
+    if (child->type == XML_TEXT_NODE || child->type == XML_CDATA_SECTION_NODE ||
+        child->type == XML_ENTITY_REF_NODE) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void AppendIndent(int depth, std::string* out) {
+  // libxml2 caps indentation at MAX_INDENT (60) characters, i.e. 30 levels
+  // with the default two-space indent string.
+  const int kMaxIndentLevel = 30;
+  if (depth > kMaxIndentLevel)
+    depth = kMaxIndentLevel;
+  for (int i = 0; i < depth; ++i)
+    out->append("  ");
+}
+
+void AppendNode(const xmlNode* node, int depth, bool format, std::string* out);
+
+void AppendNodeList(const xmlNode* children,
+                    int depth,
+                    bool format,
+                    std::string* out) {
+  for (const xmlNode* child = children; child; child = child->next) {
+    if (format)
+      AppendIndent(depth, out);
+    AppendNode(child, depth, format, out);
+    if (format)
+      out->push_back('\n');
+  }
+}
+
+void AppendNode(const xmlNode* node, int depth, bool format, std::string* out) {
+  switch (node->type) {
+    case XML_TEXT_NODE:
+      AppendEscapedText(node->content, out);
+      return;
+    case XML_ENTITY_REF_NODE:
+      out->push_back('&');
+      out->append(reinterpret_cast<const char*>(node->name));
+      out->push_back(';');
+      return;
+    case XML_COMMENT_NODE:
+      out->append("<!--");
+      if (node->content)
+        out->append(reinterpret_cast<const char*>(node->content));
+      out->append("-->");
+      return;
+    case XML_ELEMENT_NODE:
+      break;
+    default:
+      return;
+  }
+
+  out->push_back('<');
+  out->append(reinterpret_cast<const char*>(node->name));
+  for (const xmlAttr* attr = node->properties; attr; attr = attr->next) {
+    out->push_back(' ');
+    out->append(reinterpret_cast<const char*>(attr->name));
+    out->append("=\"");
+    // Attribute values are a list of text and entity reference nodes.
+    for (const xmlNode* value = attr->children; value; value = value->next) {
+      if (value->type == XML_TEXT_NODE) {
+        AppendEscapedAttribute(value->content, out);
+      } else if (value->type == XML_ENTITY_REF_NODE) {
+        out->push_back('&');
+        out->append(reinterpret_cast<const char*>(value->name));
+        out->push_back(';');
+      }
+    }
+    out->push_back('"');
+  }
+
+  if (!node->children) {
+    out->append("/>");
+    return;
+  }
+
+  out->push_back('>');
+  const bool format_children = format && !NodeListContainsText(node->children);
+  if (format_children) {
+    out->push_back('\n');
+    AppendNodeList(node->children, depth + 1, true, out);
+    AppendIndent(depth, out);
+  } else {
+    AppendNodeList(node->children, 0, false, out);
+  }
+  out->append("</");
+  out->append(reinterpret_cast<const char*>(node->name));
+  out->push_back('>');
+}
+
 }  // namespace
 
 namespace xml {
@@ -146,6 +327,15 @@ XmlNode::~XmlNode() {}
 
 XmlNode& XmlNode::operator=(XmlNode&&) = default;
 
+XmlNode XmlNode::Clone() const {
+  DCHECK(impl_->node);
+  XmlNode clone(std::string());
+  clone.impl_->node.reset(
+      xmlCopyNode(impl_->node.get(), 1 /* recursive copy */));
+  DCHECK(clone.impl_->node);
+  return clone;
+}
+
 bool XmlNode::AddChild(XmlNode child) {
   DCHECK(impl_->node);
   DCHECK(child.impl_->node);
@@ -232,26 +422,16 @@ std::set<std::string> XmlNode::ExtractReferencedNamespaces() const {
 }
 
 std::string XmlNode::ToString(const std::string& comment) const {
-  // Create an xmlDoc from xmlNodePtr. The node is copied so ownership does not
-  // transfer.
-  xml::scoped_xml_ptr<xmlDoc> doc(xmlNewDoc(BAD_CAST "1.0"));
-  if (comment.empty()) {
-    xmlDocSetRootElement(doc.get(), xmlCopyNode(impl_->node.get(), true));
-  } else {
-    xml::scoped_xml_ptr<xmlNode> comment_xml(
-        xmlNewDocComment(doc.get(), BAD_CAST comment.c_str()));
-    xmlDocSetRootElement(doc.get(), comment_xml.get());
-    xmlAddSibling(comment_xml.release(), xmlCopyNode(impl_->node.get(), true));
-  }
-
-  // Format the xmlDoc to string.
-  static const int kNiceFormat = 1;
-  int doc_str_size = 0;
-  xmlChar* doc_str = nullptr;
-  xmlDocDumpFormatMemoryEnc(doc.get(), &doc_str, &doc_str_size, "UTF-8",
-                            kNiceFormat);
-  std::string output(doc_str, doc_str + doc_str_size);
-  xmlFree(doc_str);
+  // Serialize the node directly instead of copying it into a temporary
+  // xmlDoc and dumping that; see the serializer helpers above.
+  std::string output("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+  if (!comment.empty()) {
+    output.append("<!--");
+    output.append(comment);
+    output.append("-->\n");
+  }
+  AppendNode(impl_->node.get(), 0, true, &output);
+  output.push_back('\n');
   return output;
 }
 
@@ -49,6 +49,9 @@ class XmlNode {
 
   XmlNode& operator=(XmlNode&&);
 
+  /// @return a deep copy of this node and its subtree.
+  XmlNode Clone() const;
+
   /// Add a child element to this element.
   /// @param child is an XmlNode to add as a child for this element.
   /// @return true on success, false otherwise.
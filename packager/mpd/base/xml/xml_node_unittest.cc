@@ -22,6 +22,7 @@
 
 ABSL_DECLARE_FLAG(bool, segment_template_constant_duration);
 ABSL_DECLARE_FLAG(bool, dash_add_last_segment_number_when_needed);
+ABSL_DECLARE_FLAG(bool, dash_omit_segment_timeline_times);
 
 using ::testing::ElementsAre;
 
@@ -531,6 +532,50 @@ TEST_F(LiveSegmentTimelineTest, TwoSegmentInfoWithGap) {
                   "</Representation>"));
 }
 
+TEST_F(LiveSegmentTimelineTest, OmitRedundantSegmentTimes) {
+  const uint32_t kStartNumber = 1;
+  const bool kIsLowLatency = false;
+
+  const int64_t kStartTime1 = 500;
+  const int64_t kDuration1 = 100;
+  const uint64_t kRepeat1 = 9;
+
+  // Contiguous with the first run, so its @t is implied.
+  const int64_t kStartTime2 = kStartTime1 + (kRepeat1 + 1) * kDuration1;
+  const int64_t kDuration2 = 200;
+  const uint64_t kRepeat2 = 1;
+
+  // Follows a gap, so its @t must be written.
+  const uint64_t kGap = 100;
+  const int64_t kStartTime3 =
+      kGap + kStartTime2 + (kRepeat2 + 1) * kDuration2;
+  const int64_t kDuration3 = 100;
+  const uint64_t kRepeat3 = 0;
+
+  std::list<SegmentInfo> segment_infos = {
+      {kStartTime1, kDuration1, kRepeat1},
+      {kStartTime2, kDuration2, kRepeat2},
+      {kStartTime3, kDuration3, kRepeat3},
+  };
+  RepresentationXmlNode representation;
+  FlagSaver<bool> omit_times_saver(&FLAGS_dash_omit_segment_timeline_times);
+  absl::SetFlag(&FLAGS_dash_omit_segment_timeline_times, true);
+  ASSERT_TRUE(representation.AddLiveOnlyInfo(media_info_, segment_infos,
+                                             kStartNumber, kIsLowLatency));
+
+  EXPECT_THAT(representation,
+              XmlNodeEqual(
+                  "<Representation>"
+                  "  <SegmentTemplate media=\"$Number$.m4s\" startNumber=\"1\">"
+                  "    <SegmentTimeline>"
+                  "      <S t=\"500\" d=\"100\" r=\"9\"/>"
+                  "      <S d=\"200\" r=\"1\"/>"
+                  "      <S t=\"2000\" d=\"100\"/>"
+                  "    </SegmentTimeline>"
+                  "  </SegmentTemplate>"
+                  "</Representation>"));
+}
+
 TEST_F(LiveSegmentTimelineTest, LastSegmentNumberSupplementalProperty) {
   const uint32_t kStartNumber = 1;
   const int64_t kStartTime = 0;
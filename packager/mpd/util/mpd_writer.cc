@@ -7,13 +7,18 @@
 #include <packager/mpd/util/mpd_writer.h>
 
 #include <cstdint>
+#include <utility>
 
 #include <absl/flags/flag.h>
 #include <absl/log/check.h>
 #include <absl/log/log.h>
+#include <absl/synchronization/mutex.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 #include <google/protobuf/text_format.h>
 
 #include <packager/file.h>
+#include <packager/file/thread_pool.h>
 #include <packager/mpd/base/mpd_builder.h>
 #include <packager/mpd/base/mpd_notifier.h>
 #include <packager/mpd/base/mpd_utils.h>
@@ -45,21 +50,106 @@ class SimpleMpdNotifierFactory : public MpdNotifierFactory {
 MpdWriter::MpdWriter() : notifier_factory_(new SimpleMpdNotifierFactory()) {}
 MpdWriter::~MpdWriter() {}
 
-bool MpdWriter::AddFile(const std::string& media_info_path) {
+bool MpdWriter::LoadMediaInfo(const std::string& media_info_path,
+                              MediaInfo* media_info) {
   std::string file_content;
   if (!File::ReadFileToString(media_info_path.c_str(), &file_content)) {
     LOG(ERROR) << "Failed to read " << media_info_path << " to string.";
     return false;
   }
 
-  MediaInfo media_info;
+  // Media info files may be written in either text format or binary wire
+  // format (see VodMediaInfoDumpMuxerListener::WriteMediaInfoToFile); try
+  // the text format first and fall back to binary.
   if (!::google::protobuf::TextFormat::ParseFromString(file_content,
-                                                       &media_info)) {
-    LOG(ERROR) << "Failed to parse " << file_content << " to MediaInfo.";
+                                                       media_info)) {
+    media_info->Clear();
+    if (!media_info->ParseFromString(file_content)) {
+      LOG(ERROR) << "Failed to parse " << media_info_path << " to MediaInfo.";
+      return false;
+    }
+  }
+  return true;
+}
+
+bool MpdWriter::AddFile(const std::string& media_info_path) {
+  MediaInfo media_info;
+  if (!LoadMediaInfo(media_info_path, &media_info))
     return false;
+  media_infos_.push_back(std::move(media_info));
+  return true;
+}
+
+bool MpdWriter::AddFiles(const std::vector<std::string>& media_info_paths) {
+  if (media_info_paths.size() < 2) {
+    bool all_added = true;
+    for (const std::string& path : media_info_paths)
+      all_added &= AddFile(path);
+    return all_added;
   }
 
-  media_infos_.push_back(media_info);
+  // Read and parse concurrently; each task owns its own slot, so results
+  // can be collected in input order once all tasks are done.
+  std::vector<MediaInfo> parsed(media_info_paths.size());
+  std::vector<uint8_t> loaded(media_info_paths.size(), 0);
+  absl::Mutex mutex;
+  size_t remaining = media_info_paths.size();
+  for (size_t i = 0; i < media_info_paths.size(); ++i) {
+    ThreadPool::instance.PostTask([&, i]() {
+      loaded[i] = LoadMediaInfo(media_info_paths[i], &parsed[i]) ? 1 : 0;
+      absl::MutexLock lock(&mutex);
+      --remaining;
+    });
+  }
+  {
+    absl::MutexLock lock(&mutex);
+    mutex.Await(
+        absl::Condition(+[](size_t* count) { return *count == 0; },
+                        &remaining));
+  }
+
+  bool all_added = true;
+  for (size_t i = 0; i < media_info_paths.size(); ++i) {
+    if (loaded[i])
+      media_infos_.push_back(std::move(parsed[i]));
+    else
+      all_added = false;
+  }
+  return all_added;
+}
+
+bool MpdWriter::AddMediaInfoBundle(const std::string& bundle_path) {
+  std::string bundle;
+  if (!File::ReadFileToString(bundle_path.c_str(), &bundle)) {
+    LOG(ERROR) << "Failed to read " << bundle_path << " to string.";
+    return false;
+  }
+
+  ::google::protobuf::io::ArrayInputStream input(
+      bundle.data(), static_cast<int>(bundle.size()));
+  ::google::protobuf::io::CodedInputStream coded(&input);
+  size_t num_added = 0;
+  while (static_cast<size_t>(coded.CurrentPosition()) < bundle.size()) {
+    uint32_t message_size = 0;
+    if (!coded.ReadVarint32(&message_size)) {
+      LOG(ERROR) << "Malformed message size after MediaInfo " << num_added
+                 << " in " << bundle_path;
+      return false;
+    }
+    const auto limit = coded.PushLimit(message_size);
+    MediaInfo media_info;
+    if (!media_info.ParseFromCodedStream(&coded) ||
+        coded.BytesUntilLimit() != 0) {
+      LOG(ERROR) << "Failed to parse MediaInfo " << num_added << " in "
+                 << bundle_path;
+      return false;
+    }
+    coded.PopLimit(limit);
+    media_infos_.push_back(std::move(media_info));
+    ++num_added;
+  }
+  VLOG(1) << "Added " << num_added << " MediaInfos from bundle "
+          << bundle_path;
   return true;
 }
 
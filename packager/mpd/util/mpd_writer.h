@@ -57,6 +57,22 @@ class MpdWriter {
   // If necessary, this method can be called after WriteMpd*() methods.
   bool AddFile(const std::string& media_info_path);
 
+  // Add many MediaInfo files at once. The files are read and parsed
+  // concurrently on the shared thread pool, but their MediaInfo is added in
+  // the order given, so the generated MPD is identical to calling AddFile()
+  // in a loop. Files that fail to load are logged and skipped.
+  // Returns true if every file was added.
+  bool AddFiles(const std::vector<std::string>& media_info_paths);
+
+  // Add a bundle: a single file holding any number of binary MediaInfo
+  // messages, each prefixed with its serialized size as a protobuf varint
+  // (the standard size-delimited stream format). A batch pipeline can hand
+  // over thousands of renditions in one file open this way. The MediaInfos
+  // are added in the order they appear in the bundle.
+  // Returns false if the bundle cannot be read or any message is malformed;
+  // messages before the malformed one are kept.
+  bool AddMediaInfoBundle(const std::string& bundle_path);
+
   // |base_url| will be used for <BaseURL> element for the MPD. The BaseURL
   // element will be a direct child element of the <MPD> element.
   void AddBaseUrl(const std::string& base_url);
@@ -73,6 +89,10 @@ class MpdWriter {
  private:
   friend class MpdWriterTest;
 
+  // Reads and parses one MediaInfo file, in either text or binary format.
+  static bool LoadMediaInfo(const std::string& media_info_path,
+                            MediaInfo* media_info);
+
   void SetMpdNotifierFactoryForTest(
       std::unique_ptr<MpdNotifierFactory> factory);
 
@@ -10,8 +10,12 @@
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 
+#include <packager/file.h>
 #include <packager/file/file_test_util.h>
+#include <packager/mpd/base/media_info.pb.h>
 #include <packager/mpd/base/mock_mpd_notifier.h>
 #include <packager/mpd/base/mpd_options.h>
 #include <packager/mpd/test/mpd_builder_test_helper.h>
@@ -99,4 +103,48 @@ TEST_F(MpdWriterTest, WriteMpdToFile) {
   EXPECT_TRUE(mpd_writer_.WriteMpdToFile(temp->path().c_str()));
 }
 
+// AddFiles() parses concurrently but must produce the same MPD as calling
+// AddFile() in a loop.
+TEST_F(MpdWriterTest, AddFiles) {
+  std::filesystem::path media_info_file1 =
+      GetTestDataFilePath(kFileNameVideoMediaInfo1);
+  std::filesystem::path media_info_file2 =
+      GetTestDataFilePath(kFileNameVideoMediaInfo2);
+
+  SetMpdNotifierFactoryForTest();
+  EXPECT_TRUE(mpd_writer_.AddFiles(
+      {media_info_file1.string(), media_info_file2.string()}));
+
+  auto temp = new TempFile();
+  EXPECT_TRUE(mpd_writer_.WriteMpdToFile(temp->path().c_str()));
+}
+
+// A bundle of size-delimited binary MediaInfos behaves like adding the same
+// MediaInfo files one by one.
+TEST_F(MpdWriterTest, AddMediaInfoBundle) {
+  const MediaInfo media_info1 = GetTestMediaInfo(kFileNameVideoMediaInfo1);
+  const MediaInfo media_info2 = GetTestMediaInfo(kFileNameVideoMediaInfo2);
+
+  std::string bundle;
+  {
+    ::google::protobuf::io::StringOutputStream output(&bundle);
+    ::google::protobuf::io::CodedOutputStream coded(&output);
+    for (const MediaInfo* media_info : {&media_info1, &media_info2}) {
+      std::string serialized;
+      ASSERT_TRUE(media_info->SerializeToString(&serialized));
+      coded.WriteVarint32(static_cast<uint32_t>(serialized.size()));
+      coded.WriteString(serialized);
+    }
+  }
+
+  TempFile bundle_file;
+  ASSERT_TRUE(File::WriteStringToFile(bundle_file.path().c_str(), bundle));
+
+  SetMpdNotifierFactoryForTest();
+  EXPECT_TRUE(mpd_writer_.AddMediaInfoBundle(bundle_file.path()));
+
+  auto temp = new TempFile();
+  EXPECT_TRUE(mpd_writer_.WriteMpdToFile(temp->path().c_str()));
+}
+
 }  // namespace shaka
@@ -8,24 +8,39 @@
 
 #include <algorithm>
 #include <chrono>
+#include <list>
+#include <map>
 #include <optional>
+#include <set>
 
 #include <absl/log/check.h>
 #include <absl/log/log.h>
 #include <absl/strings/match.h>
 #include <absl/strings/str_format.h>
+#include <absl/synchronization/mutex.h>
+#include <absl/synchronization/notification.h>
+#include <absl/time/time.h>
 
 #include <packager/app/job_manager.h>
 #include <packager/app/muxer_factory.h>
 #include <packager/app/packager_util.h>
 #include <packager/app/single_thread_job_manager.h>
+#include <packager/app/work_stealing_job_manager.h>
 #include <packager/file.h>
+#include <packager/file/cached_http_file.h>
+#include <packager/file/hashing_file.h>
+#include <packager/file/http_file.h>
+#include <packager/file/thread_pool.h>
 #include <packager/hls/base/hls_notifier.h>
 #include <packager/hls/base/simple_hls_notifier.h>
+#include <packager/hls/base/threaded_hls_notifier.h>
 #include <packager/macros/logging.h>
 #include <packager/macros/status.h>
 #include <packager/media/base/cc_stream_filter.h>
 #include <packager/media/base/language_utils.h>
+#include <packager/media/base/load_shedder.h>
+#include <packager/media/base/media_handler.h>
+#include <packager/media/base/memory_tracker.h>
 #include <packager/media/base/muxer.h>
 #include <packager/media/base/muxer_util.h>
 #include <packager/media/chunking/chunking_handler.h>
@@ -33,15 +48,24 @@
 #include <packager/media/chunking/text_chunker.h>
 #include <packager/media/crypto/encryption_handler.h>
 #include <packager/media/demuxer/demuxer.h>
+#include <packager/media/event/combined_muxer_listener.h>
 #include <packager/media/event/muxer_listener_factory.h>
+#include <packager/media/event/progress_aggregator.h>
+#include <packager/media/event/segment_checkpoint_muxer_listener.h>
+#include <packager/media/event/segment_fan_out_muxer_listener.h>
 #include <packager/media/event/vod_media_info_dump_muxer_listener.h>
+#include <packager/media/formats/dvb/subtitle_composer.h>
 #include <packager/media/formats/ttml/ttml_to_mp4_handler.h>
-#include <packager/media/formats/webvtt/text_padder.h>
 #include <packager/media/formats/webvtt/webvtt_to_mp4_handler.h>
 #include <packager/media/replicator/replicator.h>
 #include <packager/media/trick_play/trick_play_handler.h>
 #include <packager/mpd/base/media_info.pb.h>
 #include <packager/mpd/base/simple_mpd_notifier.h>
+#include <packager/mpd/base/threaded_mpd_notifier.h>
+#include <packager/utils/numa.h>
+#include <packager/utils/stall_monitor.h>
+#include <packager/utils/virtual_clock.h>
+#include <packager/utils/watchdog.h>
 #include <packager/version/version.h>
 
 namespace shaka {
@@ -53,6 +77,7 @@ using media::KeySource;
 using media::MuxerOptions;
 using media::SingleThreadJobManager;
 using media::SyncPointQueue;
+using media::WorkStealingJobManager;
 
 namespace media {
 namespace {
@@ -87,12 +112,31 @@ MuxerListenerFactory::StreamData ToMuxerListenerData(
 bool DetermineTextFileCodec(const std::string& file, std::string* out) {
   CHECK(out);
 
-  std::string content;
-  if (!File::ReadFileToString(file.c_str(), &content)) {
+  // Container detection only needs the head of the file. Reading a bounded
+  // probe instead of the whole file keeps startup independent of the subtitle
+  // file size.
+  const size_t kProbeSize = 0x10000;  // 64KB, matches the Demuxer probe.
+  std::unique_ptr<File, FileCloser> media_file(File::Open(file.c_str(), "r"));
+  if (!media_file) {
     LOG(ERROR) << "Failed to open file " << file
                << " to determine file format.";
     return false;
   }
+  std::string content(kProbeSize, '\0');
+  size_t bytes_read = 0;
+  while (bytes_read < kProbeSize) {
+    const int64_t read_result =
+        media_file->Read(&content[bytes_read], kProbeSize - bytes_read);
+    if (read_result < 0) {
+      LOG(ERROR) << "Failed to read file " << file
+                 << " to determine file format.";
+      return false;
+    }
+    if (read_result == 0)
+      break;
+    bytes_read += read_result;
+  }
+  content.resize(bytes_read);
 
   const uint8_t* content_data =
       reinterpret_cast<const uint8_t*>(content.data());
@@ -392,6 +436,79 @@ bool StreamDescriptorCompareFn(const StreamDescriptor& a,
   return a.input < b.input;
 }
 
+// Returns true if |dash| and |hls| describe the same muxed track published
+// under two manifests: |dash| is dash_only, |hls| is hls_only, and every
+// field that affects the serialized segment bytes matches. Output locations
+// and the manifest-facing attributes are allowed to differ.
+bool IsDualManifestPair(const StreamDescriptor& dash,
+                        const StreamDescriptor& hls) {
+  if (!dash.dash_only || !hls.hls_only)
+    return false;
+  // Streams without an output do not create a muxer, so there is nothing to
+  // fold.
+  if (dash.output.empty() && dash.segment_template.empty())
+    return false;
+  if (hls.output.empty() && hls.segment_template.empty())
+    return false;
+  return dash.input == hls.input &&
+         dash.stream_selector == hls.stream_selector &&
+         GetOutputFormat(dash) == GetOutputFormat(hls) &&
+         dash.skip_encryption == hls.skip_encryption &&
+         dash.drm_label == hls.drm_label &&
+         dash.trick_play_factor == hls.trick_play_factor &&
+         dash.bandwidth == hls.bandwidth && dash.language == hls.language &&
+         dash.cc_index == hls.cc_index &&
+         dash.input_format == hls.input_format &&
+         dash.forced_subtitle == hls.forced_subtitle;
+}
+
+// Returns true if |a| and |b| resolve to the same muxed track published
+// under different output names: every field that affects the serialized
+// segment bytes matches, including the manifest visibility, and only the
+// output naming differs. Such descriptors commonly come from ladder variant
+// job definitions that re-list the shared audio per output set.
+bool IsDuplicateStreamPair(const StreamDescriptor& a,
+                           const StreamDescriptor& b) {
+  // Streams without an output do not create a muxer, so there is nothing to
+  // share.
+  if (a.output.empty() && a.segment_template.empty())
+    return false;
+  if (b.output.empty() && b.segment_template.empty())
+    return false;
+  return a.input == b.input && a.stream_selector == b.stream_selector &&
+         GetOutputFormat(a) == GetOutputFormat(b) &&
+         a.skip_encryption == b.skip_encryption &&
+         a.drm_label == b.drm_label &&
+         a.trick_play_factor == b.trick_play_factor &&
+         a.bandwidth == b.bandwidth && a.language == b.language &&
+         a.cc_index == b.cc_index && a.input_format == b.input_format &&
+         a.forced_subtitle == b.forced_subtitle &&
+         a.dash_only == b.dash_only && a.hls_only == b.hls_only;
+}
+
+// Alias output naming of a deduplicated stream descriptor, republished from
+// the surviving descriptor's muxer through SegmentFanOutMuxerListener.
+struct FanOutTarget {
+  std::string output;
+  std::string segment_template;
+};
+
+// Folds a dash_only / hls_only pair into one stream descriptor that muxes
+// once and feeds both manifests. The dash descriptor's output naming wins;
+// the HLS attributes are taken from the hls descriptor so its playlist keeps
+// its name, group and characteristics while referencing the shared segments.
+StreamDescriptor MergeDualManifestPair(const StreamDescriptor& dash,
+                                       const StreamDescriptor& hls) {
+  StreamDescriptor merged = dash;
+  merged.dash_only = false;
+  merged.hls_name = hls.hls_name;
+  merged.hls_group_id = hls.hls_group_id;
+  merged.hls_playlist_name = hls.hls_playlist_name;
+  merged.hls_iframe_playlist_name = hls.hls_iframe_playlist_name;
+  merged.hls_characteristics = hls.hls_characteristics;
+  return merged;
+}
+
 // A fake clock that always return time 0 (epoch). Should only be used for
 // testing.
 class FakeClock : public Clock {
@@ -401,6 +518,18 @@ class FakeClock : public Clock {
   }
 };
 
+// Adapts a shared clock to the exclusive ownership expected by MpdBuilder,
+// so the muxers and the MPD can be driven from the same VirtualClock.
+class SharedClockAdapter : public Clock {
+ public:
+  explicit SharedClockAdapter(std::shared_ptr<Clock> clock)
+      : clock_(std::move(clock)) {}
+  time_point now() noexcept override { return clock_->now(); }
+
+ private:
+  std::shared_ptr<Clock> clock_;
+};
+
 bool StreamInfoToTextMediaInfo(const StreamDescriptor& stream_descriptor,
                                MediaInfo* text_media_info) {
   std::string codec;
@@ -453,6 +582,7 @@ Status CreateDemuxer(const StreamDescriptor& stream,
   std::shared_ptr<Demuxer> demuxer = std::make_shared<Demuxer>(stream.input);
   demuxer->set_dump_stream_info(packaging_params.test_params.dump_stream_info);
   demuxer->set_input_format(stream.input_format);
+  demuxer->set_dispatch_buffer_bytes(packaging_params.demux_buffer_bytes);
 
   if (packaging_params.decryption_params.key_provider != KeyProvider::kNone) {
     std::unique_ptr<KeySource> decryption_key_source(
@@ -514,11 +644,12 @@ std::shared_ptr<MediaHandler> CreateEncryptionHandler(
 }
 
 std::unique_ptr<MediaHandler> CreateTextChunker(
-    const ChunkingParams& chunking_params) {
+    const ChunkingParams& chunking_params,
+    int32_t default_text_zero_bias_ms) {
   const float segment_length_in_seconds =
       chunking_params.segment_duration_in_seconds;
   return std::unique_ptr<MediaHandler>(
-      new TextChunker(segment_length_in_seconds));
+      new TextChunker(segment_length_in_seconds, default_text_zero_bias_ms));
 }
 
 Status CreateTtmlJobs(
@@ -529,6 +660,7 @@ Status CreateTtmlJobs(
     MpdNotifier* mpd_notifier,
     JobManager* job_manager) {
   DCHECK(job_manager);
+  std::vector<std::reference_wrapper<const StreamDescriptor>> output_streams;
   for (const StreamDescriptor& stream : streams) {
     // Check input to ensure that output is possible.
     if (!packaging_params.hls_params.master_playlist_output.empty() &&
@@ -547,37 +679,66 @@ Status CreateTtmlJobs(
                     "Converting TTML to other formats is not supported");
     }
 
-    if (!stream.output.empty()) {
+    if (!stream.output.empty())
+      output_streams.push_back(stream);
+  }
+
+  // Copy and probe all inputs concurrently; each one is an independent round
+  // trip to storage, so startup is bounded by the slowest input instead of
+  // the sum over all of them. Manifest updates stay on this thread below.
+  absl::Mutex mutex;
+  Status copy_status;                           // Protected by |mutex|.
+  size_t pending_streams = output_streams.size();  // Protected by |mutex|.
+  std::vector<MediaInfo> text_media_infos(output_streams.size());
+
+  for (size_t i = 0; i < output_streams.size(); ++i) {
+    ThreadPool::instance.PostTask([&output_streams, &text_media_infos, &mutex,
+                                   &copy_status, &pending_streams, i]() {
+      const StreamDescriptor& stream = output_streams[i].get();
+      Status status;
       if (!File::Copy(stream.input.c_str(), stream.output.c_str())) {
         std::string error;
         absl::StrAppendFormat(
             &error, "Failed to copy the input file (%s) to output file (%s).",
             stream.input.c_str(), stream.output.c_str());
-        return Status(error::FILE_FAILURE, error);
-      }
-
-      MediaInfo text_media_info;
-      if (!StreamInfoToTextMediaInfo(stream, &text_media_info)) {
-        return Status(error::INVALID_ARGUMENT,
-                      "Could not create media info for stream.");
+        status = Status(error::FILE_FAILURE, error);
+      } else if (!StreamInfoToTextMediaInfo(stream, &text_media_infos[i])) {
+        status = Status(error::INVALID_ARGUMENT,
+                        "Could not create media info for stream.");
       }
-
-      // If we are outputting to MPD, just add the input to the outputted
-      // manifest.
-      if (mpd_notifier) {
-        uint32_t unused;
-        if (mpd_notifier->NotifyNewContainer(text_media_info, &unused)) {
-          mpd_notifier->Flush();
-        } else {
-          return Status(error::PARSER_FAILURE,
-                        "Failed to process text file " + stream.input);
-        }
+      absl::MutexLock lock(&mutex);
+      copy_status.Update(status);
+      --pending_streams;
+    });
+  }
+  {
+    absl::MutexLock lock(&mutex);
+    mutex.Await(absl::Condition(
+        +[](size_t* pending) { return *pending == 0; }, &pending_streams));
+  }
+  if (!copy_status.ok())
+    return copy_status;
+
+  for (size_t i = 0; i < output_streams.size(); ++i) {
+    const StreamDescriptor& stream = output_streams[i].get();
+    const MediaInfo& text_media_info = text_media_infos[i];
+
+    // If we are outputting to MPD, just add the input to the outputted
+    // manifest.
+    if (mpd_notifier) {
+      uint32_t unused;
+      if (mpd_notifier->NotifyNewContainer(text_media_info, &unused)) {
+        mpd_notifier->Flush();
+      } else {
+        return Status(error::PARSER_FAILURE,
+                      "Failed to process text file " + stream.input);
       }
+    }
 
-      if (packaging_params.output_media_info) {
-        VodMediaInfoDumpMuxerListener::WriteMediaInfoToFile(
-            text_media_info, stream.output + kMediaInfoSuffix);
-      }
+    if (packaging_params.output_media_info) {
+      VodMediaInfoDumpMuxerListener::WriteMediaInfoToFile(
+          text_media_info, stream.output + kMediaInfoSuffix,
+          packaging_params.output_media_info_binary);
     }
   }
 
@@ -591,15 +752,22 @@ Status CreateAudioVideoJobs(
     SyncPointQueue* sync_points,
     MuxerListenerFactory* muxer_listener_factory,
     MuxerFactory* muxer_factory,
-    JobManager* job_manager) {
+    const std::map<const StreamDescriptor*, std::vector<FanOutTarget>>&
+        fan_out_targets,
+    JobManager* job_manager,
+    std::map<std::string, std::shared_ptr<Replicator>>* replicators) {
   DCHECK(muxer_listener_factory);
   DCHECK(muxer_factory);
   DCHECK(job_manager);
+  DCHECK(replicators);
   // Store all the demuxers in a map so that we can look up a stream's demuxer.
   // This is step one in making this part of the pipeline less dependant on
   // order.
   std::map<std::string, std::shared_ptr<Demuxer>> sources;
   std::map<std::string, std::shared_ptr<MediaHandler>> cue_aligners;
+  // Job-level memory accounting, one tracker per input so a misbehaving
+  // source only throttles its own job.
+  std::map<std::string, std::shared_ptr<MemoryTracker>> memory_trackers;
 
   for (const StreamDescriptor& stream : streams) {
     bool seen_input_before = sources.find(stream.input) != sources.end();
@@ -607,10 +775,34 @@ Status CreateAudioVideoJobs(
       continue;
     }
 
+    std::shared_ptr<MemoryTracker> memory_tracker;
+    if (packaging_params.job_memory_limit_bytes > 0) {
+      memory_tracker = std::make_shared<MemoryTracker>(
+          packaging_params.job_memory_limit_bytes);
+      const std::string input = stream.input;
+      const auto pressure_callback = packaging_params.memory_pressure_callback;
+      memory_tracker->set_pressure_callback(
+          [input, pressure_callback](uint64_t buffered_bytes,
+                                     uint64_t budget_bytes) {
+            LOG(WARNING) << "Job for input " << input
+                         << " reached memory pressure (" << buffered_bytes
+                         << " of " << budget_bytes
+                         << " buffered bytes); spilling and throttling until "
+                            "it drains.";
+            if (pressure_callback)
+              pressure_callback(input, buffered_bytes, budget_bytes);
+          });
+    }
+    memory_trackers[stream.input] = memory_tracker;
+
     RETURN_IF_ERROR(
         CreateDemuxer(stream, packaging_params, &sources[stream.input]));
+    sources[stream.input]->set_memory_tracker(memory_tracker);
     cue_aligners[stream.input] =
-        sync_points ? std::make_shared<CueAlignmentHandler>(sync_points)
+        sync_points ? std::make_shared<CueAlignmentHandler>(
+                          sync_points, packaging_params.temp_dir,
+                          packaging_params.sample_buffer_spill_bytes,
+                          memory_tracker)
                     : nullptr;
   }
 
@@ -619,8 +811,9 @@ Status CreateAudioVideoJobs(
   }
 
   // Replicators are shared among all streams with the same input and stream
-  // selector.
-  std::shared_ptr<MediaHandler> replicator;
+  // selector. They are also recorded in |replicators| so new output branches
+  // can be attached at runtime through Packager::AddStreamDescriptor().
+  std::shared_ptr<Replicator> replicator;
 
   std::string previous_input;
   std::string previous_selector;
@@ -652,10 +845,6 @@ Status CreateAudioVideoJobs(
       }
 
       std::vector<std::shared_ptr<MediaHandler>> handlers;
-      if (is_text) {
-        handlers.emplace_back(std::make_shared<TextPadder>(
-            packaging_params.default_text_zero_bias_ms));
-      }
       if (sync_points) {
         handlers.emplace_back(cue_aligner);
       }
@@ -667,6 +856,7 @@ Status CreateAudioVideoJobs(
       }
 
       replicator = std::make_shared<Replicator>();
+      (*replicators)[stream.input + ":" + stream.stream_selector] = replicator;
       handlers.emplace_back(replicator);
 
       RETURN_IF_ERROR(MediaHandler::Chain(handlers));
@@ -685,15 +875,33 @@ Status CreateAudioVideoJobs(
 
     std::unique_ptr<MuxerListener> muxer_listener =
         muxer_listener_factory->CreateListener(ToMuxerListenerData(stream));
+    // Republish this muxer's files under the naming of any descriptors that
+    // were deduplicated into this one.
+    const auto fan_out_it = fan_out_targets.find(&stream);
+    if (fan_out_it != fan_out_targets.end()) {
+      auto combined_listener = std::make_unique<CombinedMuxerListener>();
+      combined_listener->AddListener(std::move(muxer_listener));
+      for (const FanOutTarget& target : fan_out_it->second) {
+        combined_listener->AddListener(
+            std::make_unique<SegmentFanOutMuxerListener>(
+                target.output, target.segment_template));
+      }
+      muxer_listener = std::move(combined_listener);
+    }
     muxer->SetMuxerListener(std::move(muxer_listener));
+    // Progress publishes into a per-muxer atomic slot; aggregated on demand
+    // through Packager::DumpPipelineStats().
+    muxer->SetProgressListener(ProgressAggregator::Instance()->CreateListener());
 
     std::vector<std::shared_ptr<MediaHandler>> handlers;
     handlers.emplace_back(replicator);
 
     // Trick play is optional.
     if (stream.trick_play_factor) {
-      handlers.emplace_back(
-          std::make_shared<TrickPlayHandler>(stream.trick_play_factor));
+      handlers.emplace_back(std::make_shared<TrickPlayHandler>(
+          stream.trick_play_factor, packaging_params.temp_dir,
+          packaging_params.sample_buffer_spill_bytes,
+          memory_trackers[stream.input]));
     }
 
     if (stream.cc_index >= 0) {
@@ -704,7 +912,8 @@ Status CreateAudioVideoJobs(
     if (is_text &&
         (!stream.segment_template.empty() || output_format == CONTAINER_MOV)) {
       handlers.emplace_back(
-          CreateTextChunker(packaging_params.chunking_params));
+          CreateTextChunker(packaging_params.chunking_params,
+                            packaging_params.default_text_zero_bias_ms));
     }
 
     if (is_text && output_format == CONTAINER_MOV) {
@@ -723,14 +932,16 @@ Status CreateAudioVideoJobs(
   return Status::OK;
 }
 
-Status CreateAllJobs(const std::vector<StreamDescriptor>& stream_descriptors,
-                     const PackagingParams& packaging_params,
-                     MpdNotifier* mpd_notifier,
-                     KeySource* encryption_key_source,
-                     SyncPointQueue* sync_points,
-                     MuxerListenerFactory* muxer_listener_factory,
-                     MuxerFactory* muxer_factory,
-                     JobManager* job_manager) {
+Status CreateAllJobs(
+    const std::vector<StreamDescriptor>& stream_descriptors,
+    const PackagingParams& packaging_params,
+    MpdNotifier* mpd_notifier,
+    KeySource* encryption_key_source,
+    SyncPointQueue* sync_points,
+    MuxerListenerFactory* muxer_listener_factory,
+    MuxerFactory* muxer_factory,
+    JobManager* job_manager,
+    std::map<std::string, std::shared_ptr<Replicator>>* replicators) {
   DCHECK(muxer_factory);
   DCHECK(muxer_listener_factory);
   DCHECK(job_manager);
@@ -773,6 +984,83 @@ Status CreateAllJobs(const std::vector<StreamDescriptor>& stream_descriptors,
   std::sort(audio_video_streams.begin(), audio_video_streams.end(),
             media::StreamDescriptorCompareFn);
 
+  // With CMAF content the same track is commonly listed twice, once dash_only
+  // and once hls_only, which builds two muxers that serialize identical
+  // segment bytes. When enabled, fold such pairs into one stream that muxes
+  // once and feeds both notifiers from the same segment events. Both
+  // manifests then reference the dash descriptor's segments; the hls_only
+  // descriptor's output naming is dropped. Keeps storage for the merged
+  // descriptors alive until the jobs are set up.
+  std::list<StreamDescriptor> merged_streams;
+  if (packaging_params.share_dual_manifest_segments) {
+    std::vector<std::reference_wrapper<const StreamDescriptor>> folded;
+    for (size_t i = 0; i < audio_video_streams.size(); ++i) {
+      if (i + 1 < audio_video_streams.size()) {
+        // The sort above makes candidate pairs adjacent but leaves the order
+        // within a pair unspecified, so check both directions.
+        const StreamDescriptor& a = audio_video_streams[i];
+        const StreamDescriptor& b = audio_video_streams[i + 1];
+        const StreamDescriptor* dash = nullptr;
+        const StreamDescriptor* hls = nullptr;
+        if (IsDualManifestPair(a, b)) {
+          dash = &a;
+          hls = &b;
+        } else if (IsDualManifestPair(b, a)) {
+          dash = &b;
+          hls = &a;
+        }
+        if (dash) {
+          LOG(INFO) << "Muxing '" << dash->input << ":"
+                    << dash->stream_selector
+                    << "' once for both DASH and HLS; ignoring output naming '"
+                    << (hls->segment_template.empty() ? hls->output
+                                                      : hls->segment_template)
+                    << "' of the hls_only descriptor.";
+          merged_streams.push_back(MergeDualManifestPair(*dash, *hls));
+          folded.push_back(merged_streams.back());
+          ++i;
+          continue;
+        }
+      }
+      folded.push_back(audio_video_streams[i]);
+    }
+    audio_video_streams = std::move(folded);
+  }
+
+  // Descriptors that serialize byte-identical outputs under different names
+  // (typically the shared audio re-listed per ladder variant) share one
+  // pipeline when enabled; the dropped descriptors' naming is served by
+  // copying the surviving muxer's files through SegmentFanOutMuxerListener.
+  // The sort above makes candidates adjacent.
+  std::map<const StreamDescriptor*, std::vector<FanOutTarget>> fan_out_targets;
+  if (packaging_params.deduplicate_repeated_streams) {
+    std::vector<std::reference_wrapper<const StreamDescriptor>> deduped;
+    for (size_t i = 0; i < audio_video_streams.size(); ++i) {
+      const StreamDescriptor& primary = audio_video_streams[i];
+      deduped.push_back(audio_video_streams[i]);
+      while (i + 1 < audio_video_streams.size() &&
+             IsDuplicateStreamPair(primary, audio_video_streams[i + 1])) {
+        const StreamDescriptor& duplicate = audio_video_streams[i + 1];
+        ++i;
+        if (duplicate.output == primary.output &&
+            duplicate.segment_template == primary.segment_template) {
+          // A literal repeat; dropping it is enough.
+          continue;
+        }
+        LOG(INFO) << "Muxing '" << primary.input << ":"
+                  << primary.stream_selector
+                  << "' once; republishing its output under '"
+                  << (duplicate.segment_template.empty()
+                          ? duplicate.output
+                          : duplicate.segment_template)
+                  << "'.";
+        fan_out_targets[&primary].push_back(
+            {duplicate.output, duplicate.segment_template});
+      }
+    }
+    audio_video_streams = std::move(deduped);
+  }
+
   if (packaging_params.transport_stream_timestamp_offset_ms > 0) {
     if (has_transport_audio_video_streams &&
         has_non_transport_audio_video_streams) {
@@ -790,7 +1078,8 @@ Status CreateAllJobs(const std::vector<StreamDescriptor>& stream_descriptors,
                                  muxer_factory, mpd_notifier, job_manager));
   RETURN_IF_ERROR(CreateAudioVideoJobs(
       audio_video_streams, packaging_params, encryption_key_source, sync_points,
-      muxer_listener_factory, muxer_factory, job_manager));
+      muxer_listener_factory, muxer_factory, fan_out_targets, job_manager,
+      replicators));
 
   // Initialize processing graph.
   return job_manager->InitializeJobs();
@@ -799,18 +1088,91 @@ Status CreateAllJobs(const std::vector<StreamDescriptor>& stream_descriptors,
 }  // namespace
 }  // namespace media
 
+namespace {
+
+// Extracts "scheme://host[:port]/" from |url| so each origin is pre-warmed
+// only once, or returns an empty string for non-http(s) urls.
+std::string HttpOrigin(const std::string& url) {
+  if (!absl::StartsWith(url, "http://") && !absl::StartsWith(url, "https://"))
+    return "";
+  const size_t host_start = url.find("://") + 3;
+  const size_t path_start = url.find('/', host_start);
+  return path_start == std::string::npos ? url + "/"
+                                         : url.substr(0, path_start + 1);
+}
+
+// Resolves DNS and establishes TLS sessions to the key servers and output
+// origins on worker threads, concurrently with pipeline construction. The
+// cached DNS results and TLS session tickets take the handshakes off the
+// critical path of the first license request and the first segment upload.
+// |warmed_origins|, if not null, is a set of origins persisting across jobs
+// (owned by a PackagerEngine): origins already in it are skipped and newly
+// warmed ones are added.
+void PreWarmHttpConnections(
+    const PackagingParams& packaging_params,
+    const std::vector<StreamDescriptor>& stream_descriptors,
+    std::set<std::string>* warmed_origins) {
+  std::set<std::string> origins;
+  origins.insert(
+      HttpOrigin(packaging_params.encryption_params.widevine.key_server_url));
+  origins.insert(
+      HttpOrigin(packaging_params.encryption_params.playready.key_server_url));
+  origins.insert(
+      HttpOrigin(packaging_params.decryption_params.widevine.key_server_url));
+  origins.insert(HttpOrigin(packaging_params.mpd_params.mpd_output));
+  origins.insert(
+      HttpOrigin(packaging_params.hls_params.master_playlist_output));
+  for (const StreamDescriptor& stream : stream_descriptors) {
+    origins.insert(HttpOrigin(stream.output));
+    origins.insert(HttpOrigin(stream.segment_template));
+  }
+  origins.erase("");
+
+  for (const std::string& origin : origins) {
+    if (warmed_origins && !warmed_origins->insert(origin).second)
+      continue;
+    ThreadPool::instance.PostTask([origin]() { HttpFile::PreWarm(origin); });
+  }
+}
+
+}  // namespace
+
 struct Packager::PackagerInternal {
   std::shared_ptr<media::FakeClock> fake_clock;
   std::unique_ptr<KeySource> encryption_key_source;
-  std::unique_ptr<MpdNotifier> mpd_notifier;
-  std::unique_ptr<hls::HlsNotifier> hls_notifier;
+  std::unique_ptr<ThreadedMpdNotifier> mpd_notifier;
+  std::unique_ptr<hls::ThreadedHlsNotifier> hls_notifier;
   BufferCallbackParams buffer_callback_params;
   std::unique_ptr<media::JobManager> job_manager;
+  std::unique_ptr<media::SegmentCheckpoint> segment_checkpoint;
+  double pipeline_stats_dump_period_seconds = 0;
+  // Kept alive after Initialize() so AddStreamDescriptor() can build new
+  // muxer branches for a running pipeline.
+  std::unique_ptr<media::MuxerFactory> muxer_factory;
+  std::unique_ptr<media::MuxerListenerFactory> muxer_listener_factory;
+  // Spill configuration for the sample queues of handlers created at runtime.
+  std::string temp_dir;
+  uint64_t sample_buffer_spill_bytes = 0;
+  // Per-stream fan-out points, keyed by "<input>:<stream selector>".
+  std::map<std::string, std::shared_ptr<media::Replicator>> replicators;
+  // Branches added at runtime, keyed by output path or segment template.
+  // Guards itself with |dynamic_outputs_mutex| since Add/Remove may be called
+  // from other threads while Run() is executing.
+  absl::Mutex dynamic_outputs_mutex;
+  std::map<std::string,
+           std::pair<std::shared_ptr<media::Replicator>,
+                     std::shared_ptr<media::MediaHandler>>>
+      dynamic_outputs ABSL_GUARDED_BY(dynamic_outputs_mutex);
 };
 
 Packager::Packager() {}
 
-Packager::~Packager() {}
+Packager::~Packager() {
+  // Stop before |internal_| is destroyed: the watchdog's stall callback
+  // references the job manager.
+  Watchdog::Stop();
+  media::LoadShedder::Disable();
+}
 
 Status Packager::Initialize(
     const PackagingParams& packaging_params,
@@ -820,6 +1182,17 @@ Status Packager::Initialize(
 
   RETURN_IF_ERROR(media::ValidateParams(packaging_params, stream_descriptors));
 
+  if (packaging_params.numa_node >= 0) {
+    // Pin before any worker thread exists so the whole pipeline inherits the
+    // affinity mask.
+    RETURN_IF_ERROR(PinToNumaNode(packaging_params.numa_node));
+  }
+
+  // Kick off network pre-warm first so the handshakes overlap with the rest
+  // of the pipeline construction below.
+  PreWarmHttpConnections(packaging_params, stream_descriptors,
+                         warmed_http_origins_);
+
   if (!packaging_params.test_params.injected_library_version.empty()) {
     SetPackagerVersionForTesting(
         packaging_params.test_params.injected_library_version);
@@ -827,6 +1200,12 @@ Status Packager::Initialize(
 
   std::unique_ptr<PackagerInternal> internal(new PackagerInternal);
 
+  media::MediaHandlerStatsRegistry::SetTimingEnabled(
+      packaging_params.enable_pipeline_stats);
+  media::ProgressAggregator::Instance()->Reset();
+  internal->pipeline_stats_dump_period_seconds =
+      packaging_params.pipeline_stats_dump_period_seconds;
+
   // Create encryption key source if needed.
   if (packaging_params.encryption_params.key_provider != KeyProvider::kNone) {
     internal->encryption_key_source = CreateEncryptionKeySource(
@@ -871,12 +1250,30 @@ Status Packager::Initialize(
   hls_params.is_independent_segments =
       packaging_params.chunking_params.segment_sap_aligned;
 
+  // Virtual time mode: muxers advance this clock to the end of each segment
+  // they finalize, and the MPD's publishTime and availabilityStartTime follow
+  // it, so long live channels can be soak-tested faster than real time.
+  std::shared_ptr<VirtualClock> virtual_clock;
+  if (packaging_params.enable_virtual_clock &&
+      !packaging_params.test_params.inject_fake_clock) {
+    virtual_clock = std::make_shared<VirtualClock>();
+  }
+
   if (!mpd_params.mpd_output.empty()) {
     const bool on_demand_dash_profile =
         stream_descriptors.begin()->segment_template.empty();
     const MpdOptions mpd_options =
         media::GetMpdOptions(on_demand_dash_profile, mpd_params);
-    internal->mpd_notifier.reset(new SimpleMpdNotifier(mpd_options));
+    // Segment notifications and MPD writes from concurrent muxer threads are
+    // funneled through ThreadedMpdNotifier so they do not serialize the
+    // muxers' sample paths.
+    auto simple_notifier = std::make_unique<SimpleMpdNotifier>(mpd_options);
+    if (virtual_clock) {
+      simple_notifier->InjectClock(
+          std::make_unique<media::SharedClockAdapter>(virtual_clock));
+    }
+    internal->mpd_notifier.reset(
+        new ThreadedMpdNotifier(mpd_options, std::move(simple_notifier)));
     if (!internal->mpd_notifier->Init()) {
       LOG(ERROR) << "MpdNotifier failed to initialize.";
       return Status(error::INVALID_ARGUMENT,
@@ -885,21 +1282,58 @@ Status Packager::Initialize(
   }
 
   if (!hls_params.master_playlist_output.empty()) {
-    internal->hls_notifier.reset(new hls::SimpleHlsNotifier(hls_params));
+    // Like the MPD side above, playlist updates are funneled through a
+    // threaded notifier: per-segment playlist writes come off the muxers'
+    // sample paths, coalesce per drain pass, and overlap with MPD publishes.
+    internal->hls_notifier.reset(new hls::ThreadedHlsNotifier(
+        hls_params, std::make_unique<hls::SimpleHlsNotifier>(hls_params)));
+    if (!internal->hls_notifier->Init()) {
+      LOG(ERROR) << "HlsNotifier failed to initialize.";
+      return Status(error::INVALID_ARGUMENT,
+                    "Failed to initialize HlsNotifier.");
+    }
   }
 
   std::unique_ptr<SyncPointQueue> sync_points;
-  if (!packaging_params.ad_cue_generator_params.cue_points.empty()) {
+  if (!packaging_params.ad_cue_generator_params.cue_points.empty() ||
+      packaging_params.allow_ad_cue_injection) {
     sync_points.reset(
         new SyncPointQueue(packaging_params.ad_cue_generator_params));
+    if (packaging_params.allow_ad_cue_injection)
+      sync_points->EnableRuntimeCues();
   }
   if (packaging_params.single_threaded) {
     internal->job_manager.reset(
         new SingleThreadJobManager(std::move(sync_points)));
+  } else if (packaging_params.worker_thread_count > 0) {
+    internal->job_manager.reset(new WorkStealingJobManager(
+        std::move(sync_points), packaging_params.worker_thread_count));
   } else {
     internal->job_manager.reset(new JobManager(std::move(sync_points)));
   }
 
+  // Start the watchdog before the jobs (and their ThreadedIoFile workers,
+  // which spin up as inputs are opened below) so every worker registers a
+  // heartbeat. The callback runs on the watchdog's own thread; job_manager
+  // outlives it because ~Packager() stops the watchdog first.
+  if (packaging_params.watchdog_stall_seconds > 0) {
+    media::JobManager* job_manager = internal->job_manager.get();
+    const bool fail_fast = packaging_params.watchdog_fail_fast;
+    Watchdog::Start(
+        packaging_params.watchdog_stall_seconds, [job_manager, fail_fast]() {
+          LOG(ERROR) << "Watchdog: pipeline stats: "
+                     << media::MediaHandlerStatsRegistry::DumpJson();
+          if (fail_fast) {
+            LOG(ERROR) << "Watchdog: cancelling all jobs "
+                          "(--watchdog_fail_fast).";
+            job_manager->CancelJobs();
+          }
+        });
+  }
+
+  if (packaging_params.load_shedding_lag_seconds > 0)
+    media::LoadShedder::Enable(packaging_params.load_shedding_lag_seconds);
+
   std::vector<StreamDescriptor> streams_for_jobs;
 
   for (const StreamDescriptor& descriptor : stream_descriptors) {
@@ -931,22 +1365,52 @@ Status Packager::Initialize(
     streams_for_jobs.push_back(copy);
   }
 
-  media::MuxerFactory muxer_factory(packaging_params);
+  internal->muxer_factory =
+      std::make_unique<media::MuxerFactory>(packaging_params);
+  internal->temp_dir = packaging_params.temp_dir;
+  internal->sample_buffer_spill_bytes =
+      packaging_params.sample_buffer_spill_bytes;
   if (packaging_params.test_params.inject_fake_clock) {
     internal->fake_clock.reset(new media::FakeClock());
-    muxer_factory.OverrideClock(internal->fake_clock);
+    internal->muxer_factory->OverrideClock(internal->fake_clock);
+  } else if (virtual_clock) {
+    internal->muxer_factory->UseVirtualClock(virtual_clock);
   }
 
-  media::MuxerListenerFactory muxer_listener_factory(
-      packaging_params.output_media_info,
-      packaging_params.mpd_params.use_segment_list,
-      internal->mpd_notifier.get(), internal->hls_notifier.get());
+  if (!packaging_params.checkpoint_file.empty() ||
+      !packaging_params.resume_from.empty()) {
+    internal->segment_checkpoint.reset(
+        new media::SegmentCheckpoint(packaging_params.checkpoint_file));
+    if (!packaging_params.resume_from.empty()) {
+      RETURN_IF_ERROR(
+          internal->segment_checkpoint->LoadFrom(packaging_params.resume_from));
+    }
+    internal->muxer_factory->SetResumeCheckpoint(
+        internal->segment_checkpoint.get());
+  }
+
+  if (packaging_params.output_segment_digests) {
+    // Turns on the inline hashing tee in the File factory; the per-stream
+    // SegmentDigestMuxerListener created below claims the digests.
+    HashingFile::SetEnabled(true);
+  }
+
+  internal->muxer_listener_factory =
+      std::make_unique<media::MuxerListenerFactory>(
+          packaging_params.output_media_info,
+          packaging_params.mpd_params.use_segment_list,
+          internal->mpd_notifier.get(), internal->hls_notifier.get(),
+          internal->segment_checkpoint.get(),
+          packaging_params.output_key_frame_index,
+          packaging_params.output_media_info_binary,
+          packaging_params.output_segment_digests);
 
   RETURN_IF_ERROR(media::CreateAllJobs(
       streams_for_jobs, packaging_params, internal->mpd_notifier.get(),
       internal->encryption_key_source.get(),
-      internal->job_manager->sync_points(), &muxer_listener_factory,
-      &muxer_factory, internal->job_manager.get()));
+      internal->job_manager->sync_points(),
+      internal->muxer_listener_factory.get(), internal->muxer_factory.get(),
+      internal->job_manager.get(), &internal->replicators));
 
   internal_ = std::move(internal);
   return Status::OK;
@@ -956,15 +1420,53 @@ Status Packager::Run() {
   if (!internal_)
     return Status(error::INVALID_ARGUMENT, "Not yet initialized.");
 
-  RETURN_IF_ERROR(internal_->job_manager->RunJobs());
+  // Optional periodic pipeline stats dump, stopped when the jobs finish. The
+  // notifications are on the heap and owned here so the dumper task can never
+  // outlive them.
+  std::unique_ptr<absl::Notification> stop_stats_dump;
+  std::unique_ptr<absl::Notification> stats_dump_done;
+  const double dump_period = internal_->pipeline_stats_dump_period_seconds;
+  if (dump_period > 0) {
+    stop_stats_dump.reset(new absl::Notification);
+    stats_dump_done.reset(new absl::Notification);
+    ThreadPool::instance.PostTask(
+        [stop = stop_stats_dump.get(), done = stats_dump_done.get(),
+         dump_period]() {
+          while (!stop->WaitForNotificationWithTimeout(
+              absl::Seconds(dump_period))) {
+            LOG(INFO) << "Pipeline stats: "
+                      << media::MediaHandlerStatsRegistry::DumpJson();
+          }
+          done->Notify();
+        });
+  }
+
+  Status run_status = internal_->job_manager->RunJobs();
+  if (stop_stats_dump) {
+    stop_stats_dump->Notify();
+    stats_dump_done->WaitForNotification();
+  }
+  // The jobs are done (or failed); further silence is expected, not a stall.
+  Watchdog::Stop();
+  // Final artifacts (manifests, media info) below must never be shed.
+  media::LoadShedder::Disable();
+  RETURN_IF_ERROR(run_status);
 
   if (internal_->hls_notifier) {
-    if (!internal_->hls_notifier->Flush())
+    // The threaded notifier flushes asynchronously; wait so the playlists
+    // are on disk before returning.
+    if (!internal_->hls_notifier->Flush() ||
+        !internal_->hls_notifier->WaitUntilIdle()) {
       return Status(error::INVALID_ARGUMENT, "Failed to flush Hls.");
+    }
   }
   if (internal_->mpd_notifier) {
-    if (!internal_->mpd_notifier->Flush())
+    // The threaded notifier flushes asynchronously; wait so the MPD is on
+    // disk before returning.
+    if (!internal_->mpd_notifier->Flush() ||
+        !internal_->mpd_notifier->WaitUntilIdle()) {
       return Status(error::INVALID_ARGUMENT, "Failed to flush Mpd.");
+    }
   }
   return Status::OK;
 }
@@ -977,6 +1479,183 @@ void Packager::Cancel() {
   internal_->job_manager->CancelJobs();
 }
 
+Status Packager::AddStreamDescriptor(
+    const StreamDescriptor& stream_descriptor) {
+  if (!internal_)
+    return Status(error::INVALID_ARGUMENT, "Not yet initialized.");
+
+  // Apply the same rewrites Initialize() applies to its descriptors.
+  StreamDescriptor copy = stream_descriptor;
+  if (internal_->buffer_callback_params.read_func) {
+    copy.input = File::MakeCallbackFileName(internal_->buffer_callback_params,
+                                            stream_descriptor.input);
+  }
+  if (internal_->buffer_callback_params.write_func) {
+    copy.output = File::MakeCallbackFileName(internal_->buffer_callback_params,
+                                             stream_descriptor.output);
+    copy.segment_template = File::MakeCallbackFileName(
+        internal_->buffer_callback_params, stream_descriptor.segment_template);
+  }
+  if (!copy.language.empty()) {
+    copy.language = LanguageToISO_639_2(stream_descriptor.language);
+    if (copy.language == "und") {
+      return Status(
+          error::INVALID_ARGUMENT,
+          "Unknown/invalid language specified: " + stream_descriptor.language);
+    }
+  }
+
+  RETURN_IF_ERROR(media::ValidateStreamDescriptor(
+      /* dump_stream_info= */ false, copy));
+  if (copy.output.empty() && copy.segment_template.empty()) {
+    return Status(error::INVALID_ARGUMENT,
+                  "The stream descriptor to add must have an output.");
+  }
+  if (media::IsTextStream(copy)) {
+    return Status(error::UNIMPLEMENTED,
+                  "Text streams cannot be added at runtime.");
+  }
+
+  const std::string replicator_key = copy.input + ":" + copy.stream_selector;
+  auto replicator_it = internal_->replicators.find(replicator_key);
+  if (replicator_it == internal_->replicators.end()) {
+    return Status(error::NOT_FOUND,
+                  "No running pipeline for '" + replicator_key +
+                      "'. Only new outputs of streams that are already being "
+                      "packaged can be added at runtime.");
+  }
+
+  const auto output_format = media::GetOutputFormat(copy);
+  std::shared_ptr<media::Muxer> muxer =
+      internal_->muxer_factory->CreateMuxer(output_format, copy);
+  if (!muxer) {
+    return Status(error::INVALID_ARGUMENT,
+                  "Failed to create muxer for " + replicator_key);
+  }
+  muxer->SetMuxerListener(internal_->muxer_listener_factory->CreateListener(
+      media::ToMuxerListenerData(copy)));
+  muxer->SetProgressListener(
+      media::ProgressAggregator::Instance()->CreateListener());
+
+  // Mirror the per-track branch that CreateAudioVideoJobs() builds; the
+  // shared part of the pipeline (chunking, encryption) is upstream of the
+  // replicator and is reused as is.
+  std::vector<std::shared_ptr<media::MediaHandler>> handlers;
+  if (copy.trick_play_factor) {
+    // Runtime branches do not join the job's memory accounting; the
+    // per-stream spill budget still caps their buffering.
+    handlers.emplace_back(std::make_shared<media::TrickPlayHandler>(
+        copy.trick_play_factor, internal_->temp_dir,
+        internal_->sample_buffer_spill_bytes));
+  }
+  if (copy.cc_index >= 0) {
+    handlers.emplace_back(
+        std::make_shared<media::CcStreamFilter>(copy.language, copy.cc_index));
+  }
+  handlers.emplace_back(muxer);
+  RETURN_IF_ERROR(media::MediaHandler::Chain(handlers));
+
+  const std::string output_key =
+      copy.segment_template.empty() ? copy.output : copy.segment_template;
+  {
+    absl::MutexLock lock(&internal_->dynamic_outputs_mutex);
+    if (internal_->dynamic_outputs.find(output_key) !=
+        internal_->dynamic_outputs.end()) {
+      return Status(error::ALREADY_EXISTS,
+                    "Output '" + output_key + "' has already been added.");
+    }
+    RETURN_IF_ERROR(replicator_it->second->AttachOutput(handlers.front()));
+    internal_->dynamic_outputs[output_key] =
+        std::make_pair(replicator_it->second, handlers.front());
+  }
+  return Status::OK;
+}
+
+Status Packager::RemoveStreamDescriptor(
+    const StreamDescriptor& stream_descriptor) {
+  if (!internal_)
+    return Status(error::INVALID_ARGUMENT, "Not yet initialized.");
+
+  StreamDescriptor copy = stream_descriptor;
+  if (internal_->buffer_callback_params.write_func) {
+    copy.output = File::MakeCallbackFileName(internal_->buffer_callback_params,
+                                             stream_descriptor.output);
+    copy.segment_template = File::MakeCallbackFileName(
+        internal_->buffer_callback_params, stream_descriptor.segment_template);
+  }
+  const std::string output_key =
+      copy.segment_template.empty() ? copy.output : copy.segment_template;
+
+  absl::MutexLock lock(&internal_->dynamic_outputs_mutex);
+  auto it = internal_->dynamic_outputs.find(output_key);
+  if (it == internal_->dynamic_outputs.end()) {
+    return Status(error::NOT_FOUND,
+                  "No runtime-added output '" + output_key +
+                      "'. Only outputs added with AddStreamDescriptor() can "
+                      "be removed.");
+  }
+  RETURN_IF_ERROR(it->second.first->DetachOutput(it->second.second));
+  internal_->dynamic_outputs.erase(it);
+  return Status::OK;
+}
+
+Status Packager::InjectAdCue(double time_in_seconds) {
+  if (!internal_)
+    return Status(error::INVALID_ARGUMENT, "Not yet initialized.");
+
+  SyncPointQueue* sync_points = internal_->job_manager->sync_points();
+  if (!sync_points || !sync_points->runtime_cues_enabled()) {
+    return Status(error::INVALID_ARGUMENT,
+                  "Ad cue injection requires "
+                  "PackagingParams::allow_ad_cue_injection.");
+  }
+  if (!sync_points->AddCuePoint(time_in_seconds)) {
+    return Status(error::INVALID_ARGUMENT,
+                  absl::StrFormat("Cannot inject ad cue at %.3f: the streams "
+                                  "are already past it.",
+                                  time_in_seconds));
+  }
+  return Status::OK;
+}
+
+std::string Packager::DumpPipelineStats() const {
+  // The registry dump is a {"handlers":[...]} object; splice the stall
+  // attribution histograms in as a sibling key.
+  std::string json = media::MediaHandlerStatsRegistry::DumpJson();
+  DCHECK(!json.empty() && json.back() == '}');
+  json.insert(json.size() - 1, ",\"stalls\":" + StallMonitor::DumpJson());
+  const media::ProgressAggregator* progress =
+      media::ProgressAggregator::Instance();
+  json.insert(json.size() - 1,
+              absl::StrFormat(",\"progress\":%.6f,\"eta_seconds\":%.3f",
+                              progress->GetProgress(),
+                              progress->GetEtaSeconds()));
+  json.insert(json.size() - 1,
+              ",\"load_shedding\":" + media::LoadShedder::DumpJson());
+  uint64_t png_encodes = 0;
+  uint64_t png_dedup_hits = 0;
+  media::SubtitleComposer::GetPngDedupStats(&png_encodes, &png_dedup_hits);
+  if (png_encodes != 0 || png_dedup_hits != 0) {
+    json.insert(
+        json.size() - 1,
+        absl::StrFormat(",\"dvb_sub_png\":{\"encodes\":%d,\"dedup_hits\":%d,"
+                        "\"dedup_ratio\":%.3f}",
+                        png_encodes, png_dedup_hits,
+                        static_cast<double>(png_dedup_hits) /
+                            (png_encodes + png_dedup_hits)));
+  }
+  uint64_t http_origin_fetches = 0;
+  uint64_t http_cache_hits = 0;
+  CachedHttpFile::GetCacheStats(&http_origin_fetches, &http_cache_hits);
+  if (http_origin_fetches != 0 || http_cache_hits != 0) {
+    json.insert(
+        json.size() - 1,
+        absl::StrFormat(",\"http_cache\":{\"origin_fetches\":%d,\"hits\":%d}",
+                        http_origin_fetches, http_cache_hits));
+  }
+  return json;
+}
+
 std::string Packager::GetLibraryVersion() {
   return GetPackagerVersion();
 }
@@ -1004,4 +1683,43 @@ std::string Packager::DefaultStreamLabelFunction(
   return "";
 }
 
+struct PackagerEngine::EngineInternal {
+  // Origins pre-warmed by earlier jobs; handed to each job's Packager so
+  // PreWarmHttpConnections() skips them. Only touched from Run(), which is
+  // sequential, so it needs no lock.
+  std::set<std::string> warmed_http_origins;
+  // Guards |running_job| since Cancel() may be called from another thread
+  // while Run() is executing.
+  absl::Mutex mutex;
+  Packager* running_job ABSL_GUARDED_BY(mutex) = nullptr;
+};
+
+PackagerEngine::PackagerEngine() : internal_(new EngineInternal) {}
+
+PackagerEngine::~PackagerEngine() {}
+
+Status PackagerEngine::Run(
+    const PackagingParams& packaging_params,
+    const std::vector<StreamDescriptor>& stream_descriptors) {
+  Packager packager;
+  packager.warmed_http_origins_ = &internal_->warmed_http_origins;
+  RETURN_IF_ERROR(packager.Initialize(packaging_params, stream_descriptors));
+  {
+    absl::MutexLock lock(&internal_->mutex);
+    internal_->running_job = &packager;
+  }
+  Status status = packager.Run();
+  {
+    absl::MutexLock lock(&internal_->mutex);
+    internal_->running_job = nullptr;
+  }
+  return status;
+}
+
+void PackagerEngine::Cancel() {
+  absl::MutexLock lock(&internal_->mutex);
+  if (internal_->running_job)
+    internal_->running_job->Cancel();
+}
+
 }  // namespace shaka
@@ -113,6 +113,15 @@ TEST_F(PackagerTest, Success) {
   ASSERT_EQ(Status::OK, packager.Run());
 }
 
+TEST_F(PackagerTest, EngineRunsBackToBackJobs) {
+  PackagerEngine engine;
+  ASSERT_EQ(Status::OK,
+            engine.Run(SetupPackagingParams(), SetupStreamDescriptors()));
+  // The second job reuses the engine's warm state.
+  ASSERT_EQ(Status::OK,
+            engine.Run(SetupPackagingParams(), SetupStreamDescriptors()));
+}
+
 TEST_F(PackagerTest, MissingStreamDescriptors) {
   std::vector<StreamDescriptor> stream_descriptors;
   Packager packager;
@@ -70,13 +70,23 @@ const Status Status::UNKNOWN = Status(error::UNKNOWN, "");
 
 Status::Status(error::Code error_code, const std::string& error_message)
     : error_code_(error_code) {
-  if (!ok()) {
-    error_message_ = error_message;
-    if (!error_message.empty())
-      VLOG(1) << ToString();
+  if (!ok())
+    SetMessage(error_message);
+}
+
+void Status::SetMessage(std::string error_message) {
+  if (!error_message.empty()) {
+    error_message_ =
+        std::make_shared<const std::string>(std::move(error_message));
+    VLOG(1) << ToString();
   }
 }
 
+const std::string& Status::EmptyMessage() {
+  static const std::string* const kEmpty = new std::string;
+  return *kEmpty;
+}
+
 void Status::Update(Status new_status) {
   if (ok())
     *this = std::move(new_status);
@@ -88,7 +98,7 @@ std::string Status::ToString() const {
 
   return absl::StrFormat("%d (%s): %s", error_code_,
                          error::ErrorCodeToString(error_code_),
-                         error_message_.c_str());
+                         error_message().c_str());
 }
 
 std::ostream& operator<<(std::ostream& os, const Status& x) {
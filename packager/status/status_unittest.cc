@@ -48,6 +48,26 @@ TEST(Status, Filled) {
   CheckStatus(Status(error::CANCELLED, "message"), error::CANCELLED, "message");
 }
 
+TEST(Status, LazyMessageFilled) {
+  bool invoked = false;
+  const Status s(error::CANCELLED, [&invoked]() -> std::string {
+    invoked = true;
+    return "lazy message";
+  });
+  EXPECT_TRUE(invoked);
+  CheckStatus(s, error::CANCELLED, "lazy message");
+}
+
+TEST(Status, LazyMessageNotInvokedOnOk) {
+  bool invoked = false;
+  const Status s(error::OK, [&invoked]() -> std::string {
+    invoked = true;
+    return "lazy message";
+  });
+  EXPECT_FALSE(invoked);
+  CheckStatus(s, error::OK, "");
+}
+
 TEST(Status, Copy) {
   Status a(error::CANCELLED, "message");
   Status b(a);
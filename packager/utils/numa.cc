@@ -0,0 +1,110 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/utils/numa.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <absl/strings/ascii.h>
+#include <absl/strings/numbers.h>
+#include <absl/strings/str_format.h>
+#include <absl/strings/str_split.h>
+
+#include <packager/macros/compiler.h>
+
+namespace shaka {
+
+#if defined(__linux__)
+
+namespace {
+
+// Reads a sysfs cpulist file, e.g. "0-15,32-47\n". Sysfs files do not report
+// a size, so read into a fixed buffer; cpulist contents are tiny.
+bool ReadCpuListFile(const std::string& path, std::string* cpulist) {
+  FILE* file = fopen(path.c_str(), "r");
+  if (!file)
+    return false;
+  char buffer[1024];
+  const size_t size = fread(buffer, 1, sizeof(buffer) - 1, file);
+  fclose(file);
+  cpulist->assign(buffer, size);
+  return true;
+}
+
+}  // namespace
+
+Status PinToNumaNode(int node) {
+  if (node < 0) {
+    return Status(error::INVALID_ARGUMENT,
+                  absl::StrFormat("Invalid NUMA node %d.", node));
+  }
+
+  const std::string path =
+      absl::StrFormat("/sys/devices/system/node/node%d/cpulist", node);
+  std::string cpulist;
+  if (!ReadCpuListFile(path, &cpulist)) {
+    return Status(
+        error::INVALID_ARGUMENT,
+        absl::StrFormat("NUMA node %d does not exist on this host "
+                        "(cannot read %s).",
+                        node, path));
+  }
+
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  int num_cpus = 0;
+  for (const std::string_view range :
+       absl::StrSplit(absl::StripAsciiWhitespace(cpulist), ',',
+                      absl::SkipEmpty())) {
+    // Each token is a single CPU "12" or an inclusive range "0-15".
+    const std::pair<std::string_view, std::string_view> bounds =
+        absl::StrSplit(range, absl::MaxSplits('-', 1));
+    int first = 0;
+    int last = 0;
+    if (!absl::SimpleAtoi(bounds.first, &first)) {
+      return Status(error::UNKNOWN, "Malformed cpulist entry: " + cpulist);
+    }
+    if (bounds.second.empty()) {
+      last = first;
+    } else if (!absl::SimpleAtoi(bounds.second, &last) || last < first) {
+      return Status(error::UNKNOWN, "Malformed cpulist entry: " + cpulist);
+    }
+    for (int cpu = first; cpu <= last && cpu < CPU_SETSIZE; ++cpu) {
+      CPU_SET(cpu, &cpu_set);
+      ++num_cpus;
+    }
+  }
+  if (num_cpus == 0) {
+    return Status(error::INVALID_ARGUMENT,
+                  absl::StrFormat("NUMA node %d has no CPUs.", node));
+  }
+
+  if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+    return Status(error::UNKNOWN,
+                  absl::StrFormat("sched_setaffinity failed for NUMA node %d.",
+                                  node));
+  }
+  return Status::OK;
+}
+
+#else
+
+Status PinToNumaNode(int node) {
+  UNUSED(node);
+  return Status(error::UNIMPLEMENTED,
+                "NUMA node pinning is only supported on Linux.");
+}
+
+#endif  // defined(__linux__)
+
+}  // namespace shaka
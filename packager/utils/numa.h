@@ -0,0 +1,27 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_UTILS_NUMA_H_
+#define PACKAGER_UTILS_NUMA_H_
+
+#include <packager/status.h>
+
+namespace shaka {
+
+/// Pin the calling thread to the CPUs of NUMA node @a node. Threads spawned
+/// afterwards inherit the affinity mask, so calling this on the main thread
+/// before any worker threads exist places the whole packaging pipeline
+/// (demuxers, crypto and ThreadedIoFile workers) on that node. Memory those
+/// threads allocate then becomes node-local through the kernel's first-touch
+/// policy.
+/// Only implemented on Linux; returns UNIMPLEMENTED elsewhere.
+/// @param node is the zero-based NUMA node index.
+/// @return OK on success, an error status otherwise.
+Status PinToNumaNode(int node);
+
+}  // namespace shaka
+
+#endif  // PACKAGER_UTILS_NUMA_H_
@@ -0,0 +1,97 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/utils/stall_monitor.h>
+
+#include <map>
+#include <utility>
+
+#include <absl/strings/str_format.h>
+#include <absl/synchronization/mutex.h>
+
+namespace shaka {
+namespace {
+
+// Bucket i counts waits shorter than 2^i microseconds; the last bucket
+// catches everything longer (2^26 us is roughly a minute).
+constexpr size_t kNumBuckets = 28;
+
+struct Histogram {
+  uint64_t count = 0;
+  uint64_t total_ns = 0;
+  uint64_t max_ns = 0;
+  uint64_t buckets[kNumBuckets] = {};
+};
+
+// Leaked on purpose so recording from static-storage objects is safe.
+absl::Mutex* HistogramMutex() {
+  static absl::Mutex* mutex = new absl::Mutex;
+  return mutex;
+}
+
+std::map<std::pair<std::string, std::string>, Histogram>* Histograms() {
+  static auto* histograms =
+      new std::map<std::pair<std::string, std::string>, Histogram>;
+  return histograms;
+}
+
+size_t BucketIndex(uint64_t wait_ns) {
+  const uint64_t wait_us = wait_ns / 1000;
+  size_t index = 0;
+  while (index + 1 < kNumBuckets && (wait_us >> index) != 0)
+    ++index;
+  return index;
+}
+
+}  // namespace
+
+StallMonitor::ScopedWait::ScopedWait(const char* resource,
+                                     const std::string& name)
+    : resource_(resource),
+      name_(name),
+      start_(std::chrono::steady_clock::now()) {}
+
+StallMonitor::ScopedWait::~ScopedWait() {
+  const auto elapsed = std::chrono::steady_clock::now() - start_;
+  Record(resource_, name_,
+         std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+void StallMonitor::Record(const char* resource,
+                          const std::string& name,
+                          uint64_t wait_ns) {
+  absl::MutexLock lock(HistogramMutex());
+  Histogram& histogram = (*Histograms())[std::make_pair(resource, name)];
+  histogram.count++;
+  histogram.total_ns += wait_ns;
+  if (wait_ns > histogram.max_ns)
+    histogram.max_ns = wait_ns;
+  histogram.buckets[BucketIndex(wait_ns)]++;
+}
+
+std::string StallMonitor::DumpJson() {
+  std::string json = "[";
+  absl::MutexLock lock(HistogramMutex());
+  bool first_entry = true;
+  for (const auto& entry : *Histograms()) {
+    const Histogram& histogram = entry.second;
+    absl::StrAppendFormat(
+        &json,
+        "%s{\"resource\":\"%s\",\"name\":\"%s\",\"count\":%u,"
+        "\"total_ns\":%u,\"max_ns\":%u,\"buckets_us\":[",
+        first_entry ? "" : ",", entry.first.first, entry.first.second,
+        histogram.count, histogram.total_ns, histogram.max_ns);
+    for (size_t i = 0; i < kNumBuckets; i++)
+      absl::StrAppendFormat(&json, "%s%u", i == 0 ? "" : ",",
+                            histogram.buckets[i]);
+    json += "]}";
+    first_entry = false;
+  }
+  json += "]";
+  return json;
+}
+
+}  // namespace shaka
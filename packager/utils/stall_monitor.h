@@ -0,0 +1,60 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_UTILS_STALL_MONITOR_H_
+#define PACKAGER_UTILS_STALL_MONITOR_H_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace shaka {
+
+/// Process-wide registry of wait-time histograms for the pipeline's blocking
+/// points: full IO caches, sync point waits, network round trips. Each
+/// blocking point records how long it blocked, tagged by a resource type
+/// (e.g. "io_cache.write_full") and the instance that blocked (a file name
+/// or URL), so a channel that falls behind real time can be attributed to
+/// storage, crypto or manifest from metrics instead of a debugger.
+///
+/// Recording only happens on paths that have already decided to block, so
+/// the cost of the mutex-guarded histogram map is hidden behind the wait
+/// itself.
+class StallMonitor {
+ public:
+  /// Records the time between construction and destruction into the
+  /// histogram for (@a resource, @a name). Construct right before blocking.
+  /// @param resource must be a string literal (it is stored by pointer).
+  class ScopedWait {
+   public:
+    ScopedWait(const char* resource, const std::string& name);
+    ~ScopedWait();
+
+   private:
+    ScopedWait(const ScopedWait&) = delete;
+    ScopedWait& operator=(const ScopedWait&) = delete;
+
+    const char* const resource_;
+    const std::string name_;
+    const std::chrono::steady_clock::time_point start_;
+  };
+
+  /// Add a wait of @a wait_ns nanoseconds to the histogram for
+  /// (@a resource, @a name).
+  static void Record(const char* resource,
+                     const std::string& name,
+                     uint64_t wait_ns);
+
+  /// @return a JSON array with one entry per (resource, name) pair seen so
+  ///         far: wait count, total and maximum nanoseconds, and counts in
+  ///         power-of-two microsecond buckets (bucket i holds waits shorter
+  ///         than 2^i microseconds, the last bucket everything longer).
+  static std::string DumpJson();
+};
+
+}  // namespace shaka
+
+#endif  // PACKAGER_UTILS_STALL_MONITOR_H_
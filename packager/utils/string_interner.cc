@@ -0,0 +1,27 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/utils/string_interner.h>
+
+#include <unordered_set>
+
+#include <absl/synchronization/mutex.h>
+
+namespace shaka {
+
+const std::string& InternString(const std::string& str) {
+  // Intentionally leaked so interned references stay valid during static
+  // destruction. std::unordered_set is node based, so references to elements
+  // survive rehashing.
+  static absl::Mutex& mutex = *new absl::Mutex;
+  static std::unordered_set<std::string>& strings =
+      *new std::unordered_set<std::string>;
+
+  absl::MutexLock lock(&mutex);
+  return *strings.insert(str).first;
+}
+
+}  // namespace shaka
@@ -0,0 +1,24 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_UTILS_STRING_INTERNER_H_
+#define PACKAGER_UTILS_STRING_INTERNER_H_
+
+#include <string>
+
+namespace shaka {
+
+/// Returns a reference to the process-wide canonical copy of @a str,
+/// inserting it on first use. The reference stays valid for the lifetime of
+/// the process, so callers can hold its address instead of their own copy:
+/// values repeated across many streams (languages, codec strings) are then
+/// stored once no matter how many renditions carry them, and two interned
+/// strings are equal if and only if their addresses are equal. Thread-safe.
+const std::string& InternString(const std::string& str);
+
+}  // namespace shaka
+
+#endif  // PACKAGER_UTILS_STRING_INTERNER_H_
@@ -0,0 +1,224 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/utils/trace_event.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <absl/flags/flag.h>
+#include <absl/log/log.h>
+#include <absl/strings/str_format.h>
+
+ABSL_FLAG(std::string,
+          trace_output,
+          "",
+          "If not empty, enables in-memory pipeline tracing and writes the "
+          "buffered events to this file as Chrome trace JSON (loadable in "
+          "chrome://tracing or Perfetto) at the end of the run.");
+ABSL_FLAG(int32_t,
+          trace_buffer_events,
+          262144,
+          "Number of trace events kept in memory when --trace_output is set. "
+          "The buffer is a ring; once full, new events replace the oldest "
+          "ones.");
+
+namespace shaka {
+namespace {
+
+constexpr size_t kDetailSize = 64;
+
+struct Event {
+  // 0: empty, 1: being written, 2: ready. Slots are claimed with an atomic
+  // increment, so two writers only touch the same slot if one of them lags a
+  // full lap behind the other inside Record(); with a buffer sized for
+  // minutes of events that cannot happen in practice, and the dump skips
+  // slots not in the ready state.
+  std::atomic<uint32_t> state{0};
+  char phase = 'X';
+  const char* category = nullptr;
+  const char* name = nullptr;
+  char detail[kDetailSize] = {};
+  uint32_t tid = 0;
+  int64_t ts_us = 0;
+  int64_t dur_us = 0;
+};
+
+// Distinguishes threads in the trace without leaking platform thread ids.
+uint32_t CurrentThreadId() {
+  static std::atomic<uint32_t> next_id(1);
+  static thread_local const uint32_t id =
+      next_id.fetch_add(1, std::memory_order_relaxed);
+  return id;
+}
+
+class Ring {
+ public:
+  static Ring* Instance() {
+    static Ring* ring = new Ring();
+    return ring;
+  }
+
+  void Record(char phase,
+              const char* category,
+              const char* name,
+              const char* detail,
+              int64_t ts_us,
+              int64_t dur_us) {
+    const uint64_t slot =
+        next_.fetch_add(1, std::memory_order_relaxed) % events_.size();
+    Event& event = events_[slot];
+    event.state.store(1, std::memory_order_release);
+    event.phase = phase;
+    event.category = category;
+    event.name = name;
+    if (detail) {
+      strncpy(event.detail, detail, kDetailSize - 1);
+      event.detail[kDetailSize - 1] = '\0';
+    } else {
+      event.detail[0] = '\0';
+    }
+    event.tid = CurrentThreadId();
+    event.ts_us = ts_us;
+    event.dur_us = dur_us;
+    event.state.store(2, std::memory_order_release);
+  }
+
+  std::string DumpJson() const {
+    std::string json = "{\"traceEvents\":[";
+    bool first = true;
+    // Walk one full lap starting at the oldest slot so events come out in
+    // roughly chronological order (the viewer sorts by timestamp anyway).
+    const uint64_t next = next_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < events_.size(); ++i) {
+      const Event& event = events_[(next + i) % events_.size()];
+      if (event.state.load(std::memory_order_acquire) != 2)
+        continue;
+      if (!first)
+        json += ',';
+      first = false;
+      absl::StrAppendFormat(
+          &json,
+          "{\"ph\":\"%c\",\"cat\":\"%s\",\"name\":\"%s\",\"pid\":1,"
+          "\"tid\":%u,\"ts\":%d,\"dur\":%d,\"args\":{\"detail\":\"%s\"}}",
+          event.phase, event.category, event.name, event.tid, event.ts_us,
+          event.dur_us, EscapeDetail(event.detail));
+    }
+    json += "]}";
+    return json;
+  }
+
+ private:
+  Ring()
+      : events_(std::max<int32_t>(absl::GetFlag(FLAGS_trace_buffer_events),
+                                  1024)) {}
+
+  static std::string EscapeDetail(const char* detail) {
+    std::string escaped;
+    for (const char* p = detail; *p; ++p) {
+      if (*p == '"' || *p == '\\')
+        escaped += '\\';
+      escaped += *p;
+    }
+    return escaped;
+  }
+
+  std::vector<Event> events_;
+  std::atomic<uint64_t> next_{0};
+};
+
+int64_t NowMicroseconds() {
+  // Microseconds since the first use of the tracing layer; Chrome trace
+  // timestamps only need to be consistent within one dump.
+  static const std::chrono::steady_clock::time_point origin =
+      std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - origin)
+      .count();
+}
+
+}  // namespace
+
+bool TraceBuffer::Enabled() {
+  static const bool enabled = !absl::GetFlag(FLAGS_trace_output).empty();
+  return enabled;
+}
+
+TraceBuffer::ScopedEvent::ScopedEvent(const char* category, const char* name)
+    : ScopedEvent(category, name, static_cast<const char*>(nullptr)) {}
+
+TraceBuffer::ScopedEvent::ScopedEvent(const char* category,
+                                      const char* name,
+                                      const char* detail) {
+  if (!Enabled()) {
+    category_ = nullptr;
+    return;
+  }
+  category_ = category;
+  name_ = name;
+  if (detail) {
+    strncpy(detail_, detail, sizeof(detail_) - 1);
+    detail_[sizeof(detail_) - 1] = '\0';
+  } else {
+    detail_[0] = '\0';
+  }
+  start_ = std::chrono::steady_clock::now();
+}
+
+TraceBuffer::ScopedEvent::ScopedEvent(const char* category,
+                                      const char* name,
+                                      const std::string& detail)
+    : ScopedEvent(category, name, detail.c_str()) {}
+
+TraceBuffer::ScopedEvent::~ScopedEvent() {
+  if (!category_)
+    return;
+  const int64_t end_us = NowMicroseconds();
+  const int64_t dur_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                             std::chrono::steady_clock::now() - start_)
+                             .count();
+  Ring::Instance()->Record('X', category_, name_, detail_, end_us - dur_us,
+                           dur_us);
+}
+
+void TraceBuffer::Instant(const char* category,
+                          const char* name,
+                          const std::string& detail) {
+  if (!Enabled())
+    return;
+  Ring::Instance()->Record('i', category, name, detail.c_str(),
+                           NowMicroseconds(), 0);
+}
+
+std::string TraceBuffer::DumpJson() {
+  return Ring::Instance()->DumpJson();
+}
+
+void TraceBuffer::WriteConfiguredOutput() {
+  if (!Enabled())
+    return;
+  const std::string path = absl::GetFlag(FLAGS_trace_output);
+  const std::string json = DumpJson();
+  // Plain stdio instead of the File interface: the File layer is itself
+  // instrumented, and the trace is always a local file.
+  std::FILE* file = std::fopen(path.c_str(), "wb");
+  if (!file) {
+    LOG(ERROR) << "Failed to open trace output file " << path;
+    return;
+  }
+  const size_t written = std::fwrite(json.data(), 1, json.size(), file);
+  std::fclose(file);
+  if (written != json.size()) {
+    LOG(ERROR) << "Failed to write trace output file " << path;
+    return;
+  }
+  LOG(INFO) << "Wrote trace to " << path;
+}
+
+}  // namespace shaka
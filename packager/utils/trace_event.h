@@ -0,0 +1,76 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_UTILS_TRACE_EVENT_H_
+#define PACKAGER_UTILS_TRACE_EVENT_H_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace shaka {
+
+/// Optional in-memory trace-event layer for the media pipeline. When enabled
+/// with --trace_output, instrumented scopes (handler dispatch, segment
+/// finalization, file opens, HTTP transfers, job scheduling) record complete
+/// events into a fixed-size ring buffer holding the most recent
+/// --trace_buffer_events events. The buffer is written out as Chrome trace
+/// JSON, loadable in chrome://tracing or Perfetto, so the last window of a
+/// misbehaving channel can be inspected on a timeline instead of guessed at
+/// from aggregate counters.
+///
+/// Recording claims a slot with a single atomic increment; there are no locks
+/// on the recording path and ScopedEvent is a few loads when tracing is
+/// disabled, so instrumentation can stay on per-sample paths.
+class TraceBuffer {
+ public:
+  /// @return true if tracing was enabled on the command line.
+  static bool Enabled();
+
+  /// Records a complete ("X") event covering its own lifetime. Construct at
+  /// the top of the scope to be traced. @a category and @a name must be
+  /// string literals (they are stored by pointer); @a detail is copied, with
+  /// truncation, into the event and typically holds a file name, URL or
+  /// handler name. Does nothing when tracing is disabled.
+  class ScopedEvent {
+   public:
+    ScopedEvent(const char* category, const char* name);
+    ScopedEvent(const char* category, const char* name, const char* detail);
+    ScopedEvent(const char* category,
+                const char* name,
+                const std::string& detail);
+    ~ScopedEvent();
+
+   private:
+    ScopedEvent(const ScopedEvent&) = delete;
+    ScopedEvent& operator=(const ScopedEvent&) = delete;
+
+    // Null when tracing is disabled; the destructor then records nothing.
+    const char* category_;
+    const char* name_;
+    char detail_[64];
+    std::chrono::steady_clock::time_point start_;
+  };
+
+  /// Records an instantaneous ("i") event. Does nothing when tracing is
+  /// disabled. @a category and @a name must be string literals.
+  static void Instant(const char* category,
+                      const char* name,
+                      const std::string& detail);
+
+  /// @return the buffered events, oldest first, as a Chrome trace JSON
+  ///         document.
+  static std::string DumpJson();
+
+  /// Writes DumpJson() to the file given by --trace_output. No-op when
+  /// tracing is disabled. Intended to be called once at the end of a run;
+  /// events recorded while the dump runs may be missed or replace older ones.
+  static void WriteConfiguredOutput();
+};
+
+}  // namespace shaka
+
+#endif  // PACKAGER_UTILS_TRACE_EVENT_H_
@@ -0,0 +1,31 @@
+//  Copyright 2026 Google LLC. All rights reserved.
+//
+//  Use of this source code is governed by a BSD-style
+//  license that can be found in the LICENSE file or at
+//  https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/utils/virtual_clock.h>
+
+namespace shaka {
+
+VirtualClock::VirtualClock() : epoch_(std::chrono::system_clock::now()) {}
+
+VirtualClock::VirtualClock(time_point epoch) : epoch_(epoch) {}
+
+Clock::time_point VirtualClock::now() noexcept {
+  return epoch_ + std::chrono::microseconds(
+                      media_time_us_.load(std::memory_order_relaxed));
+}
+
+void VirtualClock::AdvanceToMediaTime(double media_time_seconds) {
+  const int64_t media_time_us =
+      static_cast<int64_t>(media_time_seconds * 1000000);
+  // Lock-free max: only move time forward, whichever stream reports first.
+  int64_t current = media_time_us_.load(std::memory_order_relaxed);
+  while (current < media_time_us &&
+         !media_time_us_.compare_exchange_weak(current, media_time_us,
+                                               std::memory_order_relaxed)) {
+  }
+}
+
+}  // namespace shaka
@@ -0,0 +1,46 @@
+//  Copyright 2026 Google LLC. All rights reserved.
+//
+//  Use of this source code is governed by a BSD-style
+//  license that can be found in the LICENSE file or at
+//  https://developers.google.com/open-source/licenses/bsd
+
+#ifndef SHAKA_PACKAGER_VIRTUAL_CLOCK_H
+#define SHAKA_PACKAGER_VIRTUAL_CLOCK_H
+
+#include <atomic>
+#include <chrono>
+
+#include <packager/utils/clock.h>
+
+namespace shaka {
+
+// A Clock driven by media timestamps instead of the system clock. now()
+// returns the epoch captured at construction plus the largest media time
+// reported through AdvanceToMediaTime(). With file inputs the pipeline runs
+// as fast as it can, so manifest and rotation logic keyed on this clock sees
+// a long live channel's worth of time pass in minutes of wall time.
+class VirtualClock : public Clock {
+ public:
+  // Virtual time starts at the current system time.
+  VirtualClock();
+  // Virtual time starts at |epoch|.
+  explicit VirtualClock(time_point epoch);
+
+  time_point now() noexcept override;
+
+  // Advance virtual time to |media_time_seconds| past the epoch. Calls with
+  // earlier times are ignored, so virtual time stays monotonic when several
+  // concurrently muxed streams report their progress.
+  void AdvanceToMediaTime(double media_time_seconds);
+
+ private:
+  VirtualClock(const VirtualClock&) = delete;
+  VirtualClock& operator=(const VirtualClock&) = delete;
+
+  const time_point epoch_;
+  std::atomic<int64_t> media_time_us_{0};
+};
+
+}  // namespace shaka
+
+#endif  // SHAKA_PACKAGER_VIRTUAL_CLOCK_H
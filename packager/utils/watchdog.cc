@@ -0,0 +1,241 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <packager/utils/watchdog.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <absl/log/log.h>
+#include <absl/strings/str_format.h>
+#include <absl/synchronization/mutex.h>
+#include <absl/synchronization/notification.h>
+
+#include <packager/utils/stall_monitor.h>
+#include <packager/utils/trace_event.h>
+
+namespace shaka {
+namespace {
+
+struct Slot {
+  std::string name;
+  std::atomic<const char*> activity{nullptr};
+  std::atomic<int64_t> timestamp{Watchdog::kNoTimestamp};
+  std::atomic<int64_t> last_beat_ns{0};
+};
+
+// Fast gate for Pulse(); flipped by Start()/Stop().
+std::atomic<bool> g_enabled{false};
+
+// The calling thread's slot, bound by ScopedHeartbeat. Raw pointer is fine:
+// the registry below holds a shared_ptr for as long as the slot is
+// registered, and ScopedHeartbeat clears this before unregistering.
+thread_local Slot* tls_slot = nullptr;
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Leaked on purpose so heartbeats from static-storage objects are safe.
+absl::Mutex* StateMutex() {
+  static absl::Mutex* mutex = new absl::Mutex;
+  return mutex;
+}
+
+struct State {
+  std::vector<std::shared_ptr<Slot>> slots;
+  int64_t stall_ns = 0;
+  std::function<void()> on_stall;
+  std::unique_ptr<std::thread> monitor;
+  std::unique_ptr<absl::Notification> stop;
+};
+
+State* GetState() {
+  static State* state = new State;
+  return state;
+}
+
+// Escapes just enough for the slot and activity names we emit.
+std::string JsonEscape(const std::string& in) {
+  std::string out;
+  out.reserve(in.size());
+  for (char c : in) {
+    if (c == '"' || c == '\\')
+      out += '\\';
+    out += c;
+  }
+  return out;
+}
+
+void MonitorLoop(absl::Notification* stop) {
+  bool in_stall = false;
+  while (true) {
+    std::vector<std::shared_ptr<Slot>> slots;
+    int64_t stall_ns;
+    std::function<void()> on_stall;
+    {
+      absl::MutexLock lock(StateMutex());
+      State* state = GetState();
+      slots = state->slots;
+      stall_ns = state->stall_ns;
+      on_stall = state->on_stall;
+    }
+
+    // Check a few times per window so a stall is caught well before it has
+    // lasted two windows.
+    const int64_t check_ns = std::max<int64_t>(stall_ns / 4, 100 * 1000000);
+    if (stop->WaitForNotificationWithTimeout(absl::Nanoseconds(check_ns)))
+      return;
+
+    if (slots.empty())
+      continue;
+
+    const int64_t now_ns = NowNs();
+    int64_t newest_beat_ns = 0;
+    for (const auto& slot : slots) {
+      newest_beat_ns = std::max(
+          newest_beat_ns, slot->last_beat_ns.load(std::memory_order_relaxed));
+    }
+
+    if (now_ns - newest_beat_ns < stall_ns) {
+      in_stall = false;
+      continue;
+    }
+    if (in_stall)  // Already reported this episode.
+      continue;
+    in_stall = true;
+
+    LOG(ERROR) << "Watchdog: no pipeline progress for "
+               << (now_ns - newest_beat_ns) / 1e9
+               << " seconds. Heartbeats: " << Watchdog::DumpTable();
+    LOG(ERROR) << "Watchdog: stall histograms: " << StallMonitor::DumpJson();
+    // Flush the trace ring while it still shows the window leading into the
+    // stall; harmless no-op without --trace_output.
+    TraceBuffer::WriteConfiguredOutput();
+    if (on_stall)
+      on_stall();
+  }
+}
+
+}  // namespace
+
+Watchdog::ScopedHeartbeat::ScopedHeartbeat(const std::string& name)
+    : slot_(nullptr) {
+  if (!Enabled())
+    return;
+  auto slot = std::make_shared<Slot>();
+  slot->name = name;
+  slot->last_beat_ns.store(NowNs(), std::memory_order_relaxed);
+  slot_ = slot.get();
+  tls_slot = slot.get();
+  absl::MutexLock lock(StateMutex());
+  GetState()->slots.push_back(std::move(slot));
+}
+
+Watchdog::ScopedHeartbeat::~ScopedHeartbeat() {
+  if (!slot_)
+    return;
+  tls_slot = nullptr;
+  absl::MutexLock lock(StateMutex());
+  auto& slots = GetState()->slots;
+  for (auto it = slots.begin(); it != slots.end(); ++it) {
+    if (it->get() == slot_) {
+      slots.erase(it);
+      break;
+    }
+  }
+}
+
+bool Watchdog::Enabled() {
+  return g_enabled.load(std::memory_order_relaxed);
+}
+
+void Watchdog::Pulse(const char* activity) {
+  Slot* slot = tls_slot;
+  if (!slot)
+    return;
+  slot->activity.store(activity, std::memory_order_relaxed);
+  slot->last_beat_ns.store(NowNs(), std::memory_order_relaxed);
+}
+
+void Watchdog::Pulse(const char* activity, int64_t timestamp) {
+  Slot* slot = tls_slot;
+  if (!slot)
+    return;
+  slot->activity.store(activity, std::memory_order_relaxed);
+  if (timestamp != kNoTimestamp)
+    slot->timestamp.store(timestamp, std::memory_order_relaxed);
+  slot->last_beat_ns.store(NowNs(), std::memory_order_relaxed);
+}
+
+void Watchdog::Start(double stall_seconds, std::function<void()> on_stall) {
+  if (stall_seconds <= 0)
+    return;
+  absl::MutexLock lock(StateMutex());
+  State* state = GetState();
+  if (state->monitor)
+    return;
+  state->stall_ns = static_cast<int64_t>(stall_seconds * 1e9);
+  state->on_stall = std::move(on_stall);
+  state->stop.reset(new absl::Notification);
+  g_enabled.store(true, std::memory_order_relaxed);
+  absl::Notification* stop = state->stop.get();
+  state->monitor.reset(new std::thread([stop]() { MonitorLoop(stop); }));
+}
+
+void Watchdog::Stop() {
+  std::unique_ptr<std::thread> monitor;
+  {
+    absl::MutexLock lock(StateMutex());
+    State* state = GetState();
+    if (!state->monitor)
+      return;
+    g_enabled.store(false, std::memory_order_relaxed);
+    state->stop->Notify();
+    monitor = std::move(state->monitor);
+    state->on_stall = nullptr;
+  }
+  // Join outside the lock: the monitor takes the lock to snapshot slots.
+  monitor->join();
+  absl::MutexLock lock(StateMutex());
+  GetState()->stop.reset();
+}
+
+std::string Watchdog::DumpTable() {
+  std::vector<std::shared_ptr<Slot>> slots;
+  {
+    absl::MutexLock lock(StateMutex());
+    slots = GetState()->slots;
+  }
+  const int64_t now_ns = NowNs();
+  std::string json = "{\"threads\":[";
+  bool first = true;
+  for (const auto& slot : slots) {
+    if (!first)
+      json += ',';
+    first = false;
+    const char* activity = slot->activity.load(std::memory_order_relaxed);
+    const int64_t timestamp = slot->timestamp.load(std::memory_order_relaxed);
+    absl::StrAppendFormat(
+        &json, "{\"name\":\"%s\",\"activity\":\"%s\",\"idle_seconds\":%.3f",
+        JsonEscape(slot->name), activity ? JsonEscape(activity) : "",
+        (now_ns - slot->last_beat_ns.load(std::memory_order_relaxed)) / 1e9);
+    if (timestamp != kNoTimestamp)
+      absl::StrAppendFormat(&json, ",\"last_timestamp\":%d", timestamp);
+    json += '}';
+  }
+  json += "]}";
+  return json;
+}
+
+}  // namespace shaka
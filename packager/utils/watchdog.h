@@ -0,0 +1,80 @@
+// Copyright 2026 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_UTILS_WATCHDOG_H_
+#define PACKAGER_UTILS_WATCHDOG_H_
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+
+namespace shaka {
+
+/// Hang detector for the media pipeline. Worker threads (jobs, threaded file
+/// I/O) register a heartbeat slot with ScopedHeartbeat and then publish cheap
+/// progress pulses — the activity they last performed and, where available,
+/// the media timestamp they last processed. A monitor on a dedicated thread
+/// (deliberately not the shared pool, which may itself be what is wedged)
+/// declares a stall when *no* registered thread has pulsed within the
+/// configured window; individual threads are allowed to sit idle while
+/// blocked on each other, so only global silence counts. On a stall it logs
+/// the heartbeat table and the StallMonitor histograms, flushes the trace
+/// ring via TraceBuffer::WriteConfiguredOutput(), and invokes the callback
+/// given to Start() — which the embedder can use to log additional state or
+/// to fail-fast by cancelling the jobs. Disabled (and a few relaxed loads per
+/// pulse) unless Start() has been called.
+class Watchdog {
+ public:
+  /// Timestamp value for pulses from contexts that have no media timestamp,
+  /// e.g. raw byte I/O.
+  static constexpr int64_t kNoTimestamp = std::numeric_limits<int64_t>::min();
+
+  /// Registers a heartbeat slot for the calling thread for the lifetime of
+  /// this object and binds Pulse() on this thread to it. No-op while the
+  /// watchdog is disabled. Must be destroyed on the thread that created it.
+  class ScopedHeartbeat {
+   public:
+    explicit ScopedHeartbeat(const std::string& name);
+    ~ScopedHeartbeat();
+
+   private:
+    ScopedHeartbeat(const ScopedHeartbeat&) = delete;
+    ScopedHeartbeat& operator=(const ScopedHeartbeat&) = delete;
+
+    // Null when the watchdog is disabled; the destructor then does nothing.
+    void* slot_;
+  };
+
+  /// @return true if Start() has been called and Stop() has not.
+  static bool Enabled();
+
+  /// Records progress on the calling thread's slot. @a activity must be a
+  /// string literal or otherwise outlive the slot (it is stored by pointer).
+  /// No-op on threads without a ScopedHeartbeat or while disabled.
+  static void Pulse(const char* activity);
+
+  /// Same, also recording the media timestamp being processed so stall dumps
+  /// show how far each stream got.
+  static void Pulse(const char* activity, int64_t timestamp);
+
+  /// Starts the monitor thread. A stall is declared when no heartbeat has
+  /// been seen for @a stall_seconds; @a on_stall (may be null) is invoked
+  /// from the monitor thread, once per stall episode. No-op if already
+  /// started.
+  static void Start(double stall_seconds, std::function<void()> on_stall);
+
+  /// Stops the monitor thread and disables heartbeats. Blocks until the
+  /// monitor has exited; safe to call when not started.
+  static void Stop();
+
+  /// @return the current heartbeat table as a JSON document.
+  static std::string DumpTable();
+};
+
+}  // namespace shaka
+
+#endif  // PACKAGER_UTILS_WATCHDOG_H_